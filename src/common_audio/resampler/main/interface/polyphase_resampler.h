@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * A polyphase FIR resampler for any pair of sampling frequencies.
+ */
+
+#ifndef WEBRTC_RESAMPLER_POLYPHASE_RESAMPLER_H_
+#define WEBRTC_RESAMPLER_POLYPHASE_RESAMPLER_H_
+
+#include "typedefs.h"
+
+namespace webrtc
+{
+
+// Length of the anti-aliasing filter. A longer filter has a narrower
+// transition band and more stopband attenuation, but costs more CPU and adds
+// more delay (half the number of taps, counted in input samples).
+enum ResamplerQuality
+{
+    kResamplerQualityLow,     // 16 taps per phase
+    kResamplerQualityMedium,  // 32 taps per phase
+    kResamplerQualityHigh     // 64 taps per phase
+};
+
+class PolyphaseResampler
+{
+
+public:
+    PolyphaseResampler();
+    ~PolyphaseResampler();
+
+    // Designs the filter for inFreq -> outFreq and clears all states.
+    // numChannels channels are resampled, interleaved. Returns -1 if the
+    // reduced ratio inFreq:outFreq needs more than kMaxPhases filter phases.
+    int Reset(int inFreq, int outFreq, int numChannels, ResamplerQuality quality);
+
+    // Resamples lengthIn interleaved samples. Any length is accepted; a
+    // multiple of 10 ms gives exactly outFreq / inFreq times as many samples.
+    // Returns -1 if more than maxLen samples would be written.
+    int Push(const WebRtc_Word16* samplesIn, int lengthIn, WebRtc_Word16* samplesOut,
+             int maxLen, int &outLen);
+
+    // Filter delay in input samples.
+    int Delay() const;
+
+    enum { kMaxPhases = 1024 };
+
+private:
+    int EnsureCapacity(int frames);
+
+    // Filter coefficients in Q14, taps_ per phase and stored reversed so that
+    // an output sample is a plain dot product with the input.
+    WebRtc_Word16* coefficients_;
+    int taps_;
+    int num_phases_;  // Interpolation factor L
+    int step_;        // Decimation factor M
+
+    // Per channel: taps_ - 1 samples of history followed by the new input.
+    WebRtc_Word16* buffer_;
+    int buffer_frames_;
+    int num_channels_;
+
+    // Position of the next output sample; input sample pos_ in the buffer and
+    // filter phase phase_.
+    int pos_;
+    int phase_;
+};
+
+} // namespace webrtc
+
+#endif // WEBRTC_RESAMPLER_POLYPHASE_RESAMPLER_H_
@@ -16,6 +16,7 @@
 #ifndef WEBRTC_RESAMPLER_RESAMPLER_H_
 #define WEBRTC_RESAMPLER_RESAMPLER_H_
 
+#include "polyphase_resampler.h"
 #include "typedefs.h"
 
 namespace webrtc
@@ -53,7 +54,9 @@ enum ResamplerMode
     kResamplerMode3To2,
     kResamplerMode11To2,
     kResamplerMode11To4,
-    kResamplerMode11To8
+    kResamplerMode11To8,
+    // Any other ratio, handled by PolyphaseResampler
+    kResamplerModePolyphase
 };
 
 class Resampler
@@ -80,6 +83,10 @@ public:
     // Asynchronous resampling output, remaining samples are buffered
     int Pull(WebRtc_Word16* samplesOut, int desiredLen, int &outLen);
 
+    // Filter quality for ratios without a dedicated resampler, such as
+    // 44.1 kHz <-> 48 kHz. Takes effect at the next Reset(). Default medium.
+    void SetPolyphaseQuality(ResamplerQuality quality);
+
 private:
     // Generic pointers since we don't know what states we'll need
     void* state1_;
@@ -103,6 +110,10 @@ private:
     // Extra instance for stereo
     Resampler* slave_left_;
     Resampler* slave_right_;
+
+    // Handles mono and stereo itself, the slaves are not used
+    PolyphaseResampler* polyphase_;
+    ResamplerQuality polyphase_quality_;
 };
 
 } // namespace webrtc
@@ -16,7 +16,14 @@ LOCAL_MODULE := libwebrtc_resampler
 LOCAL_MODULE_TAGS := optional
 LOCAL_CPP_EXTENSION := .cc
 LOCAL_GENERATED_SOURCES :=
-LOCAL_SRC_FILES := resampler.cc
+LOCAL_SRC_FILES := resampler.cc \
+    polyphase_resampler.cc
+
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
+    polyphase_resampler_neon.cc.neon
+MY_ARCH_DEFS := '-DWEBRTC_ARCH_ARM_NEON'
+endif
 
 # Flags passed to both C and C++ files.
 MY_CFLAGS := 
@@ -30,7 +37,7 @@ MY_DEFS += \
     '-DWEBRTC_ANDROID' \
     '-DANDROID' 
 endif
-LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS)
+LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS) $(MY_ARCH_DEFS)
 
 # Include paths placed before CFLAGS/CPPFLAGS
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../../.. \
@@ -0,0 +1,329 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * A polyphase FIR resampler for any pair of sampling frequencies.
+ *
+ * The input is conceptually upsampled by L, lowpass filtered with a Kaiser
+ * windowed sinc and downsampled by M, where L:M is outFreq:inFreq reduced by
+ * their gcd. Only the L phases of the filter that are actually used are
+ * evaluated, so the cost is taps_ multiplications per output sample and
+ * channel independent of the ratio.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "polyphase_resampler.h"
+#include "polyphase_resampler_kernels.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace webrtc
+{
+
+static PolyphaseDotProduct DotProduct = PolyphaseDotProductC;
+
+WebRtc_Word32 PolyphaseDotProductC(const WebRtc_Word16* in,
+                                   const WebRtc_Word16* coefficients,
+                                   int length)
+{
+    WebRtc_Word32 sum = 0;
+    for (int i = 0; i < length; i++)
+    {
+        sum += (WebRtc_Word32)in[i] * coefficients[i];
+    }
+    return sum;
+}
+
+// Zeroth order modified Bessel function of the first kind.
+static double BesselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; k++)
+    {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-12)
+        {
+            break;
+        }
+    }
+    return sum;
+}
+
+PolyphaseResampler::PolyphaseResampler()
+{
+    coefficients_ = NULL;
+    taps_ = 0;
+    num_phases_ = 1;
+    step_ = 1;
+    buffer_ = NULL;
+    buffer_frames_ = 0;
+    num_channels_ = 0;
+    pos_ = 0;
+    phase_ = 0;
+}
+
+PolyphaseResampler::~PolyphaseResampler()
+{
+    if (coefficients_)
+    {
+        free(coefficients_);
+    }
+    if (buffer_)
+    {
+        free(buffer_);
+    }
+}
+
+int PolyphaseResampler::Reset(int inFreq, int outFreq, int numChannels,
+                              ResamplerQuality quality)
+{
+    if (coefficients_)
+    {
+        free(coefficients_);
+        coefficients_ = NULL;
+    }
+    if (buffer_)
+    {
+        free(buffer_);
+        buffer_ = NULL;
+    }
+    buffer_frames_ = 0;
+    num_channels_ = 0;
+
+    if (inFreq <= 0 || outFreq <= 0 || numChannels <= 0)
+    {
+        return -1;
+    }
+
+    int a = inFreq;
+    int b = outFreq;
+    int c = a % b;
+    while (c != 0)
+    {
+        a = b;
+        b = c;
+        c = a % b;
+    }
+    num_phases_ = outFreq / b;
+    step_ = inFreq / b;
+    if (num_phases_ > kMaxPhases)
+    {
+        return -1;
+    }
+
+    // Cutoff as a fraction of the lower Nyquist frequency, and the Kaiser
+    // window beta. The transition band of the shorter filters is wider, so
+    // the cutoff is moved down to keep the aliasing out of the passband.
+    double rolloff;
+    double beta;
+    switch (quality)
+    {
+        case kResamplerQualityLow:
+            taps_ = 16;
+            rolloff = 0.80;
+            beta = 6.0;
+            break;
+        case kResamplerQualityHigh:
+            taps_ = 64;
+            rolloff = 0.94;
+            beta = 9.0;
+            break;
+        case kResamplerQualityMedium:
+        default:
+            taps_ = 32;
+            rolloff = 0.90;
+            beta = 8.0;
+            break;
+    }
+
+    // Prototype filter at the upsampled rate, with a DC gain of L.
+    const int length = taps_ * num_phases_;
+    const int lowFreq = inFreq < outFreq ? inFreq : outFreq;
+    const double cutoff = rolloff * lowFreq / ((double)inFreq * num_phases_);
+    const double center = (length - 1) / 2.0;
+    const double windowNorm = BesselI0(beta);
+    double* prototype = (double*)malloc(length * sizeof(double));
+    double gain = 0;
+    for (int k = 0; k < length; k++)
+    {
+        const double t = k - center;
+        const double x = 2 * t / length;
+        const double window = BesselI0(beta * sqrt(1 - x * x)) / windowNorm;
+        const double sinc = (t == 0) ? 1.0 : sin(M_PI * cutoff * t) / (M_PI * cutoff * t);
+        prototype[k] = cutoff * sinc * window;
+        gain += prototype[k];
+    }
+
+    // Split into phases, quantize to Q14 and make the DC gain of every phase
+    // exactly one by moving the rounding error to its largest tap.
+    coefficients_ = (WebRtc_Word16*)malloc(length * sizeof(WebRtc_Word16));
+    for (int phase = 0; phase < num_phases_; phase++)
+    {
+        WebRtc_Word16* h = &coefficients_[phase * taps_];
+        int sum = 0;
+        for (int i = 0; i < taps_; i++)
+        {
+            const double value = prototype[i * num_phases_ + phase] * num_phases_ / gain;
+            h[taps_ - 1 - i] = (WebRtc_Word16)floor(value * 16384 + 0.5);
+            sum += h[taps_ - 1 - i];
+        }
+        int largest = 0;
+        for (int i = 1; i < taps_; i++)
+        {
+            if (h[i] > h[largest])
+            {
+                largest = i;
+            }
+        }
+        h[largest] += (WebRtc_Word16)(16384 - sum);
+    }
+    free(prototype);
+
+    num_channels_ = numChannels;
+    pos_ = taps_ - 1;
+    phase_ = 0;
+    if (EnsureCapacity(0) != 0)
+    {
+        return -1;
+    }
+
+    DotProduct = PolyphaseDotProductC;
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+#if defined(__SSE2__)
+        DotProduct = PolyphaseDotProductSSE2;
+#endif
+    }
+    if (WebRtc_GetCPUInfo(kNEON))
+    {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+        DotProduct = PolyphaseDotProductNeon;
+#endif
+    }
+
+    return 0;
+}
+
+// Makes room for frames new samples per channel after the history. The
+// history is kept.
+int PolyphaseResampler::EnsureCapacity(int frames)
+{
+    if (buffer_ && frames <= buffer_frames_)
+    {
+        return 0;
+    }
+
+    const int history = taps_ - 1;
+    const int oldSize = history + buffer_frames_;
+    const int newSize = history + frames;
+    WebRtc_Word16* buffer = (WebRtc_Word16*)calloc(num_channels_ * newSize,
+                                                   sizeof(WebRtc_Word16));
+    if (buffer == NULL)
+    {
+        return -1;
+    }
+    if (buffer_)
+    {
+        for (int ch = 0; ch < num_channels_; ch++)
+        {
+            memcpy(&buffer[ch * newSize], &buffer_[ch * oldSize],
+                   history * sizeof(WebRtc_Word16));
+        }
+        free(buffer_);
+    }
+    buffer_ = buffer;
+    buffer_frames_ = frames;
+    return 0;
+}
+
+int PolyphaseResampler::Push(const WebRtc_Word16* samplesIn, int lengthIn,
+                             WebRtc_Word16* samplesOut, int maxLen, int &outLen)
+{
+    outLen = 0;
+    if (coefficients_ == NULL || lengthIn < 0 || (lengthIn % num_channels_) != 0)
+    {
+        return -1;
+    }
+
+    const int frames = lengthIn / num_channels_;
+    const int history = taps_ - 1;
+
+    // Output sample n is at upsampled time pos_ * L + phase_ + n * M, and
+    // exists once input sample pos_ + (phase_ + n * M) / L is available.
+    const WebRtc_Word64 available = (WebRtc_Word64)(history + frames - pos_) * num_phases_
+            - phase_;
+    const int numOut = available > 0 ? (int)((available + step_ - 1) / step_) : 0;
+    if (numOut * num_channels_ > maxLen)
+    {
+        return -1;
+    }
+    if (EnsureCapacity(frames) != 0)
+    {
+        return -1;
+    }
+
+    const int size = history + buffer_frames_;
+    for (int ch = 0; ch < num_channels_; ch++)
+    {
+        WebRtc_Word16* buffer = &buffer_[ch * size];
+        for (int i = 0; i < frames; i++)
+        {
+            buffer[history + i] = samplesIn[i * num_channels_ + ch];
+        }
+
+        int pos = pos_;
+        int phase = phase_;
+        for (int n = 0; n < numOut; n++)
+        {
+            WebRtc_Word32 sum = DotProduct(&buffer[pos - history],
+                                           &coefficients_[phase * taps_], taps_);
+            sum = (sum + (1 << 13)) >> 14;
+            if (sum > 32767)
+            {
+                sum = 32767;
+            } else if (sum < -32768)
+            {
+                sum = -32768;
+            }
+            samplesOut[n * num_channels_ + ch] = (WebRtc_Word16)sum;
+
+            phase += step_;
+            pos += phase / num_phases_;
+            phase %= num_phases_;
+        }
+
+        // Keep the last samples as history for the next call.
+        memmove(buffer, &buffer[frames], history * sizeof(WebRtc_Word16));
+    }
+
+    // Advance the position by the number of outputs produced.
+    const WebRtc_Word64 advance = (WebRtc_Word64)phase_ + (WebRtc_Word64)numOut * step_;
+    pos_ += (int)(advance / num_phases_) - frames;
+    phase_ = (int)(advance % num_phases_);
+
+    outLen = numOut * num_channels_;
+    return 0;
+}
+
+int PolyphaseResampler::Delay() const
+{
+    return taps_ / 2;
+}
+
+} // namespace webrtc
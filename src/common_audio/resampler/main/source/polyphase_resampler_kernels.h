@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * Inner loops of the polyphase resampler.
+ */
+
+#ifndef WEBRTC_RESAMPLER_POLYPHASE_RESAMPLER_KERNELS_H_
+#define WEBRTC_RESAMPLER_POLYPHASE_RESAMPLER_KERNELS_H_
+
+#include "typedefs.h"
+
+namespace webrtc
+{
+
+// Returns the sum of in[i] * coefficients[i], i = 0..length-1. length must be
+// a multiple of 8. All versions give bit exact results, since the sum always
+// fits in 32 bits for the filters designed by PolyphaseResampler.
+typedef WebRtc_Word32 (*PolyphaseDotProduct)(const WebRtc_Word16* in,
+                                             const WebRtc_Word16* coefficients,
+                                             int length);
+
+WebRtc_Word32 PolyphaseDotProductC(const WebRtc_Word16* in,
+                                   const WebRtc_Word16* coefficients,
+                                   int length);
+#if defined(__SSE2__)
+WebRtc_Word32 PolyphaseDotProductSSE2(const WebRtc_Word16* in,
+                                      const WebRtc_Word16* coefficients,
+                                      int length);
+#endif
+#if defined(WEBRTC_ARCH_ARM_NEON)
+WebRtc_Word32 PolyphaseDotProductNeon(const WebRtc_Word16* in,
+                                      const WebRtc_Word16* coefficients,
+                                      int length);
+#endif
+
+} // namespace webrtc
+
+#endif // WEBRTC_RESAMPLER_POLYPHASE_RESAMPLER_KERNELS_H_
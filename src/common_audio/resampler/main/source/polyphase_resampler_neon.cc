@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * NEON inner loop of the polyphase resampler, bit exact with the C version.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+
+#include "polyphase_resampler_kernels.h"
+
+namespace webrtc
+{
+
+WebRtc_Word32 PolyphaseDotProductNeon(const WebRtc_Word16* in,
+                                      const WebRtc_Word16* coefficients,
+                                      int length)
+{
+    int32x4_t sum = vdupq_n_s32(0);
+    for (int i = 0; i < length; i += 8)
+    {
+        const int16x8_t x = vld1q_s16(&in[i]);
+        const int16x8_t h = vld1q_s16(&coefficients[i]);
+        sum = vmlal_s16(sum, vget_low_s16(x), vget_low_s16(h));
+        sum = vmlal_s16(sum, vget_high_s16(x), vget_high_s16(h));
+    }
+    const int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+    return vget_lane_s32(vpadd_s32(half, half), 0);
+}
+
+} // namespace webrtc
+
+#endif // WEBRTC_ARCH_ARM_NEON
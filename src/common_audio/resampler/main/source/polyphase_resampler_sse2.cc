@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * SSE2 inner loop of the polyphase resampler, bit exact with the C version.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#include "polyphase_resampler_kernels.h"
+
+namespace webrtc
+{
+
+WebRtc_Word32 PolyphaseDotProductSSE2(const WebRtc_Word16* in,
+                                      const WebRtc_Word16* coefficients,
+                                      int length)
+{
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < length; i += 8)
+    {
+        const __m128i x = _mm_loadu_si128((const __m128i*)&in[i]);
+        const __m128i h = _mm_loadu_si128((const __m128i*)&coefficients[i]);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(x, h));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+} // namespace webrtc
+
+#endif // __SSE2__
@@ -41,6 +41,8 @@ Resampler::Resampler()
     my_type_ = kResamplerInvalid;
     slave_left_ = NULL;
     slave_right_ = NULL;
+    polyphase_ = NULL;
+    polyphase_quality_ = kResamplerQualityMedium;
 }
 
 Resampler::Resampler(int inFreq, int outFreq, ResamplerType type)
@@ -61,6 +63,8 @@ Resampler::Resampler(int inFreq, int outFreq, ResamplerType type)
     my_type_ = kResamplerInvalid;
     slave_left_ = NULL;
     slave_right_ = NULL;
+    polyphase_ = NULL;
+    polyphase_quality_ = kResamplerQualityMedium;
 
     int res = Reset(inFreq, outFreq, type);
 
@@ -96,6 +100,10 @@ Resampler::~Resampler()
     {
         delete slave_right_;
     }
+    if (polyphase_)
+    {
+        delete polyphase_;
+    }
 }
 
 int Resampler::ResetIfNeeded(int inFreq, int outFreq, ResamplerType type)
@@ -151,6 +159,11 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
         delete slave_right_;
         slave_right_ = NULL;
     }
+    if (polyphase_)
+    {
+        delete polyphase_;
+        polyphase_ = NULL;
+    }
 
     in_buffer_size_ = 0;
     out_buffer_size_ = 0;
@@ -181,15 +194,6 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
     inFreq = inFreq / b;
     outFreq = outFreq / b;
 
-    // Do we need stereo?
-    if ((my_type_ & 0xf0) == 0x20)
-    {
-        // Change type to mono
-        type = (ResamplerType)((int)type & 0x0f + 0x10);
-        slave_left_ = new Resampler(inFreq, outFreq, type);
-        slave_right_ = new Resampler(inFreq, outFreq, type);
-    }
-
     if (inFreq == outFreq)
     {
         my_mode_ = kResamplerMode1To1;
@@ -210,7 +214,7 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
                 my_mode_ = kResamplerMode1To6;
                 break;
             default:
-                my_type_ = kResamplerInvalid;
+                my_mode_ = kResamplerModePolyphase;
                 break;
         }
     } else if (outFreq == 1)
@@ -230,7 +234,7 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
                 my_mode_ = kResamplerMode6To1;
                 break;
             default:
-                my_type_ = kResamplerInvalid;
+                my_mode_ = kResamplerModePolyphase;
                 break;
         }
     } else if ((inFreq == 2) && (outFreq == 3))
@@ -265,8 +269,28 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
         my_mode_ = kResamplerMode11To8;
     } else
     {
-        my_type_ = kResamplerInvalid;
-        return -1;
+        my_mode_ = kResamplerModePolyphase;
+    }
+
+    if (my_mode_ == kResamplerModePolyphase)
+    {
+        polyphase_ = new PolyphaseResampler();
+        if (polyphase_->Reset(inFreq, outFreq, (my_type_ & 0xf0) >> 4,
+                              polyphase_quality_) != 0)
+        {
+            my_type_ = kResamplerInvalid;
+            return -1;
+        }
+        return 0;
+    }
+
+    // Do we need stereo?
+    if ((my_type_ & 0xf0) == 0x20)
+    {
+        // Change type to mono
+        type = (ResamplerType)((int)type & 0x0f + 0x10);
+        slave_left_ = new Resampler(inFreq, outFreq, type);
+        slave_right_ = new Resampler(inFreq, outFreq, type);
     }
 
     // Now create the states we need
@@ -391,7 +415,9 @@ int Resampler::Reset(int inFreq, int outFreq, ResamplerType type)
             state1_ = malloc(sizeof(WebRtcSpl_State22khzTo16khz));
             WebRtcSpl_ResetResample22khzTo16khz((WebRtcSpl_State22khzTo16khz *)state1_);
             break;
-
+        case kResamplerModePolyphase:
+            // Created above.
+            break;
     }
 
     return 0;
@@ -408,7 +434,7 @@ int Resampler::Push(const WebRtc_Word16 * samplesIn, int lengthIn, WebRtc_Word16
     }
 
     // Do we have a stereo signal?
-    if ((my_type_ & 0xf0) == 0x20)
+    if (((my_type_ & 0xf0) == 0x20) && (my_mode_ != kResamplerModePolyphase))
     {
 
         // Split up the signal and call the slave object for each channel
@@ -884,6 +910,8 @@ int Resampler::Push(const WebRtc_Word16 * samplesIn, int lengthIn, WebRtc_Word16
             free(tmp_mem);
             return 0;
             break;
+        case kResamplerModePolyphase:
+            return polyphase_->Push(samplesIn, lengthIn, samplesOut, maxLen, outLen);
 
     }
     return 0;
@@ -978,4 +1006,9 @@ int Resampler::Pull(WebRtc_Word16* samplesOut, int desiredLen, int &outLen)
     }
 }
 
+void Resampler::SetPolyphaseQuality(ResamplerQuality quality)
+{
+    polyphase_quality_ = quality;
+}
+
 } // namespace webrtc
@@ -26,9 +26,41 @@
         ],
       },
       'sources': [
+        '../interface/polyphase_resampler.h',
         '../interface/resampler.h',
+        'polyphase_resampler.cc',
+        'polyphase_resampler_kernels.h',
         'resampler.cc',
       ],
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'polyphase_resampler_sse2.cc',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'polyphase_resampler_neon.cc',
+          ],
+        }],
+      ],
+    },
+    {
+      'target_name': 'resampler_simd_test',
+      'type': 'executable',
+      'dependencies': [
+        'resampler',
+        '../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'include_dirs': [
+        '../../../../system_wrappers/interface',
+      ],
+      'sources': [
+        '../test/resampler_simd_test.cc',
+      ],
     },
   ],
 }
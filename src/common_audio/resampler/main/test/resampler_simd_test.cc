@@ -0,0 +1,226 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Resamples a chirp between rate pairs that use the polyphase resampler, with
+// and without the SSE2/NEON code, and checks that the outputs are bit exact
+// and that every 10 ms block gives a full 10 ms of output. Also prints the
+// time spent in Resampler::Push() for both.
+//
+// Then checks the quality of the filters with sines: the gain and the noise
+// (images, aliases and rounding) of a passband sine, and when downsampling,
+// the level of the aliases of a sine above the output Nyquist frequency.
+//
+// Usage: resampler_simd_test
+
+#include <math.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include "cpu_features_wrapper.h"
+#include "resampler.h"
+#include "tick_util.h"
+
+namespace {
+const int kSeconds = 10;
+const double kPi = 3.14159265358979;
+const double kAmplitude = 16384;  // -6 dBFS
+
+struct RatePair {
+  int in_hz;
+  int out_hz;
+};
+
+// Resamples |input| in 10 ms blocks and stores the result in |output|.
+// Returns the processing time in microseconds, or -1 on error.
+WebRtc_Word64 Run(const std::vector<WebRtc_Word16>& input,
+                  const RatePair& rates, int num_channels,
+                  webrtc::ResamplerQuality quality,
+                  std::vector<WebRtc_Word16>* output) {
+  const webrtc::ResamplerType type = num_channels == 2 ?
+      webrtc::kResamplerSynchronousStereo : webrtc::kResamplerSynchronous;
+  const int in_block = rates.in_hz / 100 * num_channels;
+  const int out_block = rates.out_hz / 100 * num_channels;
+
+  webrtc::Resampler resampler;
+  resampler.SetPolyphaseQuality(quality);
+  if (resampler.Reset(rates.in_hz, rates.out_hz, type) != 0) {
+    return -1;
+  }
+
+  const int num_blocks = static_cast<int>(input.size()) / in_block;
+  output->assign(num_blocks * out_block, 0);
+  WebRtc_Word64 elapsed_us = 0;
+  for (int i = 0; i < num_blocks; i++) {
+    int out_len = 0;
+    const webrtc::TickTime start = webrtc::TickTime::Now();
+    if (resampler.Push(&input[i * in_block], in_block,
+                       &(*output)[i * out_block], out_block, out_len) != 0 ||
+        out_len != out_block) {
+      return -1;
+    }
+    elapsed_us += (webrtc::TickTime::Now() - start).Microseconds();
+  }
+  return elapsed_us;
+}
+
+// Resamples one second of a mono sine at |freq_hz|. Once the filter has
+// settled, a sine of the same frequency is fitted to the output. Sets
+// |gain_db| to the level of the fitted sine and |noise_db| to the level of
+// the rest, both relative to the input sine. Returns false on error.
+bool MeasureSine(const RatePair& rates, webrtc::ResamplerQuality quality,
+                 double freq_hz, double* gain_db, double* noise_db) {
+  std::vector<WebRtc_Word16> input(rates.in_hz);
+  for (int i = 0; i < rates.in_hz; i++) {
+    input[i] = static_cast<WebRtc_Word16>(floor(
+        kAmplitude * sin(2 * kPi * freq_hz * i / rates.in_hz) + 0.5));
+  }
+  std::vector<WebRtc_Word16> output;
+  if (Run(input, rates, 1, quality, &output) < 0) {
+    return false;
+  }
+
+  // Least squares fit of a * sin + b * cos, skipping the first 100 ms.
+  const int first = rates.out_hz / 10;
+  const int length = static_cast<int>(output.size()) - first;
+  double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+  for (int n = first; n < first + length; n++) {
+    const double w = 2 * kPi * freq_hz * n / rates.out_hz;
+    ss += sin(w) * sin(w);
+    sc += sin(w) * cos(w);
+    cc += cos(w) * cos(w);
+    ys += output[n] * sin(w);
+    yc += output[n] * cos(w);
+  }
+  const double det = ss * cc - sc * sc;
+  const double a = (ys * cc - yc * sc) / det;
+  const double b = (yc * ss - ys * sc) / det;
+  double noise = 0;
+  for (int n = first; n < first + length; n++) {
+    const double w = 2 * kPi * freq_hz * n / rates.out_hz;
+    const double e = output[n] - a * sin(w) - b * cos(w);
+    noise += e * e;
+  }
+  *gain_db = 20 * log10(sqrt(a * a + b * b) / kAmplitude);
+  *noise_db = 10 * log10((noise / length + 1e-9) /
+                         (kAmplitude * kAmplitude / 2));
+  return true;
+}
+}  // namespace
+
+int main(int /*argc*/, char* /*argv*/[]) {
+  const RatePair kRates[] = {
+    {44100, 48000}, {48000, 44100}, {44100, 16000}, {16000, 44100},
+    {44100, 32000}, {32000, 44100}, {44100, 8000}, {8000, 44100}
+  };
+  const webrtc::ResamplerQuality kQualities[] = {
+    webrtc::kResamplerQualityLow, webrtc::kResamplerQualityMedium,
+    webrtc::kResamplerQualityHigh
+  };
+  const char* kQualityNames[] = {"low", "medium", "high"};
+
+  const WebRtc_CPUInfo get_cpu_info = WebRtc_GetCPUInfo;
+  int failures = 0;
+  for (size_t r = 0; r < sizeof(kRates) / sizeof(*kRates); r++) {
+    for (int num_channels = 1; num_channels <= 2; num_channels++) {
+      // A chirp from 0 Hz to the input Nyquist frequency at -6 dBFS.
+      const int length = kRates[r].in_hz * kSeconds;
+      std::vector<WebRtc_Word16> input(length * num_channels);
+      for (int i = 0; i < length; i++) {
+        const double t = static_cast<double>(i) / kRates[r].in_hz;
+        const double f = kRates[r].in_hz / 4.0 * t / kSeconds;
+        for (int ch = 0; ch < num_channels; ch++) {
+          input[i * num_channels + ch] = static_cast<WebRtc_Word16>(
+              16384 * sin(2 * kPi * f * t + ch));
+        }
+      }
+
+      for (size_t q = 0; q < sizeof(kQualities) / sizeof(*kQualities); q++) {
+        std::vector<WebRtc_Word16> reference;
+        std::vector<WebRtc_Word16> optimized;
+
+        // Resampler::Reset() selects the functions to use.
+        WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+        const WebRtc_Word64 c_us = Run(input, kRates[r], num_channels,
+                                       kQualities[q], &reference);
+        WebRtc_GetCPUInfo = get_cpu_info;
+        const WebRtc_Word64 simd_us = Run(input, kRates[r], num_channels,
+                                          kQualities[q], &optimized);
+        if (c_us < 0 || simd_us < 0) {
+          printf("Resampling %d -> %d Hz failed\n", kRates[r].in_hz,
+                 kRates[r].out_hz);
+          return 1;
+        }
+
+        const bool bit_exact = reference == optimized;
+        if (!bit_exact) {
+          failures++;
+        }
+        printf("%5d -> %5d Hz %d ch %-6s: C %6.1f ms, SIMD %6.1f ms (%.2fx), "
+               "%s\n", kRates[r].in_hz, kRates[r].out_hz, num_channels,
+               kQualityNames[q], c_us / 1000.0, simd_us / 1000.0,
+               simd_us > 0 ? (double)c_us / simd_us : 0.0,
+               bit_exact ? "bit exact" : "NOT bit exact");
+      }
+    }
+  }
+
+  // Per quality: the largest gain error of a passband sine, and the largest
+  // levels of its noise and of the aliases of a sine that should be removed.
+  const double kMaxGainErrorDb[] = {0.5, 0.1, 0.05};
+  const double kMaxNoiseDb[] = {-60, -60, -60};
+  const double kMaxAliasDb[] = {-50, -55, -65};
+  int quality_failures = 0;
+  for (size_t r = 0; r < sizeof(kRates) / sizeof(*kRates); r++) {
+    const int in_hz = kRates[r].in_hz;
+    const int out_hz = kRates[r].out_hz;
+    for (size_t q = 0; q < sizeof(kQualities) / sizeof(*kQualities); q++) {
+      // In the passband of every quality.
+      const double pass_hz = 0.1 * (in_hz < out_hz ? in_hz : out_hz);
+      double gain_db = 0;
+      double noise_db = 0;
+      if (!MeasureSine(kRates[r], kQualities[q], pass_hz, &gain_db,
+                       &noise_db)) {
+        printf("Resampling %d -> %d Hz failed\n", in_hz, out_hz);
+        return 1;
+      }
+      bool ok = fabs(gain_db) <= kMaxGainErrorDb[q] &&
+          noise_db <= kMaxNoiseDb[q];
+      printf("%5d -> %5d Hz %-6s: passband gain %5.2f dB, noise %4.0f dB",
+             in_hz, out_hz, kQualityNames[q], gain_db, noise_db);
+
+      if (in_hz > out_hz) {
+        // Above the output Nyquist frequency, past the transition band.
+        const double alias_hz = out_hz / 2.0 + 0.7 * (in_hz - out_hz) / 2.0;
+        if (!MeasureSine(kRates[r], kQualities[q], alias_hz, &gain_db,
+                         &noise_db)) {
+          printf("\nResampling %d -> %d Hz failed\n", in_hz, out_hz);
+          return 1;
+        }
+        const double alias_db = 10 * log10(pow(10, gain_db / 10) +
+                                           pow(10, noise_db / 10));
+        ok = ok && alias_db <= kMaxAliasDb[q];
+        printf(", aliases %4.0f dB", alias_db);
+      }
+      printf(", %s\n", ok ? "ok" : "FAILED");
+      if (!ok) {
+        quality_failures++;
+      }
+    }
+  }
+
+  if (failures > 0 || quality_failures > 0) {
+    printf("FAILED: %d runs were not bit exact, %d failed the quality "
+           "checks\n", failures, quality_failures);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
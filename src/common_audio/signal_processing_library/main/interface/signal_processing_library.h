@@ -205,6 +205,15 @@ int WebRtcSpl_NormU32(WebRtc_UWord32 value);
 #include "spl_inl.h"
 #endif
 
+// Initialize SPL. Points the function pointers declared below, e.g.
+// WebRtcSpl_MaxAbsValueW16 and WebRtcSpl_ComplexFFT, to their C, SSE2 or NEON
+// versions depending on WebRtc_GetCPUInfo(). It is done automatically by the
+// first call of any of them, so this only needs to be called to redo the
+// selection, e.g. after changing WebRtc_GetCPUInfo in a test.
+void WebRtcSpl_Init(void);
+void WebRtcSpl_InitSSE2(void);
+void WebRtcSpl_InitNeon(void);
+
 // Get SPL Version
 WebRtc_Word16 WebRtcSpl_get_version(char* version,
                                     WebRtc_Word16 length_in_bytes);
@@ -240,8 +249,11 @@ WebRtc_Word16 WebRtcSpl_OnesArrayW32(WebRtc_Word32* vector,
 
 // Minimum and maximum operations. Implementation in min_max_operations.c.
 // Descriptions at bottom of file.
-WebRtc_Word16 WebRtcSpl_MaxAbsValueW16(G_CONST WebRtc_Word16* vector,
-                                       WebRtc_Word16 length);
+typedef WebRtc_Word16 (*WebRtcSpl_MaxAbsValueW16_t)(G_CONST WebRtc_Word16* vector,
+                                                    WebRtc_Word16 length);
+extern WebRtcSpl_MaxAbsValueW16_t WebRtcSpl_MaxAbsValueW16;
+WebRtc_Word16 WebRtcSpl_MaxAbsValueW16C(G_CONST WebRtc_Word16* vector,
+                                        WebRtc_Word16 length);
 WebRtc_Word32 WebRtcSpl_MaxAbsValueW32(G_CONST WebRtc_Word32* vector,
                                        WebRtc_Word16 length);
 WebRtc_Word16 WebRtcSpl_MinValueW16(G_CONST WebRtc_Word16* vector,
@@ -354,13 +366,21 @@ void WebRtcSpl_LpcToReflCoef(WebRtc_Word16* lpc_coef,
 void WebRtcSpl_AutoCorrToReflCoef(G_CONST WebRtc_Word32* auto_corr,
                                   int use_order,
                                   WebRtc_Word16* refl_coef);
-void WebRtcSpl_CrossCorrelation(WebRtc_Word32* cross_corr,
-                                WebRtc_Word16* vector1,
-                                WebRtc_Word16* vector2,
-                                WebRtc_Word16 dim_vector,
-                                WebRtc_Word16 dim_cross_corr,
-                                WebRtc_Word16 right_shifts,
-                                WebRtc_Word16 step_vector2);
+typedef void (*WebRtcSpl_CrossCorrelation_t)(WebRtc_Word32* cross_corr,
+                                             WebRtc_Word16* vector1,
+                                             WebRtc_Word16* vector2,
+                                             WebRtc_Word16 dim_vector,
+                                             WebRtc_Word16 dim_cross_corr,
+                                             WebRtc_Word16 right_shifts,
+                                             WebRtc_Word16 step_vector2);
+extern WebRtcSpl_CrossCorrelation_t WebRtcSpl_CrossCorrelation;
+void WebRtcSpl_CrossCorrelationC(WebRtc_Word32* cross_corr,
+                                 WebRtc_Word16* vector1,
+                                 WebRtc_Word16* vector2,
+                                 WebRtc_Word16 dim_vector,
+                                 WebRtc_Word16 dim_cross_corr,
+                                 WebRtc_Word16 right_shifts,
+                                 WebRtc_Word16 step_vector2);
 void WebRtcSpl_GetHanningWindow(WebRtc_Word16* window, WebRtc_Word16 size);
 void WebRtcSpl_SqrtOfOneMinusXSquared(WebRtc_Word16* in_vector,
                                       int vector_length,
@@ -395,10 +415,15 @@ WebRtc_Word32 WebRtcSpl_Energy(WebRtc_Word16* vector,
                                int vector_length,
                                int* scale_factor);
 
-WebRtc_Word32 WebRtcSpl_DotProductWithScale(WebRtc_Word16* vector1,
-                                            WebRtc_Word16* vector2,
-                                            int vector_length,
-                                            int scaling);
+typedef WebRtc_Word32 (*WebRtcSpl_DotProductWithScale_t)(WebRtc_Word16* vector1,
+                                                         WebRtc_Word16* vector2,
+                                                         int vector_length,
+                                                         int scaling);
+extern WebRtcSpl_DotProductWithScale_t WebRtcSpl_DotProductWithScale;
+WebRtc_Word32 WebRtcSpl_DotProductWithScaleC(WebRtc_Word16* vector1,
+                                             WebRtc_Word16* vector2,
+                                             int vector_length,
+                                             int scaling);
 
 // Filter operations.
 int WebRtcSpl_FilterAR(G_CONST WebRtc_Word16* ar_coef, int ar_coef_length,
@@ -413,24 +438,42 @@ void WebRtcSpl_FilterMAFastQ12(WebRtc_Word16* in_vector,
                                WebRtc_Word16* ma_coef,
                                WebRtc_Word16 ma_coef_length,
                                WebRtc_Word16 vector_length);
-void WebRtcSpl_FilterARFastQ12(WebRtc_Word16* in_vector,
-                               WebRtc_Word16* out_vector,
-                               WebRtc_Word16* ar_coef,
-                               WebRtc_Word16 ar_coef_length,
-                               WebRtc_Word16 vector_length);
-int WebRtcSpl_DownsampleFast(WebRtc_Word16* in_vector,
-                             WebRtc_Word16 in_vector_length,
-                             WebRtc_Word16* out_vector,
-                             WebRtc_Word16 out_vector_length,
-                             WebRtc_Word16* ma_coef,
-                             WebRtc_Word16 ma_coef_length,
-                             WebRtc_Word16 factor,
-                             WebRtc_Word16 delay);
+typedef void (*WebRtcSpl_FilterARFastQ12_t)(WebRtc_Word16* in_vector,
+                                            WebRtc_Word16* out_vector,
+                                            WebRtc_Word16* ar_coef,
+                                            WebRtc_Word16 ar_coef_length,
+                                            WebRtc_Word16 vector_length);
+extern WebRtcSpl_FilterARFastQ12_t WebRtcSpl_FilterARFastQ12;
+void WebRtcSpl_FilterARFastQ12C(WebRtc_Word16* in_vector,
+                                WebRtc_Word16* out_vector,
+                                WebRtc_Word16* ar_coef,
+                                WebRtc_Word16 ar_coef_length,
+                                WebRtc_Word16 vector_length);
+typedef int (*WebRtcSpl_DownsampleFast_t)(WebRtc_Word16* in_vector,
+                                          WebRtc_Word16 in_vector_length,
+                                          WebRtc_Word16* out_vector,
+                                          WebRtc_Word16 out_vector_length,
+                                          WebRtc_Word16* ma_coef,
+                                          WebRtc_Word16 ma_coef_length,
+                                          WebRtc_Word16 factor,
+                                          WebRtc_Word16 delay);
+extern WebRtcSpl_DownsampleFast_t WebRtcSpl_DownsampleFast;
+int WebRtcSpl_DownsampleFastC(WebRtc_Word16* in_vector,
+                              WebRtc_Word16 in_vector_length,
+                              WebRtc_Word16* out_vector,
+                              WebRtc_Word16 out_vector_length,
+                              WebRtc_Word16* ma_coef,
+                              WebRtc_Word16 ma_coef_length,
+                              WebRtc_Word16 factor,
+                              WebRtc_Word16 delay);
 // End: Filter operations.
 
 // FFT operations
-int WebRtcSpl_ComplexFFT(WebRtc_Word16 vector[], int stages, int mode);
-int WebRtcSpl_ComplexIFFT(WebRtc_Word16 vector[], int stages, int mode);
+typedef int (*WebRtcSpl_ComplexFFT_t)(WebRtc_Word16 vector[], int stages, int mode);
+extern WebRtcSpl_ComplexFFT_t WebRtcSpl_ComplexFFT;
+extern WebRtcSpl_ComplexFFT_t WebRtcSpl_ComplexIFFT;
+int WebRtcSpl_ComplexFFTC(WebRtc_Word16 vector[], int stages, int mode);
+int WebRtcSpl_ComplexIFFTC(WebRtc_Word16 vector[], int stages, int mode);
 void WebRtcSpl_ComplexBitReverse(WebRtc_Word16 vector[], int stages);
 // End: FFT operations
 
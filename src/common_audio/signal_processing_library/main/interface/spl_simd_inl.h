@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+// This header file includes the inline SIMD helpers shared by the SSE2 and
+// NEON code of the signal processing library and its users. It is only
+// included by files built with the matching instruction set.
+
+#ifndef WEBRTC_SPL_SPL_SIMD_INL_H_
+#define WEBRTC_SPL_SPL_SIMD_INL_H_
+
+#include "typedefs.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+// Adds the four 32-bit values of |a|.
+static __inline WebRtc_Word32 WebRtcSpl_HorizontalSumSSE2(__m128i a) {
+  a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+  a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(a);
+}
+#endif
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+
+// Adds the four 32-bit values of |a|.
+static __inline WebRtc_Word32 WebRtcSpl_HorizontalSumNeon(int32x4_t a) {
+  const int32x2_t half = vadd_s32(vget_low_s32(a), vget_high_s32(a));
+  return vget_lane_s32(vpadd_s32(half, half), 0);
+}
+#endif
+
+#endif  // WEBRTC_SPL_SPL_SIMD_INL_H_
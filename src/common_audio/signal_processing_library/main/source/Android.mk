@@ -53,6 +53,7 @@ LOCAL_SRC_FILES := add_sat_w16.c \
     resample_fractional.c \
     sin_table.c \
     sin_table_1024.c \
+    spl_init.c \
     spl_sqrt.c \
     spl_version.c \
     splitting_filter.c \
@@ -61,6 +62,12 @@ LOCAL_SRC_FILES := add_sat_w16.c \
     sub_sat_w32.c \
     vector_scaling_operations.c
 
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
+    spl_neon.c.neon
+MY_ARCH_DEFS := '-DWEBRTC_ARCH_ARM_NEON'
+endif
+
 # Flags passed to both C and C++ files.
 MY_CFLAGS :=  
 MY_CFLAGS_C :=
@@ -73,7 +80,7 @@ MY_DEFS += \
     '-DWEBRTC_ANDROID' \
     '-DANDROID' 
 endif
-LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS)
+LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS) $(MY_ARCH_DEFS)
 
 # Include paths placed before CFLAGS/CPPFLAGS
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../../.. \
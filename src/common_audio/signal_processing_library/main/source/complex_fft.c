@@ -21,7 +21,7 @@
 #define CFFTRND 1
 #define CFFTRND2 16384
 
-int WebRtcSpl_ComplexFFT(WebRtc_Word16 frfi[], int stages, int mode)
+int WebRtcSpl_ComplexFFTC(WebRtc_Word16 frfi[], int stages, int mode)
 {
     int i, j, l, k, istep, n, m;
     WebRtc_Word16 wr, wi;
@@ -20,7 +20,7 @@
 #define CIFFTSFT 14
 #define CIFFTRND 1
 
-int WebRtcSpl_ComplexIFFT(WebRtc_Word16 frfi[], int stages, int mode)
+int WebRtcSpl_ComplexIFFTC(WebRtc_Word16 frfi[], int stages, int mode)
 {
     int i, j, l, k, istep, n, m, scale, shift;
     WebRtc_Word16 wr, wi;
@@ -17,8 +17,8 @@
 
 #include "signal_processing_library.h"
 
-WebRtc_Word32 WebRtcSpl_DotProductWithScale(WebRtc_Word16 *vector1, WebRtc_Word16 *vector2,
-                                            int length, int scaling)
+WebRtc_Word32 WebRtcSpl_DotProductWithScaleC(WebRtc_Word16 *vector1, WebRtc_Word16 *vector2,
+                                             int length, int scaling)
 {
     WebRtc_Word32 sum;
     int i;
@@ -29,7 +29,7 @@
 #include "signal_processing_library.h"
 
 // Maximum absolute value of word16 vector.
-WebRtc_Word16 WebRtcSpl_MaxAbsValueW16(G_CONST WebRtc_Word16 *vector, WebRtc_Word16 length)
+WebRtc_Word16 WebRtcSpl_MaxAbsValueW16C(G_CONST WebRtc_Word16 *vector, WebRtc_Word16 length)
 {
     WebRtc_Word32 tempMax = 0;
     WebRtc_Word32 absVal;
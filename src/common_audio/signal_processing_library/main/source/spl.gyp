@@ -14,6 +14,9 @@
     {
       'target_name': 'spl',
       'type': '<(library)',
+      'dependencies': [
+        '../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
       'include_dirs': [
         '../interface',
       ],
@@ -25,6 +28,7 @@
       'sources': [
         '../interface/signal_processing_library.h',
         '../interface/spl_inl.h',
+        '../interface/spl_simd_inl.h',
         'add_sat_w16.c',
         'add_sat_w32.c',
         'auto_corr_to_refl_coef.c',
@@ -65,6 +69,7 @@
         'sin_table.c',
         'sin_table_1024.c',
         'spl_sqrt.c',
+        'spl_init.c',
         'spl_sqrt_floor.c',
         'spl_version.c',
         'splitting_filter.c',
@@ -73,6 +78,36 @@
         'sub_sat_w32.c',
         'vector_scaling_operations.c',
       ],
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'spl_sse2.c',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'spl_neon.c',
+          ],
+        }],
+      ],
+    },
+    {
+      'target_name': 'spl_unit_test',
+      'type': 'executable',
+      'dependencies': [
+        'spl',
+        '../../../../../testing/gtest.gyp:gtest',
+      ],
+      'include_dirs': [
+        '../../../../../testing/gtest/include',
+      ],
+      'sources': [
+        '../test/unit_test/unit_test.cc',
+        '../test/unit_test/unit_test.h',
+      ],
     },
   ],
 }
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the function pointers of the SPL functions that have
+ * SSE2 and NEON versions, and WebRtcSpl_Init() which selects them.
+ * The description header can be found in signal_processing_library.h
+ *
+ */
+
+#include "signal_processing_library.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
+
+// Until WebRtcSpl_Init() has run, the function pointers point to the functions
+// below, which run it and then make the call through the selected version.
+// Threads racing through the first calls all store the same values.
+
+static WebRtc_Word16 MaxAbsValueW16Init(G_CONST WebRtc_Word16* vector,
+                                        WebRtc_Word16 length) {
+  WebRtcSpl_Init();
+  return WebRtcSpl_MaxAbsValueW16(vector, length);
+}
+
+static void CrossCorrelationInit(WebRtc_Word32* cross_corr,
+                                 WebRtc_Word16* vector1,
+                                 WebRtc_Word16* vector2,
+                                 WebRtc_Word16 dim_vector,
+                                 WebRtc_Word16 dim_cross_corr,
+                                 WebRtc_Word16 right_shifts,
+                                 WebRtc_Word16 step_vector2) {
+  WebRtcSpl_Init();
+  WebRtcSpl_CrossCorrelation(cross_corr, vector1, vector2, dim_vector,
+                             dim_cross_corr, right_shifts, step_vector2);
+}
+
+static WebRtc_Word32 DotProductWithScaleInit(WebRtc_Word16* vector1,
+                                             WebRtc_Word16* vector2,
+                                             int vector_length,
+                                             int scaling) {
+  WebRtcSpl_Init();
+  return WebRtcSpl_DotProductWithScale(vector1, vector2, vector_length,
+                                       scaling);
+}
+
+static void FilterARFastQ12Init(WebRtc_Word16* in_vector,
+                                WebRtc_Word16* out_vector,
+                                WebRtc_Word16* ar_coef,
+                                WebRtc_Word16 ar_coef_length,
+                                WebRtc_Word16 vector_length) {
+  WebRtcSpl_Init();
+  WebRtcSpl_FilterARFastQ12(in_vector, out_vector, ar_coef, ar_coef_length,
+                            vector_length);
+}
+
+static int DownsampleFastInit(WebRtc_Word16* in_vector,
+                              WebRtc_Word16 in_vector_length,
+                              WebRtc_Word16* out_vector,
+                              WebRtc_Word16 out_vector_length,
+                              WebRtc_Word16* ma_coef,
+                              WebRtc_Word16 ma_coef_length,
+                              WebRtc_Word16 factor,
+                              WebRtc_Word16 delay) {
+  WebRtcSpl_Init();
+  return WebRtcSpl_DownsampleFast(in_vector, in_vector_length, out_vector,
+                                  out_vector_length, ma_coef, ma_coef_length,
+                                  factor, delay);
+}
+
+static int ComplexFFTInit(WebRtc_Word16 vector[], int stages, int mode) {
+  WebRtcSpl_Init();
+  return WebRtcSpl_ComplexFFT(vector, stages, mode);
+}
+
+static int ComplexIFFTInit(WebRtc_Word16 vector[], int stages, int mode) {
+  WebRtcSpl_Init();
+  return WebRtcSpl_ComplexIFFT(vector, stages, mode);
+}
+
+WebRtcSpl_MaxAbsValueW16_t WebRtcSpl_MaxAbsValueW16 = MaxAbsValueW16Init;
+WebRtcSpl_CrossCorrelation_t WebRtcSpl_CrossCorrelation = CrossCorrelationInit;
+WebRtcSpl_DotProductWithScale_t WebRtcSpl_DotProductWithScale =
+    DotProductWithScaleInit;
+WebRtcSpl_FilterARFastQ12_t WebRtcSpl_FilterARFastQ12 = FilterARFastQ12Init;
+WebRtcSpl_DownsampleFast_t WebRtcSpl_DownsampleFast = DownsampleFastInit;
+WebRtcSpl_ComplexFFT_t WebRtcSpl_ComplexFFT = ComplexFFTInit;
+WebRtcSpl_ComplexFFT_t WebRtcSpl_ComplexIFFT = ComplexIFFTInit;
+
+void WebRtcSpl_Init(void) {
+  WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16C;
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationC;
+  WebRtcSpl_DotProductWithScale = WebRtcSpl_DotProductWithScaleC;
+  WebRtcSpl_FilterARFastQ12 = WebRtcSpl_FilterARFastQ12C;
+  WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
+  WebRtcSpl_ComplexFFT = WebRtcSpl_ComplexFFTC;
+  WebRtcSpl_ComplexIFFT = WebRtcSpl_ComplexIFFTC;
+
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+#if defined(__SSE2__)
+    WebRtcSpl_InitSSE2();
+#endif
+  }
+  if (WebRtc_GetCPUInfo(kNEON)) {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+    WebRtcSpl_InitNeon();
+#endif
+  }
+}
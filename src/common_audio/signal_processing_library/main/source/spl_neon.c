@@ -0,0 +1,255 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * NEON versions of the SPL functions selected in WebRtcSpl_Init(). The results
+ * are bit exact with the C versions.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+
+#include "signal_processing_library.h"
+#include "spl_simd_inl.h"
+
+// Returns the sum of (vector1[i] * vector2[i]) >> scaling, with the products
+// shifted one by one as in C.
+static WebRtc_Word32 DotProduct(const WebRtc_Word16* vector1,
+                                const WebRtc_Word16* vector2,
+                                int length,
+                                int scaling) {
+  const int32x4_t shift = vdupq_n_s32(-scaling);
+  int32x4_t sum = vdupq_n_s32(0);
+  WebRtc_Word32 result;
+  int i = 0;
+
+  for (; i + 8 <= length; i += 8) {
+    const int16x8_t a = vld1q_s16(&vector1[i]);
+    const int16x8_t b = vld1q_s16(&vector2[i]);
+    sum = vaddq_s32(sum, vshlq_s32(vmull_s16(vget_low_s16(a),
+                                             vget_low_s16(b)), shift));
+    sum = vaddq_s32(sum, vshlq_s32(vmull_s16(vget_high_s16(a),
+                                             vget_high_s16(b)), shift));
+  }
+  result = WebRtcSpl_HorizontalSumNeon(sum);
+  for (; i < length; i++) {
+    result += WEBRTC_SPL_MUL_16_16_RSFT(vector1[i], vector2[i], scaling);
+  }
+  return result;
+}
+
+static WebRtc_Word16 MaxAbsValueW16Neon(G_CONST WebRtc_Word16* vector,
+                                        WebRtc_Word16 length) {
+  // The saturating absolute value makes |-32768| 32767, which is the result of
+  // the C version as well.
+  int16x8_t max_abs = vdupq_n_s16(0);
+  int16x4_t max4;
+  WebRtc_Word16 result;
+  int i;
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    max_abs = vmaxq_s16(max_abs, vqabsq_s16(vld1q_s16(&vector[i])));
+  }
+  max4 = vmax_s16(vget_low_s16(max_abs), vget_high_s16(max_abs));
+  max4 = vpmax_s16(max4, max4);
+  max4 = vpmax_s16(max4, max4);
+  result = vget_lane_s16(max4, 0);
+  if (i < length) {
+    const WebRtc_Word16 tail = WebRtcSpl_MaxAbsValueW16C(&vector[i],
+                                                         length - i);
+    result = (tail > result) ? tail : result;
+  }
+  return result;
+}
+
+static void CrossCorrelationNeon(WebRtc_Word32* cross_corr,
+                                 WebRtc_Word16* vector1,
+                                 WebRtc_Word16* vector2,
+                                 WebRtc_Word16 dim_vector,
+                                 WebRtc_Word16 dim_cross_corr,
+                                 WebRtc_Word16 right_shifts,
+                                 WebRtc_Word16 step_vector2) {
+  int i;
+
+  for (i = 0; i < dim_cross_corr; i++) {
+    cross_corr[i] = DotProduct(vector1, &vector2[step_vector2 * i], dim_vector,
+                               right_shifts);
+  }
+}
+
+static WebRtc_Word32 DotProductWithScaleNeon(WebRtc_Word16* vector1,
+                                             WebRtc_Word16* vector2,
+                                             int vector_length,
+                                             int scaling) {
+  return DotProduct(vector1, vector2, vector_length, scaling);
+}
+
+// Loads the twiddle factors of the butterflies |m[0]| .. |m[3]| of the stage
+// with index step |k|. |sign| is -1 for the FFT and 1 for the IFFT.
+static __inline void LoadTwiddles(const int m[4], int k, int sign,
+                                  int16x4_t* wr, int16x4_t* wi) {
+  WebRtc_Word16 w[8];
+  int p;
+
+  for (p = 0; p < 4; p++) {
+    w[p] = WebRtcSpl_kSinTable1024[(m[p] << k) + 256];
+    w[p + 4] = (WebRtc_Word16)(sign * WebRtcSpl_kSinTable1024[m[p] << k]);
+  }
+  *wr = vld1_s16(&w[0]);
+  *wi = vld1_s16(&w[4]);
+}
+
+// Four butterflies of WebRtcSpl_ComplexFFTC() or WebRtcSpl_ComplexIFFTC() on
+// the real and imaginary parts of frfi[2 * i] (|q|) and frfi[2 * j] (|x|). The
+// outputs are shifted by |shift_count| (negative for right shifts), and
+// |round_q| is added to them in mode 1. vmovn_s32() truncates the results to
+// 16 bits as the casts in C.
+static __inline void Butterflies(int mode, int32x4_t shift_count,
+                                 int32x4_t round_q, int16x4_t wr,
+                                 int16x4_t wi, int16x4_t* q_re,
+                                 int16x4_t* q_im, int16x4_t* x_re,
+                                 int16x4_t* x_im) {
+  int32x4_t tr = vmlsl_s16(vmull_s16(wr, *x_re), wi, *x_im);
+  int32x4_t ti = vmlal_s16(vmull_s16(wr, *x_im), wi, *x_re);
+  int32x4_t qr = vmovl_s16(*q_re);
+  int32x4_t qi = vmovl_s16(*q_im);
+
+  if (mode == 0) {
+    tr = vshrq_n_s32(tr, 15);
+    ti = vshrq_n_s32(ti, 15);
+  } else {
+    const int32x4_t one = vdupq_n_s32(1);
+    tr = vshrq_n_s32(vaddq_s32(tr, one), 1);
+    ti = vshrq_n_s32(vaddq_s32(ti, one), 1);
+    qr = vaddq_s32(vshlq_n_s32(qr, 14), round_q);
+    qi = vaddq_s32(vshlq_n_s32(qi, 14), round_q);
+  }
+
+  *x_re = vmovn_s32(vshlq_s32(vsubq_s32(qr, tr), shift_count));
+  *x_im = vmovn_s32(vshlq_s32(vsubq_s32(qi, ti), shift_count));
+  *q_re = vmovn_s32(vshlq_s32(vaddq_s32(qr, tr), shift_count));
+  *q_im = vmovn_s32(vshlq_s32(vaddq_s32(qi, ti), shift_count));
+}
+
+// Runs the stage of span |l| of WebRtcSpl_ComplexFFTC() (|sign| -1, |shift| 1)
+// or WebRtcSpl_ComplexIFFTC() (|sign| 1). |n| must be a multiple of 8.
+static void FftStage(WebRtc_Word16* frfi, int n, int l, int mode, int sign,
+                     int shift) {
+  const int k = 10 - WebRtcSpl_GetSizeInBits(l);
+  const int32x4_t shift_count = vdupq_n_s32(mode == 0 ? -shift :
+                                            -(shift + 14));
+  const int32x4_t round_q = vdupq_n_s32(8192 << shift);
+  int16x4_t wr, wi;
+  int i, m;
+
+  if (l == 1) {
+    // Eight values are (q0 x0 q1 x1 q2 x2 q3 x3), all with twiddle index 0.
+    const int index[4] = {0, 0, 0, 0};
+    LoadTwiddles(index, k, sign, &wr, &wi);
+    for (i = 0; i < n; i += 8) {
+      int16x4x4_t v = vld4_s16(&frfi[2 * i]);
+      Butterflies(mode, shift_count, round_q, wr, wi, &v.val[0], &v.val[1],
+                  &v.val[2], &v.val[3]);
+      vst4_s16(&frfi[2 * i], v);
+    }
+  } else if (l == 2) {
+    // Eight values are (q0 q1 x0 x1 q2 q3 x2 x3), with twiddle index 0 and 1.
+    const int index[4] = {0, 1, 0, 1};
+    LoadTwiddles(index, k, sign, &wr, &wi);
+    for (i = 0; i < n; i += 8) {
+      const int16x8_t a = vld1q_s16(&frfi[2 * i]);
+      const int16x8_t b = vld1q_s16(&frfi[2 * i + 8]);
+      int16x8x2_t v = vuzpq_s16(vcombine_s16(vget_low_s16(a),
+                                             vget_low_s16(b)),
+                                vcombine_s16(vget_high_s16(a),
+                                             vget_high_s16(b)));
+      int16x4_t q_re = vget_low_s16(v.val[0]);
+      int16x4_t x_re = vget_high_s16(v.val[0]);
+      int16x4_t q_im = vget_low_s16(v.val[1]);
+      int16x4_t x_im = vget_high_s16(v.val[1]);
+      Butterflies(mode, shift_count, round_q, wr, wi, &q_re, &q_im, &x_re,
+                  &x_im);
+      v = vzipq_s16(vcombine_s16(q_re, x_re), vcombine_s16(q_im, x_im));
+      vst1q_s16(&frfi[2 * i], vcombine_s16(vget_low_s16(v.val[0]),
+                                           vget_low_s16(v.val[1])));
+      vst1q_s16(&frfi[2 * i + 8], vcombine_s16(vget_high_s16(v.val[0]),
+                                               vget_high_s16(v.val[1])));
+    }
+  } else {
+    // Four consecutive butterflies share the loaded twiddle factors for all
+    // blocks of the stage.
+    for (m = 0; m < l; m += 4) {
+      const int index[4] = {m, m + 1, m + 2, m + 3};
+      LoadTwiddles(index, k, sign, &wr, &wi);
+      for (i = m; i < n; i += 2 * l) {
+        int16x4x2_t q = vld2_s16(&frfi[2 * i]);
+        int16x4x2_t x = vld2_s16(&frfi[2 * (i + l)]);
+        Butterflies(mode, shift_count, round_q, wr, wi, &q.val[0], &q.val[1],
+                    &x.val[0], &x.val[1]);
+        vst2_s16(&frfi[2 * i], q);
+        vst2_s16(&frfi[2 * (i + l)], x);
+      }
+    }
+  }
+}
+
+static int ComplexFFTNeon(WebRtc_Word16 vector[], int stages, int mode) {
+  const int n = 1 << stages;
+  int l;
+
+  if (n < 8) {
+    return WebRtcSpl_ComplexFFTC(vector, stages, mode);
+  }
+  if (n > 1024) {
+    return -1;
+  }
+  for (l = 1; l < n; l <<= 1) {
+    FftStage(vector, n, l, mode, -1, 1);
+  }
+  return 0;
+}
+
+static int ComplexIFFTNeon(WebRtc_Word16 vector[], int stages, int mode) {
+  const int n = 1 << stages;
+  int scale = 0;
+  int l;
+
+  if (n < 8) {
+    return WebRtcSpl_ComplexIFFTC(vector, stages, mode);
+  }
+  if (n > 1024) {
+    return -1;
+  }
+  for (l = 1; l < n; l <<= 1) {
+    // Variable scaling, depending upon data.
+    const WebRtc_Word32 max_abs = MaxAbsValueW16Neon(vector, 2 * n);
+    int shift = 0;
+    if (max_abs > 13573) {
+      shift++;
+    }
+    if (max_abs > 27146) {
+      shift++;
+    }
+    scale += shift;
+
+    FftStage(vector, n, l, mode, 1, shift);
+  }
+  return scale;
+}
+
+void WebRtcSpl_InitNeon(void) {
+  WebRtcSpl_MaxAbsValueW16 = MaxAbsValueW16Neon;
+  WebRtcSpl_CrossCorrelation = CrossCorrelationNeon;
+  WebRtcSpl_DotProductWithScale = DotProductWithScaleNeon;
+  WebRtcSpl_ComplexFFT = ComplexFFTNeon;
+  WebRtcSpl_ComplexIFFT = ComplexIFFTNeon;
+}
+
+#endif  // WEBRTC_ARCH_ARM_NEON
@@ -0,0 +1,269 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * SSE2 versions of the SPL functions selected in WebRtcSpl_Init(). The results
+ * are bit exact with the C versions.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#include "signal_processing_library.h"
+#include "spl_simd_inl.h"
+
+// Returns the sum of (vector1[i] * vector2[i]) >> scaling. The products are
+// shifted one by one as in C, except for scaling 0 where pairs of them can be
+// added directly.
+static WebRtc_Word32 DotProduct(const WebRtc_Word16* vector1,
+                                const WebRtc_Word16* vector2,
+                                int length,
+                                int scaling) {
+  __m128i sum = _mm_setzero_si128();
+  WebRtc_Word32 result;
+  int i = 0;
+
+  if (scaling == 0) {
+    for (; i + 8 <= length; i += 8) {
+      const __m128i a = _mm_loadu_si128((const __m128i*)&vector1[i]);
+      const __m128i b = _mm_loadu_si128((const __m128i*)&vector2[i]);
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(a, b));
+    }
+  } else {
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    for (; i + 8 <= length; i += 8) {
+      const __m128i a = _mm_loadu_si128((const __m128i*)&vector1[i]);
+      const __m128i b = _mm_loadu_si128((const __m128i*)&vector2[i]);
+      const __m128i prod_lo = _mm_mullo_epi16(a, b);
+      const __m128i prod_hi = _mm_mulhi_epi16(a, b);
+      sum = _mm_add_epi32(sum, _mm_sra_epi32(
+          _mm_unpacklo_epi16(prod_lo, prod_hi), shift));
+      sum = _mm_add_epi32(sum, _mm_sra_epi32(
+          _mm_unpackhi_epi16(prod_lo, prod_hi), shift));
+    }
+  }
+  result = WebRtcSpl_HorizontalSumSSE2(sum);
+  for (; i < length; i++) {
+    result += WEBRTC_SPL_MUL_16_16_RSFT(vector1[i], vector2[i], scaling);
+  }
+  return result;
+}
+
+static WebRtc_Word16 MaxAbsValueW16SSE2(G_CONST WebRtc_Word16* vector,
+                                        WebRtc_Word16 length) {
+  // The saturating negation makes |-32768| 32767, which is the result of the
+  // C version as well.
+  __m128i max_abs = _mm_setzero_si128();
+  WebRtc_Word16 result;
+  int i;
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    const __m128i x = _mm_loadu_si128((const __m128i*)&vector[i]);
+    max_abs = _mm_max_epi16(max_abs, _mm_max_epi16(
+        x, _mm_subs_epi16(_mm_setzero_si128(), x)));
+  }
+  max_abs = _mm_max_epi16(max_abs, _mm_shuffle_epi32(max_abs,
+                                                     _MM_SHUFFLE(1, 0, 3, 2)));
+  max_abs = _mm_max_epi16(max_abs, _mm_shuffle_epi32(max_abs,
+                                                     _MM_SHUFFLE(2, 3, 0, 1)));
+  max_abs = _mm_max_epi16(max_abs, _mm_shufflelo_epi16(max_abs,
+                                                       _MM_SHUFFLE(2, 3, 0, 1)));
+  result = (WebRtc_Word16)_mm_extract_epi16(max_abs, 0);
+  if (i < length) {
+    const WebRtc_Word16 tail = WebRtcSpl_MaxAbsValueW16C(&vector[i],
+                                                         length - i);
+    result = (tail > result) ? tail : result;
+  }
+  return result;
+}
+
+static void CrossCorrelationSSE2(WebRtc_Word32* cross_corr,
+                                 WebRtc_Word16* vector1,
+                                 WebRtc_Word16* vector2,
+                                 WebRtc_Word16 dim_vector,
+                                 WebRtc_Word16 dim_cross_corr,
+                                 WebRtc_Word16 right_shifts,
+                                 WebRtc_Word16 step_vector2) {
+  int i;
+
+  for (i = 0; i < dim_cross_corr; i++) {
+    cross_corr[i] = DotProduct(vector1, &vector2[step_vector2 * i], dim_vector,
+                               right_shifts);
+  }
+}
+
+static WebRtc_Word32 DotProductWithScaleSSE2(WebRtc_Word16* vector1,
+                                             WebRtc_Word16* vector2,
+                                             int vector_length,
+                                             int scaling) {
+  return DotProduct(vector1, vector2, vector_length, scaling);
+}
+
+// Loads the twiddle factors of the butterflies |m[0]| .. |m[3]| of the stage
+// with index step |k|, as pairs of (wr, -wi) and (wi, wr). _mm_madd_epi16()
+// with interleaved (re, im) values then gives the real and imaginary parts of
+// the products. |sign| is -1 for the FFT and 1 for the IFFT.
+static __inline void LoadTwiddles(const int m[4], int k, int sign,
+                                  __m128i* w_re, __m128i* w_im) {
+  WebRtc_Word16 wr[4], wi[4];
+  int p;
+
+  for (p = 0; p < 4; p++) {
+    wr[p] = WebRtcSpl_kSinTable1024[(m[p] << k) + 256];
+    wi[p] = (WebRtc_Word16)(sign * WebRtcSpl_kSinTable1024[m[p] << k]);
+  }
+  *w_re = _mm_setr_epi16(wr[0], -wi[0], wr[1], -wi[1],
+                         wr[2], -wi[2], wr[3], -wi[3]);
+  *w_im = _mm_setr_epi16(wi[0], wr[0], wi[1], wr[1],
+                         wi[2], wr[2], wi[3], wr[3]);
+}
+
+// Four butterflies of WebRtcSpl_ComplexFFTC() or WebRtcSpl_ComplexIFFTC() on
+// the interleaved values |q| (frfi[2 * i]) and |x| (frfi[2 * j]). The outputs
+// are right shifted by |shift_count|, and |round_q| is added to them in mode
+// 1. The results are truncated to 16 bits as in C.
+static __inline void Butterflies(int mode, __m128i shift_count,
+                                 __m128i round_q, __m128i w_re, __m128i w_im,
+                                 __m128i* q, __m128i* x) {
+  const __m128i low_mask = _mm_set1_epi32(0x0000FFFF);
+  __m128i tr = _mm_madd_epi16(*x, w_re);
+  __m128i ti = _mm_madd_epi16(*x, w_im);
+  __m128i qr = _mm_srai_epi32(_mm_slli_epi32(*q, 16), 16);
+  __m128i qi = _mm_srai_epi32(*q, 16);
+  __m128i out_r, out_i;
+
+  if (mode == 0) {
+    tr = _mm_srai_epi32(tr, 15);
+    ti = _mm_srai_epi32(ti, 15);
+  } else {
+    const __m128i one = _mm_set1_epi32(1);
+    tr = _mm_srai_epi32(_mm_add_epi32(tr, one), 1);
+    ti = _mm_srai_epi32(_mm_add_epi32(ti, one), 1);
+    qr = _mm_add_epi32(_mm_slli_epi32(qr, 14), round_q);
+    qi = _mm_add_epi32(_mm_slli_epi32(qi, 14), round_q);
+  }
+
+  out_r = _mm_sra_epi32(_mm_sub_epi32(qr, tr), shift_count);
+  out_i = _mm_sra_epi32(_mm_sub_epi32(qi, ti), shift_count);
+  *x = _mm_or_si128(_mm_and_si128(out_r, low_mask), _mm_slli_epi32(out_i, 16));
+  out_r = _mm_sra_epi32(_mm_add_epi32(qr, tr), shift_count);
+  out_i = _mm_sra_epi32(_mm_add_epi32(qi, ti), shift_count);
+  *q = _mm_or_si128(_mm_and_si128(out_r, low_mask), _mm_slli_epi32(out_i, 16));
+}
+
+// Runs the stage of span |l| of WebRtcSpl_ComplexFFTC() (|sign| -1, |shift| 1)
+// or WebRtcSpl_ComplexIFFTC() (|sign| 1). |n| must be a multiple of 8.
+static void FftStage(WebRtc_Word16* frfi, int n, int l, int mode, int sign,
+                     int shift) {
+  const int k = 10 - WebRtcSpl_GetSizeInBits(l);
+  const __m128i shift_count = _mm_cvtsi32_si128(mode == 0 ? shift :
+                                                shift + 14);
+  const __m128i round_q = _mm_set1_epi32(8192 << shift);
+  __m128i w_re, w_im, q, x, a, b;
+  int i, m;
+
+  if (l == 1) {
+    // Eight values are (q0 x0 q1 x1 q2 x2 q3 x3), all with twiddle index 0.
+    const int index[4] = {0, 0, 0, 0};
+    LoadTwiddles(index, k, sign, &w_re, &w_im);
+    for (i = 0; i < n; i += 8) {
+      a = _mm_shuffle_epi32(_mm_loadu_si128((__m128i*)&frfi[2 * i]),
+                            _MM_SHUFFLE(3, 1, 2, 0));
+      b = _mm_shuffle_epi32(_mm_loadu_si128((__m128i*)&frfi[2 * i + 8]),
+                            _MM_SHUFFLE(3, 1, 2, 0));
+      q = _mm_unpacklo_epi64(a, b);
+      x = _mm_unpackhi_epi64(a, b);
+      Butterflies(mode, shift_count, round_q, w_re, w_im, &q, &x);
+      _mm_storeu_si128((__m128i*)&frfi[2 * i], _mm_unpacklo_epi32(q, x));
+      _mm_storeu_si128((__m128i*)&frfi[2 * i + 8], _mm_unpackhi_epi32(q, x));
+    }
+  } else if (l == 2) {
+    // Eight values are (q0 q1 x0 x1 q2 q3 x2 x3), with twiddle index 0 and 1.
+    const int index[4] = {0, 1, 0, 1};
+    LoadTwiddles(index, k, sign, &w_re, &w_im);
+    for (i = 0; i < n; i += 8) {
+      a = _mm_loadu_si128((__m128i*)&frfi[2 * i]);
+      b = _mm_loadu_si128((__m128i*)&frfi[2 * i + 8]);
+      q = _mm_unpacklo_epi64(a, b);
+      x = _mm_unpackhi_epi64(a, b);
+      Butterflies(mode, shift_count, round_q, w_re, w_im, &q, &x);
+      _mm_storeu_si128((__m128i*)&frfi[2 * i], _mm_unpacklo_epi64(q, x));
+      _mm_storeu_si128((__m128i*)&frfi[2 * i + 8], _mm_unpackhi_epi64(q, x));
+    }
+  } else {
+    // Four consecutive butterflies share the loaded twiddle factors for all
+    // blocks of the stage.
+    for (m = 0; m < l; m += 4) {
+      const int index[4] = {m, m + 1, m + 2, m + 3};
+      LoadTwiddles(index, k, sign, &w_re, &w_im);
+      for (i = m; i < n; i += 2 * l) {
+        q = _mm_loadu_si128((__m128i*)&frfi[2 * i]);
+        x = _mm_loadu_si128((__m128i*)&frfi[2 * (i + l)]);
+        Butterflies(mode, shift_count, round_q, w_re, w_im, &q, &x);
+        _mm_storeu_si128((__m128i*)&frfi[2 * i], q);
+        _mm_storeu_si128((__m128i*)&frfi[2 * (i + l)], x);
+      }
+    }
+  }
+}
+
+static int ComplexFFTSSE2(WebRtc_Word16 vector[], int stages, int mode) {
+  const int n = 1 << stages;
+  int l;
+
+  if (n < 8) {
+    return WebRtcSpl_ComplexFFTC(vector, stages, mode);
+  }
+  if (n > 1024) {
+    return -1;
+  }
+  for (l = 1; l < n; l <<= 1) {
+    FftStage(vector, n, l, mode, -1, 1);
+  }
+  return 0;
+}
+
+static int ComplexIFFTSSE2(WebRtc_Word16 vector[], int stages, int mode) {
+  const int n = 1 << stages;
+  int scale = 0;
+  int l;
+
+  if (n < 8) {
+    return WebRtcSpl_ComplexIFFTC(vector, stages, mode);
+  }
+  if (n > 1024) {
+    return -1;
+  }
+  for (l = 1; l < n; l <<= 1) {
+    // Variable scaling, depending upon data.
+    const WebRtc_Word32 max_abs = MaxAbsValueW16SSE2(vector, 2 * n);
+    int shift = 0;
+    if (max_abs > 13573) {
+      shift++;
+    }
+    if (max_abs > 27146) {
+      shift++;
+    }
+    scale += shift;
+
+    FftStage(vector, n, l, mode, 1, shift);
+  }
+  return scale;
+}
+
+void WebRtcSpl_InitSSE2(void) {
+  WebRtcSpl_MaxAbsValueW16 = MaxAbsValueW16SSE2;
+  WebRtcSpl_CrossCorrelation = CrossCorrelationSSE2;
+  WebRtcSpl_DotProductWithScale = DotProductWithScaleSSE2;
+  WebRtcSpl_ComplexFFT = ComplexFFTSSE2;
+  WebRtcSpl_ComplexIFFT = ComplexIFFTSSE2;
+}
+
+#endif  // __SSE2__
@@ -485,6 +485,92 @@ TEST_F(SplTest, FFTTest) {
     }
 }
 
+// Compares the functions selected by WebRtcSpl_Init(), which are the SSE2 or
+// NEON versions if the CPU has them, with the C versions.
+TEST_F(SplTest, SimdBitExactTest) {
+    const int kMaxLength = 2048;
+    WebRtc_Word16 x[kMaxLength];
+    WebRtc_Word16 y[kMaxLength];
+    WebRtc_Word16 ref[kMaxLength];
+    WebRtc_Word16 out[kMaxLength];
+    WebRtc_Word32 ref32[kMaxLength];
+    WebRtc_Word32 out32[kMaxLength];
+    WebRtc_UWord32 seed = 1;
+
+    WebRtcSpl_Init();
+
+    for (int trial = 0; trial < 20; ++trial) {
+        // Full scale noise, and every fourth trial also the extreme values.
+        for (int kk = 0; kk < kMaxLength; ++kk) {
+            x[kk] = WebRtcSpl_RandU(&seed) * 2 - 32767;
+            y[kk] = WebRtcSpl_RandU(&seed) * 2 - 32767;
+            if (trial % 4 == 0 && kk % 7 == 0) {
+                x[kk] = -32768;
+                y[kk] = (kk % 14 == 0) ? -32768 : 32767;
+            }
+        }
+
+        for (int length = 0; length < 40; ++length) {
+            EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(&x[trial], length),
+                      WebRtcSpl_MaxAbsValueW16(&x[trial], length));
+            for (int scaling = 0; scaling < 17; scaling += 4) {
+                EXPECT_EQ(WebRtcSpl_DotProductWithScaleC(x, &y[trial], length,
+                                                         scaling),
+                          WebRtcSpl_DotProductWithScale(x, &y[trial], length,
+                                                        scaling));
+            }
+        }
+
+        for (int step = -1; step <= 1; step += 2) {
+            WebRtcSpl_CrossCorrelationC(ref32, x, &y[100], 77, 50, 3, step);
+            WebRtcSpl_CrossCorrelation(out32, x, &y[100], 77, 50, 3, step);
+            for (int kk = 0; kk < 50; ++kk) {
+                EXPECT_EQ(ref32[kk], out32[kk]);
+            }
+        }
+
+        // Coefficients in Q12 and state in front of the output.
+        for (int order = 1; order < 20; order += 3) {
+            WebRtc_Word16 coef[20];
+            for (int kk = 0; kk < 20; ++kk) {
+                coef[kk] = y[trial * 20 + kk] >> 4;
+                ref[kk] = out[kk] = x[kk] >> 2;
+            }
+            WebRtcSpl_FilterARFastQ12C(x, &ref[20], coef, order + 1, 160);
+            WebRtcSpl_FilterARFastQ12(x, &out[20], coef, order + 1, 160);
+            for (int kk = 0; kk < 180; ++kk) {
+                EXPECT_EQ(ref[kk], out[kk]);
+            }
+
+            EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(&x[20], 400, ref, 80, coef,
+                                                   order + 1, 4, order / 2));
+            EXPECT_EQ(0, WebRtcSpl_DownsampleFast(&x[20], 400, out, 80, coef,
+                                                  order + 1, 4, order / 2));
+            for (int kk = 0; kk < 80; ++kk) {
+                EXPECT_EQ(ref[kk], out[kk]);
+            }
+        }
+
+        for (int stages = 3; stages <= 10; ++stages) {
+            const int length = 2 << stages;
+            for (int mode = 0; mode < 2; ++mode) {
+                WEBRTC_SPL_MEMCPY_W16(ref, x, length);
+                WEBRTC_SPL_MEMCPY_W16(out, x, length);
+                EXPECT_EQ(WebRtcSpl_ComplexFFTC(ref, stages, mode),
+                          WebRtcSpl_ComplexFFT(out, stages, mode));
+                for (int kk = 0; kk < length; ++kk) {
+                    EXPECT_EQ(ref[kk], out[kk]);
+                }
+                EXPECT_EQ(WebRtcSpl_ComplexIFFTC(ref, stages, mode),
+                          WebRtcSpl_ComplexIFFT(out, stages, mode));
+                for (int kk = 0; kk < length; ++kk) {
+                    EXPECT_EQ(ref[kk], out[kk]);
+                }
+            }
+        }
+    }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   SplEnvironment* env = new SplEnvironment;
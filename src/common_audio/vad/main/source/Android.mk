@@ -22,6 +22,12 @@ LOCAL_SRC_FILES := webrtc_vad.c \
     vad_gmm.c \
     vad_sp.c
 
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
+    vad_core_neon.c.neon
+MY_ARCH_DEFS := '-DWEBRTC_ARCH_ARM_NEON'
+endif
+
 # Flags passed to both C and C++ files.
 MY_CFLAGS :=  
 MY_CFLAGS_C :=
@@ -34,7 +40,7 @@ MY_DEFS += \
     '-DWEBRTC_ANDROID' \
     '-DANDROID' 
 endif
-LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS)
+LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS) $(MY_ARCH_DEFS)
 
 # Include paths placed before CFLAGS/CPPFLAGS
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../../.. \
@@ -40,6 +40,38 @@
         'vad_sp.c',
         'vad_sp.h',
       ],
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'vad_core_sse2.c',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'vad_core_neon.c',
+          ],
+        }],
+      ],
+    },
+    {
+      'target_name': 'vad_unit_test',
+      'type': 'executable',
+      'dependencies': [
+        'vad',
+        '../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+        '../../../../../testing/gtest.gyp:gtest',
+      ],
+      'include_dirs': [
+        '../../../../system_wrappers/interface',
+        '../../../../../testing/gtest/include',
+      ],
+      'sources': [
+        '../test/unit_test/unit_test.cc',
+        '../test/unit_test/unit_test.h',
+      ],
     },
   ],
 }
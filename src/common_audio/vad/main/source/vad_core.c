@@ -21,6 +21,7 @@
 #include "vad_gmm.h"
 #include "vad_sp.h"
 #include "signal_processing_library.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
 
 static const int kInitCheck = 42;
 
@@ -148,6 +149,22 @@ int WebRtcVad_InitCore(VadInstT *inst, short mode)
 
     inst->init_flag = kInitCheck;
 
+    WebRtcVad_Energy = WebRtcVad_EnergyC;
+    WebRtcVad_SplitBands = WebRtcVad_SplitBandsC;
+    WebRtcVad_GaussianProbabilities = WebRtcVad_GaussianProbabilitiesC;
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+#if defined(__SSE2__)
+        WebRtcVad_InitCore_SSE2();
+#endif
+    }
+    if (WebRtc_GetCPUInfo(kNEON))
+    {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+        WebRtcVad_InitCore_NEON();
+#endif
+    }
+
     return 0;
 }
 
@@ -294,7 +311,7 @@ WebRtc_Word16 WebRtcVad_GmmProbability(VadInstT *inst, WebRtc_Word16 *feature_ve
     int n, k;
     WebRtc_Word16 backval;
     WebRtc_Word16 h0, h1;
-    WebRtc_Word16 ratvec, xval;
+    WebRtc_Word16 ratvec;
     WebRtc_Word16 vadflag;
     WebRtc_Word16 shifts0, shifts1;
     WebRtc_Word16 tmp16, tmp16_1, tmp16_2;
@@ -309,6 +326,12 @@ WebRtc_Word16 WebRtcVad_GmmProbability(VadInstT *inst, WebRtc_Word16 *feature_ve
     WebRtc_Word32 dotVal;
     WebRtc_Word32 nmid, smid;
     WebRtc_Word32 probn[NUM_MODELS], probs[NUM_MODELS];
+    // Parameters and results of the Gaussians: noise model 1 and 2, then
+    // speech model 1 and 2, NUM_CHANNELS values each
+    WebRtc_Word16 xvals[2 * NUM_TABLE_VALUES];
+    WebRtc_Word16 means[2 * NUM_TABLE_VALUES], stds[2 * NUM_TABLE_VALUES];
+    WebRtc_Word16 deltas[2 * NUM_TABLE_VALUES];
+    WebRtc_Word32 gaussians[2 * NUM_TABLE_VALUES];
     WebRtc_Word16 *nmean1ptr, *nmean2ptr, *smean1ptr, *smean2ptr, *nstd1ptr, *nstd2ptr,
             *sstd1ptr, *sstd2ptr;
     WebRtc_Word16 overhead1, overhead2, individualTest, totalTest;
@@ -340,15 +363,23 @@ WebRtc_Word16 WebRtcVad_GmmProbability(VadInstT *inst, WebRtc_Word16 *feature_ve
     if (total_power > MIN_ENERGY)
     { // If signal present at all
 
-        // Set pointers to the gaussian parameters
-        nmean1ptr = &inst->noise_means[0];
-        nmean2ptr = &inst->noise_means[NUM_CHANNELS];
-        smean1ptr = &inst->speech_means[0];
-        smean2ptr = &inst->speech_means[NUM_CHANNELS];
-        nstd1ptr = &inst->noise_stds[0];
-        nstd2ptr = &inst->noise_stds[NUM_CHANNELS];
-        sstd1ptr = &inst->speech_stds[0];
-        sstd2ptr = &inst->speech_stds[NUM_CHANNELS];
+        // Evaluate all the Gaussians at once
+        for (n = 0; n < NUM_CHANNELS; n++)
+        {
+            xvals[n] = feature_vector[n];
+            xvals[n + NUM_CHANNELS] = feature_vector[n];
+            xvals[n + 2 * NUM_CHANNELS] = feature_vector[n];
+            xvals[n + 3 * NUM_CHANNELS] = feature_vector[n];
+        }
+        for (n = 0; n < NUM_TABLE_VALUES; n++)
+        {
+            means[n] = inst->noise_means[n];
+            means[n + NUM_TABLE_VALUES] = inst->speech_means[n];
+            stds[n] = inst->noise_stds[n];
+            stds[n + NUM_TABLE_VALUES] = inst->speech_stds[n];
+        }
+        WebRtcVad_GaussianProbabilities(xvals, means, stds, 2 * NUM_TABLE_VALUES, deltas,
+                                        gaussians);
 
         vadflag = 0;
         dotVal = 0;
@@ -356,25 +387,22 @@ WebRtc_Word16 WebRtcVad_GmmProbability(VadInstT *inst, WebRtc_Word16 *feature_ve
         { // For all channels
 
             pos = WEBRTC_SPL_LSHIFT_W16(n, 1);
-            xval = feature_vector[n];
 
             // Probability for Noise, Q7 * Q20 = Q27
-            tmp32_1 = WebRtcVad_GaussianProbability(xval, *nmean1ptr++, *nstd1ptr++,
-                                                    &deltaN[pos]);
-            probn[0] = (WebRtc_Word32)(kNoiseDataWeights[n] * tmp32_1);
-            tmp32_1 = WebRtcVad_GaussianProbability(xval, *nmean2ptr++, *nstd2ptr++,
-                                                    &deltaN[pos + 1]);
-            probn[1] = (WebRtc_Word32)(kNoiseDataWeights[n + NUM_CHANNELS] * tmp32_1);
+            deltaN[pos] = deltas[n];
+            probn[0] = (WebRtc_Word32)(kNoiseDataWeights[n] * gaussians[n]);
+            deltaN[pos + 1] = deltas[n + NUM_CHANNELS];
+            probn[1] = (WebRtc_Word32)(kNoiseDataWeights[n + NUM_CHANNELS]
+                    * gaussians[n + NUM_CHANNELS]);
             h0test = probn[0] + probn[1]; // Q27
             h0 = (WebRtc_Word16)WEBRTC_SPL_RSHIFT_W32(h0test, 12); // Q15
 
             // Probability for Speech
-            tmp32_1 = WebRtcVad_GaussianProbability(xval, *smean1ptr++, *sstd1ptr++,
-                                                    &deltaS[pos]);
-            probs[0] = (WebRtc_Word32)(kSpeechDataWeights[n] * tmp32_1);
-            tmp32_1 = WebRtcVad_GaussianProbability(xval, *smean2ptr++, *sstd2ptr++,
-                                                    &deltaS[pos + 1]);
-            probs[1] = (WebRtc_Word32)(kSpeechDataWeights[n + NUM_CHANNELS] * tmp32_1);
+            deltaS[pos] = deltas[n + 2 * NUM_CHANNELS];
+            probs[0] = (WebRtc_Word32)(kSpeechDataWeights[n] * gaussians[n + 2 * NUM_CHANNELS]);
+            deltaS[pos + 1] = deltas[n + 3 * NUM_CHANNELS];
+            probs[1] = (WebRtc_Word32)(kSpeechDataWeights[n + NUM_CHANNELS]
+                    * gaussians[n + 3 * NUM_CHANNELS]);
             h1test = probs[0] + probs[1]; // Q27
             h1 = (WebRtc_Word16)WEBRTC_SPL_RSHIFT_W32(h1test, 12); // Q15
 
@@ -129,4 +129,9 @@ WebRtc_Word16 WebRtcVad_CalcVad8khz(VadInstT* inst, WebRtc_Word16* speech_frame,
 WebRtc_Word16 WebRtcVad_GmmProbability(VadInstT* inst, WebRtc_Word16* feature_vector,
                                        WebRtc_Word16 total_power, int frame_length);
 
+// Select the SSE2 and NEON versions of the speed-critical functions in
+// vad_filterbank.h and vad_gmm.h. Called from WebRtcVad_InitCore(...).
+void WebRtcVad_InitCore_SSE2(void);
+void WebRtcVad_InitCore_NEON(void);
+
 #endif // WEBRTC_VAD_CORE_H_
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * NEON versions of the speed-critical VAD functions in vad_filterbank.h and
+ * vad_gmm.h. The results are bit exact with the C versions.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+
+#include "signal_processing_library.h"
+#include "spl_simd_inl.h"
+#include "vad_const.h"
+#include "vad_core.h"
+#include "vad_filterbank.h"
+#include "vad_gmm.h"
+
+// Returns a / b, truncated, for positive a and b where b * (a / b + 1) is
+// below 2^24. The reciprocal estimate is refined twice, and the quotient is
+// corrected with products that are exact in float.
+static __inline int32x4_t Divide(int32x4_t a, int32x4_t b) {
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t a_f = vcvtq_f32_s32(a);
+  const float32x4_t b_f = vcvtq_f32_s32(b);
+  float32x4_t recip = vrecpeq_f32(b_f);
+  float32x4_t q_f, prod;
+  recip = vmulq_f32(recip, vrecpsq_f32(b_f, recip));
+  recip = vmulq_f32(recip, vrecpsq_f32(b_f, recip));
+  q_f = vcvtq_f32_s32(vcvtq_s32_f32(vmulq_f32(a_f, recip)));
+  prod = vmulq_f32(q_f, b_f);
+  q_f = vsubq_f32(q_f, vreinterpretq_f32_u32(vandq_u32(
+      vcgtq_f32(prod, a_f), vreinterpretq_u32_f32(one))));
+  q_f = vaddq_f32(q_f, vreinterpretq_f32_u32(vandq_u32(
+      vcleq_f32(vaddq_f32(prod, b_f), a_f), vreinterpretq_u32_f32(one))));
+  return vcvtq_s32_f32(q_f);
+}
+
+static WebRtc_Word32 EnergyNeon(const WebRtc_Word16* vector,
+                                int vector_length,
+                                int* scale_factor) {
+  int16x8_t max_abs = vdupq_n_s16(-1);
+  int32x4_t sum = vdupq_n_s32(0);
+  int16x4_t max4;
+  int32x4_t shift;
+  WebRtc_Word16 smax;
+  WebRtc_Word32 energy;
+  int nbits, t, i;
+
+  // Same as WebRtcSpl_GetScalingSquare(). vqabsq_s16() would saturate -32768,
+  // so the negation wraps as in C.
+  for (i = 0; i + 8 <= vector_length; i += 8) {
+    const int16x8_t x = vld1q_s16(&vector[i]);
+    max_abs = vmaxq_s16(max_abs, vmaxq_s16(x, vnegq_s16(x)));
+  }
+  max4 = vmax_s16(vget_low_s16(max_abs), vget_high_s16(max_abs));
+  max4 = vpmax_s16(max4, max4);
+  max4 = vpmax_s16(max4, max4);
+  smax = vget_lane_s16(max4, 0);
+  for (; i < vector_length; i++) {
+    const WebRtc_Word16 sabs = (vector[i] > 0 ? vector[i] : -vector[i]);
+    smax = (sabs > smax ? sabs : smax);
+  }
+
+  nbits = WebRtcSpl_GetSizeInBits(vector_length);
+  t = WebRtcSpl_NormW32(WEBRTC_SPL_MUL(smax, smax));
+  if (smax == 0) {
+    *scale_factor = 0;
+  } else {
+    *scale_factor = (t > nbits) ? 0 : nbits - t;
+  }
+
+  shift = vdupq_n_s32(-*scale_factor);
+  for (i = 0; i + 8 <= vector_length; i += 8) {
+    const int16x8_t x = vld1q_s16(&vector[i]);
+    const int32x4_t lo = vmull_s16(vget_low_s16(x), vget_low_s16(x));
+    const int32x4_t hi = vmull_s16(vget_high_s16(x), vget_high_s16(x));
+    sum = vaddq_s32(sum, vshlq_s32(lo, shift));
+    sum = vaddq_s32(sum, vshlq_s32(hi, shift));
+  }
+  energy = WebRtcSpl_HorizontalSumNeon(sum);
+  for (; i < vector_length; i++) {
+    energy += WEBRTC_SPL_MUL_16_16_RSFT(vector[i], vector[i], *scale_factor);
+  }
+
+  return energy;
+}
+
+static void SplitBandsNeon(WebRtc_Word16* hp, WebRtc_Word16* lp, int length) {
+  int k;
+
+  for (k = 0; k + 8 <= length; k += 8) {
+    const int16x8_t h = vld1q_s16(&hp[k]);
+    const int16x8_t l = vld1q_s16(&lp[k]);
+    vst1q_s16(&hp[k], vsubq_s16(h, l));
+    vst1q_s16(&lp[k], vaddq_s16(l, h));
+  }
+  WebRtcVad_SplitBandsC(&hp[k], &lp[k], length - k);
+}
+
+// Follows WebRtcVad_GaussianProbability() step by step for eight values.
+static void GaussianProbabilitiesNeon(const WebRtc_Word16* in_samples,
+                                      const WebRtc_Word16* means,
+                                      const WebRtc_Word16* stds,
+                                      int length,
+                                      WebRtc_Word16* deltas,
+                                      WebRtc_Word32* probabilities) {
+  const int32x4_t comp_var = vdupq_n_s32(kCompVar);
+  const int32x4_t one_q17 = vdupq_n_s32(131072);
+  int i;
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    const int16x8_t x = vld1q_s16(&in_samples[i]);
+    const int16x8_t mean = vld1q_s16(&means[i]);
+    const int16x8_t std = vld1q_s16(&stds[i]);
+    const int32x4_t std_lo = vmovl_s16(vget_low_s16(std));
+    const int32x4_t std_hi = vmovl_s16(vget_high_s16(std));
+    int16x8_t div, div2, diff, delta, tmp, exp_arg, exp_frac, exp_shift;
+    int16x8_t exp_val;
+    int32x4_t lo, hi;
+    uint32x4_t mask_lo, mask_hi;
+
+    // tmpDiv = 1 / std in Q10, tmpDiv2 = 1 / std^2 in Q14. With std at least
+    // MIN_STD, tmpDiv is below 2^9 and tmpDiv2 below 2^13.
+    lo = vaddq_s32(vshrq_n_s32(std_lo, 1), one_q17);
+    hi = vaddq_s32(vshrq_n_s32(std_hi, 1), one_q17);
+    div = vcombine_s16(vmovn_s32(Divide(lo, std_lo)),
+                       vmovn_s32(Divide(hi, std_hi)));
+    tmp = vshrq_n_s16(div, 2);
+    div2 = vshrq_n_s16(vmulq_s16(tmp, tmp), 2);
+
+    // delta = (x - m) / std^2 in Q11.
+    diff = vsubq_s16(vshlq_n_s16(x, 3), mean);
+    lo = vmull_s16(vget_low_s16(div2), vget_low_s16(diff));
+    hi = vmull_s16(vget_high_s16(div2), vget_high_s16(diff));
+    delta = vcombine_s16(vmovn_s32(vshrq_n_s32(lo, 10)),
+                         vmovn_s32(vshrq_n_s32(hi, 10)));
+    vst1q_s16(&deltas[i], delta);
+
+    // (x - m)^2 / (2 * std^2) in Q10, only used where below kCompVar.
+    lo = vshrq_n_s32(vmull_s16(vget_low_s16(delta), vget_low_s16(diff)), 9);
+    hi = vshrq_n_s32(vmull_s16(vget_high_s16(delta), vget_high_s16(diff)), 9);
+    mask_lo = vcltq_s32(lo, comp_var);
+    mask_hi = vcltq_s32(hi, comp_var);
+
+    // exp(-(x - m)^2 / (2 * std^2)) in Q10, as a shifted fraction.
+    tmp = vcombine_s16(vmovn_s32(lo), vmovn_s32(hi));
+    lo = vmull_s16(vget_low_s16(tmp), vdup_n_s16(kLog10Const));
+    hi = vmull_s16(vget_high_s16(tmp), vdup_n_s16(kLog10Const));
+    exp_arg = vnegq_s16(vcombine_s16(vmovn_s32(vshrq_n_s32(lo, 12)),
+                                     vmovn_s32(vshrq_n_s32(hi, 12))));
+    exp_frac = vorrq_s16(vdupq_n_s16(0x0400),
+                         vandq_s16(exp_arg, vdupq_n_s16(0x03FF)));
+    exp_shift = vaddq_s16(vshrq_n_s16(vmvnq_s16(exp_arg), 10),
+                          vdupq_n_s16(1));
+    exp_val = vshlq_s16(exp_frac, vnegq_s16(exp_shift));
+
+    // tmpDiv * expVal in Q20.
+    lo = vmull_s16(vget_low_s16(div), vget_low_s16(exp_val));
+    hi = vmull_s16(vget_high_s16(div), vget_high_s16(exp_val));
+    vst1q_s32(&probabilities[i],
+              vreinterpretq_s32_u32(vandq_u32(vreinterpretq_u32_s32(lo),
+                                              mask_lo)));
+    vst1q_s32(&probabilities[i + 4],
+              vreinterpretq_s32_u32(vandq_u32(vreinterpretq_u32_s32(hi),
+                                              mask_hi)));
+  }
+  WebRtcVad_GaussianProbabilitiesC(&in_samples[i], &means[i], &stds[i],
+                                   length - i, &deltas[i], &probabilities[i]);
+}
+
+void WebRtcVad_InitCore_NEON(void) {
+  WebRtcVad_Energy = EnergyNeon;
+  WebRtcVad_SplitBands = SplitBandsNeon;
+  WebRtcVad_GaussianProbabilities = GaussianProbabilitiesNeon;
+}
+
+#endif  // WEBRTC_ARCH_ARM_NEON
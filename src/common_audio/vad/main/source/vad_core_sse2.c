@@ -0,0 +1,203 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * SSE2 versions of the speed-critical VAD functions in vad_filterbank.h and
+ * vad_gmm.h. The results are bit exact with the C versions.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#include "signal_processing_library.h"
+#include "vad_const.h"
+#include "vad_core.h"
+#include "vad_filterbank.h"
+#include "vad_gmm.h"
+
+// Multiplies eight pairs of 16-bit values into eight 32-bit products.
+static __inline void Mul16x16(__m128i a, __m128i b, __m128i* lo, __m128i* hi) {
+  const __m128i prod_lo = _mm_mullo_epi16(a, b);
+  const __m128i prod_hi = _mm_mulhi_epi16(a, b);
+  *lo = _mm_unpacklo_epi16(prod_lo, prod_hi);
+  *hi = _mm_unpackhi_epi16(prod_lo, prod_hi);
+}
+
+// Casts eight 32-bit values to 16 bits, keeping the low half as C does.
+static __inline __m128i Cast32To16(__m128i lo, __m128i hi) {
+  lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+  hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+  return _mm_packs_epi32(lo, hi);
+}
+
+// Returns a / b, truncated, for positive a and b where b * (a / b + 1) is
+// below 2^24. All products are then exact in float, which is used to correct
+// the float quotient when it is rounded across an integer.
+static __inline __m128i Divide(__m128i a, __m128i b) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 a_f = _mm_cvtepi32_ps(a);
+  const __m128 b_f = _mm_cvtepi32_ps(b);
+  __m128 q_f = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(a_f, b_f)));
+  const __m128 prod = _mm_mul_ps(q_f, b_f);
+  q_f = _mm_sub_ps(q_f, _mm_and_ps(_mm_cmpgt_ps(prod, a_f), one));
+  q_f = _mm_add_ps(q_f, _mm_and_ps(_mm_cmple_ps(_mm_add_ps(prod, b_f), a_f),
+                                   one));
+  return _mm_cvttps_epi32(q_f);
+}
+
+// Returns value >> shift for 0 <= value < 2^24 and 0 <= shift <= 31, through
+// a float multiplication with 2^-shift.
+static __inline __m128i ShiftRight(__m128i value, __m128i shift) {
+  const __m128i exponent = _mm_sub_epi32(_mm_set1_epi32(127), shift);
+  const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(exponent, 23));
+  return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(value), scale));
+}
+
+static WebRtc_Word32 EnergySSE2(const WebRtc_Word16* vector,
+                                int vector_length,
+                                int* scale_factor) {
+  __m128i max_abs = _mm_set1_epi16(-1);
+  __m128i sum = _mm_setzero_si128();
+  __m128i shift;
+  WebRtc_Word16 smax;
+  WebRtc_Word32 energy;
+  int nbits, t, i;
+
+  // Same as WebRtcSpl_GetScalingSquare(). The absolute value of -32768 is
+  // -32768 in both versions.
+  for (i = 0; i + 8 <= vector_length; i += 8) {
+    const __m128i x = _mm_loadu_si128((const __m128i*)&vector[i]);
+    const __m128i abs_x = _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(),
+                                                         x));
+    max_abs = _mm_max_epi16(max_abs, abs_x);
+  }
+  max_abs = _mm_max_epi16(max_abs, _mm_shuffle_epi32(max_abs,
+                                                     _MM_SHUFFLE(1, 0, 3, 2)));
+  max_abs = _mm_max_epi16(max_abs, _mm_shuffle_epi32(max_abs,
+                                                     _MM_SHUFFLE(2, 3, 0, 1)));
+  max_abs = _mm_max_epi16(max_abs, _mm_shufflelo_epi16(max_abs,
+                                                       _MM_SHUFFLE(2, 3, 0, 1)));
+  smax = (WebRtc_Word16)_mm_extract_epi16(max_abs, 0);
+  for (; i < vector_length; i++) {
+    const WebRtc_Word16 sabs = (vector[i] > 0 ? vector[i] : -vector[i]);
+    smax = (sabs > smax ? sabs : smax);
+  }
+
+  nbits = WebRtcSpl_GetSizeInBits(vector_length);
+  t = WebRtcSpl_NormW32(WEBRTC_SPL_MUL(smax, smax));
+  if (smax == 0) {
+    *scale_factor = 0;
+  } else {
+    *scale_factor = (t > nbits) ? 0 : nbits - t;
+  }
+
+  shift = _mm_cvtsi32_si128(*scale_factor);
+  for (i = 0; i + 8 <= vector_length; i += 8) {
+    const __m128i x = _mm_loadu_si128((const __m128i*)&vector[i]);
+    __m128i lo, hi;
+    Mul16x16(x, x, &lo, &hi);
+    sum = _mm_add_epi32(sum, _mm_sra_epi32(lo, shift));
+    sum = _mm_add_epi32(sum, _mm_sra_epi32(hi, shift));
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  energy = _mm_cvtsi128_si32(sum);
+  for (; i < vector_length; i++) {
+    energy += WEBRTC_SPL_MUL_16_16_RSFT(vector[i], vector[i], *scale_factor);
+  }
+
+  return energy;
+}
+
+static void SplitBandsSSE2(WebRtc_Word16* hp, WebRtc_Word16* lp, int length) {
+  int k;
+
+  for (k = 0; k + 8 <= length; k += 8) {
+    const __m128i h = _mm_loadu_si128((__m128i*)&hp[k]);
+    const __m128i l = _mm_loadu_si128((__m128i*)&lp[k]);
+    _mm_storeu_si128((__m128i*)&hp[k], _mm_sub_epi16(h, l));
+    _mm_storeu_si128((__m128i*)&lp[k], _mm_add_epi16(l, h));
+  }
+  WebRtcVad_SplitBandsC(&hp[k], &lp[k], length - k);
+}
+
+// Follows WebRtcVad_GaussianProbability() step by step for eight values.
+static void GaussianProbabilitiesSSE2(const WebRtc_Word16* in_samples,
+                                      const WebRtc_Word16* means,
+                                      const WebRtc_Word16* stds,
+                                      int length,
+                                      WebRtc_Word16* deltas,
+                                      WebRtc_Word32* probabilities) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i comp_var = _mm_set1_epi32(kCompVar);
+  int i;
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    const __m128i x = _mm_loadu_si128((const __m128i*)&in_samples[i]);
+    const __m128i mean = _mm_loadu_si128((const __m128i*)&means[i]);
+    const __m128i std = _mm_loadu_si128((const __m128i*)&stds[i]);
+    const __m128i std_lo = _mm_unpacklo_epi16(std, zero);
+    const __m128i std_hi = _mm_unpackhi_epi16(std, zero);
+    __m128i div, div2, diff, delta, tmp, exp_arg, exp_frac, exp_shift;
+    __m128i lo, hi, mask_lo, mask_hi, exp_lo, exp_hi;
+
+    // tmpDiv = 1 / std in Q10, tmpDiv2 = 1 / std^2 in Q14. With std at least
+    // MIN_STD, tmpDiv is below 2^9 and tmpDiv2 below 2^13.
+    lo = _mm_add_epi32(_mm_srai_epi32(std_lo, 1), _mm_set1_epi32(131072));
+    hi = _mm_add_epi32(_mm_srai_epi32(std_hi, 1), _mm_set1_epi32(131072));
+    div = _mm_packs_epi32(Divide(lo, std_lo), Divide(hi, std_hi));
+    tmp = _mm_srai_epi16(div, 2);
+    div2 = _mm_srai_epi16(_mm_mullo_epi16(tmp, tmp), 2);
+
+    // delta = (x - m) / std^2 in Q11.
+    diff = _mm_sub_epi16(_mm_slli_epi16(x, 3), mean);
+    Mul16x16(div2, diff, &lo, &hi);
+    delta = Cast32To16(_mm_srai_epi32(lo, 10), _mm_srai_epi32(hi, 10));
+    _mm_storeu_si128((__m128i*)&deltas[i], delta);
+
+    // (x - m)^2 / (2 * std^2) in Q10, only used where below kCompVar.
+    Mul16x16(delta, diff, &lo, &hi);
+    lo = _mm_srai_epi32(lo, 9);
+    hi = _mm_srai_epi32(hi, 9);
+    mask_lo = _mm_cmplt_epi32(lo, comp_var);
+    mask_hi = _mm_cmplt_epi32(hi, comp_var);
+
+    // exp(-(x - m)^2 / (2 * std^2)) in Q10, as a shifted fraction.
+    Mul16x16(Cast32To16(lo, hi), _mm_set1_epi16(kLog10Const), &lo, &hi);
+    exp_arg = _mm_sub_epi16(zero, Cast32To16(_mm_srai_epi32(lo, 12),
+                                             _mm_srai_epi32(hi, 12)));
+    exp_frac = _mm_or_si128(_mm_set1_epi16(0x0400),
+                            _mm_and_si128(exp_arg, _mm_set1_epi16(0x03FF)));
+    exp_shift = _mm_add_epi16(
+        _mm_srai_epi16(_mm_xor_si128(exp_arg, _mm_set1_epi16(-1)), 10),
+        _mm_set1_epi16(1));
+    exp_lo = ShiftRight(_mm_unpacklo_epi16(exp_frac, zero),
+                        _mm_unpacklo_epi16(exp_shift, zero));
+    exp_hi = ShiftRight(_mm_unpackhi_epi16(exp_frac, zero),
+                        _mm_unpackhi_epi16(exp_shift, zero));
+
+    // tmpDiv * expVal in Q20. Both factors fit in the low 16 bits.
+    lo = _mm_madd_epi16(_mm_unpacklo_epi16(div, zero), exp_lo);
+    hi = _mm_madd_epi16(_mm_unpackhi_epi16(div, zero), exp_hi);
+    _mm_storeu_si128((__m128i*)&probabilities[i], _mm_and_si128(lo, mask_lo));
+    _mm_storeu_si128((__m128i*)&probabilities[i + 4],
+                     _mm_and_si128(hi, mask_hi));
+  }
+  WebRtcVad_GaussianProbabilitiesC(&in_samples[i], &means[i], &stds[i],
+                                   length - i, &deltas[i], &probabilities[i]);
+}
+
+void WebRtcVad_InitCore_SSE2(void) {
+  WebRtcVad_Energy = EnergySSE2;
+  WebRtcVad_SplitBands = SplitBandsSSE2;
+  WebRtcVad_GaussianProbabilities = GaussianProbabilitiesSSE2;
+}
+
+#endif  // __SSE2__
@@ -19,6 +19,29 @@
 #include "vad_const.h"
 #include "signal_processing_library.h"
 
+WebRtcVad_Energy_t WebRtcVad_Energy = WebRtcVad_EnergyC;
+WebRtcVad_SplitBands_t WebRtcVad_SplitBands = WebRtcVad_SplitBandsC;
+
+WebRtc_Word32 WebRtcVad_EnergyC(const WebRtc_Word16* vector,
+                                int vector_length,
+                                int* scale_factor)
+{
+    return WebRtcSpl_Energy((WebRtc_Word16*)vector, vector_length, scale_factor);
+}
+
+void WebRtcVad_SplitBandsC(WebRtc_Word16* hp, WebRtc_Word16* lp, int length)
+{
+    WebRtc_Word16 tmpOut;
+    int k;
+
+    for (k = 0; k < length; k++)
+    {
+        tmpOut = *hp;
+        *hp++ -= *lp;
+        *lp++ += tmpOut;
+    }
+}
+
 void WebRtcVad_HpOutput(WebRtc_Word16 *in_vector,
                         WebRtc_Word16 in_vector_length,
                         WebRtc_Word16 *out_vector,
@@ -96,8 +119,7 @@ void WebRtcVad_SplitFilter(WebRtc_Word16 *in_vector,
                            WebRtc_Word16 *lower_state,
                            int in_vector_length)
 {
-    WebRtc_Word16 tmpOut;
-    int k, halflen;
+    int halflen;
 
     // Downsampling by 2 and get two branches
     halflen = WEBRTC_SPL_RSHIFT_W16(in_vector_length, 1);
@@ -109,12 +131,7 @@ void WebRtcVad_SplitFilter(WebRtc_Word16 *in_vector,
     WebRtcVad_Allpass(&in_vector[1], out_vector_lp, kAllPassCoefsQ15[1], halflen, lower_state);
 
     // Make LP and HP signals
-    for (k = 0; k < halflen; k++)
-    {
-        tmpOut = *out_vector_hp;
-        *out_vector_hp++ -= *out_vector_lp;
-        *out_vector_lp++ += tmpOut;
-    }
+    WebRtcVad_SplitBands(out_vector_hp, out_vector_lp, halflen);
 }
 
 WebRtc_Word16 WebRtcVad_get_features(VadInstT *inst,
@@ -214,7 +231,7 @@ void WebRtcVad_LogOfEnergy(WebRtc_Word16 *vector,
 
     int shfts = 0, shfts2;
 
-    energy = WebRtcSpl_Energy(vector, vector_length, &shfts);
+    energy = WebRtcVad_Energy(vector, vector_length, &shfts);
 
     if (energy > 0)
     {
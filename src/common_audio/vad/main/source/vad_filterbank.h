@@ -140,4 +140,54 @@ void WebRtcVad_LogOfEnergy(WebRtc_Word16* vector,
                            WebRtc_Word16 offset,
                            int vector_length);
 
+/****************************************************************************
+ * Speed-critical functions of the filterbank, selected in WebRtcVad_InitCore(...)
+ * depending on the CPU. The SSE2 and NEON versions give the same result as the C
+ * versions.
+ */
+
+/****************************************************************************
+ * WebRtcVad_Energy(...)
+ *
+ * Calculates the energy of a vector, as WebRtcSpl_Energy(...).
+ *
+ * Input:
+ *      - vector            : Input samples
+ *      - vector_length     : Length of input vector
+ *
+ * Output:
+ *      - scale_factor      : Number of right shifts applied to each product
+ *
+ * Return: Energy of the vector, right shifted by scale_factor.
+ */
+typedef WebRtc_Word32 (*WebRtcVad_Energy_t)(const WebRtc_Word16* vector,
+                                            int vector_length,
+                                            int* scale_factor);
+extern WebRtcVad_Energy_t WebRtcVad_Energy;
+
+/****************************************************************************
+ * WebRtcVad_SplitBands(...)
+ *
+ * Makes the upper and lower band of WebRtcVad_SplitFilter(...) out of the two
+ * all-pass filtered branches, in place.
+ *
+ * Input:
+ *      - hp                : Upper all-pass branch
+ *      - lp                : Lower all-pass branch
+ *      - length            : Length of the branches
+ *
+ * Output:
+ *      - hp                : hp - lp, the upper half of the spectrum
+ *      - lp                : lp + hp, the lower half of the spectrum
+ */
+typedef void (*WebRtcVad_SplitBands_t)(WebRtc_Word16* hp,
+                                       WebRtc_Word16* lp,
+                                       int length);
+extern WebRtcVad_SplitBands_t WebRtcVad_SplitBands;
+
+WebRtc_Word32 WebRtcVad_EnergyC(const WebRtc_Word16* vector,
+                                int vector_length,
+                                int* scale_factor);
+void WebRtcVad_SplitBandsC(WebRtc_Word16* hp, WebRtc_Word16* lp, int length);
+
 #endif // WEBRTC_VAD_FILTERBANK_H_
@@ -18,6 +18,9 @@
 #include "signal_processing_library.h"
 #include "vad_const.h"
 
+WebRtcVad_GaussianProbabilities_t WebRtcVad_GaussianProbabilities =
+        WebRtcVad_GaussianProbabilitiesC;
+
 WebRtc_Word32 WebRtcVad_GaussianProbability(WebRtc_Word16 in_sample,
                                             WebRtc_Word16 mean,
                                             WebRtc_Word16 std,
@@ -68,3 +71,19 @@ WebRtc_Word32 WebRtcVad_GaussianProbability(WebRtc_Word16 in_sample,
 
     return y32; // Q20
 }
+
+void WebRtcVad_GaussianProbabilitiesC(const WebRtc_Word16* in_samples,
+                                      const WebRtc_Word16* means,
+                                      const WebRtc_Word16* stds,
+                                      int length,
+                                      WebRtc_Word16* deltas,
+                                      WebRtc_Word32* probabilities)
+{
+    int i;
+
+    for (i = 0; i < length; i++)
+    {
+        probabilities[i] = WebRtcVad_GaussianProbability(in_samples[i], means[i], stds[i],
+                                                         &deltas[i]);
+    }
+}
@@ -44,4 +44,38 @@ WebRtc_Word32 WebRtcVad_GaussianProbability(WebRtc_Word16 in_sample,
                                             WebRtc_Word16 std,
                                             WebRtc_Word16 *delta);
 
+/****************************************************************************
+ * WebRtcVad_GaussianProbabilities(...)
+ *
+ * Calls WebRtcVad_GaussianProbability(...) for 'length' sets of parameters at
+ * once. Selected in WebRtcVad_InitCore(...) depending on the CPU; the SSE2 and
+ * NEON versions give the same result as the C version as long as the deltas
+ * fit in 16 bits, which holds for the features and models of the VAD.
+ *
+ * Input:
+ *      - in_samples    : Input samples in Q4
+ *      - means         : mean values in the statistical model, Q7
+ *      - stds          : standard deviations, Q7, at least MIN_STD
+ *      - length        : Number of probabilities to calculate
+ *
+ * Output:
+ *      - deltas        : Values used when updating the model, Q11
+ *      - probabilities : Probabilities for the input samples, Q20
+ *
+ */
+typedef void (*WebRtcVad_GaussianProbabilities_t)(const WebRtc_Word16* in_samples,
+                                                  const WebRtc_Word16* means,
+                                                  const WebRtc_Word16* stds,
+                                                  int length,
+                                                  WebRtc_Word16* deltas,
+                                                  WebRtc_Word32* probabilities);
+extern WebRtcVad_GaussianProbabilities_t WebRtcVad_GaussianProbabilities;
+
+void WebRtcVad_GaussianProbabilitiesC(const WebRtc_Word16* in_samples,
+                                      const WebRtc_Word16* means,
+                                      const WebRtc_Word16* stds,
+                                      int length,
+                                      WebRtc_Word16* deltas,
+                                      WebRtc_Word32* probabilities);
+
 #endif // WEBRTC_VAD_GMM_H_
@@ -14,6 +14,7 @@
  */
 
 #include <cstring>
+#include "cpu_features_wrapper.h"
 #include "unit_test.h"
 #include "webrtc_vad.h"
 
@@ -59,7 +60,7 @@ TEST_F(VadTest, ApiTest) {
 
 
     // WebRtcVad_get_version()
-    WebRtcVad_get_version(version);
+    WebRtcVad_get_version(version, sizeof(version));
     //printf("API Test for %s\n", version);
 
     // Null instance tests
@@ -114,6 +115,64 @@ TEST_F(VadTest, ApiTest) {
 
 }
 
+// Runs the VAD without and with the SSE2/NEON code on a synthetic signal, for
+// all rates, modes and frame lengths, and checks that the decisions match.
+// The code is selected in WebRtcVad_Init(), so the two runs are made after
+// each other.
+TEST_F(VadTest, SimdBitExact) {
+    const int kNumFrames = 200;
+    int fs[3] = {8000, 16000, 32000};
+    int framelen[3][3] = {{80, 160, 240},
+    {160, 320, 480}, {320, 640, 960}};
+    short signal[960];
+    int decisions[kNumFrames];
+    VadInst *vad_inst;
+    WebRtc_CPUInfo get_cpu_info = WebRtc_GetCPUInfo;
+    unsigned int seed;
+    int i, j, k, n, m, run;
+
+    EXPECT_EQ(0, WebRtcVad_Create(&vad_inst));
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            for (k = 0; k < 4; k++) {
+                for (run = 0; run < 2; run++) {
+                    WebRtc_GetCPUInfo = (run == 0) ? WebRtc_GetCPUInfoNoASM :
+                        get_cpu_info;
+                    EXPECT_EQ(0, WebRtcVad_Init(vad_inst));
+                    EXPECT_EQ(0, WebRtcVad_set_mode(vad_inst, k));
+                    seed = 7;
+                    for (n = 0; n < kNumFrames; n++) {
+                        // Bursts of noise and a sawtooth at two levels, and
+                        // full scale samples now and then.
+                        const int level = (n / 20) % 2 ? 8000 : 100;
+                        for (m = 0; m < framelen[i][j]; m++) {
+                            seed = seed * 1103515245 + 12345;
+                            signal[m] = (short)(
+                                ((int)((seed >> 16) % 201) - 100) * level / 100 +
+                                ((m * (n + 1)) % 64 - 32) * level / 64);
+                        }
+                        if (n % 37 == 0) {
+                            signal[n % framelen[i][j]] = -32768;
+                            signal[(n + 1) % framelen[i][j]] = 32767;
+                        }
+                        if (run == 0) {
+                            decisions[n] = WebRtcVad_Process(vad_inst, fs[i],
+                                signal, framelen[i][j]);
+                        } else {
+                            EXPECT_EQ(decisions[n], WebRtcVad_Process(vad_inst,
+                                fs[i], signal, framelen[i][j]));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    WebRtc_GetCPUInfo = get_cpu_info;
+
+    EXPECT_EQ(0, WebRtcVad_Free(vad_inst));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   VadEnvironment* env = new VadEnvironment;
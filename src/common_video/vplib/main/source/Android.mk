@@ -20,6 +20,12 @@ LOCAL_SRC_FILES := \
     interpolator.cc \
     scale_bilinear_yuv.cc 
 
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
+    vplib_neon.cc.neon
+MY_ARCH_DEFS := '-DWEBRTC_ARCH_ARM_NEON'
+endif
+
 # Flags passed to both C and C++ files.
 MY_CFLAGS :=  
 MY_CFLAGS_C :=
@@ -31,11 +37,12 @@ MY_DEFS := '-DNO_TCMALLOC' \
     '-DWEBRTC_ANDROID' \
     '-DANDROID' 
 
-LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS)
+LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS) $(MY_ARCH_DEFS)
 
 # Include paths placed before CFLAGS/CPPFLAGS
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../../.. \
-    $(LOCAL_PATH)/../interface 
+    $(LOCAL_PATH)/../interface \
+    $(LOCAL_PATH)/../../../../system_wrappers/interface 
 
 # Flags passed to only C++ (and not C) files.
 LOCAL_CPPFLAGS := 
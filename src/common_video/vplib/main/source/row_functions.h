@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Speed-critical per-row kernels of the vplib conversions. The C versions
+ * are implemented in vplib.cc and replaced by SSE2 or NEON versions when the
+ * CPU supports it.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_VPLIB_MAIN_SOURCE_ROW_FUNCTIONS_H_
+#define WEBRTC_COMMON_VIDEO_VPLIB_MAIN_SOURCE_ROW_FUNCTIONS_H_
+
+#include "typedefs.h"
+
+namespace webrtc
+{
+
+// Converts one row of width pixels (width even) to ARGB. u and v hold
+// width / 2 samples.
+typedef void (*I420ToARGBRowFunc)(const WebRtc_UWord8* y,
+                                  const WebRtc_UWord8* u,
+                                  const WebRtc_UWord8* v,
+                                  WebRtc_UWord8* argb,
+                                  WebRtc_UWord32 width);
+
+// De-interlaces width UV pairs into the u and v planes.
+typedef void (*SplitUVRowFunc)(const WebRtc_UWord8* uv,
+                               WebRtc_UWord8* u,
+                               WebRtc_UWord8* v,
+                               WebRtc_UWord32 width);
+
+// Extracts the luma of one YUY2 row of width pixels (width even).
+typedef void (*YUY2ToYRowFunc)(const WebRtc_UWord8* yuy2,
+                               WebRtc_UWord8* y,
+                               WebRtc_UWord32 width);
+
+// Extracts the chroma of one YUY2 row of width pixels (width even),
+// averaged with the samples stride bytes ahead.
+typedef void (*YUY2ToUVRowFunc)(const WebRtc_UWord8* yuy2,
+                                WebRtc_UWord32 stride,
+                                WebRtc_UWord8* u,
+                                WebRtc_UWord8* v,
+                                WebRtc_UWord32 width);
+
+// C versions, also used by the SIMD versions for the end of rows.
+void I420ToARGBRow_C(const WebRtc_UWord8* y, const WebRtc_UWord8* u,
+                     const WebRtc_UWord8* v, WebRtc_UWord8* argb,
+                     WebRtc_UWord32 width);
+void SplitUVRow_C(const WebRtc_UWord8* uv, WebRtc_UWord8* u,
+                  WebRtc_UWord8* v, WebRtc_UWord32 width);
+void YUY2ToYRow_C(const WebRtc_UWord8* yuy2, WebRtc_UWord8* y,
+                  WebRtc_UWord32 width);
+void YUY2ToUVRow_C(const WebRtc_UWord8* yuy2, WebRtc_UWord32 stride,
+                   WebRtc_UWord8* u, WebRtc_UWord8* v, WebRtc_UWord32 width);
+
+extern I420ToARGBRowFunc I420ToARGBRow;
+extern SplitUVRowFunc SplitUVRow;
+extern YUY2ToYRowFunc YUY2ToYRow;
+extern YUY2ToUVRowFunc YUY2ToUVRow;
+
+// Selects the row functions from the features reported by
+// WebRtc_GetCPUInfo. Called automatically by the conversions; calling it
+// again re-runs the selection.
+void InitRowFunctions();
+
+void InitRowFunctions_SSE2();
+void InitRowFunctions_NEON();
+
+} // namespace webrtc
+
+#endif // WEBRTC_COMMON_VIDEO_VPLIB_MAIN_SOURCE_ROW_FUNCTIONS_H_
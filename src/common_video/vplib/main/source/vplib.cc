@@ -22,6 +22,8 @@
 
 // webrtc includes
 #include "conversion_tables.h"
+#include "cpu_features_wrapper.h"
+#include "row_functions.h"
 
 namespace webrtc
 {
@@ -38,6 +40,102 @@ void *memcpy_16(void * dest, const void * src, size_t n);
 void *memcpy_8(void * dest, const void * src, size_t n);
 #endif
 
+void
+I420ToARGBRow_C(const WebRtc_UWord8* y, const WebRtc_UWord8* u,
+                const WebRtc_UWord8* v, WebRtc_UWord8* argb,
+                WebRtc_UWord32 width)
+{
+    for (WebRtc_UWord32 x = 0; x < (width >> 1); x++)
+    {
+        // two pixels share chroma
+        const WebRtc_Word32 cr = mapVcr[v[x]] + 128;
+        const WebRtc_Word32 cg = mapUcg[u[x]] + mapVcg[v[x]] + 128;
+        const WebRtc_Word32 cb = mapUcb[u[x]] + 128;
+        WebRtc_Word32 yc = mapYc[y[0]];
+        argb[3] = 0xff;
+        argb[2] = Clip((yc + cr) >> 8);
+        argb[1] = Clip((yc + cg) >> 8);
+        argb[0] = Clip((yc + cb) >> 8);
+        yc = mapYc[y[1]];
+        argb[7] = 0xff;
+        argb[6] = Clip((yc + cr) >> 8);
+        argb[5] = Clip((yc + cg) >> 8);
+        argb[4] = Clip((yc + cb) >> 8);
+        y += 2;
+        argb += 8;
+    }
+}
+
+void
+SplitUVRow_C(const WebRtc_UWord8* uv, WebRtc_UWord8* u, WebRtc_UWord8* v,
+             WebRtc_UWord32 width)
+{
+    for (WebRtc_UWord32 x = 0; x < width; x++)
+    {
+        u[x] = uv[2 * x];
+        v[x] = uv[2 * x + 1];
+    }
+}
+
+void
+YUY2ToYRow_C(const WebRtc_UWord8* yuy2, WebRtc_UWord8* y,
+             WebRtc_UWord32 width)
+{
+    for (WebRtc_UWord32 x = 0; x < width; x++)
+    {
+        y[x] = yuy2[2 * x];
+    }
+}
+
+void
+YUY2ToUVRow_C(const WebRtc_UWord8* yuy2, WebRtc_UWord32 stride,
+              WebRtc_UWord8* u, WebRtc_UWord8* v, WebRtc_UWord32 width)
+{
+    for (WebRtc_UWord32 x = 0; x < (width >> 1); x++)
+    {
+        u[x] = (yuy2[1] + yuy2[1 + stride] + 1) >> 1;
+        v[x] = (yuy2[3] + yuy2[3 + stride] + 1) >> 1;
+        yuy2 += 4;
+    }
+}
+
+I420ToARGBRowFunc I420ToARGBRow = NULL;
+SplitUVRowFunc SplitUVRow = NULL;
+YUY2ToYRowFunc YUY2ToYRow = NULL;
+YUY2ToUVRowFunc YUY2ToUVRow = NULL;
+
+void
+InitRowFunctions()
+{
+    I420ToARGBRow = I420ToARGBRow_C;
+    SplitUVRow = SplitUVRow_C;
+    YUY2ToYRow = YUY2ToYRow_C;
+    YUY2ToUVRow = YUY2ToUVRow_C;
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+#if defined(__SSE2__)
+        InitRowFunctions_SSE2();
+#endif
+    }
+    if (WebRtc_GetCPUInfo(kNEON))
+    {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+        InitRowFunctions_NEON();
+#endif
+    }
+}
+
+// The row functions are selected on first use. Concurrent first calls
+// select the same functions, so no locking is needed.
+static inline void
+EnsureRowFunctions()
+{
+    if (YUY2ToUVRow == NULL)
+    {
+        InitRowFunctions();
+    }
+}
+
 
 WebRtc_UWord32
 CalcBufferSize(VideoType type, WebRtc_UWord32 width, WebRtc_UWord32 height)
@@ -264,72 +362,27 @@ ConvertI420ToARGB(const WebRtc_UWord8* inFrame, WebRtc_UWord8* outFrame,
     {
         return -1;
     }
-    WebRtc_Word32 diff = strideOut - width;
-    WebRtc_UWord8* out1 = outFrame;
-    WebRtc_UWord8* out2 = out1 + strideOut * 4;
-    const WebRtc_UWord8 *y1,*y2, *u, *v;
-    y1 = inFrame;
-    y2 = y1 + width;
-    u = y1 + width * height;
+    EnsureRowFunctions();
+    WebRtc_UWord8* out = outFrame;
+    const WebRtc_UWord8 *y, *u, *v;
+    y = inFrame;
+    u = y + width * height;
     v = u + (( width * height ) >> 2 );
-    WebRtc_UWord32 h, w;
-    WebRtc_Word32 tmpR, tmpG, tmpB;
+    // the last pixel of odd widths is not converted
+    const WebRtc_UWord32 evenWidth = width & ~1u;
 
-    for (h = (height >> 1); h > 0; h--)
+    for (WebRtc_UWord32 h = 0; h < (height & ~1u); h++)
     {
-        //do 2 rows at the time
-        for (w = 0; w < (width >> 1); w++)
-        {   // vertical and horizontal sub-sampling
-
-            tmpR = (WebRtc_UWord32)((mapYc[y1[0]] + mapVcr[v[0]] + 128) >> 8);
-            tmpG = (WebRtc_UWord32)((mapYc[y1[0]] + mapUcg[u[0]] + mapVcg[v[0]]
-                                     +128) >> 8);
-            tmpB = (WebRtc_UWord32)((mapYc[y1[0]] + mapUcb[u[0]] + 128) >> 8);
-            out1[3] = 0xff;
-            out1[2] = Clip(tmpR);
-            out1[1] = Clip(tmpG);
-            out1[0] = Clip(tmpB);
-
-            tmpR = (WebRtc_UWord32)((mapYc[y2[0]] + mapVcr[v[0]] + 128) >> 8);
-            tmpG = (WebRtc_UWord32)((mapYc[y2[0]] + mapUcg[u[0]] + mapVcg[v[0]]
-                                     + 128) >> 8);
-            tmpB = (WebRtc_UWord32)((mapYc[y2[0]] + mapUcb[u[0]] + 128) >> 8);
-            out2[3] = 0xff;
-            out2[2] = Clip(tmpR);
-            out2[1] = Clip(tmpG);
-            out2[0] = Clip(tmpB);
-
-            tmpR = (WebRtc_UWord32)((mapYc[y1[1]] + mapVcr[v[0]] + 128) >> 8);
-            tmpG = (WebRtc_UWord32)((mapYc[y1[1]] + mapUcg[u[0]] + mapVcg[v[0]]
-                                     + 128) >> 8);
-            tmpB = (WebRtc_UWord32)((mapYc[y1[1]] + mapUcb[u[0]] + 128) >> 8);
-            out1[7] = 0xff;
-            out1[6] = Clip(tmpR);
-            out1[5] = Clip(tmpG);
-            out1[4] = Clip(tmpB);
-
-            tmpR = (WebRtc_UWord32)((mapYc[y2[1]] + mapVcr[v[0]] + 128) >> 8);
-            tmpG = (WebRtc_UWord32)((mapYc[y2[1]] + mapUcg[u[0]] + mapVcg[v[0]]
-                                     + 128) >> 8);
-            tmpB = (WebRtc_UWord32)((mapYc[y2[1]] + mapUcb[u[0]] + 128) >> 8);
-            out2[7] = 0xff;
-            out2[6] = Clip(tmpR);
-            out2[5] = Clip(tmpG);
-            out2[4] = Clip(tmpB);
-
-            out1 += 8;
-            out2 += 8;
-            y1 += 2;
-            y2 += 2;
-            u++;
-            v++;
+        // vertical sub-sampling, two rows share chroma
+        I420ToARGBRow(y, u, v, out, evenWidth);
+        y += width;
+        out += strideOut * 4;
+        if (h & 1)
+        {
+            u += width >> 1;
+            v += width >> 1;
         }
-        y1 += width;
-        y2 += width;
-        out1 += (strideOut + diff) * 4;
-        out2 += (strideOut + diff) * 4;
-
-    } // end height for
+    }
     return strideOut * height * 4;
 }
 
@@ -1066,11 +1119,8 @@ ConvertNV12ToI420(const WebRtc_UWord8* inFrame, WebRtc_UWord8* outFrame,
     u = outFrame + width * height;
     v = u + (width * height >> 2);
     interlacedSrc = inFrame + width * height;
-    for (WebRtc_UWord32 ind = 0; ind < (width * height >> 2); ind ++)
-    {
-        u[ind] = interlacedSrc[2 * ind];
-        v[ind] = interlacedSrc[2 * ind + 1];
-    }
+    EnsureRowFunctions();
+    SplitUVRow(interlacedSrc, u, v, width * height >> 2);
     return (width * height * 3 >> 1);
 }
 WebRtc_Word32
@@ -2098,7 +2148,6 @@ ConvertYUY2ToI420(const WebRtc_UWord8* inFrame, WebRtc_UWord32 inWidth,
         return -1;
     }
     WebRtc_UWord32 i = 0;
-    WebRtc_UWord32 j = 0;
     WebRtc_Word32 cutDiff = 0; // in pixels
     WebRtc_Word32 padDiffLow = 0; // in pixels
     WebRtc_Word32 padDiffHigh = 0; // in pixels
@@ -2150,7 +2199,11 @@ ConvertYUY2ToI420(const WebRtc_UWord8* inFrame, WebRtc_UWord32 inWidth,
         height = outHeight;
     else
         height = inHeight;
+    // pixels converted per row, 2 pixels per loop
+    const WebRtc_UWord32 rowWidth =
+        padDiffLow ? (inWidth & ~1u) : (outWidth & ~1u);
 
+    EnsureRowFunctions();
     for (; i< (height >> 1); i++) // 2 rows per loop
     {
         // pad beginning of row?
@@ -2164,17 +2217,13 @@ ConvertYUY2ToI420(const WebRtc_UWord8* inFrame, WebRtc_UWord32 inWidth,
             outCr += padDiffLow >> 1;
             outCb += padDiffLow >> 1;
 
-            for (j = 0; j < (inWidth >> 1);j++) // 2 pixels per loop
-            {
-                outI[0] = inFrame[0];
-                *outCr = (inFrame[1] + inFrame[1 + inWidth] + 1) >> 1;
-                outI[1] = inFrame[2];
-                *outCb = (inFrame[3] + inFrame[3 + inWidth] + 1) >> 1;;
-                inFrame += 4;
-                outI += 2;
-                outCr++;
-                outCb++;
-            }
+            // 2 pixels per chroma sample
+            YUY2ToYRow(inFrame, outI, rowWidth);
+            YUY2ToUVRow(inFrame, inWidth, outCr, outCb, rowWidth);
+            inFrame += rowWidth * 2;
+            outI += rowWidth;
+            outCr += rowWidth >> 1;
+            outCb += rowWidth >> 1;
             // pad end of row?
             if (padDiffHigh)
             {
@@ -2190,13 +2239,9 @@ ConvertYUY2ToI420(const WebRtc_UWord8* inFrame, WebRtc_UWord32 inWidth,
             memset(outI,0,padDiffLow);
             outI += padDiffLow;
 
-            for (j = 0; j < (inWidth >> 1); j++)
-            {
-                outI[0] = inFrame[0];
-                outI[1] = inFrame[2];
-                inFrame += 4;
-                outI += 2;
-            }
+            YUY2ToYRow(inFrame, outI, rowWidth);
+            inFrame += rowWidth * 2;
+            outI += rowWidth;
             // pad end of row?
             if (padDiffHigh)
             {
@@ -2205,28 +2250,17 @@ ConvertYUY2ToI420(const WebRtc_UWord8* inFrame, WebRtc_UWord32 inWidth,
             }
         } else
         {
-            // cut row
-            for (j = 0; j < (outWidth >> 1); j++) // 2 pixels per loop
-            {
-                outI[0] = inFrame[0];
-                *outCr = inFrame[1];
-                outI[1] = inFrame[2];
-                *outCb = inFrame[3];
-                inFrame += 4;
-                outI += 2;
-                outCr++;
-                outCb++;
-            }
-            inFrame += cutDiff * 2;
+            // cut row, the chroma of the first row is used as is
+            YUY2ToYRow(inFrame, outI, rowWidth);
+            YUY2ToUVRow(inFrame, 0, outCr, outCb, rowWidth);
+            inFrame += rowWidth * 2 + cutDiff * 2;
+            outI += rowWidth;
+            outCr += rowWidth >> 1;
+            outCb += rowWidth >> 1;
             // next row
-            for (j = 0; j < (outWidth >> 1); j++)
-            {
-                outI[0] = inFrame[0];
-                outI[1] = inFrame[2];
-                inFrame += 4;
-                outI += 2;
-            }
-            inFrame += cutDiff * 2;
+            YUY2ToYRow(inFrame, outI, rowWidth);
+            inFrame += rowWidth * 2 + cutDiff * 2;
+            outI += rowWidth;
         }
     }
     return outWidth * (outHeight >> 1) * 3;
@@ -15,6 +15,7 @@
       'target_name': 'webrtc_vplib',
       'type': '<(library)',
       'dependencies': [
+        '../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
       ],
       'include_dirs': [
         '../interface',
@@ -31,6 +32,7 @@
 
         # headers
         'conversion_tables.h',
+        'row_functions.h',
         'scale_bilinear_yuv.h',
       
         # sources
@@ -38,12 +40,28 @@
         'interpolator.cc',
         'scale_bilinear_yuv.cc',
       ],
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'vplib_sse2.cc',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'vplib_neon.cc',
+          ],
+        }],
+      ],
     },
     {
       'target_name': 'vplib_test',
       'type': 'executable',
       'dependencies': [
         'webrtc_vplib',
+        '../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
       ],
       'include_dirs': [
          '../interface',
@@ -58,6 +76,7 @@
         '../test/tester_main.cc',
         '../test/scale_test.cc',
         '../test/convert_test.cc',
+        '../test/convert_benchmark.cc',
         '../test/interpolation_test.cc',
       ], # source
     },  
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * NEON versions of the vplib row functions. The results are bit exact with
+ * the C versions.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+#include <string.h>
+
+#include "row_functions.h"
+
+namespace webrtc
+{
+
+// Loads 4 chroma samples, duplicated horizontally and offset by -128.
+static inline int16x8_t
+LoadChroma(const WebRtc_UWord8* src)
+{
+    uint32_t samples;
+    memcpy(&samples, src, sizeof(samples));
+    const uint8x8_t c = vreinterpret_u8_u32(vdup_n_u32(samples));
+    const uint8x8_t dup = vzip_u8(c, c).val[0];
+    return vreinterpretq_s16_u16(vsubl_u8(dup, vdup_n_u8(128)));
+}
+
+// Narrows (sum + 128) >> 8 to 8 bit with clipping to [0, 255].
+static inline uint8x8_t
+Narrow(int32x4_t lo, int32x4_t hi)
+{
+    const int32x4_t round = vdupq_n_s32(128);
+    const int16x8_t sum = vcombine_s16(vqshrn_n_s32(vaddq_s32(lo, round), 8),
+                                       vqshrn_n_s32(vaddq_s32(hi, round), 8));
+    return vqmovun_s16(sum);
+}
+
+static void
+I420ToARGBRow_NEON(const WebRtc_UWord8* y, const WebRtc_UWord8* u,
+                   const WebRtc_UWord8* v, WebRtc_UWord8* argb,
+                   WebRtc_UWord32 width)
+{
+    WebRtc_UWord32 x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        const int16x8_t y16 =
+            vreinterpretq_s16_u16(vsubl_u8(vld1_u8(y), vdup_n_u8(16)));
+        const int16x8_t u16 = LoadChroma(u);
+        const int16x8_t v16 = LoadChroma(v);
+        // See conversion_tables.h for the coefficients.
+        const int32x4_t yLo = vmull_n_s16(vget_low_s16(y16), 298);
+        const int32x4_t yHi = vmull_n_s16(vget_high_s16(y16), 298);
+
+        uint8x8x4_t out;
+        out.val[0] = Narrow(vmlal_n_s16(yLo, vget_low_s16(u16), 516),
+                            vmlal_n_s16(yHi, vget_high_s16(u16), 516));
+        out.val[1] = Narrow(
+            vmlal_n_s16(vmlal_n_s16(yLo, vget_low_s16(u16), -100),
+                        vget_low_s16(v16), -208),
+            vmlal_n_s16(vmlal_n_s16(yHi, vget_high_s16(u16), -100),
+                        vget_high_s16(v16), -208));
+        out.val[2] = Narrow(vmlal_n_s16(yLo, vget_low_s16(v16), 409),
+                            vmlal_n_s16(yHi, vget_high_s16(v16), 409));
+        out.val[3] = vdup_n_u8(0xff);
+        vst4_u8(argb, out);
+        y += 8;
+        u += 4;
+        v += 4;
+        argb += 32;
+    }
+    I420ToARGBRow_C(y, u, v, argb, width - x);
+}
+
+static void
+SplitUVRow_NEON(const WebRtc_UWord8* uv, WebRtc_UWord8* u, WebRtc_UWord8* v,
+                WebRtc_UWord32 width)
+{
+    WebRtc_UWord32 x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        const uint8x16x2_t in = vld2q_u8(uv);
+        vst1q_u8(u, in.val[0]);
+        vst1q_u8(v, in.val[1]);
+        uv += 32;
+        u += 16;
+        v += 16;
+    }
+    SplitUVRow_C(uv, u, v, width - x);
+}
+
+static void
+YUY2ToYRow_NEON(const WebRtc_UWord8* yuy2, WebRtc_UWord8* y,
+                WebRtc_UWord32 width)
+{
+    WebRtc_UWord32 x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        vst1q_u8(y, vld2q_u8(yuy2).val[0]);
+        yuy2 += 32;
+        y += 16;
+    }
+    YUY2ToYRow_C(yuy2, y, width - x);
+}
+
+static void
+YUY2ToUVRow_NEON(const WebRtc_UWord8* yuy2, WebRtc_UWord32 stride,
+                 WebRtc_UWord8* u, WebRtc_UWord8* v, WebRtc_UWord32 width)
+{
+    WebRtc_UWord32 x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        // Y0 U Y1 V
+        const uint8x8x4_t a = vld4_u8(yuy2);
+        const uint8x8x4_t b = vld4_u8(yuy2 + stride);
+        // vrhadd_u8 rounds up, like (a + b + 1) >> 1.
+        vst1_u8(u, vrhadd_u8(a.val[1], b.val[1]));
+        vst1_u8(v, vrhadd_u8(a.val[3], b.val[3]));
+        yuy2 += 32;
+        u += 8;
+        v += 8;
+    }
+    YUY2ToUVRow_C(yuy2, stride, u, v, width - x);
+}
+
+void
+InitRowFunctions_NEON()
+{
+    I420ToARGBRow = I420ToARGBRow_NEON;
+    SplitUVRow = SplitUVRow_NEON;
+    YUY2ToYRow = YUY2ToYRow_NEON;
+    YUY2ToUVRow = YUY2ToUVRow_NEON;
+}
+
+} // namespace webrtc
+
+#endif // WEBRTC_ARCH_ARM_NEON
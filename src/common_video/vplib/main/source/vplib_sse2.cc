@@ -0,0 +1,191 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * SSE2 versions of the vplib row functions. The results are bit exact with
+ * the C versions.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#include <string.h>
+
+#include "row_functions.h"
+
+namespace webrtc
+{
+
+// Two 16 bit coefficients for _mm_madd_epi16, lo applies to the even and hi
+// to the odd 16 bit elements.
+static inline __m128i
+Coefficients(WebRtc_Word16 lo, WebRtc_Word16 hi)
+{
+    return _mm_set1_epi32((static_cast<WebRtc_UWord16>(hi) << 16) |
+                          static_cast<WebRtc_UWord16>(lo));
+}
+
+// Computes ((a * ca + b * cb + c * cc + 128) >> 8) for 8 pixels and clips
+// the result to [0, 255] in the lower 8 bytes.
+static inline __m128i
+Combine(__m128i a, __m128i b, __m128i c, __m128i cab, __m128i cc)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(128);
+    __m128i lo = _mm_add_epi32(
+        _mm_madd_epi16(_mm_unpacklo_epi16(a, b), cab),
+        _mm_madd_epi16(_mm_unpacklo_epi16(c, zero), cc));
+    __m128i hi = _mm_add_epi32(
+        _mm_madd_epi16(_mm_unpackhi_epi16(a, b), cab),
+        _mm_madd_epi16(_mm_unpackhi_epi16(c, zero), cc));
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, round), 8);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, round), 8);
+    const __m128i packed = _mm_packs_epi32(lo, hi);
+    return _mm_packus_epi16(packed, packed);
+}
+
+// Loads 4 chroma samples, duplicated horizontally and offset by -128.
+static inline __m128i
+LoadChroma(const WebRtc_UWord8* src)
+{
+    WebRtc_Word32 samples;
+    memcpy(&samples, src, sizeof(samples));
+    __m128i c = _mm_cvtsi32_si128(samples);
+    c = _mm_unpacklo_epi8(c, c);
+    c = _mm_unpacklo_epi8(c, _mm_setzero_si128());
+    return _mm_sub_epi16(c, _mm_set1_epi16(128));
+}
+
+static void
+I420ToARGBRow_SSE2(const WebRtc_UWord8* y, const WebRtc_UWord8* u,
+                   const WebRtc_UWord8* v, WebRtc_UWord8* argb,
+                   WebRtc_UWord32 width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xff));
+    const __m128i offsetY = _mm_set1_epi16(16);
+    // See conversion_tables.h for the coefficients.
+    const __m128i coeffR = Coefficients(298, 409);
+    const __m128i coeffG = Coefficients(298, -100);
+    const __m128i coeffGv = Coefficients(-208, 0);
+    const __m128i coeffB = Coefficients(298, 516);
+
+    WebRtc_UWord32 x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i y16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(y));
+        y16 = _mm_sub_epi16(_mm_unpacklo_epi8(y16, zero), offsetY);
+        const __m128i u16 = LoadChroma(u);
+        const __m128i v16 = LoadChroma(v);
+
+        const __m128i r = Combine(y16, v16, zero, coeffR, zero);
+        const __m128i g = Combine(y16, u16, v16, coeffG, coeffGv);
+        const __m128i b = Combine(y16, u16, zero, coeffB, zero);
+
+        const __m128i bg = _mm_unpacklo_epi8(b, g);
+        const __m128i ra = _mm_unpacklo_epi8(r, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(argb),
+                         _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(argb + 16),
+                         _mm_unpackhi_epi16(bg, ra));
+        y += 8;
+        u += 4;
+        v += 4;
+        argb += 32;
+    }
+    I420ToARGBRow_C(y, u, v, argb, width - x);
+}
+
+static void
+SplitUVRow_SSE2(const WebRtc_UWord8* uv, WebRtc_UWord8* u, WebRtc_UWord8* v,
+                WebRtc_UWord32 width)
+{
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    WebRtc_UWord32 x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv));
+        const __m128i b =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(u),
+                         _mm_packus_epi16(_mm_and_si128(a, mask),
+                                          _mm_and_si128(b, mask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(v),
+                         _mm_packus_epi16(_mm_srli_epi16(a, 8),
+                                          _mm_srli_epi16(b, 8)));
+        uv += 32;
+        u += 16;
+        v += 16;
+    }
+    SplitUVRow_C(uv, u, v, width - x);
+}
+
+static void
+YUY2ToYRow_SSE2(const WebRtc_UWord8* yuy2, WebRtc_UWord8* y,
+                WebRtc_UWord32 width)
+{
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    WebRtc_UWord32 x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        const __m128i a =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(yuy2));
+        const __m128i b =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(yuy2 + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y),
+                         _mm_packus_epi16(_mm_and_si128(a, mask),
+                                          _mm_and_si128(b, mask)));
+        yuy2 += 32;
+        y += 16;
+    }
+    YUY2ToYRow_C(yuy2, y, width - x);
+}
+
+static void
+YUY2ToUVRow_SSE2(const WebRtc_UWord8* yuy2, WebRtc_UWord32 stride,
+                 WebRtc_UWord8* u, WebRtc_UWord8* v, WebRtc_UWord32 width)
+{
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    WebRtc_UWord32 x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        // _mm_avg_epu8 rounds up, like (a + b + 1) >> 1.
+        const __m128i a = _mm_avg_epu8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(yuy2)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(yuy2 + stride)));
+        const __m128i b = _mm_avg_epu8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(yuy2 + 16)),
+            _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(yuy2 + 16 + stride)));
+        // Interleaved U and V.
+        const __m128i uv = _mm_packus_epi16(_mm_srli_epi16(a, 8),
+                                            _mm_srli_epi16(b, 8));
+        const __m128i u8 = _mm_packus_epi16(_mm_and_si128(uv, mask), uv);
+        const __m128i v8 = _mm_packus_epi16(_mm_srli_epi16(uv, 8), uv);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u), u8);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v), v8);
+        yuy2 += 32;
+        u += 8;
+        v += 8;
+    }
+    YUY2ToUVRow_C(yuy2, stride, u, v, width - x);
+}
+
+void
+InitRowFunctions_SSE2()
+{
+    I420ToARGBRow = I420ToARGBRow_SSE2;
+    SplitUVRow = SplitUVRow_SSE2;
+    YUY2ToYRow = YUY2ToYRow_SSE2;
+    YUY2ToUVRow = YUY2ToUVRow_SSE2;
+}
+
+} // namespace webrtc
+
+#endif // __SSE2__
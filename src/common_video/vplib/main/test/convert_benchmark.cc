@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Benchmark of the color space conversions with and without the SIMD row
+// functions. Also verifies that both give the same result.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cpu_features_wrapper.h"
+#include "row_functions.h"
+#include "test_util.h"
+#include "vplib.h"
+
+using namespace webrtc;
+
+enum { kBenchmarkIterations = 200 };
+
+enum BenchmarkConversion
+{
+    kBenchmarkI420ToARGB = 0,
+    kBenchmarkNV12ToI420,
+    kBenchmarkYUY2ToI420,
+    kBenchmarkConversions
+};
+
+static const char* kConversionNames[kBenchmarkConversions] =
+{
+    "I420 -> ARGB",
+    "NV12 -> I420",
+    "YUY2 -> I420"
+};
+
+static void
+RunConversion(int conversion, const WebRtc_UWord8* inFrame,
+              WebRtc_UWord8* outFrame, WebRtc_UWord32 width,
+              WebRtc_UWord32 height)
+{
+    switch (conversion)
+    {
+    case kBenchmarkI420ToARGB:
+        ConvertI420ToARGB(inFrame, outFrame, width, height, 0);
+        break;
+    case kBenchmarkNV12ToI420:
+        ConvertNV12ToI420(inFrame, outFrame, width, height);
+        break;
+    case kBenchmarkYUY2ToI420:
+        ConvertYUY2ToI420(inFrame, width, height, outFrame, width, height);
+        break;
+    }
+}
+
+// Returns the throughput in megapixels per second.
+static double
+TimeConversion(int conversion, const WebRtc_UWord8* inFrame,
+               WebRtc_UWord8* outFrame, WebRtc_UWord32 width,
+               WebRtc_UWord32 height)
+{
+    clock_t ticks = clock();
+    for (int i = 0; i < kBenchmarkIterations; i++)
+    {
+        RunConversion(conversion, inFrame, outFrame, width, height);
+    }
+    ticks = clock() - ticks;
+    if (ticks == 0)
+    {
+        ticks = 1;
+    }
+    const double seconds = static_cast<double>(ticks) / CLOCKS_PER_SEC;
+    return (static_cast<double>(width) * height * kBenchmarkIterations) /
+        (seconds * 1e6);
+}
+
+int convert_benchmark(CmdArgs& args)
+{
+    const WebRtc_UWord32 width = (args.width > 0) ? args.width : 640;
+    const WebRtc_UWord32 height = (args.height > 0) ? args.height : 480;
+    // Large enough for any of the input and output formats.
+    const WebRtc_UWord32 bufferSize = width * height * 4;
+
+    WebRtc_UWord8* inFrame = new WebRtc_UWord8[bufferSize];
+    WebRtc_UWord8* refFrame = new WebRtc_UWord8[bufferSize];
+    WebRtc_UWord8* outFrame = new WebRtc_UWord8[bufferSize];
+    srand(0);
+    for (WebRtc_UWord32 i = 0; i < bufferSize; i++)
+    {
+        inFrame[i] = static_cast<WebRtc_UWord8>(rand());
+    }
+
+    const WebRtc_CPUInfo getCPUInfo = WebRtc_GetCPUInfo;
+    int ret = 0;
+    printf("%ux%u, %d iterations\n", width, height, kBenchmarkIterations);
+    printf("%-14s %12s %12s %8s\n", "", "C (MP/s)", "SIMD (MP/s)", "speedup");
+    for (int conversion = 0; conversion < kBenchmarkConversions; conversion++)
+    {
+        memset(refFrame, 0, bufferSize);
+        memset(outFrame, 0, bufferSize);
+
+        WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+        InitRowFunctions();
+        RunConversion(conversion, inFrame, refFrame, width, height);
+        const double scalar =
+            TimeConversion(conversion, inFrame, refFrame, width, height);
+
+        WebRtc_GetCPUInfo = getCPUInfo;
+        InitRowFunctions();
+        RunConversion(conversion, inFrame, outFrame, width, height);
+        const double simd =
+            TimeConversion(conversion, inFrame, outFrame, width, height);
+
+        printf("%-14s %12.1f %12.1f %7.2fx\n", kConversionNames[conversion],
+               scalar, simd, simd / scalar);
+        if (memcmp(refFrame, outFrame, bufferSize) != 0)
+        {
+            printf("%s: SIMD result differs from C\n",
+                   kConversionNames[conversion]);
+            ret = -1;
+        }
+    }
+
+    delete [] inFrame;
+    delete [] refFrame;
+    delete [] outFrame;
+    return ret;
+}
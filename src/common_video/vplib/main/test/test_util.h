@@ -34,6 +34,7 @@ public:
 int interpolation_test(CmdArgs& args);
 int convert_test(CmdArgs& args);
 int scale_test();
+int convert_benchmark(CmdArgs& args);
 
 #define PRINT_ERR_MSG(msg)                              \
     do {                                                \
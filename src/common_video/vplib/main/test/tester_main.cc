@@ -120,6 +120,10 @@ int main(int argc, char **argv)
             printf("VPLIB Convert Test\n");
             ret = convert_test(args);
             break;
+        case 4:
+            printf("VPLIB Convert Benchmark\n");
+            ret = convert_benchmark(args);
+            break;
         default:
             ret = -1;
             break;
@@ -123,6 +123,27 @@
         '../test/NetEqRTPplay.cc',
       ],
     },
+    {
+      'target_name': 'NetEqSim',
+      'type': 'executable',
+      'dependencies': [
+        'NetEq',         # NetEQ library defined above
+        'NetEqTestTools',# Test helpers
+        '../../../codecs/G711/main/source/g711.gyp:G711',
+        '../../../codecs/G722/main/source/g722.gyp:G722',
+        '../../../codecs/PCM16B/main/source/pcm16b.gyp:PCM16B',
+        '../../../codecs/iLBC/main/source/ilbc.gyp:iLBC',
+        '../../../codecs/iSAC/main/source/isac.gyp:iSAC',
+        '../../../codecs/CNG/main/source/cng.gyp:CNG',
+      ],
+      'include_dirs': [
+        '../source',
+        '../test',
+      ],
+      'sources': [
+        '../test/NetEqSim.cc',
+      ],
+    },
     {
       'target_name': 'RTPencode',
       'type': 'executable',
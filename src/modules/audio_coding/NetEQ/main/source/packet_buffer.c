@@ -29,6 +29,170 @@ extern FILE *delay_fid2; /* file pointer to delay log file */
 extern WebRtc_UWord32 tot_received_packets;
 #endif /* NETEQ_DELAY_LOGGING */
 
+/*
+ * The occupied slots are kept in sortedPositions, a ring ordered by timestamp (as an
+ * unsigned number), rcuPlCntr and slot. Packets arriving in order are appended at the
+ * end of the ring and the oldest packet is extracted from the start, so both are O(1);
+ * other insertions and removals move the shorter side of the ring.
+ */
+
+/* Returns the index in sortedPositions of the n-th packet in the ring */
+static int SortedIndex(const PacketBuf_t *bufferInst, int n)
+{
+    int index = bufferInst->sortedHead + n;
+
+    if (index >= bufferInst->maxInsertPositions)
+    {
+        index -= bufferInst->maxInsertPositions;
+    }
+    return index;
+}
+
+/* Returns the slot of the n-th packet in the ring */
+static int SortedSlot(const PacketBuf_t *bufferInst, int n)
+{
+    return bufferInst->sortedPositions[SortedIndex(bufferInst, n)];
+}
+
+/* Returns 1 if the packet in slot a is ordered before the packet in slot b */
+static int SortedLess(const PacketBuf_t *bufferInst, int a, int b)
+{
+    if (bufferInst->timeStamp[a] != bufferInst->timeStamp[b])
+    {
+        return (bufferInst->timeStamp[a] < bufferInst->timeStamp[b]);
+    }
+    if (bufferInst->rcuPlCntr[a] != bufferInst->rcuPlCntr[b])
+    {
+        return (bufferInst->rcuPlCntr[a] < bufferInst->rcuPlCntr[b]);
+    }
+    return (a < b);
+}
+
+/* Returns the ring position of the first packet with timestamp >= timeStamp */
+static int SortedFindTimestamp(const PacketBuf_t *bufferInst, WebRtc_UWord32 timeStamp)
+{
+    int low = 0;
+    int high = bufferInst->numPacketsInBuffer;
+
+    while (low < high)
+    {
+        int mid = (low + high) >> 1;
+        if (bufferInst->timeStamp[SortedSlot(bufferInst, mid)] < timeStamp)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/* Returns the ring position where the packet in slot should be (or is) stored */
+static int SortedFindSlot(const PacketBuf_t *bufferInst, int slot)
+{
+    int low = 0;
+    int high = bufferInst->numPacketsInBuffer;
+
+    while (low < high)
+    {
+        int mid = (low + high) >> 1;
+        if (SortedLess(bufferInst, SortedSlot(bufferInst, mid), slot))
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/* Adds the packet in slot to the ring and increases numPacketsInBuffer */
+static void SortedInsert(PacketBuf_t *bufferInst, int slot)
+{
+    int n = bufferInst->numPacketsInBuffer;
+    int pos = SortedFindSlot(bufferInst, slot);
+    int i;
+
+    if (pos < n - pos)
+    {
+        /* Move the packets before pos one step backwards */
+        bufferInst->sortedHead = SortedIndex(bufferInst, bufferInst->maxInsertPositions - 1);
+        for (i = 0; i < pos; i++)
+        {
+            bufferInst->sortedPositions[SortedIndex(bufferInst, i)]
+                = (WebRtc_Word16) SortedSlot(bufferInst, i + 1);
+        }
+    }
+    else
+    {
+        /* Move the packets from pos one step forward */
+        for (i = n; i > pos; i--)
+        {
+            bufferInst->sortedPositions[SortedIndex(bufferInst, i)]
+                = (WebRtc_Word16) SortedSlot(bufferInst, i - 1);
+        }
+    }
+    bufferInst->sortedPositions[SortedIndex(bufferInst, pos)] = (WebRtc_Word16) slot;
+    bufferInst->numPacketsInBuffer++;
+}
+
+/* Removes count packets from ring position first and decreases numPacketsInBuffer */
+static void SortedRemove(PacketBuf_t *bufferInst, int first, int count)
+{
+    int n = bufferInst->numPacketsInBuffer;
+    int i;
+
+    if (count <= 0)
+    {
+        return;
+    }
+
+    if (first < n - first - count)
+    {
+        /* Move the packets before first count steps forward */
+        for (i = first - 1; i >= 0; i--)
+        {
+            bufferInst->sortedPositions[SortedIndex(bufferInst, i + count)]
+                = (WebRtc_Word16) SortedSlot(bufferInst, i);
+        }
+        bufferInst->sortedHead = SortedIndex(bufferInst, count);
+    }
+    else
+    {
+        /* Move the packets after the removed ones count steps backwards */
+        for (i = first; i < n - count; i++)
+        {
+            bufferInst->sortedPositions[SortedIndex(bufferInst, i)]
+                = (WebRtc_Word16) SortedSlot(bufferInst, i + count);
+        }
+    }
+    bufferInst->numPacketsInBuffer -= count;
+}
+
+/* Throws away count packets from ring position first, as too old */
+static void SortedDiscardOld(PacketBuf_t *bufferInst, int first, int count)
+{
+    int i;
+
+    for (i = first; i < first + count; i++)
+    {
+        int slot = SortedSlot(bufferInst, i);
+
+        /* Clear the position in the buffer */
+        bufferInst->payloadType[slot] = -1;
+        bufferInst->payloadLengthBytes[slot] = 0;
+
+        /* Increase discard counter for in-call and post-call statistics */
+        bufferInst->discardedPackets++;
+        bufferInst->totalDiscardedPackets++;
+    }
+    SortedRemove(bufferInst, first, count);
+}
+
 
 int WebRtcNetEQ_PacketBufferInit(PacketBuf_t *bufferInst, int maxNoOfPackets,
                                  WebRtc_Word16 *pw16_memory, int memorySize)
@@ -78,6 +242,9 @@ int WebRtcNetEQ_PacketBufferInit(PacketBuf_t *bufferInst, int maxNoOfPackets,
     bufferInst->rcuPlCntr = &pw16_memory[pos];
     pos += maxNoOfPackets; /* advance maxNoOfPackets * WebRtc_Word16 */
 
+    bufferInst->sortedPositions = &pw16_memory[pos];
+    pos += maxNoOfPackets; /* advance maxNoOfPackets * WebRtc_Word16 */
+
     /* The payload memory starts after the slot arrays */
     bufferInst->startPayloadMemory = &pw16_memory[pos];
     bufferInst->currentMemoryPos = bufferInst->startPayloadMemory;
@@ -93,6 +260,8 @@ int WebRtcNetEQ_PacketBufferInit(PacketBuf_t *bufferInst, int maxNoOfPackets,
     bufferInst->numPacketsInBuffer = 0;
     bufferInst->packSizeSamples = 0;
     bufferInst->insertPosition = 0;
+    bufferInst->oldestPosition = 0;
+    bufferInst->sortedHead = 0;
 
     /* Reset buffer statistics */
     bufferInst->discardedPackets = 0;
@@ -126,6 +295,8 @@ int WebRtcNetEQ_PacketBufferFlush(PacketBuf_t *bufferInst)
     bufferInst->numPacketsInBuffer = 0;
     bufferInst->currentMemoryPos = bufferInst->startPayloadMemory;
     bufferInst->insertPosition = 0;
+    bufferInst->oldestPosition = 0;
+    bufferInst->sortedHead = 0;
 
     /* Clear all slots, starting with the last one */
     for (i = (bufferInst->maxInsertPositions - 1); i >= 0; i--)
@@ -180,6 +351,16 @@ int WebRtcNetEQ_PacketBufferInsert(PacketBuf_t *bufferInst, const RTPPacket_t *R
             bufferInst->insertPosition = 0;
         }
 
+        /* Skip the slots of the extracted packets that were inserted first */
+        while (bufferInst->payloadLengthBytes[bufferInst->oldestPosition] == 0)
+        {
+            bufferInst->oldestPosition++;
+            if (bufferInst->oldestPosition >= bufferInst->maxInsertPositions)
+            {
+                bufferInst->oldestPosition = 0;
+            }
+        }
+
         /* Check if there is enough space for the new packet */
         if (bufferInst->currentMemoryPos + ((RTPpacket->payloadLen + 1) >> 1)
             >= &bufferInst->startPayloadMemory[bufferInst->memorySizeW16])
@@ -195,6 +376,7 @@ int WebRtcNetEQ_PacketBufferInsert(PacketBuf_t *bufferInst, const RTPPacket_t *R
             /*
              * Now, we must search for the next non-empty payload,
              * finding the one with the lowest start address for the payload
+             * (this happens once per lap of the payload memory)
              */
             tempMemAddress = &bufferInst->startPayloadMemory[bufferInst->memorySizeW16];
             nextPos = -1;
@@ -225,30 +407,11 @@ int WebRtcNetEQ_PacketBufferInsert(PacketBuf_t *bufferInst, const RTPPacket_t *R
         {
             /* Payload fits at the end of memory. */
 
-            /* Find the next non-empty slot. */
-            nextPos = bufferInst->insertPosition + 1;
-
-            /* Increase nextPos until a non-empty slot is found or end of array is encountered*/
-            while ((bufferInst->payloadLengthBytes[nextPos] == 0) && (nextPos
-                < bufferInst->maxInsertPositions))
-            {
-                nextPos++;
-            }
-
-            if (nextPos == bufferInst->maxInsertPositions)
-            {
-                /*
-                 * Reached the end of the array, so there must be a packet in the first
-                 * position instead
-                 */
-                nextPos = 0;
-
-                /* Increase nextPos until a non-empty slot is found */
-                while (bufferInst->payloadLengthBytes[nextPos] == 0)
-                {
-                    nextPos++;
-                }
-            }
+            /*
+             * Slots are taken in turn, so the next non-empty slot is that of the oldest
+             * packet. (If the new slot is not empty the buffer is flushed below anyway.)
+             */
+            nextPos = bufferInst->oldestPosition;
         } /* end if-else */
 
         /*
@@ -307,7 +470,11 @@ int WebRtcNetEQ_PacketBufferInsert(PacketBuf_t *bufferInst, const RTPPacket_t *R
     bufferInst->timeStamp[bufferInst->insertPosition] = RTPpacket->timeStamp;
     bufferInst->rcuPlCntr[bufferInst->insertPosition] = RTPpacket->rcuPlCntr;
     /* Update buffer parameters */
-    bufferInst->numPacketsInBuffer++;
+    if (bufferInst->numPacketsInBuffer == 0)
+    {
+        bufferInst->oldestPosition = bufferInst->insertPosition;
+    }
+    SortedInsert(bufferInst, bufferInst->insertPosition);
     bufferInst->currentMemoryPos += (RTPpacket->payloadLen + 1) >> 1;
 
 #ifdef NETEQ_DELAY_LOGGING
@@ -371,6 +538,9 @@ int WebRtcNetEQ_PacketBufferExtract(PacketBuf_t *bufferInst, RTPPacket_t *RTPpac
     RTPpacket->rcuPlCntr = bufferInst->rcuPlCntr[bufferPosition];
     RTPpacket->starts_byte1 = 0; /* payload is 16-bit aligned */
 
+    /* Remove the packet from the ring, which also reduces the packet counter */
+    SortedRemove(bufferInst, SortedFindSlot(bufferInst, bufferPosition), 1);
+
     /* Clear the position in the packet buffer */
     bufferInst->payloadType[bufferPosition] = -1;
     bufferInst->payloadLengthBytes[bufferPosition] = 0;
@@ -378,8 +548,37 @@ int WebRtcNetEQ_PacketBufferExtract(PacketBuf_t *bufferInst, RTPPacket_t *RTPpac
     bufferInst->timeStamp[bufferPosition] = 0;
     bufferInst->payloadLocation[bufferPosition] = bufferInst->startPayloadMemory;
 
-    /* Reduce packet counter with one */
-    bufferInst->numPacketsInBuffer--;
+    return (0);
+}
+
+
+int WebRtcNetEQ_PacketBufferDiscard(PacketBuf_t *bufferInst, int bufferPosition)
+{
+
+    /* Sanity check */
+    if (bufferInst->startPayloadMemory == NULL)
+    {
+        /* packet buffer has not been initialized */
+        return (PBUFFER_NOT_INITIALIZED);
+    }
+
+    if (bufferPosition < 0 || bufferPosition >= bufferInst->maxInsertPositions)
+    {
+        /* buffer position is outside valid range */
+        return (NETEQ_OTHER_ERROR);
+    }
+
+    if (bufferInst->payloadLengthBytes[bufferPosition] <= 0)
+    {
+        /* The position does not contain a valid payload */
+        return (PBUFFER_NONEXISTING_PACKET);
+    }
+
+    SortedRemove(bufferInst, SortedFindSlot(bufferInst, bufferPosition), 1);
+
+    /* Clear the position in the packet buffer */
+    bufferInst->payloadType[bufferPosition] = -1;
+    bufferInst->payloadLengthBytes[bufferPosition] = 0;
 
     return (0);
 }
@@ -391,10 +590,8 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
                                                 int *bufferPosition, int eraseOldPkts,
                                                 WebRtc_Word16 *payloadType)
 {
-    WebRtc_Word32 timeStampDiff = WEBRTC_SPL_WORD32_MAX; /* Smallest diff found */
-    WebRtc_Word32 newDiff;
-    int i;
-    WebRtc_Word16 rcuPlCntr;
+    WebRtc_UWord32 oldestTS;
+    int first, end;
 
     /* Sanity check */
     if (bufferInst->startPayloadMemory == NULL)
@@ -407,7 +604,6 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
     *timestamp = 0;
     *payloadType = -1; /* indicates that no packet was found */
     *bufferPosition = -1; /* indicates that no packet was found */
-    rcuPlCntr = WEBRTC_SPL_WORD16_MAX; /* indicates that no packet was found */
 
     /* Check if buffer is empty */
     if (bufferInst->numPacketsInBuffer <= 0)
@@ -416,75 +612,59 @@ int WebRtcNetEQ_PacketBufferFindLowestTimestamp(PacketBuf_t *bufferInst,
         return (0);
     }
 
-    /* Loop through all slots in buffer */
-    for (i = 0; i < bufferInst->maxInsertPositions; i++)
+    if (eraseOldPkts)
     {
-        /* Calculate difference between this slot and currentTS */
-        newDiff = (WebRtc_Word32) (bufferInst->timeStamp[i] - currentTS);
-
-        /* Check if payload should be discarded */
-        if ((newDiff < 0) /* payload is too old */
-            && (newDiff > -30000) /* account for TS wrap-around */
-            && (eraseOldPkts) /* old payloads should be discarded */
-            && (bufferInst->payloadLengthBytes[i] > 0)) /* the payload exists */
+        /*
+         * Throw away the packets that are too old, that is, with a timestamp difference
+         * to currentTS in [-29999, -1] (to account for TS wrap-around)
+         */
+        oldestTS = currentTS - 29999;
+        first = SortedFindTimestamp(bufferInst, oldestTS);
+        end = SortedFindTimestamp(bufferInst, currentTS);
+        if (oldestTS < currentTS)
         {
-            /* Throw away old packet */
-
-            /* Clear the position in the buffer */
-            bufferInst->payloadType[i] = -1;
-            bufferInst->payloadLengthBytes[i] = 0;
-
-            /* Reduce packet counter by one */
-            bufferInst->numPacketsInBuffer--;
-
-            /* Increase discard counter for in-call and post-call statistics */
-            bufferInst->discardedPackets++;
-            bufferInst->totalDiscardedPackets++;
+            SortedDiscardOld(bufferInst, first, end - first);
         }
-        else if (((newDiff < timeStampDiff) || ((newDiff == timeStampDiff)
-            && (bufferInst->rcuPlCntr[i] < rcuPlCntr))) && (bufferInst->payloadLengthBytes[i]
-            > 0))
+        else
         {
-            /*
-             * New diff is smaller than previous diffs or we have a candidate with a timestamp
-             * as previous candidate but better RCU-counter; and the payload exists.
-             */
+            /* The range wraps around zero */
+            SortedDiscardOld(bufferInst, first, bufferInst->numPacketsInBuffer - first);
+            SortedDiscardOld(bufferInst, 0, end);
+        }
 
-            /* Save this position as the best candidate */
-            *bufferPosition = i;
-            timeStampDiff = newDiff;
-            *payloadType = bufferInst->payloadType[i];
-            rcuPlCntr = bufferInst->rcuPlCntr[i];
+        if (bufferInst->numPacketsInBuffer <= 0)
+        {
+            return (0);
         }
-    } /* end of for loop */
+    }
 
-    /* check that we did find a real position */
-    if (*bufferPosition >= 0)
+    /*
+     * The smallest difference to currentTS, as a signed number, is found for the first
+     * timestamp from currentTS + 2^31 and on, continuing from the start of the ring.
+     * Equal timestamps are ordered by RCU-counter.
+     */
+    first = SortedFindTimestamp(bufferInst, currentTS + 0x80000000);
+    if (first == bufferInst->numPacketsInBuffer)
     {
-        /* get the timestamp for the best position */
-        *timestamp = bufferInst->timeStamp[*bufferPosition];
+        first = 0;
     }
 
+    /* Save this position as the best candidate */
+    *bufferPosition = SortedSlot(bufferInst, first);
+    *payloadType = bufferInst->payloadType[*bufferPosition];
+    *timestamp = bufferInst->timeStamp[*bufferPosition];
+
     return 0;
 }
 
 
 WebRtc_Word32 WebRtcNetEQ_PacketBufferGetSize(const PacketBuf_t *bufferInst)
 {
-    int i, count;
+    int count;
     WebRtc_Word32 sizeSamples;
 
-    count = 0;
-
-    /* Loop through all slots in the buffer */
-    for (i = 0; i < bufferInst->maxInsertPositions; i++)
-    {
-        /* Only count the packets with non-zero size */
-        if (bufferInst->payloadLengthBytes[i] != 0)
-        {
-            count++;
-        }
-    }
+    /* All packets in the buffer have non-zero size */
+    count = bufferInst->numPacketsInBuffer;
 
     /*
      * Calculate buffer size as number of packets times packet size
@@ -698,7 +878,8 @@ int WebRtcNetEQ_GetDefaultCodecSettings(const enum WebRtcNetEQDecoder *codecID,
     + sizeof(WebRtc_UWord16) /* seqNumber */
     + sizeof(WebRtc_Word16) /* payloadType */
     + sizeof(WebRtc_Word16) /* payloadLengthBytes */
-    + sizeof(WebRtc_Word16)); /* rcuPlCntr   */
+    + sizeof(WebRtc_Word16) /* rcuPlCntr   */
+    + sizeof(WebRtc_Word16)); /* sortedPositions */
     /* Add the extra size per slot to the memory count */
     *maxBytes += w16_tmp * (*maxSlots);
 
@@ -38,6 +38,9 @@ typedef struct
     int numPacketsInBuffer; /* The number of packets in the buffer */
     int insertPosition; /* The position to insert next packet */
     int maxInsertPositions; /* Maximum number of packets allowed */
+    int oldestPosition; /* Position of the oldest inserted packet (or an empty
+     position before it) */
+    int sortedHead; /* Start of the ring in sortedPositions */
 
     /* Arrays with one entry per packet slot */
     /* NOTE: If these are changed, the changes must be accounted for at the end of
@@ -49,6 +52,8 @@ typedef struct
     WebRtc_Word16 *payloadLengthBytes; /* Payload length of packet in slot n */
     WebRtc_Word16 *rcuPlCntr; /* zero for non-RCU payload, 1 for main payload
      2 for redundant payload */
+    WebRtc_Word16 *sortedPositions; /* Ring with the numPacketsInBuffer occupied
+     slots, ordered by timestamp, rcuPlCntr and slot */
 
     /* Statistics counters */
     WebRtc_UWord16 discardedPackets; /* Number of discarded packets */
@@ -140,6 +145,25 @@ int WebRtcNetEQ_PacketBufferInsert(PacketBuf_t *bufferInst, const RTPPacket_t *R
 int WebRtcNetEQ_PacketBufferExtract(PacketBuf_t *bufferInst, RTPPacket_t *RTPpacket,
                                     int bufferPosition);
 
+/****************************************************************************
+ * WebRtcNetEQ_PacketBufferDiscard(...)
+ *
+ * This function removes a packet from the buffer without extracting it.
+ * The discard statistics are not updated.
+ *
+ * Input:
+ *		- bufferInst	: Buffer instance
+ *		- bufferPosition: Position of the packet that should be removed
+ *
+ * Output:
+ *      - bufferInst    : Updated buffer instance
+ *
+ * Return value			:  0 - Ok
+ *						  <0 - Error
+ */
+
+int WebRtcNetEQ_PacketBufferDiscard(PacketBuf_t *bufferInst, int bufferPosition);
+
 /****************************************************************************
  * WebRtcNetEQ_PacketBufferFindLowestTimestamp(...)
  *
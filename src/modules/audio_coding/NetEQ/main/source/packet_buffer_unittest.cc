@@ -0,0 +1,402 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file includes unit tests for the NetEQ packet buffer. The buffer is
+ * compared against a reference that keeps the packets in a plain list and
+ * finds the lowest timestamp by scanning all of them.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include "packet_buffer.h"
+#include "neteq_error_codes.h"
+}
+
+namespace {
+
+const int kMaxPackets = 20;
+const int kPackSizeSamples = 160;
+const int kMaxPayloadBytes = 120;
+
+// A packet in the reference.
+struct RefPacket {
+  WebRtc_UWord16 seq;
+  WebRtc_UWord32 timestamp;
+  WebRtc_Word16 rcu;
+  int payload_type;
+  WebRtc_Word16 length;
+};
+
+// Byte i of the payload of the packet with sequence number seq.
+WebRtc_UWord8 PayloadByte(WebRtc_UWord16 seq, int i) {
+  return static_cast<WebRtc_UWord8>(seq * 7 + i);
+}
+
+class PacketBufferTest : public ::testing::Test {
+ protected:
+  PacketBufferTest()
+      : next_seq_(0), discarded_(0), flushed_(0), random_(1) {}
+
+  void Init(int memory_size_w16) {
+    memory_.resize(memory_size_w16);
+    ASSERT_EQ(0, WebRtcNetEQ_PacketBufferInit(&buffer_, kMaxPackets,
+                                              &memory_[0], memory_size_w16));
+    buffer_.packSizeSamples = kPackSizeSamples;
+    ref_.clear();
+    discarded_ = 0;
+    flushed_ = 0;
+  }
+
+  // Returns a pseudo-random number in [0, n).
+  int Random(int n) {
+    random_ = random_ * 1103515245 + 12345;
+    return static_cast<int>((random_ >> 8) % n);
+  }
+
+  // Inserts a packet in the buffer and the reference. Returns the flushed
+  // flag.
+  int Insert(WebRtc_UWord32 timestamp, WebRtc_Word16 rcu, int payload_type,
+             WebRtc_Word16 length) {
+    RefPacket packet = {next_seq_++, timestamp, rcu, payload_type, length};
+    WebRtc_Word16 payload[(kMaxPayloadBytes + 1) / 2];
+    WebRtc_UWord8* bytes = reinterpret_cast<WebRtc_UWord8*>(payload);
+    for (int i = 0; i < length; i++) {
+      bytes[i] = PayloadByte(packet.seq, i);
+    }
+    RTPPacket_t rtp;
+    memset(&rtp, 0, sizeof(rtp));
+    rtp.seqNumber = packet.seq;
+    rtp.timeStamp = timestamp;
+    rtp.payloadType = payload_type;
+    rtp.payload = payload;
+    rtp.payloadLen = length;
+    rtp.rcuPlCntr = rcu;
+
+    WebRtc_Word16 flushed = 0;
+    EXPECT_EQ(0, WebRtcNetEQ_PacketBufferInsert(&buffer_, &rtp, &flushed));
+    if (flushed) {
+      flushed_ += static_cast<WebRtc_UWord32>(ref_.size());
+      ref_.clear();
+    }
+    ref_.push_back(packet);
+    return flushed;
+  }
+
+  // Returns the slot of the packet with sequence number seq, or -1.
+  int SlotOf(WebRtc_UWord16 seq) const {
+    for (int i = 0; i < kMaxPackets; i++) {
+      if (buffer_.payloadLengthBytes[i] > 0 && buffer_.seqNumber[i] == seq) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // The reference FindLowestTimestamp. Returns the index in ref_, or -1.
+  int RefFindLowest(WebRtc_UWord32 current_ts, bool erase_old) {
+    if (erase_old) {
+      for (size_t i = 0; i < ref_.size();) {
+        const WebRtc_Word32 diff =
+            static_cast<WebRtc_Word32>(ref_[i].timestamp - current_ts);
+        if (diff < 0 && diff > -30000) {
+          ref_.erase(ref_.begin() + i);
+          discarded_++;
+        } else {
+          i++;
+        }
+      }
+    }
+    int best = -1;
+    for (size_t i = 0; i < ref_.size(); i++) {
+      const WebRtc_Word32 diff =
+          static_cast<WebRtc_Word32>(ref_[i].timestamp - current_ts);
+      if (best < 0) {
+        best = static_cast<int>(i);
+        continue;
+      }
+      const WebRtc_Word32 best_diff =
+          static_cast<WebRtc_Word32>(ref_[best].timestamp - current_ts);
+      if (diff < best_diff ||
+          (diff == best_diff && ref_[i].rcu < ref_[best].rcu)) {
+        best = static_cast<int>(i);
+      }
+    }
+    return best;
+  }
+
+  // Compares FindLowestTimestamp with the reference. Returns the slot found.
+  int FindLowest(WebRtc_UWord32 current_ts, bool erase_old) {
+    WebRtc_UWord32 timestamp = 0;
+    int position = 0;
+    WebRtc_Word16 payload_type = 0;
+    EXPECT_EQ(0, WebRtcNetEQ_PacketBufferFindLowestTimestamp(
+        &buffer_, current_ts, &timestamp, &position, erase_old ? 1 : 0,
+        &payload_type));
+    const int best = RefFindLowest(current_ts, erase_old);
+    if (best < 0) {
+      EXPECT_EQ(-1, position);
+      EXPECT_EQ(-1, payload_type);
+      return position;
+    }
+    EXPECT_GE(position, 0);
+    if (position < 0) {
+      return position;
+    }
+    // Packets with the same timestamp and RCU counter are equally good.
+    EXPECT_EQ(ref_[best].timestamp, timestamp);
+    EXPECT_EQ(ref_[best].timestamp, buffer_.timeStamp[position]);
+    EXPECT_EQ(ref_[best].rcu, buffer_.rcuPlCntr[position]);
+    EXPECT_EQ(payload_type, buffer_.payloadType[position]);
+    EXPECT_GT(buffer_.payloadLengthBytes[position], 0);
+    return position;
+  }
+
+  // Extracts the packet in slot and checks it against the reference.
+  void Extract(int slot) {
+    WebRtc_Word16 payload[(kMaxPayloadBytes + 1) / 2];
+    RTPPacket_t rtp;
+    memset(&rtp, 0, sizeof(rtp));
+    rtp.payload = payload;
+    ASSERT_EQ(0, WebRtcNetEQ_PacketBufferExtract(&buffer_, &rtp, slot));
+    const int index = RefIndex(rtp.seqNumber);
+    ASSERT_GE(index, 0);
+    const RefPacket& packet = ref_[index];
+    EXPECT_EQ(packet.timestamp, rtp.timeStamp);
+    EXPECT_EQ(packet.rcu, rtp.rcuPlCntr);
+    EXPECT_EQ(packet.payload_type, rtp.payloadType);
+    ASSERT_EQ(packet.length, rtp.payloadLen);
+    const WebRtc_UWord8* bytes = reinterpret_cast<WebRtc_UWord8*>(payload);
+    for (int i = 0; i < packet.length; i++) {
+      ASSERT_EQ(PayloadByte(packet.seq, i), bytes[i]);
+    }
+    ref_.erase(ref_.begin() + index);
+    EXPECT_EQ(PBUFFER_NONEXISTING_PACKET,
+              WebRtcNetEQ_PacketBufferExtract(&buffer_, &rtp, slot));
+  }
+
+  void Discard(int slot) {
+    const int index = RefIndex(buffer_.seqNumber[slot]);
+    ASSERT_GE(index, 0);
+    ASSERT_EQ(0, WebRtcNetEQ_PacketBufferDiscard(&buffer_, slot));
+    ref_.erase(ref_.begin() + index);
+    EXPECT_EQ(PBUFFER_NONEXISTING_PACKET,
+              WebRtcNetEQ_PacketBufferDiscard(&buffer_, slot));
+  }
+
+  void Flush() {
+    flushed_ += static_cast<WebRtc_UWord32>(ref_.size());
+    ref_.clear();
+    ASSERT_EQ(0, WebRtcNetEQ_PacketBufferFlush(&buffer_));
+  }
+
+  int RefIndex(WebRtc_UWord16 seq) const {
+    for (size_t i = 0; i < ref_.size(); i++) {
+      if (ref_[i].seq == seq) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  // Checks the packets, the size and the statistics of the buffer against
+  // the reference, and that the ring holds the packets in order.
+  void CheckState() {
+    const int count = static_cast<int>(ref_.size());
+    ASSERT_EQ(count, buffer_.numPacketsInBuffer);
+    EXPECT_EQ(count * kPackSizeSamples,
+              WebRtcNetEQ_PacketBufferGetSize(&buffer_));
+    EXPECT_EQ(discarded_, buffer_.totalDiscardedPackets);
+    EXPECT_EQ(static_cast<WebRtc_UWord16>(discarded_),
+              buffer_.discardedPackets);
+    EXPECT_EQ(flushed_, buffer_.totalFlushedPackets);
+
+    int occupied = 0;
+    for (int i = 0; i < kMaxPackets; i++) {
+      if (buffer_.payloadLengthBytes[i] > 0) {
+        occupied++;
+      }
+    }
+    EXPECT_EQ(count, occupied);
+    for (int i = 0; i < count; i++) {
+      const int slot = SlotOf(ref_[i].seq);
+      ASSERT_GE(slot, 0);
+      EXPECT_EQ(ref_[i].timestamp, buffer_.timeStamp[slot]);
+    }
+
+    int previous = -1;
+    for (int n = 0; n < count; n++) {
+      const int slot = buffer_.sortedPositions[
+          (buffer_.sortedHead + n) % kMaxPackets];
+      ASSERT_GT(buffer_.payloadLengthBytes[slot], 0);
+      if (previous >= 0) {
+        const WebRtc_UWord32 ts = buffer_.timeStamp[slot];
+        const WebRtc_UWord32 previous_ts = buffer_.timeStamp[previous];
+        ASSERT_LE(previous_ts, ts);
+        if (previous_ts == ts) {
+          ASSERT_LE(buffer_.rcuPlCntr[previous], buffer_.rcuPlCntr[slot]);
+          if (buffer_.rcuPlCntr[previous] == buffer_.rcuPlCntr[slot]) {
+            ASSERT_LT(previous, slot);
+          }
+        }
+      }
+      previous = slot;
+    }
+  }
+
+  void RunRandom(int memory_size_w16);
+
+  PacketBuf_t buffer_;
+  std::vector<WebRtc_Word16> memory_;
+  std::vector<RefPacket> ref_;
+  WebRtc_UWord16 next_seq_;
+  WebRtc_UWord32 discarded_;
+  WebRtc_UWord32 flushed_;
+  WebRtc_UWord32 random_;
+};
+
+TEST_F(PacketBufferTest, ExtractsPacketsInTimestampOrder) {
+  Init(4000);
+  const WebRtc_UWord32 timestamps[] = {480, 160, 0, 320, 640};
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(0, Insert(timestamps[i], 0, 0, 40 + i));
+  }
+  CheckState();
+  for (WebRtc_UWord32 ts = 0; ts <= 640; ts += 160) {
+    const int slot = FindLowest(ts, true);
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(ts, buffer_.timeStamp[slot]);
+    Extract(slot);
+    CheckState();
+  }
+  EXPECT_EQ(-1, FindLowest(800, true));
+}
+
+TEST_F(PacketBufferTest, PrefersTheMainPayloadForTheSameTimestamp) {
+  Init(4000);
+  Insert(160, 2, 1, 20);
+  Insert(160, 1, 2, 30);
+  Insert(320, 0, 3, 40);
+  const int slot = FindLowest(0, true);
+  ASSERT_GE(slot, 0);
+  EXPECT_EQ(1, buffer_.rcuPlCntr[slot]);
+  EXPECT_EQ(2, buffer_.payloadType[slot]);
+  CheckState();
+}
+
+TEST_F(PacketBufferTest, DiscardsOldPacketsAcrossTimestampWrap) {
+  Init(4000);
+  // Too old by 261 and by 29999 samples.
+  Insert(0xFFFFFF00, 0, 0, 20);
+  Insert(5 - 29999, 0, 0, 20);
+  // Older than the discard window, so kept and found first.
+  Insert(0xFFFF0000, 0, 0, 20);
+  Insert(5 - 30000, 0, 0, 20);
+  Insert(100, 0, 0, 20);
+  Insert(0, 0, 0, 20);
+
+  // Nothing is discarded unless asked.
+  int slot = FindLowest(5, false);
+  ASSERT_GE(slot, 0);
+  EXPECT_EQ(0xFFFF0000u, buffer_.timeStamp[slot]);
+  CheckState();
+
+  slot = FindLowest(5, true);
+  ASSERT_GE(slot, 0);
+  EXPECT_EQ(0xFFFF0000u, buffer_.timeStamp[slot]);
+  EXPECT_EQ(3u, discarded_);
+  CheckState();
+  Extract(slot);
+
+  slot = FindLowest(5, true);
+  ASSERT_GE(slot, 0);
+  EXPECT_EQ(5u - 30000, buffer_.timeStamp[slot]);
+  Extract(slot);
+
+  slot = FindLowest(5, true);
+  ASSERT_GE(slot, 0);
+  EXPECT_EQ(100u, buffer_.timeStamp[slot]);
+  CheckState();
+}
+
+TEST_F(PacketBufferTest, FlushesWhenAllSlotsAreTaken) {
+  Init(4000);
+  for (int i = 0; i < kMaxPackets; i++) {
+    EXPECT_EQ(0, Insert(i * 160, 0, 0, 20));
+  }
+  CheckState();
+  EXPECT_EQ(1, Insert(kMaxPackets * 160, 0, 0, 20));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kMaxPackets), flushed_);
+  CheckState();
+
+  Flush();
+  CheckState();
+  EXPECT_EQ(-1, FindLowest(0, true));
+}
+
+// Drives the buffer with random out-of-order packets, extractions, discards
+// and flushes.
+void PacketBufferTest::RunRandom(int memory_size_w16) {
+  Init(memory_size_w16);
+  // Starts just before the timestamps wrap.
+  WebRtc_UWord32 current_ts = 0xFFFFFFFF - 50000;
+  int flushes = 0;
+  for (int i = 0; i < 20000; i++) {
+    const int action = Random(100);
+    if (action < 45) {
+      WebRtc_UWord32 ts = current_ts + 160 * (Random(40) - 10);
+      if (Random(50) == 0) {
+        // Too old to be discarded.
+        ts = current_ts - 40000 - Random(1000);
+      }
+      flushes += Insert(ts, static_cast<WebRtc_Word16>(Random(3)), Random(5),
+                        static_cast<WebRtc_Word16>(1 +
+                                                   Random(kMaxPayloadBytes)));
+    } else if (action < 80) {
+      const int slot = FindLowest(current_ts, Random(4) != 0);
+      if (slot >= 0 && Random(3) != 0) {
+        Extract(slot);
+      }
+      current_ts += 160;
+    } else if (action < 90) {
+      if (!ref_.empty()) {
+        Extract(SlotOf(ref_[Random(static_cast<int>(ref_.size()))].seq));
+      }
+    } else if (action < 99) {
+      if (!ref_.empty()) {
+        Discard(SlotOf(ref_[Random(static_cast<int>(ref_.size()))].seq));
+      }
+    } else {
+      Flush();
+    }
+    CheckState();
+    if (HasFatalFailure()) {
+      return;
+    }
+  }
+  EXPECT_GT(discarded_, 0u);
+  EXPECT_GT(flushes, 0);
+}
+
+TEST_F(PacketBufferTest, MatchesTheReference) {
+  RunRandom(4000);
+}
+
+// The payloads wrap around the memory, and the buffer flushes when it runs
+// out of memory.
+TEST_F(PacketBufferTest, MatchesTheReferenceWithLittleMemory) {
+  RunRandom(600);
+}
+
+}  // namespace
@@ -206,9 +206,7 @@ int WebRtcNetEQ_SignalMcu(MCUInst_t *inst)
         {
 
             /* Don't use this packet, discard it */
-            inst->PacketBuffer_inst.payloadType[i_bufferpos] = -1;
-            inst->PacketBuffer_inst.payloadLengthBytes[i_bufferpos] = 0;
-            inst->PacketBuffer_inst.numPacketsInBuffer--;
+            WebRtcNetEQ_PacketBufferDiscard(&inst->PacketBuffer_inst, i_bufferpos);
 
             /* Check buffer again */
             WebRtcNetEQ_PacketBufferFindLowestTimestamp(&inst->PacketBuffer_inst,
@@ -690,6 +690,8 @@ int WebRtcNetEQ_CodecDbRemove(void *inst, enum WebRtcNetEQDecoder codec)
         NetEqMainInst->DSPinst.codec_ptr_inst.funcGetMDinfo = NULL;
         NetEqMainInst->DSPinst.codec_ptr_inst.funcUpdBWEst = NULL;
         NetEqMainInst->DSPinst.codec_ptr_inst.funcGetErrorCode = NULL;
+        /* signal a new codec if the codec is added and received again */
+        NetEqMainInst->MCUinst.current_Codec = -1;
     }
 
     ok = WebRtcNetEQ_DbRemove(&NetEqMainInst->MCUinst.codec_DB_inst, codec);
@@ -0,0 +1,682 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Offline NetEQ simulator. Runs rtpdump files, or all rtpdump files in
+ * directories, through RecIn/RecOut as fast as possible, once for each
+ * arrival-time jitter model, and reports CPU use per second of audio,
+ * expand/accelerate rates and delay percentiles. Mono streams only.
+ */
+
+#include "typedefs.h"
+#include "webrtc_neteq.h"
+#include "webrtc_neteq_internal.h"
+
+#include "NETEQTEST_RTPpacket.h"
+#include "NETEQTEST_NetEQClass.h"
+#include "NETEQTEST_CodecClass.h"
+
+#include <algorithm>
+#include <float.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+/*********************/
+/* Misc. definitions */
+/*********************/
+
+#define FIRSTLINELEN 40
+#define RECOUT_INTERVAL_MS 10
+#define MAX_TAIL_MS 10000 // playout after the last packet, if never drained
+#define DEFAULT_SEED 4711
+
+typedef struct
+{
+    std::string name;
+    enum WebRtcNetEQDecoder codec;
+    int fs;
+} ptypeStruct;
+
+typedef struct
+{
+    std::string trace;
+    std::string model;
+    double audioMs;
+    double cpuMs;
+    double expandMs;
+    double accelerateMs;
+    double flushedMs;
+    double lateLossMs;
+    std::vector<WebRtc_UWord16> delayMs; // current delay after each RecOut
+} simResult;
+
+/*************************/
+/* Function declarations */
+/*************************/
+
+int parsePtypeFile(const char *fileName, std::map<WebRtc_UWord8, ptypeStruct> *ptypes);
+NETEQTEST_Decoder * createDecoder(const ptypeStruct & ptype, WebRtc_UWord8 pt);
+void listTraces(const char *path, std::vector<std::string> *traces);
+int readTrace(const char *fileName, std::vector<NETEQTEST_RTPpacket> *packets);
+int applyJitterModel(const std::string & model, unsigned int seed, int fs,
+                     std::vector<NETEQTEST_RTPpacket> *packets);
+int simulate(const std::vector<NETEQTEST_RTPpacket> & packets,
+             std::map<WebRtc_UWord8, ptypeStruct> & ptypes, simResult *result);
+double percentile(std::vector<WebRtc_UWord16> values, double p);
+void printResult(FILE *fp, const simResult & result, bool csv);
+
+
+int main(int argc, char* argv[])
+{
+    std::map<WebRtc_UWord8, ptypeStruct> ptypes;
+    std::vector<std::string> traces;
+    std::vector<std::string> models;
+    const char *ptypeFile = "ptypes.txt";
+    const char *csvFile = NULL;
+    unsigned int seed = DEFAULT_SEED;
+
+    if (argc < 2)
+    {
+        printf("Offline simulator and benchmark for NetEQ.\n");
+        printf("Each RTP stream is inserted into NetEQ with the packet arrival times given by\n");
+        printf("the jitter models, and played out without waiting for real time.\n");
+        printf("The RTP streams should be in rtpdump format (as written by RtpDump or\n");
+        printf("RTPencode); directories are searched for such files.\n\n");
+        printf("Usage:\n\n");
+        printf("%s [-options] RTPfile|directory ...\n", argv[0]);
+        printf("-options are optional switches:\n");
+        printf("\t-jitter model   : arrival-time model, may be given several times\n");
+        printf("\t                  recorded    : arrival times from the file (default)\n");
+        printf("\t                  clean       : arrival times from the RTP timestamps\n");
+        printf("\t                  uniform:N   : recorded times plus 0..N ms random delay\n");
+        printf("\t                  datfile     : arrival times in ms as for RTPjitter\n");
+        printf("\t-seed n         : seed for the random jitter models (default %d)\n",
+               DEFAULT_SEED);
+        printf("\t-ptypes file    : payload type file (default ptypes.txt)\n");
+        printf("\t-csv file       : also write the results to a CSV file\n");
+        return(0);
+    }
+
+    for (int argIx = 1; argIx < argc; argIx++)
+    {
+        if (argv[argIx][0] != '-')
+        {
+            listTraces(argv[argIx], &traces);
+        }
+        else if (argIx + 1 >= argc)
+        {
+            fprintf(stderr, "Missing value for %s\n", argv[argIx]);
+            return(-1);
+        }
+        else if (strcmp(argv[argIx], "-jitter") == 0)
+        {
+            models.push_back(argv[++argIx]);
+        }
+        else if (strcmp(argv[argIx], "-seed") == 0)
+        {
+            seed = static_cast<unsigned int>(atoi(argv[++argIx]));
+        }
+        else if (strcmp(argv[argIx], "-ptypes") == 0)
+        {
+            ptypeFile = argv[++argIx];
+        }
+        else if (strcmp(argv[argIx], "-csv") == 0)
+        {
+            csvFile = argv[++argIx];
+        }
+        else
+        {
+            fprintf(stderr, "Unknown input argument %s\n", argv[argIx]);
+            return(-1);
+        }
+    }
+
+    if (models.empty())
+    {
+        models.push_back("recorded");
+    }
+
+    if (parsePtypeFile(ptypeFile, &ptypes) != 0)
+    {
+        fprintf(stderr, "Could not read payload types from %s\n", ptypeFile);
+        return(-1);
+    }
+
+    if (traces.empty())
+    {
+        fprintf(stderr, "No RTP files found\n");
+        return(-1);
+    }
+
+    FILE *csv = NULL;
+    if (csvFile)
+    {
+        csv = fopen(csvFile, "wt");
+        if (csv == NULL)
+        {
+            fprintf(stderr, "Could not open file %s for writing\n", csvFile);
+            return(-1);
+        }
+        fprintf(csv, "trace,model,audio_s,cpu_ms_per_s,realtime_factor,expand_pct,"
+            "accelerate_pct,flushed_pct,late_loss_pct,delay_p50_ms,delay_p95_ms,"
+            "delay_p99_ms\n");
+    }
+
+    printf("%-32s %-14s %8s %9s %9s %7s %7s %7s %7s %5s %5s %5s\n", "trace", "model",
+           "audio s", "cpu ms/s", "x rt", "exp %", "acc %", "flush %", "late %", "d50",
+           "d95", "d99");
+
+    // The totals per model, with the delays of all traces pooled.
+    std::vector<simResult> totals(models.size());
+    for (size_t m = 0; m < models.size(); m++)
+    {
+        totals[m].trace = "(all)";
+        totals[m].model = models[m];
+        totals[m].audioMs = totals[m].cpuMs = totals[m].expandMs = 0;
+        totals[m].accelerateMs = totals[m].flushedMs = totals[m].lateLossMs = 0;
+    }
+
+    for (size_t t = 0; t < traces.size(); t++)
+    {
+        std::vector<NETEQTEST_RTPpacket> recorded;
+        if (readTrace(traces[t].c_str(), &recorded) != 0)
+        {
+            fprintf(stderr, "Could not read %s\n", traces[t].c_str());
+            continue;
+        }
+
+        // The RTP clock rate of the first speech payload type is used by the
+        // clean jitter model.
+        int fs = 8000;
+        for (size_t k = 0; k < recorded.size(); k++)
+        {
+            if (ptypes.count(recorded[k].payloadType()) > 0)
+            {
+                const ptypeStruct & ptype = ptypes[recorded[k].payloadType()];
+                if (ptype.codec != kDecoderRED && ptype.codec != kDecoderAVT
+                    && ptype.codec != kDecoderCNG)
+                {
+                    // G.722 uses an 8 kHz RTP clock.
+                    fs = (ptype.codec == kDecoderG722) ? 8000 : ptype.fs;
+                    break;
+                }
+            }
+        }
+
+        for (size_t m = 0; m < models.size(); m++)
+        {
+            std::vector<NETEQTEST_RTPpacket> packets(recorded);
+            simResult result;
+
+            result.trace = traces[t];
+            result.model = models[m];
+            if (applyJitterModel(models[m], seed, fs, &packets) != 0)
+            {
+                fprintf(stderr, "Could not apply jitter model %s\n", models[m].c_str());
+                return(-1);
+            }
+            if (simulate(packets, ptypes, &result) != 0)
+            {
+                fprintf(stderr, "Simulation of %s failed\n", traces[t].c_str());
+                continue;
+            }
+
+            printResult(stdout, result, false);
+            if (csv)
+            {
+                printResult(csv, result, true);
+            }
+
+            totals[m].audioMs += result.audioMs;
+            totals[m].cpuMs += result.cpuMs;
+            totals[m].expandMs += result.expandMs;
+            totals[m].accelerateMs += result.accelerateMs;
+            totals[m].flushedMs += result.flushedMs;
+            totals[m].lateLossMs += result.lateLossMs;
+            totals[m].delayMs.insert(totals[m].delayMs.end(), result.delayMs.begin(),
+                                     result.delayMs.end());
+        }
+    }
+
+    for (size_t m = 0; m < models.size(); m++)
+    {
+        printResult(stdout, totals[m], false);
+        if (csv)
+        {
+            printResult(csv, totals[m], true);
+        }
+    }
+
+    if (csv)
+    {
+        fclose(csv);
+    }
+
+    return(0);
+}
+
+
+/****************/
+/* Subfunctions */
+/****************/
+
+int parsePtypeFile(const char *fileName, std::map<WebRtc_UWord8, ptypeStruct> *ptypes)
+{
+    // Payload type names of the decoders in NetEqTestTools.
+    static const struct
+    {
+        const char *name;
+        enum WebRtcNetEQDecoder codec;
+        int fs;
+    } knownCodecs[] = {
+        { "pcmu", kDecoderPCMu, 8000 },
+        { "pcma", kDecoderPCMa, 8000 },
+        { "g722", kDecoderG722, 16000 },
+        { "ilbc", kDecoderILBC, 8000 },
+        { "isac", kDecoderISAC, 16000 },
+        { "isacswb", kDecoderISACswb, 32000 },
+        { "pcm16b", kDecoderPCM16B, 8000 },
+        { "pcm16b_wb", kDecoderPCM16Bwb, 16000 },
+        { "pcm16b_swb32khz", kDecoderPCM16Bswb32kHz, 32000 },
+        { "cn", kDecoderCNG, 8000 },
+        { "cn_wb", kDecoderCNG, 16000 },
+        { "cn_swb32", kDecoderCNG, 32000 },
+        { "avt", kDecoderAVT, 8000 },
+        { "red", kDecoderRED, 8000 }
+    };
+
+    FILE *fp = fopen(fileName, "rt");
+    if (fp == NULL)
+    {
+        return(-1);
+    }
+
+    char codec[100];
+    int pt;
+    while (fscanf(fp, "%99s %i\n", codec, &pt) == 2)
+    {
+        if (pt < 0 || pt > 127)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < sizeof(knownCodecs) / sizeof(knownCodecs[0]); i++)
+        {
+            if (strcmp(codec, knownCodecs[i].name) == 0)
+            {
+                ptypeStruct ptype;
+                ptype.name = knownCodecs[i].name;
+                ptype.codec = knownCodecs[i].codec;
+                ptype.fs = knownCodecs[i].fs;
+                (*ptypes)[static_cast<WebRtc_UWord8>(pt)] = ptype;
+            }
+        }
+    }
+
+    fclose(fp);
+    return(ptypes->empty() ? -1 : 0);
+}
+
+
+NETEQTEST_Decoder * createDecoder(const ptypeStruct & ptype, WebRtc_UWord8 pt)
+{
+    switch (ptype.codec)
+    {
+    case kDecoderPCMu:
+        return new decoder_PCMU(pt);
+    case kDecoderPCMa:
+        return new decoder_PCMA(pt);
+    case kDecoderG722:
+        return new decoder_G722(pt);
+    case kDecoderILBC:
+        return new decoder_ILBC(pt);
+    case kDecoderISAC:
+        return new decoder_iSAC(pt);
+    case kDecoderISACswb:
+        return new decoder_iSACSWB(pt);
+    case kDecoderPCM16B:
+        return new decoder_PCM16B_NB(pt);
+    case kDecoderPCM16Bwb:
+        return new decoder_PCM16B_WB(pt);
+    case kDecoderPCM16Bswb32kHz:
+        return new decoder_PCM16B_SWB32(pt);
+    case kDecoderCNG:
+        return new decoder_CNG(pt, static_cast<WebRtc_UWord16>(ptype.fs));
+    case kDecoderAVT:
+        return new decoder_AVT(pt);
+    case kDecoderRED:
+        return new decoder_RED(pt);
+    default:
+        return NULL;
+    }
+}
+
+
+void listTraces(const char *path, std::vector<std::string> *traces)
+{
+    std::vector<std::string> files;
+
+#ifdef WIN32
+    WIN32_FIND_DATAA findData;
+    std::string pattern = std::string(path) + "\\*";
+    HANDLE handle = FindFirstFileA(pattern.c_str(), &findData);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        // Not a directory
+        traces->push_back(path);
+        return;
+    }
+    do
+    {
+        if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+        {
+            files.push_back(std::string(path) + "\\" + findData.cFileName);
+        }
+    } while (FindNextFileA(handle, &findData));
+    FindClose(handle);
+#else
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+    {
+        // Not a directory
+        traces->push_back(path);
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        std::string fileName = std::string(path) + "/" + entry->d_name;
+        struct stat fileStat;
+        if (stat(fileName.c_str(), &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+        {
+            files.push_back(fileName);
+        }
+    }
+    closedir(dir);
+#endif
+
+    // Keep the files with an rtpdump header, in a stable order.
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        FILE *fp = fopen(files[i].c_str(), "rb");
+        char firstline[FIRSTLINELEN];
+        if (fp == NULL)
+        {
+            continue;
+        }
+        if (fgets(firstline, FIRSTLINELEN, fp)
+            && (strncmp(firstline, "#!rtpplay1.0", 12) == 0
+                || strncmp(firstline, "#!RTPencode1.0", 14) == 0))
+        {
+            traces->push_back(files[i]);
+        }
+        fclose(fp);
+    }
+}
+
+
+int readTrace(const char *fileName, std::vector<NETEQTEST_RTPpacket> *packets)
+{
+    FILE *fp = fopen(fileName, "rb");
+    char firstline[FIRSTLINELEN];
+
+    if (fp == NULL)
+    {
+        return(-1);
+    }
+
+    /* read RTP file header */
+    if (fgets(firstline, FIRSTLINELEN, fp) == NULL
+        || (strncmp(firstline, "#!rtpplay1.0", 12) != 0
+            && strncmp(firstline, "#!RTPencode1.0", 14) != 0)
+        || fseek(fp, 4 + 4 + 4 + 2 + 2, SEEK_CUR) != 0) // start_sec + start_usec + source + port + padding
+    {
+        fclose(fp);
+        return(-1);
+    }
+
+    NETEQTEST_RTPpacket rtp;
+    int packetLen;
+    while ((packetLen = rtp.readFromFile(fp)) >= 0)
+    {
+        // A zero plen specifies RTCP
+        if (packetLen > 0 && rtp.dataLen() > 0)
+        {
+            packets->push_back(rtp);
+        }
+    }
+
+    fclose(fp);
+    return(packets->empty() ? -1 : 0);
+}
+
+
+// Sorts the packets on arrival time, keeping the file order for equal times.
+static bool earlierArrival(const NETEQTEST_RTPpacket & a, const NETEQTEST_RTPpacket & b)
+{
+    return (a.time() < b.time());
+}
+
+
+int applyJitterModel(const std::string & model, unsigned int seed, int fs,
+                     std::vector<NETEQTEST_RTPpacket> *packets)
+{
+    if (model == "recorded")
+    {
+        // keep the arrival times from the file
+    }
+    else if (model == "clean")
+    {
+        // Let the packets arrive according to the RTP timestamps.
+        WebRtc_UWord32 firstTime = (*packets)[0].time();
+        WebRtc_UWord32 firstTS = (*packets)[0].timeStamp();
+        for (size_t k = 0; k < packets->size(); k++)
+        {
+            WebRtc_Word32 diff = static_cast<WebRtc_Word32>((*packets)[k].timeStamp() - firstTS);
+            if (diff < 0)
+            {
+                diff = 0;
+            }
+            (*packets)[k].setTime(firstTime + diff / (fs / 1000));
+        }
+    }
+    else if (model.compare(0, 8, "uniform:") == 0)
+    {
+        // Extra delay from a fixed generator, so that the results can be
+        // compared between builds and platforms.
+        int maxDelay = atoi(model.c_str() + 8);
+        WebRtc_UWord32 state = seed;
+        if (maxDelay < 0)
+        {
+            return(-1);
+        }
+        for (size_t k = 0; k < packets->size(); k++)
+        {
+            state = state * 1103515245 + 12345;
+            (*packets)[k].setTime((*packets)[k].time() + (state >> 16) % (maxDelay + 1));
+        }
+    }
+    else
+    {
+        // Arrival times in ms for each packet, as floats (see RTPjitter).
+        // Packets with time FLT_MAX, or without a time, are lost.
+        FILE *fp = fopen(model.c_str(), "rb");
+        std::vector<NETEQTEST_RTPpacket> received;
+        float arrivalTime;
+        size_t k = 0;
+
+        if (fp == NULL)
+        {
+            return(-1);
+        }
+        while (k < packets->size() && fread(&arrivalTime, sizeof(float), 1, fp) == 1)
+        {
+            if (arrivalTime < FLT_MAX)
+            {
+                (*packets)[k].setTime(arrivalTime >= 0 ?
+                    static_cast<WebRtc_UWord32>(arrivalTime) : 0);
+                received.push_back((*packets)[k]);
+            }
+            k++;
+        }
+        fclose(fp);
+        packets->swap(received);
+        if (packets->empty())
+        {
+            return(-1);
+        }
+    }
+
+    std::stable_sort(packets->begin(), packets->end(), earlierArrival);
+    return(0);
+}
+
+
+int simulate(const std::vector<NETEQTEST_RTPpacket> & packets,
+             std::map<WebRtc_UWord8, ptypeStruct> & ptypes, simResult *result)
+{
+    enum WebRtcNetEQDecoder usedCodec[kDecoderReservedEnd - 1];
+    std::vector<NETEQTEST_Decoder *> decoders;
+    WebRtc_Word16 outData[640 * 2];
+    int noOfCodecs = 0;
+    int fs = 8000;
+    bool fsFound = false;
+
+    // Use the payload types present in the stream.
+    std::map<WebRtc_UWord8, bool> present;
+    for (size_t k = 0; k < packets.size(); k++)
+    {
+        WebRtc_UWord8 pt = packets[k].payloadType();
+        if (ptypes.count(pt) > 0 && present.count(pt) == 0)
+        {
+            present[pt] = true;
+            usedCodec[noOfCodecs++] = ptypes[pt].codec;
+            if (!fsFound && ptypes[pt].codec != kDecoderRED
+                && ptypes[pt].codec != kDecoderAVT && ptypes[pt].codec != kDecoderCNG)
+            {
+                fs = ptypes[pt].fs;
+                fsFound = true;
+            }
+        }
+    }
+    if (noOfCodecs == 0)
+    {
+        return(-1);
+    }
+
+    NETEQTEST_NetEQClass neteq(usedCodec, noOfCodecs, static_cast<WebRtc_UWord16>(fs),
+                               kTCPLargeJitter);
+    for (std::map<WebRtc_UWord8, bool>::iterator it = present.begin(); it != present.end();
+        it++)
+    {
+        NETEQTEST_Decoder *dec = createDecoder(ptypes[(*it).first], (*it).first);
+        if (dec)
+        {
+            dec->loadToNetEQ(neteq);
+            decoders.push_back(dec);
+        }
+    }
+    WebRtcNetEQ_SetAVTPlayout(neteq.instance(), 1); // enable DTMF playout
+
+    // Only RecIn and RecOut run between the packet arrivals and playout
+    // times, in the same order as in NetEqRTPplay.
+    size_t next = 0;
+    WebRtc_UWord32 simClock = packets[0].time();
+    WebRtc_UWord32 tailEnd = packets.back().time() + MAX_TAIL_MS;
+    WebRtc_UWord16 delay = 0;
+    int recOuts = 0;
+    result->delayMs.clear();
+    result->delayMs.reserve((tailEnd - simClock) / RECOUT_INTERVAL_MS + 1);
+
+    clock_t startTime = clock();
+    while (true)
+    {
+        while (next < packets.size() && packets[next].time() <= simClock)
+        {
+            NETEQTEST_RTPpacket rtp(packets[next]);
+            neteq.recIn(rtp);
+            next++;
+        }
+
+        if (simClock % RECOUT_INTERVAL_MS == 0)
+        {
+            neteq.recOut(outData);
+            WebRtcNetEQ_GetCurrentDelay(neteq.instance(), &delay);
+            result->delayMs.push_back(delay);
+            recOuts++;
+        }
+
+        // After the last packet, play out what is left in the buffer.
+        if (next >= packets.size()
+            && (delay <= RECOUT_INTERVAL_MS || simClock >= tailEnd))
+        {
+            break;
+        }
+        simClock += RECOUT_INTERVAL_MS - simClock % RECOUT_INTERVAL_MS;
+    }
+    clock_t endTime = clock();
+
+    WebRtcNetEQ_JitterStatistics jitterStats;
+    WebRtcNetEQ_GetJitterStatistics(neteq.instance(), &jitterStats);
+
+    result->audioMs = recOuts * RECOUT_INTERVAL_MS;
+    result->cpuMs = 1000.0 * (endTime - startTime) / CLOCKS_PER_SEC;
+    result->expandMs = jitterStats.interpolatedVoiceMs + jitterStats.interpolatedSilentMs;
+    result->accelerateMs = jitterStats.accelerateMs;
+    result->flushedMs = jitterStats.flushedMs;
+    result->lateLossMs = jitterStats.lateLossMs;
+
+    for (size_t i = 0; i < decoders.size(); i++)
+    {
+        delete decoders[i];
+    }
+
+    return(0);
+}
+
+
+double percentile(std::vector<WebRtc_UWord16> values, double p)
+{
+    if (values.empty())
+    {
+        return(0);
+    }
+    size_t ix = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + ix, values.end());
+    return(values[ix]);
+}
+
+
+void printResult(FILE *fp, const simResult & result, bool csv)
+{
+    double audioS = result.audioMs / 1000;
+    double cpuPerS = (audioS > 0) ? result.cpuMs / audioS : 0;
+    double realtime = (result.cpuMs > 0) ? result.audioMs / result.cpuMs : 0;
+    double pct = (result.audioMs > 0) ? 100.0 / result.audioMs : 0;
+
+    fprintf(fp, csv ? "%s,%s,%.2f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f,%.0f,%.0f,%.0f\n" :
+            "%-32s %-14s %8.2f %9.3f %9.1f %7.2f %7.2f %7.2f %7.2f %5.0f %5.0f %5.0f\n",
+            result.trace.c_str(), result.model.c_str(), audioS, cpuPerS, realtime,
+            result.expandMs * pct, result.accelerateMs * pct, result.flushedMs * pct,
+            result.lateLossMs * pct, percentile(result.delayMs, 0.50),
+            percentile(result.delayMs, 0.95), percentile(result.delayMs, 0.99));
+}
@@ -123,6 +123,50 @@ WebRtc_Word16 WebRtcG711_DecodeU(void *state,
                                  WebRtc_Word16 *decoded,
                                  WebRtc_Word16 *speechType);
 
+/****************************************************************************
+ * WebRtcG711_TranscodeAtoU(...)
+ *
+ * This function transcodes a packet G711 A-law frame to U-law with the
+ * tables of the G.711 specification, without decoding to linear speech.
+ *
+ * Input:
+ *      - encodedIn          : A-law encoded data
+ *      - len                : Bytes in encodedIn
+ *
+ * Output:
+ *      - encodedOut         : U-law encoded data. Can be the same vector as
+ *                             encodedIn.
+ *
+ * Return value              : >0 - Length (in bytes) of encodedOut
+ *                             -1 - Error
+ */
+
+WebRtc_Word16 WebRtcG711_TranscodeAtoU(WebRtc_Word16 *encodedIn,
+                                       WebRtc_Word16 len,
+                                       WebRtc_Word16 *encodedOut);
+
+/****************************************************************************
+ * WebRtcG711_TranscodeUtoA(...)
+ *
+ * This function transcodes a packet G711 U-law frame to A-law with the
+ * tables of the G.711 specification, without decoding to linear speech.
+ *
+ * Input:
+ *      - encodedIn          : U-law encoded data
+ *      - len                : Bytes in encodedIn
+ *
+ * Output:
+ *      - encodedOut         : A-law encoded data. Can be the same vector as
+ *                             encodedIn.
+ *
+ * Return value              : >0 - Length (in bytes) of encodedOut
+ *                             -1 - Error
+ */
+
+WebRtc_Word16 WebRtcG711_TranscodeUtoA(WebRtc_Word16 *encodedIn,
+                                       WebRtc_Word16 len,
+                                       WebRtc_Word16 *encodedOut);
+
 /**********************************************************************
 * WebRtcG711_Version(...)
 *
@@ -10,7 +10,14 @@ LOCAL_MODULE := libwebrtc_g711
 LOCAL_MODULE_TAGS := optional
 LOCAL_GENERATED_SOURCES :=
 LOCAL_SRC_FILES := g711_interface.c \
-    g711.c
+    g711.c \
+    g711_batch.c
+
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
+    g711_batch_neon.c.neon
+MY_ARCH_DEFS := '-DWEBRTC_ARCH_ARM_NEON'
+endif
 
 # Flags passed to both C and C++ files.
 MY_CFLAGS :=  
@@ -21,7 +28,7 @@ MY_DEFS := '-DNO_TCMALLOC' \
     '-DWEBRTC_LINUX' \
     '-DWEBRTC_ANDROID' \
     '-DANDROID' 
-LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS)
+LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS) $(MY_ARCH_DEFS)
 
 # Include paths placed before CFLAGS/CPPFLAGS
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../../../../.. \
@@ -18,6 +18,7 @@
  * -Removed unused include files
  * -Changed to use WebRtc types
  * -Added option to run encoder bitexact with ITU-T reference implementation
+ * -Added transcoding of whole vectors
  */
 
 /*! \file */
@@ -80,4 +81,22 @@ WebRtc_UWord8 ulaw_to_alaw(WebRtc_UWord8 ulaw)
     return ulaw_to_alaw_table[ulaw];
 }
 /*- End of function --------------------------------------------------------*/
+
+void alaw_to_ulaw_vector(const WebRtc_UWord8 *alaw, WebRtc_UWord8 *ulaw, int len)
+{
+    int i;
+
+    for (i = 0;  i < len;  i++)
+        ulaw[i] = alaw_to_ulaw_table[alaw[i]];
+}
+/*- End of function --------------------------------------------------------*/
+
+void ulaw_to_alaw_vector(const WebRtc_UWord8 *ulaw, WebRtc_UWord8 *alaw, int len)
+{
+    int i;
+
+    for (i = 0;  i < len;  i++)
+        alaw[i] = ulaw_to_alaw_table[ulaw[i]];
+}
+/*- End of function --------------------------------------------------------*/
 /*- End of file ------------------------------------------------------------*/
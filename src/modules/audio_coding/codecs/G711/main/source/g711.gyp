@@ -14,6 +14,9 @@
     {
       'target_name': 'G711',
       'type': '<(library)',
+      'dependencies': [
+        '../../../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
       'include_dirs': [
         '../interface',
       ],
@@ -27,6 +30,23 @@
         'g711_interface.c',
         'g711.c',
         'g711.h',
+        'g711_batch.c',
+        'g711_batch.h',
+      ],
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'g711_batch_sse2.c',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'g711_batch_neon.c',
+          ],
+        }],
       ],
     },
 
@@ -46,6 +66,22 @@
  #         ],
  #       }],
  #     ],
+    },
+    {
+      'target_name': 'g711_benchmark',
+      'type': 'executable',
+      'dependencies': [
+        'G711',
+        '../../../PCM16B/main/source/pcm16b.gyp:PCM16B',
+        '../../../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'include_dirs': [
+        '.',
+        '../../../../../../system_wrappers/interface',
+      ],
+      'sources': [
+        '../testG711/g711_benchmark.cc',
+      ],
     },
       ],
 }
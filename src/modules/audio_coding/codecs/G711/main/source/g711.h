@@ -374,6 +374,18 @@ WebRtc_UWord8 alaw_to_ulaw(WebRtc_UWord8 alaw);
 */
 WebRtc_UWord8 ulaw_to_alaw(WebRtc_UWord8 ulaw);
 
+/*! \brief Transcode a vector from A-law to u-law, using the procedure defined in G.711.
+    \param alaw The A-law samples to transcode.
+    \param ulaw The best matching u-law values. This may be the same buffer as alaw.
+    \param len The number of samples. */
+void alaw_to_ulaw_vector(const WebRtc_UWord8 *alaw, WebRtc_UWord8 *ulaw, int len);
+
+/*! \brief Transcode a vector from u-law to A-law, using the procedure defined in G.711.
+    \param ulaw The u-law samples to transcode.
+    \param alaw The best matching A-law values. This may be the same buffer as ulaw.
+    \param len The number of samples. */
+void ulaw_to_alaw_vector(const WebRtc_UWord8 *ulaw, WebRtc_UWord8 *alaw, int len);
+
 #ifdef __cplusplus
 }
 #endif
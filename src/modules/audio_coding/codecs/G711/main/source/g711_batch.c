@@ -0,0 +1,212 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Table driven C versions of the batch G.711 functions, and the function
+ * pointers selected by WebRtcG711_InitBatch(). The description header can be
+ * found in g711_batch.h
+ */
+
+#include "g711_batch.h"
+
+#include "g711.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
+
+// Decoded values of all A-law and u-law codes, as given by alaw_to_linear()
+// and ulaw_to_linear().
+static const WebRtc_Word16 kAlawToLinear[256] = {
+  -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736,
+  -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784,
+  -2752, -2624, -3008, -2880, -2240, -2112, -2496, -2368,
+  -3776, -3648, -4032, -3904, -3264, -3136, -3520, -3392,
+  -22016, -20992, -24064, -23040, -17920, -16896, -19968, -18944,
+  -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136,
+  -11008, -10496, -12032, -11520, -8960, -8448, -9984, -9472,
+  -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568,
+  -344, -328, -376, -360, -280, -264, -312, -296,
+  -472, -456, -504, -488, -408, -392, -440, -424,
+  -88, -72, -120, -104, -24, -8, -56, -40,
+  -216, -200, -248, -232, -152, -136, -184, -168,
+  -1376, -1312, -1504, -1440, -1120, -1056, -1248, -1184,
+  -1888, -1824, -2016, -1952, -1632, -1568, -1760, -1696,
+  -688, -656, -752, -720, -560, -528, -624, -592,
+  -944, -912, -1008, -976, -816, -784, -880, -848,
+  5504, 5248, 6016, 5760, 4480, 4224, 4992, 4736,
+  7552, 7296, 8064, 7808, 6528, 6272, 7040, 6784,
+  2752, 2624, 3008, 2880, 2240, 2112, 2496, 2368,
+  3776, 3648, 4032, 3904, 3264, 3136, 3520, 3392,
+  22016, 20992, 24064, 23040, 17920, 16896, 19968, 18944,
+  30208, 29184, 32256, 31232, 26112, 25088, 28160, 27136,
+  11008, 10496, 12032, 11520, 8960, 8448, 9984, 9472,
+  15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568,
+  344, 328, 376, 360, 280, 264, 312, 296,
+  472, 456, 504, 488, 408, 392, 440, 424,
+  88, 72, 120, 104, 24, 8, 56, 40,
+  216, 200, 248, 232, 152, 136, 184, 168,
+  1376, 1312, 1504, 1440, 1120, 1056, 1248, 1184,
+  1888, 1824, 2016, 1952, 1632, 1568, 1760, 1696,
+  688, 656, 752, 720, 560, 528, 624, 592,
+  944, 912, 1008, 976, 816, 784, 880, 848,
+};
+
+static const WebRtc_Word16 kUlawToLinear[256] = {
+  -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956,
+  -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764,
+  -15996, -15484, -14972, -14460, -13948, -13436, -12924, -12412,
+  -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316,
+  -7932, -7676, -7420, -7164, -6908, -6652, -6396, -6140,
+  -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092,
+  -3900, -3772, -3644, -3516, -3388, -3260, -3132, -3004,
+  -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980,
+  -1884, -1820, -1756, -1692, -1628, -1564, -1500, -1436,
+  -1372, -1308, -1244, -1180, -1116, -1052, -988, -924,
+  -876, -844, -812, -780, -748, -716, -684, -652,
+  -620, -588, -556, -524, -492, -460, -428, -396,
+  -372, -356, -340, -324, -308, -292, -276, -260,
+  -244, -228, -212, -196, -180, -164, -148, -132,
+  -120, -112, -104, -96, -88, -80, -72, -64,
+  -56, -48, -40, -32, -24, -16, -8, 0,
+  32124, 31100, 30076, 29052, 28028, 27004, 25980, 24956,
+  23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764,
+  15996, 15484, 14972, 14460, 13948, 13436, 12924, 12412,
+  11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316,
+  7932, 7676, 7420, 7164, 6908, 6652, 6396, 6140,
+  5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092,
+  3900, 3772, 3644, 3516, 3388, 3260, 3132, 3004,
+  2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980,
+  1884, 1820, 1756, 1692, 1628, 1564, 1500, 1436,
+  1372, 1308, 1244, 1180, 1116, 1052, 988, 924,
+  876, 844, 812, 780, 748, 716, 684, 652,
+  620, 588, 556, 524, 492, 460, 428, 396,
+  372, 356, 340, 324, 308, 292, 276, 260,
+  244, 228, 212, 196, 180, 164, 148, 132,
+  120, 112, 104, 96, 88, 80, 72, 64,
+  56, 48, 40, 32, 24, 16, 8, 0,
+};
+
+// Segment of a magnitude, indexed by the magnitude >> 8. This is
+// top_bit(magnitude | 0xFF) - 7 without the bit search, which is slow on
+// processors where g711.h has no assembly version of it.
+static const WebRtc_UWord8 kSegment[129] = {
+  0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4,
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+  8,
+};
+
+void WebRtcG711_EncodeABatchC(const WebRtc_Word16* speech,
+                              int length,
+                              WebRtc_UWord8* encoded) {
+  int i;
+  for (i = 0; i < length; i++) {
+    // |sign| is -1 for negative samples, for which |linear| becomes -x - 1.
+    const int sign = speech[i] >> 15;
+    const int linear = speech[i] ^ sign;
+    const int seg = kSegment[linear >> 8];
+    const int shift = seg ? seg + 3 : 4;
+    const int mask = (ALAW_AMI_MASK | 0x80) ^ (sign & 0x80);
+    encoded[i] = (WebRtc_UWord8)(((seg << 4) | ((linear >> shift) & 0x0F)) ^
+                                 mask);
+  }
+}
+
+void WebRtcG711_EncodeUBatchC(const WebRtc_Word16* speech,
+                              int length,
+                              WebRtc_UWord8* encoded) {
+  int i;
+  for (i = 0; i < length; i++) {
+    const int sign = speech[i] >> 15;
+    const int linear = (speech[i] ^ sign) + ULAW_BIAS;
+    const int seg = kSegment[linear >> 8];
+    const int mask = 0xFF ^ (sign & 0x80);
+    // Only the largest magnitudes reach segment 8, which is clipped.
+    const int code = seg >= 8 ? 0x7F :
+        (seg << 4) | ((linear >> (seg + 3)) & 0x0F);
+    encoded[i] = (WebRtc_UWord8)(code ^ mask);
+  }
+}
+
+void WebRtcG711_DecodeABatchC(const WebRtc_UWord8* encoded,
+                              int length,
+                              WebRtc_Word16* speech) {
+  int i;
+  for (i = 0; i < length; i++) {
+    speech[i] = kAlawToLinear[encoded[i]];
+  }
+}
+
+void WebRtcG711_DecodeUBatchC(const WebRtc_UWord8* encoded,
+                              int length,
+                              WebRtc_Word16* speech) {
+  int i;
+  for (i = 0; i < length; i++) {
+    speech[i] = kUlawToLinear[encoded[i]];
+  }
+}
+
+// Until WebRtcG711_InitBatch() has run, the function pointers point to the
+// functions below, which run it and then make the call through the selected
+// version. Threads racing through the first calls all store the same values.
+
+static void EncodeABatchInit(const WebRtc_Word16* speech,
+                             int length,
+                             WebRtc_UWord8* encoded) {
+  WebRtcG711_InitBatch();
+  WebRtcG711_EncodeABatch(speech, length, encoded);
+}
+
+static void EncodeUBatchInit(const WebRtc_Word16* speech,
+                             int length,
+                             WebRtc_UWord8* encoded) {
+  WebRtcG711_InitBatch();
+  WebRtcG711_EncodeUBatch(speech, length, encoded);
+}
+
+static void DecodeABatchInit(const WebRtc_UWord8* encoded,
+                             int length,
+                             WebRtc_Word16* speech) {
+  WebRtcG711_InitBatch();
+  WebRtcG711_DecodeABatch(encoded, length, speech);
+}
+
+static void DecodeUBatchInit(const WebRtc_UWord8* encoded,
+                             int length,
+                             WebRtc_Word16* speech) {
+  WebRtcG711_InitBatch();
+  WebRtcG711_DecodeUBatch(encoded, length, speech);
+}
+
+WebRtcG711_EncodeBatch_t WebRtcG711_EncodeABatch = EncodeABatchInit;
+WebRtcG711_EncodeBatch_t WebRtcG711_EncodeUBatch = EncodeUBatchInit;
+WebRtcG711_DecodeBatch_t WebRtcG711_DecodeABatch = DecodeABatchInit;
+WebRtcG711_DecodeBatch_t WebRtcG711_DecodeUBatch = DecodeUBatchInit;
+
+void WebRtcG711_InitBatch(void) {
+  WebRtcG711_EncodeABatch = WebRtcG711_EncodeABatchC;
+  WebRtcG711_EncodeUBatch = WebRtcG711_EncodeUBatchC;
+  WebRtcG711_DecodeABatch = WebRtcG711_DecodeABatchC;
+  WebRtcG711_DecodeUBatch = WebRtcG711_DecodeUBatchC;
+
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+#if defined(__SSE2__)
+    WebRtcG711_InitBatchSSE2();
+#endif
+  }
+  if (WebRtc_GetCPUInfo(kNEON)) {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+    WebRtcG711_InitBatchNeon();
+#endif
+  }
+}
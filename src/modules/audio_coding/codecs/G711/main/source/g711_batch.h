@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Batch A-law and u-law encoders and decoders used by g711_interface.c. The
+ * encoded data is one byte per sample in packet order. All versions are bit
+ * exact with linear_to_alaw(), linear_to_ulaw(), alaw_to_linear() and
+ * ulaw_to_linear() in g711.h.
+ */
+
+#ifndef MODULES_AUDIO_CODING_CODECS_G711_MAIN_SOURCE_G711_BATCH_H_
+#define MODULES_AUDIO_CODING_CODECS_G711_MAIN_SOURCE_G711_BATCH_H_
+
+#include "typedefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*WebRtcG711_EncodeBatch_t)(const WebRtc_Word16* speech,
+                                         int length,
+                                         WebRtc_UWord8* encoded);
+typedef void (*WebRtcG711_DecodeBatch_t)(const WebRtc_UWord8* encoded,
+                                         int length,
+                                         WebRtc_Word16* speech);
+
+// Point to the C, SSE2 or NEON versions selected by WebRtcG711_InitBatch().
+// The selection is done automatically by the first call of any of them.
+extern WebRtcG711_EncodeBatch_t WebRtcG711_EncodeABatch;
+extern WebRtcG711_EncodeBatch_t WebRtcG711_EncodeUBatch;
+extern WebRtcG711_DecodeBatch_t WebRtcG711_DecodeABatch;
+extern WebRtcG711_DecodeBatch_t WebRtcG711_DecodeUBatch;
+
+// Table driven C versions. The SIMD versions use them for the last samples.
+void WebRtcG711_EncodeABatchC(const WebRtc_Word16* speech,
+                              int length,
+                              WebRtc_UWord8* encoded);
+void WebRtcG711_EncodeUBatchC(const WebRtc_Word16* speech,
+                              int length,
+                              WebRtc_UWord8* encoded);
+void WebRtcG711_DecodeABatchC(const WebRtc_UWord8* encoded,
+                              int length,
+                              WebRtc_Word16* speech);
+void WebRtcG711_DecodeUBatchC(const WebRtc_UWord8* encoded,
+                              int length,
+                              WebRtc_Word16* speech);
+
+// Selects the batch functions depending on WebRtc_GetCPUInfo(). Only needs to
+// be called to redo the selection, e.g. after changing WebRtc_GetCPUInfo in a
+// test.
+void WebRtcG711_InitBatch(void);
+void WebRtcG711_InitBatchSSE2(void);
+void WebRtcG711_InitBatchNeon(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MODULES_AUDIO_CODING_CODECS_G711_MAIN_SOURCE_G711_BATCH_H_
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * NEON versions of the batch G.711 functions selected in
+ * WebRtcG711_InitBatch(). The results are bit exact with the C versions.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+
+#include "g711.h"
+#include "g711_batch.h"
+
+// Returns top_bit(magnitude | 0xFF) - 7 of each magnitude.
+static __inline int16x8_t Segment(uint16x8_t magnitude) {
+  const uint16x8_t leading_zeros =
+      vclzq_u16(vorrq_u16(magnitude, vdupq_n_u16(0xFF)));
+  return vsubq_s16(vdupq_n_s16(8), vreinterpretq_s16_u16(leading_zeros));
+}
+
+// Encodes eight samples to A-law.
+static __inline uint8x8_t EncodeA8(int16x8_t x) {
+  const int16x8_t sign = vshrq_n_s16(x, 15);
+  const uint16x8_t linear = vreinterpretq_u16_s16(veorq_s16(x, sign));
+  const int16x8_t seg = Segment(linear);
+  // Segments 0 and 1 both take the quantization bits from linear >> 4.
+  const int16x8_t shift =
+      vaddq_s16(vmaxq_s16(seg, vdupq_n_s16(1)), vdupq_n_s16(3));
+  const uint16x8_t quant = vandq_u16(vshlq_u16(linear, vnegq_s16(shift)),
+                                     vdupq_n_u16(0x0F));
+  const uint16x8_t code =
+      vorrq_u16(vshlq_n_u16(vreinterpretq_u16_s16(seg), 4), quant);
+  const uint16x8_t mask = veorq_u16(
+      vdupq_n_u16(ALAW_AMI_MASK | 0x80),
+      vandq_u16(vreinterpretq_u16_s16(sign), vdupq_n_u16(0x80)));
+  return vmovn_u16(veorq_u16(code, mask));
+}
+
+// Encodes eight samples to u-law.
+static __inline uint8x8_t EncodeU8(int16x8_t x) {
+  const int16x8_t sign = vshrq_n_s16(x, 15);
+  // Up to 0x8083, so the magnitude is unsigned.
+  const uint16x8_t linear = vaddq_u16(vreinterpretq_u16_s16(veorq_s16(x, sign)),
+                                      vdupq_n_u16(ULAW_BIAS));
+  const int16x8_t seg = Segment(linear);
+  const uint16x8_t quant = vandq_u16(
+      vshlq_u16(linear, vnegq_s16(vaddq_s16(seg, vdupq_n_s16(3)))),
+      vdupq_n_u16(0x0F));
+  // Segment 8 gives at least 0x80 here, which is clipped to 0x7F.
+  const uint16x8_t code = vminq_u16(
+      vorrq_u16(vshlq_n_u16(vreinterpretq_u16_s16(seg), 4), quant),
+      vdupq_n_u16(0x7F));
+  const uint16x8_t mask = veorq_u16(
+      vdupq_n_u16(0xFF),
+      vandq_u16(vreinterpretq_u16_s16(sign), vdupq_n_u16(0x80)));
+  return vmovn_u16(veorq_u16(code, mask));
+}
+
+// Decodes eight A-law codes.
+static __inline int16x8_t DecodeA8(uint8x8_t alaw) {
+  const uint16x8_t a =
+      vmovl_u8(veor_u8(alaw, vdup_n_u8(ALAW_AMI_MASK)));
+  const uint16x8_t seg = vandq_u16(vshrq_n_u16(a, 4), vdupq_n_u16(7));
+  // (i + 0x108) << (seg - 1) for segments above 0, else i + 8.
+  const uint16x8_t base = vaddq_u16(
+      vaddq_u16(vshlq_n_u16(vandq_u16(a, vdupq_n_u16(0x0F)), 4),
+                vdupq_n_u16(8)),
+      vandq_u16(vtstq_u16(seg, seg), vdupq_n_u16(0x100)));
+  const int16x8_t value = vreinterpretq_s16_u16(vshlq_u16(
+      base, vreinterpretq_s16_u16(vqsubq_u16(seg, vdupq_n_u16(1)))));
+  return vbslq_s16(vtstq_u16(a, vdupq_n_u16(0x80)), value, vnegq_s16(value));
+}
+
+// Decodes eight u-law codes.
+static __inline int16x8_t DecodeU8(uint8x8_t ulaw) {
+  const uint16x8_t u = vmovl_u8(vmvn_u8(ulaw));
+  const uint16x8_t seg = vandq_u16(vshrq_n_u16(u, 4), vdupq_n_u16(7));
+  const uint16x8_t base = vaddq_u16(
+      vshlq_n_u16(vandq_u16(u, vdupq_n_u16(0x0F)), 3),
+      vdupq_n_u16(ULAW_BIAS));
+  const int16x8_t value = vsubq_s16(
+      vreinterpretq_s16_u16(vshlq_u16(base, vreinterpretq_s16_u16(seg))),
+      vdupq_n_s16(ULAW_BIAS));
+  return vbslq_s16(vtstq_u16(u, vdupq_n_u16(0x80)), vnegq_s16(value), value);
+}
+
+static void EncodeABatch(const WebRtc_Word16* speech,
+                         int length,
+                         WebRtc_UWord8* encoded) {
+  int i = 0;
+  for (; i + 16 <= length; i += 16) {
+    vst1q_u8(&encoded[i], vcombine_u8(EncodeA8(vld1q_s16(&speech[i])),
+                                      EncodeA8(vld1q_s16(&speech[i + 8]))));
+  }
+  WebRtcG711_EncodeABatchC(&speech[i], length - i, &encoded[i]);
+}
+
+static void EncodeUBatch(const WebRtc_Word16* speech,
+                         int length,
+                         WebRtc_UWord8* encoded) {
+  int i = 0;
+  for (; i + 16 <= length; i += 16) {
+    vst1q_u8(&encoded[i], vcombine_u8(EncodeU8(vld1q_s16(&speech[i])),
+                                      EncodeU8(vld1q_s16(&speech[i + 8]))));
+  }
+  WebRtcG711_EncodeUBatchC(&speech[i], length - i, &encoded[i]);
+}
+
+static void DecodeABatch(const WebRtc_UWord8* encoded,
+                         int length,
+                         WebRtc_Word16* speech) {
+  int i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t codes = vld1q_u8(&encoded[i]);
+    vst1q_s16(&speech[i], DecodeA8(vget_low_u8(codes)));
+    vst1q_s16(&speech[i + 8], DecodeA8(vget_high_u8(codes)));
+  }
+  WebRtcG711_DecodeABatchC(&encoded[i], length - i, &speech[i]);
+}
+
+static void DecodeUBatch(const WebRtc_UWord8* encoded,
+                         int length,
+                         WebRtc_Word16* speech) {
+  int i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t codes = vld1q_u8(&encoded[i]);
+    vst1q_s16(&speech[i], DecodeU8(vget_low_u8(codes)));
+    vst1q_s16(&speech[i + 8], DecodeU8(vget_high_u8(codes)));
+  }
+  WebRtcG711_DecodeUBatchC(&encoded[i], length - i, &speech[i]);
+}
+
+void WebRtcG711_InitBatchNeon(void) {
+  WebRtcG711_EncodeABatch = EncodeABatch;
+  WebRtcG711_EncodeUBatch = EncodeUBatch;
+  WebRtcG711_DecodeABatch = DecodeABatch;
+  WebRtcG711_DecodeUBatch = DecodeUBatch;
+}
+#endif  // WEBRTC_ARCH_ARM_NEON
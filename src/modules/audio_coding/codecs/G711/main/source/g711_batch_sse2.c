@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * SSE2 versions of the batch G.711 functions selected in
+ * WebRtcG711_InitBatch(). The results are bit exact with the C versions.
+ * SSE2 has no per lane shifts or bit search, so the encoders find the segment
+ * through a conversion to float and the decoders shift by the segment through
+ * a multiplication by a power of two.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#include "g711.h"
+#include "g711_batch.h"
+
+// Returns (seg << 4) | quant of each 16 bit magnitude in |magnitude|, where
+// seg is top_bit(magnitude) - 7 and quant the four bits below the top bit.
+// These are the exponent and the top mantissa bits of the magnitude as a
+// float. Magnitudes below 256 give meaningless codes.
+static __inline __m128i SegmentAndQuant(__m128i magnitude) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i offset = _mm_set1_epi32((127 + 7) << 4);
+  const __m128i low = _mm_castps_si128(
+      _mm_cvtepi32_ps(_mm_unpacklo_epi16(magnitude, zero)));
+  const __m128i high = _mm_castps_si128(
+      _mm_cvtepi32_ps(_mm_unpackhi_epi16(magnitude, zero)));
+  return _mm_packs_epi32(_mm_sub_epi32(_mm_srli_epi32(low, 19), offset),
+                         _mm_sub_epi32(_mm_srli_epi32(high, 19), offset));
+}
+
+// Returns 1 << |shift| for shifts from 0 to 7.
+static __inline __m128i PowerOfTwo(__m128i shift) {
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i two = _mm_set1_epi16(2);
+  const __m128i four = _mm_set1_epi16(4);
+  __m128i mask = _mm_cmpeq_epi16(_mm_and_si128(shift, one), one);
+  __m128i power = _mm_sub_epi16(one, mask);
+  mask = _mm_cmpeq_epi16(_mm_and_si128(shift, two), two);
+  power = _mm_or_si128(_mm_andnot_si128(mask, power),
+                       _mm_and_si128(mask, _mm_slli_epi16(power, 2)));
+  mask = _mm_cmpeq_epi16(_mm_and_si128(shift, four), four);
+  power = _mm_or_si128(_mm_andnot_si128(mask, power),
+                       _mm_and_si128(mask, _mm_slli_epi16(power, 4)));
+  return power;
+}
+
+// Encodes eight samples to A-law, one code in the low byte of each lane.
+static __inline __m128i EncodeA8(__m128i x) {
+  const __m128i sign = _mm_srai_epi16(x, 15);
+  const __m128i linear = _mm_xor_si128(x, sign);
+  // Segment 0 takes the quantization bits from linear >> 4, which is also the
+  // code.
+  const __m128i segment_zero = _mm_cmplt_epi16(linear, _mm_set1_epi16(256));
+  const __m128i code = _mm_or_si128(
+      _mm_and_si128(segment_zero, _mm_srli_epi16(linear, 4)),
+      _mm_andnot_si128(segment_zero, SegmentAndQuant(linear)));
+  const __m128i mask = _mm_xor_si128(
+      _mm_set1_epi16(ALAW_AMI_MASK | 0x80),
+      _mm_and_si128(sign, _mm_set1_epi16(0x80)));
+  return _mm_xor_si128(code, mask);
+}
+
+// Encodes eight samples to u-law, one code in the low byte of each lane.
+static __inline __m128i EncodeU8(__m128i x) {
+  const __m128i sign = _mm_srai_epi16(x, 15);
+  // At least 0x84, so always in segment 0 or above, and up to 0x8083, where
+  // segment 8 gives codes from 0x80 which are clipped to 0x7F.
+  const __m128i linear = _mm_add_epi16(_mm_xor_si128(x, sign),
+                                       _mm_set1_epi16(ULAW_BIAS));
+  const __m128i code = _mm_min_epi16(SegmentAndQuant(linear),
+                                     _mm_set1_epi16(0x7F));
+  const __m128i mask = _mm_xor_si128(
+      _mm_set1_epi16(0xFF), _mm_and_si128(sign, _mm_set1_epi16(0x80)));
+  return _mm_xor_si128(code, mask);
+}
+
+// Decodes eight A-law codes held in the low bytes of the lanes.
+static __inline __m128i DecodeA8(__m128i alaw) {
+  const __m128i a = _mm_xor_si128(alaw, _mm_set1_epi16(ALAW_AMI_MASK));
+  const __m128i seg = _mm_and_si128(_mm_srli_epi16(a, 4), _mm_set1_epi16(7));
+  const __m128i nonzero_seg = _mm_cmpgt_epi16(seg, _mm_setzero_si128());
+  // (i + 0x108) << (seg - 1) for segments above 0, else i + 8.
+  const __m128i base = _mm_add_epi16(
+      _mm_add_epi16(_mm_slli_epi16(_mm_and_si128(a, _mm_set1_epi16(0x0F)), 4),
+                    _mm_set1_epi16(8)),
+      _mm_and_si128(nonzero_seg, _mm_set1_epi16(0x100)));
+  const __m128i value = _mm_mullo_epi16(
+      base, PowerOfTwo(_mm_subs_epu16(seg, _mm_set1_epi16(1))));
+  const __m128i negative = _mm_cmpeq_epi16(
+      _mm_and_si128(a, _mm_set1_epi16(0x80)), _mm_setzero_si128());
+  return _mm_sub_epi16(_mm_xor_si128(value, negative), negative);
+}
+
+// Decodes eight u-law codes held in the low bytes of the lanes.
+static __inline __m128i DecodeU8(__m128i ulaw) {
+  const __m128i u = _mm_xor_si128(ulaw, _mm_set1_epi16(0xFF));
+  const __m128i seg = _mm_and_si128(_mm_srli_epi16(u, 4), _mm_set1_epi16(7));
+  const __m128i base = _mm_add_epi16(
+      _mm_slli_epi16(_mm_and_si128(u, _mm_set1_epi16(0x0F)), 3),
+      _mm_set1_epi16(ULAW_BIAS));
+  const __m128i value = _mm_sub_epi16(_mm_mullo_epi16(base, PowerOfTwo(seg)),
+                                      _mm_set1_epi16(ULAW_BIAS));
+  const __m128i negative = _mm_cmpeq_epi16(
+      _mm_and_si128(u, _mm_set1_epi16(0x80)), _mm_set1_epi16(0x80));
+  return _mm_sub_epi16(_mm_xor_si128(value, negative), negative);
+}
+
+static void EncodeABatch(const WebRtc_Word16* speech,
+                         int length,
+                         WebRtc_UWord8* encoded) {
+  int i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i low = EncodeA8(_mm_loadu_si128((const __m128i*)&speech[i]));
+    const __m128i high =
+        EncodeA8(_mm_loadu_si128((const __m128i*)&speech[i + 8]));
+    _mm_storeu_si128((__m128i*)&encoded[i], _mm_packus_epi16(low, high));
+  }
+  WebRtcG711_EncodeABatchC(&speech[i], length - i, &encoded[i]);
+}
+
+static void EncodeUBatch(const WebRtc_Word16* speech,
+                         int length,
+                         WebRtc_UWord8* encoded) {
+  int i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i low = EncodeU8(_mm_loadu_si128((const __m128i*)&speech[i]));
+    const __m128i high =
+        EncodeU8(_mm_loadu_si128((const __m128i*)&speech[i + 8]));
+    _mm_storeu_si128((__m128i*)&encoded[i], _mm_packus_epi16(low, high));
+  }
+  WebRtcG711_EncodeUBatchC(&speech[i], length - i, &encoded[i]);
+}
+
+static void DecodeABatch(const WebRtc_UWord8* encoded,
+                         int length,
+                         WebRtc_Word16* speech) {
+  const __m128i zero = _mm_setzero_si128();
+  int i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i codes = _mm_loadu_si128((const __m128i*)&encoded[i]);
+    _mm_storeu_si128((__m128i*)&speech[i],
+                     DecodeA8(_mm_unpacklo_epi8(codes, zero)));
+    _mm_storeu_si128((__m128i*)&speech[i + 8],
+                     DecodeA8(_mm_unpackhi_epi8(codes, zero)));
+  }
+  WebRtcG711_DecodeABatchC(&encoded[i], length - i, &speech[i]);
+}
+
+static void DecodeUBatch(const WebRtc_UWord8* encoded,
+                         int length,
+                         WebRtc_Word16* speech) {
+  const __m128i zero = _mm_setzero_si128();
+  int i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i codes = _mm_loadu_si128((const __m128i*)&encoded[i]);
+    _mm_storeu_si128((__m128i*)&speech[i],
+                     DecodeU8(_mm_unpacklo_epi8(codes, zero)));
+    _mm_storeu_si128((__m128i*)&speech[i + 8],
+                     DecodeU8(_mm_unpackhi_epi8(codes, zero)));
+  }
+  WebRtcG711_DecodeUBatchC(&encoded[i], length - i, &speech[i]);
+}
+
+void WebRtcG711_InitBatchSSE2(void) {
+  WebRtcG711_EncodeABatch = EncodeABatch;
+  WebRtcG711_EncodeUBatch = EncodeUBatch;
+  WebRtcG711_DecodeABatch = DecodeABatch;
+  WebRtcG711_DecodeUBatch = DecodeUBatch;
+}
+#endif  // __SSE2__
@@ -9,6 +9,7 @@
  */
 #include <string.h>
 #include "g711.h"
+#include "g711_batch.h"
 #include "g711_interface.h"
 #include "typedefs.h"
 
@@ -17,9 +18,6 @@ WebRtc_Word16 WebRtcG711_EncodeA(void *state,
                                  WebRtc_Word16 len,
                                  WebRtc_Word16 *encoded)
 {
-    int n;
-    WebRtc_UWord16 tempVal,  tempVal2;
-
     // Set to avoid getting warnings
     state = state;
 
@@ -28,25 +26,11 @@ WebRtc_Word16 WebRtcG711_EncodeA(void *state,
         return (-1);
     }
 
-    // Loop over all samples
-    for (n = 0; n < len; n++) {
-        tempVal = (WebRtc_UWord16)linear_to_alaw(speechIn[n]);
-
-#ifdef WEBRTC_BIG_ENDIAN
-        if ((n & 0x1) == 1) {
-            encoded[n>>1]|=((WebRtc_UWord16)tempVal);
-        } else {
-            encoded[n>>1]=((WebRtc_UWord16)tempVal)<<8;
-        }
-#else
-        if ((n & 0x1) == 1) {
-            tempVal2 |= ((WebRtc_UWord16) tempVal) << 8;
-            encoded[n >> 1] |= ((WebRtc_UWord16) tempVal) << 8;
-        } else {
-            tempVal2 = ((WebRtc_UWord16) tempVal);
-            encoded[n >> 1] = ((WebRtc_UWord16) tempVal);
-        }
-#endif
+    // Sample n is byte n of the encoded vector, on both little and big endian
+    // hosts. The unused byte after an odd number of samples is cleared.
+    WebRtcG711_EncodeABatch(speechIn, len, (WebRtc_UWord8*) encoded);
+    if (len & 0x1) {
+        ((WebRtc_UWord8*) encoded)[len] = 0;
     }
     return (len);
 }
@@ -56,9 +40,6 @@ WebRtc_Word16 WebRtcG711_EncodeU(void *state,
                                  WebRtc_Word16 len,
                                  WebRtc_Word16 *encoded)
 {
-    int n;
-    WebRtc_UWord16 tempVal;
-
     // Set to avoid getting warnings
     state = state;
 
@@ -67,23 +48,11 @@ WebRtc_Word16 WebRtcG711_EncodeU(void *state,
         return (-1);
     }
 
-    // Loop over all samples
-    for (n = 0; n < len; n++) {
-        tempVal = (WebRtc_UWord16)linear_to_ulaw(speechIn[n]);
-
- #ifdef WEBRTC_BIG_ENDIAN
-        if ((n & 0x1) == 1) {
-            encoded[n>>1]|=((WebRtc_UWord16)tempVal);
-        } else {
-            encoded[n>>1]=((WebRtc_UWord16)tempVal)<<8;
-        }
- #else
-        if ((n & 0x1) == 1) {
-            encoded[n >> 1] |= ((WebRtc_UWord16) tempVal) << 8;
-        } else {
-            encoded[n >> 1] = ((WebRtc_UWord16) tempVal);
-        }
- #endif
+    // Sample n is byte n of the encoded vector, on both little and big endian
+    // hosts. The unused byte after an odd number of samples is cleared.
+    WebRtcG711_EncodeUBatch(speechIn, len, (WebRtc_UWord8*) encoded);
+    if (len & 0x1) {
+        ((WebRtc_UWord8*) encoded)[len] = 0;
     }
     return (len);
 }
@@ -94,9 +63,6 @@ WebRtc_Word16 WebRtcG711_DecodeA(void *state,
                                  WebRtc_Word16 *decoded,
                                  WebRtc_Word16 *speechType)
 {
-    int n;
-    WebRtc_UWord16 tempVal;
-
     // Set to avoid getting warnings
     state = state;
 
@@ -105,22 +71,7 @@ WebRtc_Word16 WebRtcG711_DecodeA(void *state,
         return (-1);
     }
 
-    for (n = 0; n < len; n++) {
- #ifdef WEBRTC_BIG_ENDIAN
-        if ((n & 0x1) == 1) {
-            tempVal=((WebRtc_UWord16)encoded[n>>1] & 0xFF);
-        } else {
-            tempVal=((WebRtc_UWord16)encoded[n>>1] >> 8);
-        }
- #else
-        if ((n & 0x1) == 1) {
-            tempVal = (encoded[n >> 1] >> 8);
-        } else {
-            tempVal = (encoded[n >> 1] & 0xFF);
-        }
- #endif
-        decoded[n] = (WebRtc_Word16) alaw_to_linear(tempVal);
-    }
+    WebRtcG711_DecodeABatch((const WebRtc_UWord8*) encoded, len, decoded);
 
     *speechType = 1;
     return (len);
@@ -132,9 +83,6 @@ WebRtc_Word16 WebRtcG711_DecodeU(void *state,
                                  WebRtc_Word16 *decoded,
                                  WebRtc_Word16 *speechType)
 {
-    int n;
-    WebRtc_UWord16 tempVal;
-
     // Set to avoid getting warnings
     state = state;
 
@@ -143,27 +91,40 @@ WebRtc_Word16 WebRtcG711_DecodeU(void *state,
         return (-1);
     }
 
-    for (n = 0; n < len; n++) {
- #ifdef WEBRTC_BIG_ENDIAN
-        if ((n & 0x1) == 1) {
-            tempVal=((WebRtc_UWord16)encoded[n>>1] & 0xFF);
-        } else {
-            tempVal=((WebRtc_UWord16)encoded[n>>1] >> 8);
-        }
- #else
-        if ((n & 0x1) == 1) {
-            tempVal = (encoded[n >> 1] >> 8);
-        } else {
-            tempVal = (encoded[n >> 1] & 0xFF);
-        }
- #endif
-        decoded[n] = (WebRtc_Word16) ulaw_to_linear(tempVal);
-    }
+    WebRtcG711_DecodeUBatch((const WebRtc_UWord8*) encoded, len, decoded);
 
     *speechType = 1;
     return (len);
 }
 
+WebRtc_Word16 WebRtcG711_TranscodeAtoU(WebRtc_Word16 *encodedIn,
+                                       WebRtc_Word16 len,
+                                       WebRtc_Word16 *encodedOut)
+{
+    // Sanity check of input length
+    if (len < 0) {
+        return (-1);
+    }
+
+    alaw_to_ulaw_vector((const WebRtc_UWord8*) encodedIn,
+                        (WebRtc_UWord8*) encodedOut, len);
+    return (len);
+}
+
+WebRtc_Word16 WebRtcG711_TranscodeUtoA(WebRtc_Word16 *encodedIn,
+                                       WebRtc_Word16 len,
+                                       WebRtc_Word16 *encodedOut)
+{
+    // Sanity check of input length
+    if (len < 0) {
+        return (-1);
+    }
+
+    ulaw_to_alaw_vector((const WebRtc_UWord8*) encodedIn,
+                        (WebRtc_UWord8*) encodedOut, len);
+    return (len);
+}
+
 WebRtc_Word16 WebRtcG711_Version(char* version, WebRtc_Word16 lenBytes)
 {
     strncpy(version, "2.0.0", lenBytes);
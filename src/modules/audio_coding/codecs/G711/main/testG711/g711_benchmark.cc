@@ -0,0 +1,212 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the throughput in samples/s of the G.711 and PCM16B conversions in
+// 20 ms packets: the per sample g711.h functions, the table driven C batch
+// functions and the batch functions selected for this CPU, and the direct
+// u-law <-> A-law transcoding against a round trip through linear speech.
+// The batch outputs are checked against the per sample functions. Without a
+// file, the input is every 16 bit value, i.e. all codes are checked.
+//
+// Usage: g711_benchmark [pcm file] [repetitions]
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "g711.h"
+#include "g711_batch.h"
+#include "g711_interface.h"
+#include "pcm16b.h"
+#include "tick_util.h"
+
+namespace {
+const int kPacketSize = 160;
+
+bool ReadFile(const char* filename, std::vector<WebRtc_Word16>* data) {
+  FILE* file = fopen(filename, "rb");
+  if (file == NULL) {
+    printf("Unable to open %s\n", filename);
+    return false;
+  }
+  WebRtc_Word16 buffer[1024];
+  size_t read = 0;
+  while ((read = fread(buffer, sizeof(WebRtc_Word16), 1024, file)) > 0) {
+    data->insert(data->end(), buffer, buffer + read);
+  }
+  fclose(file);
+  return true;
+}
+
+void EncodeAPerSample(const WebRtc_Word16* speech, int length,
+                      WebRtc_UWord8* encoded) {
+  for (int i = 0; i < length; i++) {
+    encoded[i] = linear_to_alaw(speech[i]);
+  }
+}
+
+void EncodeUPerSample(const WebRtc_Word16* speech, int length,
+                      WebRtc_UWord8* encoded) {
+  for (int i = 0; i < length; i++) {
+    encoded[i] = linear_to_ulaw(speech[i]);
+  }
+}
+
+void DecodeAPerSample(const WebRtc_UWord8* encoded, int length,
+                      WebRtc_Word16* speech) {
+  for (int i = 0; i < length; i++) {
+    speech[i] = alaw_to_linear(encoded[i]);
+  }
+}
+
+void DecodeUPerSample(const WebRtc_UWord8* encoded, int length,
+                      WebRtc_Word16* speech) {
+  for (int i = 0; i < length; i++) {
+    speech[i] = ulaw_to_linear(encoded[i]);
+  }
+}
+
+void UtoARoundTrip(const WebRtc_UWord8* in, int length, WebRtc_UWord8* out) {
+  WebRtc_Word16 speech[kPacketSize];
+  WebRtcG711_DecodeUBatch(in, length, speech);
+  WebRtcG711_EncodeABatch(speech, length, out);
+}
+
+void AtoURoundTrip(const WebRtc_UWord8* in, int length, WebRtc_UWord8* out) {
+  WebRtc_Word16 speech[kPacketSize];
+  WebRtcG711_DecodeABatch(in, length, speech);
+  WebRtcG711_EncodeUBatch(speech, length, out);
+}
+
+void UtoADirect(const WebRtc_UWord8* in, int length, WebRtc_UWord8* out) {
+  WebRtcG711_TranscodeUtoA((WebRtc_Word16*)in, length, (WebRtc_Word16*)out);
+}
+
+void AtoUDirect(const WebRtc_UWord8* in, int length, WebRtc_UWord8* out) {
+  WebRtcG711_TranscodeAtoU((WebRtc_Word16*)in, length, (WebRtc_Word16*)out);
+}
+
+void SwapPerSample(const WebRtc_Word16* in, int length, WebRtc_Word16* out) {
+  for (int i = 0; i < length; i++) {
+    const WebRtc_UWord16 value = static_cast<WebRtc_UWord16>(in[i]);
+    out[i] = static_cast<WebRtc_Word16>((value >> 8) | (value << 8));
+  }
+}
+
+void Pcm16bEncode(const WebRtc_Word16* in, int length, WebRtc_Word16* out) {
+  WebRtcPcm16b_EncodeW16(const_cast<WebRtc_Word16*>(in), length, out);
+}
+
+// Runs |function| over |in| in packets, |repetitions| times, and prints the
+// throughput. If |reference| is given, |out| is compared to it.
+template <typename In, typename Out>
+void Run(const char* name, void (*function)(const In*, int, Out*),
+         const std::vector<In>& in, int repetitions, std::vector<Out>* out,
+         const std::vector<Out>* reference) {
+  const int num_packets = static_cast<int>(in.size()) / kPacketSize;
+  out->assign(in.size(), 0);
+
+  const webrtc::TickTime start = webrtc::TickTime::Now();
+  for (int r = 0; r < repetitions; r++) {
+    for (int i = 0; i < num_packets; i++) {
+      function(&in[i * kPacketSize], kPacketSize, &(*out)[i * kPacketSize]);
+    }
+  }
+  const WebRtc_Word64 elapsed_us =
+      (webrtc::TickTime::Now() - start).Microseconds();
+
+  const double samples =
+      static_cast<double>(repetitions) * num_packets * kPacketSize;
+  printf("%-22s %8.1f Msamples/s", name,
+         elapsed_us > 0 ? samples / elapsed_us : 0.0);
+  if (reference != NULL) {
+    int mismatches = 0;
+    for (size_t i = 0; i < out->size(); i++) {
+      mismatches += (*out)[i] != (*reference)[i];
+    }
+    printf(", %d mismatches", mismatches);
+  }
+  printf("\n");
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<WebRtc_Word16> speech;
+  if (argc > 1) {
+    if (!ReadFile(argv[1], &speech)) {
+      return 1;
+    }
+  } else {
+    for (int i = -32768; i < 32768; i++) {
+      speech.push_back(static_cast<WebRtc_Word16>(i));
+    }
+  }
+  speech.resize(speech.size() / kPacketSize * kPacketSize);
+  if (speech.empty()) {
+    printf("Too short input\n");
+    return 1;
+  }
+  const int repetitions = argc > 2 ? atoi(argv[2]) : 200;
+  if (repetitions < 1) {
+    printf("Invalid number of repetitions\n");
+    return 1;
+  }
+  WebRtcG711_InitBatch();
+
+  std::vector<WebRtc_UWord8> alaw;
+  std::vector<WebRtc_UWord8> ulaw;
+  std::vector<WebRtc_UWord8> encoded;
+  std::vector<WebRtc_Word16> reference;
+  std::vector<WebRtc_Word16> decoded;
+  std::vector<WebRtc_UWord8> transcoded;
+
+  Run("A-law encode per sample", EncodeAPerSample, speech, repetitions, &alaw,
+      static_cast<std::vector<WebRtc_UWord8>*>(NULL));
+  Run("A-law encode table", WebRtcG711_EncodeABatchC, speech, repetitions,
+      &encoded, &alaw);
+  Run("A-law encode selected", WebRtcG711_EncodeABatch, speech, repetitions,
+      &encoded, &alaw);
+  Run("u-law encode per sample", EncodeUPerSample, speech, repetitions, &ulaw,
+      static_cast<std::vector<WebRtc_UWord8>*>(NULL));
+  Run("u-law encode table", WebRtcG711_EncodeUBatchC, speech, repetitions,
+      &encoded, &ulaw);
+  Run("u-law encode selected", WebRtcG711_EncodeUBatch, speech, repetitions,
+      &encoded, &ulaw);
+
+  Run("A-law decode per sample", DecodeAPerSample, alaw, repetitions,
+      &reference, static_cast<std::vector<WebRtc_Word16>*>(NULL));
+  Run("A-law decode table", WebRtcG711_DecodeABatchC, alaw, repetitions,
+      &decoded, &reference);
+  Run("A-law decode selected", WebRtcG711_DecodeABatch, alaw, repetitions,
+      &decoded, &reference);
+  Run("u-law decode per sample", DecodeUPerSample, ulaw, repetitions,
+      &reference, static_cast<std::vector<WebRtc_Word16>*>(NULL));
+  Run("u-law decode table", WebRtcG711_DecodeUBatchC, ulaw, repetitions,
+      &decoded, &reference);
+  Run("u-law decode selected", WebRtcG711_DecodeUBatch, ulaw, repetitions,
+      &decoded, &reference);
+
+  // The round trips do not follow the G.711 transcoding tables, so the
+  // outputs are not compared.
+  Run("u-law to A-law linear", UtoARoundTrip, ulaw, repetitions, &transcoded,
+      static_cast<std::vector<WebRtc_UWord8>*>(NULL));
+  Run("u-law to A-law direct", UtoADirect, ulaw, repetitions, &transcoded,
+      static_cast<std::vector<WebRtc_UWord8>*>(NULL));
+  Run("A-law to u-law linear", AtoURoundTrip, alaw, repetitions, &transcoded,
+      static_cast<std::vector<WebRtc_UWord8>*>(NULL));
+  Run("A-law to u-law direct", AtoUDirect, alaw, repetitions, &transcoded,
+      static_cast<std::vector<WebRtc_UWord8>*>(NULL));
+
+  Run("PCM16B swap per sample", SwapPerSample, speech, repetitions,
+      &reference, static_cast<std::vector<WebRtc_Word16>*>(NULL));
+  Run("PCM16B encode", Pcm16bEncode, speech, repetitions, &decoded,
+      &reference);
+  return 0;
+}
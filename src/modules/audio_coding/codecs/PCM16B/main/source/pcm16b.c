@@ -15,11 +15,40 @@
 
 #ifdef WEBRTC_BIG_ENDIAN
 #include "signal_processing_library.h"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
 #endif
 
-#define HIGHEND 0xFF00
-#define LOWEND    0xFF
-
+#ifndef WEBRTC_BIG_ENDIAN
+/* Swaps the two bytes of each of the |samples| 16 bit values in |in|, for
+ * converting between host (little endian) and network byte order. The
+ * buffers do not need to be aligned, and may be the same. */
+static void WebRtcPcm16b_ByteSwap(const unsigned char *in,
+                                  int samples,
+                                  unsigned char *out)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i*) &in[i*2]);
+        _mm_storeu_si128((__m128i*) &out[i*2],
+                         _mm_or_si128(_mm_slli_epi16(v, 8),
+                                      _mm_srli_epi16(v, 8)));
+    }
+#elif defined(WEBRTC_ARCH_ARM_NEON)
+    for (; i + 8 <= samples; i += 8) {
+        vst1q_u8(&out[i*2], vrev16q_u8(vld1q_u8(&in[i*2])));
+    }
+#endif
+    for (; i < samples; i++) {
+        const unsigned char high = in[i*2+1];
+        out[i*2+1] = in[i*2];
+        out[i*2] = high;
+    }
+}
+#endif
 
 
 /* Encoder with WebRtc_Word16 Output */
@@ -30,10 +59,8 @@ WebRtc_Word16 WebRtcPcm16b_EncodeW16(WebRtc_Word16 *speechIn16b,
 #ifdef WEBRTC_BIG_ENDIAN
     WEBRTC_SPL_MEMCPY_W16(speechOut16b, speechIn16b, len);
 #else
-    int i;
-    for (i=0;i<len;i++) {
-        speechOut16b[i]=(((WebRtc_UWord16)speechIn16b[i])>>8)|((((WebRtc_UWord16)speechIn16b[i])<<8)&0xFF00);
-    }
+    WebRtcPcm16b_ByteSwap((const unsigned char*) speechIn16b, len,
+                          (unsigned char*) speechOut16b);
 #endif
     return(len<<1);
 }
@@ -44,18 +71,12 @@ WebRtc_Word16 WebRtcPcm16b_Encode(WebRtc_Word16 *speech16b,
                                   WebRtc_Word16 len,
                                   unsigned char *speech8b)
 {
-    WebRtc_Word16 samples=len*2;
-    WebRtc_Word16 pos;
-    WebRtc_Word16 short1;
-    WebRtc_Word16 short2;
-    for (pos=0;pos<len;pos++) {
-        short1=HIGHEND & speech16b[pos];
-        short2=LOWEND & speech16b[pos];
-        short1=short1>>8;
-        speech8b[pos*2]=(unsigned char) short1;
-        speech8b[pos*2+1]=(unsigned char) short2;
-    }
-    return(samples);
+#ifdef WEBRTC_BIG_ENDIAN
+    WEBRTC_SPL_MEMCPY_W8(speech8b, speech16b, len*2);
+#else
+    WebRtcPcm16b_ByteSwap((const unsigned char*) speech16b, len, speech8b);
+#endif
+    return(len*2);
 }
 
 
@@ -69,12 +90,8 @@ WebRtc_Word16 WebRtcPcm16b_DecodeW16(void *inst,
 #ifdef WEBRTC_BIG_ENDIAN
     WEBRTC_SPL_MEMCPY_W8(speechOut16b, speechIn16b, ((len*sizeof(WebRtc_Word16)+1)>>1));
 #else
-    int i;
-    int samples=len>>1;
-
-    for (i=0;i<samples;i++) {
-        speechOut16b[i]=(((WebRtc_UWord16)speechIn16b[i])>>8)|(((WebRtc_UWord16)(speechIn16b[i]&0xFF))<<8);
-    }
+    WebRtcPcm16b_ByteSwap((const unsigned char*) speechIn16b, len>>1,
+                          (unsigned char*) speechOut16b);
 #endif
 
     *speechType=1;
@@ -86,15 +103,10 @@ WebRtc_Word16 WebRtcPcm16b_Decode(unsigned char *speech8b,
                                   WebRtc_Word16 len,
                                   WebRtc_Word16 *speech16b)
 {
-    WebRtc_Word16 samples=len>>1;
-    WebRtc_Word16 pos;
-    WebRtc_Word16 shortval;
-    for (pos=0;pos<samples;pos++) {
-        shortval=((unsigned short) speech8b[pos*2]);
-        shortval=(shortval<<8)&HIGHEND;
-        shortval=shortval|(((unsigned short) speech8b[pos*2+1])&LOWEND);
-        speech16b[pos]=shortval;
-    }
-    return(samples);
+#ifdef WEBRTC_BIG_ENDIAN
+    WEBRTC_SPL_MEMCPY_W8(speech16b, speech8b, len&~1);
+#else
+    WebRtcPcm16b_ByteSwap(speech8b, len>>1, (unsigned char*) speech16b);
+#endif
+    return(len>>1);
 }
-
@@ -26,6 +26,13 @@
         '../interface/pcm16b.h',
         'pcm16b.c',
       ],
+      'conditions': [
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+        }],
+      ],
     },
   ],
 }
@@ -20,6 +20,11 @@ typedef struct WebRtcISACStruct    ISACStruct;
 
 enum IsacSamplingRate {kIsacWideband = 16,  kIsacSuperWideband = 32};
 
+/* Runs task(arg) on worker, c.f. WebRtcIsac_SetEncoderWorker(). */
+typedef void (*IsacTask)(void* arg);
+typedef int (*IsacStartTask)(void* worker, IsacTask task, void* arg);
+typedef void (*IsacWaitTask)(void* worker);
+
 
 #if defined(__cplusplus)
 extern "C" {
@@ -720,6 +725,39 @@ extern "C" {
       WebRtc_Word16*        speechType);
 
 
+  /****************************************************************************
+   * WebRtcIsac_SetEncoderWorker(...)
+   *
+   * In super-wideband mode the analysis of the upper-band does not depend on
+   * the lower-band. With a worker, WebRtcIsac_Encode() runs the upper-band
+   * analysis of a frame on the worker while the lower-band is analyzed and
+   * entropy coded on the calling thread. The upper-band spectrum is coded
+   * when both are done, so the bit-stream is the same as without a worker
+   * and no delay is added.
+   *
+   * startTask(worker, task, arg) should start task(arg) on the worker and
+   * return 0, or return -1 if it cannot, in which case the task runs on the
+   * calling thread. waitTask(worker) should return when the started task is
+   * done. The worker must not be removed or destroyed while
+   * WebRtcIsac_Encode() is running.
+   *
+   * Input:
+   *        - ISAC_main_inst    : iSAC instance
+   *        - startTask         : starts a task on the worker, NULL to encode
+   *                              on the calling thread only.
+   *        - waitTask          : waits for the task started by startTask.
+   *        - worker            : passed to startTask and waitTask.
+   *
+   * Return value               : 0 if successful
+   *                             -1 if failed.
+   */
+  WebRtc_Word16 WebRtcIsac_SetEncoderWorker(
+      ISACStruct*   ISAC_main_inst,
+      IsacStartTask startTask,
+      IsacWaitTask  waitTask,
+      void*         worker);
+
+
 #if defined(__cplusplus)
 }
 #endif
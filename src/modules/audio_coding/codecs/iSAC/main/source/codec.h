@@ -141,46 +141,105 @@ int WebRtcIsac_DecodeUb12(
 
 
 /******************************************************************************
- * WebRtcIsac_EncodeUb16()
+ * WebRtcIsac_BufferUb()
  *
- * Encode the upper-band if the codec is in 0-16 kHz mode.
+ * Buffer the upper-band audio until there is a frame to encode. The frame is
+ * encoded by WebRtcIsac_AnalyzeUb16() and WebRtcIsac_CodeUb16(), or by
+ * WebRtcIsac_AnalyzeUb12() and WebRtcIsac_CodeUb12(), which may be called
+ * before the lower-band of the frame is encoded.
  *
  * Input:
  *       -in                 : upper-band audio, 160 samples (10 ms).
  *
  * Input/Output:
- *       -ISACdec_obj        : pointer to the upper-band encoder object. The
- *                             bit-stream is stored inside the encoder object.
+ *       -ISACenc_obj        : pointer to the upper-band encoder object.
  *
- * Return value              : >0 number of encoded bytes.
- *                             <0 if an error occurred.
+ * Return value              : 1 if a frame is buffered, 0 otherwise.
  */
-int WebRtcIsac_EncodeUb16(
+int WebRtcIsac_BufferUb(
     float*           in,
-    ISACUBEncStruct* ISACenc_obj,
-    WebRtc_Word32    jitterInfo);
+    ISACUBEncStruct* ISACenc_obj);
 
 
 /******************************************************************************
- * WebRtcIsac_EncodeUb12()
+ * WebRtcIsac_AnalyzeUb16()
  *
- * Encode the upper-band if the codec is in 0-12 kHz mode.
+ * Analyze the buffered upper-band frame if the codec is in 0-16 kHz mode, and
+ * code the LPC parameters. Does not use the lower-band, so it can run
+ * concurrently with WebRtcIsac_EncodeLb().
  *
  * Input:
- *       -in                 : upper-band audio, 160 samples (10 ms).
+ *       -jitterInfo         : jitter information coded in the bit-stream.
+ *
+ * Input/Output:
+ *       -ISACenc_obj        : pointer to the upper-band encoder object. The
+ *                             analysis is stored inside the encoder object.
+ *
+ * Return value              : 0 if successful.
+ *                             <0 if an error occurred.
+ */
+int WebRtcIsac_AnalyzeUb16(
+    ISACUBEncStruct* ISACenc_obj,
+    WebRtc_Word32    jitterInfo);
+
+
+/******************************************************************************
+ * WebRtcIsac_CodeUb16()
+ *
+ * Code the spectrum of the upper-band frame analyzed by
+ * WebRtcIsac_AnalyzeUb16(), within the payload left by the lower-band as
+ * given by numBytesUsed in the encoder object.
  *
  * Input/Output:
- *       -ISACdec_obj        : pointer to the upper-band encoder object. The
+ *       -ISACenc_obj        : pointer to the upper-band encoder object. The
  *                             bit-stream is stored inside the encoder object.
  *
  * Return value              : >0 number of encoded bytes.
  *                             <0 if an error occurred.
  */
-int WebRtcIsac_EncodeUb12(
-    float*           in,
+int WebRtcIsac_CodeUb16(
+    ISACUBEncStruct* ISACenc_obj);
+
+
+/******************************************************************************
+ * WebRtcIsac_AnalyzeUb12()
+ *
+ * Analyze the buffered upper-band frame if the codec is in 0-12 kHz mode, and
+ * code the LPC parameters. Does not use the lower-band, so it can run
+ * concurrently with WebRtcIsac_EncodeLb().
+ *
+ * Input:
+ *       -jitterInfo         : jitter information coded in the bit-stream.
+ *
+ * Input/Output:
+ *       -ISACenc_obj        : pointer to the upper-band encoder object. The
+ *                             analysis is stored inside the encoder object.
+ *
+ * Return value              : 0 if successful.
+ *                             <0 if an error occurred.
+ */
+int WebRtcIsac_AnalyzeUb12(
     ISACUBEncStruct* ISACenc_obj,
     WebRtc_Word32    jitterInfo);
 
+
+/******************************************************************************
+ * WebRtcIsac_CodeUb12()
+ *
+ * Code the spectrum of the upper-band frame analyzed by
+ * WebRtcIsac_AnalyzeUb12(), within the payload left by the lower-band as
+ * given by numBytesUsed in the encoder object.
+ *
+ * Input/Output:
+ *       -ISACenc_obj        : pointer to the upper-band encoder object. The
+ *                             bit-stream is stored inside the encoder object.
+ *
+ * Return value              : >0 number of encoded bytes.
+ *                             <0 if an error occurred.
+ */
+int WebRtcIsac_CodeUb12(
+    ISACUBEncStruct* ISACenc_obj);
+
 /************************** initialization functions *************************/
 
 void WebRtcIsac_InitMasking(MaskFiltstr *maskdata);
@@ -568,36 +568,14 @@ WebRtcIsac_EncodeLb(
 
 
 int
-WebRtcIsac_EncodeUb16(
+WebRtcIsac_BufferUb(
     float*           in,
-    ISACUBEncStruct* ISACencUB_obj,
-    WebRtc_Word32      jitterInfo)
+    ISACUBEncStruct* ISACencUB_obj)
 {
-  int err;
   int k;
 
-  double lpcVecs[UB_LPC_ORDER * UB16_LPC_VEC_PER_FRAME];
-  double percepFilterParams[(1 + UB_LPC_ORDER) * (SUBFRAMES<<1) +
-                            (1 + UB_LPC_ORDER)];
-
-  double LP_lookahead[FRAMESAMPLES];
-  WebRtc_Word16 fre[FRAMESAMPLES_HALF];   /* Q7 */
-  WebRtc_Word16 fim[FRAMESAMPLES_HALF];   /* Q7 */
-
-  int status = 0;
-
-  double varscale[2];
-  double corr[SUBFRAMES<<1][UB_LPC_ORDER + 1];
-  double lpcGains[SUBFRAMES<<1];
-  transcode_obj transcodingParam;
-  double bytesLeftSpecCoding;
-  WebRtc_UWord16 payloadLimitBytes;
-  WebRtc_UWord16 iterCntr;
-  double s2nr;
-
-
   /* buffer speech samples (by 10ms packet) until the framelength is   */
-  /* reached (30 or 60 ms)                                             */
+  /* reached (30 ms)                                                   */
   /*********************************************************************/
 
   /* fill the buffer with 10ms input data */
@@ -606,18 +584,39 @@ WebRtcIsac_EncodeUb16(
         in[k];
   }
 
-  /* if buffersize is not equal to current framesize, and end of file is
-     not reached yet, we don't do encoding unless we have the whole frame */
+  /* if buffersize is not equal to current framesize, we don't do
+     encoding unless we have the whole frame */
   if (ISACencUB_obj->buffer_index + FRAMESAMPLES_10ms < FRAMESAMPLES) {
     ISACencUB_obj->buffer_index += FRAMESAMPLES_10ms;
     return 0;
   }
+  return 1;
+}
 
-  /* end of buffer function */
-  /**************************/
 
-  /* encoding */
-  /************/
+int
+WebRtcIsac_AnalyzeUb16(
+    ISACUBEncStruct* ISACencUB_obj,
+    WebRtc_Word32      jitterInfo)
+{
+  int k;
+
+  double lpcVecs[UB_LPC_ORDER * UB16_LPC_VEC_PER_FRAME];
+  double percepFilterParams[(1 + UB_LPC_ORDER) * (SUBFRAMES<<1) +
+                            (1 + UB_LPC_ORDER)];
+
+  double LP_lookahead[FRAMESAMPLES];
+  WebRtc_Word16* fre = ISACencUB_obj->analysis_obj.fre;   /* Q7 */
+  WebRtc_Word16* fim = ISACencUB_obj->analysis_obj.fim;   /* Q7 */
+
+  int status = 0;
+
+  double varscale[2];
+  double corr[SUBFRAMES<<1][UB_LPC_ORDER + 1];
+  double* lpcGains = ISACencUB_obj->analysis_obj.lpcGains;
+  transcode_obj* transcodingParam =
+      &ISACencUB_obj->analysis_obj.transcodingParam;
+  double s2nr;
 
   /* reset bitstream */
   ISACencUB_obj->bitstr_obj.W_upper = 0xFFFFFFFF;
@@ -662,20 +661,20 @@ WebRtcIsac_EncodeUb16(
                        (SUBFRAMES<<1), lpcGains, corr, varscale);
 
   /* Store the state of arithmetic coder before coding LPC gains */
-  transcodingParam.stream_index = ISACencUB_obj->bitstr_obj.stream_index;
-  transcodingParam.W_upper      = ISACencUB_obj->bitstr_obj.W_upper;
-  transcodingParam.streamval    = ISACencUB_obj->bitstr_obj.streamval;
-  transcodingParam.stream[0]    = ISACencUB_obj->bitstr_obj.stream[
+  transcodingParam->stream_index = ISACencUB_obj->bitstr_obj.stream_index;
+  transcodingParam->W_upper      = ISACencUB_obj->bitstr_obj.W_upper;
+  transcodingParam->streamval    = ISACencUB_obj->bitstr_obj.streamval;
+  transcodingParam->stream[0]    = ISACencUB_obj->bitstr_obj.stream[
       ISACencUB_obj->bitstr_obj.stream_index - 2];
-  transcodingParam.stream[1]    = ISACencUB_obj->bitstr_obj.stream[
+  transcodingParam->stream[1]    = ISACencUB_obj->bitstr_obj.stream[
       ISACencUB_obj->bitstr_obj.stream_index - 1];
-  transcodingParam.stream[2]    = ISACencUB_obj->bitstr_obj.stream[
+  transcodingParam->stream[2]    = ISACencUB_obj->bitstr_obj.stream[
       ISACencUB_obj->bitstr_obj.stream_index];
 
   /* Store LPC Gains before encoding them */
   for(k = 0; k < SUBFRAMES; k++) {
-    transcodingParam.loFiltGain[k] = lpcGains[k];
-    transcodingParam.hiFiltGain[k] = lpcGains[SUBFRAMES + k];
+    transcodingParam->loFiltGain[k] = lpcGains[k];
+    transcodingParam->hiFiltGain[k] = lpcGains[SUBFRAMES + k];
   }
 
   // Store the gains for multiple encoding
@@ -686,14 +685,6 @@ WebRtcIsac_EncodeUb16(
   WebRtcIsac_EncodeLpcGainUb(&lpcGains[SUBFRAMES], &ISACencUB_obj->bitstr_obj,
                              &ISACencUB_obj->SaveEnc_obj.lpcGainIndex[SUBFRAMES]);
 
-  /* Get the correct value for the payload limit and calculate the number of
-     bytes left for coding the spectrum. It is a 30ms frame
-     Subract 3 because termination process may add 3 bytes */
-  payloadLimitBytes = ISACencUB_obj->maxPayloadSizeBytes -
-      ISACencUB_obj->numBytesUsed - 3;
-  bytesLeftSpecCoding = payloadLimitBytes -
-      ISACencUB_obj->bitstr_obj.stream_index;
-
   for (k = 0; k < (SUBFRAMES<<1); k++) {
     percepFilterParams[k*(UB_LPC_ORDER + 1) + (UB_LPC_ORDER + 1)] =
         lpcGains[k];
@@ -735,6 +726,35 @@ WebRtcIsac_EncodeUb16(
   // of the lower-band.
   ISACencUB_obj->buffer_index = LB_TOTAL_DELAY_SAMPLES;
 
+  return 0;
+}
+
+
+int
+WebRtcIsac_CodeUb16(
+    ISACUBEncStruct* ISACencUB_obj)
+{
+  int err;
+  int k;
+
+  WebRtc_Word16* fre = ISACencUB_obj->analysis_obj.fre;   /* Q7 */
+  WebRtc_Word16* fim = ISACencUB_obj->analysis_obj.fim;   /* Q7 */
+
+  double* lpcGains = ISACencUB_obj->analysis_obj.lpcGains;
+  transcode_obj* transcodingParam =
+      &ISACencUB_obj->analysis_obj.transcodingParam;
+  double bytesLeftSpecCoding;
+  WebRtc_UWord16 payloadLimitBytes;
+  WebRtc_UWord16 iterCntr;
+
+  /* Get the correct value for the payload limit and calculate the number of
+     bytes left for coding the spectrum. It is a 30ms frame
+     Subract 3 because termination process may add 3 bytes */
+  payloadLimitBytes = ISACencUB_obj->maxPayloadSizeBytes -
+      ISACencUB_obj->numBytesUsed - 3;
+  bytesLeftSpecCoding = payloadLimitBytes -
+      ISACencUB_obj->bitstr_obj.stream_index;
+
   // Save the bit-stream object at this point for FEC.
   memcpy(&ISACencUB_obj->SaveEnc_obj.bitStreamObj,
          &ISACencUB_obj->bitstr_obj, sizeof(Bitstr));
@@ -762,7 +782,7 @@ WebRtcIsac_EncodeUb16(
       transcodeScale = bytesLeftSpecCoding / bytesSpecCoderUsed * 0.5;
     } else {
       bytesSpecCoderUsed = ISACencUB_obj->bitstr_obj.stream_index -
-          transcodingParam.stream_index;
+          transcodingParam->stream_index;
       transcodeScale = bytesLeftSpecCoding / bytesSpecCoderUsed;
     }
 
@@ -773,8 +793,8 @@ WebRtcIsac_EncodeUb16(
 
     /* Scale the LPC Gains */
     for (k = 0; k < SUBFRAMES; k++) {
-      transcodingParam.loFiltGain[k] *= transcodeScale;
-      transcodingParam.hiFiltGain[k] *= transcodeScale;
+      transcodingParam->loFiltGain[k] *= transcodeScale;
+      transcodingParam->hiFiltGain[k] *= transcodeScale;
     }
 
     /* Scale DFT coefficients */
@@ -792,29 +812,29 @@ WebRtcIsac_EncodeUb16(
 
 
     /* Store the state of arithmetic coder before coding LPC gains */
-    ISACencUB_obj->bitstr_obj.W_upper = transcodingParam.W_upper;
+    ISACencUB_obj->bitstr_obj.W_upper = transcodingParam->W_upper;
 
-    ISACencUB_obj->bitstr_obj.stream_index = transcodingParam.stream_index;
+    ISACencUB_obj->bitstr_obj.stream_index = transcodingParam->stream_index;
 
-    ISACencUB_obj->bitstr_obj.streamval = transcodingParam.streamval;
+    ISACencUB_obj->bitstr_obj.streamval = transcodingParam->streamval;
 
-    ISACencUB_obj->bitstr_obj.stream[transcodingParam.stream_index - 2] =
-        transcodingParam.stream[0];
+    ISACencUB_obj->bitstr_obj.stream[transcodingParam->stream_index - 2] =
+        transcodingParam->stream[0];
 
-    ISACencUB_obj->bitstr_obj.stream[transcodingParam.stream_index - 1] =
-        transcodingParam.stream[1];
+    ISACencUB_obj->bitstr_obj.stream[transcodingParam->stream_index - 1] =
+        transcodingParam->stream[1];
 
-    ISACencUB_obj->bitstr_obj.stream[transcodingParam.stream_index] =
-        transcodingParam.stream[2];
+    ISACencUB_obj->bitstr_obj.stream[transcodingParam->stream_index] =
+        transcodingParam->stream[2];
 
     // Store the gains for multiple encoding
     memcpy(ISACencUB_obj->SaveEnc_obj.lpcGain, lpcGains,
            (SUBFRAMES << 1) * sizeof(double));
 
-    WebRtcIsac_EncodeLpcGainUb(transcodingParam.loFiltGain,
+    WebRtcIsac_EncodeLpcGainUb(transcodingParam->loFiltGain,
                                &ISACencUB_obj->bitstr_obj,
                                ISACencUB_obj->SaveEnc_obj.lpcGainIndex);
-    WebRtcIsac_EncodeLpcGainUb(transcodingParam.hiFiltGain,
+    WebRtcIsac_EncodeLpcGainUb(transcodingParam->hiFiltGain,
                                &ISACencUB_obj->bitstr_obj,
                                &ISACencUB_obj->SaveEnc_obj.lpcGainIndex[SUBFRAMES]);
 
@@ -842,14 +862,11 @@ WebRtcIsac_EncodeUb16(
 
 
 int
-WebRtcIsac_EncodeUb12(
-    float*           in,
+WebRtcIsac_AnalyzeUb12(
     ISACUBEncStruct* ISACencUB_obj,
     WebRtc_Word32      jitterInfo)
 {
-  int err;
   int k;
-  int iterCntr;
 
   double lpcVecs[UB_LPC_ORDER * UB_LPC_VEC_PER_FRAME];
 
@@ -862,8 +879,8 @@ WebRtcIsac_EncodeUb12(
   double LPw[FRAMESAMPLES_HALF];
 
   double HPw[FRAMESAMPLES_HALF];
-  WebRtc_Word16 fre[FRAMESAMPLES_HALF];   /* Q7 */
-  WebRtc_Word16 fim[FRAMESAMPLES_HALF];   /* Q7 */
+  WebRtc_Word16* fre = ISACencUB_obj->analysis_obj.fre;   /* Q7 */
+  WebRtc_Word16* fim = ISACencUB_obj->analysis_obj.fim;   /* Q7 */
 
   WebRtc_Word16    AvgPitchGain_Q12;
 
@@ -872,38 +889,15 @@ WebRtcIsac_EncodeUb12(
   double varscale[1];
 
   double corr[UB_LPC_GAIN_DIM][UB_LPC_ORDER + 1];
-  double lpcGains[SUBFRAMES];
-  transcode_obj transcodingParam;
-  double bytesLeftSpecCoding;
-  WebRtc_UWord16 payloadLimitBytes;
+  double* lpcGains = ISACencUB_obj->analysis_obj.lpcGains;
+  transcode_obj* transcodingParam =
+      &ISACencUB_obj->analysis_obj.transcodingParam;
   double s2nr;
 
-  /* buffer speech samples (by 10ms packet) until the framelength is  */
-  /* reached (30 or 60 ms)                                            */
-  /********************************************************************/
-
-  /* fill the buffer with 10ms input data */
-  for (k=0; k<FRAMESAMPLES_10ms; k++) {
-    ISACencUB_obj->data_buffer_float[k + ISACencUB_obj->buffer_index] =
-        in[k];
-  }
-
-  /* if buffer-size is not equal to current frame-size then increase the
-     index and return. We do the encoding when we have enough audio.     */
-  if (ISACencUB_obj->buffer_index + FRAMESAMPLES_10ms < FRAMESAMPLES) {
-    ISACencUB_obj->buffer_index += FRAMESAMPLES_10ms;
-    return 0;
-  }
-  /* if buffer reached the right size, reset index and continue
+  /* the buffer has reached the right size, reset index and continue
      with encoding the frame */
   ISACencUB_obj->buffer_index = 0;
 
-  /* end of buffer function */
-  /**************************/
-
-  /* encoding */
-  /************/
-
   /* reset bitstream */
   ISACencUB_obj->bitstr_obj.W_upper = 0xFFFFFFFF;
   ISACencUB_obj->bitstr_obj.streamval = 0;
@@ -941,24 +935,24 @@ WebRtcIsac_EncodeUb12(
                        corr, varscale);
   
   /* Store the state of arithmetic coder before coding LPC gains */
-  transcodingParam.W_upper = ISACencUB_obj->bitstr_obj.W_upper;
+  transcodingParam->W_upper = ISACencUB_obj->bitstr_obj.W_upper;
 
-  transcodingParam.stream_index = ISACencUB_obj->bitstr_obj.stream_index;
+  transcodingParam->stream_index = ISACencUB_obj->bitstr_obj.stream_index;
 
-  transcodingParam.streamval = ISACencUB_obj->bitstr_obj.streamval;
+  transcodingParam->streamval = ISACencUB_obj->bitstr_obj.streamval;
 
-  transcodingParam.stream[0] = ISACencUB_obj->bitstr_obj.stream[
+  transcodingParam->stream[0] = ISACencUB_obj->bitstr_obj.stream[
       ISACencUB_obj->bitstr_obj.stream_index - 2];
 
-  transcodingParam.stream[1] = ISACencUB_obj->bitstr_obj.stream[
+  transcodingParam->stream[1] = ISACencUB_obj->bitstr_obj.stream[
       ISACencUB_obj->bitstr_obj.stream_index - 1];
 
-  transcodingParam.stream[2] = ISACencUB_obj->bitstr_obj.stream[
+  transcodingParam->stream[2] = ISACencUB_obj->bitstr_obj.stream[
       ISACencUB_obj->bitstr_obj.stream_index];
 
   /* Store LPC Gains before encoding them */
   for(k = 0; k < SUBFRAMES; k++) {
-    transcodingParam.loFiltGain[k] = lpcGains[k];
+    transcodingParam->loFiltGain[k] = lpcGains[k];
   }
 
   // Store the gains for multiple encoding
@@ -979,14 +973,6 @@ WebRtcIsac_EncodeUb12(
                                   ISACencUB_obj->maskfiltstr_obj.PreStateLoG, LP, percepFilterParams,
                                   LPw);
 
-  /* Get the correct value for the payload limit and calculate the number
-     of bytes left for coding the spectrum. It is a 30ms frame Subract 3
-     because termination process may add 3 bytes */
-  payloadLimitBytes = ISACencUB_obj->maxPayloadSizeBytes -
-      ISACencUB_obj->numBytesUsed - 3;
-  bytesLeftSpecCoding = payloadLimitBytes -
-      ISACencUB_obj->bitstr_obj.stream_index;
-
   memset(HPw, 0, sizeof(double) * FRAMESAMPLES_HALF);
 
   /* transform */
@@ -1000,6 +986,35 @@ WebRtcIsac_EncodeUb12(
   memcpy(&ISACencUB_obj->SaveEnc_obj.imagFFT, fim,
          FRAMESAMPLES_HALF * sizeof(WebRtc_Word16));
 
+  return 0;
+}
+
+
+int
+WebRtcIsac_CodeUb12(
+    ISACUBEncStruct* ISACencUB_obj)
+{
+  int err;
+  int k;
+  int iterCntr;
+
+  WebRtc_Word16* fre = ISACencUB_obj->analysis_obj.fre;   /* Q7 */
+  WebRtc_Word16* fim = ISACencUB_obj->analysis_obj.fim;   /* Q7 */
+
+  double* lpcGains = ISACencUB_obj->analysis_obj.lpcGains;
+  transcode_obj* transcodingParam =
+      &ISACencUB_obj->analysis_obj.transcodingParam;
+  double bytesLeftSpecCoding;
+  WebRtc_UWord16 payloadLimitBytes;
+
+  /* Get the correct value for the payload limit and calculate the number
+     of bytes left for coding the spectrum. It is a 30ms frame Subract 3
+     because termination process may add 3 bytes */
+  payloadLimitBytes = ISACencUB_obj->maxPayloadSizeBytes -
+      ISACencUB_obj->numBytesUsed - 3;
+  bytesLeftSpecCoding = payloadLimitBytes -
+      ISACencUB_obj->bitstr_obj.stream_index;
+
   // Save the bit-stream object at this point for FEC.
   memcpy(&ISACencUB_obj->SaveEnc_obj.bitStreamObj,
          &ISACencUB_obj->bitstr_obj, sizeof(Bitstr));
@@ -1028,7 +1043,7 @@ WebRtcIsac_EncodeUb12(
       transcodeScale = bytesLeftSpecCoding / bytesSpecCoderUsed * 0.5;
     } else {
       bytesSpecCoderUsed = ISACencUB_obj->bitstr_obj.stream_index -
-          transcodingParam.stream_index;
+          transcodingParam->stream_index;
       transcodeScale = bytesLeftSpecCoding / bytesSpecCoderUsed;
     }
 
@@ -1039,7 +1054,7 @@ WebRtcIsac_EncodeUb12(
 
     /* Scale the LPC Gains */
     for (k = 0; k < SUBFRAMES; k++) {
-      transcodingParam.loFiltGain[k] *= transcodeScale;
+      transcodingParam->loFiltGain[k] *= transcodeScale;
     }
 
     /* Scale DFT coefficients */
@@ -1058,20 +1073,20 @@ WebRtcIsac_EncodeUb12(
 
 
     /* Re-store the state of arithmetic coder before coding LPC gains */
-    ISACencUB_obj->bitstr_obj.W_upper = transcodingParam.W_upper;
+    ISACencUB_obj->bitstr_obj.W_upper = transcodingParam->W_upper;
 
-    ISACencUB_obj->bitstr_obj.stream_index = transcodingParam.stream_index;
+    ISACencUB_obj->bitstr_obj.stream_index = transcodingParam->stream_index;
 
-    ISACencUB_obj->bitstr_obj.streamval = transcodingParam.streamval;
+    ISACencUB_obj->bitstr_obj.streamval = transcodingParam->streamval;
 
-    ISACencUB_obj->bitstr_obj.stream[transcodingParam.stream_index - 2] =
-        transcodingParam.stream[0];
+    ISACencUB_obj->bitstr_obj.stream[transcodingParam->stream_index - 2] =
+        transcodingParam->stream[0];
 
-    ISACencUB_obj->bitstr_obj.stream[transcodingParam.stream_index - 1] =
-        transcodingParam.stream[1];
+    ISACencUB_obj->bitstr_obj.stream[transcodingParam->stream_index - 1] =
+        transcodingParam->stream[1];
 
-    ISACencUB_obj->bitstr_obj.stream[transcodingParam.stream_index] =
-        transcodingParam.stream[2];
+    ISACencUB_obj->bitstr_obj.stream[transcodingParam->stream_index] =
+        transcodingParam->stream[2];
 
     // Store the gains for multiple encoding
     memcpy(&ISACencUB_obj->SaveEnc_obj.lpcGain, lpcGains, SUBFRAMES *
@@ -1079,7 +1094,7 @@ WebRtcIsac_EncodeUb12(
 
     // encode LPC gain and store quantization indices. HAving quantization
     // indices reduces transcoding complexity if 'scale factor' is 1.
-    WebRtcIsac_EncodeLpcGainUb(transcodingParam.loFiltGain,
+    WebRtcIsac_EncodeLpcGainUb(transcodingParam->loFiltGain,
                                &ISACencUB_obj->bitstr_obj,
                                ISACencUB_obj->SaveEnc_obj.lpcGainIndex);
 
@@ -230,6 +230,29 @@ static void GetSendBandwidthInfo(
 }
 
 
+/*
+ * Analyzes the buffered upper-band frame. Runs on the encoder worker, if there
+ * is one, and therefore only touches the upper-band encoder and the input and
+ * result fields of the analysis.
+ */
+static void AnalyzeUb(void* arg)
+{
+  ISACMainStruct* instISAC = (ISACMainStruct*)arg;
+  ISACUBEncStruct* ISACencUB_obj = &(instISAC->instUB.ISACencUB_obj);
+
+  if(instISAC->bandwidthKHz == isac12kHz)
+    {
+      instISAC->statusUB = WebRtcIsac_AnalyzeUb12(ISACencUB_obj,
+                                                  instISAC->jitterInfoUB);
+    }
+  else
+    {
+      instISAC->statusUB = WebRtcIsac_AnalyzeUb16(ISACencUB_obj,
+                                                  instISAC->jitterInfoUB);
+    }
+}
+
+
 /****************************************************************************
  * WebRtcIsac_AssignSize(...)
  *
@@ -281,6 +304,9 @@ WebRtc_Word16 WebRtcIsac_Assign(
       instISAC->encoderSamplingRateKHz = kIsacWideband;
       instISAC->decoderSamplingRateKHz = kIsacWideband;
       instISAC->bandwidthKHz           = isac8kHz;
+      instISAC->startTaskEnc = NULL;
+      instISAC->waitTaskEnc  = NULL;
+      instISAC->workerEnc    = NULL;
       return 0;
     }
   else
@@ -317,6 +343,9 @@ WebRtc_Word16 WebRtcIsac_Create(
       instISAC->bandwidthKHz           = isac8kHz;
       instISAC->encoderSamplingRateKHz = kIsacWideband;
       instISAC->decoderSamplingRateKHz = kIsacWideband;
+      instISAC->startTaskEnc = NULL;
+      instISAC->waitTaskEnc  = NULL;
+      instISAC->workerEnc    = NULL;
       return 0;
     }
   else
@@ -561,6 +590,7 @@ WebRtc_Word16 WebRtcIsac_Encode(
   ISACUBStruct*   instUB;
 
   float        inFrame[FRAMESAMPLES_10ms];
+  float        inFrameUB[FRAMESAMPLES_10ms];
   WebRtc_Word16  speechInLB[FRAMESAMPLES_10ms];
   WebRtc_Word16  speechInUB[FRAMESAMPLES_10ms];
   WebRtc_Word16  streamLenLB;
@@ -572,6 +602,8 @@ WebRtc_Word16 WebRtcIsac_Encode(
   WebRtc_Word32  bottleneck;
   WebRtc_Word16  bottleneckIdx = 0;
   WebRtc_Word16  jitterInfo = 0;
+  int          analyzeUB = 0;
+  int          waitUB = 0;
 
   instISAC = (ISACMainStruct*)ISAC_main_inst;
   instLB = &(instISAC->instLB);
@@ -618,65 +650,94 @@ WebRtc_Word16 WebRtcIsac_Encode(
   GetSendBandwidthInfo(instISAC, &bottleneckIdx, &jitterInfo);
 
   //
-  // ENCODE LOWER-BAND
+  // ANALYZE UPPER-BAND
   //
-  streamLenLB = WebRtcIsac_EncodeLb(inFrame, &instLB->ISACencLB_obj,
-                                    instISAC->codingMode, bottleneckIdx);
-
-  if(streamLenLB < 0)
-    {
-      return -1;
-    }
-
   if(instISAC->encoderSamplingRateKHz == kIsacSuperWideband)
     {
-      instUB = &(instISAC->instUB);
-
       // convert to float
       for(k = 0; k < FRAMESAMPLES_10ms; k++)
 	{
-	  inFrame[k] = (float) speechInUB[k];
+	  inFrameUB[k] = (float) speechInUB[k];
 	}
 
       /* add some noise to avoid denormal numbers */
-      inFrame[0] += (float)1.23455334e-3;
-      inFrame[1] -= (float)2.04324239e-3;
-      inFrame[2] += (float)1.90854954e-3;
-      inFrame[9] += (float)1.84854878e-3;
+      inFrameUB[0] += (float)1.23455334e-3;
+      inFrameUB[1] -= (float)2.04324239e-3;
+      inFrameUB[2] += (float)1.90854954e-3;
+      inFrameUB[9] += (float)1.84854878e-3;
 
-      // Tell to upper-band the number of bytes used so far.
-      // This is for payload limitation.
-      instUB->ISACencUB_obj.numBytesUsed = streamLenLB + 1 +
-        LEN_CHECK_SUM_WORD8;
-
-      //
-      // ENCODE UPPER-BAND
-      //
       switch(instISAC->bandwidthKHz)
 	{
 	case isac12kHz:
-	  {
-	    streamLenUB = WebRtcIsac_EncodeUb12(inFrame,
-						&instUB->ISACencUB_obj,
-						jitterInfo);
-	    break;
-	  }
 	case isac16kHz:
 	  {
-	    streamLenUB = WebRtcIsac_EncodeUb16(inFrame,
-						&instUB->ISACencUB_obj,
-						jitterInfo);
+	    analyzeUB = WebRtcIsac_BufferUb(inFrameUB, &instUB->ISACencUB_obj);
 	    break;
 	  }
 	case isac8kHz:
 	  {
-	    streamLenUB = 0;
 	    break;
 	  }
 	default:
 	  return -1;
 	}
 
+      // The analysis does not depend on the lower-band, so it runs on the
+      // worker, if there is one, while the lower-band is encoded.
+      if(analyzeUB)
+	{
+	  instISAC->jitterInfoUB = jitterInfo;
+	  if((instISAC->startTaskEnc != NULL) &&
+	     (instISAC->startTaskEnc(instISAC->workerEnc, AnalyzeUb,
+				     instISAC) == 0))
+	    {
+	      waitUB = 1;
+	    }
+	  else
+	    {
+	      AnalyzeUb(instISAC);
+	    }
+	}
+    }
+
+  //
+  // ENCODE LOWER-BAND
+  //
+  streamLenLB = WebRtcIsac_EncodeLb(inFrame, &instLB->ISACencLB_obj,
+                                    instISAC->codingMode, bottleneckIdx);
+
+  if(waitUB)
+    {
+      instISAC->waitTaskEnc(instISAC->workerEnc);
+    }
+
+  if(streamLenLB < 0)
+    {
+      return -1;
+    }
+
+  if(instISAC->encoderSamplingRateKHz == kIsacSuperWideband)
+    {
+      // Tell to upper-band the number of bytes used so far.
+      // This is for payload limitation.
+      instUB->ISACencUB_obj.numBytesUsed = streamLenLB + 1 +
+        LEN_CHECK_SUM_WORD8;
+
+      //
+      // ENCODE UPPER-BAND
+      //
+      streamLenUB = 0;
+      if(analyzeUB)
+	{
+	  streamLenUB = instISAC->statusUB;
+	  if(streamLenUB == 0)
+	    {
+	      streamLenUB = (instISAC->bandwidthKHz == isac12kHz)?
+		WebRtcIsac_CodeUb12(&instUB->ISACencUB_obj):
+		WebRtcIsac_CodeUb16(&instUB->ISACencUB_obj);
+	    }
+	}
+
       if((streamLenUB < 0) &&
 	 (streamLenUB != -ISAC_PAYLOAD_LARGER_THAN_LIMIT))
 	{
@@ -2812,3 +2873,39 @@ enum IsacSamplingRate WebRtcIsac_DecSampRate(
 
   return instISAC->decoderSamplingRateKHz;
 }
+
+
+/****************************************************************************
+ * WebRtcIsac_SetEncoderWorker(...)
+ *
+ * This function sets the worker on which the upper-band analysis runs in
+ * super-wideband mode. A NULL startTask removes the worker.
+ *
+ * Input:
+ *        - ISAC_main_inst    : iSAC instance
+ *        - startTask         : starts a task on the worker.
+ *        - waitTask          : waits for the task started by startTask.
+ *        - worker            : passed to startTask and waitTask.
+ *
+ * Return value               : 0 if successful
+ *                             -1 if failed.
+ */
+WebRtc_Word16 WebRtcIsac_SetEncoderWorker(
+					 ISACStruct*   ISAC_main_inst,
+					 IsacStartTask startTask,
+					 IsacWaitTask  waitTask,
+					 void*         worker)
+{
+  ISACMainStruct* instISAC;
+
+  instISAC = (ISACMainStruct*)ISAC_main_inst;
+
+  if((startTask != NULL) && (waitTask == NULL))
+    {
+      return -1;
+    }
+  instISAC->startTaskEnc = startTask;
+  instISAC->waitTaskEnc  = waitTask;
+  instISAC->workerEnc    = worker;
+  return 0;
+}
@@ -354,6 +354,37 @@ typedef struct {
   WebRtc_Word16         lastBWIdx;
 } ISACLBEncStruct;
 
+/*
+  This struct is used to take a snapshot of the entropy coder and LPC gains
+  right before encoding LPC gains. This allows us to go back to that state
+  if we like to limit the payload size.
+*/
+typedef struct {
+  /* 6 lower-band & 6 upper-band */
+  double       loFiltGain[SUBFRAMES];
+  double       hiFiltGain[SUBFRAMES];
+  /* Upper boundary of interval W */
+  WebRtc_UWord32 W_upper;
+  WebRtc_UWord32 streamval;
+  /* Index to the current position in bytestream */
+  WebRtc_UWord32 stream_index;
+  WebRtc_UWord8  stream[3];
+} transcode_obj;
+
+
+/*
+  The upper-band analysis of a frame, which is kept until its spectrum is
+  coded. The analysis does not depend on the lower-band, while the spectrum
+  coding depends on the number of bytes used by the lower-band.
+*/
+typedef struct {
+  WebRtc_Word16  fre[FRAMESAMPLES_HALF];   /* Q7 */
+  WebRtc_Word16  fim[FRAMESAMPLES_HALF];   /* Q7 */
+  double       lpcGains[SUBFRAMES<<1];
+  transcode_obj transcodingParam;
+} ISACUBAnalysisStruct;
+
+
 typedef struct {
 
   Bitstr                  bitstr_obj;
@@ -361,6 +392,7 @@ typedef struct {
   PreFiltBankstr          prefiltbankstr_obj;
   FFTstr                  fftstr_obj;
   ISACUBSaveEncDataStruct SaveEnc_obj;
+  ISACUBAnalysisStruct    analysis_obj;
 
   int                     buffer_index;
   float                   data_buffer_float[MAX_FRAMESAMPLES +
@@ -413,24 +445,6 @@ typedef struct {
   ISACUBDecStruct ISACdecUB_obj;
 } ISACUBStruct;
 
-/*
-  This struct is used to take a snapshot of the entropy coder and LPC gains
-  right before encoding LPC gains. This allows us to go back to that state
-  if we like to limit the payload size.
-*/
-typedef struct {
-  /* 6 lower-band & 6 upper-band */
-  double       loFiltGain[SUBFRAMES];
-  double       hiFiltGain[SUBFRAMES];
-  /* Upper boundary of interval W */
-  WebRtc_UWord32 W_upper;
-  WebRtc_UWord32 streamval;
-  /* Index to the current position in bytestream */
-  WebRtc_UWord32 stream_index;
-  WebRtc_UWord8  stream[3];
-} transcode_obj;
-
-
 typedef struct {
   // lower-band codec instance
   ISACLBStruct              instLB;
@@ -473,6 +487,14 @@ typedef struct {
   WebRtc_Word16               maxRateBytesPer30Ms;
   // Maximum allowed payload-size, measured in Bytes.
   WebRtc_Word16               maxPayloadSizeBytes;
+
+  // Worker running the upper-band analysis, c.f.
+  // WebRtcIsac_SetEncoderWorker(), and the input and result of the analysis.
+  IsacStartTask             startTaskEnc;
+  IsacWaitTask              waitTaskEnc;
+  void*                     workerEnc;
+  WebRtc_Word16               jitterInfoUB;
+  int                       statusUB;
 } ISACMainStruct;
 
 #endif /* WEBRTC_MODULES_AUDIO_CODING_CODECS_ISAC_MAIN_SOURCE_STRUCTS_H_ */
@@ -609,6 +609,32 @@ public:
         CodecInst& currRcvCodec) const = 0;
 
 
+    ///////////////////////////////////////////////////////////////////////////
+    // WebRtc_Word32 SetDecoderOnDemand()
+    // Configure on-demand decoders, e.g. to keep the memory of idle channels
+    // low on a server. When enabled, the decoder of a mono codec registered
+    // by RegisterReceiveCodec() is created when the first packet with its
+    // payload type arrives, instead of at registration. CNG, AVT and RED are
+    // always created at registration. Codecs registered before the call are
+    // not affected.
+    //
+    // Inputs:
+    //   -enable             : if true, create decoders on demand.
+    //   -idleReleaseMs      : release an on-demand decoder, and free the codec
+    //                         if it is not used for sending, when no packet
+    //                         for it has arrived during this much playout.
+    //                         It is created again by the next packet. Zero
+    //                         keeps the decoders, otherwise at least 1000.
+    //
+    // Return value:
+    //   -1 if failed to configure,
+    //    0 if succeeded.
+    //
+    virtual WebRtc_Word32 SetDecoderOnDemand(
+        const bool           enable,
+        const WebRtc_UWord32 idleReleaseMs = 0) = 0;
+
+
     ///////////////////////////////////////////////////////////////////////////
     // WebRtc_Word32 IncomingPacket()
     // Call this function to insert a parsed RTP packet into ACM.
@@ -977,6 +1003,26 @@ public:
     virtual WebRtc_Word32 SetISACMaxPayloadSize(
         const WebRtc_UWord16 maxPayloadLenBytes) = 0;
 
+    ///////////////////////////////////////////////////////////////////////////
+    // WebRtc_Word32 SetISACPipelinedEncoding()
+    // Run the upper-band analysis of the super-wideband iSAC encoder on a
+    // worker thread, while the lower-band is analyzed and entropy coded on
+    // the thread calling Process(). The payloads are the same as without the
+    // worker and no delay is added, but Process() returns sooner, so more
+    // channels can be encoded by one thread. The setting is kept by the iSAC
+    // encoder until it is disabled or InitializeSender() is called.
+    //
+    // Input:
+    //   -enable             : true to encode with a worker thread, false to
+    //                         encode on the calling thread only.
+    //
+    // Return value:
+    //   -1 if failed, e.g. the send-codec is not floating-point iSAC.
+    //    0 if succeeded.
+    //
+    virtual WebRtc_Word32 SetISACPipelinedEncoding(
+        const bool enable) = 0;
+
 
     ///////////////////////////////////////////////////////////////////////////
     // WebRtc_Word32 ConfigISACBandwidthEstimator()
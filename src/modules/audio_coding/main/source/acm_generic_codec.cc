@@ -1488,6 +1488,15 @@ ACMGenericCodec::SetISACMaxRate(
         "The send-codec is not iSAC, failed to set iSAC max rate.");
     return -1;
 }
+
+WebRtc_Word32
+ACMGenericCodec::SetISACPipelinedEncoding(
+    const bool /* enable */)
+{
+    WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceAudioCoding, _uniqueID, 
+        "The send-codec is not iSAC, failed to set iSAC pipelined encoding.");
+    return -1;
+}
  
 WebRtc_Word32
 ACMGenericCodec::SetISACMaxPayloadSize(
@@ -757,6 +757,22 @@ public:
     //
     virtual WebRtc_Word32 SetISACMaxRate(
         const WebRtc_UWord32 maxRateBitPerSec);
+
+
+    ///////////////////////////////////////////////////////////////////////////
+    // SetISACPipelinedEncoding()
+    // Run the upper-band analysis of super-wideband iSAC on a worker thread,
+    // c.f. AudioCodingModule::SetISACPipelinedEncoding().
+    //
+    // Input:
+    //   -enable             : true to encode with a worker thread.
+    //
+    // Return value:
+    //   -1 if failed.
+    //    0 if succeeded.
+    //
+    virtual WebRtc_Word32 SetISACPipelinedEncoding(
+        const bool enable);
     
 
     ///////////////////////////////////////////////////////////////////////////
@@ -8,10 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
+
 #include "acm_codec_database.h"
 #include "acm_common_defs.h"
 #include "acm_isac.h"
 #include "acm_neteq.h"
+#include "event_wrapper.h"
+#include "thread_wrapper.h"
 #include "trace.h"
 #include "webrtc_neteq.h"
 #include "webrtc_neteq_help_macros.h"
@@ -37,6 +41,141 @@ struct ACMISACInst
 {
     ACM_ISAC_STRUCT *inst;
 };
+
+// Thread running one task at a time for the iSAC encoder, c.f.
+// WebRtcIsac_SetEncoderWorker().
+class ACMISACEncoderWorker
+{
+public:
+    static ACMISACEncoderWorker* Create(WebRtc_Word32 id);
+    // Stop() must have succeeded.
+    ~ACMISACEncoderWorker();
+
+    // Stops the thread. Returns false if it could not be stopped; the thread
+    // may then still use the worker, which must be leaked.
+    bool Stop();
+
+    // Signatures of IsacStartTask and IsacWaitTask.
+    static int StartTask(
+        void* worker,
+        void  (*task)(void*),
+        void* arg);
+    static void WaitTask(
+        void* worker);
+
+private:
+    ACMISACEncoderWorker(WebRtc_Word32 id);
+
+    static bool Run(ThreadObj obj);
+    bool Process();
+
+    WebRtc_Word32  _id;
+    ThreadWrapper* _thread;
+    EventWrapper*  _startEvent;
+    EventWrapper*  _doneEvent;
+    void           (*_task)(void*);
+    void*          _arg;
+};
+
+ACMISACEncoderWorker::ACMISACEncoderWorker(WebRtc_Word32 id):
+_id(id),
+_thread(NULL),
+_startEvent(EventWrapper::Create()),
+_doneEvent(EventWrapper::Create()),
+_task(NULL),
+_arg(NULL)
+{
+}
+
+ACMISACEncoderWorker*
+ACMISACEncoderWorker::Create(WebRtc_Word32 id)
+{
+    ACMISACEncoderWorker* worker = new ACMISACEncoderWorker(id);
+    if((worker->_startEvent == NULL) || (worker->_doneEvent == NULL))
+    {
+        delete worker;
+        return NULL;
+    }
+    worker->_thread = ThreadWrapper::CreateThread(Run, worker,
+        kNormalPriority, "ACMISACEncoderWorker");
+    unsigned int threadId;
+    if((worker->_thread == NULL) || !worker->_thread->Start(threadId))
+    {
+        delete worker;
+        return NULL;
+    }
+    return worker;
+}
+
+ACMISACEncoderWorker::~ACMISACEncoderWorker()
+{
+    Stop();
+    assert(_thread == NULL);
+    delete _startEvent;
+    delete _doneEvent;
+}
+
+bool
+ACMISACEncoderWorker::Stop()
+{
+    if(_thread == NULL)
+    {
+        return true;
+    }
+    _thread->SetNotAlive();
+    _task = NULL;
+    _startEvent->Set();
+    if(!_thread->Stop())
+    {
+        WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceAudioCoding, _id,
+            "Could not stop the iSAC encoder worker thread.");
+        return false;
+    }
+    delete _thread;
+    _thread = NULL;
+    return true;
+}
+
+int
+ACMISACEncoderWorker::StartTask(
+    void* worker,
+    void  (*task)(void*),
+    void* arg)
+{
+    ACMISACEncoderWorker* self = static_cast<ACMISACEncoderWorker*>(worker);
+    self->_task = task;
+    self->_arg = arg;
+    return self->_startEvent->Set()? 0:-1;
+}
+
+void
+ACMISACEncoderWorker::WaitTask(
+    void* worker)
+{
+    static_cast<ACMISACEncoderWorker*>(worker)->_doneEvent->Wait(
+        WEBRTC_EVENT_INFINITE);
+}
+
+bool
+ACMISACEncoderWorker::Run(
+    ThreadObj obj)
+{
+    return static_cast<ACMISACEncoderWorker*>(obj)->Process();
+}
+
+bool
+ACMISACEncoderWorker::Process()
+{
+    // The events order the accesses to the task with StartTask() and
+    // WaitTask().
+    if((_startEvent->Wait(WEBRTC_EVENT_INFINITE) == kEventSignaled) &&
+        (_task != NULL))
+    {
+        _task(_arg);
+        _doneEvent->Set();
+    }
+    return true;
+}
 #endif
 
 #define ISAC_MIN_RATE 10000
@@ -299,6 +438,13 @@ ACMISAC::SetISACMaxRate(
     return -1;
 }
 
+WebRtc_Word32
+ACMISAC::SetISACPipelinedEncoding(
+    const bool /* enable */)
+{
+    return -1;
+}
+
 
 void 
 ACMISAC::UpdateFrameLen()
@@ -460,7 +606,8 @@ ACMISACFixGetDecSampRate(
 
 ACMISAC::ACMISAC(
     WebRtc_Word16 codecID):
-_codecInstPtr(NULL)
+_codecInstPtr(NULL),
+_encoderWorker(NULL)
 {
     _codecInstPtr = new ACMISACInst;
     if (_codecInstPtr == NULL)
@@ -483,6 +630,7 @@ ACMISAC::~ACMISAC()
 {
     if (_codecInstPtr != NULL)
     {
+        RemoveEncoderWorker();
         if(_codecInstPtr->inst != NULL)
         {
             ACM_ISAC_FREE(_codecInstPtr->inst);
@@ -680,6 +828,7 @@ ACMISAC::InternalCreateDecoder()
     else
     {
         _encoderExist = true;
+        SetEncoderWorker();
     }
     return status;
 }
@@ -712,6 +861,7 @@ ACMISAC::InternalCreateEncoder()
     else
     {
         _decoderExist = true;
+        SetEncoderWorker();
     }
     return status;
 }
@@ -722,6 +872,7 @@ ACMISAC::DestructEncoderSafe()
 {
     // codec with shared instance cannot delete.
     _encoderInitialized = false;
+    RemoveEncoderWorker();
     return;
 }
 
@@ -1159,6 +1310,70 @@ ACMISAC::SetISACMaxRate(
     return ACM_ISAC_SETMAXRATE(_codecInstPtr->inst, maxRateBitPerSec);
 }
 
+WebRtc_Word32
+ACMISAC::SetISACPipelinedEncoding(
+    const bool enable)
+{
+#ifdef WEBRTC_CODEC_ISAC
+    if(!enable)
+    {
+        RemoveEncoderWorker();
+        return 0;
+    }
+    if(_encoderWorker == NULL)
+    {
+        _encoderWorker = ACMISACEncoderWorker::Create(_uniqueID);
+        if(_encoderWorker == NULL)
+        {
+            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _uniqueID,
+                "Could not start the iSAC encoder worker thread.");
+            return -1;
+        }
+    }
+    return SetEncoderWorker();
+#else
+    // The fixed-point iSAC has no worker support.
+    return enable? -1:0;
+#endif
+}
+
+WebRtc_Word32
+ACMISAC::SetEncoderWorker()
+{
+#ifdef WEBRTC_CODEC_ISAC
+    if((_codecInstPtr->inst == NULL) || (_encoderWorker == NULL))
+    {
+        return 0;
+    }
+    return WebRtcIsac_SetEncoderWorker(_codecInstPtr->inst,
+        ACMISACEncoderWorker::StartTask, ACMISACEncoderWorker::WaitTask,
+        _encoderWorker);
+#else
+    return 0;
+#endif
+}
+
+void
+ACMISAC::RemoveEncoderWorker()
+{
+    if(_encoderWorker == NULL)
+    {
+        return;
+    }
+#ifdef WEBRTC_CODEC_ISAC
+    if(_codecInstPtr->inst != NULL)
+    {
+        WebRtcIsac_SetEncoderWorker(_codecInstPtr->inst, NULL, NULL, NULL);
+    }
+#endif
+    // A thread which failed to stop may still use the worker.
+    if(_encoderWorker->Stop())
+    {
+        delete _encoderWorker;
+    }
+    _encoderWorker = NULL;
+}
+
 
 void 
 ACMISAC::UpdateFrameLen()
@@ -17,6 +17,7 @@ namespace webrtc
 {
 
 struct ACMISACInst;
+class ACMISACEncoderWorker;
 
 enum iSACCodingMode {ADAPTIVE, CHANNEL_INDEPENDENT};
 
@@ -76,6 +77,9 @@ public:
     WebRtc_Word32 SetISACMaxRate(
         const WebRtc_UWord32 maxRateBitPerSec);
 
+    WebRtc_Word32 SetISACPipelinedEncoding(
+        const bool enable);
+
     WebRtc_Word16 REDPayloadISAC(
         const WebRtc_Word32  isacRate,
         const WebRtc_Word16  isacBwEstimate,
@@ -138,7 +142,13 @@ protected:
     void SaveDecoderParamSafe(
         const WebRtcACMCodecParams* codecParams);
 
+    // Give the worker, if any, to the current iSAC instance.
+    WebRtc_Word32 SetEncoderWorker();
+
+    void RemoveEncoderWorker();
+
     ACMISACInst* _codecInstPtr;
+    ACMISACEncoderWorker* _encoderWorker;
 
     bool                  _isEncInitialized;
     iSACCodingMode        _isacCodingMode;
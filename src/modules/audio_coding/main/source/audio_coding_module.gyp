@@ -128,6 +128,17 @@
         }],
       ],
     },
+    {
+      'target_name': 'isac_encoder_benchmark',
+      'type': 'executable',
+      'dependencies': [
+        'audio_coding_module',
+        '../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'sources': [
+        '../test/ISACEncoderBenchmark.cpp',
+      ],
+    },
   ],
 }
 
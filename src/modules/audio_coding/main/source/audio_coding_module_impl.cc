@@ -65,6 +65,8 @@ AudioCodingModuleImpl::AudioCodingModuleImpl(
     _lastFECTimestamp(0),
     _receiveREDPayloadType(255),  // invalid value
     _previousPayloadType(255),
+    _decoderOnDemand(false),
+    _decoderIdleReleaseMs(0),
     _dummyRTPHeader(NULL),
     _receiverInitialized(false),
     _dtmfDetector(NULL),
@@ -84,6 +86,9 @@ AudioCodingModuleImpl::AudioCodingModuleImpl(
         _stereoReceive[i]     = false;
         _slaveCodecs[i]       = NULL;
         _mirrorCodecIdx[i]    = -1;
+        _onDemandCodec[i]     = false;
+        _decoderPending[i]    = false;
+        _decoderIdleMs[i]     = 0;
     }
 
     _netEq.SetUniqueId(_id);
@@ -1531,6 +1536,21 @@ AudioCodingModuleImpl::RegisterReceiveCodec(
         }
     }
 
+    if(_decoderOnDemand && (receiveCodec.channels == 1) &&
+        STR_CASE_CMP(receiveCodec.plname, "CN") &&
+        STR_CASE_CMP(receiveCodec.plname, "telephone-event") &&
+        STR_CASE_CMP(receiveCodec.plname, "red"))
+    {
+        // The decoder is created by the first packet, in
+        // CreateDecoderOnDemandSafe().
+        memcpy(&_onDemandCodecInst[codecId], &receiveCodec, sizeof(CodecInst));
+        _onDemandCodec[codecId] = true;
+        _decoderPending[codecId] = true;
+        _stereoReceive[codecId] = false;
+        _registeredPlTypes[codecId] = receiveCodec.pltype;
+        return 0;
+    }
+
     if(RegisterRecCodecMSSafe(receiveCodec, codecId, mirrorId,
         ACMNetEQ::masterJB) < 0)
     {
@@ -1679,6 +1699,154 @@ AudioCodingModuleImpl::RegisterRecCodecMSSafe(
 
 
 
+// Configure creation of decoders at the first packet, and release of idle
+// decoders
+WebRtc_Word32
+AudioCodingModuleImpl::SetDecoderOnDemand(
+    const bool           enable,
+    const WebRtc_UWord32 idleReleaseMs)
+{
+    WEBRTC_TRACE(webrtc::kTraceModuleCall, webrtc::kTraceAudioCoding, _id,
+        "SetDecoderOnDemand()");
+    CriticalSectionScoped lock(*_acmCritSect);
+
+    // Packets of the codec still in the jitter buffer would be discarded.
+    if((idleReleaseMs > 0) && (idleReleaseMs < 1000))
+    {
+        WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+            "Idle time before releasing a decoder must be at least 1000 ms.");
+        return -1;
+    }
+    _decoderOnDemand = enable;
+    _decoderIdleReleaseMs = idleReleaseMs;
+    return 0;
+}
+
+
+// Create and register in NetEq the decoder of an on-demand receive codec,
+// if the payload type belongs to one.
+WebRtc_Word32
+AudioCodingModuleImpl::CreateDecoderOnDemandSafe(
+    const WebRtc_UWord8 payloadType)
+{
+    WebRtc_Word16 codecCntr;
+    for(codecCntr = 0; codecCntr < MAX_NR_OF_CODECS; codecCntr++)
+    {
+        if(_registeredPlTypes[codecCntr] == payloadType)
+        {
+            break;
+        }
+    }
+    if((codecCntr == MAX_NR_OF_CODECS) || !_onDemandCodec[codecCntr])
+    {
+        return 0;
+    }
+
+    WebRtc_Word16 mirrorID = ACMCodecDB::MirrorID(codecCntr);
+    for(WebRtc_Word16 i = 0; i < MAX_NR_OF_CODECS; i++)
+    {
+        if(_onDemandCodec[i] && (ACMCodecDB::MirrorID(i) == mirrorID))
+        {
+            _decoderIdleMs[i] = 0;
+        }
+    }
+
+    if(_decoderPending[codecCntr])
+    {
+        if(RegisterRecCodecMSSafe(_onDemandCodecInst[codecCntr], codecCntr,
+            mirrorID, ACMNetEQ::masterJB) < 0)
+        {
+            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, _id,
+                "Cannot create the decoder for payload type %d.", payloadType);
+            return -1;
+        }
+        _decoderPending[codecCntr] = false;
+        // Make IncomingPacket() update the sampling frequency of the new
+        // decoder.
+        _lastRecvAudioCodecPlType = 255;
+    }
+    return 0;
+}
+
+
+// Called every 10 ms of playout.
+void
+AudioCodingModuleImpl::ReleaseIdleDecodersSafe()
+{
+    if(_decoderIdleReleaseMs == 0)
+    {
+        return;
+    }
+    for(WebRtc_Word16 codecCntr = 0; codecCntr < MAX_NR_OF_CODECS; codecCntr++)
+    {
+        if(_onDemandCodec[codecCntr] && !_decoderPending[codecCntr])
+        {
+            _decoderIdleMs[codecCntr] += 10;
+            if(_decoderIdleMs[codecCntr] >= _decoderIdleReleaseMs)
+            {
+                if(ReleaseDecoderSafe(ACMCodecDB::MirrorID(codecCntr)) < 0)
+                {
+                    // Keep the decoder, and try again after another idle
+                    // period.
+                    _decoderIdleMs[codecCntr] = 0;
+                }
+            }
+        }
+    }
+}
+
+
+// Unregister the on-demand codecs sharing the decoder of mirrorID from NetEq
+// and make them pending again. The codec is deleted unless it is used for
+// sending. Decoders shared with a codec which is not on demand are kept.
+WebRtc_Word32
+AudioCodingModuleImpl::ReleaseDecoderSafe(
+    const WebRtc_Word16 mirrorID)
+{
+    WebRtc_Word16 codecCntr;
+    for(codecCntr = 0; codecCntr < MAX_NR_OF_CODECS; codecCntr++)
+    {
+        if((ACMCodecDB::MirrorID(codecCntr) == mirrorID) &&
+            (_registeredPlTypes[codecCntr] != -1) && !_onDemandCodec[codecCntr])
+        {
+            return -1;
+        }
+    }
+
+    for(codecCntr = 0; codecCntr < MAX_NR_OF_CODECS; codecCntr++)
+    {
+        if((ACMCodecDB::MirrorID(codecCntr) == mirrorID) &&
+            _onDemandCodec[codecCntr] && !_decoderPending[codecCntr])
+        {
+            WebRtc_Word16 payloadType = _registeredPlTypes[codecCntr];
+            if(UnregisterReceiveCodecSafe(codecCntr) < 0)
+            {
+                return -1;
+            }
+            _onDemandCodec[codecCntr] = true;
+            _decoderPending[codecCntr] = true;
+            _registeredPlTypes[codecCntr] = payloadType;
+        }
+    }
+
+    if((_codecs[mirrorID] != NULL) && !(_sendCodecRegistered &&
+        (_mirrorCodecIdx[_currentSendCodecIdx] == mirrorID)))
+    {
+        delete _codecs[mirrorID];
+        for(codecCntr = 0; codecCntr < MAX_NR_OF_CODECS; codecCntr++)
+        {
+            if(_mirrorCodecIdx[codecCntr] == mirrorID)
+            {
+                _codecs[codecCntr] = NULL;
+                _mirrorCodecIdx[codecCntr] = -1;
+            }
+        }
+    }
+    WEBRTC_TRACE(webrtc::kTraceStateInfo, webrtc::kTraceAudioCoding, _id,
+        "Released idle decoder %d.", mirrorID);
+    return 0;
+}
+
 // Get current received codec
 WebRtc_Word32 
 AudioCodingModuleImpl::ReceiveCodec(
@@ -1755,6 +1923,11 @@ AudioCodingModuleImpl::IncomingPacket(
             myPayloadType = rtpInfo.header.payloadType;
         }
 
+        if(CreateDecoderOnDemandSafe(myPayloadType) < 0)
+        {
+            return -1;
+        }
+
         // If payload is audio, check if received payload is different from previous
         if((!rtpInfo.type.Audio.isCNG)       &&
             (myPayloadType != _cngNB.pltype) &&
@@ -1899,7 +2072,9 @@ AudioCodingModuleImpl::DecoderEstimatedBandwidth() const
         return -1;
     }
 
-    if ((_lastRecvAudioCodecPlType == plTypWB) || (_lastRecvAudioCodecPlType == plTypSWB))
+    // The decoder may have been released, see SetDecoderOnDemand().
+    if ((_codecs[codecID] != NULL) &&
+        ((_lastRecvAudioCodecPlType == plTypWB) || (_lastRecvAudioCodecPlType == plTypSWB)))
     {
         return _codecs[codecID]->GetEstimatedBandwidth();
     } else {
@@ -1973,6 +2148,8 @@ AudioCodingModuleImpl::PlayoutData10Ms(
     {
         CriticalSectionScoped lock(*_acmCritSect);
 
+        ReleaseIdleDecodersSafe();
+
         if ((recvFreq != desiredFreqHz) && (desiredFreqHz != -1))
         {   
             // resample payloadData
@@ -2267,6 +2444,14 @@ AudioCodingModuleImpl::IncomingPayload(
         return -1;
     }
 
+    {
+        CriticalSectionScoped lock(*_acmCritSect);
+        if(CreateDecoderOnDemandSafe(payloadType) < 0)
+        {
+            return -1;
+        }
+    }
+
     if(_dummyRTPHeader == NULL)
     {
         // This is the first time that we are using _dummyRTPHeader
@@ -2503,6 +2688,22 @@ AudioCodingModuleImpl::SetISACMaxPayloadSize(
     return _codecs[_currentSendCodecIdx]->SetISACMaxPayloadSize(maxPayloadLenBytes);
 }
 
+WebRtc_Word32 
+AudioCodingModuleImpl::SetISACPipelinedEncoding(
+    const bool enable)
+{
+    WEBRTC_TRACE(webrtc::kTraceModuleCall, webrtc::kTraceAudioCoding, _id, 
+        "SetISACPipelinedEncoding()");
+    CriticalSectionScoped lock(*_acmCritSect);
+
+    if(!HaveValidEncoder("SetISACPipelinedEncoding"))
+    {
+        return -1;
+    }
+
+    return _codecs[_currentSendCodecIdx]->SetISACPipelinedEncoding(enable);
+}
+
 WebRtc_Word32 
 AudioCodingModuleImpl::ConfigISACBandwidthEstimator(
     const WebRtc_UWord8  initFrameSizeMsec,
@@ -2631,6 +2832,14 @@ AudioCodingModuleImpl::UnregisterReceiveCodecSafe(
 {
     WebRtcNetEQDecoder *neteqDecoder = ACMCodecDB::NetEqDecoders();
     WebRtc_Word16 mirrorID = ACMCodecDB::MirrorID(codecID);
+    _onDemandCodec[codecID] = false;
+    if(_decoderPending[codecID])
+    {
+        // Neither created nor registered in NetEq.
+        _decoderPending[codecID] = false;
+        _registeredPlTypes[codecID] = -1;
+        return 0;
+    }
     if(_codecs[codecID] != NULL)
     {
         if(_registeredPlTypes[codecID] != -1)
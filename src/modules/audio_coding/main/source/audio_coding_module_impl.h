@@ -192,6 +192,12 @@ public:
     WebRtc_Word32 ReceiveCodec(
         CodecInst& currentReceiveCodec) const;
 
+    // configure creation of decoders at the first packet, and release
+    // of idle decoders
+    WebRtc_Word32 SetDecoderOnDemand(
+        const bool           enable,
+        const WebRtc_UWord32 idleReleaseMs = 0);
+
     // incoming packet from network parsed and ready for decode
     WebRtc_Word32 IncomingPacket( 
         const WebRtc_Word8*    incomingPayload,
@@ -288,6 +294,9 @@ public:
     WebRtc_Word32 SetISACMaxPayloadSize(
         const WebRtc_UWord16 payloadLenBytes);
 
+    WebRtc_Word32 SetISACPipelinedEncoding(
+        const bool enable);
+
     WebRtc_Word32 ConfigISACBandwidthEstimator(
         const WebRtc_UWord8  initFrameSizeMsec,
         const WebRtc_UWord16 initRateBitPerSec,
@@ -323,6 +332,14 @@ protected:
         WebRtc_Word16         mirrorId,
         ACMNetEQ::JB          jitterBuffer);
 
+    WebRtc_Word32 CreateDecoderOnDemandSafe(
+        const WebRtc_UWord8 payloadType);
+
+    void ReleaseIdleDecodersSafe();
+
+    WebRtc_Word32 ReleaseDecoderSafe(
+        const WebRtc_Word16 mirrorID);
+
 private:
     AudioPacketizationCallback*    _packetizationCallback;
     WebRtc_Word32                  _id;
@@ -372,6 +389,17 @@ private:
     // unused elements. 
     WebRtc_Word16                  _registeredPlTypes[MAX_NR_OF_CODECS];
 
+    // Receive codecs registered while _decoderOnDemand is set, see
+    // SetDecoderOnDemand(). A pending codec is registered in ACM but its
+    // decoder is not created, nor registered in NetEq. The idle time is
+    // counted for the codecs sharing a decoder together.
+    bool                           _decoderOnDemand;
+    WebRtc_UWord32                 _decoderIdleReleaseMs;
+    bool                           _onDemandCodec[MAX_NR_OF_CODECS];
+    bool                           _decoderPending[MAX_NR_OF_CODECS];
+    CodecInst                      _onDemandCodecInst[MAX_NR_OF_CODECS];
+    WebRtc_UWord32                 _decoderIdleMs[MAX_NR_OF_CODECS];
+
     // Used when payloads are pushed into ACM without any RTP info
     // One example is when pre-encoded bit-stream is pushed from
     // a file.
@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Encodes a number of iSAC-SWB channels on one thread, the way a mixer calls
+// Add10MsData() and Process() of one ACM per channel, without and with
+// SetISACPipelinedEncoding(). For both it prints how many channels the
+// encoding thread and how many channels one core can run in real time, i.e.
+// audio time * channels divided by the wall clock and by the CPU time. The
+// payloads of both runs are compared.
+//
+// Usage: isac_encoder_benchmark [channels] [seconds] [32 kHz pcm file]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "audio_coding_module.h"
+#include "module_common_types.h"
+#include "tick_util.h"
+
+using namespace webrtc;
+
+namespace
+{
+
+const WebRtc_Word32 kSampFreqHz = 32000;
+const WebRtc_Word16 kSamples10Ms = 320;
+
+// Counts the payload bytes of one channel and keeps a checksum of them.
+class PayloadChecksum : public AudioPacketizationCallback
+{
+public:
+    PayloadChecksum()
+        : _bytes(0),
+          _checksum(2166136261u)
+    {
+    }
+
+    WebRtc_Word32 SendData(
+        FrameType               /* frameType */,
+        WebRtc_UWord8           /* payloadType */,
+        WebRtc_UWord32          /* timeStamp */,
+        const WebRtc_UWord8*          payloadData,
+        WebRtc_UWord16          payloadSize,
+        const RTPFragmentationHeader* /* fragmentation */)
+    {
+        for(int n = 0; n < payloadSize; n++)
+        {
+            _checksum = (_checksum ^ payloadData[n]) * 16777619u;
+        }
+        _bytes += payloadSize;
+        return 0;
+    }
+
+    WebRtc_UWord64 _bytes;
+    WebRtc_UWord32 _checksum;
+};
+
+struct RunResult
+{
+    double wallSec;
+    double cpuSec;
+    WebRtc_UWord64 bytes;
+    std::vector<WebRtc_UWord32> checksums;
+};
+
+bool ReadFile(const char* fileName, std::vector<WebRtc_Word16>& audio)
+{
+    FILE* file = fopen(fileName, "rb");
+    if(file == NULL)
+    {
+        printf("Unable to open %s\n", fileName);
+        return false;
+    }
+    WebRtc_Word16 buffer[kSamples10Ms];
+    while(fread(buffer, sizeof(WebRtc_Word16), kSamples10Ms, file) ==
+        (size_t)kSamples10Ms)
+    {
+        audio.insert(audio.end(), buffer, buffer + kSamples10Ms);
+    }
+    fclose(file);
+    return true;
+}
+
+// Speech-like test signal with energy in both bands.
+void GenerateAudio(int numFrames, std::vector<WebRtc_Word16>& audio)
+{
+    unsigned int seed = 1;
+    audio.resize(numFrames * kSamples10Ms);
+    for(size_t n = 0; n < audio.size(); n++)
+    {
+        seed = seed * 1103515245 + 12345;
+        const int noise = (int)((seed >> 16) % 2001) - 1000;
+        const int period = 64 + (int)((n / 4800) % 5) * 16;
+        const int pulse = ((n % period) < 4)? 6000:0;
+        audio[n] = (WebRtc_Word16)(pulse + noise * (1 + (int)((n / 1600) % 3)));
+    }
+}
+
+bool Run(int numChannels, bool pipelined,
+    const std::vector<WebRtc_Word16>& audio, RunResult& result)
+{
+    CodecInst codec;
+    if(AudioCodingModule::Codec("ISAC", codec, kSampFreqHz) < 0)
+    {
+        printf("iSAC-SWB is not supported\n");
+        return false;
+    }
+    codec.rate = 56000;
+
+    std::vector<AudioCodingModule*> acms(numChannels);
+    std::vector<PayloadChecksum> callbacks(numChannels);
+    bool ok = true;
+    for(int c = 0; c < numChannels; c++)
+    {
+        acms[c] = AudioCodingModule::Create(c);
+        if((acms[c] == NULL) ||
+            (acms[c]->RegisterSendCodec(codec) < 0) ||
+            (acms[c]->RegisterTransportCallback(&callbacks[c]) < 0) ||
+            (pipelined && (acms[c]->SetISACPipelinedEncoding(true) < 0)))
+        {
+            printf("Unable to set up channel %d\n", c);
+            ok = false;
+            break;
+        }
+    }
+
+    AudioFrame frame;
+    frame._payloadDataLengthInSamples = kSamples10Ms;
+    frame._frequencyInHz = kSampFreqHz;
+    frame._audioChannel = 1;
+    frame._timeStamp = 0;
+
+    const int numFrames = (int)(audio.size() / kSamples10Ms);
+    const TickTime startTime = TickTime::Now();
+    const clock_t startCpu = clock();
+    for(int i = 0; ok && (i < numFrames); i++)
+    {
+        memcpy(frame._payloadData, &audio[i * kSamples10Ms],
+            kSamples10Ms * sizeof(WebRtc_Word16));
+        for(int c = 0; c < numChannels; c++)
+        {
+            if((acms[c]->Add10MsData(frame) < 0) || (acms[c]->Process() < 0))
+            {
+                printf("Encoding failed on channel %d\n", c);
+                ok = false;
+                break;
+            }
+        }
+        frame._timeStamp += kSamples10Ms;
+    }
+    result.cpuSec = (double)(clock() - startCpu) / CLOCKS_PER_SEC;
+    result.wallSec = (TickTime::Now() - startTime).Milliseconds() / 1000.0;
+
+    result.bytes = 0;
+    result.checksums.clear();
+    for(int c = 0; c < numChannels; c++)
+    {
+        result.bytes += callbacks[c]._bytes;
+        result.checksums.push_back(callbacks[c]._checksum);
+        if(acms[c] != NULL)
+        {
+            AudioCodingModule::Destroy(acms[c]);
+        }
+    }
+    return ok;
+}
+
+void Print(const char* name, int numChannels, double audioSec,
+    const RunResult& result)
+{
+    printf("%-10s %7.2f s wall %7.2f s CPU %6.1f channels/thread "
+        "%6.1f channels/core %8.1f kbps/channel\n", name, result.wallSec,
+        result.cpuSec,
+        (result.wallSec > 0)? numChannels * audioSec / result.wallSec:0.0,
+        (result.cpuSec > 0)? numChannels * audioSec / result.cpuSec:0.0,
+        result.bytes * 8 / (audioSec * numChannels * 1000));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    const int numChannels = (argc > 1)? atoi(argv[1]):8;
+    const int seconds = (argc > 2)? atoi(argv[2]):10;
+    if((numChannels < 1) || (seconds < 1))
+    {
+        printf("Usage: %s [channels] [seconds] [32 kHz pcm file]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<WebRtc_Word16> audio;
+    if(argc > 3)
+    {
+        if(!ReadFile(argv[3], audio))
+        {
+            return 1;
+        }
+        audio.resize(audio.size() < (size_t)seconds * 100 * kSamples10Ms?
+            audio.size():(size_t)seconds * 100 * kSamples10Ms);
+    }
+    else
+    {
+        GenerateAudio(seconds * 100, audio);
+    }
+    const double audioSec = (double)audio.size() / kSampFreqHz;
+    if(audioSec == 0)
+    {
+        printf("Too short input\n");
+        return 1;
+    }
+
+    printf("%d iSAC-SWB channels at 56 kbps, %.1f s of audio\n", numChannels,
+        audioSec);
+    RunResult serial;
+    RunResult pipelined;
+    if(!Run(numChannels, false, audio, serial) ||
+        !Run(numChannels, true, audio, pipelined))
+    {
+        return 1;
+    }
+    Print("serial", numChannels, audioSec, serial);
+    Print("pipelined", numChannels, audioSec, pipelined);
+
+    if(serial.checksums != pipelined.checksums)
+    {
+        printf("The payloads differ\n");
+        return 1;
+    }
+    printf("The payloads are identical\n");
+    return 0;
+}
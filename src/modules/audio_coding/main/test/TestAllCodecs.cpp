@@ -647,6 +647,7 @@ void TestAllCodecs::Perform()
     Run(_channelA2B);
     _outFileB.Close();
 #endif
+    TestDecoderOnDemand();
 
     if(_testMode != 0) {
         printf("=======================================================================\n");
@@ -776,6 +777,127 @@ WebRtc_Word16 TestAllCodecs::RegisterSendCodec(char side,
     return 0;
 }
 
+// Tests the decoders created on demand and released when idle, see
+// AudioCodingModule::SetDecoderOnDemand(). iSAC WB and SWB share a decoder.
+void TestAllCodecs::TestDecoderOnDemand()
+{
+#ifdef WEBRTC_CODEC_ISAC
+    if(_testMode != 0) {
+        printf("=======================================================================\n");
+        printf("On-demand decoders\n");
+    } else {
+        printf(".");
+    }
+
+    AudioCodingModule* receiveACM = AudioCodingModule::Create(2);
+    CHECK_ERROR(receiveACM->InitializeReceiver());
+    CHECK_ERROR(receiveACM->SetDecoderOnDemand(true, 1000));
+    CodecInst myCodecParam;
+    for(WebRtc_UWord8 n = 0; n < receiveACM->NumberOfCodecs(); n++)
+    {
+        receiveACM->Codec(n, myCodecParam);
+        receiveACM->RegisterReceiveCodec(myCodecParam);
+    }
+    _channelA2B->RegisterReceiverACM(receiveACM);
+
+    int errorCount = 0;
+    char codecISAC[] = "ISAC";
+    CodecInst receiveCodec;
+
+    // The decoder is created by the first packet, and kept while packets
+    // arrive for longer than the idle time.
+    if(receiveACM->ReceiveCodec(receiveCodec) != -1)
+    {
+        errorCount++;
+    }
+    RegisterSendCodec('A', codecISAC, 16000, -1, 480, -1);
+    if(!RunOnDemand(receiveACM, 200, true) ||
+        (receiveACM->ReceiveCodec(receiveCodec) < 0) ||
+        (receiveCodec.plfreq != 16000))
+    {
+        errorCount++;
+    }
+
+    // Released after 1 s of playout without packets.
+    RunOnDemand(receiveACM, 150, false);
+    if((receiveACM->ReceiveCodec(receiveCodec) != -1) ||
+        (receiveACM->DecoderEstimatedBandwidth() != -1))
+    {
+        errorCount++;
+    }
+
+    // Created again by a SWB packet, and shared with WB.
+    if(_testMode != 0) {
+        printf("\n");
+    }
+    RegisterSendCodec('A', codecISAC, 32000, -1, 960, -1);
+    if(!RunOnDemand(receiveACM, 100, true) ||
+        (receiveACM->ReceiveCodec(receiveCodec) < 0) ||
+        (receiveCodec.plfreq != 32000))
+    {
+        errorCount++;
+    }
+    if(_testMode != 0) {
+        printf("\n");
+    }
+    RegisterSendCodec('A', codecISAC, 16000, -1, 480, -1);
+    if(!RunOnDemand(receiveACM, 100, true) ||
+        (receiveACM->ReceiveCodec(receiveCodec) < 0) ||
+        (receiveCodec.plfreq != 16000))
+    {
+        errorCount++;
+    }
+
+    if (errorCount)
+    {
+        printf(" - test FAILED\n");
+    }
+    else if(_testMode != 0)
+    {
+        printf(" - test PASSED\n");
+    }
+
+    _channelA2B->RegisterReceiverACM(_acmB);
+    AudioCodingModule::Destroy(receiveACM);
+#endif
+}
+
+// Plays out numFrames 10 ms frames from receiveACM, sending a frame from
+// _acmA before each if sendPackets is set. Returns true if the second half
+// of the output is not silent.
+bool TestAllCodecs::RunOnDemand(AudioCodingModule* receiveACM,
+                                int numFrames,
+                                bool sendPackets)
+{
+    AudioFrame audioFrame;
+    bool audible = false;
+
+    for(int n = 0; n < numFrames; n++)
+    {
+        if(sendPackets)
+        {
+            _inFileA.Read10MsData(audioFrame);
+            CHECK_ERROR(_acmA->Add10MsData(audioFrame));
+            CHECK_ERROR(_acmA->Process());
+            if (_inFileA.EndOfFile()) {
+                _inFileA.Rewind();
+            }
+        }
+        CHECK_ERROR(receiveACM->PlayoutData10Ms(32000, audioFrame));
+        if(n >= numFrames / 2)
+        {
+            for(int i = 0; i < audioFrame._payloadDataLengthInSamples; i++)
+            {
+                if(audioFrame._payloadData[i] != 0)
+                {
+                    audible = true;
+                }
+            }
+        }
+    }
+    return audible;
+}
+
 void TestAllCodecs::Run(TestPack* channel)
 {
     AudioFrame audioFrame;
@@ -63,6 +63,9 @@ private:
         int extraByte);
 
     void Run(TestPack* channel);
+    void TestDecoderOnDemand();
+    bool RunOnDemand(AudioCodingModule* receiveACM, int numFrames,
+        bool sendPackets);
     void OpenOutFile(WebRtc_Word16 testNumber);
     void DisplaySendReceiveCodec();
 
@@ -24,7 +24,7 @@ class Trace;
 class AudioConferenceMixer : public Module
 {
 public:
-    enum {kMaximumAmountOfMixedParticipants = 16};
+    enum {kDefaultAmountOfMixedParticipants = 16};
     enum Frequency
     {
         kNbInHz           = 8000,
@@ -73,6 +73,14 @@ public:
     virtual WebRtc_Word32 AmountOfMixables(
         WebRtc_UWord32& amountOfMixableParticipants) = 0;
 
+    // Set the maximum number of participants mixed in each 10 ms frame, by
+    // default kDefaultAmountOfMixedParticipants. The number of mixable
+    // participants is not limited; the loudest participants are mixed.
+    virtual WebRtc_Word32 SetAmountOfMixedParticipants(
+        const WebRtc_UWord32 amountOfMixedParticipants) = 0;
+    virtual WebRtc_Word32 AmountOfMixedParticipants(
+        WebRtc_UWord32& amountOfMixedParticipants) const = 0;
+
     // Set the minimum sampling frequency at which to mix. The mixing algorithm
     // may still choose to mix at a higher samling frequency to avoid
     // downsampling of audio contributing to the mixed audio.
@@ -12,7 +12,6 @@
 #include "audio_conference_mixer_impl.h"
 #include "audio_frame_manipulator.h"
 #include "critical_section_wrapper.h"
-#include "map_wrapper.h"
 #include "trace.h"
 
 namespace webrtc {
@@ -32,7 +31,8 @@ WebRtc_Word32 MixerParticipant::IsMixed(bool& mixed) const
 }
 
 MixHistory::MixHistory()
-    : _isMixed(0)
+    : _isMixed(0),
+      _selected(false)
 {
 }
 
@@ -67,9 +67,13 @@ AudioConferenceMixer* AudioConferenceMixer::CreateAudioConferenceMixer(
 
 AudioConferenceMixerImpl::AudioConferenceMixerImpl(const WebRtc_Word32 id)
     : _scratchParticipantsToMixAmount(0),
-      _scratchMixedParticipants(),
+      _scratchMixedParticipants(NULL),
       _scratchVadPositiveParticipantsAmount(0),
-      _scratchVadPositiveParticipants(),
+      _scratchVadPositiveParticipants(NULL),
+      _mixCandidates(NULL),
+      _mixCandidatesAmount(0),
+      _mixCandidatesCapacity(0),
+      _spareAudioFrame(NULL),
       _crit(CriticalSectionWrapper::CreateCriticalSection()),
       _cbCrit(CriticalSectionWrapper::CreateCriticalSection()),
       _id(id),
@@ -83,6 +87,7 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(const WebRtc_Word32 id)
       _sampleSize((_outputFrequency*kProcessPeriodicityInMs)/1000),
       _participantList(),
       _amountOfMixableParticipants(0),
+      _amountOfMixedParticipants(kDefaultAmountOfMixedParticipants),
       _timeStamp(0),
       _timeScheduler(kProcessPeriodicityInMs),
       _mixedAudioLevel(),
@@ -90,6 +95,8 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(const WebRtc_Word32 id)
 {
     MemoryPool<AudioFrame>::CreateMemoryPool(_audioFramePool,
                                              DEFAULT_AUDIO_FRAME_POOLSIZE);
+    ResizeMixCandidates(kDefaultAmountOfMixedParticipants);
+    _spareAudioFrame = new AudioFrame();
     WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id, "%s created",
                  __FUNCTION__);
 }
@@ -99,6 +106,9 @@ AudioConferenceMixerImpl::~AudioConferenceMixerImpl()
     delete _crit;
     delete _cbCrit;
 
+    ResizeMixCandidates(0);
+    delete _spareAudioFrame;
+
     MemoryPool<AudioFrame>::DeleteMemoryPool(_audioFramePool);
     assert(_audioFramePool==NULL);
     WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id, "%s deleted",
@@ -189,8 +199,6 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
         _timeScheduler.UpdateScheduler();
     }
 
-    ListWrapper mixList;
-    MapWrapper mixedParticipantsMap;
     {
         CriticalSectionScoped cs(*_cbCrit);
 
@@ -240,16 +248,11 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
             }
         }
 
-        UpdateToMix(mixList,mixedParticipantsMap);
-        UpdateMixedStatus(mixedParticipantsMap);
-        _scratchParticipantsToMixAmount = mixedParticipantsMap.Size();
+        UpdateToMix();
+        UpdateMixedStatus();
+        _scratchParticipantsToMixAmount = _mixCandidatesAmount;
     }
 
-    // Clear mixedParticipantsMap to avoid memory leak warning.
-    // Please note that the mixedParticipantsMap doesn't own any dynamically
-    // allocated memory.
-    while(mixedParticipantsMap.Erase(mixedParticipantsMap.First()) == 0);
-
     // Get an AudioFrame for mixing from the memory pool.
     AudioFrame* mixedAudio = NULL;
     if(_audioFramePool->PopMemory(mixedAudio) == -1)
@@ -263,14 +266,14 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
     bool timeForMixerCallback = false;
     WebRtc_Word32 audioLevel = 0;
     {
-        const ListItem* firstItem = mixList.First();
-        // Assume mono.
+        // Mix in stereo if any of the mixed participants is stereo.
         WebRtc_UWord8 numberOfChannels = 1;
-        if(firstItem != NULL)
+        for(WebRtc_UWord32 i = 0; i < _mixCandidatesAmount; i++)
         {
-            // Use the same number of channels as the first frame to be mixed.
-            numberOfChannels = static_cast<const AudioFrame*>(
-                firstItem->GetItem())->_audioChannel;
+            if(_mixCandidates[i].audioFrame->_audioChannel > numberOfChannels)
+            {
+                numberOfChannels = _mixCandidates[i].audioFrame->_audioChannel;
+            }
         }
         // TODO (hellner): it might be better to decide the number of channels
         //                 with an API instead of dynamically.
@@ -284,7 +287,7 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
 
         _timeStamp += _sampleSize;
 
-        MixFromList(*mixedAudio,mixList);
+        MixFromCandidates(*mixedAudio);
 
         if(mixedAudio->_payloadDataLengthInSamples == 0)
         {
@@ -299,7 +302,7 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
         if(_mixerStatusCb)
         {
             _scratchVadPositiveParticipantsAmount = 0;
-            UpdateVADPositiveParticipants(mixList);
+            UpdateVADPositiveParticipants();
             if(_amountOf10MsUntilNextCallback-- == 0)
             {
                 _amountOf10MsUntilNextCallback = _amountOf10MsBetweenCallbacks;
@@ -338,7 +341,6 @@ WebRtc_Word32 AudioConferenceMixerImpl::Process()
 
     // Reclaim all outstanding memory.
     _audioFramePool->PushMemory(mixedAudio);
-    ClearAudioFrameList(mixList);
     {
         CriticalSectionScoped cs(*_crit);
         _processCalls--;
@@ -471,11 +473,6 @@ WebRtc_Word32 AudioConferenceMixerImpl::SetMixabilityStatus(
         bool success = false;
         if(mixable)
         {
-            if(_amountOfMixableParticipants >=
-               kMaximumAmountOfMixedParticipants)
-            {
-                return -1;
-            }
             success = AddParticipantToList(participant,_participantList);
         }
         else
@@ -521,6 +518,34 @@ WebRtc_Word32 AudioConferenceMixerImpl::AmountOfMixables(
     return 0;
 }
 
+WebRtc_Word32 AudioConferenceMixerImpl::SetAmountOfMixedParticipants(
+    const WebRtc_UWord32 amountOfMixedParticipants)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceAudioMixerServer, _id,
+                 "SetAmountOfMixedParticipants(%u)",
+                 amountOfMixedParticipants);
+    if(amountOfMixedParticipants == 0)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                     "amountOfMixedParticipants must be larger than 0");
+        return -1;
+    }
+    // The candidate arrays are resized in Process().
+    CriticalSectionScoped cs(*_cbCrit);
+    _amountOfMixedParticipants = amountOfMixedParticipants;
+    return 0;
+}
+
+WebRtc_Word32 AudioConferenceMixerImpl::AmountOfMixedParticipants(
+    WebRtc_UWord32& amountOfMixedParticipants) const
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceAudioMixerServer, _id,
+                 "AmountOfMixedParticipants(amountOfMixedParticipants)");
+    CriticalSectionScoped cs(*_cbCrit);
+    amountOfMixedParticipants = _amountOfMixedParticipants;
+    return 0;
+}
+
 WebRtc_Word32 AudioConferenceMixerImpl::SetMinimumMixingFrequency(
     Frequency freq)
 {
@@ -577,101 +602,172 @@ WebRtc_Word32 AudioConferenceMixerImpl::GetLowestMixingFrequency()
     return highestFreq;
 }
 
-void AudioConferenceMixerImpl::UpdateToMix(
-    ListWrapper& mixList,
-    MapWrapper& mixParticipantList)
+void AudioConferenceMixerImpl::UpdateToMix()
 {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
-                 "UpdateToMix(mixList,mixParticipantList)");
+                 "UpdateToMix()");
 
+    if(_amountOfMixedParticipants > _mixCandidatesCapacity)
+    {
+        ResizeMixCandidates(_amountOfMixedParticipants);
+    }
+    _mixCandidatesAmount = 0;
     ListItem* item = _participantList.First();
     while(item)
     {
-        MixerParticipant* participant = static_cast<MixerParticipant*>(
+        MixCandidate candidate;
+        candidate.participant = static_cast<MixerParticipant*>(
             item->GetItem());
-        AudioFrame* audioFrame = NULL;
-        if(_audioFramePool->PopMemory(audioFrame) == -1)
-        {
-            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
-                         "failed PopMemory() call");
-            assert(false);
-            return;
-        }
-        audioFrame->_frequencyInHz = _outputFrequency;
+        candidate.audioFrame = _spareAudioFrame;
+        item = _participantList.Next(item);
 
-        if(participant->GetAudioFrame(_id,*audioFrame) != 0)
+        candidate.audioFrame->_frequencyInHz = _outputFrequency;
+        if(candidate.participant->GetAudioFrame(_id,
+                                                *candidate.audioFrame) != 0)
         {
             WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
                          "failed to GetAudioFrame() from participant");
-            _audioFramePool->PushMemory(audioFrame);
-            item = _participantList.Next(item);
             continue;
         }
-        assert(audioFrame->_vadActivity != AudioFrame::kVadUnknown);
-        mixList.PushBack(static_cast<void*>(audioFrame));
-        mixParticipantList.Insert(audioFrame->_id,static_cast<void*>(
-            participant));
-        assert(mixParticipantList.Size() <= kMaximumAmountOfMixedParticipants);
-        item = _participantList.Next(item);
+        assert(candidate.audioFrame->_vadActivity != AudioFrame::kVadUnknown);
+        CalculateEnergy(*candidate.audioFrame);
+
+        if(_mixCandidatesAmount < _amountOfMixedParticipants)
+        {
+            // Swap the spare AudioFrame with the one of an unused slot.
+            _spareAudioFrame = _mixCandidates[_mixCandidatesAmount].audioFrame;
+            _mixCandidates[_mixCandidatesAmount] = candidate;
+            SiftUp(_mixCandidatesAmount);
+            _mixCandidatesAmount++;
+        }
+        else if(IsLouder(candidate, _mixCandidates[0]))
+        {
+            // Replace the quietest of the selected participants.
+            _spareAudioFrame = _mixCandidates[0].audioFrame;
+            _mixCandidates[0] = candidate;
+            SiftDown(0);
+        }
     }
 }
 
-void AudioConferenceMixerImpl::UpdateMixedStatus(
-    MapWrapper& mixedParticipantsMap)
+void AudioConferenceMixerImpl::ResizeMixCandidates(
+    const WebRtc_UWord32 capacity)
 {
-    WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
-                 "UpdateMixedStatus(mixedParticipantsMap)");
-    assert(mixedParticipantsMap.Size() <= kMaximumAmountOfMixedParticipants);
+    for(WebRtc_UWord32 i = 0; i < _mixCandidatesCapacity; i++)
+    {
+        delete _mixCandidates[i].audioFrame;
+    }
+    delete [] _mixCandidates;
+    delete [] _scratchMixedParticipants;
+    delete [] _scratchVadPositiveParticipants;
+    _mixCandidates = NULL;
+    _scratchMixedParticipants = NULL;
+    _scratchVadPositiveParticipants = NULL;
+    _mixCandidatesAmount = 0;
+    _mixCandidatesCapacity = capacity;
+    if(capacity == 0)
+    {
+        return;
+    }
+    _mixCandidates = new MixCandidate[capacity];
+    for(WebRtc_UWord32 i = 0; i < capacity; i++)
+    {
+        _mixCandidates[i].audioFrame = new AudioFrame();
+        _mixCandidates[i].participant = NULL;
+    }
+    _scratchMixedParticipants = new ParticipantStatistics[capacity];
+    _scratchVadPositiveParticipants = new ParticipantStatistics[capacity];
+}
 
-    // Loop through all non-VIP participants. If they are in the mix map they
-    // were mixed.
-    ListItem* participantItem = _participantList.First();
-    while(participantItem != NULL)
+bool AudioConferenceMixerImpl::IsLouder(const MixCandidate& lhs,
+                                        const MixCandidate& rhs)
+{
+    // Active speech is always preferred over passive.
+    const bool lhsActive =
+        lhs.audioFrame->_vadActivity == AudioFrame::kVadActive;
+    const bool rhsActive =
+        rhs.audioFrame->_vadActivity == AudioFrame::kVadActive;
+    if(lhsActive != rhsActive)
     {
-        bool isMixed = false;
-        MixerParticipant* participant =
-            static_cast<MixerParticipant*>(participantItem->GetItem());
+        return lhsActive;
+    }
+    return lhs.audioFrame->_energy > rhs.audioFrame->_energy;
+}
 
-        MapItem* mixedItem = mixedParticipantsMap.First();
-        while(mixedItem)
+void AudioConferenceMixerImpl::SiftUp(WebRtc_UWord32 position)
+{
+    while(position > 0)
+    {
+        const WebRtc_UWord32 parent = (position - 1) / 2;
+        if(!IsLouder(_mixCandidates[parent], _mixCandidates[position]))
         {
-            if(participant == mixedItem->GetItem())
-            {
-                isMixed = true;
-                break;
-            }
-            mixedItem = mixedParticipantsMap.Next(mixedItem);
+            break;
         }
-        participant->_mixHistory->SetIsMixed(isMixed);
-        participantItem = _participantList.Next(participantItem);
+        const MixCandidate tmp = _mixCandidates[parent];
+        _mixCandidates[parent] = _mixCandidates[position];
+        _mixCandidates[position] = tmp;
+        position = parent;
+    }
+}
+
+void AudioConferenceMixerImpl::SiftDown(WebRtc_UWord32 position)
+{
+    while(true)
+    {
+        WebRtc_UWord32 quietest = position;
+        const WebRtc_UWord32 left = 2 * position + 1;
+        const WebRtc_UWord32 right = left + 1;
+        if((left < _mixCandidatesAmount) &&
+           IsLouder(_mixCandidates[quietest], _mixCandidates[left]))
+        {
+            quietest = left;
+        }
+        if((right < _mixCandidatesAmount) &&
+           IsLouder(_mixCandidates[quietest], _mixCandidates[right]))
+        {
+            quietest = right;
+        }
+        if(quietest == position)
+        {
+            break;
+        }
+        const MixCandidate tmp = _mixCandidates[quietest];
+        _mixCandidates[quietest] = _mixCandidates[position];
+        _mixCandidates[position] = tmp;
+        position = quietest;
     }
 }
 
-void AudioConferenceMixerImpl::ClearAudioFrameList(ListWrapper& audioFrameList)
+void AudioConferenceMixerImpl::UpdateMixedStatus()
 {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
-                 "ClearAudioFrameList(audioFrameList)");
-    ListItem* item = audioFrameList.First();
-    while(item)
+                 "UpdateMixedStatus()");
+    assert(_mixCandidatesAmount <= _mixCandidatesCapacity);
+
+    for(WebRtc_UWord32 i = 0; i < _mixCandidatesAmount; i++)
+    {
+        _mixCandidates[i].participant->_mixHistory->SetSelected(true);
+    }
+    ListItem* participantItem = _participantList.First();
+    while(participantItem != NULL)
     {
-        AudioFrame* audioFrame = static_cast<AudioFrame*>(item->GetItem());
-        _audioFramePool->PushMemory(audioFrame);
-        audioFrameList.Erase(item);
-        item = audioFrameList.First();
+        MixerParticipant* participant =
+            static_cast<MixerParticipant*>(participantItem->GetItem());
+        MixHistory* mixHistory = participant->_mixHistory;
+        mixHistory->SetIsMixed(mixHistory->Selected());
+        mixHistory->SetSelected(false);
+        participantItem = _participantList.Next(participantItem);
     }
 }
 
-void AudioConferenceMixerImpl::UpdateVADPositiveParticipants(
-    ListWrapper& mixList)
+void AudioConferenceMixerImpl::UpdateVADPositiveParticipants()
 {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
-                 "UpdateVADPositiveParticipants(mixList)");
+                 "UpdateVADPositiveParticipants()");
 
-    ListItem* item = mixList.First();
-    while(item != NULL)
+    for(WebRtc_UWord32 i = 0; i < _mixCandidatesAmount; i++)
     {
-        AudioFrame* audioFrame = static_cast<AudioFrame*>(item->GetItem());
-        CalculateEnergy(*audioFrame);
+        const AudioFrame* audioFrame = _mixCandidates[i].audioFrame;
         if(audioFrame->_vadActivity == AudioFrame::kVadActive)
         {
             _scratchVadPositiveParticipants[
@@ -682,7 +778,6 @@ void AudioConferenceMixerImpl::UpdateVADPositiveParticipants(
                 audioFrame->_volume;
             _scratchVadPositiveParticipantsAmount++;
         }
-        item = mixList.Next(item);
     }
 }
 
@@ -742,28 +837,19 @@ bool AudioConferenceMixerImpl::RemoveParticipantFromList(
     return false;
 }
 
-WebRtc_Word32 AudioConferenceMixerImpl::MixFromList(AudioFrame& mixedAudioFrame,
-                                                    ListWrapper& audioFrameList)
+WebRtc_Word32 AudioConferenceMixerImpl::MixFromCandidates(
+    AudioFrame& mixedAudioFrame)
 {
     WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, _id,
-                 "MixFromList(mixedAudioFrame, audioFrameList)");
-    WebRtc_UWord32 position = 0;
-    ListItem* item = audioFrameList.First();
-    while(item != NULL)
+                 "MixFromCandidates(mixedAudioFrame)");
+    for(WebRtc_UWord32 position = 0; position < _mixCandidatesAmount;
+        position++)
     {
-        if(position >= kMaximumAmountOfMixedParticipants)
+        AudioFrame* audioFrame = _mixCandidates[position].audioFrame;
+        if(audioFrame->_audioChannel < mixedAudioFrame._audioChannel)
         {
-            WEBRTC_TRACE(
-                kTraceMemory,
-                kTraceAudioMixerServer,
-                _id,
-                "Trying to mix more than max amount of mixed participants:%d!",
-                kMaximumAmountOfMixedParticipants);
-            // Assert and avoid crash
-            assert(false);
-            position = 0;
+            UpmixMonoToStereo(*audioFrame);
         }
-        AudioFrame* audioFrame = static_cast<AudioFrame*>(item->GetItem());
 
         // Divide the AudioFrame samples by 2 to avoid saturation.
         *audioFrame >>= 1;
@@ -771,9 +857,6 @@ WebRtc_Word32 AudioConferenceMixerImpl::MixFromList(AudioFrame& mixedAudioFrame,
 
         _scratchMixedParticipants[position].participant = audioFrame->_id;
         _scratchMixedParticipants[position].level = audioFrame->_volume;
-
-        position++;
-        item = audioFrameList.Next(item);
     }
     return 0;
 }
@@ -39,8 +39,21 @@ public:
     WebRtc_Word32 SetIsMixed(const bool mixed);
 
     void ResetMixedStatus();
+
+    // Marks the participant as selected for the mix that is being prepared.
+    // May only be used in the scope of AudioConferenceMixerImpl::Process().
+    void SetSelected(const bool selected) { _selected = selected; }
+    bool Selected() const { return _selected; }
 private:
     Atomic32Wrapper _isMixed;  // 0 = false, 1 = true
+    bool _selected;
+};
+
+// A participant and its audio for the current 10 ms frame.
+struct MixCandidate
+{
+    AudioFrame*       audioFrame;
+    MixerParticipant* participant;
 };
 
 class AudioConferenceMixerImpl : public AudioConferenceMixer
@@ -74,6 +87,10 @@ public:
     virtual WebRtc_Word32 SetMinimumMixingFrequency(Frequency freq);
     virtual WebRtc_Word32 AmountOfMixables(
         WebRtc_UWord32& amountOfMixableParticipants);
+    virtual WebRtc_Word32 SetAmountOfMixedParticipants(
+        const WebRtc_UWord32 amountOfMixedParticipants);
+    virtual WebRtc_Word32 AmountOfMixedParticipants(
+        WebRtc_UWord32& amountOfMixedParticipants) const;
 private:
     enum{DEFAULT_AUDIO_FRAME_POOLSIZE = 50};
 
@@ -81,26 +98,33 @@ private:
     WebRtc_Word32 SetOutputFrequency(const Frequency frequency);
     Frequency OutputFrequency() const;
 
-    // Fill mixList with the AudioFrames pointers that should be used when
-    // mixing. Fill mixParticipantList with ParticipantStatistics for the
-    // participants who's AudioFrames are inside mixList.
-    void UpdateToMix(ListWrapper& mixList, MapWrapper& mixParticipantList);
+    // Fetch the AudioFrames of all participants and select the
+    // _amountOfMixedParticipants loudest ones into _mixCandidates.
+    void UpdateToMix();
+
+    // Reallocate _mixCandidates and the scratch arrays for up to capacity
+    // mixed participants.
+    void ResizeMixCandidates(const WebRtc_UWord32 capacity);
+
+    // Returns true if candidate lhs should be mixed rather than rhs.
+    static bool IsLouder(const MixCandidate& lhs, const MixCandidate& rhs);
+
+    // Restore the heap property of _mixCandidates, with the quietest
+    // candidate first, after the candidate at position has been replaced.
+    void SiftDown(WebRtc_UWord32 position);
+    void SiftUp(WebRtc_UWord32 position);
 
     // Return the lowest mixing frequency that can be used without having to
     // downsample any audio.
     WebRtc_Word32 GetLowestMixingFrequency();
 
-    // Update the MixHistory of all MixerParticipants. mixedParticipantsList
-    // should contain a map of MixerParticipants that have been mixed.
-    void UpdateMixedStatus(MapWrapper& mixedParticipantsList);
-
-    // Clears audioFrameList and reclaims all memory associated with it.
-    void ClearAudioFrameList(ListWrapper& audioFrameList);
+    // Update the MixHistory of all MixerParticipants. The participants in
+    // _mixCandidates have been mixed.
+    void UpdateMixedStatus();
 
-    // Update the list of MixerParticipants who have a positive VAD. mixList
-    // should be a list of AudioFrames
-    void UpdateVADPositiveParticipants(
-        ListWrapper& mixList);
+    // Update the list of MixerParticipants who have a positive VAD among the
+    // mixed participants.
+    void UpdateVADPositiveParticipants();
 
     // This function returns true if it finds the MixerParticipant in the
     // specified list of MixerParticipants.
@@ -117,20 +141,25 @@ private:
         MixerParticipant& removeParticipant,
         ListWrapper& participantList);
 
-    // Mix the AudioFrames stored in audioFrameList into mixedAudioFrame.
-    WebRtc_Word32 MixFromList(
-        AudioFrame& mixedAudioFrame,
-        ListWrapper& audioFrameList);
+    // Mix the AudioFrames in _mixCandidates into mixedAudioFrame.
+    WebRtc_Word32 MixFromCandidates(AudioFrame& mixedAudioFrame);
 
     // Scratch memory
     // Note that the scratch memory may only be touched in the scope of
     // Process().
+    // The arrays hold _mixCandidatesCapacity elements, which is at least
+    // _amountOfMixedParticipants when selecting the participants to mix.
     WebRtc_UWord32         _scratchParticipantsToMixAmount;
-    ParticipantStatistics  _scratchMixedParticipants[
-        kMaximumAmountOfMixedParticipants];
+    ParticipantStatistics* _scratchMixedParticipants;
     WebRtc_UWord32         _scratchVadPositiveParticipantsAmount;
-    ParticipantStatistics  _scratchVadPositiveParticipants[
-        kMaximumAmountOfMixedParticipants];
+    ParticipantStatistics* _scratchVadPositiveParticipants;
+    // Min-heap, ordered with IsLouder(), of the participants to mix. The
+    // AudioFrames are owned by the mixer, _spareAudioFrame holds the one not
+    // in use.
+    MixCandidate*          _mixCandidates;
+    WebRtc_UWord32         _mixCandidatesAmount;
+    WebRtc_UWord32         _mixCandidatesCapacity;
+    AudioFrame*            _spareAudioFrame;
 
     CriticalSectionWrapper* _crit;
     CriticalSectionWrapper* _cbCrit;
@@ -158,6 +187,7 @@ private:
     ListWrapper _participantList;              // May be mixed.
 
     WebRtc_UWord32 _amountOfMixableParticipants;
+    WebRtc_UWord32 _amountOfMixedParticipants;
 
     WebRtc_UWord32 _timeStamp;
 
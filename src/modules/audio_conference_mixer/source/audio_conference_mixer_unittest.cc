@@ -0,0 +1,222 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file includes unit tests for the selection of the participants to mix
+ * in AudioConferenceMixerImpl.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "audio_conference_mixer.h"
+#include "audio_conference_mixer_defines.h"
+#include "module_common_types.h"
+
+namespace {
+
+using webrtc::AudioConferenceMixer;
+using webrtc::AudioFrame;
+using webrtc::AudioMixerOutputReceiver;
+using webrtc::AudioMixerStatusReceiver;
+using webrtc::MixerParticipant;
+using webrtc::ParticipantStatistics;
+
+const int kFrequency = 16000;
+const int kSamples = kFrequency / 100;
+
+// Delivers a constant signal of the given amplitude.
+class FakeParticipant : public MixerParticipant {
+ public:
+  FakeParticipant(int id, WebRtc_Word16 amplitude,
+                  AudioFrame::VADActivity vad, int channels)
+      : id_(id), amplitude_(amplitude), vad_(vad), channels_(channels) {}
+  virtual ~FakeParticipant() {}
+
+  virtual WebRtc_Word32 GetAudioFrame(const WebRtc_Word32 /*id*/,
+                                      AudioFrame& audioFrame) {
+    WebRtc_Word16 samples[2 * kSamples];
+    for (int i = 0; i < channels_ * kSamples; i++) {
+      samples[i] = amplitude_;
+    }
+    return audioFrame.UpdateFrame(id_, 0, samples, kSamples, kFrequency,
+                                  AudioFrame::kNormalSpeech, vad_, channels_);
+  }
+  virtual WebRtc_Word32 NeededFrequency(const WebRtc_Word32 /*id*/) {
+    return kFrequency;
+  }
+
+  bool IsMixed() const {
+    bool mixed = false;
+    MixerParticipant::IsMixed(mixed);
+    return mixed;
+  }
+
+ private:
+  int id_;
+  WebRtc_Word16 amplitude_;
+  AudioFrame::VADActivity vad_;
+  int channels_;
+};
+
+class Receiver : public AudioMixerOutputReceiver,
+                 public AudioMixerStatusReceiver {
+ public:
+  Receiver() : channels_(0), first_sample_(0), mixed_(0) {}
+
+  virtual void NewMixedAudio(const WebRtc_Word32 /*id*/,
+                             const AudioFrame& generalAudioFrame,
+                             const AudioFrame** /*uniqueAudioFrames*/,
+                             const WebRtc_UWord32 /*size*/) {
+    channels_ = generalAudioFrame._audioChannel;
+    first_sample_ = generalAudioFrame._payloadData[0];
+  }
+  virtual void MixedParticipants(const WebRtc_Word32 /*id*/,
+                                 const ParticipantStatistics* /*stats*/,
+                                 const WebRtc_UWord32 size) {
+    mixed_ = size;
+  }
+  virtual void VADPositiveParticipants(const WebRtc_Word32 /*id*/,
+                                       const ParticipantStatistics* /*stats*/,
+                                       const WebRtc_UWord32 /*size*/) {}
+  virtual void MixedAudioLevel(const WebRtc_Word32 /*id*/,
+                               const WebRtc_UWord32 /*level*/) {}
+
+  int channels_;
+  int first_sample_;
+  WebRtc_UWord32 mixed_;
+};
+
+class AudioConferenceMixerTest : public ::testing::Test {
+ protected:
+  AudioConferenceMixerTest()
+      : mixer_(AudioConferenceMixer::CreateAudioConferenceMixer(0)) {}
+
+  virtual void SetUp() {
+    ASSERT_EQ(0, mixer_->RegisterMixedStreamCallback(receiver_));
+    ASSERT_EQ(0, mixer_->RegisterMixerStatusCallback(receiver_, 1));
+  }
+
+  virtual void TearDown() {
+    for (size_t i = 0; i < participants_.size(); i++) {
+      EXPECT_EQ(0, mixer_->SetMixabilityStatus(*participants_[i], false));
+      delete participants_[i];
+    }
+    EXPECT_EQ(0, mixer_->UnRegisterMixerStatusCallback());
+    EXPECT_EQ(0, mixer_->UnRegisterMixedStreamCallback());
+    delete mixer_;
+  }
+
+  void AddParticipant(WebRtc_Word16 amplitude,
+                      AudioFrame::VADActivity vad = AudioFrame::kVadActive,
+                      int channels = 1) {
+    const int id = static_cast<int>(participants_.size());
+    participants_.push_back(
+        new FakeParticipant(id, amplitude, vad, channels));
+    ASSERT_EQ(0, mixer_->SetMixabilityStatus(*participants_.back(), true));
+  }
+
+  int MixedCount() const {
+    int mixed = 0;
+    for (size_t i = 0; i < participants_.size(); i++) {
+      if (participants_[i]->IsMixed()) {
+        mixed++;
+      }
+    }
+    return mixed;
+  }
+
+  AudioConferenceMixer* mixer_;
+  Receiver receiver_;
+  std::vector<FakeParticipant*> participants_;
+};
+
+TEST_F(AudioConferenceMixerTest, RejectsZeroMixedParticipants) {
+  EXPECT_EQ(-1, mixer_->SetAmountOfMixedParticipants(0));
+  WebRtc_UWord32 amount = 0;
+  EXPECT_EQ(0, mixer_->AmountOfMixedParticipants(amount));
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(
+      AudioConferenceMixer::kDefaultAmountOfMixedParticipants), amount);
+}
+
+TEST_F(AudioConferenceMixerTest, MixesTheLoudestParticipants) {
+  const int kParticipants = 20;
+  const int kMixed = 5;
+  // Interleave loud and quiet participants in the order they are added.
+  for (int i = 0; i < kParticipants; i++) {
+    const int rank = (i % 2 == 0) ? i / 2 : kParticipants - 1 - i / 2;
+    AddParticipant(static_cast<WebRtc_Word16>(100 * (rank + 1)));
+  }
+  ASSERT_EQ(0, mixer_->SetAmountOfMixedParticipants(kMixed));
+  EXPECT_EQ(0, mixer_->Process());
+
+  EXPECT_EQ(kMixed, MixedCount());
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kMixed), receiver_.mixed_);
+  for (int i = 0; i < kParticipants; i++) {
+    const int rank = (i % 2 == 0) ? i / 2 : kParticipants - 1 - i / 2;
+    EXPECT_EQ(rank >= kParticipants - kMixed, participants_[i]->IsMixed())
+        << "participant " << i;
+  }
+}
+
+TEST_F(AudioConferenceMixerTest, PrefersActiveSpeech) {
+  AddParticipant(1000, AudioFrame::kVadPassive);
+  AddParticipant(10, AudioFrame::kVadActive);
+  AddParticipant(2000, AudioFrame::kVadPassive);
+  AddParticipant(20, AudioFrame::kVadActive);
+  ASSERT_EQ(0, mixer_->SetAmountOfMixedParticipants(3));
+  EXPECT_EQ(0, mixer_->Process());
+
+  EXPECT_FALSE(participants_[0]->IsMixed());
+  EXPECT_TRUE(participants_[1]->IsMixed());
+  EXPECT_TRUE(participants_[2]->IsMixed());
+  EXPECT_TRUE(participants_[3]->IsMixed());
+}
+
+TEST_F(AudioConferenceMixerTest, MixesMoreThanTheDefaultAmount) {
+  const int kMixed = 2 * AudioConferenceMixer::kDefaultAmountOfMixedParticipants;
+  const int kParticipants = kMixed + 10;
+  for (int i = 0; i < kParticipants; i++) {
+    AddParticipant(static_cast<WebRtc_Word16>(10 * (i + 1)));
+  }
+  EXPECT_EQ(0, mixer_->Process());
+  EXPECT_EQ(AudioConferenceMixer::kDefaultAmountOfMixedParticipants,
+            MixedCount());
+
+  ASSERT_EQ(0, mixer_->SetAmountOfMixedParticipants(kMixed));
+  // The status callback is made every second Process() call.
+  EXPECT_EQ(0, mixer_->Process());
+  EXPECT_EQ(0, mixer_->Process());
+  EXPECT_EQ(kMixed, MixedCount());
+  EXPECT_EQ(static_cast<WebRtc_UWord32>(kMixed), receiver_.mixed_);
+  for (int i = 0; i < kParticipants; i++) {
+    EXPECT_EQ(i >= kParticipants - kMixed, participants_[i]->IsMixed());
+  }
+}
+
+TEST_F(AudioConferenceMixerTest, MixesInStereoIfAnyMixedParticipantIs) {
+  AddParticipant(1000);
+  AddParticipant(2000);
+  AddParticipant(100, AudioFrame::kVadActive, 2);
+  EXPECT_EQ(0, mixer_->Process());
+  EXPECT_EQ(2, receiver_.channels_);
+  // The mono participants are mixed into both channels.
+  EXPECT_EQ((1000 >> 1) + (2000 >> 1) + (100 >> 1), receiver_.first_sample_);
+
+  // The stereo participant is the quietest and no longer mixed.
+  ASSERT_EQ(0, mixer_->SetAmountOfMixedParticipants(2));
+  EXPECT_EQ(0, mixer_->Process());
+  EXPECT_FALSE(participants_[2]->IsMixed());
+  EXPECT_EQ(1, receiver_.channels_);
+  EXPECT_EQ((1000 >> 1) + (2000 >> 1), receiver_.first_sample_);
+}
+
+}  // namespace
@@ -27,4 +27,24 @@ void CalculateEnergy(AudioFrame& audioFrame)
                               audioFrame._payloadData[position];
     }
 }
+
+void UpmixMonoToStereo(AudioFrame& audioFrame)
+{
+    if((audioFrame._audioChannel != 1) ||
+       (2 * audioFrame._payloadDataLengthInSamples >
+        AudioFrame::kMaxAudioFrameSizeSamples))
+    {
+        return;
+    }
+    // Backwards, so that no sample is overwritten before it's copied.
+    for(int position = audioFrame._payloadDataLengthInSamples - 1;
+        position >= 0; position--)
+    {
+        audioFrame._payloadData[2 * position + 1] =
+            audioFrame._payloadData[position];
+        audioFrame._payloadData[2 * position] =
+            audioFrame._payloadData[position];
+    }
+    audioFrame._audioChannel = 2;
+}
 } // namespace webrtc
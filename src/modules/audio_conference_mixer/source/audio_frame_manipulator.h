@@ -15,6 +15,9 @@ namespace webrtc {
 class AudioFrame;
 // Updates the audioFrame's energy (based on its samples).
 void CalculateEnergy(AudioFrame& audioFrame);
+
+// Duplicates the samples of a mono audioFrame into both stereo channels.
+void UpmixMonoToStereo(AudioFrame& audioFrame);
 } // namespace webrtc
 
 #endif // WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_FRAME_MANIPULATOR_H_
@@ -45,6 +45,20 @@
         }],
       ],
     },
+    {
+      'target_name': 'aec_benchmark',
+      'type': 'executable',
+      'dependencies': [
+        'aec',
+        '../../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'include_dirs': [
+        '../../../../../system_wrappers/interface',
+      ],
+      'sources': [
+        '../test/aec_benchmark.cc',
+      ],
+    },
   ],
 }
 
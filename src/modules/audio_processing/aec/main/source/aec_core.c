@@ -115,6 +115,9 @@ const float WebRtcAec_overDriveCurve[65] = {
     1.9682f, 1.9763f, 1.9843f, 1.9922f, 2.0000f
 };
 
+// Power estimate smoothing coefficients, indexed by aec->mult - 1.
+const float WebRtcAec_gCoh[2][2] = {{0.9f, 0.1f}, {0.93f, 0.07f}};
+
 // "Private" function prototypes.
 static void ProcessBlock(aec_t *aec, const short *farend,
                               const short *nearend, const short *nearendH,
@@ -335,10 +338,59 @@ static void OverdriveAndSuppress(aec_t *aec, float hNl[PART_LEN1],
   }
 }
 
+static void SubbandCoherence(aec_t *aec, float efw[2][PART_LEN1],
+                             float dfw[2][PART_LEN1],
+                             complex_t xfw[PART_LEN1],
+                             float *cohde, float *cohxd,
+                             float *sdSum, float *seSum)
+{
+    const float *ptrGCoh = WebRtcAec_gCoh[aec->mult - 1];
+    float sdAcc = 0, seAcc = 0;
+    int i;
+
+    // Smoothed PSD
+    for (i = 0; i < PART_LEN1; i++) {
+        aec->sd[i] = ptrGCoh[0] * aec->sd[i] + ptrGCoh[1] *
+            (dfw[0][i] * dfw[0][i] + dfw[1][i] * dfw[1][i]);
+        aec->se[i] = ptrGCoh[0] * aec->se[i] + ptrGCoh[1] *
+            (efw[0][i] * efw[0][i] + efw[1][i] * efw[1][i]);
+        // We threshold here to protect against the ill-effects of a zero farend.
+        // The threshold is not arbitrarily chosen, but balances protection and
+        // adverse interaction with the algorithm's tuning.
+        // TODO: investigate further why this is so sensitive.
+        aec->sx[i] = ptrGCoh[0] * aec->sx[i] + ptrGCoh[1] *
+            WEBRTC_SPL_MAX(xfw[i][0] * xfw[i][0] + xfw[i][1] * xfw[i][1], 15);
+
+        aec->sde[i][0] = ptrGCoh[0] * aec->sde[i][0] + ptrGCoh[1] *
+            (dfw[0][i] * efw[0][i] + dfw[1][i] * efw[1][i]);
+        aec->sde[i][1] = ptrGCoh[0] * aec->sde[i][1] + ptrGCoh[1] *
+            (dfw[0][i] * efw[1][i] - dfw[1][i] * efw[0][i]);
+
+        aec->sxd[i][0] = ptrGCoh[0] * aec->sxd[i][0] + ptrGCoh[1] *
+            (dfw[0][i] * xfw[i][0] + dfw[1][i] * xfw[i][1]);
+        aec->sxd[i][1] = ptrGCoh[0] * aec->sxd[i][1] + ptrGCoh[1] *
+            (dfw[0][i] * xfw[i][1] - dfw[1][i] * xfw[i][0]);
+
+        sdAcc += aec->sd[i];
+        seAcc += aec->se[i];
+    }
+    *sdSum = sdAcc;
+    *seSum = seAcc;
+
+    // Subband coherence
+    for (i = 0; i < PART_LEN1; i++) {
+        cohde[i] = (aec->sde[i][0] * aec->sde[i][0] + aec->sde[i][1] * aec->sde[i][1]) /
+            (aec->sd[i] * aec->se[i] + 1e-10f);
+        cohxd[i] = (aec->sxd[i][0] * aec->sxd[i][0] + aec->sxd[i][1] * aec->sxd[i][1]) /
+            (aec->sx[i] * aec->sd[i] + 1e-10f);
+    }
+}
+
 WebRtcAec_FilterFar_t WebRtcAec_FilterFar;
 WebRtcAec_ScaleErrorSignal_t WebRtcAec_ScaleErrorSignal;
 WebRtcAec_FilterAdaptation_t WebRtcAec_FilterAdaptation;
 WebRtcAec_OverdriveAndSuppress_t WebRtcAec_OverdriveAndSuppress;
+WebRtcAec_SubbandCoherence_t WebRtcAec_SubbandCoherence;
 
 int WebRtcAec_InitAec(aec_t *aec, int sampFreq)
 {
@@ -467,6 +519,7 @@ int WebRtcAec_InitAec(aec_t *aec, int sampFreq)
     WebRtcAec_ScaleErrorSignal = ScaleErrorSignal;
     WebRtcAec_FilterAdaptation = FilterAdaptation;
     WebRtcAec_OverdriveAndSuppress = OverdriveAndSuppress;
+    WebRtcAec_SubbandCoherence = SubbandCoherence;
     if (WebRtc_GetCPUInfo(kSSE2)) {
 #if defined(__SSE2__)
       WebRtcAec_InitAec_SSE2();
@@ -794,10 +847,6 @@ static void NonLinearProcessing(aec_t *aec, short *output, short *outputH)
     // Near and error power sums
     float sdSum = 0, seSum = 0;
 
-    // Power estimate smoothing coefficients
-    const float gCoh[2][2] = {{0.9f, 0.1f}, {0.93f, 0.07f}};
-    const float *ptrGCoh = gCoh[aec->mult - 1];
-
     // Filter energey
     float wfEnMax = 0, wfEn = 0;
     const int delayEstInterval = 10 * aec->mult;
@@ -886,32 +935,7 @@ static void NonLinearProcessing(aec_t *aec, short *output, short *outputH)
         efw[1][i] = fft[2 * i + 1];
     }
 
-    // Smoothed PSD
-    for (i = 0; i < PART_LEN1; i++) {
-        aec->sd[i] = ptrGCoh[0] * aec->sd[i] + ptrGCoh[1] *
-            (dfw[0][i] * dfw[0][i] + dfw[1][i] * dfw[1][i]);
-        aec->se[i] = ptrGCoh[0] * aec->se[i] + ptrGCoh[1] *
-            (efw[0][i] * efw[0][i] + efw[1][i] * efw[1][i]);
-        // We threshold here to protect against the ill-effects of a zero farend.
-        // The threshold is not arbitrarily chosen, but balances protection and
-        // adverse interaction with the algorithm's tuning.
-        // TODO: investigate further why this is so sensitive.
-        aec->sx[i] = ptrGCoh[0] * aec->sx[i] + ptrGCoh[1] *
-            WEBRTC_SPL_MAX(xfw[i][0] * xfw[i][0] + xfw[i][1] * xfw[i][1], 15);
-
-        aec->sde[i][0] = ptrGCoh[0] * aec->sde[i][0] + ptrGCoh[1] *
-            (dfw[0][i] * efw[0][i] + dfw[1][i] * efw[1][i]);
-        aec->sde[i][1] = ptrGCoh[0] * aec->sde[i][1] + ptrGCoh[1] *
-            (dfw[0][i] * efw[1][i] - dfw[1][i] * efw[0][i]);
-
-        aec->sxd[i][0] = ptrGCoh[0] * aec->sxd[i][0] + ptrGCoh[1] *
-            (dfw[0][i] * xfw[i][0] + dfw[1][i] * xfw[i][1]);
-        aec->sxd[i][1] = ptrGCoh[0] * aec->sxd[i][1] + ptrGCoh[1] *
-            (dfw[0][i] * xfw[i][1] - dfw[1][i] * xfw[i][0]);
-
-        sdSum += aec->sd[i];
-        seSum += aec->se[i];
-    }
+    WebRtcAec_SubbandCoherence(aec, efw, dfw, xfw, cohde, cohxd, &sdSum, &seSum);
 
     // Divergent filter safeguard.
     if (aec->divergeState == 0) {
@@ -934,14 +958,6 @@ static void NonLinearProcessing(aec_t *aec, short *output, short *outputH)
         memset(aec->wfBuf, 0, sizeof(aec->wfBuf));
     }
 
-    // Subband coherence
-    for (i = 0; i < PART_LEN1; i++) {
-        cohde[i] = (aec->sde[i][0] * aec->sde[i][0] + aec->sde[i][1] * aec->sde[i][1]) /
-            (aec->sd[i] * aec->se[i] + 1e-10f);
-        cohxd[i] = (aec->sxd[i][0] * aec->sxd[i][0] + aec->sxd[i][1] * aec->sxd[i][1]) /
-            (aec->sx[i] * aec->sd[i] + 1e-10f);
-    }
-
     hNlXdAvg = 0;
     for (i = minPrefBand; i < prefBandSize + minPrefBand; i++) {
         hNlXdAvg += cohxd[i];
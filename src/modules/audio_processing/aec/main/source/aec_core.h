@@ -177,6 +177,14 @@ extern WebRtcAec_FilterAdaptation_t WebRtcAec_FilterAdaptation;
 typedef void (*WebRtcAec_OverdriveAndSuppress_t)
   (aec_t *aec, float hNl[PART_LEN1], const float hNlFb, float efw[2][PART_LEN1]);
 extern WebRtcAec_OverdriveAndSuppress_t WebRtcAec_OverdriveAndSuppress;
+// Updates the smoothed auto and cross PSDs of the far end (|xfw|), near end
+// (|dfw|) and error (|efw|) spectra, computes the near-error and far-near
+// coherence per subband and returns the near and error power sums.
+typedef void (*WebRtcAec_SubbandCoherence_t)
+  (aec_t *aec, float efw[2][PART_LEN1], float dfw[2][PART_LEN1],
+   complex_t xfw[PART_LEN1], float *cohde, float *cohxd,
+   float *sdSum, float *seSum);
+extern WebRtcAec_SubbandCoherence_t WebRtcAec_SubbandCoherence;
 
 int WebRtcAec_CreateAec(aec_t **aec);
 int WebRtcAec_FreeAec(aec_t *aec);
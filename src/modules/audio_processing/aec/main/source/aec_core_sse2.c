@@ -425,11 +425,147 @@ static void OverdriveAndSuppressSSE2(aec_t *aec, float hNl[PART_LEN1],
   }
 }
 
+extern const float WebRtcAec_gCoh[2][2];
+
+// Splits four interleaved complex values, starting at |a|, into their real
+// and imaginary parts.
+static __inline void LoadComplex(const complex_t *a, __m128 *re, __m128 *im)
+{
+  const __m128 lo = _mm_loadu_ps(a[0]);
+  const __m128 hi = _mm_loadu_ps(a[2]);
+  *re = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+  *im = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+static __inline void StoreComplex(complex_t *a, __m128 re, __m128 im)
+{
+  _mm_storeu_ps(a[0], _mm_unpacklo_ps(re, im));
+  _mm_storeu_ps(a[2], _mm_unpackhi_ps(re, im));
+}
+
+// Adds the four values of |a|.
+static __inline float HorizontalSum(__m128 a)
+{
+  a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+  a = _mm_add_ss(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(a);
+}
+
+static void SubbandCoherenceSSE2(aec_t *aec, float efw[2][PART_LEN1],
+                                 float dfw[2][PART_LEN1],
+                                 complex_t xfw[PART_LEN1],
+                                 float *cohde, float *cohxd,
+                                 float *sdSum, float *seSum) {
+  const float *ptrGCoh = WebRtcAec_gCoh[aec->mult - 1];
+  const __m128 vec_gCoh0 = _mm_set1_ps(ptrGCoh[0]);
+  const __m128 vec_gCoh1 = _mm_set1_ps(ptrGCoh[1]);
+  const __m128 vec_15 = _mm_set1_ps(15.0f);
+  const __m128 vec_1eminus10 = _mm_set1_ps(1e-10f);
+  __m128 vec_sdSum = _mm_setzero_ps();
+  __m128 vec_seSum = _mm_setzero_ps();
+  int i;
+
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < PART_LEN1; i += 4) {
+    const __m128 vec_dfw0 = _mm_loadu_ps(&dfw[0][i]);
+    const __m128 vec_dfw1 = _mm_loadu_ps(&dfw[1][i]);
+    const __m128 vec_efw0 = _mm_loadu_ps(&efw[0][i]);
+    const __m128 vec_efw1 = _mm_loadu_ps(&efw[1][i]);
+    __m128 vec_xfw0, vec_xfw1, vec_sde0, vec_sde1, vec_sxd0, vec_sxd1;
+    __m128 vec_sd, vec_se, vec_sx, vec_a, vec_b;
+    LoadComplex(&xfw[i], &vec_xfw0, &vec_xfw1);
+    LoadComplex(&aec->sde[i], &vec_sde0, &vec_sde1);
+    LoadComplex(&aec->sxd[i], &vec_sxd0, &vec_sxd1);
+
+    // Smoothed PSD
+    vec_a = _mm_add_ps(_mm_mul_ps(vec_dfw0, vec_dfw0),
+                       _mm_mul_ps(vec_dfw1, vec_dfw1));
+    vec_sd = _mm_add_ps(_mm_mul_ps(vec_gCoh0, _mm_loadu_ps(&aec->sd[i])),
+                        _mm_mul_ps(vec_gCoh1, vec_a));
+    vec_a = _mm_add_ps(_mm_mul_ps(vec_efw0, vec_efw0),
+                       _mm_mul_ps(vec_efw1, vec_efw1));
+    vec_se = _mm_add_ps(_mm_mul_ps(vec_gCoh0, _mm_loadu_ps(&aec->se[i])),
+                        _mm_mul_ps(vec_gCoh1, vec_a));
+    // Same threshold on the far end power as in the C version.
+    vec_a = _mm_max_ps(_mm_add_ps(_mm_mul_ps(vec_xfw0, vec_xfw0),
+                                  _mm_mul_ps(vec_xfw1, vec_xfw1)), vec_15);
+    vec_sx = _mm_add_ps(_mm_mul_ps(vec_gCoh0, _mm_loadu_ps(&aec->sx[i])),
+                        _mm_mul_ps(vec_gCoh1, vec_a));
+    _mm_storeu_ps(&aec->sd[i], vec_sd);
+    _mm_storeu_ps(&aec->se[i], vec_se);
+    _mm_storeu_ps(&aec->sx[i], vec_sx);
+
+    vec_a = _mm_add_ps(_mm_mul_ps(vec_dfw0, vec_efw0),
+                       _mm_mul_ps(vec_dfw1, vec_efw1));
+    vec_b = _mm_sub_ps(_mm_mul_ps(vec_dfw0, vec_efw1),
+                       _mm_mul_ps(vec_dfw1, vec_efw0));
+    vec_sde0 = _mm_add_ps(_mm_mul_ps(vec_gCoh0, vec_sde0),
+                          _mm_mul_ps(vec_gCoh1, vec_a));
+    vec_sde1 = _mm_add_ps(_mm_mul_ps(vec_gCoh0, vec_sde1),
+                          _mm_mul_ps(vec_gCoh1, vec_b));
+    StoreComplex(&aec->sde[i], vec_sde0, vec_sde1);
+
+    vec_a = _mm_add_ps(_mm_mul_ps(vec_dfw0, vec_xfw0),
+                       _mm_mul_ps(vec_dfw1, vec_xfw1));
+    vec_b = _mm_sub_ps(_mm_mul_ps(vec_dfw0, vec_xfw1),
+                       _mm_mul_ps(vec_dfw1, vec_xfw0));
+    vec_sxd0 = _mm_add_ps(_mm_mul_ps(vec_gCoh0, vec_sxd0),
+                          _mm_mul_ps(vec_gCoh1, vec_a));
+    vec_sxd1 = _mm_add_ps(_mm_mul_ps(vec_gCoh0, vec_sxd1),
+                          _mm_mul_ps(vec_gCoh1, vec_b));
+    StoreComplex(&aec->sxd[i], vec_sxd0, vec_sxd1);
+
+    vec_sdSum = _mm_add_ps(vec_sdSum, vec_sd);
+    vec_seSum = _mm_add_ps(vec_seSum, vec_se);
+
+    // Subband coherence
+    vec_a = _mm_add_ps(_mm_mul_ps(vec_sde0, vec_sde0),
+                       _mm_mul_ps(vec_sde1, vec_sde1));
+    vec_b = _mm_add_ps(_mm_mul_ps(vec_sd, vec_se), vec_1eminus10);
+    _mm_storeu_ps(&cohde[i], _mm_div_ps(vec_a, vec_b));
+    vec_a = _mm_add_ps(_mm_mul_ps(vec_sxd0, vec_sxd0),
+                       _mm_mul_ps(vec_sxd1, vec_sxd1));
+    vec_b = _mm_add_ps(_mm_mul_ps(vec_sx, vec_sd), vec_1eminus10);
+    _mm_storeu_ps(&cohxd[i], _mm_div_ps(vec_a, vec_b));
+  }
+  *sdSum = HorizontalSum(vec_sdSum);
+  *seSum = HorizontalSum(vec_seSum);
+
+  // scalar code for the remaining items.
+  for (; i < PART_LEN1; i++) {
+    aec->sd[i] = ptrGCoh[0] * aec->sd[i] + ptrGCoh[1] *
+        (dfw[0][i] * dfw[0][i] + dfw[1][i] * dfw[1][i]);
+    aec->se[i] = ptrGCoh[0] * aec->se[i] + ptrGCoh[1] *
+        (efw[0][i] * efw[0][i] + efw[1][i] * efw[1][i]);
+    aec->sx[i] = ptrGCoh[0] * aec->sx[i] + ptrGCoh[1] *
+        WEBRTC_SPL_MAX(xfw[i][0] * xfw[i][0] + xfw[i][1] * xfw[i][1], 15);
+
+    aec->sde[i][0] = ptrGCoh[0] * aec->sde[i][0] + ptrGCoh[1] *
+        (dfw[0][i] * efw[0][i] + dfw[1][i] * efw[1][i]);
+    aec->sde[i][1] = ptrGCoh[0] * aec->sde[i][1] + ptrGCoh[1] *
+        (dfw[0][i] * efw[1][i] - dfw[1][i] * efw[0][i]);
+
+    aec->sxd[i][0] = ptrGCoh[0] * aec->sxd[i][0] + ptrGCoh[1] *
+        (dfw[0][i] * xfw[i][0] + dfw[1][i] * xfw[i][1]);
+    aec->sxd[i][1] = ptrGCoh[0] * aec->sxd[i][1] + ptrGCoh[1] *
+        (dfw[0][i] * xfw[i][1] - dfw[1][i] * xfw[i][0]);
+
+    *sdSum += aec->sd[i];
+    *seSum += aec->se[i];
+
+    cohde[i] = (aec->sde[i][0] * aec->sde[i][0] +
+        aec->sde[i][1] * aec->sde[i][1]) / (aec->sd[i] * aec->se[i] + 1e-10f);
+    cohxd[i] = (aec->sxd[i][0] * aec->sxd[i][0] +
+        aec->sxd[i][1] * aec->sxd[i][1]) / (aec->sx[i] * aec->sd[i] + 1e-10f);
+  }
+}
+
 void WebRtcAec_InitAec_SSE2(void) {
   WebRtcAec_FilterFar = FilterFarSSE2;
   WebRtcAec_ScaleErrorSignal = ScaleErrorSignalSSE2;
   WebRtcAec_FilterAdaptation = FilterAdaptationSSE2;
   WebRtcAec_OverdriveAndSuppress = OverdriveAndSuppressSSE2;
+  WebRtcAec_SubbandCoherence = SubbandCoherenceSSE2;
 }
 
 #endif   //__SSE2__
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the frame throughput of the AEC for one channel with and without
+// the SSE2 code, at 8, 16 and 32 kHz. At 32 kHz the near end is fed to both
+// bands. The float SSE2 code is not bit exact with C, so the largest output
+// difference is printed as well.
+//
+// Usage: aec_benchmark [far end pcm file] [near end pcm file] [repetitions]
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "cpu_features_wrapper.h"
+#include "echo_cancellation.h"
+#include "tick_util.h"
+
+namespace {
+const char kDefaultFarFile[] = "test/data/audio_processing/aec_far.pcm";
+const char kDefaultNearFile[] = "test/data/audio_processing/aec_near.pcm";
+const int kFrameSize = 160;
+
+bool ReadFile(const char* filename, std::vector<WebRtc_Word16>* data) {
+  FILE* file = fopen(filename, "rb");
+  if (file == NULL) {
+    printf("Unable to open %s\n", filename);
+    return false;
+  }
+  WebRtc_Word16 buffer[1024];
+  size_t read = 0;
+  while ((read = fread(buffer, sizeof(WebRtc_Word16), 1024, file)) > 0) {
+    data->insert(data->end(), buffer, buffer + read);
+  }
+  fclose(file);
+  return true;
+}
+
+// Processes the files |repetitions| times at |sample_rate_hz| in 10 ms frames
+// and stores the low band output of the last repetition in |output|. Returns
+// the processing time in microseconds, or -1 on error.
+WebRtc_Word64 Run(const std::vector<WebRtc_Word16>& far_end,
+                  const std::vector<WebRtc_Word16>& near_end,
+                  int sample_rate_hz, int repetitions,
+                  std::vector<WebRtc_Word16>* output) {
+  // The AEC runs on 80 or 160 samples per band.
+  const int frame_size = sample_rate_hz == 8000 ? 80 : kFrameSize;
+  const size_t length = far_end.size() < near_end.size() ?
+      far_end.size() : near_end.size();
+  const int num_frames = static_cast<int>(length) / frame_size;
+
+  void* aec = NULL;
+  if (WebRtcAec_Create(&aec) != 0) {
+    return -1;
+  }
+  if (WebRtcAec_Init(aec, sample_rate_hz, sample_rate_hz) != 0) {
+    WebRtcAec_Free(aec);
+    return -1;
+  }
+
+  output->assign(num_frames * frame_size, 0);
+  WebRtc_Word16 out_h[kFrameSize];
+  WebRtc_Word64 elapsed_us = 0;
+  for (int r = 0; r < repetitions; r++) {
+    for (int i = 0; i < num_frames; i++) {
+      const WebRtc_Word16* near_frame = &near_end[i * frame_size];
+
+      const webrtc::TickTime start = webrtc::TickTime::Now();
+      if (WebRtcAec_BufferFarend(aec, &far_end[i * frame_size],
+                                 frame_size) != 0 ||
+          WebRtcAec_Process(aec, near_frame,
+                            sample_rate_hz == 32000 ? near_frame : NULL,
+                            &(*output)[i * frame_size],
+                            sample_rate_hz == 32000 ? out_h : NULL,
+                            frame_size, 20, 0) != 0) {
+        WebRtcAec_Free(aec);
+        return -1;
+      }
+      elapsed_us += (webrtc::TickTime::Now() - start).Microseconds();
+    }
+  }
+
+  WebRtcAec_Free(aec);
+  return elapsed_us;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<WebRtc_Word16> far_end;
+  std::vector<WebRtc_Word16> near_end;
+  if (!ReadFile(argc > 1 ? argv[1] : kDefaultFarFile, &far_end) ||
+      !ReadFile(argc > 2 ? argv[2] : kDefaultNearFile, &near_end)) {
+    return 1;
+  }
+  const int repetitions = argc > 3 ? atoi(argv[3]) : 10;
+  if (repetitions < 1) {
+    printf("Invalid number of repetitions\n");
+    return 1;
+  }
+
+  const int kSampleRates[] = {8000, 16000, 32000};
+  const WebRtc_CPUInfo get_cpu_info = WebRtc_GetCPUInfo;
+  for (size_t i = 0; i < sizeof(kSampleRates) / sizeof(*kSampleRates); i++) {
+    const int frame_size = kSampleRates[i] == 8000 ? 80 : kFrameSize;
+    std::vector<WebRtc_Word16> reference;
+    std::vector<WebRtc_Word16> optimized;
+
+    // WebRtcAec_Init() selects the functions to use.
+    WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+    const WebRtc_Word64 c_us = Run(far_end, near_end, kSampleRates[i],
+                                   repetitions, &reference);
+    WebRtc_GetCPUInfo = get_cpu_info;
+    const WebRtc_Word64 simd_us = Run(far_end, near_end, kSampleRates[i],
+                                      repetitions, &optimized);
+    if (c_us < 0 || simd_us < 0) {
+      printf("Processing failed\n");
+      return 1;
+    }
+
+    int max_diff = 0;
+    for (size_t j = 0; j < reference.size(); j++) {
+      const int diff = abs(reference[j] - optimized[j]);
+      max_diff = diff > max_diff ? diff : max_diff;
+    }
+    const double frames = static_cast<double>(repetitions) *
+        (reference.size() / frame_size);
+    printf("%5d Hz: C %6.2f us/frame, SIMD %6.2f us/frame (%.2fx), "
+           "%.0f frames/s per core, max diff %d\n",
+           kSampleRates[i], c_us / frames, simd_us / frames,
+           simd_us > 0 ? static_cast<double>(c_us) / simd_us : 0.0,
+           simd_us > 0 ? frames * 1e6 / simd_us : 0.0, max_diff);
+  }
+  return 0;
+}
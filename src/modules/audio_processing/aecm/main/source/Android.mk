@@ -18,6 +18,12 @@ LOCAL_GENERATED_SOURCES :=
 LOCAL_SRC_FILES := echo_control_mobile.c \
     aecm_core.c 
 
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
+    aecm_core_neon.c.neon
+MY_ARCH_DEFS := '-DWEBRTC_ARCH_ARM_NEON'
+endif
+
 # Flags passed to both C and C++ files.
 MY_CFLAGS :=  
 MY_CFLAGS_C :=
@@ -31,7 +37,7 @@ MY_DEFS += \
     '-DWEBRTC_ANDROID' \
     '-DANDROID' 
 endif
-LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS)
+LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS) $(MY_ARCH_DEFS)
 
 # Include paths placed before CFLAGS/CPPFLAGS
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../../../.. \
@@ -32,6 +32,35 @@
         'aecm_core.c',
         'aecm_core.h',
       ],
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'aecm_core_sse2.c',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'aecm_core_neon.c',
+          ],
+        }],
+      ],
+    },
+    {
+      'target_name': 'aecm_simd_test',
+      'type': 'executable',
+      'dependencies': [
+        'aecm',
+        '../../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'include_dirs': [
+        '../../../../../system_wrappers/interface',
+      ],
+      'sources': [
+        '../test/aecm_simd_test.cc',
+      ],
     },
   ],
 }
@@ -15,6 +15,7 @@
 #include "ring_buffer.h"
 #include "echo_control_mobile.h"
 #include "typedefs.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
 
 #ifdef ARM_WINM_LOG
 #include <stdio.h>
@@ -39,7 +40,7 @@ FILE *testfile;
 #ifdef AECM_SHORT
 
 // Square root of Hanning window in Q14
-static const WebRtc_Word16 kSqrtHanning[] =
+const WebRtc_Word16 WebRtcAecm_kSqrtHanning[] =
 {
     0, 804, 1606, 2404, 3196, 3981, 4756, 5520,
     6270, 7005, 7723, 8423, 9102, 9760, 10394, 11003,
@@ -51,7 +52,7 @@ static const WebRtc_Word16 kSqrtHanning[] =
 #else
 
 // Square root of Hanning window in Q14
-static const WebRtc_Word16 kSqrtHanning[] = {0, 399, 798, 1196, 1594, 1990, 2386, 2780, 3172,
+const WebRtc_Word16 WebRtcAecm_kSqrtHanning[] = {0, 399, 798, 1196, 1594, 1990, 2386, 2780, 3172,
         3562, 3951, 4337, 4720, 5101, 5478, 5853, 6224, 6591, 6954, 7313, 7668, 8019, 8364,
         8705, 9040, 9370, 9695, 10013, 10326, 10633, 10933, 11227, 11514, 11795, 12068, 12335,
         12594, 12845, 13089, 13325, 13553, 13773, 13985, 14189, 14384, 14571, 14749, 14918,
@@ -111,6 +112,156 @@ static void WebRtcAecm_ComfortNoise(AecmCore_t* const aecm, const WebRtc_UWord16
                                     WebRtc_Word16 * const outImag,
                                     const WebRtc_Word16 * const lambda);
 
+static void WindowAndFFT(WebRtc_Word16* fft,
+                         const WebRtc_Word16* timeSignal,
+                         WebRtc_Word16 timeSignalScaling,
+                         WebRtc_Word16* freqSignal)
+{
+    int i, j;
+
+    for (i = 0; i < PART_LEN; i++)
+    {
+        j = WEBRTC_SPL_LSHIFT_W32(i, 1);
+        // Window time domain signal
+        fft[j] = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT((timeSignal[i] << timeSignalScaling),
+                WebRtcAecm_kSqrtHanning[i], 14);
+        fft[PART_LEN2 + j] = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT(
+                (timeSignal[PART_LEN + i] << timeSignalScaling),
+                WebRtcAecm_kSqrtHanning[PART_LEN - i], 14);
+        // Inserting zeros in imaginary parts
+        fft[j + 1] = 0;
+        fft[PART_LEN2 + j + 1] = 0;
+    }
+
+    // Fourier transformation of time domain signal.
+    // The result is scaled with 1/PART_LEN2, that is, the result is in Q(-6) for PART_LEN = 32
+    WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
+    WebRtcSpl_ComplexFFT(fft, PART_LEN_SHIFT, 1);
+
+    // Take only the first PART_LEN2 samples, the imaginary part has to switch sign
+    for (i = 0; i < PART_LEN2; i += 2)
+    {
+        freqSignal[i] = fft[i];
+        freqSignal[i + 1] = -fft[i + 1];
+    }
+}
+
+static void InverseFFTAndWindow(AecmCore_t* aecm,
+                                WebRtc_Word16* fft,
+                                const WebRtc_Word16* efwReal,
+                                const WebRtc_Word16* efwImag,
+                                WebRtc_Word16* output)
+{
+    int i, j, outCFFT;
+    WebRtc_Word32 tmp32no1;
+
+    for (i = 1; i < PART_LEN; i++)
+    {
+        j = WEBRTC_SPL_LSHIFT_W32(i, 1);
+        fft[j] = efwReal[i];
+
+        // mirrored data, even
+        fft[PART_LEN4 - j] = efwReal[i];
+        fft[j + 1] = -efwImag[i];
+
+        //mirrored data, odd
+        fft[PART_LEN4 - (j - 1)] = efwImag[i];
+    }
+    fft[0] = efwReal[0];
+    fft[1] = -efwImag[0];
+
+    fft[PART_LEN2] = efwReal[PART_LEN];
+    fft[PART_LEN2 + 1] = -efwImag[PART_LEN];
+
+    // inverse FFT, result should be scaled with outCFFT
+    WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
+    outCFFT = WebRtcSpl_ComplexIFFT(fft, PART_LEN_SHIFT, 1);
+
+    //take only the real values and scale with outCFFT
+    for (i = 0; i < PART_LEN2; i++)
+    {
+        j = WEBRTC_SPL_LSHIFT_W32(i, 1);
+        fft[i] = fft[j];
+    }
+
+    for (i = 0; i < PART_LEN; i++)
+    {
+        fft[i] = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(
+                fft[i],
+                WebRtcAecm_kSqrtHanning[i],
+                14);
+        tmp32no1 = WEBRTC_SPL_SHIFT_W32((WebRtc_Word32)fft[i],
+                outCFFT - aecm->dfaCleanQDomain);
+        fft[i] = (WebRtc_Word16)WEBRTC_SPL_SAT(WEBRTC_SPL_WORD16_MAX,
+                tmp32no1 + aecm->outBuf[i],
+                WEBRTC_SPL_WORD16_MIN);
+        output[i] = fft[i];
+
+        tmp32no1 = WEBRTC_SPL_MUL_16_16_RSFT(
+                fft[PART_LEN + i],
+                WebRtcAecm_kSqrtHanning[PART_LEN - i],
+                14);
+        tmp32no1 = WEBRTC_SPL_SHIFT_W32(tmp32no1,
+                outCFFT - aecm->dfaCleanQDomain);
+        aecm->outBuf[i] = (WebRtc_Word16)WEBRTC_SPL_SAT(
+                WEBRTC_SPL_WORD16_MAX,
+                tmp32no1,
+                WEBRTC_SPL_WORD16_MIN);
+    }
+}
+
+static void CalcLinearEnergies(AecmCore_t* aecm,
+                               const WebRtc_UWord16* farSpectrum,
+                               WebRtc_Word32* echoEst,
+                               WebRtc_UWord32* farEnergy,
+                               WebRtc_UWord32* echoEnergyAdapt,
+                               WebRtc_UWord32* echoEnergyStored)
+{
+    int i;
+
+    // Get energy for the delayed far end signal and estimated
+    // echo using both stored and adapted channels.
+    for (i = 0; i < PART_LEN1; i++)
+    {
+        echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], farSpectrum[i]);
+        (*farEnergy) += (WebRtc_UWord32)(farSpectrum[i]);
+        (*echoEnergyAdapt) += WEBRTC_SPL_UMUL_16_16(aecm->channelAdapt16[i], farSpectrum[i]);
+        (*echoEnergyStored) += (WebRtc_UWord32)echoEst[i];
+    }
+}
+
+static void StoreAdaptiveChannel(AecmCore_t* aecm,
+                                 const WebRtc_UWord16* farSpectrum,
+                                 WebRtc_Word32* echoEst)
+{
+    int i;
+
+    memcpy(aecm->channelStored, aecm->channelAdapt16, sizeof(WebRtc_Word16) * PART_LEN1);
+    // Recalculate echo estimate
+    for (i = 0; i < PART_LEN1; i++)
+    {
+        echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], farSpectrum[i]);
+    }
+}
+
+static void ResetAdaptiveChannel(AecmCore_t* aecm)
+{
+    int i;
+
+    memcpy(aecm->channelAdapt16, aecm->channelStored, sizeof(WebRtc_Word16) * PART_LEN1);
+    // Restore the W32 channel
+    for (i = 0; i < PART_LEN1; i++)
+    {
+        aecm->channelAdapt32[i] = WEBRTC_SPL_LSHIFT_W32((WebRtc_Word32)aecm->channelStored[i], 16);
+    }
+}
+
+WebRtcAecm_WindowAndFFT_t WebRtcAecm_WindowAndFFT;
+WebRtcAecm_InverseFFTAndWindow_t WebRtcAecm_InverseFFTAndWindow;
+WebRtcAecm_CalcLinearEnergies_t WebRtcAecm_CalcLinearEnergies;
+WebRtcAecm_StoreAdaptiveChannel_t WebRtcAecm_StoreAdaptiveChannel;
+WebRtcAecm_ResetAdaptiveChannel_t WebRtcAecm_ResetAdaptiveChannel;
+
 static __inline WebRtc_UWord32 WebRtcAecm_SetBit(WebRtc_UWord32 in, WebRtc_Word32 pos)
 {
     WebRtc_UWord32 mask, out;
@@ -409,6 +560,25 @@ int WebRtcAecm_InitCore(AecmCore_t * const aecm, int samplingFreq)
     aecm->supGainErrParamDiffAB = SUPGAIN_ERROR_PARAM_A - SUPGAIN_ERROR_PARAM_B;
     aecm->supGainErrParamDiffBD = SUPGAIN_ERROR_PARAM_B - SUPGAIN_ERROR_PARAM_D;
 
+    // Assembly optimization
+    WebRtcAecm_WindowAndFFT = WindowAndFFT;
+    WebRtcAecm_InverseFFTAndWindow = InverseFFTAndWindow;
+    WebRtcAecm_CalcLinearEnergies = CalcLinearEnergies;
+    WebRtcAecm_StoreAdaptiveChannel = StoreAdaptiveChannel;
+    WebRtcAecm_ResetAdaptiveChannel = ResetAdaptiveChannel;
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+#if defined(__SSE2__)
+        WebRtcAecm_InitCore_SSE2();
+#endif
+    }
+    if (WebRtc_GetCPUInfo(kNEON))
+    {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+        WebRtcAecm_InitCore_NEON();
+#endif
+    }
+
     return 0;
 }
 
@@ -492,7 +662,7 @@ WebRtc_Word16 WebRtcAecm_EstimateDelay(AecmCore_t * const aecm,
 
     for (i = 0; i < PART_LEN1; i++)
     {
-        aecm->xfaHistory[i][histpos] = farSpec[i];
+        aecm->xfaHistory[histpos][i] = farSpec[i];
 
         state = &(aecm->medianXlogspec[i]);
         res = WebRtcAecm_MedianEstimator(farSpec[i], state, 6);
@@ -780,17 +950,8 @@ void WebRtcAecm_CalcEnergies(AecmCore_t * const aecm, const WebRtc_Word16 delayD
     tmpAdapt = 0;
     tmpStored = 0;
     tmpFar = 0;
-
-    for (i = 0; i < PART_LEN1; i++)
-    {
-        // Get estimated echo energies for adaptive channel and stored channel
-        echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
-                aecm->xfaHistory[i][delayDiff]);
-        tmpFar += (WebRtc_UWord32)(aecm->xfaHistory[i][delayDiff]);
-        tmpAdapt += WEBRTC_SPL_UMUL_16_16(aecm->channelAdapt16[i],
-                aecm->xfaHistory[i][delayDiff]);
-        tmpStored += (WebRtc_UWord32)echoEst[i];
-    }
+    WebRtcAecm_CalcLinearEnergies(aecm, aecm->xfaHistory[delayDiff], echoEst, &tmpFar,
+                                  &tmpAdapt, &tmpStored);
     // Shift buffers
     memmove(aecm->farLogEnergy + 1, aecm->farLogEnergy,
             sizeof(WebRtc_Word16) * (MAX_BUF_LEN - 1));
@@ -1018,12 +1179,12 @@ void WebRtcAecm_UpdateChannel(AecmCore_t * const aecm, const WebRtc_UWord16 * co
             // Determine norm of channel and farend to make sure we don't get overflow in
             // multiplication
             zerosCh = WebRtcSpl_NormU32(aecm->channelAdapt32[i]);
-            zerosFar = WebRtcSpl_NormU32((WebRtc_UWord32)aecm->xfaHistory[i][delayDiff]);
+            zerosFar = WebRtcSpl_NormU32((WebRtc_UWord32)aecm->xfaHistory[delayDiff][i]);
             if (zerosCh + zerosFar > 31)
             {
                 // Multiplication is safe
                 tmpU32no1 = WEBRTC_SPL_UMUL_32_16(aecm->channelAdapt32[i],
-                        aecm->xfaHistory[i][delayDiff]);
+                        aecm->xfaHistory[delayDiff][i]);
                 shiftChFar = 0;
             } else
             {
@@ -1032,7 +1193,7 @@ void WebRtcAecm_UpdateChannel(AecmCore_t * const aecm, const WebRtc_UWord16 * co
                 tmpU32no1
                         = WEBRTC_SPL_UMUL_32_16(WEBRTC_SPL_RSHIFT_W32(aecm->channelAdapt32[i],
                                         shiftChFar),
-                                aecm->xfaHistory[i][delayDiff]);
+                                aecm->xfaHistory[delayDiff][i]);
             }
             // Determine Q-domain of numerator
             zerosNum = WebRtcSpl_NormU32(tmpU32no1);
@@ -1060,7 +1221,7 @@ void WebRtcAecm_UpdateChannel(AecmCore_t * const aecm, const WebRtc_UWord16 * co
             tmpU32no2 = WEBRTC_SPL_SHIFT_W32((WebRtc_UWord32)dfa[i], dfaQ);
             tmp32no1 = (WebRtc_Word32)tmpU32no2 - (WebRtc_Word32)tmpU32no1;
             zerosNum = WebRtcSpl_NormW32(tmp32no1);
-            if ((tmp32no1) && (aecm->xfaHistory[i][delayDiff] > (CHANNEL_VAD
+            if ((tmp32no1) && (aecm->xfaHistory[delayDiff][i] > (CHANNEL_VAD
                     << aecm->xfaQDomainBuf[delayDiff])))
             {
                 //
@@ -1068,10 +1229,10 @@ void WebRtcAecm_UpdateChannel(AecmCore_t * const aecm, const WebRtc_UWord16 * co
                 //
                 // This is what we would like to compute
                 //
-                // tmp32no1 = dfa[i] - (aecm->channelAdapt[i] * aecm->xfaHistory[i][delayDiff])
+                // tmp32no1 = dfa[i] - (aecm->channelAdapt[i] * aecm->xfaHistory[delayDiff][i])
                 // tmp32norm = (i + 1)
                 // aecm->channelAdapt[i] += (2^mu) * tmp32no1
-                //                        / (tmp32norm * aecm->xfaHistory[i][delayDiff])
+                //                        / (tmp32norm * aecm->xfaHistory[delayDiff][i])
                 //
 
                 // Make sure we don't get overflow in multiplication.
@@ -1080,11 +1241,11 @@ void WebRtcAecm_UpdateChannel(AecmCore_t * const aecm, const WebRtc_UWord16 * co
                     if (tmp32no1 > 0)
                     {
                         tmp32no2 = (WebRtc_Word32)WEBRTC_SPL_UMUL_32_16(tmp32no1,
-                                aecm->xfaHistory[i][delayDiff]);
+                                aecm->xfaHistory[delayDiff][i]);
                     } else
                     {
                         tmp32no2 = -(WebRtc_Word32)WEBRTC_SPL_UMUL_32_16(-tmp32no1,
-                                aecm->xfaHistory[i][delayDiff]);
+                                aecm->xfaHistory[delayDiff][i]);
                     }
                     shiftNum = 0;
                 } else
@@ -1094,12 +1255,12 @@ void WebRtcAecm_UpdateChannel(AecmCore_t * const aecm, const WebRtc_UWord16 * co
                     {
                         tmp32no2 = (WebRtc_Word32)WEBRTC_SPL_UMUL_32_16(
                                 WEBRTC_SPL_RSHIFT_W32(tmp32no1, shiftNum),
-                                aecm->xfaHistory[i][delayDiff]);
+                                aecm->xfaHistory[delayDiff][i]);
                     } else
                     {
                         tmp32no2 = -(WebRtc_Word32)WEBRTC_SPL_UMUL_32_16(
                                 WEBRTC_SPL_RSHIFT_W32(-tmp32no1, shiftNum),
-                                aecm->xfaHistory[i][delayDiff]);
+                                aecm->xfaHistory[delayDiff][i]);
                     }
                 }
                 // Normalize with respect to frequency bin
@@ -1130,38 +1291,12 @@ void WebRtcAecm_UpdateChannel(AecmCore_t * const aecm, const WebRtc_UWord16 * co
     // Determine if we should store or restore the channel
     if ((aecm->startupState == 0) & (aecm->currentVADValue))
     {
-        // During startup we store the channel every block.
-        memcpy(aecm->channelStored, aecm->channelAdapt16, sizeof(WebRtc_Word16) * PART_LEN1);
+        // During startup we store the channel every block,
+        // and we recalculate echo estimate.
+        WebRtcAecm_StoreAdaptiveChannel(aecm, aecm->xfaHistory[delayDiff], echoEst);
         // TODO(bjornv): Will be removed in final version.
 #ifdef STORE_CHANNEL_DATA
         fwrite(aecm->channelStored, sizeof(WebRtc_Word16), PART_LEN1, aecm->channel_file_init);
-#endif
-        // Recalculate echo estimate
-#if (!defined ARM_WINM) && (!defined ARM9E_GCC) && (!defined ANDROID_AECOPT)
-        for (i = 0; i < PART_LEN1; i++)
-        {
-            echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
-                    aecm->xfaHistory[i][delayDiff]);
-        }
-#else
-        for (i = 0; i < PART_LEN; ) //assume PART_LEN is 4's multiples
-
-        {
-            echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
-                    aecm->xfaHistory[i][delayDiff]);
-            i++;
-            echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
-                    aecm->xfaHistory[i][delayDiff]);
-            i++;
-            echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
-                    aecm->xfaHistory[i][delayDiff]);
-            i++;
-            echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
-                    aecm->xfaHistory[i][delayDiff]);
-            i++;
-        }
-        echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i],
-                aecm->xfaHistory[i][delayDiff]);
 #endif
     } else
     {
@@ -1200,65 +1335,18 @@ void WebRtcAecm_UpdateChannel(AecmCore_t * const aecm, const WebRtc_UWord16 * co
             {
                 // The stored channel has a significantly lower MSE than the adaptive one for
                 // two consecutive calculations. Reset the adaptive channel.
-                memcpy(aecm->channelAdapt16, aecm->channelStored,
-                       sizeof(WebRtc_Word16) * PART_LEN1);
-                // Restore the W32 channel
-#if (!defined ARM_WINM) && (!defined ARM9E_GCC) && (!defined ANDROID_AECOPT)
-                for (i = 0; i < PART_LEN1; i++)
-                {
-                    aecm->channelAdapt32[i]
-                            = WEBRTC_SPL_LSHIFT_W32((WebRtc_Word32)aecm->channelStored[i], 16);
-                }
-#else
-                for (i = 0; i < PART_LEN; ) //assume PART_LEN is 4's multiples
-
-                {
-                    aecm->channelAdapt32[i] = WEBRTC_SPL_LSHIFT_W32((WebRtc_Word32)aecm->channelStored[i], 16);
-                    i++;
-                    aecm->channelAdapt32[i] = WEBRTC_SPL_LSHIFT_W32((WebRtc_Word32)aecm->channelStored[i], 16);
-                    i++;
-                    aecm->channelAdapt32[i] = WEBRTC_SPL_LSHIFT_W32((WebRtc_Word32)aecm->channelStored[i], 16);
-                    i++;
-                    aecm->channelAdapt32[i] = WEBRTC_SPL_LSHIFT_W32((WebRtc_Word32)aecm->channelStored[i], 16);
-                    i++;
-                }
-                aecm->channelAdapt32[i] = WEBRTC_SPL_LSHIFT_W32((WebRtc_Word32)aecm->channelStored[i], 16);
-#endif
-
+                WebRtcAecm_ResetAdaptiveChannel(aecm);
             } else if (((MIN_MSE_DIFF * mseStored) > (mseAdapt << MSE_RESOLUTION)) & (mseAdapt
                     < aecm->mseThreshold) & (aecm->mseAdaptOld < aecm->mseThreshold))
             {
                 // The adaptive channel has a significantly lower MSE than the stored one.
                 // The MSE for the adaptive channel has also been low for two consecutive
-                // calculations. Store the adaptive channel.
-                memcpy(aecm->channelStored, aecm->channelAdapt16,
-                       sizeof(WebRtc_Word16) * PART_LEN1);
+                // calculations. Store the adaptive channel and recalculate echo estimate.
+                WebRtcAecm_StoreAdaptiveChannel(aecm, aecm->xfaHistory[delayDiff], echoEst);
                 // TODO(bjornv): Will be removed in final version.
 #ifdef STORE_CHANNEL_DATA
                 fwrite(aecm->channelStored, sizeof(WebRtc_Word16), PART_LEN1,
                        aecm->channel_file);
-#endif
-// Recalculate echo estimate
-#if (!defined ARM_WINM) && (!defined ARM9E_GCC) && (!defined ANDROID_AECOPT)
-                for (i = 0; i < PART_LEN1; i++)
-                {
-                    echoEst[i]
-                            = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], aecm->xfaHistory[i][delayDiff]);
-                }
-#else
-                for (i = 0; i < PART_LEN; ) //assume PART_LEN is 4's multiples
-
-                {
-                    echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], aecm->xfaHistory[i][delayDiff]);
-                    i++;
-                    echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], aecm->xfaHistory[i][delayDiff]);
-                    i++;
-                    echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], aecm->xfaHistory[i][delayDiff]);
-                    i++;
-                    echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], aecm->xfaHistory[i][delayDiff]);
-                    i++;
-                }
-                echoEst[i] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[i], aecm->xfaHistory[i][delayDiff]);
 #endif
                 // Update threshold
                 if (aecm->mseThreshold == WEBRTC_SPL_WORD32_MAX)
@@ -1514,8 +1602,6 @@ void WebRtcAecm_ProcessBlock(AecmCore_t * const aecm, const WebRtc_Word16 * cons
     WebRtc_UWord16 dfaClean[PART_LEN1];
     WebRtc_UWord16* ptrDfaClean = dfaClean;
 
-    int outCFFT;
-
     WebRtc_Word16 fft[PART_LEN4];
     WebRtc_Word16 postFft[PART_LEN2];
     WebRtc_Word16 dfwReal[PART_LEN1];
@@ -1613,38 +1699,8 @@ void WebRtcAecm_ProcessBlock(AecmCore_t * const aecm, const WebRtc_Word16 * cons
     QueryPerformanceCounter((LARGE_INTEGER*)&start);
 #endif
 
-    // FFT of noisy near end signal
-    for (i = 0; i < PART_LEN; i++)
-    {
-        j = WEBRTC_SPL_LSHIFT_W32(i, 1);
-        // Window near end
-        fft[j] = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT((aecm->dBufNoisy[i]
-                        << zerosDBufNoisy), kSqrtHanning[i], 14);
-        fft[PART_LEN2 + j] = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT(
-                (aecm->dBufNoisy[PART_LEN + i] << zerosDBufNoisy),
-                kSqrtHanning[PART_LEN - i], 14);
-        // Inserting zeros in imaginary parts
-        fft[j + 1] = 0;
-        fft[PART_LEN2 + j + 1] = 0;
-    }
-
-    // Fourier transformation of near end signal.
-    // The result is scaled with 1/PART_LEN2, that is, the result is in Q(-6) for PART_LEN = 32
-
-    WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
-    outCFFT = WebRtcSpl_ComplexFFT(fft, PART_LEN_SHIFT, 1);
-
-    // Take only the first PART_LEN2 samples
-    for (i = 0; i < PART_LEN2; i++)
-    {
-        postFft[i] = fft[i];
-    }
-    // The imaginary part has to switch sign
-    for (i = 1; i < PART_LEN2;)
-    {
-        postFft[i] = -postFft[i];
-        i += 2;
-    }
+    // Transform noisy near end signal
+    WebRtcAecm_WindowAndFFT(fft, aecm->dBufNoisy, zerosDBufNoisy, postFft);
 
     // Extract imaginary and real part, calculate the magnitude for all frequency bins
     dfwImag[0] = 0;
@@ -1721,36 +1777,8 @@ void WebRtcAecm_ProcessBlock(AecmCore_t * const aecm, const WebRtc_Word16 * cons
         ptrDfaClean = dfaNoisy;
     } else
     {
-        // FFT of clean near end signal
-        for (i = 0; i < PART_LEN; i++)
-        {
-            j = WEBRTC_SPL_LSHIFT_W32(i, 1);
-            // Window near end
-            fft[j]
-                    = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT((aecm->dBufClean[i] << zerosDBufClean), kSqrtHanning[i], 14);
-            fft[PART_LEN2 + j]
-                    = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT((aecm->dBufClean[PART_LEN + i] << zerosDBufClean), kSqrtHanning[PART_LEN - i], 14);
-            // Inserting zeros in imaginary parts
-            fft[j + 1] = 0;
-            fft[PART_LEN2 + j + 1] = 0;
-        }
-
-        // Fourier transformation of near end signal.
-        // The result is scaled with 1/PART_LEN2, that is, in Q(-6) for PART_LEN = 32
-        WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
-        outCFFT = WebRtcSpl_ComplexFFT(fft, PART_LEN_SHIFT, 1);
-
-        // Take only the first PART_LEN2 samples
-        for (i = 0; i < PART_LEN2; i++)
-        {
-            postFft[i] = fft[i];
-        }
-        // The imaginary part has to switch sign
-        for (i = 1; i < PART_LEN2;)
-        {
-            postFft[i] = -postFft[i];
-            i += 2;
-        }
+        // Transform clean near end signal
+        WebRtcAecm_WindowAndFFT(fft, aecm->dBufClean, zerosDBufClean, postFft);
 
         // Extract imaginary and real part, calculate the magnitude for all frequency bins
         dfwImag[0] = 0;
@@ -1820,35 +1848,8 @@ void WebRtcAecm_ProcessBlock(AecmCore_t * const aecm, const WebRtc_Word16 * cons
     }
     // END: FFT of clean near end signal
 
-    // FFT of far end signal
-    for (i = 0; i < PART_LEN; i++)
-    {
-        j = WEBRTC_SPL_LSHIFT_W32(i, 1);
-        // Window farend
-        fft[j]
-                = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT((aecm->xBuf[i] << zerosXBuf), kSqrtHanning[i], 14);
-        fft[PART_LEN2 + j]
-                = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT((aecm->xBuf[PART_LEN + i] << zerosXBuf), kSqrtHanning[PART_LEN - i], 14);
-        // Inserting zeros in imaginary parts
-        fft[j + 1] = 0;
-        fft[PART_LEN2 + j + 1] = 0;
-    }
-    // Fourier transformation of far end signal.
-    // The result is scaled with 1/PART_LEN2, that is the result is in Q(-6) for PART_LEN = 32
-    WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
-    outCFFT = WebRtcSpl_ComplexFFT(fft, PART_LEN_SHIFT, 1);
-
-    // Take only the first PART_LEN2 samples
-    for (i = 0; i < PART_LEN2; i++)
-    {
-        postFft[i] = fft[i];
-    }
-    // The imaginary part has to switch sign
-    for (i = 1; i < PART_LEN2;)
-    {
-        postFft[i] = -postFft[i];
-        i += 2;
-    }
+    // Transform far end signal
+    WebRtcAecm_WindowAndFFT(fft, aecm->xBuf, zerosXBuf, postFft);
 
     // Extract imaginary and real part, calculate the magnitude for all frequency bins
     xfwImag[0] = 0;
@@ -2222,59 +2223,7 @@ void WebRtcAecm_ProcessBlock(AecmCore_t * const aecm, const WebRtc_Word16 * cons
 #endif
 
     // Synthesis
-    for (i = 1; i < PART_LEN; i++)
-    {
-        j = WEBRTC_SPL_LSHIFT_W32(i, 1);
-        fft[j] = efwReal[i];
-
-        // mirrored data, even
-        fft[PART_LEN4 - j] = efwReal[i];
-        fft[j + 1] = -efwImag[i];
-
-        //mirrored data, odd
-        fft[PART_LEN4 - (j - 1)] = efwImag[i];
-    }
-    fft[0] = efwReal[0];
-    fft[1] = -efwImag[0];
-
-    fft[PART_LEN2] = efwReal[PART_LEN];
-    fft[PART_LEN2 + 1] = -efwImag[PART_LEN];
-
-    // inverse FFT, result should be scaled with outCFFT
-    WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
-    outCFFT = WebRtcSpl_ComplexIFFT(fft, PART_LEN_SHIFT, 1);
-
-    //take only the real values and scale with outCFFT
-    for (i = 0; i < PART_LEN2; i++)
-    {
-        j = WEBRTC_SPL_LSHIFT_W32(i, 1);
-        fft[i] = fft[j];
-    }
-
-    for (i = 0; i < PART_LEN; i++)
-    {
-        fft[i] = (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(
-                fft[i],
-                kSqrtHanning[i],
-                14);
-        tmp32no1 = WEBRTC_SPL_SHIFT_W32((WebRtc_Word32)fft[i],
-                outCFFT - aecm->dfaCleanQDomain);
-        fft[i] = (WebRtc_Word16)WEBRTC_SPL_SAT(WEBRTC_SPL_WORD16_MAX,
-                tmp32no1 + aecm->outBuf[i],
-                WEBRTC_SPL_WORD16_MIN);
-        output[i] = fft[i];
-
-        tmp32no1 = WEBRTC_SPL_MUL_16_16_RSFT(
-                fft[PART_LEN + i],
-                kSqrtHanning[PART_LEN - i],
-                14);
-        tmp32no1 = WEBRTC_SPL_SHIFT_W32(tmp32no1,
-                outCFFT - aecm->dfaCleanQDomain);
-        aecm->outBuf[i] = (WebRtc_Word16)WEBRTC_SPL_SAT(
-                WEBRTC_SPL_WORD16_MAX,
-                tmp32no1,
-                WEBRTC_SPL_WORD16_MIN);
-    }
+    WebRtcAecm_InverseFFTAndWindow(aecm, fft, efwReal, efwImag, output);
 
 #ifdef ARM_WINM_LOG_
     // measure tick end
@@ -130,7 +130,7 @@ typedef struct
     WebRtc_UWord16 medianYlogspec[PART_LEN1];
     WebRtc_UWord16 medianXlogspec[PART_LEN1];
     WebRtc_UWord16 medianBCount[MAX_DELAY];
-    WebRtc_UWord16 xfaHistory[PART_LEN1][MAX_DELAY];
+    WebRtc_UWord16 xfaHistory[MAX_DELAY][PART_LEN1];
     WebRtc_Word16 delHistoryPos;
     WebRtc_UWord32 bxHistory[MAX_DELAY];
     WebRtc_UWord16 currentDelay;
@@ -349,4 +349,55 @@ void WebRtcAecm_BufferFarFrame(AecmCore_t * const aecm, const WebRtc_Word16 * co
 void WebRtcAecm_FetchFarFrame(AecmCore_t * const aecm, WebRtc_Word16 * const farend,
                               const int farLen, const int knownDelay);
 
+// Square root of Hanning window in Q14, PART_LEN1 values.
+extern const WebRtc_Word16 WebRtcAecm_kSqrtHanning[];
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Speed-critical functions of WebRtcAecm_ProcessBlock(...), selected in
+// WebRtcAecm_InitCore(...) depending on the CPU. The SSE2 and NEON versions give the same
+// result as the C versions.
+//
+
+// Windows one block (PART_LEN2 samples) of |timeSignal| scaled up by
+// |timeSignalScaling| and transforms it. Stores the first PART_LEN complex values
+// of the spectrum, interleaved, in |freqSignal|. The real valued bin PART_LEN is
+// left in fft[PART_LEN2].
+typedef void (*WebRtcAecm_WindowAndFFT_t)(WebRtc_Word16* fft,
+                                          const WebRtc_Word16* timeSignal,
+                                          WebRtc_Word16 timeSignalScaling,
+                                          WebRtc_Word16* freqSignal);
+extern WebRtcAecm_WindowAndFFT_t WebRtcAecm_WindowAndFFT;
+
+// Inverse transforms the spectrum (efwReal, efwImag), windows it and overlap-adds it
+// with aecm->outBuf into |output| (PART_LEN samples).
+typedef void (*WebRtcAecm_InverseFFTAndWindow_t)(AecmCore_t* aecm,
+                                                 WebRtc_Word16* fft,
+                                                 const WebRtc_Word16* efwReal,
+                                                 const WebRtc_Word16* efwImag,
+                                                 WebRtc_Word16* output);
+extern WebRtcAecm_InverseFFTAndWindow_t WebRtcAecm_InverseFFTAndWindow;
+
+// Calculates the echo estimate through the stored channel, and the far end energy and
+// the echo energies through the adaptive and the stored channel.
+typedef void (*WebRtcAecm_CalcLinearEnergies_t)(AecmCore_t* aecm,
+                                                const WebRtc_UWord16* farSpectrum,
+                                                WebRtc_Word32* echoEst,
+                                                WebRtc_UWord32* farEnergy,
+                                                WebRtc_UWord32* echoEnergyAdapt,
+                                                WebRtc_UWord32* echoEnergyStored);
+extern WebRtcAecm_CalcLinearEnergies_t WebRtcAecm_CalcLinearEnergies;
+
+// Stores the adaptive channel and recalculates the echo estimate with it.
+typedef void (*WebRtcAecm_StoreAdaptiveChannel_t)(AecmCore_t* aecm,
+                                                  const WebRtc_UWord16* farSpectrum,
+                                                  WebRtc_Word32* echoEst);
+extern WebRtcAecm_StoreAdaptiveChannel_t WebRtcAecm_StoreAdaptiveChannel;
+
+// Restores the adaptive channel from the stored channel.
+typedef void (*WebRtcAecm_ResetAdaptiveChannel_t)(AecmCore_t* aecm);
+extern WebRtcAecm_ResetAdaptiveChannel_t WebRtcAecm_ResetAdaptiveChannel;
+
+void WebRtcAecm_InitCore_SSE2(void);
+void WebRtcAecm_InitCore_NEON(void);
+
 #endif
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core AECM algorithm, NEON version of speed-critical functions. The
+ * results are bit exact with the C versions in aecm_core.c.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+#include <string.h>
+
+#include "aecm_core.h"
+#include "spl_simd_inl.h"
+
+// Loads WebRtcAecm_kSqrtHanning[PART_LEN - i - k] for k = 0..7.
+static __inline int16x8_t LoadWindowReversed(int i) {
+  const int16x8_t a = vrev64q_s16(vld1q_s16(
+      &WebRtcAecm_kSqrtHanning[PART_LEN - i - 7]));
+  return vcombine_s16(vget_high_s16(a), vget_low_s16(a));
+}
+
+// WEBRTC_SPL_MUL_16_U16 of four values. The product of a signed and an
+// unsigned 16-bit value always fits in 32 signed bits.
+static __inline int32x4_t MulS16U16(int16x4_t a, uint16x4_t b) {
+  return vmulq_s32(vmovl_s16(a), vreinterpretq_s32_u32(vmovl_u16(b)));
+}
+
+// (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT(a, window, 14) of eight values.
+// The window is at most 1 in Q14, so the result always fits in 16 bits.
+static __inline int16x8_t MulWindow(int16x8_t a, int16x8_t window) {
+  return vcombine_s16(
+      vshrn_n_s32(vmull_s16(vget_low_s16(a), vget_low_s16(window)), 14),
+      vshrn_n_s32(vmull_s16(vget_high_s16(a), vget_high_s16(window)), 14));
+}
+
+static void WindowAndFFTNeon(WebRtc_Word16* fft,
+                             const WebRtc_Word16* timeSignal,
+                             WebRtc_Word16 timeSignalScaling,
+                             WebRtc_Word16* freqSignal) {
+  const int16x8_t scaling = vdupq_n_s16(timeSignalScaling);
+  int16x8x2_t first;
+  int16x8x2_t second;
+  int i;
+
+  // Inserting zeros in imaginary parts.
+  first.val[1] = vdupq_n_s16(0);
+  second.val[1] = vdupq_n_s16(0);
+  for (i = 0; i < PART_LEN; i += 8) {
+    first.val[0] = MulWindow(vshlq_s16(vld1q_s16(&timeSignal[i]), scaling),
+                             vld1q_s16(&WebRtcAecm_kSqrtHanning[i]));
+    second.val[0] = MulWindow(
+        vshlq_s16(vld1q_s16(&timeSignal[PART_LEN + i]), scaling),
+        LoadWindowReversed(i));
+    vst2q_s16(&fft[2 * i], first);
+    vst2q_s16(&fft[PART_LEN2 + 2 * i], second);
+  }
+
+  WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
+  WebRtcSpl_ComplexFFT(fft, PART_LEN_SHIFT, 1);
+
+  // The imaginary part has to switch sign.
+  for (i = 0; i < PART_LEN2; i += 16) {
+    int16x8x2_t spectrum = vld2q_s16(&fft[i]);
+    spectrum.val[1] = vnegq_s16(spectrum.val[1]);
+    vst2q_s16(&freqSignal[i], spectrum);
+  }
+}
+
+static void InverseFFTAndWindowNeon(AecmCore_t* aecm,
+                                    WebRtc_Word16* fft,
+                                    const WebRtc_Word16* efwReal,
+                                    const WebRtc_Word16* efwImag,
+                                    WebRtc_Word16* output) {
+  int32x4_t shift;
+  int i, outCFFT;
+
+  // Conjugate symmetric spectrum.
+  for (i = 0; i < PART_LEN; i += 8) {
+    int16x8x2_t spectrum;
+    spectrum.val[0] = vld1q_s16(&efwReal[i]);
+    spectrum.val[1] = vnegq_s16(vld1q_s16(&efwImag[i]));
+    vst2q_s16(&fft[2 * i], spectrum);
+  }
+  fft[PART_LEN2] = efwReal[PART_LEN];
+  fft[PART_LEN2 + 1] = -efwImag[PART_LEN];
+  // Mirrored data: bin i goes to fft[PART_LEN4 - 2 * i], i = 1..PART_LEN - 1.
+  for (i = 1; i + 3 < PART_LEN; i += 4) {
+    const int16x4x2_t pairs = vzip_s16(vld1_s16(&efwReal[i]),
+                                       vld1_s16(&efwImag[i]));
+    // Reverse the order of the four (real, imag) pairs.
+    const int32x4_t reversed = vrev64q_s32(vreinterpretq_s32_s16(
+        vcombine_s16(pairs.val[1], pairs.val[0])));
+    vst1q_s16(&fft[PART_LEN4 - 2 * (i + 3)], vreinterpretq_s16_s32(reversed));
+  }
+  for (; i < PART_LEN; i++) {
+    fft[PART_LEN4 - 2 * i] = efwReal[i];
+    fft[PART_LEN4 - 2 * i + 1] = efwImag[i];
+  }
+
+  WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
+  outCFFT = WebRtcSpl_ComplexIFFT(fft, PART_LEN_SHIFT, 1);
+
+  // A negative shift is a right shift, as in WEBRTC_SPL_SHIFT_W32().
+  shift = vdupq_n_s32(outCFFT - aecm->dfaCleanQDomain);
+
+  // Take the real values, window and overlap-add.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const int16x8_t window = vld1q_s16(&WebRtcAecm_kSqrtHanning[i]);
+    const int16x8_t window_reversed = LoadWindowReversed(i);
+    const int16x8_t out_buf = vld1q_s16(&aecm->outBuf[i]);
+    const int16x8_t first = vld2q_s16(&fft[2 * i]).val[0];
+    const int16x8_t second = vld2q_s16(&fft[PART_LEN2 + 2 * i]).val[0];
+    int32x4_t out_lo = vrshrq_n_s32(
+        vmull_s16(vget_low_s16(first), vget_low_s16(window)), 14);
+    int32x4_t out_hi = vrshrq_n_s32(
+        vmull_s16(vget_high_s16(first), vget_high_s16(window)), 14);
+    int32x4_t buf_lo = vshrq_n_s32(
+        vmull_s16(vget_low_s16(second), vget_low_s16(window_reversed)), 14);
+    int32x4_t buf_hi = vshrq_n_s32(
+        vmull_s16(vget_high_s16(second), vget_high_s16(window_reversed)), 14);
+
+    out_lo = vaddw_s16(vshlq_s32(out_lo, shift), vget_low_s16(out_buf));
+    out_hi = vaddw_s16(vshlq_s32(out_hi, shift), vget_high_s16(out_buf));
+    vst1q_s16(&output[i], vcombine_s16(vqmovn_s32(out_lo),
+                                       vqmovn_s32(out_hi)));
+
+    buf_lo = vshlq_s32(buf_lo, shift);
+    buf_hi = vshlq_s32(buf_hi, shift);
+    vst1q_s16(&aecm->outBuf[i], vcombine_s16(vqmovn_s32(buf_lo),
+                                             vqmovn_s32(buf_hi)));
+  }
+}
+
+static void CalcLinearEnergiesNeon(AecmCore_t* aecm,
+                                   const WebRtc_UWord16* farSpectrum,
+                                   WebRtc_Word32* echoEst,
+                                   WebRtc_UWord32* farEnergy,
+                                   WebRtc_UWord32* echoEnergyAdapt,
+                                   WebRtc_UWord32* echoEnergyStored) {
+  uint32x4_t far_energy = vdupq_n_u32(0);
+  uint32x4_t echo_energy_adapt = vdupq_n_u32(0);
+  uint32x4_t echo_energy_stored = vdupq_n_u32(0);
+  int i;
+
+  // The sums wrap around like the unsigned sums of the C version.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const uint16x8_t far = vld1q_u16(&farSpectrum[i]);
+    const int16x8_t stored = vld1q_s16(&aecm->channelStored[i]);
+    const uint16x8_t adapt = vreinterpretq_u16_s16(
+        vld1q_s16(&aecm->channelAdapt16[i]));
+    const int32x4_t echo_lo = MulS16U16(vget_low_s16(stored),
+                                        vget_low_u16(far));
+    const int32x4_t echo_hi = MulS16U16(vget_high_s16(stored),
+                                        vget_high_u16(far));
+
+    vst1q_s32(&echoEst[i], echo_lo);
+    vst1q_s32(&echoEst[i + 4], echo_hi);
+
+    far_energy = vpadalq_u16(far_energy, far);
+    echo_energy_adapt = vaddq_u32(echo_energy_adapt, vaddq_u32(
+        vmull_u16(vget_low_u16(adapt), vget_low_u16(far)),
+        vmull_u16(vget_high_u16(adapt), vget_high_u16(far))));
+    echo_energy_stored = vaddq_u32(echo_energy_stored, vreinterpretq_u32_s32(
+        vaddq_s32(echo_lo, echo_hi)));
+  }
+
+  echoEst[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                            farSpectrum[PART_LEN]);
+  // The sums wrap around as in C.
+  (*farEnergy) += (WebRtc_UWord32)WebRtcSpl_HorizontalSumNeon(
+      vreinterpretq_s32_u32(far_energy)) +
+      (WebRtc_UWord32)farSpectrum[PART_LEN];
+  (*echoEnergyAdapt) += (WebRtc_UWord32)WebRtcSpl_HorizontalSumNeon(
+      vreinterpretq_s32_u32(echo_energy_adapt)) +
+      WEBRTC_SPL_UMUL_16_16(aecm->channelAdapt16[PART_LEN],
+                            farSpectrum[PART_LEN]);
+  (*echoEnergyStored) += (WebRtc_UWord32)WebRtcSpl_HorizontalSumNeon(
+      vreinterpretq_s32_u32(echo_energy_stored)) +
+      (WebRtc_UWord32)echoEst[PART_LEN];
+}
+
+static void StoreAdaptiveChannelNeon(AecmCore_t* aecm,
+                                     const WebRtc_UWord16* farSpectrum,
+                                     WebRtc_Word32* echoEst) {
+  int i;
+
+  memcpy(aecm->channelStored, aecm->channelAdapt16,
+         sizeof(WebRtc_Word16) * PART_LEN1);
+  for (i = 0; i < PART_LEN; i += 8) {
+    const uint16x8_t far = vld1q_u16(&farSpectrum[i]);
+    const int16x8_t stored = vld1q_s16(&aecm->channelStored[i]);
+    vst1q_s32(&echoEst[i], MulS16U16(vget_low_s16(stored),
+                                     vget_low_u16(far)));
+    vst1q_s32(&echoEst[i + 4], MulS16U16(vget_high_s16(stored),
+                                         vget_high_u16(far)));
+  }
+  echoEst[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                            farSpectrum[PART_LEN]);
+}
+
+static void ResetAdaptiveChannelNeon(AecmCore_t* aecm) {
+  int i;
+
+  memcpy(aecm->channelAdapt16, aecm->channelStored,
+         sizeof(WebRtc_Word16) * PART_LEN1);
+  for (i = 0; i < PART_LEN; i += 8) {
+    const int16x8_t stored = vld1q_s16(&aecm->channelStored[i]);
+    vst1q_s32(&aecm->channelAdapt32[i],
+              vshll_n_s16(vget_low_s16(stored), 16));
+    vst1q_s32(&aecm->channelAdapt32[i + 4],
+              vshll_n_s16(vget_high_s16(stored), 16));
+  }
+  aecm->channelAdapt32[PART_LEN] = WEBRTC_SPL_LSHIFT_W32(
+      (WebRtc_Word32)aecm->channelStored[PART_LEN], 16);
+}
+
+void WebRtcAecm_InitCore_NEON(void) {
+  WebRtcAecm_WindowAndFFT = WindowAndFFTNeon;
+  WebRtcAecm_InverseFFTAndWindow = InverseFFTAndWindowNeon;
+  WebRtcAecm_CalcLinearEnergies = CalcLinearEnergiesNeon;
+  WebRtcAecm_StoreAdaptiveChannel = StoreAdaptiveChannelNeon;
+  WebRtcAecm_ResetAdaptiveChannel = ResetAdaptiveChannelNeon;
+}
+
+#endif   // WEBRTC_ARCH_ARM_NEON
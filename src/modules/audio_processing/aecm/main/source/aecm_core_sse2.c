@@ -0,0 +1,278 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core AECM algorithm, SSE2 version of speed-critical functions. The
+ * results are bit exact with the C versions in aecm_core.c.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#include <string.h>
+
+#include "aecm_core.h"
+#include "spl_simd_inl.h"
+
+// Reverses the order of eight 16-bit values.
+static __inline __m128i Reverse16(__m128i a) {
+  a = _mm_shufflelo_epi16(a, _MM_SHUFFLE(0, 1, 2, 3));
+  a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(0, 1, 2, 3));
+  return _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+// Loads WebRtcAecm_kSqrtHanning[PART_LEN - i - k] for k = 0..7.
+static __inline __m128i LoadWindowReversed(int i) {
+  return Reverse16(_mm_loadu_si128(
+      (const __m128i*)&WebRtcAecm_kSqrtHanning[PART_LEN - i - 7]));
+}
+
+// WEBRTC_SPL_MUL_16_U16 of eight values. |lo| and |hi| get the 32-bit
+// products of the low and high four values.
+static __inline void MulS16U16(__m128i a, __m128i b, __m128i* lo,
+                               __m128i* hi) {
+  const __m128i low = _mm_mullo_epi16(a, b);
+  // _mm_mulhi_epi16() treats |b| as signed, which is |b| - 2^16 when the
+  // sign bit is set. Add back 2^16 * |a| in that case.
+  const __m128i high = _mm_add_epi16(_mm_mulhi_epi16(a, b),
+                                     _mm_and_si128(a, _mm_srai_epi16(b, 15)));
+  *lo = _mm_unpacklo_epi16(low, high);
+  *hi = _mm_unpackhi_epi16(low, high);
+}
+
+// (WebRtc_Word16)WEBRTC_SPL_MUL_16_16_RSFT(a, window, 14) of eight values.
+// The window is at most 1 in Q14, so the result always fits in 16 bits.
+static __inline __m128i MulWindow(__m128i a, __m128i window) {
+  const __m128i low = _mm_mullo_epi16(a, window);
+  const __m128i high = _mm_mulhi_epi16(a, window);
+  return _mm_packs_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(low, high), 14),
+                         _mm_srai_epi32(_mm_unpackhi_epi16(low, high), 14));
+}
+
+static void WindowAndFFTSSE2(WebRtc_Word16* fft,
+                             const WebRtc_Word16* timeSignal,
+                             WebRtc_Word16 timeSignalScaling,
+                             WebRtc_Word16* freqSignal) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i scaling = _mm_cvtsi32_si128(timeSignalScaling);
+  // -1 in the imaginary parts.
+  const __m128i conjugate = _mm_set1_epi32((int)0xffff0000);
+  int i;
+
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i window = _mm_loadu_si128(
+        (const __m128i*)&WebRtcAecm_kSqrtHanning[i]);
+    const __m128i first = MulWindow(_mm_sll_epi16(
+        _mm_loadu_si128((const __m128i*)&timeSignal[i]), scaling), window);
+    const __m128i second = MulWindow(_mm_sll_epi16(
+        _mm_loadu_si128((const __m128i*)&timeSignal[PART_LEN + i]), scaling),
+        LoadWindowReversed(i));
+    // Inserting zeros in imaginary parts.
+    _mm_storeu_si128((__m128i*)&fft[2 * i], _mm_unpacklo_epi16(first, zero));
+    _mm_storeu_si128((__m128i*)&fft[2 * i + 8],
+                     _mm_unpackhi_epi16(first, zero));
+    _mm_storeu_si128((__m128i*)&fft[PART_LEN2 + 2 * i],
+                     _mm_unpacklo_epi16(second, zero));
+    _mm_storeu_si128((__m128i*)&fft[PART_LEN2 + 2 * i + 8],
+                     _mm_unpackhi_epi16(second, zero));
+  }
+
+  WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
+  WebRtcSpl_ComplexFFT(fft, PART_LEN_SHIFT, 1);
+
+  // Negate the imaginary parts: (x ^ -1) - (-1) = -x.
+  for (i = 0; i < PART_LEN2; i += 8) {
+    const __m128i a = _mm_loadu_si128((const __m128i*)&fft[i]);
+    _mm_storeu_si128((__m128i*)&freqSignal[i],
+                     _mm_sub_epi16(_mm_xor_si128(a, conjugate), conjugate));
+  }
+}
+
+static void InverseFFTAndWindowSSE2(AecmCore_t* aecm,
+                                    WebRtc_Word16* fft,
+                                    const WebRtc_Word16* efwReal,
+                                    const WebRtc_Word16* efwImag,
+                                    WebRtc_Word16* output) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi32(1 << 13);
+  __m128i left_shift;
+  __m128i right_shift;
+  int i, outCFFT, shift;
+
+  // Conjugate symmetric spectrum.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i real = _mm_loadu_si128((const __m128i*)&efwReal[i]);
+    const __m128i imag = _mm_sub_epi16(
+        zero, _mm_loadu_si128((const __m128i*)&efwImag[i]));
+    _mm_storeu_si128((__m128i*)&fft[2 * i], _mm_unpacklo_epi16(real, imag));
+    _mm_storeu_si128((__m128i*)&fft[2 * i + 8],
+                     _mm_unpackhi_epi16(real, imag));
+  }
+  fft[PART_LEN2] = efwReal[PART_LEN];
+  fft[PART_LEN2 + 1] = -efwImag[PART_LEN];
+  // Mirrored data: bin i goes to fft[PART_LEN4 - 2 * i], i = 1..PART_LEN - 1.
+  for (i = 1; i + 3 < PART_LEN; i += 4) {
+    const __m128i pairs = _mm_unpacklo_epi16(
+        _mm_loadl_epi64((const __m128i*)&efwReal[i]),
+        _mm_loadl_epi64((const __m128i*)&efwImag[i]));
+    _mm_storeu_si128((__m128i*)&fft[PART_LEN4 - 2 * (i + 3)],
+                     _mm_shuffle_epi32(pairs, _MM_SHUFFLE(0, 1, 2, 3)));
+  }
+  for (; i < PART_LEN; i++) {
+    fft[PART_LEN4 - 2 * i] = efwReal[i];
+    fft[PART_LEN4 - 2 * i + 1] = efwImag[i];
+  }
+
+  WebRtcSpl_ComplexBitReverse(fft, PART_LEN_SHIFT);
+  outCFFT = WebRtcSpl_ComplexIFFT(fft, PART_LEN_SHIFT, 1);
+
+  // WEBRTC_SPL_SHIFT_W32() by |shift|, as a left and a right shift where one
+  // of them is zero.
+  shift = outCFFT - aecm->dfaCleanQDomain;
+  left_shift = _mm_cvtsi32_si128(shift > 0 ? shift : 0);
+  right_shift = _mm_cvtsi32_si128(shift < 0 ? -shift : 0);
+
+  // Take the real values, window and overlap-add. Multiplying the (real,
+  // imag) pairs with (window, 0) gives real * window in 32 bits.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i window = _mm_loadu_si128(
+        (const __m128i*)&WebRtcAecm_kSqrtHanning[i]);
+    const __m128i window_reversed = LoadWindowReversed(i);
+    const __m128i out_buf = _mm_loadu_si128((const __m128i*)&aecm->outBuf[i]);
+    __m128i out_lo = _mm_madd_epi16(
+        _mm_loadu_si128((const __m128i*)&fft[2 * i]),
+        _mm_unpacklo_epi16(window, zero));
+    __m128i out_hi = _mm_madd_epi16(
+        _mm_loadu_si128((const __m128i*)&fft[2 * i + 8]),
+        _mm_unpackhi_epi16(window, zero));
+    __m128i buf_lo = _mm_madd_epi16(
+        _mm_loadu_si128((const __m128i*)&fft[PART_LEN2 + 2 * i]),
+        _mm_unpacklo_epi16(window_reversed, zero));
+    __m128i buf_hi = _mm_madd_epi16(
+        _mm_loadu_si128((const __m128i*)&fft[PART_LEN2 + 2 * i + 8]),
+        _mm_unpackhi_epi16(window_reversed, zero));
+
+    out_lo = _mm_srai_epi32(_mm_add_epi32(out_lo, round), 14);
+    out_hi = _mm_srai_epi32(_mm_add_epi32(out_hi, round), 14);
+    out_lo = _mm_sra_epi32(_mm_sll_epi32(out_lo, left_shift), right_shift);
+    out_hi = _mm_sra_epi32(_mm_sll_epi32(out_hi, left_shift), right_shift);
+    // Sign extend |out_buf| and add.
+    out_lo = _mm_add_epi32(out_lo,
+        _mm_srai_epi32(_mm_unpacklo_epi16(out_buf, out_buf), 16));
+    out_hi = _mm_add_epi32(out_hi,
+        _mm_srai_epi32(_mm_unpackhi_epi16(out_buf, out_buf), 16));
+    _mm_storeu_si128((__m128i*)&output[i], _mm_packs_epi32(out_lo, out_hi));
+
+    buf_lo = _mm_srai_epi32(buf_lo, 14);
+    buf_hi = _mm_srai_epi32(buf_hi, 14);
+    buf_lo = _mm_sra_epi32(_mm_sll_epi32(buf_lo, left_shift), right_shift);
+    buf_hi = _mm_sra_epi32(_mm_sll_epi32(buf_hi, left_shift), right_shift);
+    _mm_storeu_si128((__m128i*)&aecm->outBuf[i],
+                     _mm_packs_epi32(buf_lo, buf_hi));
+  }
+}
+
+static void CalcLinearEnergiesSSE2(AecmCore_t* aecm,
+                                   const WebRtc_UWord16* farSpectrum,
+                                   WebRtc_Word32* echoEst,
+                                   WebRtc_UWord32* farEnergy,
+                                   WebRtc_UWord32* echoEnergyAdapt,
+                                   WebRtc_UWord32* echoEnergyStored) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i far_energy = zero;
+  __m128i echo_energy_adapt = zero;
+  __m128i echo_energy_stored = zero;
+  int i;
+
+  // The sums wrap around like the unsigned sums of the C version.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i far = _mm_loadu_si128((const __m128i*)&farSpectrum[i]);
+    const __m128i stored = _mm_loadu_si128(
+        (const __m128i*)&aecm->channelStored[i]);
+    const __m128i adapt = _mm_loadu_si128(
+        (const __m128i*)&aecm->channelAdapt16[i]);
+    const __m128i adapt_low = _mm_mullo_epi16(adapt, far);
+    const __m128i adapt_high = _mm_mulhi_epu16(adapt, far);
+    __m128i echo_lo, echo_hi;
+
+    MulS16U16(stored, far, &echo_lo, &echo_hi);
+    _mm_storeu_si128((__m128i*)&echoEst[i], echo_lo);
+    _mm_storeu_si128((__m128i*)&echoEst[i + 4], echo_hi);
+
+    far_energy = _mm_add_epi32(far_energy, _mm_add_epi32(
+        _mm_unpacklo_epi16(far, zero), _mm_unpackhi_epi16(far, zero)));
+    echo_energy_adapt = _mm_add_epi32(echo_energy_adapt, _mm_add_epi32(
+        _mm_unpacklo_epi16(adapt_low, adapt_high),
+        _mm_unpackhi_epi16(adapt_low, adapt_high)));
+    echo_energy_stored = _mm_add_epi32(echo_energy_stored,
+                                       _mm_add_epi32(echo_lo, echo_hi));
+  }
+
+  echoEst[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                            farSpectrum[PART_LEN]);
+  // The sums wrap around as in C.
+  (*farEnergy) += (WebRtc_UWord32)WebRtcSpl_HorizontalSumSSE2(
+      far_energy) +
+      (WebRtc_UWord32)farSpectrum[PART_LEN];
+  (*echoEnergyAdapt) += (WebRtc_UWord32)WebRtcSpl_HorizontalSumSSE2(
+      echo_energy_adapt) +
+      WEBRTC_SPL_UMUL_16_16(aecm->channelAdapt16[PART_LEN],
+                            farSpectrum[PART_LEN]);
+  (*echoEnergyStored) += (WebRtc_UWord32)WebRtcSpl_HorizontalSumSSE2(
+      echo_energy_stored) +
+      (WebRtc_UWord32)echoEst[PART_LEN];
+}
+
+static void StoreAdaptiveChannelSSE2(AecmCore_t* aecm,
+                                     const WebRtc_UWord16* farSpectrum,
+                                     WebRtc_Word32* echoEst) {
+  int i;
+
+  memcpy(aecm->channelStored, aecm->channelAdapt16,
+         sizeof(WebRtc_Word16) * PART_LEN1);
+  for (i = 0; i < PART_LEN; i += 8) {
+    __m128i echo_lo, echo_hi;
+    MulS16U16(_mm_loadu_si128((const __m128i*)&aecm->channelStored[i]),
+              _mm_loadu_si128((const __m128i*)&farSpectrum[i]),
+              &echo_lo, &echo_hi);
+    _mm_storeu_si128((__m128i*)&echoEst[i], echo_lo);
+    _mm_storeu_si128((__m128i*)&echoEst[i + 4], echo_hi);
+  }
+  echoEst[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                            farSpectrum[PART_LEN]);
+}
+
+static void ResetAdaptiveChannelSSE2(AecmCore_t* aecm) {
+  const __m128i zero = _mm_setzero_si128();
+  int i;
+
+  memcpy(aecm->channelAdapt16, aecm->channelStored,
+         sizeof(WebRtc_Word16) * PART_LEN1);
+  // Interleaving with zeros below shifts left by 16.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i stored = _mm_loadu_si128(
+        (const __m128i*)&aecm->channelStored[i]);
+    _mm_storeu_si128((__m128i*)&aecm->channelAdapt32[i],
+                     _mm_unpacklo_epi16(zero, stored));
+    _mm_storeu_si128((__m128i*)&aecm->channelAdapt32[i + 4],
+                     _mm_unpackhi_epi16(zero, stored));
+  }
+  aecm->channelAdapt32[PART_LEN] = WEBRTC_SPL_LSHIFT_W32(
+      (WebRtc_Word32)aecm->channelStored[PART_LEN], 16);
+}
+
+void WebRtcAecm_InitCore_SSE2(void) {
+  WebRtcAecm_WindowAndFFT = WindowAndFFTSSE2;
+  WebRtcAecm_InverseFFTAndWindow = InverseFFTAndWindowSSE2;
+  WebRtcAecm_CalcLinearEnergies = CalcLinearEnergiesSSE2;
+  WebRtcAecm_StoreAdaptiveChannel = StoreAdaptiveChannelSSE2;
+  WebRtcAecm_ResetAdaptiveChannel = ResetAdaptiveChannelSSE2;
+}
+
+#endif   // __SSE2__
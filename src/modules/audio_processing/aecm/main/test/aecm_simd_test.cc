@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Runs the AECM over a far and near end file with and without the SSE2/NEON
+// code and checks that the outputs are bit exact. Also prints the time spent
+// in WebRtcAecm_Process() for both.
+//
+// Usage: aecm_simd_test [far end pcm file] [near end pcm file]
+
+#include <cstdio>
+#include <vector>
+
+#include "cpu_features_wrapper.h"
+#include "echo_control_mobile.h"
+#include "tick_util.h"
+
+namespace {
+const char kDefaultFarFile[] = "test/data/audio_processing/aec_far.pcm";
+const char kDefaultNearFile[] = "test/data/audio_processing/aec_near.pcm";
+
+bool ReadFile(const char* filename, std::vector<WebRtc_Word16>* data) {
+  FILE* file = fopen(filename, "rb");
+  if (file == NULL) {
+    printf("Unable to open %s\n", filename);
+    return false;
+  }
+  WebRtc_Word16 buffer[1024];
+  size_t read = 0;
+  while ((read = fread(buffer, sizeof(WebRtc_Word16), 1024, file)) > 0) {
+    data->insert(data->end(), buffer, buffer + read);
+  }
+  fclose(file);
+  return true;
+}
+
+// Processes the files, read as |sample_rate_hz| audio, and stores the result
+// in |output|. Feeds the near end also as the clean near end signal if
+// |use_clean| is set. Returns the processing time in microseconds, or -1 on
+// error.
+WebRtc_Word64 Run(const std::vector<WebRtc_Word16>& far_end,
+                  const std::vector<WebRtc_Word16>& near_end,
+                  int sample_rate_hz, bool use_clean,
+                  std::vector<WebRtc_Word16>* output) {
+  const int frame_size = sample_rate_hz / 100;
+  const size_t length = far_end.size() < near_end.size() ?
+      far_end.size() : near_end.size();
+  const int num_frames = static_cast<int>(length) / frame_size;
+
+  void* aecm = NULL;
+  if (WebRtcAecm_Create(&aecm) != 0) {
+    return -1;
+  }
+  if (WebRtcAecm_Init(aecm, sample_rate_hz) != 0) {
+    WebRtcAecm_Free(aecm);
+    return -1;
+  }
+
+  output->assign(num_frames * frame_size, 0);
+  WebRtc_Word64 elapsed_us = 0;
+  for (int i = 0; i < num_frames; i++) {
+    const WebRtc_Word16* near_frame = &near_end[i * frame_size];
+
+    const webrtc::TickTime start = webrtc::TickTime::Now();
+    if (WebRtcAecm_BufferFarend(aecm, &far_end[i * frame_size],
+                                frame_size) != 0 ||
+        WebRtcAecm_Process(aecm, near_frame, use_clean ? near_frame : NULL,
+                           &(*output)[i * frame_size], frame_size, 20) != 0) {
+      WebRtcAecm_Free(aecm);
+      return -1;
+    }
+    elapsed_us += (webrtc::TickTime::Now() - start).Microseconds();
+  }
+
+  WebRtcAecm_Free(aecm);
+  return elapsed_us;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<WebRtc_Word16> far_end;
+  std::vector<WebRtc_Word16> near_end;
+  if (!ReadFile(argc > 1 ? argv[1] : kDefaultFarFile, &far_end) ||
+      !ReadFile(argc > 2 ? argv[2] : kDefaultNearFile, &near_end)) {
+    return 1;
+  }
+
+  const int kSampleRates[] = {8000, 16000};
+  const WebRtc_CPUInfo get_cpu_info = WebRtc_GetCPUInfo;
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(kSampleRates) / sizeof(*kSampleRates); i++) {
+    for (int use_clean = 0; use_clean < 2; use_clean++) {
+      std::vector<WebRtc_Word16> reference;
+      std::vector<WebRtc_Word16> optimized;
+
+      // WebRtcAecm_Init() selects the functions to use.
+      WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+      const WebRtc_Word64 c_us = Run(far_end, near_end, kSampleRates[i],
+                                     use_clean != 0, &reference);
+      WebRtc_GetCPUInfo = get_cpu_info;
+      const WebRtc_Word64 simd_us = Run(far_end, near_end, kSampleRates[i],
+                                        use_clean != 0, &optimized);
+      if (c_us < 0 || simd_us < 0) {
+        printf("Processing failed\n");
+        return 1;
+      }
+
+      const bool bit_exact = reference == optimized;
+      if (!bit_exact) {
+        failures++;
+      }
+      printf("%5d Hz%s: C %6.1f ms, SIMD %6.1f ms (%.2fx), %s\n",
+             kSampleRates[i], use_clean ? " clean" : "      ",
+             c_us / 1000.0, simd_us / 1000.0,
+             simd_us > 0 ? (double)c_us / simd_us : 0.0,
+             bit_exact ? "bit exact" : "NOT bit exact");
+    }
+  }
+
+  if (failures > 0) {
+    printf("FAILED: %d runs were not bit exact\n", failures);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -32,6 +32,24 @@
         'test/unit_test/audio_processing_unittest.pb.h',
       ],
     },
+    {
+      'target_name': 'debug_writer_unittest',
+      'type': 'executable',
+      'dependencies': [
+        'source/apm.gyp:audio_processing',
+        '../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+
+        '../../../../testing/gtest.gyp:gtest',
+        '../../../../testing/gtest.gyp:gtest_main',
+      ],
+      'include_dirs': [
+        'source',
+        '../../../../testing/gtest/include',
+      ],
+      'sources': [
+        'source/debug_writer_unittest.cc',
+      ],
+    },
     {
       'target_name': 'process_test',
       'type': 'executable',
@@ -49,6 +67,17 @@
         'test/process_test/process_test.cc',
       ],
     },
+    {
+      'target_name': 'batch_benchmark',
+      'type': 'executable',
+      'dependencies': [
+        'source/apm.gyp:audio_processing',
+        '../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'sources': [
+        'test/batch_benchmark/batch_benchmark.cc',
+      ],
+    },
 
   ],
 }
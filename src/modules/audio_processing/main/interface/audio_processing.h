@@ -130,13 +130,15 @@ class AudioProcessing : public Module {
 
   // Sets the number of channels for the primary audio stream. Input frames must
   // contain a number of channels given by |input_channels|, while output frames
-  // will be returned with number of channels given by |output_channels|.
+  // will be returned with number of channels given by |output_channels|. Up to
+  // |kMaxNumChannels| channels are supported. |output_channels| must either be
+  // equal to |input_channels| or 1, in which case the input is mixed to mono.
   virtual int set_num_channels(int input_channels, int output_channels) = 0;
   virtual int num_input_channels() const = 0;
   virtual int num_output_channels() const = 0;
 
   // Sets the number of channels for the reverse audio stream. Input frames must
-  // contain a number of channels given by |channels|.
+  // contain a number of channels given by |channels|, up to |kMaxNumChannels|.
   virtual int set_num_reverse_channels(int channels) = 0;
   virtual int num_reverse_channels() const = 0;
 
@@ -152,6 +154,22 @@ class AudioProcessing : public Module {
   // to APM.
   virtual int ProcessStream(AudioFrame* frame) = 0;
 
+  // Processes one 10 ms frame for each of |num_streams| independent streams,
+  // |frames[i]| with |apms[i]|. The results are identical to calling
+  // |apms[i]->ProcessStream(frames[i])| for every stream, but each instance is
+  // locked only once and the streams are passed through each component in
+  // turn, which keeps the code and tables of the component in cache. This is
+  // intended for servers processing many streams on one thread.
+  //
+  // The instances must be distinct, and an instance must not take part in two
+  // concurrent calls. A failing stream does not stop the others. If |errors|
+  // is non-NULL, the result of every stream is stored in |errors[i]|. Returns
+  // the first error in stream order, or kNoError.
+  static int ProcessStreams(AudioProcessing* const* apms,
+                            AudioFrame* const* frames,
+                            int num_streams,
+                            int* errors);
+
   // Analyzes a 10 ms |frame| of the reverse direction audio stream. The frame
   // will not be modified. On the client-side, this is the far-end (or to be
   // rendered) audio.
@@ -165,6 +183,12 @@ class AudioProcessing : public Module {
   // The |_frequencyInHz|, |_audioChannel|, and |_payloadDataLengthInSamples|
   // members of |frame| must be valid.
   //
+  // The frame is copied to a queue and analyzed by the next ProcessStream()
+  // call, so a render thread does not wait for a capture thread inside
+  // ProcessStream(). It is only analyzed here if several frames arrive without
+  // a ProcessStream() call. An error from analyzing a queued frame is returned
+  // by the next call to this function.
+  //
   // TODO(ajm): add const to input; requires an implementation fix.
   virtual int AnalyzeReverseStream(AudioFrame* frame) = 0;
 
@@ -191,10 +215,21 @@ class AudioProcessing : public Module {
   static const int kMaxFilenameSize = 1024;
   virtual int StartDebugRecording(const char filename[kMaxFilenameSize]) = 0;
 
+  // Same as above, but frames which would make the file larger than
+  // |max_bytes| are not recorded, nor any frame after them. A |max_bytes| of
+  // 0 means no limit.
+  virtual int StartDebugRecording(const char filename[kMaxFilenameSize],
+                                  int max_bytes) = 0;
+
   // Stops recording debugging information, and closes the file. Recording
   // cannot be resumed in the same file (without overwriting it).
   virtual int StopDebugRecording() = 0;
 
+  // Returns the number of frames the current, or else the last, debug
+  // recording has dropped because they were queued faster than the file
+  // could be written.
+  virtual int debug_recording_dropped_frames() const = 0;
+
   // These provide access to the component interfaces and should never return
   // NULL. The pointers will be valid for the lifetime of the APM instance.
   // The memory for these objects is entirely managed internally.
@@ -237,6 +272,10 @@ class AudioProcessing : public Module {
     kBadStreamParameterWarning = -13,
   };
 
+  enum {
+    kMaxNumChannels = 8
+  };
+
   // Inherited from Module.
   virtual WebRtc_Word32 TimeUntilNextProcess() { return -1; };
   virtual WebRtc_Word32 Process() { return -1; };
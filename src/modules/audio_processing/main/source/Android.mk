@@ -17,6 +17,7 @@ LOCAL_CPP_EXTENSION := .cc
 LOCAL_GENERATED_SOURCES :=
 LOCAL_SRC_FILES := audio_buffer.cc \
     audio_processing_impl.cc \
+    debug_writer.cc \
     echo_cancellation_impl.cc \
     echo_control_mobile_impl.cc \
     gain_control_impl.cc \
@@ -25,6 +26,7 @@ LOCAL_SRC_FILES := audio_buffer.cc \
     noise_suppression_impl.cc \
     splitting_filter.cc \
     processing_component.cc \
+    render_queue.cc \
     voice_detection_impl.cc
 
 # Flags passed to both C and C++ files.
@@ -47,6 +47,8 @@
         'audio_buffer.h',
         'audio_processing_impl.cc',
         'audio_processing_impl.h',
+        'debug_writer.cc',
+        'debug_writer.h',
         'echo_cancellation_impl.cc',
         'echo_cancellation_impl.h',
         'echo_control_mobile_impl.cc',
@@ -63,6 +65,8 @@
         'splitting_filter.h',
         'processing_component.cc',
         'processing_component.h',
+        'render_queue.cc',
+        'render_queue.h',
         'voice_detection_impl.cc',
         'voice_detection_impl.h',
       ],
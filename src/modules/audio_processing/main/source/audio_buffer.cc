@@ -10,7 +10,11 @@
 
 #include "audio_buffer.h"
 
+#include <cassert>
+#include <cstring>
+
 #include "module_common_types.h"
+#include "splitting_filter.h"
 
 namespace webrtc {
 namespace {
@@ -21,18 +25,32 @@ enum {
   kSamplesPer32kHzChannel = 320
 };
 
-void StereoToMono(const WebRtc_Word16* left, const WebRtc_Word16* right,
-                  WebRtc_Word16* out, int samples_per_channel) {
-  WebRtc_Word32 data_int32 = 0;
+// Saturates and truncates, like the float components did when they produced
+// 16-bit output themselves.
+WebRtc_Word16 FloatToS16(float value) {
+  if (value > 32767.0f) {
+    return 32767;
+  } else if (value < -32768.0f) {
+    return -32768;
+  }
+  return static_cast<WebRtc_Word16>(value);
+}
+
+void AddToSum(const WebRtc_Word16* in, WebRtc_Word32* sum,
+              int samples_per_channel) {
   for (int i = 0; i < samples_per_channel; i++) {
-    data_int32 = (left[i] + right[i]) >> 1;
-    if (data_int32 > 32767) {
-      data_int32 = 32767;
-    } else if (data_int32 < -32768) {
-      data_int32 = -32768;
-    }
+    sum[i] += in[i];
+  }
+}
 
-    out[i] = static_cast<WebRtc_Word16>(data_int32);
+// Divides the sum of |num_channels| channels by |num_channels|, rounding
+// towards minus infinity. For two channels this is the same as a right shift.
+void SumToMono(const WebRtc_Word32* sum, int num_channels,
+               WebRtc_Word16* out, int samples_per_channel) {
+  for (int i = 0; i < samples_per_channel; i++) {
+    const WebRtc_Word32 floored =
+        sum[i] >= 0 ? sum[i] : sum[i] - num_channels + 1;
+    out[i] = static_cast<WebRtc_Word16>(floored / num_channels);
   }
 }
 }  // namespace
@@ -45,130 +63,287 @@ struct AudioChannel {
   WebRtc_Word16 data[kSamplesPer32kHzChannel];
 };
 
-struct SplitAudioChannel {
-  SplitAudioChannel() {
-    memset(low_pass_data, 0, sizeof(low_pass_data));
-    memset(high_pass_data, 0, sizeof(high_pass_data));
+struct SplitFilterStates {
+  SplitFilterStates() {
+    ResetAnalysis();
+    ResetSynthesis();
+  }
+
+  void ResetAnalysis() {
     memset(analysis_filter_state1, 0, sizeof(analysis_filter_state1));
     memset(analysis_filter_state2, 0, sizeof(analysis_filter_state2));
+  }
+
+  void ResetSynthesis() {
     memset(synthesis_filter_state1, 0, sizeof(synthesis_filter_state1));
     memset(synthesis_filter_state2, 0, sizeof(synthesis_filter_state2));
   }
 
-  WebRtc_Word16 low_pass_data[kSamplesPer16kHzChannel];
-  WebRtc_Word16 high_pass_data[kSamplesPer16kHzChannel];
-
   WebRtc_Word32 analysis_filter_state1[6];
   WebRtc_Word32 analysis_filter_state2[6];
   WebRtc_Word32 synthesis_filter_state1[6];
   WebRtc_Word32 synthesis_filter_state2[6];
 };
 
+// Deinterleaved data kept both as 16-bit integers and as floats. A
+// representation is converted from the other one when it is asked for after
+// the other one has been written.
+class IFChannelBuffer {
+ public:
+  IFChannelBuffer(int max_num_channels, int samples_per_channel)
+      : max_num_channels_(max_num_channels),
+        num_channels_(max_num_channels),
+        samples_per_channel_(samples_per_channel),
+        ivalid_(true),
+        fvalid_(true),
+        idata_(new WebRtc_Word16[max_num_channels * samples_per_channel]),
+        fdata_(new float[max_num_channels * samples_per_channel]),
+        ichannels_(new WebRtc_Word16*[max_num_channels]),
+        fchannels_(new float*[max_num_channels]) {
+    memset(idata_, 0,
+           sizeof(WebRtc_Word16) * max_num_channels * samples_per_channel);
+    memset(fdata_, 0, sizeof(float) * max_num_channels * samples_per_channel);
+    for (int i = 0; i < max_num_channels; i++) {
+      ichannels_[i] = &idata_[i * samples_per_channel];
+      fchannels_[i] = &fdata_[i * samples_per_channel];
+    }
+  }
+
+  ~IFChannelBuffer() {
+    delete [] idata_;
+    delete [] fdata_;
+    delete [] ichannels_;
+    delete [] fchannels_;
+  }
+
+  void set_num_channels(int num_channels) {
+    assert(num_channels <= max_num_channels_);
+    num_channels_ = num_channels;
+  }
+
+  // Lets the first channel refer to |data|, which then holds the current
+  // samples. With |data| set to NULL, the own memory is used again and is
+  // expected to be written through ibuf().
+  void set_external_idata(WebRtc_Word16* data) {
+    ichannels_[0] = data != NULL ? data : idata_;
+    ivalid_ = true;
+    fvalid_ = false;
+  }
+
+  // Marks both representations as stale. The data has to be written through
+  // ibuf() or fbuf() before it is read again.
+  void Invalidate() {
+    ivalid_ = false;
+    fvalid_ = false;
+  }
+
+  bool is_valid() const {
+    return ivalid_ || fvalid_;
+  }
+
+  WebRtc_Word16* ibuf(int channel) {
+    RefreshI();
+    fvalid_ = false;
+    return ichannels_[channel];
+  }
+
+  const WebRtc_Word16* ibuf_const(int channel) {
+    assert(is_valid());
+    RefreshI();
+    return ichannels_[channel];
+  }
+
+  float* fbuf(int channel) {
+    RefreshF();
+    ivalid_ = false;
+    return fchannels_[channel];
+  }
+
+  const float* fbuf_const(int channel) {
+    assert(is_valid());
+    RefreshF();
+    return fchannels_[channel];
+  }
+
+ private:
+  void RefreshI() {
+    if (!ivalid_ && fvalid_) {
+      for (int i = 0; i < num_channels_; i++) {
+        for (int j = 0; j < samples_per_channel_; j++) {
+          ichannels_[i][j] = FloatToS16(fchannels_[i][j]);
+        }
+      }
+    }
+    ivalid_ = true;
+  }
+
+  void RefreshF() {
+    if (!fvalid_ && ivalid_) {
+      for (int i = 0; i < num_channels_; i++) {
+        for (int j = 0; j < samples_per_channel_; j++) {
+          fchannels_[i][j] = ichannels_[i][j];
+        }
+      }
+    }
+    fvalid_ = true;
+  }
+
+  const int max_num_channels_;
+  int num_channels_;
+  const int samples_per_channel_;
+  bool ivalid_;
+  bool fvalid_;
+  WebRtc_Word16* idata_;
+  float* fdata_;
+  WebRtc_Word16** ichannels_;
+  float** fchannels_;
+};
+
 // TODO(am): check range of input parameters?
 AudioBuffer::AudioBuffer(WebRtc_Word32 max_num_channels,
                          WebRtc_Word32 samples_per_channel)
     : max_num_channels_(max_num_channels),
       num_channels_(0),
-      num_mixed_channels_(0),
       num_mixed_low_pass_channels_(0),
       samples_per_channel_(samples_per_channel),
       samples_per_split_channel_(samples_per_channel),
       reference_copied_(false),
-      data_(NULL),
-      channels_(NULL),
-      split_channels_(NULL),
+      frame_(0),
+      last_split_frame_(0),
+      last_merge_frame_(0),
+      data_(new IFChannelBuffer(max_num_channels, samples_per_channel)),
+      low_pass_data_(NULL),
+      high_pass_data_(NULL),
+      filter_states_(NULL),
       mixed_low_pass_channels_(NULL),
       low_pass_reference_channels_(NULL) {
   if (max_num_channels_ > 1) {
-    channels_ = new AudioChannel[max_num_channels_];
     mixed_low_pass_channels_ = new AudioChannel[max_num_channels_];
   }
   low_pass_reference_channels_ = new AudioChannel[max_num_channels_];
 
   if (samples_per_channel_ == kSamplesPer32kHzChannel) {
-    split_channels_ = new SplitAudioChannel[max_num_channels_];
     samples_per_split_channel_ = kSamplesPer16kHzChannel;
+    low_pass_data_ = new IFChannelBuffer(max_num_channels_,
+                                         samples_per_split_channel_);
+    high_pass_data_ = new IFChannelBuffer(max_num_channels_,
+                                          samples_per_split_channel_);
+    filter_states_ = new SplitFilterStates[max_num_channels_];
   }
 }
 
 AudioBuffer::~AudioBuffer() {
-  if (channels_ != NULL) {
-    delete [] channels_;
-  }
-
-  if (mixed_low_pass_channels_ != NULL) {
-    delete [] mixed_low_pass_channels_;
-  }
+  delete data_;
+  delete low_pass_data_;
+  delete high_pass_data_;
+  delete [] filter_states_;
+  delete [] mixed_low_pass_channels_;
+  delete [] low_pass_reference_channels_;
+}
 
-  if (low_pass_reference_channels_ != NULL) {
-    delete [] low_pass_reference_channels_;
-  }
+bool AudioBuffer::is_split() const {
+  return low_pass_data_ != NULL;
+}
 
-  if (split_channels_ != NULL) {
-    delete [] split_channels_;
-  }
+WebRtc_Word16* AudioBuffer::data(WebRtc_Word32 channel) {
+  assert(channel >= 0 && channel < num_channels_);
+  assert(!is_split() || !low_pass_data_->is_valid());
+  return data_->ibuf(channel);
 }
 
-WebRtc_Word16* AudioBuffer::data(WebRtc_Word32 channel) const {
+const WebRtc_Word16* AudioBuffer::data_const(WebRtc_Word32 channel) {
   assert(channel >= 0 && channel < num_channels_);
-  if (data_ != NULL) {
-    return data_;
+  if (!data_->is_valid()) {
+    MergeBands();
   }
-
-  return channels_[channel].data;
+  return data_->ibuf_const(channel);
 }
 
-WebRtc_Word16* AudioBuffer::low_pass_split_data(WebRtc_Word32 channel) const {
+float* AudioBuffer::data_f(WebRtc_Word32 channel) {
   assert(channel >= 0 && channel < num_channels_);
-  if (split_channels_ == NULL) {
+  assert(!is_split() || !low_pass_data_->is_valid());
+  return data_->fbuf(channel);
+}
+
+WebRtc_Word16* AudioBuffer::low_pass_split_data(WebRtc_Word32 channel) {
+  if (!is_split()) {
     return data(channel);
   }
 
-  return split_channels_[channel].low_pass_data;
+  assert(channel >= 0 && channel < num_channels_);
+  SplitIntoBands();
+  data_->Invalidate();
+  return low_pass_data_->ibuf(channel);
 }
 
-WebRtc_Word16* AudioBuffer::high_pass_split_data(WebRtc_Word32 channel) const {
-  assert(channel >= 0 && channel < num_channels_);
-  if (split_channels_ == NULL) {
-    return NULL;
+const WebRtc_Word16* AudioBuffer::low_pass_split_data_const(
+    WebRtc_Word32 channel) {
+  if (!is_split()) {
+    return data_const(channel);
   }
 
-  return split_channels_[channel].high_pass_data;
+  assert(channel >= 0 && channel < num_channels_);
+  SplitIntoBands();
+  return low_pass_data_->ibuf_const(channel);
 }
 
-WebRtc_Word16* AudioBuffer::mixed_low_pass_data(WebRtc_Word32 channel) const {
-  assert(channel >= 0 && channel < num_mixed_low_pass_channels_);
+float* AudioBuffer::low_pass_split_data_f(WebRtc_Word32 channel) {
+  if (!is_split()) {
+    return data_f(channel);
+  }
 
-  return mixed_low_pass_channels_[channel].data;
+  assert(channel >= 0 && channel < num_channels_);
+  SplitIntoBands();
+  data_->Invalidate();
+  return low_pass_data_->fbuf(channel);
 }
 
-WebRtc_Word16* AudioBuffer::low_pass_reference(WebRtc_Word32 channel) const {
-  assert(channel >= 0 && channel < num_channels_);
-  if (!reference_copied_) {
+WebRtc_Word16* AudioBuffer::high_pass_split_data(WebRtc_Word32 channel) {
+  if (!is_split()) {
     return NULL;
   }
 
-  return low_pass_reference_channels_[channel].data;
+  assert(channel >= 0 && channel < num_channels_);
+  SplitIntoBands();
+  data_->Invalidate();
+  return high_pass_data_->ibuf(channel);
 }
 
-WebRtc_Word32* AudioBuffer::analysis_filter_state1(WebRtc_Word32 channel) const {
+const WebRtc_Word16* AudioBuffer::high_pass_split_data_const(
+    WebRtc_Word32 channel) {
+  if (!is_split()) {
+    return NULL;
+  }
+
   assert(channel >= 0 && channel < num_channels_);
-  return split_channels_[channel].analysis_filter_state1;
+  SplitIntoBands();
+  return high_pass_data_->ibuf_const(channel);
 }
 
-WebRtc_Word32* AudioBuffer::analysis_filter_state2(WebRtc_Word32 channel) const {
+float* AudioBuffer::high_pass_split_data_f(WebRtc_Word32 channel) {
+  if (!is_split()) {
+    return NULL;
+  }
+
   assert(channel >= 0 && channel < num_channels_);
-  return split_channels_[channel].analysis_filter_state2;
+  SplitIntoBands();
+  data_->Invalidate();
+  return high_pass_data_->fbuf(channel);
 }
 
-WebRtc_Word32* AudioBuffer::synthesis_filter_state1(WebRtc_Word32 channel) const {
-  assert(channel >= 0 && channel < num_channels_);
-  return split_channels_[channel].synthesis_filter_state1;
+WebRtc_Word16* AudioBuffer::mixed_low_pass_data(WebRtc_Word32 channel) const {
+  assert(channel >= 0 && channel < num_mixed_low_pass_channels_);
+
+  return mixed_low_pass_channels_[channel].data;
 }
 
-WebRtc_Word32* AudioBuffer::synthesis_filter_state2(WebRtc_Word32 channel) const {
+WebRtc_Word16* AudioBuffer::low_pass_reference(WebRtc_Word32 channel) const {
   assert(channel >= 0 && channel < num_channels_);
-  return split_channels_[channel].synthesis_filter_state2;
+  if (!reference_copied_) {
+    return NULL;
+  }
+
+  return low_pass_reference_channels_[channel].data;
 }
 
 WebRtc_Word32 AudioBuffer::num_channels() const {
@@ -183,24 +358,71 @@ WebRtc_Word32 AudioBuffer::samples_per_split_channel() const {
   return samples_per_split_channel_;
 }
 
+void AudioBuffer::SplitIntoBands() {
+  if (low_pass_data_->is_valid()) {
+    return;
+  }
+
+  // The filter state is stale if the previous frame wasn't split, e.g. after
+  // the components asking for the bands changed. Start over like a new
+  // buffer would.
+  const bool reset = (frame_ - last_split_frame_ != 1);
+  last_split_frame_ = frame_;
+  for (int i = 0; i < num_channels_; i++) {
+    if (reset) {
+      filter_states_[i].ResetAnalysis();
+    }
+    SplittingFilterAnalysis(data_->ibuf_const(i),
+                            low_pass_data_->ibuf(i),
+                            high_pass_data_->ibuf(i),
+                            filter_states_[i].analysis_filter_state1,
+                            filter_states_[i].analysis_filter_state2);
+  }
+}
+
+void AudioBuffer::MergeBands() {
+  assert(is_split() && low_pass_data_->is_valid());
+  const bool reset = (frame_ - last_merge_frame_ != 1);
+  last_merge_frame_ = frame_;
+  for (int i = 0; i < num_channels_; i++) {
+    if (reset) {
+      filter_states_[i].ResetSynthesis();
+    }
+    SplittingFilterSynthesis(low_pass_data_->ibuf_const(i),
+                             high_pass_data_->ibuf_const(i),
+                             data_->ibuf(i),
+                             filter_states_[i].synthesis_filter_state1,
+                             filter_states_[i].synthesis_filter_state2);
+  }
+}
+
 // TODO(ajm): Do deinterleaving and mixing in one step?
 void AudioBuffer::DeinterleaveFrom(AudioFrame* audioFrame) {
   assert(audioFrame->_audioChannel <= max_num_channels_);
   assert(audioFrame->_payloadDataLengthInSamples ==  samples_per_channel_);
 
   num_channels_ = audioFrame->_audioChannel;
-  num_mixed_channels_ = 0;
   num_mixed_low_pass_channels_ = 0;
   reference_copied_ = false;
+  frame_++;
+
+  data_->set_num_channels(num_channels_);
+  if (is_split()) {
+    low_pass_data_->set_num_channels(num_channels_);
+    high_pass_data_->set_num_channels(num_channels_);
+    low_pass_data_->Invalidate();
+    high_pass_data_->Invalidate();
+  }
 
   if (num_channels_ == 1) {
     // We can get away with a pointer assignment in this case.
-    data_ = audioFrame->_payloadData;
+    data_->set_external_idata(audioFrame->_payloadData);
     return;
   }
 
+  data_->set_external_idata(NULL);
   for (int i = 0; i < num_channels_; i++) {
-    WebRtc_Word16* deinterleaved = channels_[i].data;
+    WebRtc_Word16* deinterleaved = data_->ibuf(i);
     WebRtc_Word16* interleaved = audioFrame->_payloadData;
     WebRtc_Word32 interleaved_idx = i;
     for (int j = 0; j < samples_per_channel_; j++) {
@@ -210,25 +432,24 @@ void AudioBuffer::DeinterleaveFrom(AudioFrame* audioFrame) {
   }
 }
 
-void AudioBuffer::InterleaveTo(AudioFrame* audioFrame) const {
+void AudioBuffer::InterleaveTo(AudioFrame* audioFrame) {
   assert(audioFrame->_audioChannel == num_channels_);
   assert(audioFrame->_payloadDataLengthInSamples == samples_per_channel_);
 
   if (num_channels_ == 1) {
-    if (num_mixed_channels_ == 1) {
+    // Without mixing, this points to the frame and there is nothing to copy.
+    const WebRtc_Word16* deinterleaved = data_const(0);
+    if (deinterleaved != audioFrame->_payloadData) {
       memcpy(audioFrame->_payloadData,
-             channels_[0].data,
+             deinterleaved,
              sizeof(WebRtc_Word16) * samples_per_channel_);
-    } else {
-      // These should point to the same buffer in this case.
-      assert(data_ == audioFrame->_payloadData);
     }
 
     return;
   }
 
   for (int i = 0; i < num_channels_; i++) {
-    WebRtc_Word16* deinterleaved = channels_[i].data;
+    const WebRtc_Word16* deinterleaved = data_const(i);
     WebRtc_Word16* interleaved = audioFrame->_payloadData;
     WebRtc_Word32 interleaved_idx = i;
     for (int j = 0; j < samples_per_channel_; j++) {
@@ -241,28 +462,35 @@ void AudioBuffer::InterleaveTo(AudioFrame* audioFrame) const {
 // TODO(ajm): would be good to support the no-mix case with pointer assignment.
 // TODO(ajm): handle mixing to multiple channels?
 void AudioBuffer::Mix(WebRtc_Word32 num_mixed_channels) {
-  // We currently only support the stereo to mono case.
-  assert(num_channels_ == 2);
+  // We currently only support mixing to mono.
+  assert(num_channels_ > 1);
   assert(num_mixed_channels == 1);
 
-  StereoToMono(channels_[0].data,
-               channels_[1].data,
-               channels_[0].data,
-               samples_per_channel_);
+  WebRtc_Word32 sum[kSamplesPer32kHzChannel] = {0};
+  for (int i = 0; i < num_channels_; i++) {
+    AddToSum(data_const(i), sum, samples_per_channel_);
+  }
+  SumToMono(sum, num_channels_, data(0), samples_per_channel_);
 
   num_channels_ = num_mixed_channels;
-  num_mixed_channels_ = num_mixed_channels;
+  data_->set_num_channels(num_channels_);
+  if (is_split()) {
+    low_pass_data_->set_num_channels(num_channels_);
+    high_pass_data_->set_num_channels(num_channels_);
+  }
 }
 
 void AudioBuffer::CopyAndMixLowPass(WebRtc_Word32 num_mixed_channels) {
-  // We currently only support the stereo to mono case.
-  assert(num_channels_ == 2);
+  // We currently only support mixing to mono.
+  assert(num_channels_ > 1);
   assert(num_mixed_channels == 1);
 
-  StereoToMono(low_pass_split_data(0),
-               low_pass_split_data(1),
-               mixed_low_pass_channels_[0].data,
-               samples_per_split_channel_);
+  WebRtc_Word32 sum[kSamplesPer32kHzChannel] = {0};
+  for (int i = 0; i < num_channels_; i++) {
+    AddToSum(low_pass_split_data_const(i), sum, samples_per_split_channel_);
+  }
+  SumToMono(sum, num_channels_, mixed_low_pass_channels_[0].data,
+            samples_per_split_channel_);
 
   num_mixed_low_pass_channels_ = num_mixed_channels;
 }
@@ -271,7 +499,7 @@ void AudioBuffer::CopyLowPassToReference() {
   reference_copied_ = true;
   for (int i = 0; i < num_channels_; i++) {
     memcpy(low_pass_reference_channels_[i].data,
-           low_pass_split_data(i),
+           low_pass_split_data_const(i),
            sizeof(WebRtc_Word16) * samples_per_split_channel_);
   }
 }
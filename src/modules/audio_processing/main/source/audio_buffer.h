@@ -17,9 +17,22 @@
 namespace webrtc {
 
 struct AudioChannel;
-struct SplitAudioChannel;
+struct SplitFilterStates;
 class AudioFrame;
+class IFChannelBuffer;
 
+// Holds one frame of deinterleaved audio for any number of channels.
+//
+// The full band and, at 32 kHz, the low and high band data are available both
+// as 16-bit integers and as floats with the range of 16-bit integers. Only the
+// representation last written is kept up to date; the other one is converted
+// the first time it is asked for. Getting a non-const pointer counts as a
+// write, so components that only read should use the const accessors.
+//
+// The band split is done the first time a component asks for the split data
+// and the bands are only merged again in InterleaveTo() if they were written.
+// A filter which did not run on the previous frame starts from a reset state.
+// At 8 and 16 kHz the split data is the full band data.
 class AudioBuffer {
  public:
   AudioBuffer(WebRtc_Word32 max_num_channels, WebRtc_Word32 samples_per_channel);
@@ -29,36 +42,52 @@ class AudioBuffer {
   WebRtc_Word32 samples_per_channel() const;
   WebRtc_Word32 samples_per_split_channel() const;
 
-  WebRtc_Word16* data(WebRtc_Word32 channel) const;
-  WebRtc_Word16* low_pass_split_data(WebRtc_Word32 channel) const;
-  WebRtc_Word16* high_pass_split_data(WebRtc_Word32 channel) const;
+  // The full band data must not be written once the split data has been
+  // accessed in the same frame.
+  WebRtc_Word16* data(WebRtc_Word32 channel);
+  const WebRtc_Word16* data_const(WebRtc_Word32 channel);
+  float* data_f(WebRtc_Word32 channel);
+
+  WebRtc_Word16* low_pass_split_data(WebRtc_Word32 channel);
+  const WebRtc_Word16* low_pass_split_data_const(WebRtc_Word32 channel);
+  float* low_pass_split_data_f(WebRtc_Word32 channel);
+  // Returns NULL at 8 and 16 kHz.
+  WebRtc_Word16* high_pass_split_data(WebRtc_Word32 channel);
+  const WebRtc_Word16* high_pass_split_data_const(WebRtc_Word32 channel);
+  float* high_pass_split_data_f(WebRtc_Word32 channel);
+
   WebRtc_Word16* mixed_low_pass_data(WebRtc_Word32 channel) const;
   WebRtc_Word16* low_pass_reference(WebRtc_Word32 channel) const;
 
-  WebRtc_Word32* analysis_filter_state1(WebRtc_Word32 channel) const;
-  WebRtc_Word32* analysis_filter_state2(WebRtc_Word32 channel) const;
-  WebRtc_Word32* synthesis_filter_state1(WebRtc_Word32 channel) const;
-  WebRtc_Word32* synthesis_filter_state2(WebRtc_Word32 channel) const;
-
   void DeinterleaveFrom(AudioFrame* audioFrame);
-  void InterleaveTo(AudioFrame* audioFrame) const;
+  void InterleaveTo(AudioFrame* audioFrame);
+  // Mixes all channels down to |num_mixed_channels|, which has to be 1.
   void Mix(WebRtc_Word32 num_mixed_channels);
   void CopyAndMixLowPass(WebRtc_Word32 num_mixed_channels);
   void CopyLowPassToReference();
 
  private:
+  bool is_split() const;
+  void SplitIntoBands();
+  void MergeBands();
+
   const WebRtc_Word32 max_num_channels_;
   WebRtc_Word32 num_channels_;
-  WebRtc_Word32 num_mixed_channels_;
   WebRtc_Word32 num_mixed_low_pass_channels_;
   const WebRtc_Word32 samples_per_channel_;
   WebRtc_Word32 samples_per_split_channel_;
   bool reference_copied_;
+  // Counts the frames, wrapping around, to tell if the split filters ran on
+  // the previous frame. Their state is reset otherwise.
+  WebRtc_UWord32 frame_;
+  WebRtc_UWord32 last_split_frame_;
+  WebRtc_UWord32 last_merge_frame_;
 
-  WebRtc_Word16* data_;
-  // TODO(ajm): Prefer to make these vectors if permitted...
-  AudioChannel* channels_;
-  SplitAudioChannel* split_channels_;
+  IFChannelBuffer* data_;
+  // NULL unless the data is split into bands, i.e. at 32 kHz.
+  IFChannelBuffer* low_pass_data_;
+  IFChannelBuffer* high_pass_data_;
+  SplitFilterStates* filter_states_;
   // TODO(ajm): improve this, we don't need the full 32 kHz space here.
   AudioChannel* mixed_low_pass_channels_;
   AudioChannel* low_pass_reference_channels_;
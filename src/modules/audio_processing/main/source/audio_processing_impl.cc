@@ -18,6 +18,7 @@
 #include "file_wrapper.h"
 
 #include "audio_buffer.h"
+#include "debug_writer.h"
 #include "echo_cancellation_impl.h"
 #include "echo_control_mobile_impl.h"
 #include "high_pass_filter_impl.h"
@@ -25,19 +26,18 @@
 #include "level_estimator_impl.h"
 #include "noise_suppression_impl.h"
 #include "processing_component.h"
-#include "splitting_filter.h"
+#include "render_queue.h"
 #include "voice_detection_impl.h"
 
 namespace webrtc {
 namespace {
+// Reverse stream frames which can be queued before AnalyzeReverseStream()
+// has to process them itself.
+const int kRenderQueueSize = 8;
 
-enum Events {
-  kInitializeEvent,
-  kRenderEvent,
-  kCaptureEvent
-};
-
-const char kMagicNumber[] = "#!vqetrace1.2";
+// ProcessStreams() runs the streams in batches of this many, so that the
+// per-stream state lives on the stack.
+const int kStreamsPerBatch = 32;
 }  // namespace
 
 AudioProcessing* AudioProcessing::Create(int id) {
@@ -68,8 +68,13 @@ AudioProcessingImpl::AudioProcessingImpl(int id)
       level_estimator_(NULL),
       noise_suppression_(NULL),
       voice_detection_(NULL),
-      debug_file_(FileWrapper::Create()),
+      debug_writer_(NULL),
+      debug_dropped_frames_(0),
       crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      render_crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      render_queue_(new RenderQueue(kRenderQueueSize)),
+      render_error_(kNoError),
+      render_format_(0),
       render_audio_(NULL),
       capture_audio_(NULL),
       sample_rate_hz_(kSampleRate16kHz),
@@ -111,15 +116,17 @@ AudioProcessingImpl::~AudioProcessingImpl() {
     component_list_.pop_front();
   }
 
-  if (debug_file_->Open()) {
-    debug_file_->CloseFile();
-  }
-  delete debug_file_;
-  debug_file_ = NULL;
+  StopDebugRecording();
 
   delete crit_;
   crit_ = NULL;
 
+  delete render_crit_;
+  render_crit_ = NULL;
+
+  delete render_queue_;
+  render_queue_ = NULL;
+
   if (render_audio_ != NULL) {
     delete render_audio_;
     render_audio_ = NULL;
@@ -160,6 +167,12 @@ int AudioProcessingImpl::InitializeLocked() {
   capture_audio_ = new AudioBuffer(num_capture_input_channels_,
                                    samples_per_channel_);
 
+  // Queued reverse stream frames belong to the old settings.
+  render_queue_->Clear();
+  render_error_ = kNoError;
+  render_format_ = sample_rate_hz_ * (kMaxNumChannels + 1) +
+      num_render_input_channels_;
+
   was_stream_delay_set_ = false;
 
   // Initialize all components.
@@ -200,8 +213,7 @@ int AudioProcessingImpl::sample_rate_hz() const {
 
 int AudioProcessingImpl::set_num_reverse_channels(int channels) {
   CriticalSectionScoped crit_scoped(*crit_);
-  // Only stereo supported currently.
-  if (channels > 2 || channels < 1) {
+  if (channels > kMaxNumChannels || channels < 1) {
     return kBadParameterError;
   }
 
@@ -218,16 +230,12 @@ int AudioProcessingImpl::set_num_channels(
     int input_channels,
     int output_channels) {
   CriticalSectionScoped crit_scoped(*crit_);
-  if (output_channels > input_channels) {
-    return kBadParameterError;
-  }
-
-  // Only stereo supported currently.
-  if (input_channels > 2 || input_channels < 1) {
+  if (input_channels > kMaxNumChannels || input_channels < 1) {
     return kBadParameterError;
   }
 
-  if (output_channels > 2 || output_channels < 1) {
+  // Only mixing to mono is supported.
+  if (output_channels != input_channels && output_channels != 1) {
     return kBadParameterError;
   }
 
@@ -245,199 +253,232 @@ int AudioProcessingImpl::num_output_channels() const {
   return num_capture_output_channels_;
 }
 
-int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
-  CriticalSectionScoped crit_scoped(*crit_);
-  int err = kNoError;
-
-  if (frame == NULL) {
+int AudioProcessing::ProcessStreams(AudioProcessing* const* apms,
+                                    AudioFrame* const* frames,
+                                    int num_streams,
+                                    int* errors) {
+  if (apms == NULL || frames == NULL || num_streams < 0) {
     return kNullPointerError;
   }
-
-  if (frame->_frequencyInHz !=
-      static_cast<WebRtc_UWord32>(sample_rate_hz_)) {
-    return kBadSampleRateError;
-  }
-
-  if (frame->_audioChannel != num_capture_input_channels_) {
-    return kBadNumberChannelsError;
-  }
-
-  if (frame->_payloadDataLengthInSamples != samples_per_channel_) {
-    return kBadDataLengthError;
+  for (int i = 0; i < num_streams; i++) {
+    if (apms[i] == NULL) {
+      return kNullPointerError;
+    }
   }
 
-  if (debug_file_->Open()) {
-    WebRtc_UWord8 event = kCaptureEvent;
-    if (!debug_file_->Write(&event, sizeof(event))) {
-      return kFileError;
+  int first_error = kNoError;
+  for (int first = 0; first < num_streams; first += kStreamsPerBatch) {
+    int batch_size = num_streams - first;
+    if (batch_size > kStreamsPerBatch) {
+      batch_size = kStreamsPerBatch;
+    }
+    // Every instance is an AudioProcessingImpl, see Create(). The results
+    // are kept here whether or not the caller asked for them, so that a
+    // failing stream is skipped in the later stages without stopping the
+    // others.
+    AudioProcessingImpl* batch[kStreamsPerBatch];
+    int batch_errors[kStreamsPerBatch];
+    for (int i = 0; i < batch_size; i++) {
+      batch[i] = static_cast<AudioProcessingImpl*>(apms[first + i]);
+      batch_errors[i] = kNoError;
+      batch[i]->crit()->Enter();
     }
 
-    if (!debug_file_->Write(&frame->_frequencyInHz,
-                                   sizeof(frame->_frequencyInHz))) {
-      return kFileError;
+    for (int stage = 0; stage < AudioProcessingImpl::kNumCaptureStages;
+         stage++) {
+      for (int i = 0; i < batch_size; i++) {
+        if (batch_errors[i] == kNoError) {
+          batch_errors[i] = batch[i]->ProcessCaptureStageLocked(
+              stage, frames[first + i]);
+        }
+      }
     }
 
-    if (!debug_file_->Write(&frame->_audioChannel,
-                                   sizeof(frame->_audioChannel))) {
-      return kFileError;
+    for (int i = batch_size - 1; i >= 0; i--) {
+      batch[i]->crit()->Leave();
     }
 
-    if (!debug_file_->Write(&frame->_payloadDataLengthInSamples,
-        sizeof(frame->_payloadDataLengthInSamples))) {
-      return kFileError;
+    for (int i = 0; i < batch_size; i++) {
+      if (first_error == kNoError) {
+        first_error = batch_errors[i];
+      }
+      if (errors != NULL) {
+        errors[first + i] = batch_errors[i];
+      }
     }
+  }
+  return first_error;
+}
+
+int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
+  CriticalSectionScoped crit_scoped(*crit_);
 
-    if (!debug_file_->Write(frame->_payloadData,
-        sizeof(WebRtc_Word16) * frame->_payloadDataLengthInSamples *
-        frame->_audioChannel)) {
-      return kFileError;
+  for (int stage = 0; stage < kNumCaptureStages; stage++) {
+    const int err = ProcessCaptureStageLocked(stage, frame);
+    if (err != kNoError) {
+      return err;
     }
   }
 
-  capture_audio_->DeinterleaveFrom(frame);
+  return kNoError;
+}
 
-  // TODO(ajm): experiment with mixing and AEC placement.
-  if (num_capture_output_channels_ < num_capture_input_channels_) {
-    capture_audio_->Mix(num_capture_output_channels_);
+int AudioProcessingImpl::ProcessCaptureStageLocked(int stage,
+                                                   AudioFrame* frame) {
+  switch (stage) {
+    case kCaptureStageDeinterleave:
+      // The reverse stream frames received so far precede this frame.
+      ProcessRenderQueueLocked();
 
-    frame->_audioChannel = num_capture_output_channels_;
-  }
+      if (frame == NULL) {
+        return kNullPointerError;
+      }
 
-  if (sample_rate_hz_ == kSampleRate32kHz) {
-    for (int i = 0; i < num_capture_input_channels_; i++) {
-      // Split into a low and high band.
-      SplittingFilterAnalysis(capture_audio_->data(i),
-                              capture_audio_->low_pass_split_data(i),
-                              capture_audio_->high_pass_split_data(i),
-                              capture_audio_->analysis_filter_state1(i),
-                              capture_audio_->analysis_filter_state2(i));
-    }
-  }
+      if (frame->_frequencyInHz !=
+          static_cast<WebRtc_UWord32>(sample_rate_hz_)) {
+        return kBadSampleRateError;
+      }
 
-  err = high_pass_filter_->ProcessCaptureAudio(capture_audio_);
-  if (err != kNoError) {
-    return err;
-  }
+      if (frame->_audioChannel != num_capture_input_channels_) {
+        return kBadNumberChannelsError;
+      }
 
-  err = gain_control_->AnalyzeCaptureAudio(capture_audio_);
-  if (err != kNoError) {
-    return err;
-  }
+      if (frame->_payloadDataLengthInSamples != samples_per_channel_) {
+        return kBadDataLengthError;
+      }
 
-  err = echo_cancellation_->ProcessCaptureAudio(capture_audio_);
-  if (err != kNoError) {
-    return err;
-  }
+      if (debug_writer_ != NULL) {
+        debug_writer_->WriteFrame(DebugWriter::kCaptureEvent, *frame);
+      }
 
-  if (echo_control_mobile_->is_enabled() &&
-      noise_suppression_->is_enabled()) {
-    capture_audio_->CopyLowPassToReference();
-  }
+      capture_audio_->DeinterleaveFrom(frame);
 
-  err = noise_suppression_->ProcessCaptureAudio(capture_audio_);
-  if (err != kNoError) {
-    return err;
-  }
+      // TODO(ajm): experiment with mixing and AEC placement.
+      if (num_capture_output_channels_ < num_capture_input_channels_) {
+        capture_audio_->Mix(num_capture_output_channels_);
 
-  err = echo_control_mobile_->ProcessCaptureAudio(capture_audio_);
-  if (err != kNoError) {
-    return err;
-  }
+        frame->_audioChannel = num_capture_output_channels_;
+      }
+      return kNoError;
 
-  err = voice_detection_->ProcessCaptureAudio(capture_audio_);
-  if (err != kNoError) {
-    return err;
+    // At 32 kHz, the audio is split into a low and high band when the first
+    // component asks for the split data, and the bands are recombined in
+    // InterleaveTo() if a component modified them.
+    case kCaptureStageHighPassFilter:
+      return high_pass_filter_->ProcessCaptureAudio(capture_audio_);
+
+    case kCaptureStageAnalyzeGain:
+      return gain_control_->AnalyzeCaptureAudio(capture_audio_);
+
+    case kCaptureStageEchoCancellation:
+      return echo_cancellation_->ProcessCaptureAudio(capture_audio_);
+
+    case kCaptureStageNoiseSuppression:
+      if (echo_control_mobile_->is_enabled() &&
+          noise_suppression_->is_enabled()) {
+        capture_audio_->CopyLowPassToReference();
+      }
+      return noise_suppression_->ProcessCaptureAudio(capture_audio_);
+
+    case kCaptureStageEchoControlMobile:
+      return echo_control_mobile_->ProcessCaptureAudio(capture_audio_);
+
+    case kCaptureStageVoiceDetection:
+      return voice_detection_->ProcessCaptureAudio(capture_audio_);
+
+    case kCaptureStageGainControl:
+      return gain_control_->ProcessCaptureAudio(capture_audio_);
+
+    case kCaptureStageInterleave:
+      //err = level_estimator_->ProcessCaptureAudio(capture_audio_);
+      //if (err != kNoError) {
+      //  return err;
+      //}
+
+      capture_audio_->InterleaveTo(frame);
+      was_stream_delay_set_ = false;
+      return kNoError;
   }
 
-  err = gain_control_->ProcessCaptureAudio(capture_audio_);
+  assert(false);
+  return kUnspecifiedError;
+}
+
+int AudioProcessingImpl::AnalyzeReverseStream(AudioFrame* frame) {
+  CriticalSectionScoped crit_scoped(*render_crit_);
+  // Adding zero reads the format with a full memory barrier.
+  const int format = (render_format_ += 0);
+  int err = CheckRenderFrame(frame, format / (kMaxNumChannels + 1),
+                             format % (kMaxNumChannels + 1));
   if (err != kNoError) {
     return err;
   }
 
-  //err = level_estimator_->ProcessCaptureAudio(capture_audio_);
-  //if (err != kNoError) {
-  //  return err;
-  //}
+  if (!render_queue_->Insert(*frame)) {
+    // ProcessStream() is not keeping up, or not called at all.
+    CriticalSectionScoped crit_scoped(*crit_);
+    ProcessRenderQueueLocked();
+    err = ProcessRenderFrameLocked(frame);
+  }
 
-  if (sample_rate_hz_ == kSampleRate32kHz) {
-    for (int i = 0; i < num_capture_output_channels_; i++) {
-      // Recombine low and high bands.
-      SplittingFilterSynthesis(capture_audio_->low_pass_split_data(i),
-                               capture_audio_->high_pass_split_data(i),
-                               capture_audio_->data(i),
-                               capture_audio_->synthesis_filter_state1(i),
-                               capture_audio_->synthesis_filter_state2(i));
+  const int queued_err = render_error_.Value();
+  if (queued_err != kNoError) {
+    render_error_.CompareExchange(kNoError, queued_err);
+    if (err == kNoError) {
+      err = queued_err;
     }
   }
-
-  capture_audio_->InterleaveTo(frame);
-
-  return kNoError;
+  return err;  // TODO(ajm): this is for returning warnings; necessary?
 }
 
-int AudioProcessingImpl::AnalyzeReverseStream(AudioFrame* frame) {
-  CriticalSectionScoped crit_scoped(*crit_);
-  int err = kNoError;
-
+int AudioProcessingImpl::CheckRenderFrame(const AudioFrame* frame,
+                                          int sample_rate_hz,
+                                          int num_channels) {
   if (frame == NULL) {
     return kNullPointerError;
   }
 
   if (frame->_frequencyInHz !=
-      static_cast<WebRtc_UWord32>(sample_rate_hz_)) {
+      static_cast<WebRtc_UWord32>(sample_rate_hz)) {
     return kBadSampleRateError;
   }
 
-  if (frame->_audioChannel != num_render_input_channels_) {
+  if (frame->_audioChannel != num_channels) {
     return kBadNumberChannelsError;
   }
 
-  if (frame->_payloadDataLengthInSamples != samples_per_channel_) {
+  if (frame->_payloadDataLengthInSamples != sample_rate_hz / 100) {
     return kBadDataLengthError;
   }
 
-  if (debug_file_->Open()) {
-    WebRtc_UWord8 event = kRenderEvent;
-    if (!debug_file_->Write(&event, sizeof(event))) {
-      return kFileError;
-    }
-
-    if (!debug_file_->Write(&frame->_frequencyInHz,
-                                   sizeof(frame->_frequencyInHz))) {
-      return kFileError;
-    }
+  return kNoError;
+}
 
-    if (!debug_file_->Write(&frame->_audioChannel,
-                                   sizeof(frame->_audioChannel))) {
-      return kFileError;
+void AudioProcessingImpl::ProcessRenderQueueLocked() {
+  AudioFrame* frame = NULL;
+  while ((frame = render_queue_->Front()) != NULL) {
+    const int err = ProcessRenderFrameLocked(frame);
+    if (err != kNoError) {
+      render_error_.CompareExchange(err, kNoError);
     }
+    render_queue_->Pop();
+  }
+}
 
-    if (!debug_file_->Write(&frame->_payloadDataLengthInSamples,
-        sizeof(frame->_payloadDataLengthInSamples))) {
-      return kFileError;
-    }
+int AudioProcessingImpl::ProcessRenderFrameLocked(AudioFrame* frame) {
+  // The settings may have changed since the frame was queued.
+  int err = CheckRenderFrame(frame, sample_rate_hz_,
+                             num_render_input_channels_);
+  if (err != kNoError) {
+    return err;
+  }
 
-    if (!debug_file_->Write(frame->_payloadData,
-        sizeof(WebRtc_Word16) * frame->_payloadDataLengthInSamples *
-        frame->_audioChannel)) {
-      return kFileError;
-    }
+  if (debug_writer_ != NULL) {
+    debug_writer_->WriteFrame(DebugWriter::kRenderEvent, *frame);
   }
 
   render_audio_->DeinterleaveFrom(frame);
 
-  // TODO(ajm): turn the splitting filter into a component?
-  if (sample_rate_hz_ == kSampleRate32kHz) {
-    for (int i = 0; i < num_render_input_channels_; i++) {
-      // Split into low and high band.
-      SplittingFilterAnalysis(render_audio_->data(i),
-                              render_audio_->low_pass_split_data(i),
-                              render_audio_->high_pass_split_data(i),
-                              render_audio_->analysis_filter_state1(i),
-                              render_audio_->analysis_filter_state2(i));
-    }
-  }
-
   // TODO(ajm): warnings possible from components?
   err = echo_cancellation_->ProcessRenderAudio(render_audio_);
   if (err != kNoError) {
@@ -459,11 +500,11 @@ int AudioProcessingImpl::AnalyzeReverseStream(AudioFrame* frame) {
   //  return err;
   //}
 
-  was_stream_delay_set_ = false;
-  return err;  // TODO(ajm): this is for returning warnings; necessary?
+  return kNoError;
 }
 
 int AudioProcessingImpl::set_stream_delay_ms(int delay) {
+  CriticalSectionScoped crit_scoped(*crit_);
   was_stream_delay_set_ = true;
   if (delay < 0) {
     return kBadParameterError;
@@ -489,56 +530,97 @@ bool AudioProcessingImpl::was_stream_delay_set() const {
 
 int AudioProcessingImpl::StartDebugRecording(
     const char filename[AudioProcessing::kMaxFilenameSize]) {
-  CriticalSectionScoped crit_scoped(*crit_);
+  return StartDebugRecording(filename, 0);
+}
+
+int AudioProcessingImpl::StartDebugRecording(
+    const char filename[AudioProcessing::kMaxFilenameSize],
+    int max_bytes) {
   assert(kMaxFilenameSize == FileWrapper::kMaxFileNameSize);
 
   if (filename == NULL) {
     return kNullPointerError;
   }
 
-  // Stop any ongoing recording.
-  if (debug_file_->Open()) {
-    if (debug_file_->CloseFile() == -1) {
-      return kFileError;
-    }
+  if (max_bytes < 0) {
+    return kBadParameterError;
   }
 
-  if (debug_file_->OpenFile(filename, false) == -1) {
-    debug_file_->CloseFile();
+  // Any ongoing recording is stopped first.
+  if (StopDebugRecording() != kNoError) {
     return kFileError;
   }
 
-  if (debug_file_->WriteText("%s\n", kMagicNumber) == -1) {
-    debug_file_->CloseFile();
-    return kFileError;
+  int sample_rate_hz = 0;
+  {
+    CriticalSectionScoped crit_scoped(*crit_);
+    sample_rate_hz = sample_rate_hz_;
   }
 
-  // TODO(ajm): should we do this? If so, we need the number of channels etc.
-  // Record the default sample rate.
-  WebRtc_UWord8 event = kInitializeEvent;
-  if (!debug_file_->Write(&event, sizeof(event))) {
+  // The file is opened without holding the lock.
+  DebugWriter* debug_writer =
+      new DebugWriter(id_, DebugWriter::kDefaultBufferSize);
+  if (debug_writer->Start(filename, sample_rate_hz, max_bytes) == -1) {
+    delete debug_writer;
     return kFileError;
   }
 
-  if (!debug_file_->Write(&sample_rate_hz_, sizeof(sample_rate_hz_))) {
-    return kFileError;
+  DebugWriter* old_debug_writer = NULL;
+  {
+    CriticalSectionScoped crit_scoped(*crit_);
+    old_debug_writer = debug_writer_;
+    debug_writer_ = debug_writer;
+  }
+  // Another recording may have been started meanwhile.
+  if (old_debug_writer != NULL) {
+    StopDebugWriter(old_debug_writer);
   }
 
   return kNoError;
 }
 
 int AudioProcessingImpl::StopDebugRecording() {
-  CriticalSectionScoped crit_scoped(*crit_);
+  DebugWriter* debug_writer = NULL;
+  {
+    CriticalSectionScoped crit_scoped(*crit_);
+    debug_writer = debug_writer_;
+    debug_writer_ = NULL;
+  }
+
   // We just return if recording hasn't started.
-  if (debug_file_->Open()) {
-    if (debug_file_->CloseFile() == -1) {
-      return kFileError;
-    }
+  if (debug_writer == NULL) {
+    return kNoError;
+  }
+
+  if (StopDebugWriter(debug_writer) == -1) {
+    return kFileError;
   }
 
   return kNoError;
 }
 
+int AudioProcessingImpl::StopDebugWriter(DebugWriter* debug_writer) {
+  // Writes out the queued frames without holding the lock.
+  const int err = debug_writer->Stop();
+  {
+    CriticalSectionScoped crit_scoped(*crit_);
+    debug_dropped_frames_ = debug_writer->dropped_frames();
+  }
+  // A writer thread which failed to stop may still use the writer.
+  if (!debug_writer->thread_running()) {
+    delete debug_writer;
+  }
+  return err;
+}
+
+int AudioProcessingImpl::debug_recording_dropped_frames() const {
+  CriticalSectionScoped crit_scoped(*crit_);
+  if (debug_writer_ != NULL) {
+    return debug_writer_->dropped_frames();
+  }
+  return debug_dropped_frames_;
+}
+
 EchoCancellation* AudioProcessingImpl::echo_cancellation() const {
   return echo_cancellation_;
 }
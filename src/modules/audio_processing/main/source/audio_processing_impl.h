@@ -13,13 +13,14 @@
 
 #include <list>
 
+#include "atomic32_wrapper.h"
 #include "audio_processing.h"
 
 namespace webrtc {
 class CriticalSectionWrapper;
-class FileWrapper;
 
 class AudioBuffer;
+class DebugWriter;
 class EchoCancellationImpl;
 class EchoControlMobileImpl;
 class GainControlImpl;
@@ -27,6 +28,7 @@ class HighPassFilterImpl;
 class LevelEstimatorImpl;
 class NoiseSuppressionImpl;
 class ProcessingComponent;
+class RenderQueue;
 class VoiceDetectionImpl;
 
 class AudioProcessingImpl : public AudioProcessing {
@@ -40,8 +42,26 @@ class AudioProcessingImpl : public AudioProcessing {
   explicit AudioProcessingImpl(int id);
   virtual ~AudioProcessingImpl();
 
+  // The steps of ProcessStream(), in order. ProcessStreams() runs each step
+  // over a batch of streams before moving on to the next.
+  enum CaptureStage {
+    kCaptureStageDeinterleave,
+    kCaptureStageHighPassFilter,
+    kCaptureStageAnalyzeGain,
+    kCaptureStageEchoCancellation,
+    kCaptureStageNoiseSuppression,
+    kCaptureStageEchoControlMobile,
+    kCaptureStageVoiceDetection,
+    kCaptureStageGainControl,
+    kCaptureStageInterleave,
+    kNumCaptureStages
+  };
+
   CriticalSectionWrapper* crit() const;
 
+  // Runs one step of ProcessStream() on |frame|. The lock must be held.
+  int ProcessCaptureStageLocked(int stage, AudioFrame* frame);
+
   int split_sample_rate_hz() const;
   bool was_stream_delay_set() const;
 
@@ -60,7 +80,10 @@ class AudioProcessingImpl : public AudioProcessing {
   virtual int set_stream_delay_ms(int delay);
   virtual int stream_delay_ms() const;
   virtual int StartDebugRecording(const char filename[kMaxFilenameSize]);
+  virtual int StartDebugRecording(const char filename[kMaxFilenameSize],
+                                  int max_bytes);
   virtual int StopDebugRecording();
+  virtual int debug_recording_dropped_frames() const;
   virtual EchoCancellation* echo_cancellation() const;
   virtual EchoControlMobile* echo_control_mobile() const;
   virtual GainControl* gain_control() const;
@@ -76,6 +99,18 @@ class AudioProcessingImpl : public AudioProcessing {
   virtual WebRtc_Word32 ChangeUniqueId(const WebRtc_Word32 id);
 
  private:
+  // Returns an error if |frame| does not match the given reverse stream
+  // format.
+  static int CheckRenderFrame(const AudioFrame* frame, int sample_rate_hz,
+                              int num_channels);
+  // Runs the reverse stream processing on the frames queued by
+  // AnalyzeReverseStream(). The lock must be held.
+  void ProcessRenderQueueLocked();
+  // Stops and deletes a writer which has been detached from
+  // |debug_writer_|. Returns -1 on failure.
+  int StopDebugWriter(DebugWriter* debug_writer);
+  int ProcessRenderFrameLocked(AudioFrame* frame);
+
   int id_;
 
   EchoCancellationImpl* echo_cancellation_;
@@ -88,15 +123,33 @@ class AudioProcessingImpl : public AudioProcessing {
 
   std::list<ProcessingComponent*> component_list_;
 
-  FileWrapper* debug_file_;
+  // Only exists while recording. It is set and read under |crit_|, but
+  // stopped outside of it so that writing out the queued frames does not
+  // block processing.
+  DebugWriter* debug_writer_;
+  // Frames dropped by the last stopped recording.
+  int debug_dropped_frames_;
   CriticalSectionWrapper* crit_;
 
+  // AnalyzeReverseStream() queues the frames under |render_crit_|, which the
+  // capture side never takes, and ProcessStream() processes them under
+  // |crit_|. The first error from processing a queued frame is kept in
+  // |render_error_| for AnalyzeReverseStream() to return.
+  CriticalSectionWrapper* render_crit_;
+  RenderQueue* render_queue_;
+  Atomic32Wrapper render_error_;
+  // The reverse stream sample rate and number of channels, packed into one
+  // word so that AnalyzeReverseStream() can read them together without
+  // |crit_|. Set under |crit_| by InitializeLocked().
+  Atomic32Wrapper render_format_;
+
   AudioBuffer* render_audio_;
   AudioBuffer* capture_audio_;
 
   int sample_rate_hz_;
   int split_sample_rate_hz_;
   int samples_per_channel_;
+  // Guarded by |crit_|. The delay must be set again for each capture frame.
   int stream_delay_ms_;
   bool was_stream_delay_set_;
 
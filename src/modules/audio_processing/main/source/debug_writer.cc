@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "debug_writer.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "module_common_types.h"
+
+#include "event_wrapper.h"
+#include "file_wrapper.h"
+#include "thread_wrapper.h"
+#include "trace.h"
+
+namespace webrtc {
+namespace {
+const char kMagicNumber[] = "#!vqetrace1.2";
+
+// How often the writer thread empties the buffer.
+const unsigned long kDrainIntervalMs = 20;
+}  // namespace
+
+DebugWriter::DebugWriter(int id, int buffer_size)
+    : id_(id),
+      buffer_size_(buffer_size),
+      file_(FileWrapper::Create()),
+      thread_(NULL),
+      wake_event_(EventWrapper::Create()),
+      recording_(false),
+      buffer_(NULL),
+      used_(0),
+      write_pos_(0),
+      read_pos_(0),
+      max_bytes_(0),
+      file_bytes_(0),
+      limit_reached_(false),
+      dropped_frames_(0),
+      write_error_(false) {}
+
+DebugWriter::~DebugWriter() {
+  Stop();
+  assert(thread_ == NULL);
+
+  delete file_;
+  file_ = NULL;
+
+  delete wake_event_;
+  wake_event_ = NULL;
+}
+
+int DebugWriter::Start(const char* filename, int sample_rate_hz,
+                       int max_bytes) {
+  if (Stop() == -1) {
+    return -1;
+  }
+
+  if (file_->OpenFile(filename, false) == -1) {
+    file_->CloseFile();
+    return -1;
+  }
+
+  // The header is small and written before the audio thread starts queuing.
+  if (file_->WriteText("%s\n", kMagicNumber) == -1) {
+    file_->CloseFile();
+    return -1;
+  }
+
+  // TODO(ajm): should we do this? If so, we need the number of channels etc.
+  // Record the default sample rate.
+  WebRtc_UWord8 event = kInitializeEvent;
+  if (!file_->Write(&event, sizeof(event)) ||
+      !file_->Write(&sample_rate_hz, sizeof(sample_rate_hz))) {
+    file_->CloseFile();
+    return -1;
+  }
+
+  buffer_ = new WebRtc_UWord8[buffer_size_];
+  used_ = 0;
+  write_pos_ = 0;
+  read_pos_ = 0;
+  max_bytes_ = max_bytes;
+  file_bytes_ = static_cast<int>(strlen(kMagicNumber) + 1 + sizeof(event) +
+                                 sizeof(sample_rate_hz));
+  limit_reached_ = false;
+  dropped_frames_ = 0;
+  write_error_ = false;
+
+  thread_ = ThreadWrapper::CreateThread(Run, this, kNormalPriority,
+                                        "DebugWriter");
+  unsigned int thread_id = 0;
+  if (thread_ == NULL || !thread_->Start(thread_id)) {
+    delete thread_;
+    thread_ = NULL;
+    delete [] buffer_;
+    buffer_ = NULL;
+    file_->CloseFile();
+    return -1;
+  }
+
+  recording_ = true;
+  return 0;
+}
+
+int DebugWriter::Stop() {
+  if (thread_running()) {
+    return -1;
+  }
+  if (!recording_) {
+    return 0;
+  }
+  recording_ = false;
+
+  thread_->SetNotAlive();
+  wake_event_->Set();
+  if (!thread_->Stop()) {
+    // The thread may still be in Drain(), so everything it reaches is left
+    // as it is, |thread_| included.
+    WEBRTC_TRACE(kTraceError, kTraceAudioProcessing, id_,
+                 "Failed to stop the debug recording thread");
+    return -1;
+  }
+  delete thread_;
+  thread_ = NULL;
+  wake_event_->Reset();
+
+  Drain();
+  delete [] buffer_;
+  buffer_ = NULL;
+
+  if (dropped_frames_ > 0) {
+    WEBRTC_TRACE(kTraceWarning, kTraceAudioProcessing, id_,
+                 "Debug recording dropped %d frames", dropped_frames_);
+  }
+  if (limit_reached_) {
+    WEBRTC_TRACE(kTraceInfo, kTraceAudioProcessing, id_,
+                 "Debug recording stopped at its limit of %d bytes",
+                 max_bytes_);
+  }
+
+  if (file_->CloseFile() == -1 || write_error_) {
+    return -1;
+  }
+  return 0;
+}
+
+void DebugWriter::WriteFrame(Event event, const AudioFrame& frame) {
+  if (!recording_ || limit_reached_) {
+    return;
+  }
+
+  const WebRtc_UWord8 event_byte = static_cast<WebRtc_UWord8>(event);
+  const int data_length = sizeof(WebRtc_Word16) *
+      frame._payloadDataLengthInSamples * frame._audioChannel;
+  const int length = sizeof(event_byte) + sizeof(frame._frequencyInHz) +
+      sizeof(frame._audioChannel) + sizeof(frame._payloadDataLengthInSamples) +
+      data_length;
+
+  // Nothing is written after the first frame over the limit, so that the
+  // file holds a gapless prefix of the recording.
+  if (max_bytes_ > 0 && length > max_bytes_ - file_bytes_) {
+    limit_reached_ = true;
+    return;
+  }
+
+  // |used_| only shrinks behind our back, so a stale value is on the safe
+  // side.
+  if (length > buffer_size_ - used_.Value()) {
+    dropped_frames_++;
+    return;
+  }
+
+  Push(&event_byte, sizeof(event_byte));
+  Push(&frame._frequencyInHz, sizeof(frame._frequencyInHz));
+  Push(&frame._audioChannel, sizeof(frame._audioChannel));
+  Push(&frame._payloadDataLengthInSamples,
+       sizeof(frame._payloadDataLengthInSamples));
+  Push(frame._payloadData, data_length);
+
+  // Publishes the record; the add is a full memory barrier.
+  used_ += length;
+  file_bytes_ += length;
+}
+
+bool DebugWriter::thread_running() const {
+  return !recording_ && thread_ != NULL;
+}
+
+int DebugWriter::dropped_frames() const {
+  return dropped_frames_;
+}
+
+bool DebugWriter::Run(void* obj) {
+  return static_cast<DebugWriter*>(obj)->Process();
+}
+
+bool DebugWriter::Process() {
+  wake_event_->Wait(kDrainIntervalMs);
+  Drain();
+  return true;
+}
+
+void DebugWriter::Drain() {
+  // Adding zero reads |used_| with a full memory barrier, which makes the
+  // published records visible. Value() is a plain load.
+  int available = (used_ += 0);
+  while (available > 0) {
+    int chunk = buffer_size_ - read_pos_;
+    if (chunk > available) {
+      chunk = available;
+    }
+    // Keep draining after an error so the audio thread is not starved.
+    if (!write_error_ && !file_->Write(buffer_ + read_pos_, chunk)) {
+      write_error_ = true;
+    }
+    read_pos_ = (read_pos_ + chunk) % buffer_size_;
+    available -= chunk;
+    used_ -= chunk;
+  }
+}
+
+void DebugWriter::Push(const void* data, int length) {
+  const WebRtc_UWord8* bytes = static_cast<const WebRtc_UWord8*>(data);
+  int chunk = buffer_size_ - write_pos_;
+  if (chunk > length) {
+    chunk = length;
+  }
+  memcpy(buffer_ + write_pos_, bytes, chunk);
+  memcpy(buffer_, bytes + chunk, length - chunk);
+  write_pos_ = (write_pos_ + length) % buffer_size_;
+}
+}  // namespace webrtc
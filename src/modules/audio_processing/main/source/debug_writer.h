@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_DEBUG_WRITER_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_DEBUG_WRITER_H_
+
+#include "atomic32_wrapper.h"
+#include "typedefs.h"
+
+namespace webrtc {
+class AudioFrame;
+class EventWrapper;
+class FileWrapper;
+class ThreadWrapper;
+
+// Writes the APM debug recording from a background thread. The audio thread
+// serializes each frame into a ring buffer and never touches the file;
+// frames which do not fit are dropped whole and counted. The buffer is only
+// allocated while recording.
+//
+// Start(), Stop() and WriteFrame() must not be called concurrently with each
+// other. AudioProcessingImpl calls WriteFrame() under its lock and Stop()
+// only after it has stopped calling WriteFrame(), outside of the lock.
+//
+// If Stop() fails to stop the writer thread, the thread may still be using
+// the writer, which then must be leaked rather than deleted.
+class DebugWriter {
+ public:
+  enum Event {
+    kInitializeEvent,
+    kRenderEvent,
+    kCaptureEvent
+  };
+
+  // Holds several seconds of 32 kHz stereo capture and render audio.
+  enum { kDefaultBufferSize = 1 << 20 };
+
+  // |buffer_size| caps the memory used for queued frames while recording.
+  DebugWriter(int id, int buffer_size);
+  // The writer must not be recording, or Stop() must have succeeded.
+  ~DebugWriter();
+
+  // Opens |filename|, writes the file header and the initial sample rate and
+  // starts the writer thread. Any ongoing recording is stopped first. Frames
+  // which would make the file larger than |max_bytes| are not written, nor
+  // any frame after them; 0 means no limit.
+  // Returns 0 on success and -1 if the file could not be opened or written.
+  int Start(const char* filename, int sample_rate_hz, int max_bytes);
+
+  // Writes out all queued frames, stops the writer thread and closes the
+  // file. Returns -1 if any write failed during the recording, or if the
+  // thread could not be stopped; see thread_running().
+  int Stop();
+
+  // True if Stop() failed to stop the writer thread. Nothing the thread uses
+  // has been touched, and the writer can neither be restarted nor deleted.
+  bool thread_running() const;
+
+  // Queues |frame| as an |event| record. Never blocks.
+  void WriteFrame(Event event, const AudioFrame& frame);
+
+  // Number of frames dropped by the current or last recording.
+  int dropped_frames() const;
+
+ private:
+  static bool Run(void* obj);
+  bool Process();
+  // Writes the queued bytes to |file_|. Called on the writer thread while
+  // recording and from Stop() once the thread is gone.
+  void Drain();
+  void Push(const void* data, int length);
+
+  int id_;
+  const int buffer_size_;
+  FileWrapper* file_;
+  ThreadWrapper* thread_;
+  EventWrapper* wake_event_;
+  bool recording_;
+
+  WebRtc_UWord8* buffer_;
+  // Bytes in |buffer_|. The audio thread adds to it after copying a record
+  // in, the writer thread subtracts after the bytes have reached the file.
+  Atomic32Wrapper used_;
+  // Only touched by the audio thread.
+  int write_pos_;
+  // Only touched by the writer thread, or by Stop() after it has exited.
+  int read_pos_;
+
+  // Only touched by the audio thread. |file_bytes_| counts the bytes queued
+  // for the file, including the header.
+  int max_bytes_;
+  int file_bytes_;
+  bool limit_reached_;
+
+  int dropped_frames_;
+  bool write_error_;
+};
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_DEBUG_WRITER_H_
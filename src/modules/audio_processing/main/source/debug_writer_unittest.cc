@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file includes unit tests for the format, byte limit and dropped frames
+ * of the DebugWriter recordings.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "debug_writer.h"
+#include "module_common_types.h"
+
+namespace {
+
+using webrtc::AudioFrame;
+using webrtc::DebugWriter;
+
+const char kFilename[] = "debug_writer_unittest.dat";
+const char kMagicNumber[] = "#!vqetrace1.2\n";
+const int kSampleRateHz = 16000;
+const int kSamples = kSampleRateHz / 100;
+
+// One record of a recording, as read back from the file.
+struct Record {
+  int event;
+  WebRtc_UWord32 frequency_hz;
+  WebRtc_UWord8 channels;
+  WebRtc_UWord16 samples;
+  std::vector<WebRtc_Word16> data;
+};
+
+// Fills |frame| with a ramp starting at |first|.
+void SetFrame(int first, int channels, AudioFrame* frame) {
+  frame->_frequencyInHz = kSampleRateHz;
+  frame->_audioChannel = static_cast<WebRtc_UWord8>(channels);
+  frame->_payloadDataLengthInSamples = kSamples;
+  for (int i = 0; i < kSamples * channels; i++) {
+    frame->_payloadData[i] = static_cast<WebRtc_Word16>(first + i);
+  }
+}
+
+int RecordBytes(int channels) {
+  return sizeof(WebRtc_UWord8) + sizeof(WebRtc_UWord32) +
+      sizeof(WebRtc_UWord8) + sizeof(WebRtc_UWord16) +
+      static_cast<int>(sizeof(WebRtc_Word16)) * kSamples * channels;
+}
+
+int HeaderBytes() {
+  return static_cast<int>(strlen(kMagicNumber) + sizeof(WebRtc_UWord8) +
+                          sizeof(int));
+}
+
+// Parses |kFilename| into |records|, after checking the header. Returns
+// false if the file is malformed.
+bool ReadRecording(std::vector<Record>* records) {
+  FILE* file = fopen(kFilename, "rb");
+  if (file == NULL) {
+    return false;
+  }
+  char magic[sizeof(kMagicNumber)] = {0};
+  WebRtc_UWord8 event = 0;
+  int sample_rate_hz = 0;
+  bool ok = fread(magic, 1, strlen(kMagicNumber), file) ==
+                strlen(kMagicNumber) &&
+            strcmp(magic, kMagicNumber) == 0 &&
+            fread(&event, sizeof(event), 1, file) == 1 &&
+            event == DebugWriter::kInitializeEvent &&
+            fread(&sample_rate_hz, sizeof(sample_rate_hz), 1, file) == 1 &&
+            sample_rate_hz == kSampleRateHz;
+
+  while (ok && fread(&event, sizeof(event), 1, file) == 1) {
+    Record record;
+    record.event = event;
+    ok = fread(&record.frequency_hz, sizeof(record.frequency_hz), 1,
+               file) == 1 &&
+         fread(&record.channels, sizeof(record.channels), 1, file) == 1 &&
+         fread(&record.samples, sizeof(record.samples), 1, file) == 1;
+    if (ok) {
+      const size_t length = record.samples * record.channels;
+      record.data.resize(length);
+      ok = fread(&record.data[0], sizeof(WebRtc_Word16), length, file) ==
+           length;
+      records->push_back(record);
+    }
+  }
+  fclose(file);
+  return ok;
+}
+
+TEST(DebugWriterTest, RecordsFramesInOrder) {
+  DebugWriter writer(0, DebugWriter::kDefaultBufferSize);
+  ASSERT_EQ(0, writer.Start(kFilename, kSampleRateHz, 0));
+  AudioFrame frame;
+  for (int i = 0; i < 10; i++) {
+    SetFrame(1000 * i, 1 + i % 2, &frame);
+    writer.WriteFrame(i % 2 ? DebugWriter::kRenderEvent :
+                      DebugWriter::kCaptureEvent, frame);
+  }
+  EXPECT_EQ(0, writer.Stop());
+  EXPECT_EQ(0, writer.dropped_frames());
+  EXPECT_FALSE(writer.thread_running());
+
+  std::vector<Record> records;
+  ASSERT_TRUE(ReadRecording(&records));
+  ASSERT_EQ(10u, records.size());
+  for (int i = 0; i < 10; i++) {
+    const Record& record = records[i];
+    EXPECT_EQ(i % 2 ? DebugWriter::kRenderEvent : DebugWriter::kCaptureEvent,
+              record.event);
+    EXPECT_EQ(static_cast<WebRtc_UWord32>(kSampleRateHz), record.frequency_hz);
+    EXPECT_EQ(1 + i % 2, record.channels);
+    EXPECT_EQ(kSamples, record.samples);
+    for (size_t j = 0; j < record.data.size(); j++) {
+      ASSERT_EQ(1000 * i + static_cast<int>(j), record.data[j]);
+    }
+  }
+  remove(kFilename);
+}
+
+TEST(DebugWriterTest, StopsAtTheByteLimit) {
+  const int kFrames = 5;
+  DebugWriter writer(0, DebugWriter::kDefaultBufferSize);
+  // Room for the header, |kFrames| mono frames and part of another.
+  const int max_bytes = HeaderBytes() + (kFrames + 1) * RecordBytes(1) - 1;
+  ASSERT_EQ(0, writer.Start(kFilename, kSampleRateHz, max_bytes));
+  AudioFrame frame;
+  SetFrame(0, 1, &frame);
+  for (int i = 0; i < kFrames + 1; i++) {
+    writer.WriteFrame(DebugWriter::kCaptureEvent, frame);
+  }
+  // Would fit, but the recording must not have a gap.
+  frame._payloadDataLengthInSamples = 1;
+  writer.WriteFrame(DebugWriter::kCaptureEvent, frame);
+  EXPECT_EQ(0, writer.Stop());
+  // Frames over the limit are not counted as dropped.
+  EXPECT_EQ(0, writer.dropped_frames());
+
+  std::vector<Record> records;
+  ASSERT_TRUE(ReadRecording(&records));
+  EXPECT_EQ(static_cast<size_t>(kFrames), records.size());
+
+  FILE* file = fopen(kFilename, "rb");
+  ASSERT_TRUE(file != NULL);
+  fseek(file, 0, SEEK_END);
+  EXPECT_EQ(HeaderBytes() + kFrames * RecordBytes(1), ftell(file));
+  fclose(file);
+  remove(kFilename);
+}
+
+TEST(DebugWriterTest, CountsDroppedFrames) {
+  const int kFrames = 100;
+  // Holds four stereo frames; the writer thread only drains it every 20 ms.
+  DebugWriter writer(0, 4 * RecordBytes(2));
+  ASSERT_EQ(0, writer.Start(kFilename, kSampleRateHz, 0));
+  AudioFrame frame;
+  for (int i = 0; i < kFrames; i++) {
+    SetFrame(i, 2, &frame);
+    writer.WriteFrame(DebugWriter::kCaptureEvent, frame);
+  }
+  EXPECT_EQ(0, writer.Stop());
+  const int dropped = writer.dropped_frames();
+  EXPECT_GT(dropped, 0);
+
+  // Frames are dropped whole, and the others are intact.
+  std::vector<Record> records;
+  ASSERT_TRUE(ReadRecording(&records));
+  EXPECT_EQ(static_cast<size_t>(kFrames - dropped), records.size());
+  int last_first = -1;
+  for (size_t i = 0; i < records.size(); i++) {
+    const int first = records[i].data[0];
+    EXPECT_GT(first, last_first);
+    last_first = first;
+    for (size_t j = 0; j < records[i].data.size(); j++) {
+      ASSERT_EQ(first + static_cast<int>(j), records[i].data[j]);
+    }
+  }
+
+  // The count starts over with the next recording.
+  ASSERT_EQ(0, writer.Start(kFilename, kSampleRateHz, 0));
+  EXPECT_EQ(0, writer.dropped_frames());
+  EXPECT_EQ(0, writer.Stop());
+  remove(kFilename);
+}
+
+}  // namespace
@@ -70,7 +70,7 @@ EchoCancellationImpl::EchoCancellationImpl(const AudioProcessingImpl* apm)
 
 EchoCancellationImpl::~EchoCancellationImpl() {}
 
-int EchoCancellationImpl::ProcessRenderAudio(const AudioBuffer* audio) {
+int EchoCancellationImpl::ProcessRenderAudio(AudioBuffer* audio) {
   if (!is_component_enabled()) {
     return apm_->kNoError;
   }
@@ -87,7 +87,7 @@ int EchoCancellationImpl::ProcessRenderAudio(const AudioBuffer* audio) {
       Handle* my_handle = static_cast<Handle*>(handle(handle_index));
       err = WebRtcAec_BufferFarend(
           my_handle,
-          audio->low_pass_split_data(j),
+          audio->low_pass_split_data_const(j),
           static_cast<WebRtc_Word16>(audio->samples_per_split_channel()));
 
       if (err != apm_->kNoError) {
@@ -24,7 +24,7 @@ class EchoCancellationImpl : public EchoCancellation,
   explicit EchoCancellationImpl(const AudioProcessingImpl* apm);
   virtual ~EchoCancellationImpl();
 
-  int ProcessRenderAudio(const AudioBuffer* audio);
+  int ProcessRenderAudio(AudioBuffer* audio);
   int ProcessCaptureAudio(AudioBuffer* audio);
 
   // EchoCancellation implementation.
@@ -77,7 +77,7 @@ EchoControlMobileImpl::~EchoControlMobileImpl() {
     }
 }
 
-int EchoControlMobileImpl::ProcessRenderAudio(const AudioBuffer* audio) {
+int EchoControlMobileImpl::ProcessRenderAudio(AudioBuffer* audio) {
   if (!is_component_enabled()) {
     return apm_->kNoError;
   }
@@ -94,7 +94,7 @@ int EchoControlMobileImpl::ProcessRenderAudio(const AudioBuffer* audio) {
       Handle* my_handle = static_cast<Handle*>(handle(handle_index));
       err = WebRtcAecm_BufferFarend(
           my_handle,
-          audio->low_pass_split_data(j),
+          audio->low_pass_split_data_const(j),
           static_cast<WebRtc_Word16>(audio->samples_per_split_channel()));
 
       if (err != apm_->kNoError) {
@@ -24,7 +24,7 @@ class EchoControlMobileImpl : public EchoControlMobile,
   explicit EchoControlMobileImpl(const AudioProcessingImpl* apm);
   virtual ~EchoControlMobileImpl();
 
-  int ProcessRenderAudio(const AudioBuffer* audio);
+  int ProcessRenderAudio(AudioBuffer* audio);
   int ProcessCaptureAudio(AudioBuffer* audio);
 
   // EchoControlMobile implementation.
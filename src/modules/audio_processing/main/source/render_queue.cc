@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "render_queue.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "module_common_types.h"
+
+namespace webrtc {
+namespace {
+// AudioFrame::operator=() refuses more than two channels, which APM accepts.
+void CopyFrame(const AudioFrame& from, AudioFrame* to) {
+  const int length = from._payloadDataLengthInSamples * from._audioChannel;
+  assert(length <= AudioFrame::kMaxAudioFrameSizeSamples);
+
+  to->_id = from._id;
+  to->_timeStamp = from._timeStamp;
+  to->_payloadDataLengthInSamples = from._payloadDataLengthInSamples;
+  to->_frequencyInHz = from._frequencyInHz;
+  to->_audioChannel = from._audioChannel;
+  to->_speechType = from._speechType;
+  to->_vadActivity = from._vadActivity;
+  to->_energy = from._energy;
+  to->_volume = from._volume;
+  memcpy(to->_payloadData, from._payloadData, sizeof(WebRtc_Word16) * length);
+}
+}  // namespace
+
+RenderQueue::RenderQueue(int capacity)
+    : capacity_(capacity),
+      frames_(new AudioFrame[capacity]),
+      write_pos_(0),
+      read_pos_(0),
+      num_frames_(0) {
+  assert(capacity > 0);
+}
+
+RenderQueue::~RenderQueue() {
+  delete [] frames_;
+  frames_ = NULL;
+}
+
+// The count is read with an atomic addition, which is a full memory barrier.
+// The frame accesses that follow can then not be reordered before the read.
+
+bool RenderQueue::Insert(const AudioFrame& frame) {
+  if ((num_frames_ += 0) == capacity_) {
+    return false;
+  }
+
+  CopyFrame(frame, &frames_[write_pos_]);
+  write_pos_ = (write_pos_ + 1) % capacity_;
+  ++num_frames_;
+  return true;
+}
+
+AudioFrame* RenderQueue::Front() {
+  if ((num_frames_ += 0) == 0) {
+    return NULL;
+  }
+
+  return &frames_[read_pos_];
+}
+
+void RenderQueue::Pop() {
+  assert(num_frames_.Value() > 0);
+  read_pos_ = (read_pos_ + 1) % capacity_;
+  --num_frames_;
+}
+
+void RenderQueue::Clear() {
+  while (Front() != NULL) {
+    Pop();
+  }
+}
+}  // namespace webrtc
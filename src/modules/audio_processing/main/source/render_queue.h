@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_RENDER_QUEUE_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_RENDER_QUEUE_H_
+
+#include "atomic32_wrapper.h"
+#include "typedefs.h"
+
+namespace webrtc {
+class AudioFrame;
+
+// A fixed size queue of reverse stream frames which passes them from the
+// render thread to the capture thread without a lock. One thread at a time
+// may call Insert(), and one thread at a time may call Front() and Pop().
+class RenderQueue {
+ public:
+  explicit RenderQueue(int capacity);
+  ~RenderQueue();
+
+  // Copies |frame| to the back of the queue. Returns false if the queue is
+  // full.
+  bool Insert(const AudioFrame& frame);
+
+  // Returns the oldest frame, or NULL if the queue is empty. The frame stays
+  // in the queue until Pop() is called.
+  AudioFrame* Front();
+  void Pop();
+
+  // Removes all frames. Must be called from the thread removing frames.
+  void Clear();
+
+ private:
+  const int capacity_;
+  AudioFrame* frames_;
+  // Only accessed by the inserting and the removing thread, respectively.
+  int write_pos_;
+  int read_pos_;
+  // Updated after a frame has been written or read, which publishes the
+  // frame to the other thread.
+  Atomic32Wrapper num_frames_;
+};
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_MAIN_SOURCE_RENDER_QUEUE_H_
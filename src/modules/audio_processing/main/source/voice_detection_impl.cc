@@ -66,7 +66,7 @@ int VoiceDetectionImpl::ProcessCaptureAudio(AudioBuffer* audio) {
   }
   assert(audio->samples_per_split_channel() <= 160);
 
-  WebRtc_Word16* mixed_data = audio->low_pass_split_data(0);
+  const WebRtc_Word16* mixed_data = audio->low_pass_split_data_const(0);
   if (audio->num_channels() > 1) {
     audio->CopyAndMixLowPass(1);
     mixed_data = audio->mixed_low_pass_data(0);
@@ -74,10 +74,11 @@ int VoiceDetectionImpl::ProcessCaptureAudio(AudioBuffer* audio) {
 
   // TODO(ajm): concatenate data in frame buffer here.
 
+  // WebRtcVad_Process() does not modify the frame.
   int vad_ret_val;
   vad_ret_val = WebRtcVad_Process(static_cast<Handle*>(handle(0)),
                       apm_->split_sample_rate_hz(),
-                      mixed_data,
+                      const_cast<WebRtc_Word16*>(mixed_data),
                       frame_size_samples_);
 
   if (vad_ret_val == 0) {
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Processes a number of streams, as a server would, once with a
+// ProcessStream() call per stream and frame and once with one
+// ProcessStreams() call per frame, checks that the outputs are identical and
+// prints the time spent for both. Every stream gets a different part of the
+// input file, processed with high pass filter, noise suppression, AGC and
+// VAD.
+//
+// Usage: batch_benchmark [-n STREAMS] [-fs SAMPLE_RATE_HZ] [-i PCM_FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "audio_processing.h"
+#include "module_common_types.h"
+#include "tick_util.h"
+
+using webrtc::AudioFrame;
+using webrtc::AudioProcessing;
+using webrtc::GainControl;
+using webrtc::NoiseSuppression;
+using webrtc::TickTime;
+
+namespace {
+const char kDefaultInputFile[] = "test/data/audio_processing/aec_near.pcm";
+
+AudioProcessing* CreateApm(int id, int sample_rate_hz) {
+  AudioProcessing* apm = AudioProcessing::Create(id);
+  if (apm == NULL ||
+      apm->set_sample_rate_hz(sample_rate_hz) != apm->kNoError ||
+      apm->high_pass_filter()->Enable(true) != apm->kNoError ||
+      apm->noise_suppression()->set_level(NoiseSuppression::kHigh) !=
+          apm->kNoError ||
+      apm->noise_suppression()->Enable(true) != apm->kNoError ||
+      apm->gain_control()->set_mode(GainControl::kAdaptiveDigital) !=
+          apm->kNoError ||
+      apm->gain_control()->Enable(true) != apm->kNoError ||
+      apm->voice_detection()->Enable(true) != apm->kNoError) {
+    printf("Unable to create APM\n");
+    exit(1);
+  }
+  return apm;
+}
+
+// Processes |num_frames| frames of |num_streams| streams. Stream i starts at
+// frame i * |stream_offset| of |input|. The output is stored in |output|.
+// Returns the processing time in microseconds.
+WebRtc_Word64 Run(const std::vector<WebRtc_Word16>& input, int sample_rate_hz,
+                  int num_streams, int stream_offset, int num_frames,
+                  bool batch, std::vector<WebRtc_Word16>* output) {
+  const int frame_size = sample_rate_hz / 100;
+  std::vector<AudioProcessing*> apms(num_streams);
+  std::vector<AudioFrame> frames(num_streams);
+  std::vector<AudioFrame*> frame_ptrs(num_streams);
+  for (int i = 0; i < num_streams; i++) {
+    apms[i] = CreateApm(i, sample_rate_hz);
+    frame_ptrs[i] = &frames[i];
+  }
+  output->assign(num_streams * num_frames * frame_size, 0);
+
+  WebRtc_Word64 elapsed_us = 0;
+  for (int n = 0; n < num_frames; n++) {
+    for (int i = 0; i < num_streams; i++) {
+      frames[i]._frequencyInHz = sample_rate_hz;
+      frames[i]._audioChannel = 1;
+      frames[i]._payloadDataLengthInSamples = frame_size;
+      memcpy(frames[i]._payloadData,
+             &input[(i * stream_offset + n) * frame_size],
+             frame_size * sizeof(WebRtc_Word16));
+    }
+
+    const TickTime start = TickTime::Now();
+    if (batch) {
+      if (AudioProcessing::ProcessStreams(&apms[0], &frame_ptrs[0],
+                                          num_streams, NULL) !=
+          AudioProcessing::kNoError) {
+        printf("ProcessStreams() failed\n");
+        exit(1);
+      }
+    } else {
+      for (int i = 0; i < num_streams; i++) {
+        if (apms[i]->ProcessStream(&frames[i]) != apms[i]->kNoError) {
+          printf("ProcessStream() failed\n");
+          exit(1);
+        }
+      }
+    }
+    elapsed_us += (TickTime::Now() - start).Microseconds();
+
+    for (int i = 0; i < num_streams; i++) {
+      memcpy(&(*output)[(i * num_frames + n) * frame_size],
+             frames[i]._payloadData, frame_size * sizeof(WebRtc_Word16));
+    }
+  }
+
+  for (int i = 0; i < num_streams; i++) {
+    AudioProcessing::Destroy(apms[i]);
+  }
+  return elapsed_us;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int num_streams = 16;
+  int sample_rate_hz = 16000;
+  const char* input_filename = kDefaultInputFile;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      num_streams = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-fs") == 0 && i + 1 < argc) {
+      sample_rate_hz = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+      input_filename = argv[++i];
+    } else {
+      printf("Usage: batch_benchmark [-n STREAMS] [-fs SAMPLE_RATE_HZ] "
+             "[-i PCM_FILE]\n");
+      return 1;
+    }
+  }
+  if (num_streams <= 0) {
+    printf("The number of streams must be positive\n");
+    return 1;
+  }
+
+  FILE* file = fopen(input_filename, "rb");
+  if (file == NULL) {
+    printf("Unable to open %s\n", input_filename);
+    return 1;
+  }
+  std::vector<WebRtc_Word16> input;
+  WebRtc_Word16 buffer[1024];
+  size_t read = 0;
+  while ((read = fread(buffer, sizeof(WebRtc_Word16), 1024, file)) > 0) {
+    input.insert(input.end(), buffer, buffer + read);
+  }
+  fclose(file);
+
+  // Half of the file is processed by every stream, with the streams spread
+  // over the other half.
+  const int frame_size = sample_rate_hz / 100;
+  const int total_frames = static_cast<int>(input.size()) / frame_size;
+  const int num_frames = total_frames / 2;
+  const int stream_offset = (total_frames - num_frames) / num_streams;
+  if (num_frames == 0) {
+    printf("The input file is too short\n");
+    return 1;
+  }
+
+  std::vector<WebRtc_Word16> separate_output;
+  std::vector<WebRtc_Word16> batch_output;
+  const WebRtc_Word64 separate_us = Run(input, sample_rate_hz, num_streams,
+                                        stream_offset, num_frames, false,
+                                        &separate_output);
+  const WebRtc_Word64 batch_us = Run(input, sample_rate_hz, num_streams,
+                                     stream_offset, num_frames, true,
+                                     &batch_output);
+
+  const double frames = static_cast<double>(num_frames) * num_streams;
+  printf("%d streams at %d Hz, %d frames each\n", num_streams, sample_rate_hz,
+         num_frames);
+  printf("ProcessStream():  %6.2f us per stream and frame\n",
+         separate_us / frames);
+  printf("ProcessStreams(): %6.2f us per stream and frame (%.2fx)\n",
+         batch_us / frames,
+         batch_us > 0 ? static_cast<double>(separate_us) / batch_us : 0.0);
+
+  if (separate_output != batch_output) {
+    printf("FAILED: the outputs differ\n");
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -9,6 +9,7 @@
  */
 
 #include <cstdio>
+#include <cstring>
 
 #include <gtest/gtest.h>
 
@@ -367,20 +368,36 @@ TEST_F(ApmTest, StreamParameters) {
   EXPECT_EQ(apm_->kNoError,
             apm_->gain_control()->set_stream_analog_level(127));
   EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+  // The delay is needed for each capture frame, and reverse frames in
+  // between do not reset it.
+  EXPECT_EQ(apm_->kNoError, apm_->gain_control()->Enable(false));
+  EXPECT_EQ(apm_->kNoError, apm_->set_stream_delay_ms(100));
+  EXPECT_EQ(apm_->kNoError,
+            apm_->echo_cancellation()->set_stream_drift_samples(0));
+  EXPECT_EQ(apm_->kNoError, apm_->AnalyzeReverseStream(revframe_));
+  EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+  EXPECT_EQ(apm_->kNoError,
+            apm_->echo_cancellation()->set_stream_drift_samples(0));
+  EXPECT_EQ(apm_->kStreamParameterNotSetError,
+            apm_->ProcessStream(frame_));
 }
 
 TEST_F(ApmTest, Channels) {
   // Testing number of invalid channels
+  const int max_channels = apm_->kMaxNumChannels;
   EXPECT_EQ(apm_->kBadParameterError, apm_->set_num_channels(0, 1));
   EXPECT_EQ(apm_->kBadParameterError, apm_->set_num_channels(1, 0));
-  EXPECT_EQ(apm_->kBadParameterError, apm_->set_num_channels(3, 1));
+  EXPECT_EQ(apm_->kBadParameterError,
+            apm_->set_num_channels(max_channels + 1, 1));
   EXPECT_EQ(apm_->kBadParameterError, apm_->set_num_channels(1, 3));
   EXPECT_EQ(apm_->kBadParameterError, apm_->set_num_reverse_channels(0));
-  EXPECT_EQ(apm_->kBadParameterError, apm_->set_num_reverse_channels(3));
+  EXPECT_EQ(apm_->kBadParameterError,
+            apm_->set_num_reverse_channels(max_channels + 1));
   // Testing number of valid channels
-  for (int i = 1; i < 3; i++) {
-    for (int j = 1; j < 3; j++) {
-      if (j > i) {
+  for (int i = 1; i <= max_channels; i++) {
+    for (int j = 1; j <= max_channels; j++) {
+      // Only mixing to mono is supported.
+      if (j != i && j != 1) {
         EXPECT_EQ(apm_->kBadParameterError, apm_->set_num_channels(i, j));
       } else {
         EXPECT_EQ(apm_->kNoError, apm_->set_num_channels(i, j));
@@ -393,6 +410,248 @@ TEST_F(ApmTest, Channels) {
   }
 }
 
+TEST_F(ApmTest, MoreThanTwoChannels) {
+  const int kChannels = 4;
+  ASSERT_EQ(apm_->kNoError, apm_->set_num_channels(kChannels, 1));
+  ASSERT_EQ(apm_->kNoError, apm_->set_num_reverse_channels(kChannels));
+  frame_->_audioChannel = kChannels;
+  revframe_->_audioChannel = kChannels;
+  for (int i = 0; i < frame_->_payloadDataLengthInSamples; i++) {
+    for (int j = 0; j < kChannels; j++) {
+      frame_->_payloadData[i * kChannels + j] = i * 100 + j;
+      revframe_->_payloadData[i * kChannels + j] = i * 100 + j;
+    }
+  }
+
+  // With no component enabled the bands are never split, so the output is
+  // just the average of the channels.
+  EXPECT_EQ(apm_->kNoError, apm_->AnalyzeReverseStream(revframe_));
+  EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+  EXPECT_EQ(1, frame_->_audioChannel);
+  for (int i = 0; i < frame_->_payloadDataLengthInSamples; i++) {
+    EXPECT_EQ(i * 100 + 1, frame_->_payloadData[i]);
+  }
+
+  EXPECT_EQ(apm_->kNoError, apm_->noise_suppression()->Enable(true));
+  EXPECT_EQ(apm_->kNoError, apm_->gain_control()->Enable(true));
+  frame_->_audioChannel = kChannels;
+  EXPECT_EQ(apm_->kNoError, apm_->AnalyzeReverseStream(revframe_));
+  EXPECT_EQ(apm_->kNoError,
+            apm_->gain_control()->set_stream_analog_level(127));
+  EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+  EXPECT_EQ(1, frame_->_audioChannel);
+}
+
+TEST_F(ApmTest, SplitFilterStartsOverAfterUnusedFrames) {
+  const int kNumFrames = 10;
+  AudioProcessing* fresh = AudioProcessing::Create(1);
+  ASSERT_TRUE(fresh != NULL);
+  ASSERT_EQ(apm_->kNoError, fresh->set_sample_rate_hz(32000));
+  ASSERT_EQ(apm_->kNoError, fresh->set_num_channels(2, 2));
+  ASSERT_EQ(apm_->kNoError, fresh->noise_suppression()->Enable(true));
+
+  // The bands are split while the NS is enabled, and not while it isn't.
+  ASSERT_EQ(apm_->kNoError, apm_->noise_suppression()->Enable(true));
+  for (int i = 0; i < 3 * kNumFrames; i++) {
+    if (i == kNumFrames) {
+      ASSERT_EQ(apm_->kNoError, apm_->noise_suppression()->Enable(false));
+    } else if (i == 2 * kNumFrames) {
+      ASSERT_EQ(apm_->kNoError, apm_->noise_suppression()->Enable(true));
+    }
+    ASSERT_EQ(static_cast<size_t>(frame_->_payloadDataLengthInSamples * 2),
+              fread(frame_->_payloadData, sizeof(WebRtc_Word16),
+                    frame_->_payloadDataLengthInSamples * 2, near_file_));
+    AudioFrame fresh_frame = *frame_;
+    EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+
+    // Once enabled again, the output matches an APM which starts there.
+    if (i >= 2 * kNumFrames) {
+      EXPECT_EQ(apm_->kNoError, fresh->ProcessStream(&fresh_frame));
+      EXPECT_EQ(0, memcmp(fresh_frame._payloadData, frame_->_payloadData,
+                          sizeof(WebRtc_Word16) *
+                          frame_->_payloadDataLengthInSamples * 2));
+    }
+  }
+
+  AudioProcessing::Destroy(fresh);
+}
+
+TEST_F(ApmTest, ProcessStreams) {
+  // More than one batch of streams.
+  const int kNumStreams = 40;
+  const int kNumFrames = 20;
+  AudioProcessing* single[kNumStreams];
+  AudioProcessing* batch[kNumStreams];
+  AudioFrame single_frames[kNumStreams];
+  AudioFrame batch_frames[kNumStreams];
+  AudioFrame* batch_frame_ptrs[kNumStreams];
+  for (int i = 0; i < kNumStreams; i++) {
+    AudioProcessing* apms[2];
+    apms[0] = single[i] = AudioProcessing::Create(i);
+    apms[1] = batch[i] = AudioProcessing::Create(i);
+    for (int j = 0; j < 2; j++) {
+      ASSERT_TRUE(apms[j] != NULL);
+      ASSERT_EQ(apm_->kNoError, apms[j]->set_sample_rate_hz(32000));
+      ASSERT_EQ(apm_->kNoError, apms[j]->set_num_channels(2, 2));
+      ASSERT_EQ(apm_->kNoError, apms[j]->high_pass_filter()->Enable(true));
+      ASSERT_EQ(apm_->kNoError, apms[j]->noise_suppression()->Enable(true));
+      ASSERT_EQ(apm_->kNoError, apms[j]->gain_control()->set_mode(
+          GainControl::kAdaptiveDigital));
+      ASSERT_EQ(apm_->kNoError, apms[j]->gain_control()->Enable(true));
+      ASSERT_EQ(apm_->kNoError, apms[j]->voice_detection()->Enable(true));
+    }
+    batch_frame_ptrs[i] = &batch_frames[i];
+  }
+
+  // Every stream gets a different part of the file.
+  for (int frame = 0; frame < kNumFrames; frame++) {
+    for (int i = 0; i < kNumStreams; i++) {
+      ASSERT_EQ(static_cast<size_t>(frame_->_payloadDataLengthInSamples * 2),
+                fread(frame_->_payloadData, sizeof(WebRtc_Word16),
+                      frame_->_payloadDataLengthInSamples * 2, near_file_));
+      single_frames[i] = *frame_;
+      batch_frames[i] = *frame_;
+      EXPECT_EQ(apm_->kNoError, single[i]->ProcessStream(&single_frames[i]));
+    }
+
+    int errors[kNumStreams];
+    EXPECT_EQ(apm_->kNoError, AudioProcessing::ProcessStreams(
+        batch, batch_frame_ptrs, kNumStreams, errors));
+    for (int i = 0; i < kNumStreams; i++) {
+      EXPECT_EQ(apm_->kNoError, errors[i]);
+      EXPECT_EQ(0, memcmp(single_frames[i]._payloadData,
+                          batch_frames[i]._payloadData,
+                          sizeof(WebRtc_Word16) *
+                          frame_->_payloadDataLengthInSamples * 2));
+      EXPECT_EQ(single[i]->voice_detection()->stream_has_voice(),
+                batch[i]->voice_detection()->stream_has_voice());
+    }
+  }
+
+  // A bad frame only fails its own stream, whether or not the errors are
+  // returned.
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < kNumStreams; i++) {
+      single_frames[i] = *frame_;
+      batch_frames[i] = *frame_;
+      if (i == 1 || i == kNumStreams - 2) {
+        batch_frames[i]._frequencyInHz = 16000;
+      } else {
+        EXPECT_EQ(apm_->kNoError, single[i]->ProcessStream(&single_frames[i]));
+      }
+    }
+    int errors[kNumStreams];
+    EXPECT_EQ(apm_->kBadSampleRateError, AudioProcessing::ProcessStreams(
+        batch, batch_frame_ptrs, kNumStreams, pass == 0 ? errors : NULL));
+    for (int i = 0; i < kNumStreams; i++) {
+      const bool bad = (i == 1 || i == kNumStreams - 2);
+      if (pass == 0) {
+        EXPECT_EQ(bad ? apm_->kBadSampleRateError : apm_->kNoError, errors[i]);
+      }
+      if (!bad) {
+        EXPECT_EQ(0, memcmp(single_frames[i]._payloadData,
+                            batch_frames[i]._payloadData,
+                            sizeof(WebRtc_Word16) *
+                            frame_->_payloadDataLengthInSamples * 2));
+      }
+    }
+  }
+
+  for (int i = 0; i < kNumStreams; i++) {
+    AudioProcessing::Destroy(single[i]);
+    AudioProcessing::Destroy(batch[i]);
+  }
+}
+
+struct RenderThreadData {
+  AudioProcessing* apm;
+  AudioFrame* frame;
+  EventWrapper* done;
+  int frames_left;
+  int errors;
+};
+
+bool RenderThreadProc(void* thread_object) {
+  RenderThreadData* data = static_cast<RenderThreadData*>(thread_object);
+  if (data->apm->AnalyzeReverseStream(data->frame) != data->apm->kNoError) {
+    data->errors++;
+  }
+  data->frames_left--;
+  if (data->frames_left == 0) {
+    data->done->Set();
+    return false;
+  }
+  return true;
+}
+
+TEST_F(ApmTest, ReverseStreamQueue) {
+  EXPECT_EQ(apm_->kNoError, apm_->gain_control()->set_mode(
+      GainControl::kAdaptiveDigital));
+  EXPECT_EQ(apm_->kNoError, apm_->gain_control()->Enable(true));
+
+  // More reverse frames than the queue holds, without capture processing.
+  for (int i = 0; i < 20; i++) {
+    EXPECT_EQ(apm_->kNoError, apm_->AnalyzeReverseStream(revframe_));
+  }
+  EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+
+  // Queued frames are dropped when the format changes.
+  EXPECT_EQ(apm_->kNoError, apm_->AnalyzeReverseStream(revframe_));
+  EXPECT_EQ(apm_->kNoError, apm_->set_sample_rate_hz(16000));
+  frame_->_payloadDataLengthInSamples = 160;
+  frame_->_frequencyInHz = 16000;
+  revframe_->_payloadDataLengthInSamples = 160;
+  revframe_->_frequencyInHz = 16000;
+  EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+  EXPECT_EQ(apm_->kNoError, apm_->AnalyzeReverseStream(revframe_));
+
+  // Render and capture from separate threads.
+  const int kNumFrames = 500;
+  EventWrapper* done = EventWrapper::Create();
+  RenderThreadData data = {apm_, revframe_, done, kNumFrames, 0};
+  webrtc::ThreadWrapper* thread = webrtc::ThreadWrapper::CreateThread(
+      RenderThreadProc, &data, webrtc::kNormalPriority, "render");
+  ASSERT_TRUE(thread != NULL);
+  unsigned int thread_id = 0;
+  ASSERT_TRUE(thread->Start(thread_id));
+  for (int i = 0; i < kNumFrames; i++) {
+    EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+  }
+  EXPECT_EQ(webrtc::kEventSignaled, done->Wait(10000));
+  EXPECT_TRUE(thread->Stop());
+  delete thread;
+  delete done;
+  EXPECT_EQ(0, data.errors);
+  EXPECT_EQ(0, data.frames_left);
+}
+
+TEST_F(ApmTest, DebugRecording) {
+  const char filename[] = "apm_debug_recording.dat";
+  EXPECT_EQ(apm_->kNullPointerError, apm_->StartDebugRecording(NULL));
+  EXPECT_EQ(apm_->kBadParameterError,
+            apm_->StartDebugRecording(filename, -1));
+  // Stopping without a recording is fine.
+  EXPECT_EQ(apm_->kNoError, apm_->StopDebugRecording());
+
+  EXPECT_EQ(apm_->kNoError, apm_->StartDebugRecording(filename, 1000));
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(apm_->kNoError, apm_->AnalyzeReverseStream(revframe_));
+    EXPECT_EQ(apm_->kNoError, apm_->ProcessStream(frame_));
+  }
+  EXPECT_EQ(0, apm_->debug_recording_dropped_frames());
+  EXPECT_EQ(apm_->kNoError, apm_->StopDebugRecording());
+  EXPECT_EQ(0, apm_->debug_recording_dropped_frames());
+
+  // The frames past the limit are not written.
+  FILE* file = fopen(filename, "rb");
+  ASSERT_TRUE(file != NULL);
+  fseek(file, 0, SEEK_END);
+  EXPECT_LE(ftell(file), 1000);
+  EXPECT_GT(ftell(file), 0);
+  fclose(file);
+  remove(filename);
+}
+
 TEST_F(ApmTest, SampleRates) {
   // Testing invalid sample rates
   EXPECT_EQ(apm_->kBadParameterError, apm_->set_sample_rate_hz(10000));
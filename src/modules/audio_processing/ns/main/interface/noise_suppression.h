@@ -117,6 +117,17 @@ int WebRtcNs_Process(NsHandle *NS_inst,
                      short *outframe,
                      short *outframe_H);
 
+/*
+ * Same as WebRtcNs_Process(), but with float samples in the range of 16-bit
+ * integers. The output is saturated to that range. This avoids converting to
+ * and from float when the caller already has float data.
+ */
+int WebRtcNs_ProcessFloat(NsHandle *NS_inst,
+                          const float *spframe,
+                          const float *spframe_H,
+                          float *outframe,
+                          float *outframe_H);
+
 #ifdef __cplusplus
 }
 #endif
@@ -64,6 +64,45 @@ int WebRtcNs_set_policy(NsHandle *NS_inst, int mode)
 
 
 int WebRtcNs_Process(NsHandle *NS_inst, short *spframe, short *spframe_H, short *outframe, short *outframe_H)
+{
+    NSinst_t *inst = (NSinst_t*) NS_inst;
+    float in[BLOCKL_MAX], inH[BLOCKL_MAX], out[BLOCKL_MAX], outH[BLOCKL_MAX];
+    int i, ret;
+
+    if (inst->initFlag != 1)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < inst->blockLen10ms; i++)
+    {
+        in[i] = (float)spframe[i];
+        if (spframe_H != NULL)
+        {
+            inH[i] = (float)spframe_H[i];
+        }
+    }
+
+    ret = WebRtcNs_ProcessCore(inst, in, spframe_H != NULL ? inH : NULL,
+                               out, outframe_H != NULL ? outH : NULL);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    // The output is already saturated.
+    for (i = 0; i < inst->blockLen10ms; i++)
+    {
+        outframe[i] = (short)out[i];
+        if (inst->fs == 32000)
+        {
+            outframe_H[i] = (short)outH[i];
+        }
+    }
+    return 0;
+}
+
+int WebRtcNs_ProcessFloat(NsHandle *NS_inst, const float *spframe, const float *spframe_H, float *outframe, float *outframe_H)
 {
     return WebRtcNs_ProcessCore((NSinst_t*) NS_inst, spframe, spframe_H, outframe, outframe_H);
 }
@@ -34,6 +34,21 @@
         'ns_core.c',
         'ns_core.h',
       ],
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'ns_core_sse2.c',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'ns_core_neon.c',
+          ],
+        }],
+      ],
     },
     {
       'target_name': 'ns_fix',
@@ -57,6 +72,20 @@
         'nsx_core.h',
       ],
     },
+    {
+      'target_name': 'ns_simd_test',
+      'type': 'executable',
+      'dependencies': [
+        'ns',
+        '../../../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+      ],
+      'include_dirs': [
+        '../../../../../system_wrappers/interface',
+      ],
+      'sources': [
+        '../test/ns_simd_test.cc',
+      ],
+    },
   ],
 }
 
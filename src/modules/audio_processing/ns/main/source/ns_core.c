@@ -17,6 +17,129 @@
 #include "windows_private.h"
 #include "fft4g.h"
 #include "signal_processing_library.h"
+#include "system_wrappers/interface/cpu_features_wrapper.h"
+
+// Splits the rdft output into real and imaginary parts and computes the
+// magnitude spectrum of bins 1 to magnLen - 2.
+static void Magnitude(const float *winData, int magnLen, float *real,
+                      float *imag, float *energy, float *magn)
+{
+    int i;
+    for (i = 1; i < magnLen - 1; i++)
+    {
+        real[i] = winData[2 * i];
+        imag[i] = winData[2 * i + 1];
+        energy[i] = real[i] * real[i];
+        energy[i] += imag[i] * imag[i];
+        magn[i] = ((float)sqrt(energy[i])) + 1.0f;
+    }
+}
+
+// Computes the post and the DD estimate of the prior SNR from the quantile
+// noise estimate.
+static void PriorSnr(NSinst_t *inst, const float *magn, const float *noise,
+                     float *snrLocPost, float *snrLocPrior,
+                     float *previousEstimateStsa)
+{
+    int i;
+    for (i = 0; i < inst->magnLen; i++)
+    {
+        // post snr
+        snrLocPost[i] = (float)0.0;
+        if (magn[i] > noise[i])
+        {
+            snrLocPost[i] = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
+        }
+        // previous post snr
+        // previous estimate: based on previous frame with gain filter
+        previousEstimateStsa[i] = inst->magnPrev[i] / (inst->noisePrev[i] + (float)0.0001)
+                * (inst->smooth[i]);
+        // DD estimate is sum of two terms: current estimate and previous estimate
+        // directed decision update of snrPrior
+        snrLocPrior[i] = DD_PR_SNR * previousEstimateStsa[i] + ((float)1.0 - DD_PR_SNR)
+                * snrLocPost[i];
+        // post and prior snr needed for step 2
+    } // end of loop over freqs
+}
+
+// Computes the Wiener filter from the DD update of the prior SNR based on the
+// updated noise estimate.
+static void WienerFilter(NSinst_t *inst, const float *magn, const float *noise,
+                         const float *previousEstimateStsa, float *theFilter)
+{
+    int i;
+    float currentEstimateStsa, snrPrior, tmpFloat1, tmpFloat2;
+    for (i = 0; i < inst->magnLen; i++)
+    {
+        // post and prior snr
+        currentEstimateStsa = (float)0.0;
+        if (magn[i] > noise[i])
+        {
+            currentEstimateStsa = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
+        }
+        // DD estimate is sume of two terms: current estimate and previous estimate
+        // directed decision update of snrPrior
+        snrPrior = DD_PR_SNR * previousEstimateStsa[i] + ((float)1.0 - DD_PR_SNR)
+                * currentEstimateStsa;
+        // gain filter
+        tmpFloat1 = inst->overdrive + snrPrior;
+        tmpFloat2 = (float)snrPrior / tmpFloat1;
+        theFilter[i] = (float)tmpFloat2;
+    } // end of loop over freqs
+}
+
+// Floors the filter, weights it with the startup filter theFilterTmp and
+// applies the smoothed result to the spectrum. Both filters are modified.
+static void ApplyFilter(NSinst_t *inst, float *theFilter, float *theFilterTmp,
+                        float *real, float *imag)
+{
+    int i;
+    for (i = 0; i < inst->magnLen; i++)
+    {
+        // flooring bottom
+        if (theFilter[i] < inst->denoiseBound)
+        {
+            theFilter[i] = inst->denoiseBound;
+        }
+        // flooring top
+        if (theFilter[i] > (float)1.0)
+        {
+            theFilter[i] = 1.0;
+        }
+        if (inst->blockInd < END_STARTUP_SHORT)
+        {
+            // flooring bottom
+            if (theFilterTmp[i] < inst->denoiseBound)
+            {
+                theFilterTmp[i] = inst->denoiseBound;
+            }
+            // flooring top
+            if (theFilterTmp[i] > (float)1.0)
+            {
+                theFilterTmp[i] = 1.0;
+            }
+            // Weight the two suppression filters
+            theFilter[i] *= (inst->blockInd);
+            theFilterTmp[i] *= (END_STARTUP_SHORT - inst->blockInd);
+            theFilter[i] += theFilterTmp[i];
+            theFilter[i] /= (END_STARTUP_SHORT);
+        }
+        // smoothing
+#ifdef PROCESS_FLOW_0
+        inst->smooth[i] *= SMOOTH; // value set to 0.7 in define.h file
+        inst->smooth[i] += ((float)1.0 - SMOOTH) * theFilter[i];
+#else
+        inst->smooth[i] = theFilter[i];
+#endif
+        real[i] *= inst->smooth[i];
+        imag[i] *= inst->smooth[i];
+    }
+}
+
+WebRtcNs_Magnitude_t WebRtcNs_Magnitude;
+WebRtcNs_PriorSnr_t WebRtcNs_PriorSnr;
+WebRtcNs_WienerFilter_t WebRtcNs_WienerFilter;
+WebRtcNs_ApplyFilter_t WebRtcNs_ApplyFilter;
 
 // Set Feature Extraction Parameters
 void WebRtcNs_set_feature_extraction_parameters(NSinst_t *inst)
@@ -119,6 +242,25 @@ int WebRtcNs_InitCore(NSinst_t *inst, WebRtc_UWord32 fs)
     }
     inst->magnLen = inst->anaLen / 2 + 1; // Number of frequency bins
 
+    // Assembly optimization
+    WebRtcNs_Magnitude = Magnitude;
+    WebRtcNs_PriorSnr = PriorSnr;
+    WebRtcNs_WienerFilter = WienerFilter;
+    WebRtcNs_ApplyFilter = ApplyFilter;
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+#if defined(__SSE2__)
+        WebRtcNs_InitCore_SSE2();
+#endif
+    }
+    if (WebRtc_GetCPUInfo(kNEON))
+    {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+        WebRtcNs_InitCore_NEON();
+#endif
+    }
+    rdft_init();
+
     // Initialize fft work arrays.
     inst->ip[0] = 0; // Setting this triggers initialization.
     memset(inst->dataBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
@@ -812,10 +954,10 @@ void WebRtcNs_SpeechNoiseProb(NSinst_t *inst, float *probSpeechFinal, float *snr
 }
 
 int WebRtcNs_ProcessCore(NSinst_t *inst,
-                         short *speechFrame,
-                         short *speechFrameHB,
-                         short *outFrame,
-                         short *outFrameHB)
+                         const float *speechFrame,
+                         const float *speechFrameHB,
+                         float *outFrame,
+                         float *outFrameHB)
 {
     // main routine for noise reduction
 
@@ -826,10 +968,9 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
 
     float   energy1, energy2, gain, factor, factor1, factor2;
     float   signalEnergy, sumMagn;
-    float   snrPrior, currentEstimateStsa;
     float   tmpFloat1, tmpFloat2, tmpFloat3, probSpeech, probNonSpeech;
     float   gammaNoiseTmp, gammaNoiseOld;
-    float   noiseUpdateTmp, fTmp, dTmp;
+    float   noiseUpdateTmp, dTmp;
     float   fin[BLOCKL_MAX], fout[BLOCKL_MAX];
     float   winData[ANAL_BLOCKL_MAX];
     float   magn[HALF_ANAL_BLOCKL], noise[HALF_ANAL_BLOCKL];
@@ -837,6 +978,7 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
     float   snrLocPost[HALF_ANAL_BLOCKL], snrLocPrior[HALF_ANAL_BLOCKL];
     float   probSpeechFinal[HALF_ANAL_BLOCKL], previousEstimateStsa[HALF_ANAL_BLOCKL];
     float   real[ANAL_BLOCKL_MAX], imag[HALF_ANAL_BLOCKL];
+    float   energy[HALF_ANAL_BLOCKL];
     // Variables during startup
     float   sum_log_i = 0.0;
     float   sum_log_i_square = 0.0;
@@ -879,7 +1021,7 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
     // convert to float
     for (i = 0; i < inst->blockLen10ms; i++)
     {
-        fin[i] = (float)speechFrame[i];
+        fin[i] = speechFrame[i];
     }
     // update analysis buffer for L band
     memcpy(inst->dataBuf, inst->dataBuf + inst->blockLen10ms,
@@ -892,7 +1034,7 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
         // convert to float
         for (i = 0; i < inst->blockLen10ms; i++)
         {
-            fin[i] = (float)speechFrameHB[i];
+            fin[i] = speechFrameHB[i];
         }
         // update analysis buffer for H band
         memcpy(inst->dataBufHB, inst->dataBufHB + inst->blockLen10ms,
@@ -954,7 +1096,7 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
                 {
                     dTmp = WEBRTC_SPL_WORD16_MAX;
                 }
-                outFrame[i] = (short)dTmp;
+                outFrame[i] = dTmp;
             }
 
             // for time-domain gain of HB
@@ -971,7 +1113,7 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
                     {
                         dTmp = WEBRTC_SPL_WORD16_MAX;
                     }
-                    outFrameHB[i] = (short)dTmp;
+                    outFrameHB[i] = dTmp;
                 }
             } // end of H band gain computation
             //
@@ -1003,15 +1145,11 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
             sum_log_magn = tmpFloat1;
             sum_log_i_log_magn = tmpFloat2 * tmpFloat1;
         }
+        // magnitude spectrum
+        WebRtcNs_Magnitude(winData, inst->magnLen, real, imag, energy, magn);
         for (i = 1; i < inst->magnLen - 1; i++)
         {
-            real[i] = winData[2 * i];
-            imag[i] = winData[2 * i + 1];
-            // magnitude spectrum
-            fTmp = real[i] * real[i];
-            fTmp += imag[i] * imag[i];
-            signalEnergy += fTmp;
-            magn[i] = ((float)sqrt(fTmp)) + 1.0f;
+            signalEnergy += energy[i];
             sumMagn += magn[i];
             if (inst->blockInd < END_STARTUP_SHORT)
             {
@@ -1126,24 +1264,8 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
         //
 
         // compute DD estimate of prior SNR: needed for new method
-        for (i = 0; i < inst->magnLen; i++)
-        {
-            // post snr
-            snrLocPost[i] = (float)0.0;
-            if (magn[i] > noise[i])
-            {
-                snrLocPost[i] = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
-            }
-            // previous post snr
-            // previous estimate: based on previous frame with gain filter
-            previousEstimateStsa[i] = inst->magnPrev[i] / (inst->noisePrev[i] + (float)0.0001)
-                    * (inst->smooth[i]);
-            // DD estimate is sum of two terms: current estimate and previous estimate
-            // directed decision update of snrPrior
-            snrLocPrior[i] = DD_PR_SNR * previousEstimateStsa[i] + ((float)1.0 - DD_PR_SNR)
-                    * snrLocPost[i];
-            // post and prior snr needed for step 2
-        } // end of loop over freqs
+        WebRtcNs_PriorSnr(inst, magn, noise, snrLocPost, snrLocPrior,
+                          previousEstimateStsa);
 #ifdef PROCESS_FLOW_1
         for (i = 0; i < inst->magnLen; i++)
         {
@@ -1242,67 +1364,12 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
         //
         // STEP 3: compute dd update of prior snr and post snr based on new noise estimate
         //
-        for (i = 0; i < inst->magnLen; i++)
-        {
-            // post and prior snr
-            currentEstimateStsa = (float)0.0;
-            if (magn[i] > noise[i])
-            {
-                currentEstimateStsa = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
-            }
-            // DD estimate is sume of two terms: current estimate and previous estimate
-            // directed decision update of snrPrior
-            snrPrior = DD_PR_SNR * previousEstimateStsa[i] + ((float)1.0 - DD_PR_SNR)
-                    * currentEstimateStsa;
-            // gain filter
-            tmpFloat1 = inst->overdrive + snrPrior;
-            tmpFloat2 = (float)snrPrior / tmpFloat1;
-            theFilter[i] = (float)tmpFloat2;
-        } // end of loop over freqs
+        WebRtcNs_WienerFilter(inst, magn, noise, previousEstimateStsa, theFilter);
         // done with step3
 #endif
 #endif
 
-        for (i = 0; i < inst->magnLen; i++)
-        {
-            // flooring bottom
-            if (theFilter[i] < inst->denoiseBound)
-            {
-                theFilter[i] = inst->denoiseBound;
-            }
-            // flooring top
-            if (theFilter[i] > (float)1.0)
-            {
-                theFilter[i] = 1.0;
-            }
-            if (inst->blockInd < END_STARTUP_SHORT)
-            {
-                // flooring bottom
-                if (theFilterTmp[i] < inst->denoiseBound)
-                {
-                    theFilterTmp[i] = inst->denoiseBound;
-                }
-                // flooring top
-                if (theFilterTmp[i] > (float)1.0)
-                {
-                    theFilterTmp[i] = 1.0;
-                }
-                // Weight the two suppression filters
-                theFilter[i] *= (inst->blockInd);
-                theFilterTmp[i] *= (END_STARTUP_SHORT - inst->blockInd);
-                theFilter[i] += theFilterTmp[i];
-                theFilter[i] /= (END_STARTUP_SHORT);
-            }
-            // smoothing
-#ifdef PROCESS_FLOW_0
-            inst->smooth[i] *= SMOOTH; // value set to 0.7 in define.h file
-            inst->smooth[i] += ((float)1.0 - SMOOTH) * theFilter[i];
-#else
-            inst->smooth[i] = theFilter[i];
-#endif
-            real[i] *= inst->smooth[i];
-            imag[i] *= inst->smooth[i];
-        }
+        WebRtcNs_ApplyFilter(inst, theFilter, theFilterTmp, real, imag);
         // keep track of noise and magn spectrum for next frame
         for (i = 0; i < inst->magnLen; i++)
         {
@@ -1429,7 +1496,7 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
         {
             dTmp = WEBRTC_SPL_WORD16_MAX;
         }
-        outFrame[i] = (short)dTmp;
+        outFrame[i] = dTmp;
     }
 
     // for time-domain gain of HB
@@ -1491,7 +1558,7 @@ int WebRtcNs_ProcessCore(NSinst_t *inst,
             {
                 dTmp = WEBRTC_SPL_WORD16_MAX;
             }
-            outFrameHB[i] = (short)dTmp;
+            outFrameHB[i] = dTmp;
         }
     } // end of H band gain computation
     //
@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_AUDIO_PROCESSING_NS_MAIN_SOURCE_NS_CORE_H_
 
 #include "defines.h"
+#include "typedefs.h"
 
 typedef struct NSParaExtract_t_ {
 
@@ -149,7 +150,8 @@ int WebRtcNs_set_policy_core(NSinst_t *inst, int mode);
 /****************************************************************************
  * WebRtcNs_ProcessCore
  *
- * Do noise suppression.
+ * Do noise suppression. The samples have the range of 16-bit integers and the
+ * output is saturated to that range.
  *
  * Input:
  *      - inst          : Instance that should be initialized
@@ -167,10 +169,37 @@ int WebRtcNs_set_policy_core(NSinst_t *inst, int mode);
 
 
 int WebRtcNs_ProcessCore(NSinst_t *inst,
-                         short *inFrameLow,
-                         short *inFrameHigh,
-                         short *outFrameLow,
-                         short *outFrameHigh);
+                         const float *inFrameLow,
+                         const float *inFrameHigh,
+                         float *outFrameLow,
+                         float *outFrameHigh);
+
+/****************************************************************************
+ * Speed-critical spectral loops of WebRtcNs_ProcessCore. WebRtcNs_InitCore
+ * selects the C, SSE2 or NEON versions depending on the CPU. All versions
+ * give bit exact results.
+ */
+typedef void (*WebRtcNs_Magnitude_t)(const float *winData, int magnLen,
+                                     float *real, float *imag, float *energy,
+                                     float *magn);
+extern WebRtcNs_Magnitude_t WebRtcNs_Magnitude;
+typedef void (*WebRtcNs_PriorSnr_t)(NSinst_t *inst, const float *magn,
+                                    const float *noise, float *snrLocPost,
+                                    float *snrLocPrior,
+                                    float *previousEstimateStsa);
+extern WebRtcNs_PriorSnr_t WebRtcNs_PriorSnr;
+typedef void (*WebRtcNs_WienerFilter_t)(NSinst_t *inst, const float *magn,
+                                        const float *noise,
+                                        const float *previousEstimateStsa,
+                                        float *theFilter);
+extern WebRtcNs_WienerFilter_t WebRtcNs_WienerFilter;
+typedef void (*WebRtcNs_ApplyFilter_t)(NSinst_t *inst, float *theFilter,
+                                       float *theFilterTmp, float *real,
+                                       float *imag);
+extern WebRtcNs_ApplyFilter_t WebRtcNs_ApplyFilter;
+
+void WebRtcNs_InitCore_SSE2(void);
+void WebRtcNs_InitCore_NEON(void);
 
 
 #ifdef __cplusplus
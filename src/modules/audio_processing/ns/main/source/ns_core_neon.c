@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core noise suppression algorithm, NEON version of speed-critical
+ * functions. NEON has no exact division or square root, so only the parts
+ * which can be kept bit exact with ns_core.c are vectorized.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+#include <math.h>
+
+#include "defines.h"
+#include "ns_core.h"
+
+static void MagnitudeNEON(const float *winData, int magnLen, float *real,
+                          float *imag, float *energy, float *magn) {
+  int i, j;
+
+  for (i = 1; i + 3 < magnLen - 1; i += 4) {
+    const float32x4x2_t spectrum = vld2q_f32(&winData[2 * i]);
+    const float32x4_t power =
+        vaddq_f32(vmulq_f32(spectrum.val[0], spectrum.val[0]),
+                  vmulq_f32(spectrum.val[1], spectrum.val[1]));
+    vst1q_f32(&real[i], spectrum.val[0]);
+    vst1q_f32(&imag[i], spectrum.val[1]);
+    vst1q_f32(&energy[i], power);
+    for (j = i; j < i + 4; j++) {
+      magn[j] = sqrtf(energy[j]) + 1.0f;
+    }
+  }
+  for (; i < magnLen - 1; i++) {
+    real[i] = winData[2 * i];
+    imag[i] = winData[2 * i + 1];
+    energy[i] = real[i] * real[i];
+    energy[i] += imag[i] * imag[i];
+    magn[i] = sqrtf(energy[i]) + 1.0f;
+  }
+}
+
+static void ApplyFilterNEON(NSinst_t *inst, float *theFilter,
+                            float *theFilterTmp, float *real, float *imag) {
+  const float32x4_t bound = vdupq_n_f32(inst->denoiseBound);
+  const float32x4_t one = vdupq_n_f32((float)1.0);
+  // The startup weighting divides and is left to the scalar code.
+  const int startup = inst->blockInd < END_STARTUP_SHORT;
+  int i = 0;
+
+  if (!startup) {
+    for (; i + 3 < inst->magnLen; i += 4) {
+      // Same as "if (x < bound) x = bound; if (x > 1) x = 1;".
+      const float32x4_t filter =
+          vminq_f32(one, vmaxq_f32(bound, vld1q_f32(&theFilter[i])));
+#ifdef PROCESS_FLOW_0
+      const float32x4_t smooth = vaddq_f32(
+          vmulq_n_f32(vld1q_f32(&inst->smooth[i]), SMOOTH),
+          vmulq_n_f32(filter, (float)1.0 - SMOOTH));
+#else
+      const float32x4_t smooth = filter;
+#endif
+      vst1q_f32(&inst->smooth[i], smooth);
+      vst1q_f32(&real[i], vmulq_f32(vld1q_f32(&real[i]), smooth));
+      vst1q_f32(&imag[i], vmulq_f32(vld1q_f32(&imag[i]), smooth));
+    }
+  }
+  for (; i < inst->magnLen; i++) {
+    if (theFilter[i] < inst->denoiseBound) {
+      theFilter[i] = inst->denoiseBound;
+    }
+    if (theFilter[i] > (float)1.0) {
+      theFilter[i] = 1.0;
+    }
+    if (startup) {
+      if (theFilterTmp[i] < inst->denoiseBound) {
+        theFilterTmp[i] = inst->denoiseBound;
+      }
+      if (theFilterTmp[i] > (float)1.0) {
+        theFilterTmp[i] = 1.0;
+      }
+      theFilter[i] *= (inst->blockInd);
+      theFilterTmp[i] *= (END_STARTUP_SHORT - inst->blockInd);
+      theFilter[i] += theFilterTmp[i];
+      theFilter[i] /= (END_STARTUP_SHORT);
+    }
+#ifdef PROCESS_FLOW_0
+    inst->smooth[i] *= SMOOTH;
+    inst->smooth[i] += ((float)1.0 - SMOOTH) * theFilter[i];
+#else
+    inst->smooth[i] = theFilter[i];
+#endif
+    real[i] *= inst->smooth[i];
+    imag[i] *= inst->smooth[i];
+  }
+}
+
+void WebRtcNs_InitCore_NEON(void) {
+  WebRtcNs_Magnitude = MagnitudeNEON;
+  WebRtcNs_ApplyFilter = ApplyFilterNEON;
+}
+
+#endif   // WEBRTC_ARCH_ARM_NEON
@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core noise suppression algorithm, SSE2 version of speed-critical
+ * functions. The operations are done in the same order as in ns_core.c to
+ * keep the results bit exact.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#include <math.h>
+
+#include "defines.h"
+#include "ns_core.h"
+
+static void MagnitudeSSE2(const float *winData, int magnLen, float *real,
+                          float *imag, float *energy, float *magn) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  int i;
+
+  // Vectorized code (four at once).
+  for (i = 1; i + 3 < magnLen - 1; i += 4) {
+    const __m128 a = _mm_loadu_ps(&winData[2 * i]);
+    const __m128 b = _mm_loadu_ps(&winData[2 * i + 4]);
+    const __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 power = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+    _mm_storeu_ps(&real[i], re);
+    _mm_storeu_ps(&imag[i], im);
+    _mm_storeu_ps(&energy[i], power);
+    // The square root of a float is exact whether done in single or double
+    // precision.
+    _mm_storeu_ps(&magn[i], _mm_add_ps(_mm_sqrt_ps(power), one));
+  }
+  // Scalar code for the remaining items.
+  for (; i < magnLen - 1; i++) {
+    real[i] = winData[2 * i];
+    imag[i] = winData[2 * i + 1];
+    energy[i] = real[i] * real[i];
+    energy[i] += imag[i] * imag[i];
+    magn[i] = ((float)sqrt(energy[i])) + 1.0f;
+  }
+}
+
+// Returns magn / (noise + 0.0001) - 1 where magn > noise and 0 elsewhere.
+static __inline __m128 PostSnr(__m128 magn, __m128 noise) {
+  const __m128 snr = _mm_sub_ps(
+      _mm_div_ps(magn, _mm_add_ps(noise, _mm_set1_ps((float)0.0001))),
+      _mm_set1_ps((float)1.0));
+  return _mm_and_ps(_mm_cmpgt_ps(magn, noise), snr);
+}
+
+static void PriorSnrSSE2(NSinst_t *inst, const float *magn,
+                         const float *noise, float *snrLocPost,
+                         float *snrLocPrior, float *previousEstimateStsa) {
+  const __m128 dd = _mm_set1_ps(DD_PR_SNR);
+  const __m128 one_minus_dd = _mm_set1_ps((float)1.0 - DD_PR_SNR);
+  const __m128 eps = _mm_set1_ps((float)0.0001);
+  int i;
+
+  for (i = 0; i + 3 < inst->magnLen; i += 4) {
+    const __m128 post = PostSnr(_mm_loadu_ps(&magn[i]),
+                                _mm_loadu_ps(&noise[i]));
+    const __m128 previous = _mm_mul_ps(
+        _mm_div_ps(_mm_loadu_ps(&inst->magnPrev[i]),
+                   _mm_add_ps(_mm_loadu_ps(&inst->noisePrev[i]), eps)),
+        _mm_loadu_ps(&inst->smooth[i]));
+    _mm_storeu_ps(&snrLocPost[i], post);
+    _mm_storeu_ps(&previousEstimateStsa[i], previous);
+    _mm_storeu_ps(&snrLocPrior[i], _mm_add_ps(_mm_mul_ps(dd, previous),
+                                              _mm_mul_ps(one_minus_dd, post)));
+  }
+  for (; i < inst->magnLen; i++) {
+    snrLocPost[i] = (float)0.0;
+    if (magn[i] > noise[i]) {
+      snrLocPost[i] = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
+    }
+    previousEstimateStsa[i] = inst->magnPrev[i] /
+        (inst->noisePrev[i] + (float)0.0001) * (inst->smooth[i]);
+    snrLocPrior[i] = DD_PR_SNR * previousEstimateStsa[i] +
+        ((float)1.0 - DD_PR_SNR) * snrLocPost[i];
+  }
+}
+
+static void WienerFilterSSE2(NSinst_t *inst, const float *magn,
+                             const float *noise,
+                             const float *previousEstimateStsa,
+                             float *theFilter) {
+  const __m128 dd = _mm_set1_ps(DD_PR_SNR);
+  const __m128 one_minus_dd = _mm_set1_ps((float)1.0 - DD_PR_SNR);
+  const __m128 overdrive = _mm_set1_ps(inst->overdrive);
+  int i;
+
+  for (i = 0; i + 3 < inst->magnLen; i += 4) {
+    const __m128 current = PostSnr(_mm_loadu_ps(&magn[i]),
+                                   _mm_loadu_ps(&noise[i]));
+    const __m128 snr_prior = _mm_add_ps(
+        _mm_mul_ps(dd, _mm_loadu_ps(&previousEstimateStsa[i])),
+        _mm_mul_ps(one_minus_dd, current));
+    _mm_storeu_ps(&theFilter[i],
+                  _mm_div_ps(snr_prior, _mm_add_ps(overdrive, snr_prior)));
+  }
+  for (; i < inst->magnLen; i++) {
+    float currentEstimateStsa = (float)0.0;
+    float snrPrior;
+    if (magn[i] > noise[i]) {
+      currentEstimateStsa = magn[i] / (noise[i] + (float)0.0001) - (float)1.0;
+    }
+    snrPrior = DD_PR_SNR * previousEstimateStsa[i] +
+        ((float)1.0 - DD_PR_SNR) * currentEstimateStsa;
+    theFilter[i] = snrPrior / (inst->overdrive + snrPrior);
+  }
+}
+
+static void ApplyFilterSSE2(NSinst_t *inst, float *theFilter,
+                            float *theFilterTmp, float *real, float *imag) {
+  const __m128 bound = _mm_set1_ps(inst->denoiseBound);
+  const __m128 one = _mm_set1_ps((float)1.0);
+  const int startup = inst->blockInd < END_STARTUP_SHORT;
+  const __m128 weight = _mm_set1_ps((float)inst->blockInd);
+  const __m128 weight_tmp =
+      _mm_set1_ps((float)(END_STARTUP_SHORT - inst->blockInd));
+  const __m128 end_startup = _mm_set1_ps((float)END_STARTUP_SHORT);
+#ifdef PROCESS_FLOW_0
+  const __m128 smooth_factor = _mm_set1_ps(SMOOTH);
+  const __m128 one_minus_smooth = _mm_set1_ps((float)1.0 - SMOOTH);
+#endif
+  int i;
+
+  for (i = 0; i + 3 < inst->magnLen; i += 4) {
+    __m128 smooth;
+    // Same as "if (x < bound) x = bound; if (x > 1) x = 1;".
+    __m128 filter = _mm_min_ps(one, _mm_max_ps(bound,
+                                               _mm_loadu_ps(&theFilter[i])));
+    if (startup) {
+      const __m128 filter_tmp = _mm_min_ps(
+          one, _mm_max_ps(bound, _mm_loadu_ps(&theFilterTmp[i])));
+      filter = _mm_div_ps(_mm_add_ps(_mm_mul_ps(filter, weight),
+                                     _mm_mul_ps(filter_tmp, weight_tmp)),
+                          end_startup);
+    }
+#ifdef PROCESS_FLOW_0
+    smooth = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&inst->smooth[i]),
+                                   smooth_factor),
+                        _mm_mul_ps(one_minus_smooth, filter));
+#else
+    smooth = filter;
+#endif
+    _mm_storeu_ps(&inst->smooth[i], smooth);
+    _mm_storeu_ps(&real[i], _mm_mul_ps(_mm_loadu_ps(&real[i]), smooth));
+    _mm_storeu_ps(&imag[i], _mm_mul_ps(_mm_loadu_ps(&imag[i]), smooth));
+  }
+  for (; i < inst->magnLen; i++) {
+    if (theFilter[i] < inst->denoiseBound) {
+      theFilter[i] = inst->denoiseBound;
+    }
+    if (theFilter[i] > (float)1.0) {
+      theFilter[i] = 1.0;
+    }
+    if (startup) {
+      if (theFilterTmp[i] < inst->denoiseBound) {
+        theFilterTmp[i] = inst->denoiseBound;
+      }
+      if (theFilterTmp[i] > (float)1.0) {
+        theFilterTmp[i] = 1.0;
+      }
+      theFilter[i] *= (inst->blockInd);
+      theFilterTmp[i] *= (END_STARTUP_SHORT - inst->blockInd);
+      theFilter[i] += theFilterTmp[i];
+      theFilter[i] /= (END_STARTUP_SHORT);
+    }
+#ifdef PROCESS_FLOW_0
+    inst->smooth[i] *= SMOOTH;
+    inst->smooth[i] += ((float)1.0 - SMOOTH) * theFilter[i];
+#else
+    inst->smooth[i] = theFilter[i];
+#endif
+    real[i] *= inst->smooth[i];
+    imag[i] *= inst->smooth[i];
+  }
+}
+
+void WebRtcNs_InitCore_SSE2(void) {
+  WebRtcNs_Magnitude = MagnitudeSSE2;
+  WebRtcNs_PriorSnr = PriorSnrSSE2;
+  WebRtcNs_WienerFilter = WienerFilterSSE2;
+  WebRtcNs_ApplyFilter = ApplyFilterSSE2;
+}
+
+#endif   // __SSE2__
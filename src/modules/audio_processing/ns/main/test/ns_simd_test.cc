@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Runs the floating point noise suppression over a file with and without
+// the SSE2/NEON code and checks that the outputs are bit exact. Also prints
+// the time spent in WebRtcNs_Process() for both.
+//
+// Usage: ns_simd_test [16 kHz mono pcm file]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "cpu_features_wrapper.h"
+#include "noise_suppression.h"
+#include "tick_util.h"
+
+namespace {
+const char kDefaultInput[] = "test/data/audio_processing/aec_near.pcm";
+
+// Processes |input|, which is at 16 kHz, at |sample_rate_hz| and stores the
+// result in |output|. Returns the processing time in microseconds, or -1 on
+// error.
+WebRtc_Word64 Run(const std::vector<short>& input, int sample_rate_hz,
+                  int mode, std::vector<short>* output) {
+  // 8 kHz uses every other sample. 32 kHz feeds consecutive 10 ms blocks as
+  // the low and high band.
+  const int frame_size = sample_rate_hz == 8000 ? 80 : 160;
+  const int step = sample_rate_hz == 8000 ? 2 : 1;
+  const int bands = sample_rate_hz == 32000 ? 2 : 1;
+  const int input_per_frame = frame_size * step * bands;
+  const int num_frames = static_cast<int>(input.size()) / input_per_frame;
+
+  NsHandle* ns = NULL;
+  if (WebRtcNs_Create(&ns) != 0) {
+    return -1;
+  }
+  if (WebRtcNs_Init(ns, sample_rate_hz) != 0 ||
+      WebRtcNs_set_policy(ns, mode) != 0) {
+    WebRtcNs_Free(ns);
+    return -1;
+  }
+
+  output->assign(num_frames * frame_size * bands, 0);
+  short low[160];
+  short high[160];
+  WebRtc_Word64 elapsed_us = 0;
+  for (int i = 0; i < num_frames; i++) {
+    const short* frame = &input[i * input_per_frame];
+    for (int j = 0; j < frame_size; j++) {
+      low[j] = frame[j * step];
+      high[j] = bands == 2 ? frame[frame_size + j] : 0;
+    }
+    short* out = &(*output)[i * frame_size * bands];
+    short* out_high = bands == 2 ? out + frame_size : NULL;
+
+    const webrtc::TickTime start = webrtc::TickTime::Now();
+    if (WebRtcNs_Process(ns, low, bands == 2 ? high : NULL, out,
+                         out_high) != 0) {
+      WebRtcNs_Free(ns);
+      return -1;
+    }
+    elapsed_us += (webrtc::TickTime::Now() - start).Microseconds();
+  }
+
+  WebRtcNs_Free(ns);
+  return elapsed_us;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const char* filename = argc > 1 ? argv[1] : kDefaultInput;
+  FILE* file = fopen(filename, "rb");
+  if (file == NULL) {
+    printf("Unable to open %s\n", filename);
+    return 1;
+  }
+  std::vector<short> input;
+  short buffer[1024];
+  size_t read = 0;
+  while ((read = fread(buffer, sizeof(short), 1024, file)) > 0) {
+    input.insert(input.end(), buffer, buffer + read);
+  }
+  fclose(file);
+
+  const int kSampleRates[] = {8000, 16000, 32000};
+  const int kModes[] = {0, 2};
+  const WebRtc_CPUInfo get_cpu_info = WebRtc_GetCPUInfo;
+  int failures = 0;
+  for (size_t i = 0; i < sizeof(kSampleRates) / sizeof(*kSampleRates); i++) {
+    for (size_t j = 0; j < sizeof(kModes) / sizeof(*kModes); j++) {
+      std::vector<short> reference;
+      std::vector<short> optimized;
+
+      // WebRtcNs_Init() selects the functions to use.
+      WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+      const WebRtc_Word64 c_us = Run(input, kSampleRates[i], kModes[j],
+                                     &reference);
+      WebRtc_GetCPUInfo = get_cpu_info;
+      const WebRtc_Word64 simd_us = Run(input, kSampleRates[i], kModes[j],
+                                        &optimized);
+      if (c_us < 0 || simd_us < 0) {
+        printf("Processing failed\n");
+        return 1;
+      }
+
+      int max_diff = 0;
+      for (size_t k = 0; k < reference.size(); k++) {
+        const int diff = abs(reference[k] - optimized[k]);
+        if (diff > max_diff) {
+          max_diff = diff;
+        }
+      }
+      if (max_diff != 0) {
+        failures++;
+      }
+      printf("%5d Hz mode %d: C %6.1f ms, SIMD %6.1f ms (%.2fx), "
+             "max diff %d\n", kSampleRates[i], kModes[j], c_us / 1000.0,
+             simd_us / 1000.0, simd_us > 0 ? (double)c_us / simd_us : 0.0,
+             max_diff);
+    }
+  }
+
+  if (failures > 0) {
+    printf("FAILED: %d runs were not bit exact\n", failures);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
@@ -18,6 +18,12 @@ LOCAL_GENERATED_SOURCES :=
 LOCAL_SRC_FILES := fft4g.c \
     ring_buffer.c
 
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
+    fft4g_neon.c.neon
+MY_ARCH_DEFS := '-DWEBRTC_ARCH_ARM_NEON'
+endif
+
 # Flags passed to both C and C++ files.
 MY_CFLAGS :=  
 MY_CFLAGS_C :=
@@ -28,11 +34,12 @@ MY_DEFS := '-DNO_TCMALLOC' \
     '-DWEBRTC_THREAD_RR' \
     '-DWEBRTC_ANDROID' \
     '-DANDROID' 
-LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS)
+LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS) $(MY_ARCH_DEFS)
 
 # Include paths placed before CFLAGS/CPPFLAGS
 LOCAL_C_INCLUDES := \
-    $(LOCAL_PATH)
+    $(LOCAL_PATH) \
+    $(LOCAL_PATH)/../../..
 
 # Flags passed to only C++ (and not C) files.
 LOCAL_CPPFLAGS := 
@@ -8,6 +8,8 @@
  *
  * Changes:
  * Trivial type modifications by the WebRTC authors.
+ * rdft calls the butterflies through function pointers so that they can be
+ * replaced by SIMD versions.
  */
 
 /*
@@ -286,6 +288,34 @@ Appendix :
     w[] and ip[] are compatible with all routines.
 */
 
+#include "fft4g.h"
+
+#include "system_wrappers/interface/cpu_features_wrapper.h"
+
+rdft_cft_sub_t rdft_cftfsub = cftfsub;
+rdft_cft_sub_t rdft_cftbsub = cftbsub;
+rdft_rft_sub_t rdft_rftfsub = rftfsub;
+rdft_rft_sub_t rdft_rftbsub = rftbsub;
+
+void rdft_init(void)
+{
+    rdft_cftfsub = cftfsub;
+    rdft_cftbsub = cftbsub;
+    rdft_rftfsub = rftfsub;
+    rdft_rftbsub = rftbsub;
+    if (WebRtc_GetCPUInfo(kSSE2)) {
+#if defined(__SSE2__)
+        rdft_init_sse2();
+#endif
+    }
+    if (WebRtc_GetCPUInfo(kNEON)) {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+        rdft_init_neon();
+#endif
+    }
+}
+
+
 void cdft(int n, int isgn, float *a, int *ip, float *w)
 {
     void makewt(int nw, int *ip, float *w);
@@ -316,10 +346,6 @@ void rdft(int n, int isgn, float *a, int *ip, float *w)
     void makewt(int nw, int *ip, float *w);
     void makect(int nc, int *ip, float *c);
     void bitrv2(int n, int *ip, float *a);
-    void cftfsub(int n, float *a, float *w);
-    void cftbsub(int n, float *a, float *w);
-    void rftfsub(int n, float *a, int nc, float *c);
-    void rftbsub(int n, float *a, int nc, float *c);
     int nw, nc;
     float xi;
 
@@ -336,8 +362,8 @@ void rdft(int n, int isgn, float *a, int *ip, float *w)
     if (isgn >= 0) {
         if (n > 4) {
             bitrv2(n, ip + 2, a);
-            cftfsub(n, a, w);
-            rftfsub(n, a, nc, w + nw);
+            rdft_cftfsub(n, a, w);
+            rdft_rftfsub(n, a, nc, w + nw);
         } else if (n == 4) {
             cftfsub(n, a, w);
         }
@@ -348,9 +374,9 @@ void rdft(int n, int isgn, float *a, int *ip, float *w)
         a[1] = 0.5f * (a[0] - a[1]);
         a[0] -= a[1];
         if (n > 4) {
-            rftbsub(n, a, nc, w + nw);
+            rdft_rftbsub(n, a, nc, w + nw);
             bitrv2(n, ip + 2, a);
-            cftbsub(n, a, w);
+            rdft_cftbsub(n, a, w);
         } else if (n == 4) {
             cftfsub(n, a, w);
         }
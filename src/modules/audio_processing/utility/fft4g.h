@@ -14,5 +14,27 @@
 void rdft(int, int, float *, int *, float *);
 void cdft(int, int, float *, int *, float *);
 
+// The butterflies used by rdft. These start out as the C versions and are
+// replaced by SSE2 or NEON versions by rdft_init(). All versions give bit
+// exact results.
+typedef void (*rdft_cft_sub_t)(int n, float *a, float *w);
+typedef void (*rdft_rft_sub_t)(int n, float *a, int nc, float *c);
+extern rdft_cft_sub_t rdft_cftfsub;
+extern rdft_cft_sub_t rdft_cftbsub;
+extern rdft_rft_sub_t rdft_rftfsub;
+extern rdft_rft_sub_t rdft_rftbsub;
+
+// C versions, also used by the SIMD versions for the cases they don't cover.
+void cft1st(int n, float *a, float *w);
+void cftfsub(int n, float *a, float *w);
+void cftbsub(int n, float *a, float *w);
+void rftfsub(int n, float *a, int nc, float *c);
+void rftbsub(int n, float *a, int nc, float *c);
+
+// Selects the butterflies from the features reported by WebRtc_GetCPUInfo.
+void rdft_init(void);
+void rdft_init_sse2(void);
+void rdft_init_neon(void);
+
 #endif
 
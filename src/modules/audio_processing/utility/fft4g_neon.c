@@ -0,0 +1,306 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * NEON versions of the rdft butterflies, see fft4g_sse2.c. Separate
+ * multiplies and adds are used instead of vmlaq_f32 to keep the results bit
+ * exact with the C versions.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+
+#include "fft4g.h"
+
+static __inline float32x4_t Swap(float32x4_t x) {
+  return vrev64q_f32(x);
+}
+
+static __inline float32x4_t Negate(float32x4_t x, uint32x4_t sign) {
+  return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(x), sign));
+}
+
+static __inline uint32x4_t SignRe(void) {
+  return vreinterpretq_u32_u64(vdupq_n_u64(0x80000000ULL));
+}
+
+static __inline uint32x4_t SignIm(void) {
+  return vreinterpretq_u32_u64(vdupq_n_u64(0x8000000000000000ULL));
+}
+
+// Duplicates (re, im) into both complex values.
+static __inline float32x4_t Pair(float re, float im) {
+  const float32x2_t pair = vset_lane_f32(im, vdup_n_f32(re), 1);
+  return vcombine_f32(pair, pair);
+}
+
+static __inline float32x4_t Twiddle(float32x4_t x, float wr, float wi) {
+  return vaddq_f32(vmulq_n_f32(x, wr), vmulq_f32(Swap(x), Pair(-wi, wi)));
+}
+
+static void Radix4(float *a, int j, int l) {
+  const uint32x4_t sign_re = SignRe();
+  const uint32x4_t sign_im = SignIm();
+  const float32x4_t a0 = vld1q_f32(&a[j]);
+  const float32x4_t a1 = vld1q_f32(&a[j + l]);
+  const float32x4_t a2 = vld1q_f32(&a[j + 2 * l]);
+  const float32x4_t a3 = vld1q_f32(&a[j + 3 * l]);
+  const float32x4_t x0 = vaddq_f32(a0, a1);
+  const float32x4_t x1 = vsubq_f32(a0, a1);
+  const float32x4_t x2 = vaddq_f32(a2, a3);
+  const float32x4_t x3s = Swap(vsubq_f32(a2, a3));
+  vst1q_f32(&a[j], vaddq_f32(x0, x2));
+  vst1q_f32(&a[j + 2 * l], vsubq_f32(x0, x2));
+  vst1q_f32(&a[j + l], vaddq_f32(x1, Negate(x3s, sign_re)));
+  vst1q_f32(&a[j + 3 * l], vaddq_f32(x1, Negate(x3s, sign_im)));
+}
+
+static void cftmdl_NEON(int n, int l, float *a, float *w) {
+  const uint32x4_t sign_re = SignRe();
+  const uint32x4_t sign_im = SignIm();
+  int j, k, k1, k2, m, m2;
+  float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+
+  m = l << 2;
+  for (j = 0; j < l; j += 4) {
+    Radix4(a, j, l);
+  }
+  wk1r = w[2];
+  for (j = m; j < l + m; j += 4) {
+    const float32x4_t a0 = vld1q_f32(&a[j]);
+    const float32x4_t a1 = vld1q_f32(&a[j + l]);
+    const float32x4_t a2 = vld1q_f32(&a[j + 2 * l]);
+    const float32x4_t a3 = vld1q_f32(&a[j + 3 * l]);
+    const float32x4_t x0 = vaddq_f32(a0, a1);
+    const float32x4_t x1 = vsubq_f32(a0, a1);
+    const float32x4_t x2 = vaddq_f32(a2, a3);
+    const float32x4_t x3 = vsubq_f32(a2, a3);
+    const float32x4_t y2 = Negate(Swap(vsubq_f32(x0, x2)), sign_re);
+    const float32x4_t t = vaddq_f32(x1, Negate(Swap(x3), sign_re));
+    const float32x4_t p = vaddq_f32(Swap(x3), Negate(x1, sign_im));
+    vst1q_f32(&a[j], vaddq_f32(x0, x2));
+    vst1q_f32(&a[j + 2 * l], y2);
+    vst1q_f32(&a[j + l], vmulq_n_f32(
+        vaddq_f32(t, Negate(Swap(t), sign_re)), wk1r));
+    vst1q_f32(&a[j + 3 * l], vmulq_n_f32(
+        vaddq_f32(Swap(p), Negate(p, sign_re)), wk1r));
+  }
+  k1 = 0;
+  m2 = 2 * m;
+  for (k = m2; k < n; k += m2) {
+    k1 += 2;
+    k2 = 2 * k1;
+    wk2r = w[k1];
+    wk2i = w[k1 + 1];
+    wk1r = w[k2];
+    wk1i = w[k2 + 1];
+    wk3r = wk1r - 2 * wk2i * wk1i;
+    wk3i = 2 * wk2i * wk1r - wk1i;
+    for (j = k; j < l + k; j += 4) {
+      const float32x4_t a0 = vld1q_f32(&a[j]);
+      const float32x4_t a1 = vld1q_f32(&a[j + l]);
+      const float32x4_t a2 = vld1q_f32(&a[j + 2 * l]);
+      const float32x4_t a3 = vld1q_f32(&a[j + 3 * l]);
+      const float32x4_t x0 = vaddq_f32(a0, a1);
+      const float32x4_t x1 = vsubq_f32(a0, a1);
+      const float32x4_t x2 = vaddq_f32(a2, a3);
+      const float32x4_t x3s = Swap(vsubq_f32(a2, a3));
+      vst1q_f32(&a[j], vaddq_f32(x0, x2));
+      vst1q_f32(&a[j + 2 * l], Twiddle(vsubq_f32(x0, x2), wk2r, wk2i));
+      vst1q_f32(&a[j + l],
+                Twiddle(vaddq_f32(x1, Negate(x3s, sign_re)), wk1r, wk1i));
+      vst1q_f32(&a[j + 3 * l],
+                Twiddle(vaddq_f32(x1, Negate(x3s, sign_im)), wk3r, wk3i));
+    }
+    wk1r = w[k2 + 2];
+    wk1i = w[k2 + 3];
+    wk3r = wk1r - 2 * wk2r * wk1i;
+    wk3i = 2 * wk2r * wk1r - wk1i;
+    for (j = k + m; j < l + (k + m); j += 4) {
+      const float32x4_t a0 = vld1q_f32(&a[j]);
+      const float32x4_t a1 = vld1q_f32(&a[j + l]);
+      const float32x4_t a2 = vld1q_f32(&a[j + 2 * l]);
+      const float32x4_t a3 = vld1q_f32(&a[j + 3 * l]);
+      const float32x4_t x0 = vaddq_f32(a0, a1);
+      const float32x4_t x1 = vsubq_f32(a0, a1);
+      const float32x4_t x2 = vaddq_f32(a2, a3);
+      const float32x4_t x3s = Swap(vsubq_f32(a2, a3));
+      vst1q_f32(&a[j + 2 * l], Twiddle(vsubq_f32(x0, x2), -wk2i, wk2r));
+      vst1q_f32(&a[j], vaddq_f32(x0, x2));
+      vst1q_f32(&a[j + l],
+                Twiddle(vaddq_f32(x1, Negate(x3s, sign_re)), wk1r, wk1i));
+      vst1q_f32(&a[j + 3 * l],
+                Twiddle(vaddq_f32(x1, Negate(x3s, sign_im)), wk3r, wk3i));
+    }
+  }
+}
+
+static void cftfsub_NEON(int n, float *a, float *w) {
+  int j, l;
+
+  if (n <= 8) {
+    cftfsub(n, a, w);
+    return;
+  }
+  cft1st(n, a, w);
+  l = 8;
+  while ((l << 2) < n) {
+    cftmdl_NEON(n, l, a, w);
+    l <<= 2;
+  }
+  if ((l << 2) == n) {
+    for (j = 0; j < l; j += 4) {
+      Radix4(a, j, l);
+    }
+  } else {
+    for (j = 0; j < l; j += 4) {
+      const float32x4_t a0 = vld1q_f32(&a[j]);
+      const float32x4_t a1 = vld1q_f32(&a[j + l]);
+      vst1q_f32(&a[j], vaddq_f32(a0, a1));
+      vst1q_f32(&a[j + l], vsubq_f32(a0, a1));
+    }
+  }
+}
+
+static void cftbsub_NEON(int n, float *a, float *w) {
+  const uint32x4_t sign_re = SignRe();
+  const uint32x4_t sign_im = SignIm();
+  int j, l;
+
+  if (n <= 8) {
+    cftbsub(n, a, w);
+    return;
+  }
+  cft1st(n, a, w);
+  l = 8;
+  while ((l << 2) < n) {
+    cftmdl_NEON(n, l, a, w);
+    l <<= 2;
+  }
+  if ((l << 2) == n) {
+    for (j = 0; j < l; j += 4) {
+      const float32x4_t a0 = vld1q_f32(&a[j]);
+      const float32x4_t a1 = vld1q_f32(&a[j + l]);
+      const float32x4_t a2 = vld1q_f32(&a[j + 2 * l]);
+      const float32x4_t a3 = vld1q_f32(&a[j + 3 * l]);
+      const float32x4_t x0 = Negate(vaddq_f32(a0, a1), sign_im);
+      const float32x4_t x1 = Negate(vsubq_f32(a0, a1), sign_im);
+      const float32x4_t x2 = vaddq_f32(a2, a3);
+      const float32x4_t x3s = Swap(vsubq_f32(a2, a3));
+      vst1q_f32(&a[j], vaddq_f32(x0, Negate(x2, sign_im)));
+      vst1q_f32(&a[j + 2 * l], vaddq_f32(x0, Negate(x2, sign_re)));
+      vst1q_f32(&a[j + l], vsubq_f32(x1, x3s));
+      vst1q_f32(&a[j + 3 * l], vaddq_f32(x1, x3s));
+    }
+  } else {
+    for (j = 0; j < l; j += 4) {
+      const float32x4_t a0 = vld1q_f32(&a[j]);
+      const float32x4_t a1 = vld1q_f32(&a[j + l]);
+      vst1q_f32(&a[j], Negate(vaddq_f32(a0, a1), sign_im));
+      vst1q_f32(&a[j + l], Negate(vsubq_f32(a0, a1), sign_im));
+    }
+  }
+}
+
+static __inline void LoadRftTwiddles(const float *c, int nc, int kk,
+                                     float32x4_t *wkr, float32x4_t *wki) {
+  *wkr = vcombine_f32(vdup_n_f32(0.5f - c[nc - kk]),
+                      vdup_n_f32(0.5f - c[nc - kk - 1]));
+  *wki = vcombine_f32(vdup_n_f32(c[kk]), vdup_n_f32(c[kk + 1]));
+}
+
+static __inline float32x4_t Reverse(float32x4_t x) {
+  return vcombine_f32(vget_high_f32(x), vget_low_f32(x));
+}
+
+static void rftfsub_NEON(int n, float *a, int nc, float *c) {
+  const uint32x4_t sign_re = SignRe();
+  const uint32x4_t sign_im = SignIm();
+  const int m = n >> 1;
+  int j, kk;
+
+  if (2 * nc != m) {
+    rftfsub(n, a, nc, c);
+    return;
+  }
+  kk = 1;
+  for (j = 2; j + 2 < m; j += 4, kk += 2) {
+    float32x4_t wkr, wki, x, y;
+    const float32x4_t aj = vld1q_f32(&a[j]);
+    const float32x4_t ak = Reverse(vld1q_f32(&a[n - j - 2]));
+    LoadRftTwiddles(c, nc, kk, &wkr, &wki);
+    x = vaddq_f32(aj, Negate(ak, sign_re));
+    y = vaddq_f32(vmulq_f32(wkr, x),
+                  vmulq_f32(Negate(wki, sign_re), Swap(x)));
+    vst1q_f32(&a[j], vsubq_f32(aj, y));
+    vst1q_f32(&a[n - j - 2], Reverse(vaddq_f32(ak, Negate(y, sign_im))));
+  }
+  for (; j < m; j += 2, kk++) {
+    const int k = n - j;
+    const float wkr = 0.5f - c[nc - kk];
+    const float wki = c[kk];
+    const float xr = a[j] - a[k];
+    const float xi = a[j + 1] + a[k + 1];
+    const float yr = wkr * xr - wki * xi;
+    const float yi = wkr * xi + wki * xr;
+    a[j] -= yr;
+    a[j + 1] -= yi;
+    a[k] += yr;
+    a[k + 1] -= yi;
+  }
+}
+
+static void rftbsub_NEON(int n, float *a, int nc, float *c) {
+  const uint32x4_t sign_re = SignRe();
+  const uint32x4_t sign_im = SignIm();
+  const int m = n >> 1;
+  int j, kk;
+
+  if (2 * nc != m) {
+    rftbsub(n, a, nc, c);
+    return;
+  }
+  a[1] = -a[1];
+  kk = 1;
+  for (j = 2; j + 2 < m; j += 4, kk += 2) {
+    float32x4_t wkr, wki, x, y;
+    const float32x4_t aj = vld1q_f32(&a[j]);
+    const float32x4_t ak = Reverse(vld1q_f32(&a[n - j - 2]));
+    LoadRftTwiddles(c, nc, kk, &wkr, &wki);
+    x = vaddq_f32(aj, Negate(ak, sign_re));
+    y = vaddq_f32(vmulq_f32(wkr, x),
+                  vmulq_f32(Negate(wki, sign_im), Swap(x)));
+    vst1q_f32(&a[j], Negate(vsubq_f32(aj, y), sign_im));
+    vst1q_f32(&a[n - j - 2], Reverse(vaddq_f32(Negate(ak, sign_im), y)));
+  }
+  for (; j < m; j += 2, kk++) {
+    const int k = n - j;
+    const float wkr = 0.5f - c[nc - kk];
+    const float wki = c[kk];
+    const float xr = a[j] - a[k];
+    const float xi = a[j + 1] + a[k + 1];
+    const float yr = wkr * xr + wki * xi;
+    const float yi = wkr * xi - wki * xr;
+    a[j] -= yr;
+    a[j + 1] = yi - a[j + 1];
+    a[k] += yr;
+    a[k + 1] = yi - a[k + 1];
+  }
+  a[m + 1] = -a[m + 1];
+}
+
+void rdft_init_neon(void) {
+  rdft_cftfsub = cftfsub_NEON;
+  rdft_cftbsub = cftbsub_NEON;
+  rdft_rftfsub = rftfsub_NEON;
+  rdft_rftbsub = rftbsub_NEON;
+}
+
+#endif  // WEBRTC_ARCH_ARM_NEON
@@ -0,0 +1,325 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * SSE2 versions of the rdft butterflies. Each vector holds two consecutive
+ * complex values (re, im, re, im). The arithmetic is done in the same order
+ * as in fft4g.c, so the results are bit exact with the C versions.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#include "fft4g.h"
+
+// Swaps the real and imaginary parts.
+static __inline __m128 Swap(__m128 x) {
+  return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// Negates the real (k_sign_re) or imaginary (k_sign_im) parts.
+static __inline __m128 Negate(__m128 x, __m128 sign) {
+  return _mm_xor_ps(x, sign);
+}
+
+static __inline __m128 SignRe(void) {
+  return _mm_castsi128_ps(_mm_set_epi32(0, 0x80000000, 0, 0x80000000));
+}
+
+static __inline __m128 SignIm(void) {
+  return _mm_castsi128_ps(_mm_set_epi32(0x80000000, 0, 0x80000000, 0));
+}
+
+// (x0r, x0i) * (wr, wi) computed as wr * x0r - wi * x0i, wr * x0i + wi * x0r.
+static __inline __m128 Twiddle(__m128 x, float wr, float wi) {
+  return _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(wr)),
+                    _mm_mul_ps(Swap(x), _mm_set_ps(wi, -wi, wi, -wi)));
+}
+
+// The radix-4 butterfly of the first loop of cftmdl and of cftfsub.
+static void Radix4(float *a, int j, int l) {
+  const __m128 sign_re = SignRe();
+  const __m128 sign_im = SignIm();
+  const __m128 a0 = _mm_loadu_ps(&a[j]);
+  const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+  const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+  const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+  const __m128 x0 = _mm_add_ps(a0, a1);
+  const __m128 x1 = _mm_sub_ps(a0, a1);
+  const __m128 x2 = _mm_add_ps(a2, a3);
+  const __m128 x3s = Swap(_mm_sub_ps(a2, a3));
+  _mm_storeu_ps(&a[j], _mm_add_ps(x0, x2));
+  _mm_storeu_ps(&a[j + 2 * l], _mm_sub_ps(x0, x2));
+  _mm_storeu_ps(&a[j + l], _mm_add_ps(x1, Negate(x3s, sign_re)));
+  _mm_storeu_ps(&a[j + 3 * l], _mm_add_ps(x1, Negate(x3s, sign_im)));
+}
+
+static void cftmdl_SSE2(int n, int l, float *a, float *w) {
+  const __m128 sign_re = SignRe();
+  const __m128 sign_im = SignIm();
+  int j, k, k1, k2, m, m2;
+  float wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+  __m128 mm_wk1r;
+
+  m = l << 2;
+  for (j = 0; j < l; j += 4) {
+    Radix4(a, j, l);
+  }
+  wk1r = w[2];
+  mm_wk1r = _mm_set1_ps(wk1r);
+  for (j = m; j < l + m; j += 4) {
+    const __m128 a0 = _mm_loadu_ps(&a[j]);
+    const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+    const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+    const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+    const __m128 x0 = _mm_add_ps(a0, a1);
+    const __m128 x1 = _mm_sub_ps(a0, a1);
+    const __m128 x2 = _mm_add_ps(a2, a3);
+    const __m128 x3 = _mm_sub_ps(a2, a3);
+    // x2i - x0i, x0r - x2r
+    const __m128 y2 = Negate(Swap(_mm_sub_ps(x0, x2)), sign_re);
+    // x1r - x3i, x1i + x3r
+    const __m128 t = _mm_add_ps(x1, Negate(Swap(x3), sign_re));
+    // x3i + x1r, x3r - x1i
+    const __m128 p = _mm_add_ps(Swap(x3), Negate(x1, sign_im));
+    _mm_storeu_ps(&a[j], _mm_add_ps(x0, x2));
+    _mm_storeu_ps(&a[j + 2 * l], y2);
+    _mm_storeu_ps(&a[j + l], _mm_mul_ps(
+        mm_wk1r, _mm_add_ps(t, Negate(Swap(t), sign_re))));
+    _mm_storeu_ps(&a[j + 3 * l], _mm_mul_ps(
+        mm_wk1r, _mm_add_ps(Swap(p), Negate(p, sign_re))));
+  }
+  k1 = 0;
+  m2 = 2 * m;
+  for (k = m2; k < n; k += m2) {
+    k1 += 2;
+    k2 = 2 * k1;
+    wk2r = w[k1];
+    wk2i = w[k1 + 1];
+    wk1r = w[k2];
+    wk1i = w[k2 + 1];
+    wk3r = wk1r - 2 * wk2i * wk1i;
+    wk3i = 2 * wk2i * wk1r - wk1i;
+    for (j = k; j < l + k; j += 4) {
+      const __m128 a0 = _mm_loadu_ps(&a[j]);
+      const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+      const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+      const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+      const __m128 x0 = _mm_add_ps(a0, a1);
+      const __m128 x1 = _mm_sub_ps(a0, a1);
+      const __m128 x2 = _mm_add_ps(a2, a3);
+      const __m128 x3s = Swap(_mm_sub_ps(a2, a3));
+      _mm_storeu_ps(&a[j], _mm_add_ps(x0, x2));
+      _mm_storeu_ps(&a[j + 2 * l], Twiddle(_mm_sub_ps(x0, x2), wk2r, wk2i));
+      _mm_storeu_ps(&a[j + l],
+                    Twiddle(_mm_add_ps(x1, Negate(x3s, sign_re)), wk1r, wk1i));
+      _mm_storeu_ps(&a[j + 3 * l],
+                    Twiddle(_mm_add_ps(x1, Negate(x3s, sign_im)), wk3r, wk3i));
+    }
+    wk1r = w[k2 + 2];
+    wk1i = w[k2 + 3];
+    wk3r = wk1r - 2 * wk2r * wk1i;
+    wk3i = 2 * wk2r * wk1r - wk1i;
+    for (j = k + m; j < l + (k + m); j += 4) {
+      const __m128 a0 = _mm_loadu_ps(&a[j]);
+      const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+      const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+      const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+      const __m128 x0 = _mm_add_ps(a0, a1);
+      const __m128 x1 = _mm_sub_ps(a0, a1);
+      const __m128 x2 = _mm_add_ps(a2, a3);
+      const __m128 x3s = Swap(_mm_sub_ps(a2, a3));
+      // Multiplication by (-wk2i, wk2r).
+      _mm_storeu_ps(&a[j + 2 * l], Twiddle(_mm_sub_ps(x0, x2), -wk2i, wk2r));
+      _mm_storeu_ps(&a[j], _mm_add_ps(x0, x2));
+      _mm_storeu_ps(&a[j + l],
+                    Twiddle(_mm_add_ps(x1, Negate(x3s, sign_re)), wk1r, wk1i));
+      _mm_storeu_ps(&a[j + 3 * l],
+                    Twiddle(_mm_add_ps(x1, Negate(x3s, sign_im)), wk3r, wk3i));
+    }
+  }
+}
+
+static void cftfsub_SSE2(int n, float *a, float *w) {
+  int j, l;
+
+  if (n <= 8) {
+    cftfsub(n, a, w);
+    return;
+  }
+  cft1st(n, a, w);
+  l = 8;
+  while ((l << 2) < n) {
+    cftmdl_SSE2(n, l, a, w);
+    l <<= 2;
+  }
+  if ((l << 2) == n) {
+    for (j = 0; j < l; j += 4) {
+      Radix4(a, j, l);
+    }
+  } else {
+    for (j = 0; j < l; j += 4) {
+      const __m128 a0 = _mm_loadu_ps(&a[j]);
+      const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+      _mm_storeu_ps(&a[j], _mm_add_ps(a0, a1));
+      _mm_storeu_ps(&a[j + l], _mm_sub_ps(a0, a1));
+    }
+  }
+}
+
+static void cftbsub_SSE2(int n, float *a, float *w) {
+  const __m128 sign_re = SignRe();
+  const __m128 sign_im = SignIm();
+  int j, l;
+
+  if (n <= 8) {
+    cftbsub(n, a, w);
+    return;
+  }
+  cft1st(n, a, w);
+  l = 8;
+  while ((l << 2) < n) {
+    cftmdl_SSE2(n, l, a, w);
+    l <<= 2;
+  }
+  if ((l << 2) == n) {
+    for (j = 0; j < l; j += 4) {
+      const __m128 a0 = _mm_loadu_ps(&a[j]);
+      const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+      const __m128 a2 = _mm_loadu_ps(&a[j + 2 * l]);
+      const __m128 a3 = _mm_loadu_ps(&a[j + 3 * l]);
+      // The imaginary parts of the input are conjugated.
+      const __m128 x0 = Negate(_mm_add_ps(a0, a1), sign_im);
+      const __m128 x1 = Negate(_mm_sub_ps(a0, a1), sign_im);
+      const __m128 x2 = _mm_add_ps(a2, a3);
+      const __m128 x3s = Swap(_mm_sub_ps(a2, a3));
+      _mm_storeu_ps(&a[j], _mm_add_ps(x0, Negate(x2, sign_im)));
+      _mm_storeu_ps(&a[j + 2 * l], _mm_add_ps(x0, Negate(x2, sign_re)));
+      _mm_storeu_ps(&a[j + l], _mm_sub_ps(x1, x3s));
+      _mm_storeu_ps(&a[j + 3 * l], _mm_add_ps(x1, x3s));
+    }
+  } else {
+    for (j = 0; j < l; j += 4) {
+      const __m128 a0 = _mm_loadu_ps(&a[j]);
+      const __m128 a1 = _mm_loadu_ps(&a[j + l]);
+      _mm_storeu_ps(&a[j], Negate(_mm_add_ps(a0, a1), sign_im));
+      _mm_storeu_ps(&a[j + l], Negate(_mm_sub_ps(a0, a1), sign_im));
+    }
+  }
+}
+
+// Loads the twiddles of rftfsub and rftbsub for j and j + 2 (kk and kk + 1)
+// as (wkr, wkr, wkr', wkr') and (wki, wki, wki', wki').
+static __inline void LoadRftTwiddles(const float *c, int nc, int kk,
+                                     __m128 *wkr, __m128 *wki) {
+  const float wkr0 = 0.5f - c[nc - kk];
+  const float wkr1 = 0.5f - c[nc - kk - 1];
+  *wkr = _mm_set_ps(wkr1, wkr1, wkr0, wkr0);
+  *wki = _mm_set_ps(c[kk + 1], c[kk + 1], c[kk], c[kk]);
+}
+
+// Swaps the two complex values of a vector.
+static __inline __m128 Reverse(__m128 x) {
+  return _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+static void rftfsub_SSE2(int n, float *a, int nc, float *c) {
+  const __m128 sign_re = SignRe();
+  const __m128 sign_im = SignIm();
+  const int m = n >> 1;
+  int j, kk;
+
+  if (2 * nc != m) {
+    // The twiddles are only contiguous when ks == 1.
+    rftfsub(n, a, nc, c);
+    return;
+  }
+  kk = 1;
+  for (j = 2; j + 2 < m; j += 4, kk += 2) {
+    __m128 wkr, wki, x, y;
+    const __m128 aj = _mm_loadu_ps(&a[j]);
+    // a[k], a[k + 1] for k = n - j and n - j - 2.
+    const __m128 ak = Reverse(_mm_loadu_ps(&a[n - j - 2]));
+    LoadRftTwiddles(c, nc, kk, &wkr, &wki);
+    // xr = a[j] - a[k], xi = a[j + 1] + a[k + 1]
+    x = _mm_add_ps(aj, Negate(ak, sign_re));
+    // yr = wkr * xr - wki * xi, yi = wkr * xi + wki * xr
+    y = _mm_add_ps(_mm_mul_ps(wkr, x),
+                   _mm_mul_ps(Negate(wki, sign_re), Swap(x)));
+    _mm_storeu_ps(&a[j], _mm_sub_ps(aj, y));
+    _mm_storeu_ps(&a[n - j - 2],
+                  Reverse(_mm_add_ps(ak, Negate(y, sign_im))));
+  }
+  for (; j < m; j += 2, kk++) {
+    const int k = n - j;
+    const float wkr = 0.5f - c[nc - kk];
+    const float wki = c[kk];
+    const float xr = a[j] - a[k];
+    const float xi = a[j + 1] + a[k + 1];
+    const float yr = wkr * xr - wki * xi;
+    const float yi = wkr * xi + wki * xr;
+    a[j] -= yr;
+    a[j + 1] -= yi;
+    a[k] += yr;
+    a[k + 1] -= yi;
+  }
+}
+
+static void rftbsub_SSE2(int n, float *a, int nc, float *c) {
+  const __m128 sign_re = SignRe();
+  const __m128 sign_im = SignIm();
+  const int m = n >> 1;
+  int j, kk;
+
+  if (2 * nc != m) {
+    rftbsub(n, a, nc, c);
+    return;
+  }
+  a[1] = -a[1];
+  kk = 1;
+  for (j = 2; j + 2 < m; j += 4, kk += 2) {
+    __m128 wkr, wki, x, y;
+    const __m128 aj = _mm_loadu_ps(&a[j]);
+    const __m128 ak = Reverse(_mm_loadu_ps(&a[n - j - 2]));
+    LoadRftTwiddles(c, nc, kk, &wkr, &wki);
+    x = _mm_add_ps(aj, Negate(ak, sign_re));
+    // yr = wkr * xr + wki * xi, yi = wkr * xi - wki * xr
+    y = _mm_add_ps(_mm_mul_ps(wkr, x),
+                   _mm_mul_ps(Negate(wki, sign_im), Swap(x)));
+    // a[j] -= yr, a[j + 1] = yi - a[j + 1]
+    _mm_storeu_ps(&a[j], Negate(_mm_sub_ps(aj, y), sign_im));
+    // a[k] += yr, a[k + 1] = yi - a[k + 1]
+    _mm_storeu_ps(&a[n - j - 2],
+                  Reverse(_mm_add_ps(Negate(ak, sign_im), y)));
+  }
+  for (; j < m; j += 2, kk++) {
+    const int k = n - j;
+    const float wkr = 0.5f - c[nc - kk];
+    const float wki = c[kk];
+    const float xr = a[j] - a[k];
+    const float xi = a[j + 1] + a[k + 1];
+    const float yr = wkr * xr + wki * xi;
+    const float yi = wkr * xi - wki * xr;
+    a[j] -= yr;
+    a[j + 1] = yi - a[j + 1];
+    a[k] += yr;
+    a[k + 1] = yi - a[k + 1];
+  }
+  a[m + 1] = -a[m + 1];
+}
+
+void rdft_init_sse2(void) {
+  rdft_cftfsub = cftfsub_SSE2;
+  rdft_cftbsub = cftbsub_SSE2;
+  rdft_rftfsub = rftfsub_SSE2;
+  rdft_rftbsub = rftbsub_SSE2;
+}
+
+#endif  // __SSE2__
@@ -25,6 +25,21 @@
         'fft4g.c',
         'fft4g.h',
       ],
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'fft4g_sse2.c',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'fft4g_neon.c',
+          ],
+        }],
+      ],
     },
   ],
 }
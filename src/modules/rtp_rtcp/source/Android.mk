@@ -40,6 +40,12 @@ LOCAL_SRC_FILES := bitrate.cc \
     rtp_sender_video.cc \
     rtp_format_vp8.cc
 
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
+    forward_error_correction_neon.cc.neon
+MY_ARCH_DEFS := '-DWEBRTC_ARCH_ARM_NEON'
+endif
+
 # Flags passed to both C and C++ files.
 MY_CFLAGS :=  
 MY_CFLAGS_C :=
@@ -50,7 +56,7 @@ MY_DEFS := '-DNO_TCMALLOC' \
     '-DWEBRTC_THREAD_RR' \
     '-DWEBRTC_ANDROID' \
     '-DANDROID' 
-LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS)
+LOCAL_CFLAGS := $(MY_CFLAGS_C) $(MY_CFLAGS) $(MY_DEFS) $(MY_ARCH_DEFS)
 
 # Include paths placed before CFLAGS/CPPFLAGS
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../.. \
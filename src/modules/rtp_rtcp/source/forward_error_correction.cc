@@ -63,6 +63,7 @@ ForwardErrorCorrection::ForwardErrorCorrection(const WebRtc_Word32 id) :
     _lastMediaPacketReceived(false),
     _fecPacketReceived(false)
 {
+    internal::InitXorBuffers();
 }
 
 ForwardErrorCorrection::~ForwardErrorCorrection()
@@ -145,12 +146,16 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
         return -1;
     }
 
-    // Do some error checking on the media packets.
+    // Do some error checking on the media packets, and gather them in an
+    // array so that the encoder doesn't have to walk the list.
+    Packet* mediaPackets[kMaxMediaPackets];
     Packet* mediaPacket;
+    WebRtc_UWord32 mediaPktIdx = 0;
     ListItem* mediaListItem = mediaPacketList.First();
     while (mediaListItem != NULL)
     {
         mediaPacket = static_cast<Packet*>(mediaListItem->GetItem());
+        mediaPackets[mediaPktIdx++] = mediaPacket;
 
         if (mediaPacket->length < kRtpHeaderSize)
         {
@@ -199,84 +204,71 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
     }
 
     // -- Generate packet masks --
-    WebRtc_UWord8* packetMask = new WebRtc_UWord8[numFecPackets * numMaskBytes];
+    WebRtc_UWord8 packetMask[kMaxMediaPackets * kMaskSizeLBitSet];
     memset(packetMask, 0, numFecPackets * numMaskBytes);
     internal::GeneratePacketMasks(numMediaPackets, numFecPackets,
         numImportantPackets, useUnequalProtection, packetMask);
 
     // -- Generate FEC bit strings --
     WebRtc_UWord8 mediaPayloadLength[2];
-    mediaListItem = mediaPacketList.First();
     for (WebRtc_UWord32 i = 0; i < numFecPackets; i++)
     {
-        mediaListItem = mediaPacketList.First();
-        WebRtc_UWord32 pktMaskIdx = i * numMaskBytes;
-        WebRtc_UWord32 mediaPktIdx = 0;
-        WebRtc_UWord16 fecPacketLength = 0;
-        while (mediaListItem != NULL)
+        const WebRtc_UWord8* fecMask = &packetMask[i * numMaskBytes];
+        WebRtc_UWord8* fecData = _generatedFecPackets[i].data;
+        for (mediaPktIdx = 0; mediaPktIdx < numMediaPackets; mediaPktIdx++)
         {
             // Each FEC packet has a multiple byte mask.
-            if (packetMask[pktMaskIdx] & (1 << (7 - mediaPktIdx)))
+            if ((fecMask[mediaPktIdx >> 3] & (0x80 >> (mediaPktIdx & 7))) == 0)
             {
-                mediaPacket = static_cast<Packet*>(mediaListItem->GetItem());
-
-                // Assign network-ordered media payload length.
-                ModuleRTPUtility::AssignUWord16ToBuffer(mediaPayloadLength,
-                    mediaPacket->length - kRtpHeaderSize);
-                fecPacketLength = mediaPacket->length + fecRtpOffset;
-                // On the first protected packet, we don't need to XOR.
-                if (_generatedFecPackets[i].length == 0)
+                continue;
+            }
+            mediaPacket = mediaPackets[mediaPktIdx];
+            const WebRtc_UWord16 payloadLength =
+                mediaPacket->length - kRtpHeaderSize;
+
+            // Assign network-ordered media payload length.
+            ModuleRTPUtility::AssignUWord16ToBuffer(mediaPayloadLength,
+                payloadLength);
+            const WebRtc_UWord16 fecPacketLength =
+                mediaPacket->length + fecRtpOffset;
+            // On the first protected packet, we don't need to XOR.
+            if (_generatedFecPackets[i].length == 0)
+            {
+                // Copy the first 2 bytes of the RTP header.
+                memcpy(fecData, mediaPacket->data, 2);
+                // Copy the 5th to 8th bytes of the RTP header.
+                memcpy(&fecData[4], &mediaPacket->data[4], 4);
+                // Copy network-ordered payload size.
+                memcpy(&fecData[8], mediaPayloadLength, 2);
+
+                // Copy RTP payload, leaving room for the ULP header.
+                memcpy(&fecData[kFecHeaderSize + ulpHeaderSize],
+                    &mediaPacket->data[kRtpHeaderSize], payloadLength);
+            }
+            else
+            {
+                // XOR with the first 2 bytes of the RTP header.
+                fecData[0] ^= mediaPacket->data[0];
+                fecData[1] ^= mediaPacket->data[1];
+
+                // XOR with the 5th to 8th bytes of the RTP header.
+                for (WebRtc_UWord32 j = 4; j < 8; j++)
                 {
-                    // Copy the first 2 bytes of the RTP header.
-                    memcpy(_generatedFecPackets[i].data, mediaPacket->data, 2);
-                    // Copy the 5th to 8th bytes of the RTP header.
-                    memcpy(&_generatedFecPackets[i].data[4], &mediaPacket->data[4], 4);
-                    // Copy network-ordered payload size.
-                    memcpy(&_generatedFecPackets[i].data[8], mediaPayloadLength, 2);
-
-                    // Copy RTP payload, leaving room for the ULP header.
-                    memcpy(&_generatedFecPackets[i].data[kFecHeaderSize + ulpHeaderSize],
-                        &mediaPacket->data[kRtpHeaderSize],
-                        mediaPacket->length - kRtpHeaderSize);
+                    fecData[j] ^= mediaPacket->data[j];
                 }
-                else
-                {
-                    // XOR with the first 2 bytes of the RTP header.
-                    _generatedFecPackets[i].data[0] ^= mediaPacket->data[0];
-                    _generatedFecPackets[i].data[1] ^= mediaPacket->data[1];
 
-                    // XOR with the 5th to 8th bytes of the RTP header.
-                    for (WebRtc_UWord32 j = 4; j < 8; j++)
-                    {
-                        _generatedFecPackets[i].data[j] ^= mediaPacket->data[j];
-                    }
-
-                    // XOR with the network-ordered payload size.
-                    _generatedFecPackets[i].data[8] ^= mediaPayloadLength[0];
-                    _generatedFecPackets[i].data[9] ^= mediaPayloadLength[1];
-
-                    // XOR with RTP payload, leaving room for the ULP header.
-                    for (WebRtc_Word32 j = kFecHeaderSize + ulpHeaderSize;
-                        j < fecPacketLength; j++)
-                    {
-                        _generatedFecPackets[i].data[j] ^=
-                            mediaPacket->data[j - fecRtpOffset];
-                    }
-                }
+                // XOR with the network-ordered payload size.
+                fecData[8] ^= mediaPayloadLength[0];
+                fecData[9] ^= mediaPayloadLength[1];
 
-                if (fecPacketLength > _generatedFecPackets[i].length)
-                {
-                    _generatedFecPackets[i].length = fecPacketLength;
-                }
+                // XOR with RTP payload, leaving room for the ULP header.
+                internal::XorBuffers(&fecData[kFecHeaderSize + ulpHeaderSize],
+                    &mediaPacket->data[kRtpHeaderSize], payloadLength);
             }
 
-            mediaListItem = mediaPacketList.Next(mediaListItem);
-            mediaPktIdx++;
-            if (mediaPktIdx == 8)
+            if (fecPacketLength > _generatedFecPackets[i].length)
             {
-                // Switch to the next mask byte.
-                mediaPktIdx = 0;
-                pktMaskIdx++;
+                _generatedFecPackets[i].length = fecPacketLength;
             }
         }
 
@@ -286,7 +278,6 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
             WEBRTC_TRACE(kTraceError, kTraceRtpRtcp, _id,
                 "Packet mask has row of zeros %d %d %d ",
                 numMediaPackets, numImportantPackets, numFecPackets);
-            delete packetMask;
             return -1;
 
         }
@@ -313,8 +304,7 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
     //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     //   |              mask cont. (present only when L = 1)             |
     //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    mediaListItem = mediaPacketList.First();
-    mediaPacket = static_cast<Packet*>(mediaListItem->GetItem());
+    mediaPacket = mediaPackets[0];
     assert(mediaPacket != NULL);
     for (WebRtc_UWord32 i = 0; i < numFecPackets; i++)
     {
@@ -344,7 +334,6 @@ ForwardErrorCorrection::GenerateFEC(const ListWrapper& mediaPacketList,
         memcpy(&_generatedFecPackets[i].data[12], &packetMask[i * numMaskBytes],
             numMaskBytes);
     }
-    delete packetMask; 
     return 0;
 }
 
@@ -686,10 +675,12 @@ ForwardErrorCorrection::DecodeFEC(ListWrapper& receivedPacketList,
 
                     // XOR with RTP payload.
                     // TODO: Are we doing more XORs than required here?
-                    for (WebRtc_Word32 i = kRtpHeaderSize; i < protectedPacket->pkt->length;
-                        i++)
+                    if (protectedPacket->pkt->length > kRtpHeaderSize)
                     {
-                        recPacketToInsert->pkt->data[i] ^= protectedPacket->pkt->data[i];
+                        internal::XorBuffers(
+                            &recPacketToInsert->pkt->data[kRtpHeaderSize],
+                            &protectedPacket->pkt->data[kRtpHeaderSize],
+                            protectedPacket->pkt->length - kRtpHeaderSize);
                     }
                 }
                 protectedPacketListItem =
@@ -11,6 +11,8 @@
 #include "forward_error_correction_internal.h"
 #include "fec_private_tables.h"
 
+#include "cpu_features_wrapper.h"
+
 #include <cassert>
 #include <cstring>
 
@@ -330,5 +332,44 @@ void GeneratePacketMasks(const WebRtc_UWord32 numMediaPackets,
 
 } //End of GetPacketMasks
 
+XorBuffersFunc XorBuffers = XorBuffers_C;
+
+void XorBuffers_C(WebRtc_UWord8* dst, const WebRtc_UWord8* src,
+                  WebRtc_UWord32 length)
+{
+    // Word-wise, memcpy keeps the accesses alignment and aliasing safe.
+    WebRtc_UWord32 i = 0;
+    for (; i + 4 <= length; i += 4)
+    {
+        WebRtc_UWord32 a;
+        WebRtc_UWord32 b;
+        memcpy(&a, &dst[i], 4);
+        memcpy(&b, &src[i], 4);
+        a ^= b;
+        memcpy(&dst[i], &a, 4);
+    }
+    for (; i < length; i++)
+    {
+        dst[i] ^= src[i];
+    }
+}
+
+void InitXorBuffers()
+{
+    XorBuffers = XorBuffers_C;
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+#if defined(__SSE2__)
+        InitXorBuffers_SSE2();
+#endif
+    }
+    if (WebRtc_GetCPUInfo(kNEON))
+    {
+#if defined(WEBRTC_ARCH_ARM_NEON)
+        InitXorBuffers_NEON();
+#endif
+    }
+}
+
 }  // namespace internal
 }  // namespace webrtc
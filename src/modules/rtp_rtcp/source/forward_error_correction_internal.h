@@ -44,6 +44,26 @@ void GeneratePacketMasks(const WebRtc_UWord32 numMediaPackets,
                          const bool useUnequalProtection,
                          WebRtc_UWord8* packetMask);
 
+ /**
+  * XORs length bytes of src into dst. Points to the fastest version the CPU
+  * supports once #InitXorBuffers() has been called.
+  */
+typedef void (*XorBuffersFunc)(WebRtc_UWord8* dst,
+                               const WebRtc_UWord8* src,
+                               WebRtc_UWord32 length);
+extern XorBuffersFunc XorBuffers;
+
+void XorBuffers_C(WebRtc_UWord8* dst, const WebRtc_UWord8* src,
+                  WebRtc_UWord32 length);
+
+ /**
+  * Selects #XorBuffers from the features reported by WebRtc_GetCPUInfo.
+  * Calling it again re-runs the selection.
+  */
+void InitXorBuffers();
+
+void InitXorBuffers_SSE2();
+void InitXorBuffers_NEON();
 
 } // namespace internal
 } // namespace webrtc
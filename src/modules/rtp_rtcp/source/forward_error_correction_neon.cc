@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#if defined(WEBRTC_ARCH_ARM_NEON)
+#include <arm_neon.h>
+
+#include "forward_error_correction_internal.h"
+
+namespace webrtc {
+namespace internal {
+
+static void XorBuffers_NEON(WebRtc_UWord8* dst, const WebRtc_UWord8* src,
+                            WebRtc_UWord32 length)
+{
+    WebRtc_UWord32 i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        const uint8x16_t x0 = veorq_u8(vld1q_u8(&dst[i]), vld1q_u8(&src[i]));
+        const uint8x16_t x1 = veorq_u8(vld1q_u8(&dst[i + 16]),
+                                       vld1q_u8(&src[i + 16]));
+        vst1q_u8(&dst[i], x0);
+        vst1q_u8(&dst[i + 16], x1);
+    }
+    XorBuffers_C(&dst[i], &src[i], length - i);
+}
+
+void InitXorBuffers_NEON()
+{
+    XorBuffers = XorBuffers_NEON;
+}
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // WEBRTC_ARCH_ARM_NEON
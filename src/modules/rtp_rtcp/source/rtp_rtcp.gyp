@@ -83,6 +83,21 @@
         'rtp_format_vp8.cc',
         'rtp_format_vp8.h',
       ], # source
+      'conditions': [
+        ['disable_sse2 == 0 and (target_arch == "ia32" or target_arch == "x64")', {
+          'sources': [
+            'forward_error_correction_sse2.cc',
+          ],
+        }],
+        ['target_arch == "arm" and arm_neon == 1', {
+          'defines': [
+            'WEBRTC_ARCH_ARM_NEON',
+          ],
+          'sources': [
+            'forward_error_correction_neon.cc',
+          ],
+        }],
+      ],
     },
   ],
 }
@@ -27,6 +27,22 @@
         'rtp_format_vp8_unittest.cc',
       ],
     },
+    {
+      'target_name': 'rtp_sender_unittest',
+      'type': 'executable',
+      'dependencies': [
+        'rtp_rtcp.gyp:rtp_rtcp',
+        '../../../system_wrappers/source/system_wrappers.gyp:system_wrappers',
+        '../../../../testing/gtest.gyp:gtest',
+        '../../../../testing/gtest.gyp:gtest_main',
+      ],
+      'include_dirs': [
+        '.',
+      ],
+      'sources': [
+        'rtp_sender_unittest.cc',
+      ],
+    },
   ],
 }
 
@@ -47,8 +47,8 @@ RTPSender::RTPSender(const WebRtc_Word32 id, const bool audio) :
     _storeSentPackets(false),
     _storeSentPacketsNumber(0),
     _prevSentPacketsCritsect(*CriticalSectionWrapper::CreateCriticalSection()),
-    _prevSentPacketsIndex(0),
-    _ptrPrevSentPackets(NULL),
+    _prevSentPackets(NULL),
+    _prevSentPacketsSlotSize(0),
     _prevSentPacketsSeqNum(NULL),
     _prevSentPacketsLength(NULL),
     _prevSentPacketsResendTime(NULL),
@@ -127,15 +127,7 @@ RTPSender::~RTPSender()
         }
     } while (loop);
 
-    for(WebRtc_Word32 i=0; i< _storeSentPacketsNumber; i++)
-    {
-        if(_ptrPrevSentPackets[i])
-        {
-            delete [] _ptrPrevSentPackets[i];
-            _ptrPrevSentPackets[i] = 0;
-        }
-    }
-    delete [] _ptrPrevSentPackets;
+    delete [] _prevSentPackets;
     delete [] _prevSentPacketsSeqNum;
     delete [] _prevSentPacketsLength;
     delete [] _prevSentPacketsResendTime;
@@ -506,14 +498,11 @@ RTPSender::SetMaxPayloadLength(const WebRtc_UWord16 maxPayloadLength, const WebR
         {
             // we need to free the memmory allocated for storing sent packets
             // will be allocated in SendToNetwork
-            for(WebRtc_Word32 i=0; i< _storeSentPacketsNumber; i++)
-            {
-                if(_ptrPrevSentPackets[i])
-                {
-                    delete [] _ptrPrevSentPackets[i];
-                    _ptrPrevSentPackets[i] = NULL;
-                }
-            }
+            delete [] _prevSentPackets;
+            _prevSentPackets = NULL;
+            _prevSentPacketsSlotSize = 0;
+            memset(_prevSentPacketsLength, 0,
+                   sizeof(WebRtc_UWord16) * _storeSentPacketsNumber);
         }
     }
 
@@ -706,18 +695,25 @@ RTPSender::SetStorePacketsStatus(const bool enable, const WebRtc_UWord16 numberT
         }
         if(numberToStore > 0)
         {
+            // round up to a power of two, see _storeSentPacketsNumber
+            WebRtc_UWord32 number = 1;
+            while(number < numberToStore)
+            {
+                number <<= 1;
+            }
             _storeSentPackets = enable;
-            _storeSentPacketsNumber = numberToStore;
-
-            _ptrPrevSentPackets = new WebRtc_Word8*[numberToStore],
-            _prevSentPacketsSeqNum = new WebRtc_UWord16[numberToStore];
-            _prevSentPacketsLength = new WebRtc_UWord16[numberToStore];
-            _prevSentPacketsResendTime = new WebRtc_UWord32[numberToStore];
-
-            memset(_ptrPrevSentPackets,0, sizeof(WebRtc_Word8*)*numberToStore);
-            memset(_prevSentPacketsSeqNum,0, sizeof(WebRtc_UWord16)*numberToStore);
-            memset(_prevSentPacketsLength,0, sizeof(WebRtc_UWord16)*numberToStore);
-            memset(_prevSentPacketsResendTime,0,sizeof(WebRtc_UWord32)*numberToStore);
+            _storeSentPacketsNumber = number;
+
+            // the packets are allocated in SendToNetwork
+            _prevSentPackets = NULL;
+            _prevSentPacketsSlotSize = 0;
+            _prevSentPacketsSeqNum = new WebRtc_UWord16[number];
+            _prevSentPacketsLength = new WebRtc_UWord16[number];
+            _prevSentPacketsResendTime = new WebRtc_UWord32[number];
+
+            memset(_prevSentPacketsSeqNum,0, sizeof(WebRtc_UWord16)*number);
+            memset(_prevSentPacketsLength,0, sizeof(WebRtc_UWord16)*number);
+            memset(_prevSentPacketsResendTime,0,sizeof(WebRtc_UWord32)*number);
         } else
         {
             // storing 0 packets does not make sence
@@ -728,20 +724,13 @@ RTPSender::SetStorePacketsStatus(const bool enable, const WebRtc_UWord16 numberT
         _storeSentPackets = enable;
         if(_storeSentPacketsNumber > 0)
         {
-            for(WebRtc_Word32 i=0; i< _storeSentPacketsNumber; i++)
-            {
-                if(_ptrPrevSentPackets[i])
-                {
-                    delete [] _ptrPrevSentPackets[i];
-                    _ptrPrevSentPackets[i] = 0;
-                }
-            }
-            delete [] _ptrPrevSentPackets;
+            delete [] _prevSentPackets;
             delete [] _prevSentPacketsSeqNum;
             delete [] _prevSentPacketsLength;
             delete [] _prevSentPacketsResendTime;
 
-            _ptrPrevSentPackets = NULL;
+            _prevSentPackets = NULL;
+            _prevSentPacketsSlotSize = 0;
             _prevSentPacketsSeqNum = NULL;
             _prevSentPacketsLength = NULL;
             _prevSentPacketsResendTime = NULL;
@@ -770,7 +759,7 @@ RTPSender::ReSendToNetwork(WebRtc_UWord16 packetID,
 
     WebRtc_Word32 i = -1;
     WebRtc_Word32 length = 0;
-    WebRtc_Word32 index =0;
+    WebRtc_UWord32 index =0;
     WebRtc_UWord8 dataBuffer[IP_PACKET_SIZE];
 
     {
@@ -778,33 +767,9 @@ RTPSender::ReSendToNetwork(WebRtc_UWord16 packetID,
 
         if(_storeSentPackets)
         {
-            WebRtc_UWord16 seqNum = 0;
-            if(_prevSentPacketsIndex)
-            {
-                seqNum = _prevSentPacketsSeqNum[_prevSentPacketsIndex-1];
-            }else
-            {
-                seqNum = _prevSentPacketsSeqNum[_storeSentPacketsNumber-1];
-            }
-            index = (_prevSentPacketsIndex-1) - (seqNum - packetID);
-            if (index >= 0 && index < _storeSentPacketsNumber)
-            {
-                seqNum = _prevSentPacketsSeqNum[index];
-            }
-            if(seqNum != packetID)
-            {
-                //we did not found a match, search all
-                for (WebRtc_Word32 m = 0; m < _storeSentPacketsNumber ;m++)
-                {
-                    if(_prevSentPacketsSeqNum[m] == packetID)
-                    {
-                        index = m;
-                        seqNum = _prevSentPacketsSeqNum[index];
-                        break;
-                    }
-                }
-            }
-            if(seqNum == packetID)
+            index = packetID & (_storeSentPacketsNumber - 1);
+            const WebRtc_UWord16 seqNum = _prevSentPacketsSeqNum[index];
+            if(seqNum == packetID && _prevSentPacketsLength[index] > 0)
             {
                 WebRtc_UWord32 timeNow= ModuleRTPUtility::GetTimeInMS();
                 if(minResendTime>0 && (timeNow-_prevSentPacketsResendTime[index]<minResendTime))
@@ -816,7 +781,7 @@ RTPSender::ReSendToNetwork(WebRtc_UWord16 packetID,
 
                 length = _prevSentPacketsLength[index];
 
-                if(length > _maxPayloadLength || _ptrPrevSentPackets[index] == 0)
+                if(length > _maxPayloadLength || _prevSentPackets == NULL)
                 {
                     return -1;
                 }
@@ -831,7 +796,8 @@ RTPSender::ReSendToNetwork(WebRtc_UWord16 packetID,
         }
 
         // copy to local buffer for callback
-        memcpy(dataBuffer, _ptrPrevSentPackets[index], length);
+        memcpy(dataBuffer, _prevSentPackets + index * _prevSentPacketsSlotSize,
+               length);
     }
     {
         CriticalSectionScoped lock(_transportCritsect);
@@ -854,7 +820,7 @@ RTPSender::ReSendToNetwork(WebRtc_UWord16 packetID,
     {
         CriticalSectionScoped lock(_prevSentPacketsCritsect);
 
-        if(_prevSentPacketsSeqNum[index] == packetID) // Make sure the  packet is still in the array
+        if(index < _storeSentPacketsNumber && _prevSentPacketsSeqNum[index] == packetID) // Make sure the  packet is still in the array
         {
             _prevSentPacketsResendTime[index]= ModuleRTPUtility::GetTimeInMS();  // Store the time when the frame was last resent.
         }
@@ -1002,26 +968,22 @@ RTPSender::SendToNetwork(const WebRtc_UWord8* buffer,
         CriticalSectionScoped lock(_prevSentPacketsCritsect);
         if(_storeSentPackets && length > 0)
         {
-            if(_ptrPrevSentPackets[0] == NULL)
+            if(_prevSentPackets == NULL)
             {
-                for(WebRtc_Word32 i=0; i< _storeSentPacketsNumber; i++)
-                {
-                    _ptrPrevSentPackets[i] = new char[_maxPayloadLength];
-                    memset(_ptrPrevSentPackets[i],0, _maxPayloadLength);
-                }
+                _prevSentPacketsSlotSize = _maxPayloadLength;
+                _prevSentPackets = new WebRtc_UWord8[_storeSentPacketsNumber *
+                                                     _prevSentPacketsSlotSize];
             }
 
             const WebRtc_UWord16 sequenceNumber = (buffer[2] << 8) + buffer[3];
-
-            memcpy(_ptrPrevSentPackets[_prevSentPacketsIndex], buffer, length + rtpLength);
-            _prevSentPacketsSeqNum[_prevSentPacketsIndex] = sequenceNumber;
-            _prevSentPacketsLength[_prevSentPacketsIndex]= length + rtpLength;
-            _prevSentPacketsResendTime[_prevSentPacketsIndex]=0; // Packet has not been re-sent.
-            _prevSentPacketsIndex++;
-            if(_prevSentPacketsIndex >= _storeSentPacketsNumber)
-            {
-                _prevSentPacketsIndex = 0;
-            }
+            const WebRtc_UWord32 index =
+                sequenceNumber & (_storeSentPacketsNumber - 1);
+
+            memcpy(_prevSentPackets + index * _prevSentPacketsSlotSize, buffer,
+                   length + rtpLength);
+            _prevSentPacketsSeqNum[index] = sequenceNumber;
+            _prevSentPacketsLength[index]= length + rtpLength;
+            _prevSentPacketsResendTime[index]=0; // Packet has not been re-sent.
         }
     }
     // Send packet
@@ -281,11 +281,16 @@ private:
     WebRtc_UWord32            _keepAliveLastSent;
     WebRtc_UWord16            _keepAliveDeltaTimeSend;
 
+    // Sent packets are stored for NACK in slot
+    // (sequence number & (_storeSentPacketsNumber - 1)) of one slab of
+    // _storeSentPacketsNumber * _prevSentPacketsSlotSize bytes. The number of
+    // slots is a power of two so that the mapping survives sequence number
+    // wraparound.
     bool                      _storeSentPackets;
-    WebRtc_UWord16            _storeSentPacketsNumber;
+    WebRtc_UWord32            _storeSentPacketsNumber;
     CriticalSectionWrapper&    _prevSentPacketsCritsect;
-    WebRtc_Word32             _prevSentPacketsIndex;
-    WebRtc_Word8**            _ptrPrevSentPackets;
+    WebRtc_UWord8*            _prevSentPackets;
+    WebRtc_UWord16            _prevSentPacketsSlotSize;
     WebRtc_UWord16*           _prevSentPacketsSeqNum;
     WebRtc_UWord16*           _prevSentPacketsLength;
     WebRtc_UWord32*           _prevSentPacketsResendTime;
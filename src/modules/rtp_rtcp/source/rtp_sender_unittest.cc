@@ -0,0 +1,182 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file includes unit tests for the history of sent packets that
+ * RTPSender keeps for NACK.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+#include "typedefs.h"
+#include "common_types.h"
+#include "rtp_sender.h"
+
+namespace {
+
+using webrtc::RTPSender;
+using webrtc::Transport;
+
+const int kHeaderLength = 12;
+const int kPayloadLength = 100;
+const int kPacketLength = kHeaderLength + kPayloadLength;
+// Rounded up to 16 slots by RTPSender.
+const int kNumberToStore = 10;
+const int kSlots = 16;
+
+// Keeps the last packet sent to it.
+class LoopbackTransport : public Transport {
+ public:
+  LoopbackTransport() : packets_(0), length_(0) {}
+  virtual int SendPacket(int /*channel*/, const void* data, int len) {
+    packets_++;
+    length_ = len;
+    memcpy(packet_, data, len);
+    return len;
+  }
+  virtual int SendRTCPPacket(int /*channel*/, const void* /*data*/,
+                             int len) {
+    return len;
+  }
+
+  int packets_;
+  int length_;
+  WebRtc_UWord8 packet_[IP_PACKET_SIZE];
+};
+
+class RtpSenderHistoryTest : public ::testing::Test {
+ protected:
+  RtpSenderHistoryTest() : sender_(0, false) {}
+
+  virtual void SetUp() {
+    ASSERT_EQ(0, sender_.RegisterSendTransport(&transport_));
+    ASSERT_EQ(0, sender_.SetStorePacketsStatus(true, kNumberToStore));
+  }
+
+  // Fills |packet| with a header with |seq| and a payload derived from |seq|.
+  static void BuildPacket(WebRtc_UWord16 seq, WebRtc_UWord8* packet) {
+    memset(packet, 0, kHeaderLength);
+    packet[0] = 0x80;
+    packet[2] = static_cast<WebRtc_UWord8>(seq >> 8);
+    packet[3] = static_cast<WebRtc_UWord8>(seq);
+    for (int i = kHeaderLength; i < kPacketLength; i++) {
+      packet[i] = static_cast<WebRtc_UWord8>(seq + i);
+    }
+  }
+
+  void Send(WebRtc_UWord16 seq) {
+    WebRtc_UWord8 packet[kPacketLength];
+    BuildPacket(seq, packet);
+    ASSERT_EQ(0, sender_.SendToNetwork(packet, kPayloadLength,
+                                       kHeaderLength));
+  }
+
+  // Resends |seq| and checks that the packet that was sent with |seq| went
+  // out again.
+  void ExpectResent(WebRtc_UWord16 seq) {
+    const int packets = transport_.packets_;
+    EXPECT_EQ(kPacketLength, sender_.ReSendToNetwork(seq)) << seq;
+    ASSERT_EQ(packets + 1, transport_.packets_) << seq;
+    WebRtc_UWord8 packet[kPacketLength];
+    BuildPacket(seq, packet);
+    ASSERT_EQ(kPacketLength, transport_.length_);
+    EXPECT_EQ(0, memcmp(packet, transport_.packet_, kPacketLength)) << seq;
+  }
+
+  // Checks that resending |seq| fails without sending anything.
+  void ExpectNotResent(WebRtc_UWord16 seq) {
+    const int packets = transport_.packets_;
+    EXPECT_EQ(-1, sender_.ReSendToNetwork(seq)) << seq;
+    EXPECT_EQ(packets, transport_.packets_) << seq;
+  }
+
+  LoopbackTransport transport_;
+  RTPSender sender_;
+};
+
+TEST_F(RtpSenderHistoryTest, FindsPacketsBySequenceNumber) {
+  for (int seq = 100; seq < 100 + kNumberToStore; seq++) {
+    Send(seq);
+  }
+  // In any order.
+  ExpectResent(105);
+  ExpectResent(100);
+  ExpectResent(100 + kNumberToStore - 1);
+  ExpectResent(103);
+
+  // Never sent.
+  ExpectNotResent(99);
+  ExpectNotResent(100 + kNumberToStore);
+}
+
+TEST_F(RtpSenderHistoryTest, WrapsAroundTheSlotsAndSequenceNumbers) {
+  // The sequence numbers wrap in the middle of the slots.
+  const WebRtc_UWord16 first = 0xFFFF - kSlots / 2 + 1;
+  WebRtc_UWord16 seq = first;
+  for (int i = 0; i < kSlots; i++) {
+    Send(seq++);
+  }
+  EXPECT_EQ(kSlots / 2, seq);
+  seq = first;
+  for (int i = 0; i < kSlots; i++) {
+    ExpectResent(seq++);
+  }
+}
+
+TEST_F(RtpSenderHistoryTest, EvictsTheOldestPacket) {
+  for (int seq = 0; seq < kSlots; seq++) {
+    Send(seq);
+  }
+  ExpectResent(0);
+
+  // Takes the slot of packet 0.
+  Send(kSlots);
+  ExpectNotResent(0);
+  ExpectResent(kSlots);
+  for (int seq = 1; seq < kSlots; seq++) {
+    ExpectResent(seq);
+  }
+
+  // A whole history later, only the new packets are left.
+  for (int seq = kSlots + 1; seq < 3 * kSlots; seq++) {
+    Send(seq);
+  }
+  for (int seq = 0; seq < 2 * kSlots; seq++) {
+    ExpectNotResent(seq);
+  }
+  for (int seq = 2 * kSlots; seq < 3 * kSlots; seq++) {
+    ExpectResent(seq);
+  }
+}
+
+TEST_F(RtpSenderHistoryTest, ResendAfterEvictionFailsCleanly) {
+  Send(1);
+  Send(1 + kSlots);
+  ExpectNotResent(1);
+  // The failed resend leaves the packet in the slot alone.
+  ExpectResent(1 + kSlots);
+
+  // The packets are dropped when the slab is re-allocated...
+  ASSERT_EQ(0, sender_.SetMaxPayloadLength(IP_PACKET_SIZE - 20, 20));
+  ExpectNotResent(1 + kSlots);
+  Send(2);
+  ExpectResent(2);
+
+  // ...and when storing is disabled.
+  ASSERT_EQ(0, sender_.SetStorePacketsStatus(false, 0));
+  ExpectNotResent(2);
+  Send(3);
+  ExpectNotResent(3);
+}
+
+}  // namespace
@@ -0,0 +1,279 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/**
+ * Benchmark of the FEC encoder and decoder, with and without the SIMD XOR
+ * kernels, over the packet masks of fec_private_tables.h. Also verifies that
+ * both give the same FEC packets and that a lost media packet is recovered.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "cpu_features_wrapper.h"
+#include "forward_error_correction.h"
+#include "forward_error_correction_internal.h"
+#include "list_wrapper.h"
+#include "rtp_utility.h"
+
+using webrtc::ForwardErrorCorrection;
+
+namespace {
+
+enum { kIterations = 200 };
+// Typical size of a video packet.
+enum { kMediaPacketLength = 1200 };
+
+const WebRtc_UWord32 kSsrc = 0x12345678;
+
+struct Result
+{
+    double encodeMBps;
+    double decodeMBps;
+};
+
+void MakeMediaPackets(WebRtc_UWord32 numMediaPackets,
+                      ForwardErrorCorrection::Packet* mediaPackets,
+                      webrtc::ListWrapper& mediaPacketList)
+{
+    for (WebRtc_UWord32 i = 0; i < numMediaPackets; i++)
+    {
+        ForwardErrorCorrection::Packet* packet = &mediaPackets[i];
+        packet->length = kMediaPacketLength;
+        for (WebRtc_UWord32 j = 0; j < packet->length; j++)
+        {
+            packet->data[j] = static_cast<WebRtc_UWord8>(rand());
+        }
+        packet->data[0] = 0x80; // RTP version 2.
+        packet->data[1] &= 0x7f; // Clear marker bit.
+        webrtc::ModuleRTPUtility::AssignUWord16ToBuffer(&packet->data[2],
+                                                        i);
+        webrtc::ModuleRTPUtility::AssignUWord32ToBuffer(&packet->data[8],
+                                                        kSsrc);
+        mediaPacketList.PushBack(packet);
+    }
+    // Set the marker bit of the last packet.
+    mediaPackets[numMediaPackets - 1].data[1] |= 0x80;
+}
+
+// Receives all packets except media packet 0 and decodes. Returns 0 if the
+// lost packet was recovered.
+int Decode(ForwardErrorCorrection& fec,
+           WebRtc_UWord32 numMediaPackets,
+           const ForwardErrorCorrection::Packet* mediaPackets,
+           const webrtc::ListWrapper& fecPacketList)
+{
+    webrtc::ListWrapper receivedPacketList;
+    webrtc::ListWrapper recoveredPacketList;
+    WebRtc_UWord16 seqNum = 1;
+    for (; seqNum < numMediaPackets; seqNum++)
+    {
+        ForwardErrorCorrection::ReceivedPacket* receivedPacket =
+            new ForwardErrorCorrection::ReceivedPacket;
+        receivedPacket->pkt = new ForwardErrorCorrection::Packet;
+        receivedPacket->pkt->length = mediaPackets[seqNum].length;
+        memcpy(receivedPacket->pkt->data, mediaPackets[seqNum].data,
+               mediaPackets[seqNum].length);
+        receivedPacket->seqNum = seqNum;
+        receivedPacket->ssrc = kSsrc;
+        receivedPacket->isFec = false;
+        receivedPacket->lastMediaPktInFrame = (seqNum == numMediaPackets - 1);
+        receivedPacketList.PushBack(receivedPacket);
+    }
+    webrtc::ListItem* item = fecPacketList.First();
+    while (item != NULL)
+    {
+        const ForwardErrorCorrection::Packet* fecPacket =
+            static_cast<ForwardErrorCorrection::Packet*>(item->GetItem());
+        ForwardErrorCorrection::ReceivedPacket* receivedPacket =
+            new ForwardErrorCorrection::ReceivedPacket;
+        receivedPacket->pkt = new ForwardErrorCorrection::Packet;
+        receivedPacket->pkt->length = fecPacket->length;
+        memcpy(receivedPacket->pkt->data, fecPacket->data, fecPacket->length);
+        receivedPacket->seqNum = seqNum++;
+        receivedPacket->ssrc = kSsrc;
+        receivedPacket->isFec = true;
+        receivedPacket->lastMediaPktInFrame = false;
+        receivedPacketList.PushBack(receivedPacket);
+        item = fecPacketList.Next(item);
+    }
+
+    bool frameComplete = true;
+    if (fec.DecodeFEC(receivedPacketList, recoveredPacketList, seqNum,
+                      frameComplete) != 0)
+    {
+        return -1;
+    }
+    int ret = -1;
+    item = recoveredPacketList.First();
+    while (item != NULL)
+    {
+        const ForwardErrorCorrection::RecoveredPacket* recPacket =
+            static_cast<ForwardErrorCorrection::RecoveredPacket*>(
+                item->GetItem());
+        if (recPacket->wasRecovered && recPacket->seqNum == 0 &&
+            recPacket->pkt->length == mediaPackets[0].length &&
+            memcmp(recPacket->pkt->data, mediaPackets[0].data,
+                   mediaPackets[0].length) == 0)
+        {
+            ret = 0;
+        }
+        item = recoveredPacketList.Next(item);
+    }
+
+    // Free the recovered and stored packets.
+    frameComplete = true;
+    fec.DecodeFEC(receivedPacketList, recoveredPacketList, seqNum,
+                  frameComplete);
+    return ret;
+}
+
+int Run(ForwardErrorCorrection& fec, WebRtc_UWord32 numMediaPackets,
+        WebRtc_UWord32 numFecPackets,
+        const ForwardErrorCorrection::Packet* mediaPackets,
+        const webrtc::ListWrapper& mediaPacketList,
+        ForwardErrorCorrection::Packet* fecPackets, Result& result)
+{
+    const WebRtc_UWord8 protectionFactor =
+        static_cast<WebRtc_UWord8>(numFecPackets * 255 / numMediaPackets);
+    const double frameMB =
+        numMediaPackets * kMediaPacketLength / (1024.0 * 1024.0);
+
+    webrtc::ListWrapper fecPacketList;
+    clock_t ticks = clock();
+    for (int n = 0; n < kIterations; n++)
+    {
+        while (!fecPacketList.Empty())
+        {
+            fecPacketList.PopFront();
+        }
+        if (fec.GenerateFEC(mediaPacketList, protectionFactor, 0, false,
+                            fecPacketList) != 0)
+        {
+            printf("Error: GenerateFEC() failed\n");
+            return -1;
+        }
+    }
+    ticks = clock() - ticks;
+    result.encodeMBps = kIterations * frameMB * CLOCKS_PER_SEC /
+        (ticks > 0 ? ticks : 1);
+
+    // Keep a copy, the decoder may overwrite the generated packets.
+    WebRtc_UWord32 i = 0;
+    webrtc::ListItem* item = fecPacketList.First();
+    while (item != NULL)
+    {
+        memcpy(&fecPackets[i++], item->GetItem(),
+               sizeof(ForwardErrorCorrection::Packet));
+        item = fecPacketList.Next(item);
+    }
+
+    ticks = clock();
+    for (int n = 0; n < kIterations; n++)
+    {
+        if (Decode(fec, numMediaPackets, mediaPackets, fecPacketList) != 0)
+        {
+            printf("Error: media packet not recovered (%u, %u)\n",
+                   numMediaPackets, numFecPackets);
+            return -1;
+        }
+    }
+    ticks = clock() - ticks;
+    result.decodeMBps = kIterations * frameMB * CLOCKS_PER_SEC /
+        (ticks > 0 ? ticks : 1);
+    return 0;
+}
+
+}  // namespace
+
+int main()
+{
+    const WebRtc_UWord32 kNumMediaPackets[] = {4, 8, 12, 16, 24, 32, 48};
+    const WebRtc_UWord32 kNumConfigs =
+        sizeof(kNumMediaPackets) / sizeof(*kNumMediaPackets);
+    // Protection factors in percent.
+    const WebRtc_UWord32 kProtection[] = {25, 50, 100};
+    const WebRtc_UWord32 kNumProtections =
+        sizeof(kProtection) / sizeof(*kProtection);
+
+    webrtc::ForwardErrorCorrection fec(0);
+    ForwardErrorCorrection::Packet* mediaPackets =
+        new ForwardErrorCorrection::Packet[ForwardErrorCorrection::kMaxMediaPackets];
+    ForwardErrorCorrection::Packet* fecPackets[2];
+    fecPackets[0] =
+        new ForwardErrorCorrection::Packet[ForwardErrorCorrection::kMaxMediaPackets];
+    fecPackets[1] =
+        new ForwardErrorCorrection::Packet[ForwardErrorCorrection::kMaxMediaPackets];
+    const WebRtc_CPUInfo getCPUInfo = WebRtc_GetCPUInfo;
+    srand(0);
+
+    printf("%d byte media packets, MB/s of media\n", kMediaPacketLength);
+    printf("%5s %5s %10s %10s %10s %10s\n", "media", "fec", "enc C",
+           "enc SIMD", "dec C", "dec SIMD");
+    int ret = 0;
+    for (WebRtc_UWord32 c = 0; c < kNumConfigs && ret == 0; c++)
+    {
+        const WebRtc_UWord32 numMediaPackets = kNumMediaPackets[c];
+        webrtc::ListWrapper mediaPacketList;
+        MakeMediaPackets(numMediaPackets, mediaPackets, mediaPacketList);
+
+        for (WebRtc_UWord32 p = 0; p < kNumProtections && ret == 0; p++)
+        {
+            WebRtc_UWord32 numFecPackets =
+                numMediaPackets * kProtection[p] / 100;
+            if (numFecPackets == 0)
+            {
+                numFecPackets = 1;
+            }
+
+            Result result[2];
+            for (int simd = 0; simd < 2 && ret == 0; simd++)
+            {
+                WebRtc_GetCPUInfo = simd ? getCPUInfo : WebRtc_GetCPUInfoNoASM;
+                webrtc::internal::InitXorBuffers();
+                ret = Run(fec, numMediaPackets, numFecPackets, mediaPackets,
+                          mediaPacketList, fecPackets[simd], result[simd]);
+            }
+            if (ret != 0)
+            {
+                break;
+            }
+            for (WebRtc_UWord32 i = 0; i < numFecPackets; i++)
+            {
+                if (fecPackets[0][i].length != fecPackets[1][i].length ||
+                    memcmp(fecPackets[0][i].data, fecPackets[1][i].data,
+                           fecPackets[0][i].length) != 0)
+                {
+                    printf("Error: SIMD FEC packet %u differs from C\n", i);
+                    ret = -1;
+                }
+            }
+            printf("%5u %5u %10.1f %10.1f %10.1f %10.1f\n", numMediaPackets,
+                   numFecPackets, result[0].encodeMBps, result[1].encodeMBps,
+                   result[0].decodeMBps, result[1].decodeMBps);
+        }
+        while (!mediaPacketList.Empty())
+        {
+            mediaPacketList.PopFront();
+        }
+    }
+    WebRtc_GetCPUInfo = getCPUInfo;
+
+    delete [] mediaPackets;
+    delete [] fecPackets[0];
+    delete [] fecPackets[1];
+    if (ret == 0)
+    {
+        printf("\nAll tests passed successfully\n");
+    }
+    return ret;
+}
@@ -28,6 +28,20 @@
       ],
       
     },
+    {
+      'target_name': 'test_fec_benchmark',
+      'type': 'executable',
+      'dependencies': [
+        '../../source/rtp_rtcp.gyp:rtp_rtcp',
+      ],
+      'include_dirs': [
+        '../../source',
+        '../../../../system_wrappers/interface',
+      ],
+      'sources': [
+        'fec_benchmark.cc',
+      ],
+    },
   ],
 }
 
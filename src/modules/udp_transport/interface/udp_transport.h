@@ -135,7 +135,8 @@ public:
         kCannotFindLocalIp        = 14,
         kTosError                 = 16,
         kNotInitialized           = 17,
-        kPcpError                 = 18
+        kPcpError                 = 18,
+        kSendError                = 19
     };
 
     // Factory method. Constructor disabled.
@@ -328,6 +329,21 @@ public:
     virtual WebRtc_Word32 SetSendPorts(const WebRtc_UWord16 rtpPort,
                                        const WebRtc_UWord16 rtcpPort = 0) = 0;
 
+    // Enable batched socket I/O. Up to maxBatchSize incoming datagrams are
+    // read per system call and outgoing RTP packets sent with SendPacket(..)
+    // are queued and sent maxBatchSize at a time with one system call. A
+    // packet waits at most a few ms for the queue to fill up, and the queue
+    // is also flushed by Process(), FlushSendQueue() and before the sockets
+    // are closed or the destination changes. A maxBatchSize of 0 or 1
+    // disables batching. If a queued packet can't be sent, the next
+    // SendPacket(..) or FlushSendQueue() call returns -1 and LastError()
+    // returns kSendError.
+    // Note: this API only has effect on Linux.
+    virtual WebRtc_Word32 SetBatchedIO(const WebRtc_UWord16 maxBatchSize) = 0;
+
+    // Send all RTP packets queued in batched I/O mode.
+    virtual WebRtc_Word32 FlushSendQueue() = 0;
+
     // Retreive the last registered error code.
     virtual ErrorCode LastError() const = 0;
 
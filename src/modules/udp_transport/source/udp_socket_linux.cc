@@ -24,6 +24,22 @@
 #include "udp_socket_wrapper.h"
 
 namespace webrtc {
+UdpSocketLinuxReceiveBatch::UdpSocketLinuxReceiveBatch()
+{
+    memset(_from, 0, sizeof(_from));
+#if defined(WEBRTC_UDP_SOCKET_MMSG)
+    memset(_msgs, 0, sizeof(_msgs));
+    for(int i = 0; i < kMaxDatagrams; i++)
+    {
+        _iov[i].iov_base = _buf[i];
+        _iov[i].iov_len = kMaxDatagramSize;
+        _msgs[i].msg_hdr.msg_name = &_from[i];
+        _msgs[i].msg_hdr.msg_iov = &_iov[i];
+        _msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+}
+
 UdpSocketLinux::UdpSocketLinux(const WebRtc_Word32 id, UdpSocketManager* mgr,
                                bool ipV6Enable)
 {
@@ -33,6 +49,7 @@ UdpSocketLinux::UdpSocketLinux(const WebRtc_Word32 id, UdpSocketManager* mgr,
     _wantsIncoming = false;
     _error = 0;
     _mgr = mgr;
+    _receiveBatchSize = 1;
 
     _id = id;
     _obj = NULL;
@@ -163,13 +180,102 @@ WebRtc_Word32 UdpSocketLinux::SendTo(const WebRtc_Word8* buf, WebRtc_Word32 len,
     return retVal;
 }
 
+WebRtc_Word32 UdpSocketLinux::SendToBatch(const WebRtc_Word8* const* bufs,
+                                          const WebRtc_Word32* lens,
+                                          WebRtc_Word32 count,
+                                          const SocketAddress& to)
+{
+#if defined(WEBRTC_UDP_SOCKET_MMSG)
+    struct mmsghdr msgs[UdpSocketLinuxReceiveBatch::kMaxDatagrams];
+    struct iovec iov[UdpSocketLinuxReceiveBatch::kMaxDatagrams];
+    WebRtc_Word32 sent = 0;
+    while(sent < count)
+    {
+        int num = count - sent;
+        if(num > UdpSocketLinuxReceiveBatch::kMaxDatagrams)
+        {
+            num = UdpSocketLinuxReceiveBatch::kMaxDatagrams;
+        }
+        memset(msgs, 0, sizeof(msgs[0]) * num);
+        for(int i = 0; i < num; i++)
+        {
+            iov[i].iov_base = const_cast<WebRtc_Word8*>(bufs[sent + i]);
+            iov[i].iov_len = lens[sent + i];
+            msgs[i].msg_hdr.msg_name = const_cast<SocketAddress*>(&to);
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int retVal = sendmmsg(_socket, msgs, num, 0);
+        if(retVal == SOCKET_ERROR)
+        {
+            _error = errno;
+            WEBRTC_TRACE(kTraceError, kTraceTransport, _id,
+                         "UdpSocketLinux::SendToBatch() error: %d", _error);
+            break;
+        }
+        sent += retVal;
+        if(retVal < num)
+        {
+            break;
+        }
+    }
+    return (sent == 0 && count > 0) ? -1 : sent;
+#else
+    return UdpSocketWrapper::SendToBatch(bufs, lens, count, to);
+#endif
+}
+
+bool UdpSocketLinux::SetReceiveBatchSize(const WebRtc_UWord16 size)
+{
+#if defined(WEBRTC_UDP_SOCKET_MMSG)
+    if(size == 0)
+    {
+        return false;
+    }
+    _receiveBatchSize = size;
+    if(_receiveBatchSize > UdpSocketLinuxReceiveBatch::kMaxDatagrams)
+    {
+        _receiveBatchSize = UdpSocketLinuxReceiveBatch::kMaxDatagrams;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
 bool UdpSocketLinux::ValidHandle()
 {
     return _socket != INVALID_SOCKET;
 }
 
-void UdpSocketLinux::HasIncoming()
+bool UdpSocketLinux::HasIncoming(UdpSocketLinuxReceiveBatch* batch)
 {
+#if defined(WEBRTC_UDP_SOCKET_MMSG)
+    const WebRtc_UWord16 batchSize = _receiveBatchSize;
+    if(batch != NULL && batchSize > 1)
+    {
+        for(int i = 0; i < batchSize; i++)
+        {
+            batch->_msgs[i].msg_hdr.msg_namelen = sizeof(SocketAddress);
+        }
+        const int num = recvmmsg(_socket, batch->_msgs, batchSize, 0, NULL);
+        if(num == SOCKET_ERROR)
+        {
+            return false;
+        }
+        for(int i = 0; i < num; i++)
+        {
+            if(batch->_msgs[i].msg_len > 0 && _wantsIncoming && _incomingCb)
+            {
+                _incomingCb(_obj, batch->_buf[i], batch->_msgs[i].msg_len,
+                            &batch->_from[i]);
+            }
+        }
+        // A short read means that the socket has been drained.
+        return num == batchSize;
+    }
+#endif
     char buf[2048];
     int retval;
     SocketAddress from;
@@ -199,7 +305,7 @@ void UdpSocketLinux::HasIncoming()
         // The peer has performed an orderly shutdown.
         break;
     case SOCKET_ERROR:
-        break;
+        return false;
     default:
         if(_wantsIncoming && _incomingCb)
         {
@@ -207,6 +313,7 @@ void UdpSocketLinux::HasIncoming()
         }
         break;
     }
+    return true;
 }
 
 void UdpSocketLinux::CloseBlocking()
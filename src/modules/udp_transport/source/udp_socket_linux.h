@@ -15,6 +15,7 @@
 #include <netinet/in.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "condition_variable_wrapper.h"
 #include "critical_section_wrapper.h"
@@ -22,7 +23,30 @@
 
 #define SOCKET_ERROR -1
 
+// recvmmsg()/sendmmsg() are not available in the Android NDK.
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+#define WEBRTC_UDP_SOCKET_MMSG
+#endif
+
 namespace webrtc {
+// Scratch buffers used for batched reads. One instance is owned by each
+// socket manager thread and shared by all sockets serviced by that thread.
+class UdpSocketLinuxReceiveBatch
+{
+public:
+    enum {kMaxDatagrams = 32};
+    enum {kMaxDatagramSize = 2048};
+
+    UdpSocketLinuxReceiveBatch();
+
+#if defined(WEBRTC_UDP_SOCKET_MMSG)
+    struct mmsghdr _msgs[kMaxDatagrams];
+    struct iovec _iov[kMaxDatagrams];
+#endif
+    SocketAddress _from[kMaxDatagrams];
+    WebRtc_Word8 _buf[kMaxDatagrams][kMaxDatagramSize];
+};
+
 class UdpSocketLinux : public UdpSocketWrapper
 {
 public:
@@ -45,6 +69,13 @@ public:
     virtual WebRtc_Word32 SendTo(const WebRtc_Word8* buf, WebRtc_Word32 len,
                                  const SocketAddress& to);
 
+    virtual WebRtc_Word32 SendToBatch(const WebRtc_Word8* const* bufs,
+                                      const WebRtc_Word32* lens,
+                                      WebRtc_Word32 count,
+                                      const SocketAddress& to);
+
+    virtual bool SetReceiveBatchSize(const WebRtc_UWord16 size);
+
     // Deletes socket in addition to closing it.
     // TODO (hellner): make destructor protected.
     virtual void CloseBlocking();
@@ -64,7 +95,10 @@ public:
                         WebRtc_Word32 /*overrideDSCP*/) {return false;}
 
     bool CleanUp();
-    void HasIncoming();
+    // Reads and delivers one datagram, or up to the configured receive batch
+    // size if batch is non-NULL. Returns false if the socket has been
+    // drained (or failed).
+    bool HasIncoming(UdpSocketLinuxReceiveBatch* batch = NULL);
     bool WantsIncoming() {return _wantsIncoming;}
     void ReadyForDeletion();
 private:
@@ -77,6 +111,7 @@ private:
 
     SOCKET _socket;
     UdpSocketManager* _mgr;
+    WebRtc_UWord16 _receiveBatchSize;
     ConditionVariableWrapper* _closeBlockingCompletedCond;
     ConditionVariableWrapper* _readyForDeletionCond;
 
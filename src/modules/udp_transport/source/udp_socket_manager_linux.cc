@@ -10,6 +10,9 @@
 
 #include "udp_socket_manager_linux.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
 #include <strings.h>
 #include <sys/time.h>
 #include <sys/types.h>
@@ -21,7 +24,8 @@
 
 namespace webrtc {
 UdpSocketManagerLinux::UdpSocketManagerLinux(const WebRtc_Word32 id,
-                                             WebRtc_UWord8& numOfWorkThreads)
+                                             WebRtc_UWord8& numOfWorkThreads,
+                                             const UdpSocketManagerType type)
     : UdpSocketManager(id, numOfWorkThreads),
       _id(id),
       _critSect(CriticalSectionWrapper::CreateCriticalSection()),
@@ -36,12 +40,19 @@ UdpSocketManagerLinux::UdpSocketManagerLinux(const WebRtc_Word32 id,
     }
     for(int i = 0;i < _numberOfSocketMgr; i++)
     {
+#if defined(WEBRTC_LINUX)
+        if(type != kUdpSocketManagerSelect)
+        {
+            _socketMgr[i] = new UdpSocketManagerEpollImpl();
+            continue;
+        }
+#endif
         _socketMgr[i] = new UdpSocketManagerLinuxImpl();
     }
 
     WEBRTC_TRACE(kTraceDebug, kTraceTransport, _id,
-                 "UdpSocketManagerLinux(%d)::UdpSocketManagerLinux()",
-                 _numberOfSocketMgr);
+                 "UdpSocketManagerLinux(%d)::UdpSocketManagerLinux() type:%d",
+                 _numberOfSocketMgr, type);
 }
 
 UdpSocketManagerLinux::~UdpSocketManagerLinux()
@@ -178,6 +189,7 @@ bool UdpSocketManagerLinux::RemoveSocket(UdpSocketWrapper* s)
 UdpSocketManagerLinuxImpl::UdpSocketManagerLinuxImpl()
 {
     _critSectList = CriticalSectionWrapper::CreateCriticalSection();
+    _receiveBatch = new UdpSocketLinuxReceiveBatch();
     _thread = ThreadWrapper::CreateThread(UdpSocketManagerLinuxImpl::Run, this,
                                           kRealtimePriority,
                                           "UdpSocketManagerLinuxImplThread");
@@ -192,6 +204,7 @@ UdpSocketManagerLinuxImpl::~UdpSocketManagerLinuxImpl()
     {
         delete _thread;
     }
+    delete _receiveBatch;
 
     if (_critSectList != NULL)
     {
@@ -296,7 +309,7 @@ bool UdpSocketManagerLinuxImpl::Process()
         UdpSocketLinux* s = static_cast<UdpSocketLinux*>(it->GetItem());
         if (FD_ISSET(it->GetUnsignedId(), &_readFds))
         {
-            s->HasIncoming();
+            s->HasIncoming(_receiveBatch);
             num--;
         }
     }
@@ -375,6 +388,7 @@ void UdpSocketManagerLinuxImpl::UpdateSocketMap()
             if(removeFD == addFD)
             {
                 deleteSocket = addSocket;
+                SocketRemoved(addSocket);
                 _addList.Erase(addListItem);
                 break;
             }
@@ -390,6 +404,7 @@ void UdpSocketManagerLinuxImpl::UpdateSocketMap()
             if(socket)
             {
                 deleteSocket = socket;
+                SocketRemoved(socket);
             }
             _socketMap.Erase(it);
         }
@@ -414,4 +429,113 @@ void UdpSocketManagerLinuxImpl::UpdateSocketMap()
     }
     _critSectList->Leave();
 }
+
+#if defined(WEBRTC_LINUX)
+UdpSocketManagerEpollImpl::UdpSocketManagerEpollImpl()
+    : UdpSocketManagerLinuxImpl(),
+      _epollFd(epoll_create(kMaxEventsPerWakeup))
+{
+    if(_epollFd == -1)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceTransport, -1,
+                     "UdpSocketManagerEpollImpl epoll_create() error: %d",
+                     errno);
+    } else {
+        fcntl(_epollFd, F_SETFD, FD_CLOEXEC);
+    }
+}
+
+UdpSocketManagerEpollImpl::~UdpSocketManagerEpollImpl()
+{
+    if(_epollFd != -1)
+    {
+        close(_epollFd);
+    }
+}
+
+bool UdpSocketManagerEpollImpl::AddSocket(UdpSocketWrapper* s)
+{
+    // No FD_SETSIZE restriction applies to epoll.
+    UdpSocketLinux* sl = static_cast<UdpSocketLinux*>(s);
+    if(_epollFd == -1 || sl->GetFd() == INVALID_SOCKET)
+    {
+        return false;
+    }
+    // Register the socket here rather than in UpdateSocketMap() so that a
+    // failure is reported to the caller. If data arrived before the socket
+    // was registered the kernel reports it as ready on the first epoll_wait()
+    // after EPOLL_CTL_ADD.
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLET;
+    event.data.ptr = sl;
+    if(epoll_ctl(_epollFd, EPOLL_CTL_ADD, sl->GetFd(), &event) != 0)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceTransport, -1,
+                     "UdpSocketManagerEpollImpl failed to watch socket %d: %d",
+                     sl->GetFd(), errno);
+        return false;
+    }
+    _critSectList->Enter();
+    _addList.PushBack(s);
+    _critSectList->Leave();
+    return true;
+}
+
+void UdpSocketManagerEpollImpl::SocketRemoved(UdpSocketWrapper* s)
+{
+    UdpSocketLinux* sl = static_cast<UdpSocketLinux*>(s);
+    // The event argument is ignored but must be non-NULL on kernels older
+    // than 2.6.9.
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    epoll_ctl(_epollFd, EPOLL_CTL_DEL, sl->GetFd(), &event);
+}
+
+bool UdpSocketManagerEpollImpl::Process()
+{
+    UpdateSocketMap();
+
+    // Timeout = 10 ms. Needed so that added and removed sockets are picked up
+    // by UpdateSocketMap() and that Stop() is honored.
+    const int num = epoll_wait(_epollFd, _events, kMaxEventsPerWakeup, 10);
+    if(num == -1)
+    {
+        if(errno != EINTR)
+        {
+            timespec t;
+            t.tv_sec = 0;
+            t.tv_nsec = 10000*1000;
+            nanosleep(&t, NULL);
+        }
+        return true;
+    }
+
+    // Sockets can only be removed from the epoll set by UpdateSocketMap(),
+    // which runs on this thread, so all pointers in _events are valid.
+    for(int i = 0; i < num; i++)
+    {
+        UdpSocketLinux* s = static_cast<UdpSocketLinux*>(_events[i].data.ptr);
+        // Edge-triggered: the socket must be read until it would block or it
+        // will not be reported again. Bound the reads so that a flooded
+        // socket can't starve the others and UpdateSocketMap(). A socket that
+        // still has data is re-armed, which puts it back on the ready list
+        // behind the sockets already there.
+        int reads = 0;
+        while(s->HasIncoming(_receiveBatch))
+        {
+            if(++reads == kMaxReadsPerWakeup)
+            {
+                struct epoll_event event;
+                memset(&event, 0, sizeof(event));
+                event.events = EPOLLIN | EPOLLET;
+                event.data.ptr = s;
+                epoll_ctl(_epollFd, EPOLL_CTL_MOD, s->GetFd(), &event);
+                break;
+            }
+        }
+    }
+    return true;
+}
+#endif // WEBRTC_LINUX
 } // namespace webrtc
@@ -14,6 +14,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#if defined(WEBRTC_LINUX)
+#include <sys/epoll.h>
+#endif
+
 #include "critical_section_wrapper.h"
 #include "list_wrapper.h"
 #include "map_wrapper.h"
@@ -24,13 +28,15 @@
 #define MAX_NUMBER_OF_SOCKET_MANAGERS_LINUX 8
 
 namespace webrtc {
+class UdpSocketLinuxReceiveBatch;
 class UdpSocketManagerLinuxImpl;
 
 class UdpSocketManagerLinux : public UdpSocketManager
 {
 public:
     UdpSocketManagerLinux(const WebRtc_Word32 id,
-                          WebRtc_UWord8& numOfWorkThreads);
+                          WebRtc_UWord8& numOfWorkThreads,
+                          const UdpSocketManagerType type);
     virtual ~UdpSocketManagerLinux();
 
     virtual WebRtc_Word32 ChangeUniqueId(const WebRtc_Word32 id);
@@ -63,12 +69,17 @@ public:
 
 protected:
     static bool Run(ThreadObj obj);
-    bool Process();
+    virtual bool Process();
     void UpdateSocketMap();
 
-private:
+    // Called from UpdateSocketMap() with _critSectList held, on the worker
+    // thread, before a socket is deleted.
+    virtual void SocketRemoved(UdpSocketWrapper* /*s*/) {}
+
     ThreadWrapper* _thread;
     CriticalSectionWrapper* _critSectList;
+    // Only accessed from _thread.
+    UdpSocketLinuxReceiveBatch* _receiveBatch;
 
     fd_set _readFds;
 
@@ -76,6 +87,32 @@ private:
     ListWrapper _addList;
     ListWrapper _removeList;
 };
+
+#if defined(WEBRTC_LINUX)
+// Socket manager backed by an edge-triggered epoll set. Unlike the select()
+// based implementation there is no FD_SETSIZE limit on the descriptors that
+// can be added and a wakeup only touches the sockets that are readable.
+class UdpSocketManagerEpollImpl : public UdpSocketManagerLinuxImpl
+{
+public:
+    UdpSocketManagerEpollImpl();
+    virtual ~UdpSocketManagerEpollImpl();
+
+    virtual bool AddSocket(UdpSocketWrapper* s);
+
+protected:
+    virtual bool Process();
+    virtual void SocketRemoved(UdpSocketWrapper* s);
+
+private:
+    enum { kMaxEventsPerWakeup = 128 };
+    // HasIncoming() calls per socket and wakeup.
+    enum { kMaxReadsPerWakeup = 16 };
+
+    int _epollFd;
+    struct epoll_event _events[kMaxEventsPerWakeup];
+};
+#endif // WEBRTC_LINUX
 } // namespace webrtc
 
 #endif // WEBRTC_MODULES_UDP_TRANSPORT_SOURCE_UDP_SOCKET_MANAGER_LINUX_H_
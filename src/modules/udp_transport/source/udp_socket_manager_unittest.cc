@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file includes unit tests for the Linux socket managers. The sockets
+ * receive on the loopback interface.
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "critical_section_wrapper.h"
+#include "udp_socket_linux.h"
+#include "udp_socket_manager_linux.h"
+#include "udp_socket_wrapper.h"
+
+namespace {
+
+using webrtc::CallbackObj;
+using webrtc::CriticalSectionScoped;
+using webrtc::CriticalSectionWrapper;
+using webrtc::SocketAddress;
+using webrtc::UdpSocketManagerLinux;
+using webrtc::UdpSocketManagerType;
+using webrtc::UdpSocketWrapper;
+
+const int kWaitMs = 2000;
+
+// Counts the packets received on one socket. If |other| is set, records how
+// many packets |other| had received when the first packet arrived.
+class Receiver {
+ public:
+  Receiver()
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        packets_(0),
+        other_(NULL),
+        other_packets_at_first_(-1) {}
+  ~Receiver() { delete crit_; }
+
+  static void OnPacket(CallbackObj obj, const WebRtc_Word8* /*buf*/,
+                       WebRtc_Word32 /*len*/, const SocketAddress* /*from*/) {
+    Receiver* self = static_cast<Receiver*>(obj);
+    const int other_packets =
+        self->other_ != NULL ? self->other_->packets() : -1;
+    CriticalSectionScoped lock(*self->crit_);
+    if (self->packets_ == 0) {
+      self->other_packets_at_first_ = other_packets;
+    }
+    self->packets_++;
+  }
+
+  int packets() const {
+    CriticalSectionScoped lock(*crit_);
+    return packets_;
+  }
+  int other_packets_at_first() const {
+    CriticalSectionScoped lock(*crit_);
+    return other_packets_at_first_;
+  }
+  void set_other(const Receiver* other) { other_ = other; }
+
+ private:
+  CriticalSectionWrapper* crit_;
+  int packets_;
+  const Receiver* other_;
+  int other_packets_at_first_;
+};
+
+class UdpSocketManagerTest : public ::testing::Test {
+ protected:
+  UdpSocketManagerTest() : mgr_(NULL), started_(false), sender_(-1) {}
+
+  virtual void SetUp() {
+    sender_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ASSERT_NE(-1, sender_);
+  }
+
+  virtual void TearDown() {
+    // CloseBlocking() needs the work threads, the manager deletes the sockets.
+    if (mgr_ != NULL && !started_) {
+      Start();
+    }
+    for (size_t i = 0; i < sockets_.size(); i++) {
+      sockets_[i]->CloseBlocking();
+    }
+    if (mgr_ != NULL) {
+      EXPECT_TRUE(mgr_->Stop());
+      delete mgr_;
+    }
+    for (size_t i = 0; i < receivers_.size(); i++) {
+      delete receivers_[i];
+    }
+    close(sender_);
+  }
+
+  void CreateManager(UdpSocketManagerType type, WebRtc_UWord8 threads) {
+    mgr_ = new UdpSocketManagerLinux(0, threads, type);
+  }
+
+  bool Start() {
+    started_ = mgr_->Start();
+    return started_;
+  }
+
+  // Adds a receiving socket bound to an ephemeral loopback port. The socket
+  // and its receiver get the same index in |sockets_| and |receivers_|.
+  bool AddSocket() {
+    receivers_.push_back(new Receiver);
+    UdpSocketWrapper* s = UdpSocketWrapper::CreateSocket(
+        0, mgr_, receivers_.back(), Receiver::OnPacket);
+    if (s == NULL) {
+      return false;
+    }
+    sockets_.push_back(s);
+    SocketAddress addr;
+    memset(&addr, 0, sizeof(addr));
+    addr._sockaddr_in.sin_family = AF_INET;
+    addr._sockaddr_in.sin_addr = htonl(INADDR_LOOPBACK);
+    return s->Bind(addr) && s->StartReceiving();
+  }
+
+  void Send(int socket, int packets) {
+    const int fd =
+        static_cast<webrtc::UdpSocketLinux*>(sockets_[socket])->GetFd();
+    sockaddr_in to;
+    socklen_t len = sizeof(to);
+    ASSERT_EQ(0, getsockname(fd, reinterpret_cast<sockaddr*>(&to), &len));
+    const char payload[12] = "0123456789a";
+    for (int i = 0; i < packets; i++) {
+      ASSERT_EQ(static_cast<ssize_t>(sizeof(payload)),
+                sendto(sender_, payload, sizeof(payload), 0,
+                       reinterpret_cast<sockaddr*>(&to), len));
+    }
+  }
+
+  // Waits until the receivers from |first| to |last| have |packets| packets.
+  bool WaitForPackets(int first, int last, int packets) const {
+    for (int ms = 0; ms < kWaitMs; ms += 10) {
+      int done = first;
+      while (done <= last && receivers_[done]->packets() == packets) {
+        done++;
+      }
+      if (done > last) {
+        return true;
+      }
+      usleep(10 * 1000);
+    }
+    return false;
+  }
+
+  void ReceiveOnManySockets(UdpSocketManagerType type);
+  void FloodedSocketDoesNotStarveOthers(UdpSocketManagerType type);
+
+  UdpSocketManagerLinux* mgr_;
+  bool started_;
+  int sender_;
+  std::vector<UdpSocketWrapper*> sockets_;
+  std::vector<Receiver*> receivers_;
+};
+
+void UdpSocketManagerTest::ReceiveOnManySockets(UdpSocketManagerType type) {
+  const int kSockets = 24;
+  const int kPackets = 20;
+  CreateManager(type, 3);
+  ASSERT_TRUE(Start());
+
+  for (int i = 0; i < kSockets; i++) {
+    ASSERT_TRUE(AddSocket());
+  }
+  for (int p = 0; p < kPackets; p++) {
+    for (int i = 0; i < kSockets; i++) {
+      Send(i, 1);
+    }
+  }
+  EXPECT_TRUE(WaitForPackets(0, kSockets - 1, kPackets));
+}
+
+void UdpSocketManagerTest::FloodedSocketDoesNotStarveOthers(
+    UdpSocketManagerType type) {
+  // Small enough to fit in the default receive buffer.
+  const int kFloodPackets = 100;
+  const int kFlooded = 0;
+  const int kQuiet = 1;
+  CreateManager(type, 1);
+  ASSERT_TRUE(AddSocket());
+  ASSERT_TRUE(AddSocket());
+  receivers_[kQuiet]->set_other(receivers_[kFlooded]);
+
+  // Both sockets are readable on the first wakeup, the flooded one first.
+  Send(kFlooded, kFloodPackets);
+  Send(kQuiet, 1);
+  ASSERT_TRUE(Start());
+
+  EXPECT_TRUE(WaitForPackets(kQuiet, kQuiet, 1));
+  EXPECT_TRUE(WaitForPackets(kFlooded, kFlooded, kFloodPackets));
+  EXPECT_GE(receivers_[kQuiet]->other_packets_at_first(), 0);
+  EXPECT_LT(receivers_[kQuiet]->other_packets_at_first(), kFloodPackets);
+}
+
+TEST_F(UdpSocketManagerTest, SelectReceivesOnManySockets) {
+  ReceiveOnManySockets(webrtc::kUdpSocketManagerSelect);
+}
+
+TEST_F(UdpSocketManagerTest, SelectFloodedSocketDoesNotStarveOthers) {
+  FloodedSocketDoesNotStarveOthers(webrtc::kUdpSocketManagerSelect);
+}
+
+#if defined(WEBRTC_LINUX)
+TEST_F(UdpSocketManagerTest, EpollReceivesOnManySockets) {
+  ReceiveOnManySockets(webrtc::kUdpSocketManagerEpoll);
+}
+
+TEST_F(UdpSocketManagerTest, EpollFloodedSocketDoesNotStarveOthers) {
+  FloodedSocketDoesNotStarveOthers(webrtc::kUdpSocketManagerEpoll);
+}
+#endif
+
+}  // namespace
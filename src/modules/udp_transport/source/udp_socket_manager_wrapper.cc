@@ -29,7 +29,8 @@
 namespace webrtc {
 UdpSocketManager* UdpSocketManager::CreateSocketManager(
     const WebRtc_Word32 id,
-    WebRtc_UWord8& numOfWorkThreads)
+    WebRtc_UWord8& numOfWorkThreads,
+    const UdpSocketManagerType type)
 {
 #if defined(_WIN32)
     #if (defined(USE_WINSOCK2))
@@ -41,7 +42,7 @@ UdpSocketManager* UdpSocketManager::CreateSocketManager(
             new UdpSocketManagerWindows(id, numOfWorkThreads));
     #endif
 #else
-    return new UdpSocketManagerLinux(id, numOfWorkThreads);
+    return new UdpSocketManagerLinux(id, numOfWorkThreads, type);
 #endif
 }
 
@@ -51,7 +52,8 @@ UdpSocketManager* UdpSocketManager::CreateSocketManager(
 UdpSocketManager* UdpSocketManager::StaticInstance(
     const UdpSocketManagerCount inc,
     const WebRtc_Word32 id,
-    WebRtc_UWord8& numOfWorkThreads)
+    WebRtc_UWord8& numOfWorkThreads,
+    const UdpSocketManagerType type)
 {
     // TODO (hellner): use atomic wrapper instead.
     static volatile long theUdpSocketManagerCount = 0;
@@ -90,7 +92,8 @@ UdpSocketManager* UdpSocketManager::StaticInstance(
     if(state == kUdpSocketManagerCreate)
     {
         theUdpSocketManager =
-            UdpSocketManager::CreateSocketManager(id, numOfWorkThreads);
+            UdpSocketManager::CreateSocketManager(id, numOfWorkThreads,
+                                                  type);
         theUdpSocketManager->Start();
         assert(theUdpSocketManager);
         return theUdpSocketManager;
@@ -144,7 +147,8 @@ UdpSocketManager* UdpSocketManager::StaticInstance(
         // local copy to the global instance. All other threads reclaim their
         // local copy.
         UdpSocketManager* newSocketMgr=
-            UdpSocketManager::CreateSocketManager(id, numOfWorkThreads);
+            UdpSocketManager::CreateSocketManager(id, numOfWorkThreads,
+                                                  type);
         if(1 == InterlockedIncrement(&theUdpSocketManagerCount))
         {
             UdpSocketManager* oldValue = (UdpSocketManager*)
@@ -189,17 +193,19 @@ UdpSocketManager* UdpSocketManager::StaticInstance(
 }
 
 UdpSocketManager* UdpSocketManager::Create(const WebRtc_Word32 id,
-                                           WebRtc_UWord8& numOfWorkThreads)
+                                           WebRtc_UWord8& numOfWorkThreads,
+                                           const UdpSocketManagerType type)
 {
     return UdpSocketManager::StaticInstance(kUdpSocketManagerInc, id,
-                                            numOfWorkThreads);
+                                            numOfWorkThreads, type);
 }
 
 void UdpSocketManager::Return()
 {
     WebRtc_UWord8 numOfWorkThreads = 0;
     UdpSocketManager::StaticInstance(kUdpSocketManagerDec, -1,
-                                     numOfWorkThreads);
+                                     numOfWorkThreads,
+                                     kUdpSocketManagerDefault);
 }
 
 UdpSocketManager::UdpSocketManager(const WebRtc_Word32 /*id*/,
@@ -29,11 +29,25 @@ enum UdpSocketManagerState
     kUdpSocketManagerDestroy = 2
 };
 
+// I/O multiplexing backend used by the socket manager work threads. Only
+// honored on Linux; other platforms always use their native implementation.
+enum UdpSocketManagerType
+{
+    // epoll where available, select() otherwise.
+    kUdpSocketManagerDefault = 0,
+    kUdpSocketManagerSelect  = 1,
+    kUdpSocketManagerEpoll   = 2
+};
+
 class UdpSocketManager
 {
 public:
-    static UdpSocketManager* Create(const WebRtc_Word32 id,
-                                    WebRtc_UWord8& numOfWorkThreads);
+    // Note that the socket manager is a singleton. |type| is only used when
+    // the first reference is created.
+    static UdpSocketManager* Create(
+        const WebRtc_Word32 id,
+        WebRtc_UWord8& numOfWorkThreads,
+        const UdpSocketManagerType type = kUdpSocketManagerDefault);
     static void Return();
 
     virtual WebRtc_Word32 ChangeUniqueId(const WebRtc_Word32 id) = 0;
@@ -63,11 +77,13 @@ private:
     // Factory method.
     static UdpSocketManager* CreateSocketManager(
         const WebRtc_Word32 id,
-        WebRtc_UWord8& numOfWorkThreads);
+        WebRtc_UWord8& numOfWorkThreads,
+        const UdpSocketManagerType type);
 
     static UdpSocketManager* StaticInstance(const UdpSocketManagerCount inc,
                                             const WebRtc_Word32 id,
-                                            WebRtc_UWord8& numOfWorkThreads);
+                                            WebRtc_UWord8& numOfWorkThreads,
+                                            const UdpSocketManagerType type);
 };
 } // namespace webrtc
 
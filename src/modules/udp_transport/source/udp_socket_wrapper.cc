@@ -157,4 +157,21 @@ bool UdpSocketWrapper::StopReceiving()
     _wantsIncoming = false;
     return true;
 }
+
+WebRtc_Word32 UdpSocketWrapper::SendToBatch(const WebRtc_Word8* const* bufs,
+                                            const WebRtc_Word32* lens,
+                                            WebRtc_Word32 count,
+                                            const SocketAddress& to)
+{
+    WebRtc_Word32 sent = 0;
+    for(WebRtc_Word32 i = 0; i < count; i++)
+    {
+        if(SendTo(bufs[i], lens[i], to) < 0)
+        {
+            break;
+        }
+        sent++;
+    }
+    return (sent == 0 && count > 0) ? -1 : sent;
+}
 } // namespace webrtc
@@ -82,6 +82,20 @@ public:
     virtual WebRtc_Word32 SendTo(const WebRtc_Word8* buf, WebRtc_Word32 len,
                                  const SocketAddress& to) = 0;
 
+    // Send count datagrams, bufs[i] of length lens[i], to the address
+    // specified by to. Returns the number of datagrams sent or -1 if none
+    // could be sent. Implementations may send all datagrams with one system
+    // call.
+    virtual WebRtc_Word32 SendToBatch(const WebRtc_Word8* const* bufs,
+                                      const WebRtc_Word32* lens,
+                                      WebRtc_Word32 count,
+                                      const SocketAddress& to);
+
+    // Read up to size datagrams per system call when the socket is
+    // readable. Returns false if batched receiving isn't supported.
+    virtual bool SetReceiveBatchSize(const WebRtc_UWord16 /*size*/)
+    {return false;}
+
     virtual void SetEventToNull();
 
     // Close socket and don't return until completed.
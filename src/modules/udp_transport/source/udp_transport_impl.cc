@@ -49,6 +49,7 @@
 #include "common_types.h"
 #include "critical_section_wrapper.h"
 #include "rw_lock_wrapper.h"
+#include "tick_util.h"
 #include "trace.h"
 #include "typedefs.h"
 #include "udp_socket_manager_wrapper.h"
@@ -139,7 +140,13 @@ UdpTransportImpl::UdpTransportImpl(const WebRtc_Word32 id,
       _filterIPAddress(),
       _rtpFilterPort(0),
       _rtcpFilterPort(0),
-      _packetCallback(0)
+      _packetCallback(0),
+      _batchSize(0),
+      _sendQueue(NULL),
+      _sendQueueLength(),
+      _sendQueueCount(0),
+      _sendQueueFirstMs(0),
+      _sendQueueError(false)
 {
     memset(&_remoteRTPAddr, 0, sizeof(_remoteRTPAddr));
     memset(&_remoteRTCPAddr, 0, sizeof(_remoteRTCPAddr));
@@ -162,6 +169,11 @@ UdpTransportImpl::UdpTransportImpl(const WebRtc_Word32 id,
 
 UdpTransportImpl::~UdpTransportImpl()
 {
+    {
+        CriticalSectionScoped cs(*_crit);
+        SendQueuedPackets();
+    }
+    delete [] _sendQueue;
     CloseSendSockets();
     CloseReceiveSockets();
     delete _crit;
@@ -231,11 +243,24 @@ WebRtc_Word32 UdpTransportImpl::Version(WebRtc_Word8* version,
 
 WebRtc_Word32 UdpTransportImpl::TimeUntilNextProcess()
 {
+    CriticalSectionScoped cs(*_crit);
+    if(_sendQueueCount > 0)
+    {
+        const WebRtc_Word64 waitMs = _sendQueueFirstMs + kMaxSendQueueDelayMs -
+            TickTime::MillisecondTimestamp();
+        return waitMs > 0 ? static_cast<WebRtc_Word32>(waitMs) : 0;
+    }
+    if(_batchSize > 1)
+    {
+        return kMaxSendQueueDelayMs;
+    }
     return 100;
 }
 
 WebRtc_Word32 UdpTransportImpl::Process()
 {
+    CriticalSectionScoped cs(*_crit);
+    SendQueuedPackets();
     return 0;
 }
 
@@ -1667,6 +1692,7 @@ WebRtc_Word32 UdpTransportImpl::StartReceiving(
         _lastError = kStartReceiveError;
         return -1;
     }
+    UpdateReceiveBatchSize();
     _receiving = true;
     return 0;
 }
@@ -1716,6 +1742,7 @@ WebRtc_Word32 UdpTransportImpl::InitializeSendSockets(
     WEBRTC_TRACE(kTraceModuleCall, kTraceTransport, _id, "%s", __FUNCTION__);
     {
         CriticalSectionScoped cs(*_crit);
+        SendQueuedPackets();
         _destPort = rtpPort;
         if(rtcpPort == 0)
         {
@@ -1799,6 +1826,7 @@ WebRtc_Word32 UdpTransportImpl::InitializeSendSockets(
             {
                 WEBRTC_TRACE(kTraceError, kTraceTransport, _id,
                              "setsockopt for multicast error on RTP socket");
+                SendQueuedPackets();
                 _ptrRtpSocket->CloseBlocking();
                 _ptrRtpSocket = NULL;
                 _lastError = kMulticastAddressInvalid;
@@ -1810,6 +1838,7 @@ WebRtc_Word32 UdpTransportImpl::InitializeSendSockets(
             {
                 WEBRTC_TRACE(kTraceError, kTraceTransport, _id,
                              "setsockopt for multicast error on RTCP socket");
+                SendQueuedPackets();
                 _ptrRtpSocket->CloseBlocking();
                 _ptrRtpSocket = NULL;
                 _lastError = kMulticastAddressInvalid;
@@ -2078,17 +2107,43 @@ int UdpTransportImpl::SendPacket(int /*channel*/, const void* data, int length)
         }
     }
 
+    if(_batchSize > 1)
+    {
+        if(length <= kMaxBatchedPacketSize)
+        {
+            const WebRtc_Word64 nowMs = TickTime::MillisecondTimestamp();
+            if(_sendQueueCount == 0)
+            {
+                _sendQueueFirstMs = nowMs;
+            }
+            memcpy(_sendQueue + _sendQueueCount * kMaxBatchedPacketSize, data,
+                   length);
+            _sendQueueLength[_sendQueueCount++] = length;
+            // Don't rely on Process() being called in time.
+            if((_sendQueueCount == _batchSize) ||
+               (nowMs - _sendQueueFirstMs >= kMaxSendQueueDelayMs))
+            {
+                SendQueuedPackets();
+            }
+            // A packet queued earlier may have failed in Process().
+            return SendQueueResult(length);
+        }
+        // Keep the packet order.
+        SendQueuedPackets();
+    }
+
+    WebRtc_Word32 retVal = -1;
     if(_ptrSendRtpSocket)
     {
-        return _ptrSendRtpSocket->SendTo((const WebRtc_Word8*)data, length,
-                                         _remoteRTPAddr);
+        retVal = _ptrSendRtpSocket->SendTo((const WebRtc_Word8*)data, length,
+                                           _remoteRTPAddr);
 
     } else if(_ptrRtpSocket)
     {
-        return _ptrRtpSocket->SendTo((const WebRtc_Word8*)data, length,
-                                     _remoteRTPAddr);
+        retVal = _ptrRtpSocket->SendTo((const WebRtc_Word8*)data, length,
+                                       _remoteRTPAddr);
     }
-    return -1;
+    return SendQueueResult(retVal);
 }
 
 int UdpTransportImpl::SendRTCPPacket(int /*channel*/, const void* data,
@@ -2165,6 +2220,7 @@ WebRtc_Word32 UdpTransportImpl::SetSendIP(const WebRtc_Word8* ipaddr)
         return kIpAddressInvalid;
     }
     CriticalSectionScoped cs(*_crit);
+    SendQueuedPackets();
     strncpy(_destIP, ipaddr,kIpAddressVersion6Length);
     BuildRemoteRTPAddr();
     BuildRemoteRTCPAddr();
@@ -2176,6 +2232,7 @@ WebRtc_Word32 UdpTransportImpl::SetSendPorts(WebRtc_UWord16 rtpPort,
 {
     WEBRTC_TRACE(kTraceModuleCall, kTraceTransport, _id, "%s", __FUNCTION__);
     CriticalSectionScoped cs(*_crit);
+    SendQueuedPackets();
     _destPort = rtpPort;
     if(rtcpPort == 0)
     {
@@ -2189,6 +2246,95 @@ WebRtc_Word32 UdpTransportImpl::SetSendPorts(WebRtc_UWord16 rtpPort,
     return 0;
 }
 
+WebRtc_Word32 UdpTransportImpl::SetBatchedIO(const WebRtc_UWord16 maxBatchSize)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceTransport, _id,
+                 "SetBatchedIO(maxBatchSize:%d)", maxBatchSize);
+
+    CriticalSectionScoped cs(*_crit);
+    SendQueuedPackets();
+    delete [] _sendQueue;
+    _sendQueue = NULL;
+
+    _batchSize = maxBatchSize;
+    if(_batchSize > kMaxBatchSize)
+    {
+        _batchSize = kMaxBatchSize;
+    }
+    if(_batchSize > 1)
+    {
+        _sendQueue = new WebRtc_Word8[_batchSize * kMaxBatchedPacketSize];
+    }
+    if(_receiving)
+    {
+        UpdateReceiveBatchSize();
+    }
+    return 0;
+}
+
+WebRtc_Word32 UdpTransportImpl::FlushSendQueue()
+{
+    CriticalSectionScoped cs(*_crit);
+    return SendQueueResult(SendQueuedPackets());
+}
+
+WebRtc_Word32 UdpTransportImpl::SendQueuedPackets()
+{
+    if(_sendQueueCount == 0)
+    {
+        return 0;
+    }
+    const WebRtc_Word8* packets[kMaxBatchSize];
+    for(WebRtc_UWord16 i = 0; i < _sendQueueCount; i++)
+    {
+        packets[i] = _sendQueue + i * kMaxBatchedPacketSize;
+    }
+    UdpSocketWrapper* socket = _ptrSendRtpSocket ? _ptrSendRtpSocket :
+        _ptrRtpSocket;
+    WebRtc_Word32 retVal = -1;
+    if(socket)
+    {
+        retVal = socket->SendToBatch(packets, _sendQueueLength,
+                                     _sendQueueCount, _remoteRTPAddr);
+    }
+    if(retVal < _sendQueueCount)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceTransport, _id,
+                     "Failed to send %d of %d queued RTP packets",
+                     _sendQueueCount - (retVal < 0 ? 0 : retVal),
+                     _sendQueueCount);
+        _sendQueueCount = 0;
+        _sendQueueError = true;
+        _lastError = kSendError;
+        return -1;
+    }
+    _sendQueueCount = 0;
+    return 0;
+}
+
+WebRtc_Word32 UdpTransportImpl::SendQueueResult(const WebRtc_Word32 retVal)
+{
+    if(_sendQueueError)
+    {
+        _sendQueueError = false;
+        return -1;
+    }
+    return retVal;
+}
+
+void UdpTransportImpl::UpdateReceiveBatchSize()
+{
+    const WebRtc_UWord16 size = _batchSize > 1 ? _batchSize : 1;
+    if(_ptrRtpSocket)
+    {
+        _ptrRtpSocket->SetReceiveBatchSize(size);
+    }
+    if(_ptrRtcpSocket)
+    {
+        _ptrRtcpSocket->SetReceiveBatchSize(size);
+    }
+}
+
 void UdpTransportImpl::IncomingRTPCallback(CallbackObj obj,
                                            const WebRtc_Word8* rtpPacket,
                                            WebRtc_Word32 rtpPacketLength,
@@ -2377,6 +2523,8 @@ bool UdpTransportImpl::FilterIPAddress(const SocketAddress* fromAddress)
 
 void UdpTransportImpl::CloseReceiveSockets()
 {
+    // The RTP receive socket also sends when there is no send socket.
+    SendQueuedPackets();
     if(_ptrRtpSocket)
     {
         _ptrRtpSocket->CloseBlocking();
@@ -2392,6 +2540,7 @@ void UdpTransportImpl::CloseReceiveSockets()
 
 void UdpTransportImpl::CloseSendSockets()
 {
+    SendQueuedPackets();
     if(_ptrSendRtpSocket)
     {
         _ptrSendRtpSocket->CloseBlocking();
@@ -22,6 +22,11 @@ class UdpSocketManager;
 class UdpTransportImpl : public UdpTransport
 {
 public:
+    // Longest time a queued RTP packet waits for the queue to fill up.
+    // SendPacket(..) sends the queue once its oldest packet is this old, and
+    // Process() is due by then.
+    enum {kMaxSendQueueDelayMs = 2};
+
     // Factory method. Constructor disabled.
     UdpTransportImpl(const WebRtc_Word32 id, WebRtc_UWord8& numSocketThreads);
     virtual ~UdpTransportImpl();
@@ -118,6 +123,9 @@ public:
     virtual WebRtc_Word32 SetSendPorts(const WebRtc_UWord16 rtpPort,
                                        const WebRtc_UWord16 rtcpPort = 0);
 
+    virtual WebRtc_Word32 SetBatchedIO(const WebRtc_UWord16 maxBatchSize);
+    virtual WebRtc_Word32 FlushSendQueue();
+
     virtual ErrorCode LastError() const;
 
     virtual WebRtc_Word32 IPAddressCached(const SocketAddress& address,
@@ -173,9 +181,21 @@ protected:
     WebRtc_Word32 DisableQoS();
 
 private:
+    enum {kMaxBatchSize = 32};
+    // RTP packets larger than this are sent directly in batched mode.
+    enum {kMaxBatchedPacketSize = 1500};
+
     void GetCachedAddress(WebRtc_Word8* ip, WebRtc_UWord32& ipSize,
                           WebRtc_UWord16& sourcePort);
 
+    // Sends the queued RTP packets. Called before the sockets or the
+    // destination change. _crit must be held.
+    WebRtc_Word32 SendQueuedPackets();
+    // Returns -1 and clears _sendQueueError if a queued packet couldn't be
+    // sent since the last call, otherwise retVal. _crit must be held.
+    WebRtc_Word32 SendQueueResult(const WebRtc_Word32 retVal);
+    void UpdateReceiveBatchSize();
+
     WebRtc_Word32 _id;
     // Protects the sockets from being re-configured while receiving packets.
     CriticalSectionWrapper* _crit;
@@ -245,6 +265,15 @@ private:
     WebRtc_UWord16 _rtcpFilterPort;
 
     UdpTransportData* _packetCallback;
+
+    // Batched I/O, see SetBatchedIO(..). Protected by _crit.
+    WebRtc_UWord16 _batchSize;
+    WebRtc_Word8* _sendQueue;
+    WebRtc_Word32 _sendQueueLength[kMaxBatchSize];
+    WebRtc_UWord16 _sendQueueCount;
+    // When the oldest queued packet was queued.
+    WebRtc_Word64 _sendQueueFirstMs;
+    bool _sendQueueError;
 };
 } // namespace webrtc
 
@@ -0,0 +1,228 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file includes unit tests for the batched send mode of
+ * UdpTransportImpl. The packets are sent on the loopback interface to a
+ * plain socket.
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "udp_transport_impl.h"
+
+namespace {
+
+using webrtc::UdpTransport;
+using webrtc::UdpTransportImpl;
+
+const int kBatchSize = 4;
+const int kPacketSize = 100;
+
+// Returns a UDP port that was free when the function was called.
+WebRtc_UWord16 FreePort() {
+  const int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  bind(fd, reinterpret_cast<sockaddr*>(&addr), len);
+  getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+  close(fd);
+  return ntohs(addr.sin_port);
+}
+
+// Returns a socket bound to a loopback port, and sets |port| to that port.
+int OpenReceiver(WebRtc_UWord16* port) {
+  const int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (fd == -1 ||
+      bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    return -1;
+  }
+  *port = ntohs(addr.sin_port);
+  timeval timeout = {1, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  return fd;
+}
+
+// Returns the first byte of the next packet on |fd|, or -1 if there is none
+// within a second.
+int ReceiveOn(int fd) {
+  WebRtc_UWord8 packet[2000];
+  if (recv(fd, packet, sizeof(packet), 0) <= 0) {
+    return -1;
+  }
+  return packet[0];
+}
+
+class UdpTransportBatchTest : public ::testing::Test {
+ protected:
+  UdpTransportBatchTest() : transport_(NULL), receiver_(-1), port_(0) {}
+
+  virtual void SetUp() {
+    receiver_ = OpenReceiver(&port_);
+    ASSERT_NE(-1, receiver_);
+
+    WebRtc_UWord8 threads = 1;
+    transport_ = new UdpTransportImpl(0, threads);
+    const WebRtc_UWord16 source_port = FreePort();
+    ASSERT_EQ(0, transport_->InitializeSourcePorts(source_port,
+                                                   FreePort()));
+    ASSERT_EQ(0, transport_->SetBatchedIO(kBatchSize));
+  }
+
+  virtual void TearDown() {
+    delete transport_;
+    close(receiver_);
+  }
+
+  // Sends a packet of |length| bytes starting with |seq|.
+  int Send(WebRtc_UWord8 seq, int length) {
+    WebRtc_UWord8 packet[2000];
+    memset(packet, seq, length);
+    return transport_->SendPacket(-1, packet, length);
+  }
+
+  // Returns the first byte of the next packet, or -1 if there is none within
+  // a second.
+  int Receive() {
+    return ReceiveOn(receiver_);
+  }
+
+  bool NothingReceived() {
+    usleep(50 * 1000);
+    WebRtc_UWord8 packet[2000];
+    return recv(receiver_, packet, sizeof(packet), MSG_DONTWAIT) < 0;
+  }
+
+  UdpTransportImpl* transport_;
+  int receiver_;
+  WebRtc_UWord16 port_;
+};
+
+TEST_F(UdpTransportBatchTest, QueuesUntilBatchIsFullOrFlushed) {
+  ASSERT_EQ(0, transport_->InitializeSendSockets("127.0.0.1", port_));
+  for (int i = 0; i < kBatchSize - 1; i++) {
+    EXPECT_EQ(kPacketSize, Send(i, kPacketSize));
+  }
+  EXPECT_TRUE(NothingReceived());
+  EXPECT_EQ(kPacketSize, Send(kBatchSize - 1, kPacketSize));
+  for (int i = 0; i < kBatchSize; i++) {
+    EXPECT_EQ(i, Receive());
+  }
+
+  EXPECT_EQ(kPacketSize, Send(10, kPacketSize));
+  EXPECT_TRUE(NothingReceived());
+  EXPECT_EQ(0, transport_->FlushSendQueue());
+  EXPECT_EQ(10, Receive());
+
+  EXPECT_EQ(kPacketSize, Send(20, kPacketSize));
+  EXPECT_EQ(0, transport_->Process());
+  EXPECT_EQ(20, Receive());
+}
+
+TEST_F(UdpTransportBatchTest, LargePacketsKeepTheOrder) {
+  ASSERT_EQ(0, transport_->InitializeSendSockets("127.0.0.1", port_));
+  EXPECT_EQ(kPacketSize, Send(1, kPacketSize));
+  EXPECT_EQ(kPacketSize, Send(2, kPacketSize));
+  EXPECT_EQ(1600, Send(3, 1600));
+  EXPECT_EQ(1, Receive());
+  EXPECT_EQ(2, Receive());
+  EXPECT_EQ(3, Receive());
+}
+
+TEST_F(UdpTransportBatchTest, DisablingSendsTheQueue) {
+  ASSERT_EQ(0, transport_->InitializeSendSockets("127.0.0.1", port_));
+  EXPECT_EQ(kPacketSize, Send(1, kPacketSize));
+  EXPECT_EQ(0, transport_->SetBatchedIO(0));
+  EXPECT_EQ(1, Receive());
+  EXPECT_EQ(kPacketSize, Send(2, kPacketSize));
+  EXPECT_EQ(2, Receive());
+}
+
+TEST_F(UdpTransportBatchTest, OldPacketsAreSentWithoutProcess) {
+  ASSERT_EQ(0, transport_->InitializeSendSockets("127.0.0.1", port_));
+  EXPECT_EQ(kPacketSize, Send(1, kPacketSize));
+  EXPECT_LE(transport_->TimeUntilNextProcess(),
+            UdpTransportImpl::kMaxSendQueueDelayMs);
+  usleep(2 * UdpTransportImpl::kMaxSendQueueDelayMs * 1000);
+  EXPECT_EQ(0, transport_->TimeUntilNextProcess());
+
+  // The next packet sends the queue even though it isn't full.
+  EXPECT_EQ(kPacketSize, Send(2, kPacketSize));
+  EXPECT_EQ(1, Receive());
+  EXPECT_EQ(2, Receive());
+  EXPECT_EQ(UdpTransportImpl::kMaxSendQueueDelayMs,
+            transport_->TimeUntilNextProcess());
+}
+
+TEST_F(UdpTransportBatchTest, QueueIsSentToTheOldDestination) {
+  ASSERT_EQ(0, transport_->InitializeSendSockets("127.0.0.1", port_));
+  EXPECT_EQ(kPacketSize, Send(1, kPacketSize));
+
+  WebRtc_UWord16 new_port = 0;
+  const int new_receiver = OpenReceiver(&new_port);
+  ASSERT_NE(-1, new_receiver);
+  ASSERT_EQ(0, transport_->InitializeSendSockets("127.0.0.1", new_port));
+  EXPECT_EQ(1, Receive());
+  EXPECT_EQ(kPacketSize, Send(2, kPacketSize));
+  EXPECT_EQ(0, transport_->FlushSendQueue());
+  EXPECT_EQ(2, ReceiveOn(new_receiver));
+  close(new_receiver);
+}
+
+TEST_F(UdpTransportBatchTest, QueueIsSentBeforeTheSocketsAreClosed) {
+  ASSERT_EQ(0, transport_->InitializeSendSockets("127.0.0.1", port_));
+  EXPECT_EQ(kPacketSize, Send(1, kPacketSize));
+  // Re-creates the sockets.
+  ASSERT_EQ(0, transport_->InitializeSourcePorts(FreePort(), FreePort()));
+  EXPECT_EQ(1, Receive());
+
+  EXPECT_EQ(kPacketSize, Send(2, kPacketSize));
+  delete transport_;
+  transport_ = NULL;
+  EXPECT_EQ(2, Receive());
+}
+
+// Broadcasts fail since SO_BROADCAST isn't set on the sockets.
+TEST_F(UdpTransportBatchTest, ReportsFailedSends) {
+  ASSERT_EQ(0, transport_->InitializeSendSockets("255.255.255.255", port_));
+
+  // A full queue that fails fails the SendPacket() call that sends it.
+  for (int i = 0; i < kBatchSize - 1; i++) {
+    EXPECT_EQ(kPacketSize, Send(i, kPacketSize));
+  }
+  EXPECT_EQ(-1, Send(kBatchSize - 1, kPacketSize));
+  EXPECT_EQ(UdpTransport::kSendError, transport_->LastError());
+  EXPECT_EQ(0, transport_->FlushSendQueue());
+
+  // A failure in Process() is returned by the next call.
+  EXPECT_EQ(kPacketSize, Send(1, kPacketSize));
+  EXPECT_EQ(0, transport_->Process());
+  EXPECT_EQ(-1, Send(2, kPacketSize));
+  EXPECT_EQ(-1, transport_->FlushSendQueue());
+  EXPECT_EQ(0, transport_->FlushSendQueue());
+}
+
+}  // namespace
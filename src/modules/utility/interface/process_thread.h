@@ -19,7 +19,11 @@ class Module;
 class ProcessThread
 {
 public:
-    static ProcessThread* CreateProcessThread();
+    // Modules registered to the returned object are divided between
+    // numberOfThreads threads. A module is always processed by the same
+    // thread.
+    static ProcessThread* CreateProcessThread(
+        const WebRtc_UWord32 numberOfThreads = 1);
     static void DestroyProcessThread(ProcessThread* module);
 
     virtual WebRtc_Word32 Start() = 0;
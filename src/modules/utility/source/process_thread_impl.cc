@@ -9,18 +9,26 @@
  */
 
 #include "process_thread_impl.h"
+
+#include <string.h> // memcpy, memset
+
 #include "module.h"
+#include "tick_util.h"
 #include "trace.h"
 
 namespace webrtc {
+enum { kMaxWaitTimeMs = 100 };
+
 ProcessThread::~ProcessThread()
 {
 }
 
-ProcessThread* ProcessThread::CreateProcessThread()
+ProcessThread* ProcessThread::CreateProcessThread(
+    const WebRtc_UWord32 numberOfThreads)
 {
-    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1, "CreateProcessThread()");
-    return new ProcessThreadImpl();
+    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
+                 "CreateProcessThread(numberOfThreads:%u)", numberOfThreads);
+    return new ProcessThreadImpl(numberOfThreads);
 }
 
 void ProcessThread::DestroyProcessThread(ProcessThread* module)
@@ -29,22 +37,159 @@ void ProcessThread::DestroyProcessThread(ProcessThread* module)
     delete module;
 }
 
-ProcessThreadImpl::ProcessThreadImpl()
+ProcessThreadImpl::ProcessThreadImpl(const WebRtc_UWord32 numberOfThreads)
+    : _critSect(*CriticalSectionWrapper::CreateCriticalSection()),
+      _shards(NULL),
+      _numberOfShards(numberOfThreads > 0 ? numberOfThreads : 1),
+      _modulesPerShard(NULL),
+      _modules(NULL),
+      _numberOfModules(0),
+      _modulesCapacity(0)
+{
+    _shards = new ProcessThreadShard[_numberOfShards];
+    _modulesPerShard = new WebRtc_UWord32[_numberOfShards];
+    memset(_modulesPerShard, 0, _numberOfShards * sizeof(WebRtc_UWord32));
+    WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s created", __FUNCTION__);
+}
+
+ProcessThreadImpl::~ProcessThreadImpl()
+{
+    delete [] _shards;
+    delete [] _modulesPerShard;
+    delete [] _modules;
+    delete &_critSect;
+    WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s deleted", __FUNCTION__);
+}
+
+// The shards are created in the constructor and synchronize Start() and
+// Stop() themselves.
+WebRtc_Word32 ProcessThreadImpl::Start()
+{
+    for(WebRtc_UWord32 i = 0; i < _numberOfShards; i++)
+    {
+        if(_shards[i].Start() != 0)
+        {
+            // Don't leave the object partially started.
+            for(WebRtc_UWord32 j = 0; j < i; j++)
+            {
+                _shards[j].Stop();
+            }
+            return -1;
+        }
+    }
+    return 0;
+}
+
+WebRtc_Word32 ProcessThreadImpl::Stop()
+{
+    WebRtc_Word32 retVal = 0;
+    for(WebRtc_UWord32 i = 0; i < _numberOfShards; i++)
+    {
+        if(_shards[i].Stop() != 0)
+        {
+            retVal = -1;
+        }
+    }
+    return retVal;
+}
+
+WebRtc_Word32 ProcessThreadImpl::RegisterModule(const Module* module)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
+                 "RegisterModule(module:0x%x)", module);
+    WebRtc_UWord32 shard = 0;
+    {
+        CriticalSectionScoped lock(_critSect);
+
+        // Only allow module to be registered once. Give it to the thread with
+        // the fewest modules.
+        if(FindModule(module) != -1)
+        {
+            return -1;
+        }
+        for(WebRtc_UWord32 i = 1; i < _numberOfShards; i++)
+        {
+            if(_modulesPerShard[i] < _modulesPerShard[shard])
+            {
+                shard = i;
+            }
+        }
+        if(_numberOfModules == _modulesCapacity)
+        {
+            const WebRtc_UWord32 newCapacity =
+                (_modulesCapacity > 0) ? 2 * _modulesCapacity : 8;
+            RegisteredModule* modules = new RegisteredModule[newCapacity];
+            if(_numberOfModules > 0)
+            {
+                memcpy(modules, _modules,
+                       _numberOfModules * sizeof(RegisteredModule));
+            }
+            delete [] _modules;
+            _modules = modules;
+            _modulesCapacity = newCapacity;
+        }
+        _modules[_numberOfModules].module = module;
+        _modules[_numberOfModules].shard = shard;
+        _numberOfModules++;
+        _modulesPerShard[shard]++;
+    }
+    return _shards[shard].RegisterModule(const_cast<Module*>(module));
+}
+
+WebRtc_Word32 ProcessThreadImpl::DeRegisterModule(const Module* module)
+{
+    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
+                 "DeRegisterModule(module:0x%x)", module);
+    WebRtc_UWord32 shard = 0;
+    {
+        CriticalSectionScoped lock(_critSect);
+
+        const WebRtc_Word32 index = FindModule(module);
+        if(index == -1)
+        {
+            return -1;
+        }
+        shard = _modules[index].shard;
+        _modules[index] = _modules[--_numberOfModules];
+        _modulesPerShard[shard]--;
+    }
+    return _shards[shard].DeRegisterModule(module);
+}
+
+WebRtc_Word32 ProcessThreadImpl::FindModule(const Module* module) const
+{
+    for(WebRtc_UWord32 i = 0; i < _numberOfModules; i++)
+    {
+        if(_modules[i].module == module)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ProcessThreadShard::ProcessThreadShard()
     : _timeEvent(*EventWrapper::Create()),
       _critSectModules(*CriticalSectionWrapper::CreateCriticalSection()),
+      _critSectProcess(*CriticalSectionWrapper::CreateCriticalSection()),
+      _processingModule(NULL),
+      _modules(NULL),
+      _numberOfModules(0),
+      _modulesCapacity(0),
       _thread(NULL)
 {
-    WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s created", __FUNCTION__);
 }
 
-ProcessThreadImpl::~ProcessThreadImpl()
+ProcessThreadShard::~ProcessThreadShard()
 {
+    Stop();
+    delete [] _modules;
     delete &_critSectModules;
+    delete &_critSectProcess;
     delete &_timeEvent;
-    WEBRTC_TRACE(kTraceMemory, kTraceUtility, -1, "%s deleted", __FUNCTION__);
 }
 
-WebRtc_Word32 ProcessThreadImpl::Start()
+WebRtc_Word32 ProcessThreadShard::Start()
 {
     CriticalSectionScoped lock(_critSectModules);
     if(_thread)
@@ -64,7 +209,7 @@ WebRtc_Word32 ProcessThreadImpl::Start()
     return -1;
 }
 
-WebRtc_Word32 ProcessThreadImpl::Stop()
+WebRtc_Word32 ProcessThreadShard::Stop()
 {
     _critSectModules.Enter();
     if(_thread)
@@ -89,84 +234,187 @@ WebRtc_Word32 ProcessThreadImpl::Stop()
     return 0;
 }
 
-WebRtc_Word32 ProcessThreadImpl::RegisterModule(const Module* module)
+WebRtc_Word32 ProcessThreadShard::RegisterModule(Module* module)
 {
-    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
-                 "RegisterModule(module:0x%x)", module);
+    const WebRtc_Word64 nextProcessTime =
+        NextProcessTime(module, TickTime::MillisecondTimestamp());
     CriticalSectionScoped lock(_critSectModules);
 
-    // Only allow module to be registered once.
-    ListItem* item = _modules.First();
-    for(WebRtc_UWord32 i = 0; i < _modules.GetSize() && item; i++)
+    if(_numberOfModules == _modulesCapacity)
     {
-        if(module == item->GetItem())
+        const WebRtc_UWord32 newCapacity =
+            (_modulesCapacity > 0) ? 2 * _modulesCapacity : 8;
+        ScheduledModule* modules = new ScheduledModule[newCapacity];
+        if(_numberOfModules > 0)
         {
-            return -1;
+            memcpy(modules, _modules,
+                   _numberOfModules * sizeof(ScheduledModule));
         }
-        item = _modules.Next(item);
+        delete [] _modules;
+        _modules = modules;
+        _modulesCapacity = newCapacity;
     }
+    _numberOfModules++;
+    Schedule(_numberOfModules - 1, module, nextProcessTime);
 
-    _modules.PushFront(module);
     WEBRTC_TRACE(kTraceInfo, kTraceUtility, -1,
                  "number of registered modules has increased to %d",
-                 _modules.GetSize());
-    // Wake the thread calling ProcessThreadImpl::Process() to update the
+                 _numberOfModules);
+    // Wake the thread calling ProcessThreadShard::Process() to update the
     // waiting time. The waiting time for the just registered module may be
     // shorter than all other registered modules.
     _timeEvent.Set();
     return 0;
 }
 
-WebRtc_Word32 ProcessThreadImpl::DeRegisterModule(const Module* module)
+WebRtc_Word32 ProcessThreadShard::DeRegisterModule(const Module* module)
 {
-    WEBRTC_TRACE(kTraceModuleCall, kTraceUtility, -1,
-                 "DeRegisterModule(module:0x%x)", module);
-    CriticalSectionScoped lock(_critSectModules);
+    bool processing = false;
+    {
+        CriticalSectionScoped lock(_critSectModules);
 
-    ListItem* item = _modules.First();
-    for(WebRtc_UWord32 i = 0; i < _modules.GetSize() && item; i++)
+        const WebRtc_Word32 index = FindModule(module);
+        if(index == -1)
+        {
+            return -1;
+        }
+        Remove(index);
+        processing = (_processingModule == module);
+        WEBRTC_TRACE(kTraceInfo, kTraceUtility, -1,
+                     "number of registered modules has decreased to %d",
+                     _numberOfModules);
+    }
+    if(processing)
     {
-        if(module == item->GetItem())
+        // Doesn't block if called from the module, on the shard's thread.
+        CriticalSectionScoped lock(_critSectProcess);
+    }
+    return 0;
+}
+
+WebRtc_Word32 ProcessThreadShard::FindModule(const Module* module) const
+{
+    for(WebRtc_UWord32 i = 0; i < _numberOfModules; i++)
+    {
+        if(_modules[i].module == module)
         {
-            int res = _modules.Erase(item);
-            WEBRTC_TRACE(kTraceInfo, kTraceUtility, -1,
-                         "number of registered modules has decreased to %d",
-                         _modules.GetSize());
-            return res;
+            return i;
         }
-        item = _modules.Next(item);
     }
     return -1;
 }
 
-bool ProcessThreadImpl::Run(void* obj)
+// Asks the module when it wants to be processed.
+WebRtc_Word64 ProcessThreadShard::NextProcessTime(Module* module,
+                                                  WebRtc_Word64 now)
+{
+    WebRtc_Word32 timeToNext = module->TimeUntilNextProcess();
+    if(timeToNext < 0)
+    {
+        timeToNext = 0;
+    }
+    // A module is asked again after at most kMaxWaitTimeMs, in case its
+    // time to next process has become shorter in the meantime.
+    if(timeToNext > kMaxWaitTimeMs)
+    {
+        timeToNext = kMaxWaitTimeMs;
+    }
+    return now + timeToNext;
+}
+
+// Moves the module at index to its new place in the heap.
+void ProcessThreadShard::Schedule(WebRtc_UWord32 index, Module* module,
+                                  WebRtc_Word64 nextProcessTime)
 {
-    return static_cast<ProcessThreadImpl*>(obj)->Process();
+    _modules[index].module = module;
+    _modules[index].nextProcessTime = nextProcessTime;
+    SiftUp(index);
+    SiftDown(index);
 }
 
-bool ProcessThreadImpl::Process()
+void ProcessThreadShard::Remove(WebRtc_UWord32 index)
+{
+    _numberOfModules--;
+    if(index == _numberOfModules)
+    {
+        return;
+    }
+    _modules[index] = _modules[_numberOfModules];
+    SiftUp(index);
+    SiftDown(index);
+}
+
+void ProcessThreadShard::SiftUp(WebRtc_UWord32 index)
+{
+    while(index > 0)
+    {
+        const WebRtc_UWord32 parent = (index - 1) / 2;
+        if(_modules[parent].nextProcessTime <= _modules[index].nextProcessTime)
+        {
+            break;
+        }
+        const ScheduledModule tmp = _modules[parent];
+        _modules[parent] = _modules[index];
+        _modules[index] = tmp;
+        index = parent;
+    }
+}
+
+void ProcessThreadShard::SiftDown(WebRtc_UWord32 index)
+{
+    for(;;)
+    {
+        WebRtc_UWord32 smallest = index;
+        const WebRtc_UWord32 left = 2 * index + 1;
+        const WebRtc_UWord32 right = left + 1;
+        if(left < _numberOfModules &&
+           _modules[left].nextProcessTime < _modules[smallest].nextProcessTime)
+        {
+            smallest = left;
+        }
+        if(right < _numberOfModules &&
+           _modules[right].nextProcessTime < _modules[smallest].nextProcessTime)
+        {
+            smallest = right;
+        }
+        if(smallest == index)
+        {
+            break;
+        }
+        const ScheduledModule tmp = _modules[smallest];
+        _modules[smallest] = _modules[index];
+        _modules[index] = tmp;
+        index = smallest;
+    }
+}
+
+bool ProcessThreadShard::Run(void* obj)
+{
+    return static_cast<ProcessThreadShard*>(obj)->Process();
+}
+
+bool ProcessThreadShard::Process()
 {
     // Wait for the module that should be called next, but don't block thread
     // longer than 100 ms.
-    WebRtc_Word32 minTimeToNext = 100;
+    WebRtc_Word64 minTimeToNext = kMaxWaitTimeMs;
     {
         CriticalSectionScoped lock(_critSectModules);
-        ListItem* item = _modules.First();
-        for(WebRtc_UWord32 i = 0; i < _modules.GetSize() && item; i++)
+        if(_numberOfModules > 0)
         {
-            WebRtc_Word32 timeToNext =
-                static_cast<Module*>(item->GetItem())->TimeUntilNextProcess();
+            const WebRtc_Word64 timeToNext = _modules[0].nextProcessTime -
+                TickTime::MillisecondTimestamp();
             if(minTimeToNext > timeToNext)
             {
                 minTimeToNext = timeToNext;
             }
-            item = _modules.Next(item);
         }
     }
 
     if(minTimeToNext > 0)
     {
-        if(kEventError == _timeEvent.Wait(minTimeToNext))
+        if(kEventError == _timeEvent.Wait(
+            static_cast<unsigned long>(minTimeToNext)))
         {
             return true;
         }
@@ -175,20 +423,38 @@ bool ProcessThreadImpl::Process()
             return false;
         }
     }
+    _critSectModules.Enter();
+    const WebRtc_Word64 now = TickTime::MillisecondTimestamp();
+    // Only the modules that are due are called, each at most once per
+    // wakeup.
+    for(WebRtc_UWord32 i = _numberOfModules;
+        i > 0 && _numberOfModules > 0 &&
+        _modules[0].nextProcessTime <= now; i--)
     {
-        CriticalSectionScoped lock(_critSectModules);
-        ListItem* item = _modules.First();
-        for(WebRtc_UWord32 i = 0; i < _modules.GetSize() && item; i++)
+        Module* module = _modules[0].module;
+        _processingModule = module;
+        // Taken before _critSectModules is released, DeRegisterModule()
+        // waits for it if it sees _processingModule.
+        _critSectProcess.Enter();
+        _critSectModules.Leave();
+
+        if(module->TimeUntilNextProcess() < 1)
         {
-            WebRtc_Word32 timeToNext =
-                static_cast<Module*>(item->GetItem())->TimeUntilNextProcess();
-            if(timeToNext < 1)
-            {
-                static_cast<Module*>(item->GetItem())->Process();
-            }
-            item = _modules.Next(item);
+            module->Process();
+        }
+        const WebRtc_Word64 nextProcessTime = NextProcessTime(module, now);
+
+        _critSectModules.Enter();
+        _critSectProcess.Leave();
+        _processingModule = NULL;
+        // Process() may have registered or deregistered modules.
+        const WebRtc_Word32 index = FindModule(module);
+        if(index != -1)
+        {
+            Schedule(index, module, nextProcessTime);
         }
     }
+    _critSectModules.Leave();
     return true;
 }
 } // namespace webrtc
@@ -13,23 +13,31 @@
 
 #include "critical_section_wrapper.h"
 #include "event_wrapper.h"
-#include "list_wrapper.h"
 #include "process_thread.h"
 #include "thread_wrapper.h"
 #include "typedefs.h"
 
 namespace webrtc {
-class ProcessThreadImpl : public ProcessThread
+class Module;
+
+// A thread processing a set of modules. The modules are kept in a min-heap
+// ordered by the time they should be processed next, so that a wakeup only
+// calls the modules that are due instead of polling all of them.
+// The modules are called without holding the lock protecting the heap, so
+// that a module may register or deregister modules of other shards.
+class ProcessThreadShard
 {
 public:
-    ProcessThreadImpl();
-    virtual ~ProcessThreadImpl();
+    ProcessThreadShard();
+    ~ProcessThreadShard();
 
-    virtual WebRtc_Word32 Start();
-    virtual WebRtc_Word32 Stop();
+    WebRtc_Word32 Start();
+    WebRtc_Word32 Stop();
 
-    virtual WebRtc_Word32 RegisterModule(const Module* module);
-    virtual WebRtc_Word32 DeRegisterModule(const Module* module);
+    WebRtc_Word32 RegisterModule(Module* module);
+    // Waits for a running Process() call of the module to return, unless
+    // called from it.
+    WebRtc_Word32 DeRegisterModule(const Module* module);
 
 protected:
     static bool Run(void* obj);
@@ -37,11 +45,64 @@ protected:
     bool Process();
 
 private:
+    struct ScheduledModule
+    {
+        WebRtc_Word64 nextProcessTime;
+        Module* module;
+    };
+
+    WebRtc_Word32 FindModule(const Module* module) const;
+    static WebRtc_Word64 NextProcessTime(Module* module, WebRtc_Word64 now);
+    void Schedule(WebRtc_UWord32 index, Module* module,
+                  WebRtc_Word64 nextProcessTime);
+    void Remove(WebRtc_UWord32 index);
+    void SiftUp(WebRtc_UWord32 index);
+    void SiftDown(WebRtc_UWord32 index);
+
     EventWrapper&           _timeEvent;
     CriticalSectionWrapper& _critSectModules;
-    ListWrapper             _modules;
+    // Held by the thread while it calls a module.
+    CriticalSectionWrapper& _critSectProcess;
+    // The module being called, protected by _critSectModules.
+    Module*                 _processingModule;
+    ScheduledModule*        _modules;
+    WebRtc_UWord32          _numberOfModules;
+    WebRtc_UWord32          _modulesCapacity;
     ThreadWrapper*          _thread;
 };
+
+class ProcessThreadImpl : public ProcessThread
+{
+public:
+    ProcessThreadImpl(const WebRtc_UWord32 numberOfThreads);
+    virtual ~ProcessThreadImpl();
+
+    virtual WebRtc_Word32 Start();
+    virtual WebRtc_Word32 Stop();
+
+    virtual WebRtc_Word32 RegisterModule(const Module* module);
+    virtual WebRtc_Word32 DeRegisterModule(const Module* module);
+
+private:
+    struct RegisteredModule
+    {
+        const Module* module;
+        WebRtc_UWord32 shard;
+    };
+
+    WebRtc_Word32 FindModule(const Module* module) const;
+
+    // Protects the assignment of modules to shards. It's never held while
+    // calling into a shard, which may be waiting for a module that
+    // registers or deregisters modules from Process().
+    CriticalSectionWrapper& _critSect;
+    ProcessThreadShard*     _shards;
+    WebRtc_UWord32          _numberOfShards;
+    WebRtc_UWord32*         _modulesPerShard;
+    RegisteredModule*       _modules;
+    WebRtc_UWord32          _numberOfModules;
+    WebRtc_UWord32          _modulesCapacity;
+};
 } // namespace webrtc
 
 #endif // WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
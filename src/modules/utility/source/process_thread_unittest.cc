@@ -0,0 +1,213 @@
+/*
+ *  Copyright (c) 2011 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file includes unit tests for the scheduling of modules and their
+ * distribution over the threads of ProcessThreadImpl.
+ */
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <set>
+
+#include "critical_section_wrapper.h"
+#include "module.h"
+#include "process_thread.h"
+#include "tick_util.h"
+
+namespace {
+
+using webrtc::CriticalSectionScoped;
+using webrtc::CriticalSectionWrapper;
+using webrtc::Module;
+using webrtc::ProcessThread;
+using webrtc::TickTime;
+
+// Wants to be processed every period_ms milliseconds. If |process_thread| is
+// set, registers and deregisters |other| in each Process() call.
+class FakeModule : public Module {
+ public:
+  explicit FakeModule(WebRtc_Word64 period_ms)
+      : crit_(CriticalSectionWrapper::CreateCriticalSection()),
+        period_ms_(period_ms),
+        last_process_ms_(TickTime::MillisecondTimestamp()),
+        calls_(0),
+        process_thread_(NULL),
+        other_(NULL) {}
+  virtual ~FakeModule() { delete crit_; }
+
+  virtual int32_t Version(char* /*version*/,
+                          uint32_t& /*remainingBufferInBytes*/,
+                          uint32_t& /*position*/) const {
+    return -1;
+  }
+  virtual int32_t ChangeUniqueId(const int32_t /*id*/) { return 0; }
+
+  virtual int32_t TimeUntilNextProcess() {
+    CriticalSectionScoped lock(*crit_);
+    return static_cast<int32_t>(
+        last_process_ms_ + period_ms_ - TickTime::MillisecondTimestamp());
+  }
+
+  virtual int32_t Process() {
+    {
+      CriticalSectionScoped lock(*crit_);
+      last_process_ms_ = TickTime::MillisecondTimestamp();
+      calls_++;
+      threads_.insert(pthread_self());
+    }
+    if (process_thread_ != NULL) {
+      process_thread_->RegisterModule(other_);
+      process_thread_->DeRegisterModule(other_);
+    }
+    return 0;
+  }
+
+  void RegisterInProcess(ProcessThread* process_thread, Module* other) {
+    process_thread_ = process_thread;
+    other_ = other;
+  }
+
+  int calls() const {
+    CriticalSectionScoped lock(*crit_);
+    return calls_;
+  }
+  void reset_calls() {
+    CriticalSectionScoped lock(*crit_);
+    calls_ = 0;
+  }
+  std::set<pthread_t> threads() const {
+    CriticalSectionScoped lock(*crit_);
+    return threads_;
+  }
+
+ private:
+  CriticalSectionWrapper* crit_;
+  const WebRtc_Word64 period_ms_;
+  WebRtc_Word64 last_process_ms_;
+  int calls_;
+  std::set<pthread_t> threads_;
+  ProcessThread* process_thread_;
+  Module* other_;
+};
+
+TEST(ProcessThreadTest, RegistersModulesOnce) {
+  ProcessThread* process_thread = ProcessThread::CreateProcessThread(2);
+  FakeModule module(10);
+  EXPECT_EQ(-1, process_thread->DeRegisterModule(&module));
+  EXPECT_EQ(0, process_thread->RegisterModule(&module));
+  EXPECT_EQ(-1, process_thread->RegisterModule(&module));
+  EXPECT_EQ(0, process_thread->DeRegisterModule(&module));
+  EXPECT_EQ(-1, process_thread->DeRegisterModule(&module));
+  ProcessThread::DestroyProcessThread(process_thread);
+}
+
+TEST(ProcessThreadTest, CallsModulesWhenDue) {
+  ProcessThread* process_thread = ProcessThread::CreateProcessThread();
+  FakeModule fast(10);
+  FakeModule slow(100);
+  FakeModule idle(10000);
+  ASSERT_EQ(0, process_thread->RegisterModule(&fast));
+  ASSERT_EQ(0, process_thread->RegisterModule(&slow));
+  ASSERT_EQ(0, process_thread->RegisterModule(&idle));
+  ASSERT_EQ(0, process_thread->Start());
+  usleep(500 * 1000);
+  EXPECT_EQ(0, process_thread->Stop());
+
+  EXPECT_GE(fast.calls(), 20);
+  EXPECT_LE(fast.calls(), 51);
+  EXPECT_GE(slow.calls(), 3);
+  EXPECT_LE(slow.calls(), 6);
+  EXPECT_EQ(0, idle.calls());
+  ProcessThread::DestroyProcessThread(process_thread);
+}
+
+TEST(ProcessThreadTest, DoesNotCallDeRegisteredModules) {
+  ProcessThread* process_thread = ProcessThread::CreateProcessThread();
+  FakeModule module(0);
+  ASSERT_EQ(0, process_thread->RegisterModule(&module));
+  ASSERT_EQ(0, process_thread->Start());
+  usleep(50 * 1000);
+  EXPECT_GT(module.calls(), 0);
+  EXPECT_EQ(0, process_thread->DeRegisterModule(&module));
+  module.reset_calls();
+  usleep(50 * 1000);
+  EXPECT_EQ(0, module.calls());
+  EXPECT_EQ(0, process_thread->Stop());
+  ProcessThread::DestroyProcessThread(process_thread);
+}
+
+TEST(ProcessThreadTest, SpreadsModulesOverThreads) {
+  const int kThreads = 3;
+  const int kModulesPerThread = 2;
+  ProcessThread* process_thread =
+      ProcessThread::CreateProcessThread(kThreads);
+  FakeModule* modules[kThreads * kModulesPerThread];
+  for (int i = 0; i < kThreads * kModulesPerThread; i++) {
+    modules[i] = new FakeModule(5);
+    ASSERT_EQ(0, process_thread->RegisterModule(modules[i]));
+  }
+  ASSERT_EQ(0, process_thread->Start());
+  usleep(100 * 1000);
+  EXPECT_EQ(0, process_thread->Stop());
+
+  std::set<pthread_t> all_threads;
+  for (int i = 0; i < kThreads * kModulesPerThread; i++) {
+    // A module is always processed by the same thread.
+    const std::set<pthread_t> threads = modules[i]->threads();
+    EXPECT_EQ(1u, threads.size());
+    all_threads.insert(threads.begin(), threads.end());
+  }
+  EXPECT_EQ(static_cast<size_t>(kThreads), all_threads.size());
+
+  for (int i = 0; i < kThreads * kModulesPerThread; i++) {
+    EXPECT_EQ(0, process_thread->DeRegisterModule(modules[i]));
+    delete modules[i];
+  }
+  ProcessThread::DestroyProcessThread(process_thread);
+}
+
+// Modules on different threads registering modules from Process(), while
+// modules are also registered from outside, must not deadlock.
+TEST(ProcessThreadTest, RegistersModulesFromProcess) {
+  ProcessThread* process_thread = ProcessThread::CreateProcessThread(2);
+  FakeModule first(1);
+  FakeModule second(1);
+  FakeModule first_other(10000);
+  FakeModule second_other(10000);
+  FakeModule outside(10000);
+  first.RegisterInProcess(process_thread, &first_other);
+  second.RegisterInProcess(process_thread, &second_other);
+  ASSERT_EQ(0, process_thread->RegisterModule(&first));
+  ASSERT_EQ(0, process_thread->RegisterModule(&second));
+  ASSERT_EQ(0, process_thread->Start());
+
+  const WebRtc_Word64 end_ms = TickTime::MillisecondTimestamp() + 300;
+  while (TickTime::MillisecondTimestamp() < end_ms) {
+    process_thread->RegisterModule(&outside);
+    process_thread->DeRegisterModule(&outside);
+    usleep(100);
+  }
+  const int first_calls = first.calls();
+  const int second_calls = second.calls();
+  usleep(50 * 1000);
+  // Don't stop the threads if they are deadlocked.
+  ASSERT_GT(first.calls(), first_calls);
+  ASSERT_GT(second.calls(), second_calls);
+
+  EXPECT_EQ(0, process_thread->Stop());
+  EXPECT_EQ(0, process_thread->DeRegisterModule(&first));
+  EXPECT_EQ(0, process_thread->DeRegisterModule(&second));
+  ProcessThread::DestroyProcessThread(process_thread);
+}
+
+}  // namespace
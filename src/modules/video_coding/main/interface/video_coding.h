@@ -474,6 +474,16 @@ public:
     //                     < 0,         on error.
     virtual WebRtc_Word32 SetRenderDelay(WebRtc_UWord32 timeMS) = 0;
 
+    // Set the maximum number of frames the jitter buffers may hold, by default
+    // 100. Can not be lowered.
+    //
+    // Input:
+    //      - maxNumberOfFrames   : Maximum number of frames.
+    //
+    // Return value      : VCM_OK, on success.
+    //                     < 0,         on error.
+    virtual WebRtc_Word32 SetMaxNumberOfFrames(WebRtc_UWord32 maxNumberOfFrames) = 0;
+
     // The total delay desired by the VCM. Can be less than the minimum
     // delay set with SetMinimumPlayoutDelay.
     //
@@ -64,6 +64,7 @@ _codec(rhs._codec)
     {
         VerifyAndAllocate(rhs._size);
         memcpy(_buffer, rhs._buffer, rhs._length);
+        _length = rhs._length;
     }
 }
 
@@ -12,12 +12,24 @@
 #include "frame_buffer.h"
 #include "jitter_buffer.h"
 #include <cstdlib>
+#include <string.h>
 
 namespace webrtc {
 
+VCMFrameListTimestampOrderAsc::VCMFrameListTimestampOrderAsc()
+:
+ListWrapper(),
+_index(NULL),
+_indexSize(0),
+_indexBits(0),
+_indexCount(0)
+{
+}
+
 VCMFrameListTimestampOrderAsc::~VCMFrameListTimestampOrderAsc()
 {
     Flush();
+    delete [] _index;
 }
 
 void
@@ -26,40 +38,82 @@ VCMFrameListTimestampOrderAsc::Flush()
     while(Erase(First()) != -1) { }
 }
 
+WebRtc_Word32
+VCMFrameListTimestampOrderAsc::SetCapacity(WebRtc_UWord32 maxNumberOfFrames)
+{
+    WebRtc_UWord32 bits = 1;
+    while ((1u << bits) < 2 * maxNumberOfFrames)
+    {
+        bits++;
+    }
+    if ((1u << bits) == _indexSize)
+    {
+        return 0;
+    }
+    delete [] _index;
+    _indexBits = bits;
+    _indexSize = 1u << bits;
+    _indexCount = 0;
+    _index = new VCMFrameListItem*[_indexSize];
+    memset(_index, 0, _indexSize * sizeof(VCMFrameListItem*));
+    for (VCMFrameListItem* item = First(); item != NULL; item = Next(item))
+    {
+        IndexInsert(item);
+    }
+    return 0;
+}
+
 // Inserts frame in timestamp order, with the oldest timestamp first. Takes wrap arounds into account
 WebRtc_Word32
 VCMFrameListTimestampOrderAsc::Insert(VCMFrameBuffer* frame)
 {
-    VCMFrameListItem* item = static_cast<VCMFrameListItem*>(First());
     VCMFrameListItem* newItem = new VCMFrameListItem(frame);
-    bool inserted = false;
     if (newItem == NULL)
     {
         return -1;
     }
+    // New frames are usually the newest, search from the back for the first
+    // frame which is older.
+    VCMFrameListItem* item = Last();
     while (item != NULL)
     {
         const WebRtc_UWord32 itemTimestamp = item->GetItem()->TimeStamp();
-        if (VCMJitterBuffer::LatestTimestamp(itemTimestamp, frame->TimeStamp()) == itemTimestamp)
+        if (itemTimestamp != frame->TimeStamp() &&
+            VCMJitterBuffer::LatestTimestamp(itemTimestamp, frame->TimeStamp()) == frame->TimeStamp())
         {
-            if (InsertBefore(item, newItem) < 0)
-            {
-                delete newItem;
-                return -1;
-            }
-            inserted = true;
             break;
         }
-        item = Next(item);
+        item = Previous(item);
+    }
+    WebRtc_Word32 ret;
+    if (item != NULL)
+    {
+        ret = ListWrapper::Insert(item, newItem);
+    }
+    else
+    {
+        ret = InsertBefore(First(), newItem);
     }
-    if (!inserted && ListWrapper::Insert(ListWrapper::Last(), newItem) < 0)
+    if (ret < 0)
     {
         delete newItem;
         return -1;
     }
+    IndexInsert(newItem);
     return 0;
 }
 
+WebRtc_Word32
+VCMFrameListTimestampOrderAsc::Erase(VCMFrameListItem* item)
+{
+    if (item == NULL)
+    {
+        return -1;
+    }
+    IndexErase(item);
+    return ListWrapper::Erase(item);
+}
+
 VCMFrameBuffer*
 VCMFrameListTimestampOrderAsc::FirstFrame() const
 {
@@ -96,6 +150,107 @@ VCMFrameListTimestampOrderAsc::FindFrameListItem(FindFrameCriteria criteria,
     return NULL;
 }
 
+VCMFrameBuffer*
+VCMFrameListTimestampOrderAsc::FindFrameByTimestamp(WebRtc_UWord32 timestamp) const
+{
+    if (_index == NULL)
+    {
+        for (VCMFrameListItem* item = First(); item != NULL; item = Next(item))
+        {
+            if (item->GetItem()->TimeStamp() == timestamp)
+            {
+                return item->GetItem();
+            }
+        }
+        return NULL;
+    }
+    const WebRtc_UWord32 mask = _indexSize - 1;
+    for (WebRtc_UWord32 i = IndexSlot(timestamp); _index[i] != NULL;
+         i = (i + 1) & mask)
+    {
+        if (_index[i]->_indexedTimestamp == timestamp &&
+            _index[i]->GetItem()->TimeStamp() == timestamp)
+        {
+            return _index[i]->GetItem();
+        }
+    }
+    return NULL;
+}
+
+WebRtc_UWord32
+VCMFrameListTimestampOrderAsc::IndexSlot(WebRtc_UWord32 timestamp) const
+{
+    // Fibonacci hashing, timestamps of consecutive frames differ by a
+    // constant step.
+    return (timestamp * 2654435761u) >> (32 - _indexBits);
+}
+
+void
+VCMFrameListTimestampOrderAsc::IndexInsert(VCMFrameListItem* item)
+{
+    if (_index == NULL || 2 * (_indexCount + 1) > _indexSize)
+    {
+        // Never happens as long as the list holds at most the number of
+        // frames given to SetCapacity(). Fall back to searching the list.
+        delete [] _index;
+        _index = NULL;
+        _indexSize = 0;
+        _indexCount = 0;
+        return;
+    }
+    const WebRtc_UWord32 mask = _indexSize - 1;
+    item->_indexedTimestamp = item->GetItem()->TimeStamp();
+    WebRtc_UWord32 i = IndexSlot(item->_indexedTimestamp);
+    while (_index[i] != NULL)
+    {
+        i = (i + 1) & mask;
+    }
+    _index[i] = item;
+    _indexCount++;
+}
+
+void
+VCMFrameListTimestampOrderAsc::IndexErase(VCMFrameListItem* item)
+{
+    if (_index == NULL)
+    {
+        return;
+    }
+    const WebRtc_UWord32 mask = _indexSize - 1;
+    WebRtc_UWord32 i = IndexSlot(item->_indexedTimestamp);
+    while (_index[i] != item)
+    {
+        if (_index[i] == NULL)
+        {
+            // Not indexed.
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    _index[i] = NULL;
+    _indexCount--;
+    // Shift back the entries following the removed one which would otherwise
+    // no longer be reachable from their home slot.
+    WebRtc_UWord32 j = i;
+    while (true)
+    {
+        j = (j + 1) & mask;
+        if (_index[j] == NULL)
+        {
+            break;
+        }
+        const WebRtc_UWord32 k = IndexSlot(_index[j]->_indexedTimestamp);
+        const bool inRange = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+        if (inRange)
+        {
+            continue;
+        }
+        _index[i] = _index[j];
+        _index[j] = NULL;
+        i = j;
+    }
+}
+
 VCMFrameBuffer*
 VCMFrameListTimestampOrderAsc::FindFrame(FindFrameCriteria criteria,
                                          const void* compareWith,
@@ -26,24 +26,35 @@ class VCMFrameListItem : public ListItem
 {
     friend class VCMFrameListTimestampOrderAsc;
 public:
-    VCMFrameListItem(const VCMFrameBuffer* ptr) : ListItem(ptr) {}
+    VCMFrameListItem(const VCMFrameBuffer* ptr)
+        : ListItem(ptr), _indexedTimestamp(0) {}
     ~VCMFrameListItem() {};
 
     VCMFrameBuffer* GetItem() const
             { return static_cast<VCMFrameBuffer*>(ListItem::GetItem()); }
+
+private:
+    // Timestamp of the frame when it was added to the index. The frame
+    // timestamp may change while it's in the list, e.g. when it's reset.
+    WebRtc_UWord32 _indexedTimestamp;
 };
 
 class VCMFrameListTimestampOrderAsc : public ListWrapper
 {
 public:
-    VCMFrameListTimestampOrderAsc() : ListWrapper() {};
+    VCMFrameListTimestampOrderAsc();
     ~VCMFrameListTimestampOrderAsc();
 
     void Flush();
 
+    // Sizes the timestamp index for up to maxNumberOfFrames frames. Until
+    // this is called FindFrameByTimestamp() searches the list.
+    WebRtc_Word32 SetCapacity(WebRtc_UWord32 maxNumberOfFrames);
+
     // Inserts frame in timestamp order, with the oldest timestamp first.
     // Takes wrap arounds into account.
     WebRtc_Word32 Insert(VCMFrameBuffer* frame);
+    WebRtc_Word32 Erase(VCMFrameListItem* item);
     VCMFrameBuffer* FirstFrame() const;
     VCMFrameListItem* Next(VCMFrameListItem* item) const
             { return static_cast<VCMFrameListItem*>(ListWrapper::Next(item)); }
@@ -59,6 +70,21 @@ public:
     VCMFrameBuffer* FindFrame(FindFrameCriteria criteria,
                                              const void* compareWith = NULL,
                                              VCMFrameListItem* startItem = NULL) const;
+    // Constant time lookup of the frame with the given timestamp.
+    VCMFrameBuffer* FindFrameByTimestamp(WebRtc_UWord32 timestamp) const;
+
+private:
+    WebRtc_UWord32 IndexSlot(WebRtc_UWord32 timestamp) const;
+    void IndexInsert(VCMFrameListItem* item);
+    void IndexErase(VCMFrameListItem* item);
+
+    // Open addressing (linear probing) hash table from frame timestamp to
+    // list item. _indexSize is a power of two and at least twice the number
+    // of frames.
+    VCMFrameListItem**      _index;
+    WebRtc_UWord32          _indexSize;
+    WebRtc_UWord32          _indexBits;
+    WebRtc_UWord32          _indexCount;
 };
 
 } // namespace webrtc
@@ -36,17 +36,6 @@
 namespace webrtc {
 
 // Criteria used when searching for frames in the frame buffer list
-bool
-VCMJitterBuffer::FrameEqualTimestamp(VCMFrameBuffer* frame,
-                                     const void* timestamp)
-{
-    if (timestamp == NULL)
-    {
-        return false;
-    }
-    return (*static_cast<const WebRtc_UWord32*>(timestamp)) == frame->TimeStamp();
-}
-
 bool
 VCMJitterBuffer::CompleteDecodableKeyFrameCriteria(VCMFrameBuffer* frame,
                                                    const void* /*notUsed*/)
@@ -69,7 +58,10 @@ VCMJitterBuffer::VCMJitterBuffer(WebRtc_Word32 vcmId, WebRtc_Word32 receiverId,
     _frameEvent(),
     _packetEvent(),
     _maxNumberOfFrames(kStartNumberOfFrames),
-    _frameBuffers(),
+    _frameBufferCapacity(0),
+    _frameBuffers(NULL),
+    _freeFrameBuffers(NULL),
+    _numberOfFreeFrames(0),
     _frameBuffersTSOrder(),
     _lastDecodedSeqNum(),
     _lastDecodedTimeStamp(-1),
@@ -89,14 +81,15 @@ VCMJitterBuffer::VCMJitterBuffer(WebRtc_Word32 vcmId, WebRtc_Word32 receiverId,
     _missingMarkerBits(false),
     _firstPacket(true)
 {
-    memset(_frameBuffers, 0, sizeof(_frameBuffers));
     memset(_receiveStatistics, 0, sizeof(_receiveStatistics));
     _lastDecodedSeqNum = -1;
     memset(_NACKSeqNumInternal, -1, sizeof(_NACKSeqNumInternal));
 
+    ResizeFrameArrays(kMaxNumberOfFrames);
     for (int i = 0; i< kStartNumberOfFrames; i++)
     {
         _frameBuffers[i] = new VCMFrameBuffer();
+        _freeFrameBuffers[_numberOfFreeFrames++] = _frameBuffers[i];
     }
 }
 
@@ -104,13 +97,12 @@ VCMJitterBuffer::VCMJitterBuffer(WebRtc_Word32 vcmId, WebRtc_Word32 receiverId,
 VCMJitterBuffer::~VCMJitterBuffer()
 {
     Stop();
-    for (int i = 0; i< kMaxNumberOfFrames; i++)
+    for (int i = 0; i< _maxNumberOfFrames; i++)
     {
-        if (_frameBuffers[i])
-        {
-            delete _frameBuffers[i];
-        }
+        delete _frameBuffers[i];
     }
+    delete [] _frameBuffers;
+    delete [] _freeFrameBuffers;
     delete &_critSect;
 }
 
@@ -125,7 +117,6 @@ VCMJitterBuffer::operator=(const VCMJitterBuffer& rhs)
         _receiverId = rhs._receiverId;
         _running = rhs._running;
         _master = !rhs._master;
-        _maxNumberOfFrames = rhs._maxNumberOfFrames;
         _lastDecodedTimeStamp = rhs._lastDecodedTimeStamp;
         _incomingFrameRate = rhs._incomingFrameRate;
         _incomingFrameCount = rhs._incomingFrameCount;
@@ -148,23 +139,29 @@ VCMJitterBuffer::operator=(const VCMJitterBuffer& rhs)
         memcpy(_NACKSeqNumInternal, rhs._NACKSeqNumInternal,
                sizeof(_NACKSeqNumInternal));
         memcpy(_NACKSeqNum, rhs._NACKSeqNum, sizeof(_NACKSeqNum));
-        for (int i = 0; i < kMaxNumberOfFrames; i++)
-        {
-            if (_frameBuffers[i] != NULL)
-            {
-                delete _frameBuffers[i];
-                _frameBuffers[i] = NULL;
-            }
-        }
         while(_frameBuffersTSOrder.Erase(_frameBuffersTSOrder.First()) != -1)
         { }
         for (int i = 0; i < _maxNumberOfFrames; i++)
+        {
+            delete _frameBuffers[i];
+            _frameBuffers[i] = NULL;
+        }
+        // Nothing to keep when resizing.
+        _maxNumberOfFrames = 0;
+        _numberOfFreeFrames = 0;
+        ResizeFrameArrays(rhs._frameBufferCapacity);
+        _maxNumberOfFrames = rhs._maxNumberOfFrames;
+        for (int i = 0; i < _maxNumberOfFrames; i++)
         {
             _frameBuffers[i] = new VCMFrameBuffer(*(rhs._frameBuffers[i]));
             if (_frameBuffers[i]->Length() > 0)
             {
                 _frameBuffersTSOrder.Insert(_frameBuffers[i]);
             }
+            if (_frameBuffers[i]->GetState() == kStateFree)
+            {
+                _freeFrameBuffers[_numberOfFreeFrames++] = _frameBuffers[i];
+            }
         }
         rhs._critSect.Leave();
         _critSect.Leave();
@@ -235,12 +232,9 @@ VCMJitterBuffer::Stop()
     _lastDecodedTimeStamp = -1;
     _lastDecodedSeqNum = -1;
     _frameBuffersTSOrder.Flush();
-    for (int i = 0; i < kMaxNumberOfFrames; i++)
+    for (int i = 0; i < _maxNumberOfFrames; i++)
     {
-        if (_frameBuffers[i] != NULL)
-        {
-            static_cast<VCMFrameBuffer*>(_frameBuffers[i])->SetState(kStateFree);
-        }
+        ReleaseFrameInternal(_frameBuffers[i]);
     }
 
     _critSect.Leave();
@@ -265,6 +259,45 @@ VCMJitterBuffer::Flush()
     FlushInternal();
 }
 
+WebRtc_Word32
+VCMJitterBuffer::SetMaxNumberOfFrames(WebRtc_Word32 maxNumberOfFrames)
+{
+    CriticalSectionScoped cs(_critSect);
+    if (maxNumberOfFrames < _maxNumberOfFrames ||
+        maxNumberOfFrames < kStartNumberOfFrames)
+    {
+        return VCM_PARAMETER_ERROR;
+    }
+    ResizeFrameArrays(maxNumberOfFrames);
+    return VCM_OK;
+}
+
+// Must be called under the critical section _critSect.
+void
+VCMJitterBuffer::ResizeFrameArrays(WebRtc_Word32 capacity)
+{
+    if (capacity == _frameBufferCapacity)
+    {
+        return;
+    }
+    VCMFrameBuffer** frameBuffers = new VCMFrameBuffer*[capacity];
+    VCMFrameBuffer** freeFrameBuffers = new VCMFrameBuffer*[capacity];
+    memset(frameBuffers, 0, capacity * sizeof(VCMFrameBuffer*));
+    if (_frameBuffers != NULL)
+    {
+        memcpy(frameBuffers, _frameBuffers,
+               _maxNumberOfFrames * sizeof(VCMFrameBuffer*));
+        memcpy(freeFrameBuffers, _freeFrameBuffers,
+               _numberOfFreeFrames * sizeof(VCMFrameBuffer*));
+    }
+    delete [] _frameBuffers;
+    delete [] _freeFrameBuffers;
+    _frameBuffers = frameBuffers;
+    _freeFrameBuffers = freeFrameBuffers;
+    _frameBufferCapacity = capacity;
+    _frameBuffersTSOrder.SetCapacity(capacity);
+}
+
 // Must be called under the critical section _critSect
 void
 VCMJitterBuffer::FlushInternal()
@@ -306,9 +339,10 @@ VCMJitterBuffer::FlushInternal()
 void
 VCMJitterBuffer::ReleaseFrameInternal(VCMFrameBuffer* frame)
 {
-    if (frame != NULL)
+    if (frame != NULL && frame->GetState() != kStateFree)
     {
         frame->SetState(kStateFree);
+        _freeFrameBuffers[_numberOfFreeFrames++] = frame;
     }
 }
 
@@ -464,8 +498,7 @@ VCMJitterBuffer::GetFrame(const VCMPacket& packet, VCMEncodedFrame*& frame)
     }
     _numConsecutiveOldPackets = 0;
 
-    frame = _frameBuffersTSOrder.FindFrame(FrameEqualTimestamp,
-                                           &packet.timestamp);
+    frame = _frameBuffersTSOrder.FindFrameByTimestamp(packet.timestamp);
 
     _critSect.Leave();
 
@@ -516,19 +549,17 @@ VCMJitterBuffer::GetEmptyFrame()
 
     _critSect.Enter();
 
-    for (int i = 0; i <_maxNumberOfFrames; ++i)
+    if (_numberOfFreeFrames > 0)
     {
-        if (kStateFree == _frameBuffers[i]->GetState())
-        {
-            // found a free buffer
-            _frameBuffers[i]->SetState(kStateEmpty);
-            _critSect.Leave();
-            return _frameBuffers[i];
-        }
+        // found a free buffer
+        VCMFrameBuffer* frame = _freeFrameBuffers[--_numberOfFreeFrames];
+        frame->SetState(kStateEmpty);
+        _critSect.Leave();
+        return frame;
     }
 
     // Check if we can increase JB size
-    if (_maxNumberOfFrames < kMaxNumberOfFrames)
+    if (_maxNumberOfFrames < _frameBufferCapacity)
     {
         VCMFrameBuffer* ptrNewBuffer = new VCMFrameBuffer();
         ptrNewBuffer->SetState(kStateEmpty);
@@ -64,6 +64,11 @@ public:
     // Empty the Jitter buffer of all its data
     void Flush();
 
+    // Set the maximum number of frames the jitter buffer may allocate, by
+    // default kMaxNumberOfFrames. Can not be lower than the number of frames
+    // already allocated.
+    WebRtc_Word32 SetMaxNumberOfFrames(WebRtc_Word32 maxNumberOfFrames);
+
     // Statistics, Get received key and delta frames
     WebRtc_Word32 GetFrameStatistics(WebRtc_UWord32& receivedDeltaFrames,
                                      WebRtc_UWord32& receivedKeyFrames) const;
@@ -130,6 +135,8 @@ protected:
     // Recycle (release) frame, used if we didn't receive whole frame
     void RecycleFrame(VCMFrameBuffer* frame);
     void ReleaseFrameInternal(VCMFrameBuffer* frame);
+    // Reallocate the frame arrays to hold capacity frames.
+    void ResizeFrameArrays(WebRtc_Word32 capacity);
     // Flush and reset the jitter buffer. Call under critical section.
     void FlushInternal();
     VCMFrameListItem* FindOldestSequenceNum() const;
@@ -177,8 +184,6 @@ protected:
 
 private:
 
-    static bool FrameEqualTimestamp(VCMFrameBuffer* frame,
-                                    const void* timestamp);
     static bool CompleteDecodableKeyFrameCriteria(VCMFrameBuffer* frame,
                                                   const void* notUsed);
     // Decide whether should wait for NACK (mainly relevant for hybrid mode)
@@ -196,8 +201,13 @@ private:
     VCMEvent                      _packetEvent;
     // Number of allocated frames
     WebRtc_Word32                 _maxNumberOfFrames;
-    // Array of pointers to the frames in JB
-    VCMFrameBuffer*               _frameBuffers[kMaxNumberOfFrames];
+    // Maximum number of frames that may be allocated
+    WebRtc_Word32                 _frameBufferCapacity;
+    // Array of pointers to the frames in JB, _frameBufferCapacity long
+    VCMFrameBuffer**              _frameBuffers;
+    // Stack of the allocated frames in state kStateFree
+    VCMFrameBuffer**              _freeFrameBuffers;
+    WebRtc_Word32                 _numberOfFreeFrames;
     VCMFrameListTimestampOrderAsc _frameBuffersTSOrder;
 
     // timing
@@ -14,7 +14,7 @@
 namespace webrtc
 {
 
-enum { kMaxNumberOfFrames     = 100 };
+enum { kMaxNumberOfFrames     = 100 };  // default, see SetMaxNumberOfFrames()
 enum { kStartNumberOfFrames   = 6 };    // in packets, 6 packets are approximately 198 ms,
                                         // we need at least one more for process
 enum { kMaxVideoDelayMs       = 2000 }; // in ms
@@ -345,6 +345,17 @@ VCMReceiver::ReceivedFrameCount(VCMFrameCount& frameCount) const
                                             frameCount.numKeyFrames);
 }
 
+WebRtc_Word32
+VCMReceiver::SetMaxNumberOfFrames(WebRtc_UWord32 maxNumberOfFrames)
+{
+    if (maxNumberOfFrames > 0x7fffffff)
+    {
+        return VCM_PARAMETER_ERROR;
+    }
+    return _jitterBuffer.SetMaxNumberOfFrames(
+        static_cast<WebRtc_Word32>(maxNumberOfFrames));
+}
+
 void
 VCMReceiver::SetNackMode(VCMNackMode nackMode)
 {
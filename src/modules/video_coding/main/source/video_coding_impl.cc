@@ -1285,6 +1285,21 @@ VideoCodingModuleImpl::SetRenderDelay(WebRtc_UWord32 timeMS)
     return VCM_OK;
 }
 
+// The maximum number of frames in the jitter buffers, defaults to
+// kMaxNumberOfFrames = 100
+WebRtc_Word32
+VideoCodingModuleImpl::SetMaxNumberOfFrames(WebRtc_UWord32 maxNumberOfFrames)
+{
+    WEBRTC_TRACE(webrtc::kTraceModuleCall, webrtc::kTraceVideoCoding, VCMId(_id),
+               "SetMaxNumberOfFrames(%u)", maxNumberOfFrames);
+    WebRtc_Word32 ret = _receiver.SetMaxNumberOfFrames(maxNumberOfFrames);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    return _dualReceiver.SetMaxNumberOfFrames(maxNumberOfFrames);
+}
+
 // Current video delay
 WebRtc_Word32
 VideoCodingModuleImpl::Delay() const
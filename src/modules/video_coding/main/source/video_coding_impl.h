@@ -222,6 +222,9 @@ public:
     // The estimated delay caused by rendering
     virtual WebRtc_Word32 SetRenderDelay(WebRtc_UWord32 timeMS);
 
+    // Maximum number of frames in the jitter buffers
+    virtual WebRtc_Word32 SetMaxNumberOfFrames(WebRtc_UWord32 maxNumberOfFrames);
+
     // Current delay
     virtual WebRtc_Word32 Delay() const;
 
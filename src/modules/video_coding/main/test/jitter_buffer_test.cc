@@ -123,6 +123,55 @@ int JitterBufferTest(CmdArgs& args)
 
     //printf("DONE timestamp ordered frame list\n");
 
+    // Frames found through the timestamp index, with a wrap in timestamp
+    TEST(frameList.SetCapacity(100) == 0);
+    VCMFrameBuffer* indexedFrames[100];
+    for (i = 0; i < 100; i++)
+    {
+        fb = new VCMFrameBuffer();
+        fb->SetState(kStateEmpty);
+        packet.timestamp = 0xffffffff - 50 * 3000 + i * 3000;
+        packet.seqNum = seqNum;
+        seqNum++;
+        fb->InsertPacket(packet, VCMTickTime::MillisecondTimestamp());
+        TEST(frameList.Insert(fb) == 0);
+        indexedFrames[i] = fb;
+    }
+    for (i = 0; i < 100; i++)
+    {
+        TEST(frameList.FindFrameByTimestamp(indexedFrames[i]->TimeStamp()) ==
+             indexedFrames[i]);
+    }
+    TEST(frameList.FindFrameByTimestamp(indexedFrames[0]->TimeStamp() - 3000) ==
+         NULL);
+    TEST(frameList.FindFrameByTimestamp(indexedFrames[0]->TimeStamp() + 1) ==
+         NULL);
+    // Erase every other frame, the remaining ones must still be found
+    item = frameList.First();
+    for (i = 0; i < 100; i++)
+    {
+        VCMFrameListItem* nextItem = frameList.Next(item);
+        if (i % 2 == 0)
+        {
+            frameList.Erase(item);
+        }
+        item = nextItem;
+    }
+    for (i = 0; i < 100; i++)
+    {
+        fb = frameList.FindFrameByTimestamp(indexedFrames[i]->TimeStamp());
+        TEST(fb == (i % 2 == 0 ? NULL : indexedFrames[i]));
+    }
+    frameList.Flush();
+    for (i = 0; i < 100; i++)
+    {
+        TEST(frameList.FindFrameByTimestamp(indexedFrames[i]->TimeStamp()) ==
+             NULL);
+        delete indexedFrames[i];
+    }
+
+    //printf("DONE timestamp index\n");
+
     VCMJitterBuffer jb;
 
     seqNum = 1234;
@@ -2240,6 +2289,63 @@ int JitterBufferTest(CmdArgs& args)
     frameOut = jb.GetFrameForDecoding();
     TEST(frameOut != NULL);
 
+    //
+    // TEST fill a JB with a raised max number of frames and copy it
+    //
+
+    VCMJitterBuffer largeJb;
+    const int maxNumberOfFrames = 2 * kMaxNumberOfFrames;
+    TEST(largeJb.SetMaxNumberOfFrames(kStartNumberOfFrames - 1) < 0);
+    TEST(largeJb.SetMaxNumberOfFrames(maxNumberOfFrames) == 0);
+    largeJb.Start();
+
+    seqNum = 10;
+    timeStamp = 33 * 90;
+    timeStampStart = timeStamp;
+    packet.codec = kVideoCodecUnknown;
+    packet.bits = false;
+    packet.isFirstPacket = true;
+    packet.markerBit = true;
+    packet.frameType = kVideoFrameKey;
+    for (loop = 0; loop < maxNumberOfFrames; loop++)
+    {
+        packet.seqNum = seqNum++;
+        packet.timestamp = timeStamp;
+        timeStamp += 33 * 90;
+
+        frameIn = largeJb.GetFrame(packet);
+        TEST(frameIn != 0);
+        TEST(kFirstPacket == largeJb.InsertPacket(frameIn, packet));
+        TEST(timeStampStart == largeJb.GetNextTimeStamp(10, incomingFrameType,
+                                                        renderTimeMs));
+        packet.frameType = kVideoFrameDelta;
+    }
+    // Can't be lowered below the number of allocated frames
+    TEST(largeJb.SetMaxNumberOfFrames(kMaxNumberOfFrames) < 0);
+
+    // The copy holds the same frames, in the same order
+    VCMJitterBuffer copyJb;
+    copyJb = largeJb;
+    timeStamp = timeStampStart;
+    for (loop = 0; loop < maxNumberOfFrames; loop++)
+    {
+        frameOut = copyJb.GetCompleteFrameForDecoding(0);
+        TEST(frameOut != NULL);
+        if (frameOut == NULL)
+        {
+            break;
+        }
+        TEST(frameOut->TimeStamp() == timeStamp);
+        CheckOutFrame(frameOut, size, false);
+        copyJb.ReleaseFrame(frameOut);
+        timeStamp += 33 * 90;
+    }
+    TEST(copyJb.GetCompleteFrameForDecoding(0) == NULL);
+    copyJb.Stop();
+    largeJb.Stop();
+
+    //printf("DONE fill JB - raised max number of frames\n");
+
     // ---
     jb.Stop();
 
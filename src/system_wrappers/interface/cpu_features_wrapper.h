@@ -18,7 +18,8 @@ extern "C" {
 // list of features.
 typedef enum {
   kSSE2,
-  kSSE3
+  kSSE3,
+  kNEON
 } CPUFeature;
 
 typedef int (*WebRtc_CPUInfo)(CPUFeature feature);
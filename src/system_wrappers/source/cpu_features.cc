@@ -10,6 +10,11 @@
 
 #include "cpu_features_wrapper.h"
 
+#if defined(__arm__) && defined(WEBRTC_LINUX)
+#include <stdio.h>
+#include <string.h>
+#endif
+
 // No CPU feature is available => straight C path.
 int GetCPUInfoNoASM(CPUFeature feature) {
   (void)feature;
@@ -48,6 +53,36 @@ static int GetCPUInfo(CPUFeature feature) {
   }
   return 0;
 }
+#elif defined(__arm__) && defined(WEBRTC_LINUX)
+// Looks for "neon" among the features listed in /proc/cpuinfo.
+static int HasNEON() {
+  int neon = 0;
+  char line[512];
+  FILE* f = fopen("/proc/cpuinfo", "r");
+  if (f == NULL) {
+    return 0;
+  }
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (strncmp(line, "Features", 8) == 0) {
+      neon = (strstr(line, " neon") != NULL);
+      break;
+    }
+  }
+  fclose(f);
+  return neon;
+}
+
+// Actual feature detection for ARM.
+static int GetCPUInfo(CPUFeature feature) {
+  static int neon = -1;
+  if (feature != kNEON) {
+    return 0;
+  }
+  if (neon < 0) {
+    neon = HasNEON();
+  }
+  return neon;
+}
 #else
 // Default to straight C for other platforms.
 static int GetCPUInfo(CPUFeature feature) {
@@ -212,27 +212,21 @@ TraceImpl::TraceImpl()
       _thread(*ThreadWrapper::CreateThread(TraceImpl::Run, this,
                                            kHighestPriority, "Trace")),
       _event(*EventWrapper::Create()),
-      _critsectArray(*CriticalSectionWrapper::CreateCriticalSection()),
-      _nextFreeIdx(),
-      _level(),
-      _length(),
-      _messageQueue(),
-      _activeQueue(0)
+      _ring(new TraceSlot[WEBRTC_TRACE_MAX_QUEUE]),
+      _writePos(0),
+      _readPos(0),
+      _droppedMessages(0),
+      _wakeUpPending(0),
+      _prevAPITickCount(0),
+      _prevTickCount(0)
 {
-    _nextFreeIdx[0] = 0;
-    _nextFreeIdx[1] = 0;
+    for(int n = 0; n < WEBRTC_TRACE_MAX_QUEUE; n++)
+    {
+        _ring[n].sequence = n;
+    }
 
     unsigned int tid = 0;
     _thread.Start(tid);
-
-    for(int m = 0; m < WEBRTC_TRACE_NUM_ARRAY; m++)
-    {
-        for(int n = 0; n < WEBRTC_TRACE_MAX_QUEUE; n++)
-        {
-            _messageQueue[m][n] = new
-                WebRtc_Word8[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
-        }
-    }
 }
 
 bool TraceImpl::StopThread()
@@ -272,15 +266,7 @@ TraceImpl::~TraceImpl()
     delete &_traceFile;
     delete &_thread;
     delete &_critsectInterface;
-    delete &_critsectArray;
-
-    for(int m = 0; m < WEBRTC_TRACE_NUM_ARRAY; m++)
-    {
-        for(int n = 0; n < WEBRTC_TRACE_MAX_QUEUE; n++)
-        {
-            delete [] _messageQueue[m][n];
-        }
-    }
+    delete [] _ring;
 }
 
 WebRtc_Word32 TraceImpl::AddLevel(char* szMessage, const TraceLevel level) const
@@ -328,6 +314,34 @@ WebRtc_Word32 TraceImpl::AddLevel(char* szMessage, const TraceLevel level) const
     return 12;
 }
 
+WebRtc_Word32 TraceImpl::AddTime(char* traceMessage, const TraceLevel level,
+                                 const TraceTime& time)
+{
+    WebRtc_UWord32& prevTickCount =
+        (level == kTraceApiCall) ? _prevTickCount : _prevAPITickCount;
+    WebRtc_UWord32 deltaTime = time.ticks - prevTickCount;
+    if(prevTickCount == 0)
+    {
+        deltaTime = 0;
+    }
+    prevTickCount = time.ticks;
+    if(deltaTime > 0x0fffffff)
+    {
+        // Either wraparound or a message from another thread that was queued
+        // after a newer one.
+        deltaTime = 0;
+    }
+    if(deltaTime > 99999)
+    {
+        deltaTime = 99999;
+    }
+    sprintf(traceMessage, "(%2u:%2u:%2u:%3u |%5lu) ", time.hour, time.minute,
+            time.second, time.millisecond,
+            static_cast<unsigned long>(deltaTime));
+    // Messages is 22 characters.
+    return 22;
+}
+
 WebRtc_Word32 TraceImpl::AddModuleAndId(char* traceMessage,
                                         const TraceModule module,
                                         const WebRtc_Word32 id) const
@@ -480,6 +494,15 @@ WebRtc_Word32 TraceImpl::AddModuleAndId(char* traceMessage,
     return 25;
 }
 
+WebRtc_Word32 TraceImpl::AddThreadId(char* traceMessage,
+                                     const WebRtc_UWord64 threadId) const
+{
+    sprintf(traceMessage, "%10llu; ",
+            static_cast<unsigned long long>(threadId));
+    // 12 bytes are written.
+    return 12;
+}
+
 WebRtc_Word32 TraceImpl::SetTraceFileImpl(const WebRtc_Word8* fileNameUTF8,
                                           const bool addFileCounter)
 {
@@ -562,55 +585,83 @@ WebRtc_Word32 TraceImpl::AddMessage(
     return length+1;
 }
 
-void TraceImpl::AddMessageToList(
-    const char traceMessage[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
-    const WebRtc_UWord16 length,
-    const TraceLevel level)
+WebRtc_Word32 TraceImpl::ComposeMessage(char* traceMessage,
+                                        const TraceSlot& slot)
 {
-    CriticalSectionScoped lock(_critsectArray);
+    char* meassagePtr = traceMessage;
+
+    WebRtc_Word32 len = 0;
+    WebRtc_Word32 ackLen = 0;
 
-    if(_nextFreeIdx[_activeQueue] >= WEBRTC_TRACE_MAX_QUEUE)
+    len = AddLevel(meassagePtr, slot.level);
+    if(len == -1)
     {
-        if( ! _traceFile.Open() &&
-            !_callback)
-        {
-            // Keep at least the last 1/4 of old messages when not logging.
-            // TODO (hellner): isn't this redundant. The user will make it known
-            //                 when to start logging. Why keep messages before
-            //                 that?
-            for(int n = 0; n < WEBRTC_TRACE_MAX_QUEUE/4; n++)
-            {
-                const int lastQuarterOffset = (3*WEBRTC_TRACE_MAX_QUEUE/4);
-                memcpy(_messageQueue[_activeQueue][n],
-                       _messageQueue[_activeQueue][n + lastQuarterOffset],
-                       WEBRTC_TRACE_MAX_MESSAGE_SIZE);
-            }
-            _nextFreeIdx[_activeQueue] = WEBRTC_TRACE_MAX_QUEUE/4;
-        } else {
-            // More messages are being written than there is room for in the
-            // buffer. Drop any new messages.
-            // TODO (hellner): its probably better to drop old messages instead
-            //                 of new ones. One step further: if this happens
-            //                 it's due to writing faster than what can be
-            //                 processed. Maybe modify the filter at this point.
-            //                 E.g. turn of STREAM.
-            return;
-        }
+        return -1;
+    }
+    meassagePtr += len;
+    ackLen += len;
+
+    len = AddTime(meassagePtr, slot.level, slot.time);
+    if(len == -1)
+    {
+        return -1;
+    }
+    meassagePtr += len;
+    ackLen += len;
+
+    len = AddModuleAndId(meassagePtr, slot.module, slot.id);
+    if(len == -1)
+    {
+        return -1;
+    }
+    meassagePtr += len;
+    ackLen += len;
+
+    len = AddThreadId(meassagePtr, slot.threadId);
+    if(len == -1)
+    {
+        return -1;
+    }
+    meassagePtr += len;
+    ackLen += len;
+
+    len = AddMessage(meassagePtr, slot.message, (WebRtc_UWord16)ackLen);
+    if(len == -1)
+    {
+        return -1;
     }
+    ackLen += len;
+    return ackLen;
+}
 
-    WebRtc_UWord16 idx = _nextFreeIdx[_activeQueue];
-    _nextFreeIdx[_activeQueue]++;
+bool TraceImpl::NextMessage(TraceSlot*& slot)
+{
+    slot = &_ring[_readPos & (WEBRTC_TRACE_MAX_QUEUE - 1)];
+    // The exchange doesn't change the value, it's used as a read with a full
+    // memory barrier so that the message is read after its sequence number.
+    return slot->sequence.CompareExchange(_readPos + 1, _readPos + 1);
+}
 
-    _level[_activeQueue][idx] = level;
-    _length[_activeQueue][idx] = length;
-    memcpy(_messageQueue[_activeQueue][idx], traceMessage, length);
+void TraceImpl::ReleaseMessage()
+{
+    TraceSlot& slot = _ring[_readPos & (WEBRTC_TRACE_MAX_QUEUE - 1)];
+    // Hand the slot back for position _readPos + WEBRTC_TRACE_MAX_QUEUE.
+    slot.sequence += WEBRTC_TRACE_MAX_QUEUE - 1;
+    _readPos++;
+}
 
-    if(_nextFreeIdx[_activeQueue] == WEBRTC_TRACE_MAX_QUEUE-1)
+void TraceImpl::DiscardOldMessages()
+{
+    // Keep at least the last 1/4 of old messages when not logging.
+    // TODO (hellner): isn't this redundant. The user will make it known
+    //                 when to start logging. Why keep messages before
+    //                 that?
+    const WebRtc_UWord32 writePos = _writePos.Value();
+    TraceSlot* slot = NULL;
+    while(writePos - _readPos > WEBRTC_TRACE_MAX_QUEUE / 4 &&
+          NextMessage(slot))
     {
-        // Loggin more messages than can be worked off. Log a warning.
-        memcpy(_messageQueue[_activeQueue][_nextFreeIdx[_activeQueue]],
-               "WARNING MISSING TRACE MESSAGES\n", 32);
-        _nextFreeIdx[_activeQueue]++;
+        ReleaseMessage();
     }
 }
 
@@ -623,10 +674,15 @@ bool TraceImpl::Process()
 {
     if(_event.Wait(1000) == kEventSignaled)
     {
+        // Clear before draining so that messages added from now on signal
+        // the event again.
+        _wakeUpPending = 0;
         if(_traceFile.Open() || _callback)
         {
             // File mode (not calback mode).
             WriteToFile();
+        } else {
+            DiscardOldMessages();
         }
     } else {
         _traceFile.Flush();
@@ -636,100 +692,103 @@ bool TraceImpl::Process()
 
 void TraceImpl::WriteToFile()
 {
-    WebRtc_UWord8 localQueueActive = 0;
-    WebRtc_UWord16 localNextFreeIdx = 0;
+    // Producers never take _critsectInterface, it only serializes the worker
+    // thread with changes of the file and callback.
+    CriticalSectionScoped lock(_critsectInterface);
 
-    // There are two buffer. One for reading (for writing to file) and one for
-    // writing (for storing new messages). Let new messages be posted to the
-    // unused buffer so that the current buffer can be flushed safely.
+    char traceMessage[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
+    TraceSlot* slot = NULL;
+    while(NextMessage(slot))
     {
-        CriticalSectionScoped lock(_critsectArray);
-        localNextFreeIdx = _nextFreeIdx[_activeQueue];
-        _nextFreeIdx[_activeQueue] = 0;
-        localQueueActive = _activeQueue;
-        if(_activeQueue == 0)
-        {
-            _activeQueue = 1;
-        } else
+        const WebRtc_Word32 length = ComposeMessage(traceMessage, *slot);
+        const TraceLevel level = slot->level;
+        ReleaseMessage();
+        if(length > 0)
         {
-            _activeQueue = 0;
+            WriteMessage(level, traceMessage, (WebRtc_UWord16)length);
         }
     }
-    if(localNextFreeIdx == 0)
+
+    const WebRtc_Word32 dropped = _droppedMessages.Value();
+    if(dropped > 0)
     {
-        return;
+        // Logging more messages than can be worked off. Log a warning.
+        _droppedMessages -= dropped;
+        const int length = sprintf(traceMessage,
+                                   "WARNING MISSING TRACE MESSAGES (%ld)",
+                                   static_cast<long int>(dropped));
+        // Length with NULL termination.
+        WriteMessage(kTraceWarning, traceMessage, (WebRtc_UWord16)length + 1);
     }
+}
 
-    CriticalSectionScoped lock(_critsectInterface);
-
-    for(WebRtc_UWord16 idx = 0; idx <localNextFreeIdx; idx++)
+void TraceImpl::WriteMessage(const TraceLevel level, char* traceMessage,
+                             const WebRtc_UWord16 length)
+{
+    if(_callback)
     {
-        TraceLevel localLevel = _level[localQueueActive][idx];
-        if(_callback)
-        {
-            _callback->Print(localLevel, _messageQueue[localQueueActive][idx],
-                             _length[localQueueActive][idx]);
-        }
-        if(_traceFile.Open())
+        _callback->Print(level, traceMessage, length);
+    }
+    if(_traceFile.Open())
+    {
+        if(_rowCountText > WEBRTC_TRACE_MAX_FILE_SIZE)
         {
-            if(_rowCountText > WEBRTC_TRACE_MAX_FILE_SIZE)
-            {
-                // wrap file
-                _rowCountText = 0;
-                _traceFile.Flush();
+            // wrap file
+            _rowCountText = 0;
+            _traceFile.Flush();
 
-                if(_fileCountText == 0)
-                {
-                    _traceFile.Rewind();
-                } else
-                {
-                    WebRtc_Word8 oldFileName[FileWrapper::kMaxFileNameSize];
-                    WebRtc_Word8 newFileName[FileWrapper::kMaxFileNameSize];
+            if(_fileCountText == 0)
+            {
+                _traceFile.Rewind();
+            } else
+            {
+                WebRtc_Word8 oldFileName[FileWrapper::kMaxFileNameSize];
+                WebRtc_Word8 newFileName[FileWrapper::kMaxFileNameSize];
 
-                    // get current name
-                    _traceFile.FileName(oldFileName,
-                                        FileWrapper::kMaxFileNameSize);
-                    _traceFile.CloseFile();
+                // get current name
+                _traceFile.FileName(oldFileName,
+                                    FileWrapper::kMaxFileNameSize);
+                _traceFile.CloseFile();
 
-                    _fileCountText++;
+                _fileCountText++;
 
-                    UpdateFileName(oldFileName, newFileName, _fileCountText);
+                UpdateFileName(oldFileName, newFileName, _fileCountText);
 
-                    if(_traceFile.OpenFile(newFileName, false, false,
-                                           true) == -1)
-                    {
-                        return;
-                    }
+                if(_traceFile.OpenFile(newFileName, false, false,
+                                       true) == -1)
+                {
+                    return;
                 }
             }
-            if(_rowCountText ==  0)
+        }
+        if(_rowCountText ==  0)
+        {
+            WebRtc_Word8 message[WEBRTC_TRACE_MAX_MESSAGE_SIZE + 1];
+            WebRtc_Word32 length = AddDateTimeInfo(message);
+            if(length != -1)
             {
-                WebRtc_Word8 message[WEBRTC_TRACE_MAX_MESSAGE_SIZE + 1];
-                WebRtc_Word32 length = AddDateTimeInfo(message);
-                if(length != -1)
-                {
-                    message[length] = 0;
-                    message[length-1] = '\n';
-                    _traceFile.Write(message, length);
-                    _rowCountText++;
-                }
-                length = AddBuildInfo(message);
-                if(length != -1)
-                {
-                    message[length+1] = 0;
-                    message[length] = '\n';
-                    message[length-1] = '\n';
-                    _traceFile.Write(message, length+1);
-                    _rowCountText++;
-                    _rowCountText++;
-                }
+                message[length] = 0;
+                message[length-1] = '\n';
+                _traceFile.Write(message, length);
+                _rowCountText++;
             }
-            WebRtc_UWord16 length = _length[localQueueActive][idx];
-            _messageQueue[localQueueActive][idx][length] = 0;
-            _messageQueue[localQueueActive][idx][length-1] = '\n';
-            _traceFile.Write(_messageQueue[localQueueActive][idx], length);
-            _rowCountText++;
+            length = AddBuildInfo(message);
+            if(length != -1)
+            {
+                message[length+1] = 0;
+                message[length] = '\n';
+                message[length-1] = '\n';
+                _traceFile.Write(message, length+1);
+                _rowCountText++;
+                _rowCountText++;
+            }
+            // Restart the time since the previous message.
+            _prevAPITickCount = 0;
+            _prevTickCount = 0;
         }
+        traceMessage[length-1] = '\n';
+        _traceFile.Write(traceMessage, length);
+        _rowCountText++;
     }
 }
 
@@ -739,54 +798,57 @@ void TraceImpl::AddImpl(const TraceLevel level, const TraceModule module,
 {
     if (TraceCheck(level))
     {
-        char traceMessage[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
-        char* meassagePtr = traceMessage;
-
-        WebRtc_Word32 len = 0;
-        WebRtc_Word32 ackLen = 0;
-
-        len = AddLevel(meassagePtr, level);
-        if(len == -1)
-        {
-            return;
-        }
-        meassagePtr += len;
-        ackLen += len;
-
-        len = AddTime(meassagePtr, level);
-        if(len == -1)
+        // Claim a slot. The slot at the write position is free when its
+        // sequence number equals the position.
+        WebRtc_UWord32 pos = _writePos.Value();
+        TraceSlot* slot = NULL;
+        for(;;)
         {
-            return;
+            slot = &_ring[pos & (WEBRTC_TRACE_MAX_QUEUE - 1)];
+            const WebRtc_Word32 diff = static_cast<WebRtc_Word32>(
+                static_cast<WebRtc_UWord32>(slot->sequence.Value()) - pos);
+            if(diff == 0)
+            {
+                if(_writePos.CompareExchange(pos + 1, pos))
+                {
+                    break;
+                }
+            } else if(diff < 0) {
+                // The worker thread hasn't released the slot yet, i.e. the
+                // ring is full. Drop the message.
+                ++_droppedMessages;
+                return;
+            }
+            // Another thread claimed the position first.
+            pos = _writePos.Value();
         }
-        meassagePtr += len;
-        ackLen += len;
 
-        len = AddModuleAndId(meassagePtr, module, id);
-        if(len == -1)
+        // Only the message needs to be copied here, everything else is
+        // formatted by the worker thread.
+        slot->level = level;
+        slot->module = module;
+        slot->id = id;
+        slot->threadId = CurrentThreadId();
+        CurrentTime(slot->time);
+        int length = 0;
+        if(msg)
         {
-            return;
+            while(length < WEBRTC_TRACE_MAX_MESSAGE_SIZE - 1 && msg[length])
+            {
+                slot->message[length] = msg[length];
+                length++;
+            }
         }
-        meassagePtr += len;
-        ackLen += len;
+        slot->message[length] = 0;
 
-        len = AddThreadId(meassagePtr);
-        if(len == -1)
-        {
-            return;
-        }
-        meassagePtr += len;
-        ackLen += len;
+        // Publish the message, the sequence number becomes pos + 1.
+        slot->sequence += 1;
 
-        len = AddMessage(meassagePtr, msg, (WebRtc_UWord16)ackLen);
-        if(len == -1)
+        // Make sure that messages are written as soon as possible.
+        if(_wakeUpPending.CompareExchange(1, 0))
         {
-            return;
+            _event.Set();
         }
-        ackLen += len;
-        AddMessageToList(traceMessage,(WebRtc_UWord16)ackLen, level);
-
-        // Make sure that messages are written as soon as possible.
-        _event.Set();
     }
 }
 
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_IMPL_H_
 #define WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_IMPL_H_
 
+#include "system_wrappers/interface/atomic32_wrapper.h"
 #include "system_wrappers/interface/critical_section_wrapper.h"
 #include "system_wrappers/interface/event_wrapper.h"
 #include "system_wrappers/interface/file_wrapper.h"
@@ -36,23 +37,50 @@ enum TraceCreate
 // TODO (hellner) the buffer should be close to how much the system can write to
 //                file. Increasing the buffer will not solve anything. Sooner or
 //                later the buffer is going to fill up anyways.
+// Must be a power of two.
 #if defined(MAC_IPHONE)
-    #define WEBRTC_TRACE_MAX_QUEUE  2000
+    #define WEBRTC_TRACE_MAX_QUEUE  2048
 #else
-    #define WEBRTC_TRACE_MAX_QUEUE  8000
+    #define WEBRTC_TRACE_MAX_QUEUE  8192
 #endif
-#define WEBRTC_TRACE_NUM_ARRAY 2
 #define WEBRTC_TRACE_MAX_MESSAGE_SIZE 256
-// Total buffer size is WEBRTC_TRACE_NUM_ARRAY (number of buffer partitions) *
-// WEBRTC_TRACE_MAX_QUEUE (number of lines per buffer partition) *
-// WEBRTC_TRACE_MAX_MESSAGE_SIZE (number of 1 byte charachters per line) =
-// 1 or 4 Mbyte
+// Total buffer size is WEBRTC_TRACE_MAX_QUEUE (number of messages) *
+// sizeof(TraceSlot) (a little more than WEBRTC_TRACE_MAX_MESSAGE_SIZE) =
+// 0.6 or 2.3 Mbyte
 
 #define WEBRTC_TRACE_MAX_FILE_SIZE 100*1000
 // Number of rows that may be written to file. On average 110 bytes per row (max
 // 256 bytes per row). So on average 110*100*1000 = 11 Mbyte, max 256*100*1000 =
 // 25.6 Mbyte
 
+// Time of a trace message as captured by the OS specific implementation.
+struct TraceTime
+{
+    // Milliseconds on Windows, seconds elsewhere. Only used for the time
+    // since the previous message.
+    WebRtc_UWord32 ticks;
+    WebRtc_UWord16 hour;
+    WebRtc_UWord16 minute;
+    WebRtc_UWord16 second;
+    WebRtc_UWord16 millisecond;
+};
+
+// One entry of the message ring. The message is stored unformatted, the
+// level, time, module, id and thread id are added by the worker thread.
+struct TraceSlot
+{
+    // Equals the position the slot is free to be written at, or that position
+    // + 1 when the message has been written and is waiting for the worker
+    // thread.
+    Atomic32Wrapper sequence;
+    TraceLevel level;
+    TraceModule module;
+    WebRtc_Word32 id;
+    WebRtc_UWord64 threadId;
+    TraceTime time;
+    char message[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
+};
+
 class TraceImpl : public Trace
 {
 public:
@@ -82,9 +110,8 @@ protected:
     TraceImpl();
 
     // OS specific implementations
-    virtual WebRtc_Word32 AddThreadId(char* traceMessage) const = 0;
-    virtual WebRtc_Word32 AddTime(char* traceMessage,
-                                  const TraceLevel level) const = 0;
+    virtual WebRtc_UWord64 CurrentThreadId() const = 0;
+    virtual void CurrentTime(TraceTime& time) const = 0;
 
     virtual WebRtc_Word32 AddBuildInfo(char* traceMessage) const = 0;
     virtual WebRtc_Word32 AddDateTimeInfo(char* traceMessage) const = 0;
@@ -95,6 +122,9 @@ protected:
 private:
     WebRtc_Word32 AddLevel(char* szMessage, const TraceLevel level) const;
 
+    WebRtc_Word32 AddTime(char* traceMessage, const TraceLevel level,
+                          const TraceTime& time);
+
     WebRtc_Word32 AddModuleAndId(char* traceMessage, const TraceModule module,
                                  const WebRtc_Word32 id) const;
 
@@ -102,10 +132,20 @@ private:
                              const char msg[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
                              const WebRtc_UWord16 writtenSoFar) const;
 
-    void AddMessageToList(
-        const char traceMessage[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
-        const WebRtc_UWord16 length,
-        const TraceLevel level);
+    WebRtc_Word32 AddThreadId(char* traceMessage,
+                              const WebRtc_UWord64 threadId) const;
+
+    WebRtc_Word32 ComposeMessage(char* traceMessage, const TraceSlot& slot);
+
+    // Called by the worker thread. Return false if there is no message.
+    bool NextMessage(TraceSlot*& slot);
+    void ReleaseMessage();
+
+    // Drops the oldest messages, keeping the last quarter of the ring.
+    void DiscardOldMessages();
+
+    void WriteMessage(const TraceLevel level, char* traceMessage,
+                      const WebRtc_UWord16 length);
 
     bool UpdateFileName(
         const WebRtc_Word8 fileNameUTF8[FileWrapper::kMaxFileNameSize],
@@ -128,13 +168,20 @@ private:
     ThreadWrapper& _thread;
     EventWrapper& _event;
 
-    // _critsectArray protects _activeQueue
-    CriticalSectionWrapper& _critsectArray;
-    WebRtc_UWord16 _nextFreeIdx[WEBRTC_TRACE_NUM_ARRAY];
-    TraceLevel _level[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-    WebRtc_UWord16 _length[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-    WebRtc_Word8* _messageQueue[WEBRTC_TRACE_NUM_ARRAY][WEBRTC_TRACE_MAX_QUEUE];
-    WebRtc_UWord8 _activeQueue;
+    // Multi-producer single-consumer ring. Writers claim a position by
+    // incrementing _writePos and never block, the worker thread is the only
+    // reader. Messages that don't fit are counted in _droppedMessages.
+    TraceSlot* _ring;
+    Atomic32Wrapper _writePos;
+    WebRtc_UWord32 _readPos;
+    Atomic32Wrapper _droppedMessages;
+    // Set when _event has been signaled and the worker thread has not yet
+    // started draining the ring. Avoids signaling the event for each message.
+    Atomic32Wrapper _wakeUpPending;
+
+    // Only accessed by the worker thread.
+    WebRtc_UWord32 _prevAPITickCount;
+    WebRtc_UWord32 _prevTickCount;
 };
 } // namespace webrtc
 
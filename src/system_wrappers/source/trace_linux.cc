@@ -39,8 +39,6 @@
 namespace webrtc {
 TraceLinux::TraceLinux()
 {
-    _prevAPITickCount = time(NULL);
-    _prevTickCount = _prevAPITickCount;
 }
 
 TraceLinux::~TraceLinux()
@@ -48,65 +46,22 @@ TraceLinux::~TraceLinux()
     StopThread();
 }
 
-WebRtc_Word32 TraceLinux::AddThreadId(char* traceMessage) const
+WebRtc_UWord64 TraceLinux::CurrentThreadId() const
 {
-    WebRtc_UWord64 threadId = (WebRtc_UWord64)pthread_self();
-    sprintf(traceMessage, "%10llu; ", threadId);
-    // 12 bytes are written.
-    return 12;
+    return (WebRtc_UWord64)pthread_self();
 }
 
-WebRtc_Word32 TraceLinux::AddTime(char* traceMessage,
-                                  const TraceLevel level) const
+void TraceLinux::CurrentTime(TraceTime& time) const
 {
-    time_t dwCurrentTimeInSeconds = time(NULL);
+    time_t dwCurrentTimeInSeconds = ::time(NULL);
     struct tm systemTime;
     gmtime_r(&dwCurrentTimeInSeconds, &systemTime);
 
-    if(level == kTraceApiCall)
-    {
-        WebRtc_UWord32 dwDeltaTime = dwCurrentTimeInSeconds - _prevTickCount;
-        _prevTickCount = dwCurrentTimeInSeconds;
-
-        if(_prevTickCount == 0)
-        {
-            dwDeltaTime = 0;
-        }
-        if(dwDeltaTime > 0x0fffffff)
-        {
-            // Either wraparound or data race.
-            dwDeltaTime = 0;
-        }
-        if(dwDeltaTime > 99999)
-        {
-            dwDeltaTime = 99999;
-        }
-
-        sprintf(traceMessage, "(%2u:%2u:%2u:%3u |%5lu) ", systemTime.tm_hour,
-                systemTime.tm_min, systemTime.tm_sec, 0,
-                static_cast<unsigned long>(dwDeltaTime));
-    } else {
-        WebRtc_UWord32 dwDeltaTime = dwCurrentTimeInSeconds - _prevAPITickCount;
-        _prevAPITickCount = dwCurrentTimeInSeconds;
-        if(_prevAPITickCount == 0)
-        {
-            dwDeltaTime = 0;
-        }
-        if(dwDeltaTime > 0x0fffffff)
-        {
-            // Either wraparound or data race.
-            dwDeltaTime = 0;
-        }
-        if(dwDeltaTime > 99999)
-        {
-            dwDeltaTime = 99999;
-        }
-        sprintf(traceMessage, "(%2u:%2u:%2u:%3u |%5lu) ", systemTime.tm_hour,
-                systemTime.tm_min, systemTime.tm_sec, 0,
-                static_cast<unsigned long>(dwDeltaTime));
-    }
-    // Messages is 22 characters.
-    return 22;
+    time.ticks = static_cast<WebRtc_UWord32>(dwCurrentTimeInSeconds);
+    time.hour = systemTime.tm_hour;
+    time.minute = systemTime.tm_min;
+    time.second = systemTime.tm_sec;
+    time.millisecond = 0;
 }
 
 WebRtc_Word32 TraceLinux::AddBuildInfo(char* traceMessage) const
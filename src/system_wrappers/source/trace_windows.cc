@@ -31,8 +31,6 @@
 
 namespace webrtc {
 TraceWindows::TraceWindows()
-    : _prevAPITickCount(0),
-      _prevTickCount(0)
 {
 }
 
@@ -41,66 +39,21 @@ TraceWindows::~TraceWindows()
     StopThread();
 }
 
-WebRtc_Word32 TraceWindows::AddThreadId(char* traceMessage) const
+WebRtc_UWord64 TraceWindows::CurrentThreadId() const
 {
-    WebRtc_UWord32 threadId= GetCurrentThreadId();
-    sprintf (traceMessage, "%10u; ", threadId);
-    // Messages is 12 characters.
-    return 12;
+    return GetCurrentThreadId();
 }
 
-WebRtc_Word32 TraceWindows::AddTime(char* traceMessage,
-                                    const TraceLevel level) const
+void TraceWindows::CurrentTime(TraceTime& time) const
 {
-    WebRtc_UWord32 dwCurrentTime = timeGetTime();
     SYSTEMTIME systemTime;
     GetSystemTime(&systemTime);
 
-    if(level == kTraceApiCall)
-    {
-        WebRtc_UWord32 dwDeltaTime = dwCurrentTime- _prevTickCount;
-        _prevTickCount = dwCurrentTime;
-
-        if(_prevTickCount == 0)
-        {
-            dwDeltaTime = 0;
-        }
-        if(dwDeltaTime > 0x0fffffff)
-        {
-            // Either wraparound or data race.
-            dwDeltaTime = 0;
-        }
-        if(dwDeltaTime > 99999)
-        {
-            dwDeltaTime = 99999;
-        }
-
-        sprintf (traceMessage, "(%2u:%2u:%2u:%3u |%5lu) ", systemTime.wHour,
-                 systemTime.wMinute, systemTime.wSecond,
-                 systemTime.wMilliseconds, dwDeltaTime);
-    } else {
-        WebRtc_UWord32 dwDeltaTime = dwCurrentTime - _prevAPITickCount;
-        _prevAPITickCount = dwCurrentTime;
-
-        if(_prevAPITickCount == 0)
-        {
-            dwDeltaTime = 0;
-        }
-        if(dwDeltaTime > 0x0fffffff)
-        {
-            // Either wraparound or data race.
-            dwDeltaTime = 0;
-        }
-        if(dwDeltaTime > 99999)
-        {
-            dwDeltaTime = 99999;
-        }
-        sprintf (traceMessage, "(%2u:%2u:%2u:%3u |%5lu) ", systemTime.wHour,
-                 systemTime.wMinute, systemTime.wSecond,
-                 systemTime.wMilliseconds, dwDeltaTime);
-    }
-    // Messages is 12 characters.
-    return 22;
+    time.ticks = timeGetTime();
+    time.hour = systemTime.wHour;
+    time.minute = systemTime.wMinute;
+    time.second = systemTime.wSecond;
+    time.millisecond = systemTime.wMilliseconds;
 }
 
 WebRtc_Word32 TraceWindows::AddBuildInfo(char* traceMessage) const
@@ -113,9 +66,6 @@ WebRtc_Word32 TraceWindows::AddBuildInfo(char* traceMessage) const
 
 WebRtc_Word32 TraceWindows::AddDateTimeInfo(char* traceMessage) const
 {
-    _prevAPITickCount = timeGetTime();
-    _prevTickCount = _prevAPITickCount;
-
     SYSTEMTIME sysTime;
     GetLocalTime (&sysTime);
 
@@ -22,15 +22,11 @@ public:
     TraceWindows();
       virtual ~TraceWindows();
 
-    virtual WebRtc_Word32 AddThreadId(char *traceMessage) const;
-    virtual WebRtc_Word32 AddTime(char* traceMessage,
-                                  const TraceLevel level) const;
+    virtual WebRtc_UWord64 CurrentThreadId() const;
+    virtual void CurrentTime(TraceTime& time) const;
 
     virtual WebRtc_Word32 AddBuildInfo(char* traceMessage) const;
     virtual WebRtc_Word32 AddDateTimeInfo(char* traceMessage) const;
-private:
-    volatile mutable WebRtc_UWord32    _prevAPITickCount;
-    volatile mutable WebRtc_UWord32   _prevTickCount;
 };
 } // namespace webrtc
 
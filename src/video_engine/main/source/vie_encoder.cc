@@ -52,7 +52,8 @@ ViEEncoder::ViEEncoder(WebRtc_Word32 engineId, WebRtc_Word32 channelId,
         _paused(false), _timeLastIntraRequestMs(0),
         _channelsDroppingDeltaFrames(0), _dropNextFrame(false),
         _fecEnabled(false), _nackEnabled(false), _codecObserver(NULL),
-        _effectFilter(NULL), _moduleProcessThread(moduleProcessThread),
+        _effectFilter(NULL), _frameReadOnly(true),
+        _moduleProcessThread(moduleProcessThread),
         _hasReceivedSLI(false), _pictureIdSLI(0), _hasReceivedRPSI(false),
         _pictureIdRPSI(0), _fileRecorder(channelId)
 {
@@ -470,6 +471,19 @@ RtpRtcp* ViEEncoder::SendRtpRtcpModule()
 //=============================================================================
 
 
+// ----------------------------------------------------------------------------
+// IsFrameReadOnly
+// Implements ViEFrameCallback::IsFrameReadOnly
+// ----------------------------------------------------------------------------
+
+bool ViEEncoder::IsFrameReadOnly()
+{
+    const bool recording = _fileRecorder.RecordingStarted();
+    CriticalSectionScoped cs(_callbackCritsect);
+    _frameReadOnly = (_effectFilter == NULL && !recording);
+    return _frameReadOnly;
+}
+
 // ----------------------------------------------------------------------------
 // DeliverFrame
 // Implements ViEFrameCallback::DeliverFrame
@@ -501,21 +515,37 @@ void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& videoFrame,
             return;
         }
     }
-    // Set the frame timestamp
+    // The RTP timestamp is set on the preprocessed frame, which the VPM owns,
+    // since the delivered frame may be shared with other frame callbacks.
     const WebRtc_UWord32 timeStamp = 90 * (WebRtc_UWord32) videoFrame.RenderTimeMs();
-    videoFrame.SetTimeStamp(timeStamp);
+    VideoFrame* ptrFrame = &videoFrame;
+    const bool recording = _fileRecorder.RecordingStarted();
     {
-        // Send to effect filter, if registered by user.
         CriticalSectionScoped cs(_callbackCritsect);
+        if (_effectFilter || recording)
+        {
+            if (_frameReadOnly)
+            {
+                // The filter or the recording was started after
+                // IsFrameReadOnly(), don't change the shared frame.
+                _effectFrame.CopyFrame(videoFrame);
+                ptrFrame = &_effectFrame;
+            }
+            ptrFrame->SetTimeStamp(timeStamp);
+        }
+        // Send to effect filter, if registered by user.
         if (_effectFilter)
         {
-            _effectFilter->Transform(videoFrame.Length(), videoFrame.Buffer(),
-                                     videoFrame.TimeStamp(),
-                                     videoFrame.Width(), videoFrame.Height());
+            _effectFilter->Transform(ptrFrame->Length(), ptrFrame->Buffer(),
+                                     timeStamp, ptrFrame->Width(),
+                                     ptrFrame->Height());
         }
     }
     // Record un-encoded frame.
-    _fileRecorder.RecordVideoFrame(videoFrame);
+    if (recording)
+    {
+        _fileRecorder.RecordVideoFrame(*ptrFrame);
+    }
     // Make sure the CSRC list is correct.
     if (numCSRCs > 0)
     {
@@ -557,7 +587,7 @@ void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& videoFrame,
         }
         // Pass frame via preprocessor
         VideoFrame *decimatedFrame = NULL;
-        const int ret = _vpm.PreprocessFrame(&videoFrame, &decimatedFrame);
+        const int ret = _vpm.PreprocessFrame(ptrFrame, &decimatedFrame);
         if (ret == 1)
         {
             // Drop this frame
@@ -567,9 +597,10 @@ void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& videoFrame,
         {
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideo, ViEId(_engineId, _channelId),
                        "%s: Error preprocessing frame %u", __FUNCTION__,
-                       videoFrame.TimeStamp());
+                       timeStamp);
             return;
         }
+        decimatedFrame->SetTimeStamp(timeStamp);
 
         VideoContentMetrics* contentMetrics = NULL;
         contentMetrics = _vpm.ContentMetrics();
@@ -579,14 +610,14 @@ void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& videoFrame,
         {
             WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideo, ViEId(_engineId, _channelId),
                        "%s: Error encoding frame %u", __FUNCTION__,
-                       videoFrame.TimeStamp());
+                       timeStamp);
         }
         return;
     }
 #endif
     // Pass frame via preprocessor
     VideoFrame *decimatedFrame = NULL;
-    const int ret = _vpm.PreprocessFrame(&videoFrame, &decimatedFrame);
+    const int ret = _vpm.PreprocessFrame(ptrFrame, &decimatedFrame);
     if (ret == 1)
     {
         // Drop this frame
@@ -595,14 +626,15 @@ void ViEEncoder::DeliverFrame(int id, webrtc::VideoFrame& videoFrame,
     else if (ret != VPM_OK)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideo, ViEId(_engineId, _channelId),
-                  "%s: Error preprocessing frame %u", __FUNCTION__, videoFrame.TimeStamp());
+                  "%s: Error preprocessing frame %u", __FUNCTION__, timeStamp);
         return;
     }
+    decimatedFrame->SetTimeStamp(timeStamp);
     if (_vcm.AddVideoFrame(*decimatedFrame) != VCM_OK)
     {
         WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideo,
                    ViEId(_engineId, _channelId), "%s: Error encoding frame %u",
-                   __FUNCTION__, videoFrame.TimeStamp());
+                   __FUNCTION__, timeStamp);
     }
 }
 // ----------------------------------------------------------------------------
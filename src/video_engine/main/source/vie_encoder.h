@@ -78,6 +78,9 @@ public:
                                          int &frameRate);
 
     virtual void ProviderDestroyed(int id) { return; }
+    // The delivered frame is only written to by an effect filter and the
+    // file recorder.
+    virtual bool IsFrameReadOnly();
 
     WebRtc_Word32 EncodeFrame(VideoFrame& videoFrame);
     WebRtc_Word32 SendKeyFrame();
@@ -171,6 +174,11 @@ private:
     // Uses
     ViEEncoderObserver* _codecObserver;
     ViEEffectFilter* _effectFilter;
+    // Last value returned by IsFrameReadOnly().
+    bool _frameReadOnly;
+    // Copy of a read-only delivered frame, used if an effect filter or the
+    // recording was started after IsFrameReadOnly().
+    VideoFrame _effectFrame;
     ProcessThread& _moduleProcessThread;
 
     bool _hasReceivedSLI;
@@ -57,37 +57,40 @@ void ViEFrameProviderBase::DeliverFrame(webrtc::VideoFrame& videoFrame,int numCS
 #endif
     CriticalSectionScoped cs(_providerCritSect);
 
-    // Deliver the frame to all registered callbacks
-    if (_frameCallbackMap.Size() > 0)
+    // Deliver the frame to all registered callbacks. Read only callbacks share
+    // the frame, all writable callbacks but the last one get a copy since a
+    // previous receiver might swap it. The last one gets the original frame
+    // after the read only callbacks are done with it.
+    ViEFrameCallback* lastWritableObserver = NULL;
+    for (MapItem* mapItem = _frameCallbackMap.First();
+        mapItem != NULL;
+        mapItem = _frameCallbackMap.Next(mapItem))
     {
-        if(_frameCallbackMap.Size()==1)
+        ViEFrameCallback* frameObserver = static_cast<ViEFrameCallback*>(mapItem->GetItem());
+        if (frameObserver == NULL)
         {
-            ViEFrameCallback* frameObserver = static_cast<ViEFrameCallback*>(_frameCallbackMap.First()->GetItem());
-            frameObserver->DeliverFrame(_id,videoFrame,numCSRCs,CSRC);
+            continue;
         }
-        else
+        if (frameObserver->IsFrameReadOnly())
         {
-            // Make a copy of the frame for all callbacks
-            for (MapItem* mapItem = _frameCallbackMap.First();
-                mapItem != NULL;
-                mapItem = _frameCallbackMap.Next(mapItem))
+            frameObserver->DeliverFrame(_id, videoFrame, numCSRCs, CSRC);
+            continue;
+        }
+        if (lastWritableObserver != NULL)
+        {
+            if (_ptrExtraFrame == NULL)
             {
-                if (_ptrExtraFrame == NULL)
-                {
-                    _ptrExtraFrame = new webrtc::VideoFrame();
-                }
-                if (mapItem != NULL)
-                {
-                    ViEFrameCallback* frameObserver = static_cast<ViEFrameCallback*>(mapItem->GetItem());
-                    if (frameObserver != NULL)
-                    {
-                        // We must copy the frame each time since the previous receiver might swap it...
-                        _ptrExtraFrame->CopyFrame(videoFrame);
-                        frameObserver->DeliverFrame(_id, *_ptrExtraFrame,numCSRCs,CSRC);
-                    }
-                }
+                _ptrExtraFrame = new webrtc::VideoFrame();
             }
+            _ptrExtraFrame->CopyFrame(videoFrame);
+            lastWritableObserver->DeliverFrame(_id, *_ptrExtraFrame, numCSRCs,
+                                               CSRC);
         }
+        lastWritableObserver = frameObserver;
+    }
+    if (lastWritableObserver != NULL)
+    {
+        lastWritableObserver->DeliverFrame(_id, videoFrame, numCSRCs, CSRC);
     }
 
 #ifdef _DEBUG
@@ -44,6 +44,17 @@ public:
 
     virtual void ProviderDestroyed(int id) = 0;
 
+    /*
+     Return true if DeliverFrame neither modifies the frame buffer nor takes
+     it over (e.g. with SwapFrame). Such callbacks share the provider's frame
+     with the other callbacks instead of receiving a private copy. Called
+     once before each DeliverFrame.
+     */
+    virtual bool IsFrameReadOnly()
+    {
+        return false;
+    }
+
 protected:
     virtual ~ViEFrameCallback()
     {